@@ -9,6 +9,7 @@ extern spinlock_t sched_lock;
 #include "../../drivers/lapic/lapic.h"
 #include "../../drivers/serial/serial.h"
 #include "../mm/vmm.h"
+#include "../mm/tlb.h"
 #include "../../../kernel/watchdog.h"
 #include "../../../kernel/panic.h"
 #include "../../../kernel/vsnprintf.h"
@@ -446,12 +447,23 @@ void interrupt_handler(struct interrupt_frame *frame) {
                  * for parking the running task into BARRIER_WAIT.  The
                  * gate is a single relaxed atomic load so the original
                  * idle-only behaviour is preserved when no barrier is
-                 * in flight. */
-                if (__atomic_load_n(&g_snap_barrier.barrier_flag,
-                                    __ATOMIC_RELAXED) != 0u ||
-                    percpu_get()->runq.current ==
-                    percpu_get()->runq.idle_task) {
-                    schedule(frame);
+                 * in flight.
+                 *
+                 * Phase 26: sched_wake_one_on_channel_affine may also send
+                 * vector 48 to a busy CPU with runq.handoff_hint set, asking
+                 * it to run a woken IPC peer now. Honoured only when the
+                 * interrupted context is user mode — the same point a timer
+                 * tick preempts at — and consumed either way. */
+                {
+                    runq_t *rq = &percpu_get()->runq;
+                    bool hint = __atomic_exchange_n(&rq->handoff_hint, 0u,
+                                                    __ATOMIC_ACQ_REL) != 0u;
+                    if (__atomic_load_n(&g_snap_barrier.barrier_flag,
+                                        __ATOMIC_RELAXED) != 0u ||
+                        rq->current == rq->idle_task ||
+                        (hint && (frame->cs & 3) == 3)) {
+                        schedule(frame);
+                    }
                 }
                 break;
             case 49:
@@ -466,6 +478,13 @@ void interrupt_handler(struct interrupt_frame *frame) {
                  * "direct process switch" / fast-path IPC technique. */
                 schedule(frame);
                 break;
+            case IPI_VEC_TLB_SHOOTDOWN:
+                /* Cross-CPU TLB shootdown. A peer changed PTEs of the
+                 * address space this CPU has loaded and queued the VAs
+                 * in our mailbox; drain them all with one IPI. Never
+                 * reschedules — the shooter is spinning on our ack. */
+                tlb_shootdown_ipi_handler();
+                break;
             case 255: // Spurious interrupt from LAPIC
                 // Just return, no EOI needed for spurious
                 return;
@@ -13,7 +13,7 @@ void runq_init(runq_t *rq, uint32_t cpu_id) {
     rq->ready_head = NULL;
     rq->ready_tail = NULL;
     rq->ready_count = 0;
-    rq->_pad0 = 0;
+    rq->handoff_hint = 0;
     rq->starved_head = NULL;
     rq->current = NULL;
     rq->steal_successes = 0;
@@ -21,6 +21,10 @@ void runq_init(runq_t *rq, uint32_t cpu_id) {
     rq->context_switches = 0;
     rq->last_epoch_tick_ticks = RUNQ_EPOCH_NEVER;
     rq->idle_task = NULL;
+    rq->handoff_local = 0;
+    rq->handoff_ipi_idle = 0;
+    rq->handoff_migrate = 0;
+    rq->handoff_ipi_preempt = 0;
     spinlock_init(&rq->lock, "runq");
 }
 
@@ -48,7 +48,7 @@ typedef struct runq {
     struct task_struct *ready_head;       //  8..15   FIFO: dequeue here
     struct task_struct *ready_tail;       // 16..23   FIFO: enqueue here
     uint32_t ready_count;                 // 24..27   updated atomic-ish under lock; lockless snapshot ok
-    uint32_t _pad0;                       // 28..31
+    uint32_t handoff_hint;                // 28..31   Phase 26: IPC wake wants this CPU to reschedule
 
     struct task_struct *starved_head;     // 32..39   rlimit_consume_cpu exhausted → here
     struct task_struct *current;          // 40..47   running task, or <per-CPU idle> when idle
@@ -66,6 +66,13 @@ typedef struct runq {
     // never be NULL after the per-CPU idle is created — schedule() relies
     // on this to avoid two CPUs racing on `task_ptrs[0]` (BSP idle).
     struct task_struct *idle_task;        // 128..135
+
+    // Phase 26: IPC wake handoff decisions taken BY this CPU as the waker
+    // (sched_wake_one_on_channel_affine). Relaxed atomics; telemetry only.
+    uint64_t handoff_local;               // 136..143  receiver already on this CPU
+    uint64_t handoff_ipi_idle;            // 144..151  receiver's CPU idle: doorbell IPI
+    uint64_t handoff_migrate;             // 152..159  receiver pulled onto this CPU
+    uint64_t handoff_ipi_preempt;         // 160..167  receiver's CPU busy: preempt-hint IPI
 } runq_t;
 
 _Static_assert(sizeof(runq_t) <= 192, "runq_t must fit in the 192-byte slot reserved in percpu_t");
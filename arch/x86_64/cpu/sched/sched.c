@@ -35,6 +35,7 @@
 // points to a slab-allocated task_t when occupied.
 static task_t *task_ptrs[MAX_TASKS];
 static kmem_cache_t *task_cache = NULL;
+static kmem_cache_t *fpu_cache = NULL;
 static int next_task_id = 0;
 static int current_task_index = 0;
 
@@ -65,6 +66,7 @@ static void *memset(void *s, int c, size_t n) {
 // through when both the local runq and work-stealing came up empty.
 static void ap_idle_entry(void) {
     while (1) {
+        snap_barrier_help();   // Phase 26: lend this CPU to a snapshot barrier
         asm volatile("sti; hlt");
     }
 }
@@ -276,6 +278,36 @@ void sched_yield_now(void) {
     asm volatile("int $49" ::: "memory");
 }
 
+// Phase 26: per-task vector state. Userspace is built for x86-64, which
+// means SSE2 everywhere (GCC's own spills, BearSSL's AES-NI / PCLMUL /
+// SSE2 engines); the kernel is built -mno-sse and never touches xmm, so
+// the registers still hold the interrupted task's values when schedule()
+// runs and a plain FXSAVE / FXRSTOR around the frame swap is enough.
+//
+// A fresh image is the FNINIT / power-on state: FCW 0x037F (all x87
+// exceptions masked, double-extended precision), MXCSR 0x1F80 (all SSE
+// exceptions masked, round-to-nearest), every register zero.
+static void *sched_fpu_alloc(void) {
+    uint8_t *fx = kmem_cache_alloc(fpu_cache);   // Zeroed by the slab
+    if (!fx) return NULL;
+    fx[0] = 0x7F;                                 // FCW
+    fx[1] = 0x03;
+    *(uint32_t *)(fx + 24) = 0x1F80u;             // MXCSR
+    return fx;
+}
+
+static inline void sched_fpu_save(task_t *t) {
+    if (t && t->fpu_state) {
+        asm volatile("fxsave64 (%0)" : : "r"(t->fpu_state) : "memory");
+    }
+}
+
+static inline void sched_fpu_restore(task_t *t) {
+    if (t && t->fpu_state) {
+        asm volatile("fxrstor64 (%0)" : : "r"(t->fpu_state) : "memory");
+    }
+}
+
 void sched_init(void) {
     // Initialize the scheduler lock
     spinlock_init(&sched_lock, "scheduler");
@@ -293,6 +325,16 @@ void sched_init(void) {
             kpanic("sched_init: kmem_cache_create(task_cache) failed");
         }
     }
+    if (!fpu_cache) {
+        fpu_cache = kmem_cache_create("fpu_state",
+                                      SCHED_FPU_STATE_SIZE,
+                                      16,  // FXSAVE/FXRSTOR fault otherwise
+                                      /*ctor=*/NULL,
+                                      SUBSYS_SCHED);
+        if (!fpu_cache) {
+            kpanic("sched_init: kmem_cache_create(fpu_cache) failed");
+        }
+    }
 
     spinlock_acquire(&sched_lock);
 
@@ -572,6 +614,17 @@ static int sched_create_user_process_argv_internal(uint64_t rip, uint64_t cr3,
              "sched_create_user_process: task_cache alloc failed");
         return -1;
     }
+    (*task_ptrs[id]).fpu_state = sched_fpu_alloc();
+    if (!(*task_ptrs[id]).fpu_state) {
+        kmem_cache_free(task_cache, task_ptrs[id]);
+        task_ptrs[id] = NULL;
+        next_task_id--;
+        asm volatile("push %0; popfq" : : "r"(flags));
+        spinlock_release(&sched_lock);
+        klog(KLOG_ERROR, SUBSYS_SCHED,
+             "sched_create_user_process: fpu_cache alloc failed");
+        return -1;
+    }
     (*task_ptrs[id]).id = id;
     (*task_ptrs[id]).state = TASK_STATE_BLOCKED;  // BLOCKED until fully initialized
     (*task_ptrs[id]).cr3 = cr3;
@@ -994,6 +1047,9 @@ void schedule(struct interrupt_frame *frame) {
     uint64_t starvation_budget = 0;
     if (cur) {
         cur->regs = *frame;
+        // Phase 26: vector state goes with the frame, before cur can be
+        // enqueued where another CPU might pick it up.
+        sched_fpu_save(cur);
         if (cur->state == TASK_STATE_RUNNING) {
             if (barrier_active && !cur->is_idle) {
                 // Phase 24 W14.2: park non-idle non-owner tasks into the
@@ -1117,12 +1173,12 @@ void schedule(struct interrupt_frame *frame) {
     // TSS rsp0 + CR3 switch — outside any global lock.
     g_cpu_locals[cpu_id].tss.rsp0 = next->kernel_stack_top;
 
-    uint64_t current_cr3;
-    asm volatile("mov %%cr3, %0" : "=r"(current_cr3));
-    if (current_cr3 != next->cr3) {
-        vmm_switch_address_space_phys(next->cr3);
-    }
+    // tlb_switch_mm publishes the active mm for shootdown targeting and,
+    // with PCID, keeps the outgoing context's translations tagged instead
+    // of flushing them. No-op if next shares this CPU's current PML4.
+    tlb_switch_mm(cpu_id, next->cr3);
 
+    if (next != cur) sched_fpu_restore(next);
     *frame = next->regs;
 
     // Audit starvation OUTSIDE the hot path — audit_write_rlimit_cpu can
@@ -1276,7 +1332,7 @@ int sched_reap_zombie(int task_id) {
     // Phase 17: release any VMO mappings the task still held. The
     // address-space pages are being torn down in vmm_destroy_address_space_by_cr3
     // already; this call reconciles refcount bookkeeping on the VMO side.
-    vmo_cleanup_task((int32_t)(*task_ptrs[task_id]).id);
+    vmo_cleanup_task(task_ptrs[task_id]);
 
     // Phase 21: if the dying task owned any PCI devices via the userdrv
     // framework, reap that ownership: PIC-mask the IRQ line, mark IRQ
@@ -1300,8 +1356,8 @@ int sched_reap_zombie(int task_id) {
     cap_wasm_task_exit_cleanup((int32_t)(*task_ptrs[task_id]).id);
 
     // Phase 27 Stage C1: free any audit subscriber slots held by the dying
-    // task so a crashed grahai (or other AI agent) doesn't leave its
-    // 16 KiB ring sitting in g_audit_subscribers[] forever.
+    // task so a crashed grahai (or other AI agent) doesn't hold one of the
+    // AUDIT_SUB_MAX slots in g_audit_subscribers[] forever.
     extern void audit_unsubscribe_all_for_pid(int32_t dying_pid);
     audit_unsubscribe_all_for_pid((int32_t)(*task_ptrs[task_id]).id);
 
@@ -1321,6 +1377,10 @@ int sched_reap_zombie(int task_id) {
 
     // Phase 14: return the task_t to the slab; slot goes empty.
     // No need to memset — slab alloc zeroes on next use.
+    if (task_ptrs[task_id]->fpu_state) {
+        kmem_cache_free(fpu_cache, task_ptrs[task_id]->fpu_state);
+        task_ptrs[task_id]->fpu_state = NULL;
+    }
     kmem_cache_free(task_cache, task_ptrs[task_id]);
     task_ptrs[task_id] = NULL;
     klog(KLOG_INFO, SUBSYS_SCHED, "[REAP] task_id=%d done", task_id);
@@ -1872,19 +1932,19 @@ static uint64_t ns_to_ticks(uint64_t ns) {
     return (ns + 9999999ULL) / 10000000ULL;
 }
 
-int sched_block_on_channel(void *channel, uint8_t dir, uint64_t timeout_ns,
-                           struct task_struct **list_head) {
+// Shared body of sched_block_on_channel / sched_block_on_channel_seq. A
+// NULL seq means "always block".
+static int sched_block_common(void *channel, uint8_t dir, uint64_t deadline_tick,
+                              struct task_struct **list_head,
+                              const volatile uint64_t *seq, uint64_t seen) {
     task_t *cur = sched_get_current_task();
     if (!cur || !list_head) return -1;
 
-    uint64_t deadline_tick = 0;
-    if (timeout_ns != 0 && timeout_ns != 0xFFFFFFFFFFFFFFFFULL) {
-        uint64_t dt = ns_to_ticks(timeout_ns);
-        if (dt == 0) dt = 1;
-        deadline_tick = g_timer_ticks + dt;
-    }
-
     spinlock_acquire(&sched_lock);
+    if (seq && __atomic_load_n(seq, __ATOMIC_ACQUIRE) != seen) {
+        spinlock_release(&sched_lock);
+        return 0;
+    }
     cur->wait_next     = *list_head;
     *list_head         = cur;
     cur->wait_reason   = dir;
@@ -1954,6 +2014,24 @@ int sched_block_on_channel(void *channel, uint8_t dir, uint64_t timeout_ns,
     return result;
 }
 
+int sched_block_on_channel(void *channel, uint8_t dir, uint64_t timeout_ns,
+                           struct task_struct **list_head) {
+    uint64_t deadline_tick = 0;
+    if (timeout_ns != 0 && timeout_ns != 0xFFFFFFFFFFFFFFFFULL) {
+        uint64_t dt = ns_to_ticks(timeout_ns);
+        if (dt == 0) dt = 1;
+        deadline_tick = g_timer_ticks + dt;
+    }
+    return sched_block_common(channel, dir, deadline_tick, list_head, NULL, 0);
+}
+
+int sched_block_on_channel_seq(void *channel, uint8_t dir,
+                               uint64_t deadline_tick,
+                               struct task_struct **list_head,
+                               const volatile uint64_t *seq, uint64_t seen) {
+    return sched_block_common(channel, dir, deadline_tick, list_head, seq, seen);
+}
+
 task_t *sched_wake_one_on_channel(struct task_struct **list_head,
                                   int32_t wait_result) {
     if (!list_head) return NULL;
@@ -1986,6 +2064,59 @@ task_t *sched_wake_one_on_channel(struct task_struct **list_head,
     return t;
 }
 
+task_t *sched_wake_one_on_channel_affine(struct task_struct **list_head,
+                                         int32_t wait_result) {
+    if (!list_head) return NULL;
+    spinlock_acquire(&sched_lock);
+    task_t *t = *list_head;
+    if (!t) {
+        spinlock_release(&sched_lock);
+        return NULL;
+    }
+    *list_head = (task_t *)t->wait_next;
+    t->wait_next   = NULL;
+    t->wait_result = wait_result;
+    bool waking = (t->state == TASK_STATE_CHAN_WAIT);
+    if (waking) {
+        t->state = TASK_STATE_READY;
+    }
+    spinlock_release(&sched_lock);
+    if (!waking) return t;
+
+    // Cost model. Reads of other CPUs' runq state are relaxed snapshots:
+    // a stale read costs at most one tick of latency, as before W1.
+    uint32_t self   = smp_get_current_cpu();
+    uint32_t target = sched_doorbell_target_cpu(t);
+    runq_t  *my     = &g_cpu_locals[self].runq;
+    if (target == self) {
+        __atomic_fetch_add(&my->handoff_local, 1, __ATOMIC_RELAXED);
+        sched_enqueue_ready(t);
+        return t;
+    }
+    runq_t *trq  = &g_cpu_locals[target].runq;
+    task_t *tcur = (task_t *)__atomic_load_n(&trq->current,   __ATOMIC_RELAXED);
+    task_t *idle = (task_t *)__atomic_load_n(&trq->idle_task, __ATOMIC_RELAXED);
+    if (tcur == idle && idle != NULL) {
+        // An idle CPU starts the receiver in parallel with us, warm cache.
+        __atomic_fetch_add(&my->handoff_ipi_idle, 1, __ATOMIC_RELAXED);
+        sched_enqueue_ready(t);
+        sched_maybe_doorbell_ipi(target);
+    } else if (t->cpu_pinned < 0 &&
+               __atomic_load_n(&my->ready_count, __ATOMIC_RELAXED) == 0) {
+        // Its CPU is busy and ours is about to be free: pull it over. Same
+        // move work-stealing makes; t is off every list, so this is ours.
+        __atomic_fetch_add(&my->handoff_migrate, 1, __ATOMIC_RELAXED);
+        t->last_ran_cpu = self;
+        sched_enqueue_ready(t);
+    } else {
+        __atomic_fetch_add(&my->handoff_ipi_preempt, 1, __ATOMIC_RELAXED);
+        sched_enqueue_ready(t);
+        __atomic_store_n(&trq->handoff_hint, 1u, __ATOMIC_RELEASE);
+        apic_send_ipi(g_cpu_info[target].lapic_id, IPI_VEC_WAKEUP);
+    }
+    return t;
+}
+
 int sched_wake_all_on_channel(struct task_struct **list_head,
                               int32_t wait_result) {
     if (!list_head) return 0;
@@ -86,6 +86,12 @@ typedef enum {
 #define WAIT_STREAM_REAP    3   // task blocked in SYS_STREAM_REAP min_complete
 #define WAIT_STREAM_SUBMIT  4   // reserved: blocking submit (Phase 18 does not use)
 #define WAIT_STREAM_WORKER  5   // stream worker kernel thread idle, no jobs
+// Phase 26: task blocked in SYS_WAITSET_WAIT; wait_channel is the waitset_t.
+#define WAIT_WAITSET        6
+// Phase 26: task blocked in SYS_NOTIFY_WAIT; wait_channel is the notify_t.
+#define WAIT_NOTIFY         7
+// Phase 26: task blocked in SYS_BCAST_READ; wait_channel is the bcast_t.
+#define WAIT_BCAST          8
 
 // Spawn attributes for sys_spawn (Phase 7d). Extended in Phase 17 with
 // handle-inheritance and VMO-backed-executable fields. Existing callers
@@ -283,6 +289,14 @@ typedef struct task_struct {
     // outside the barrier window.
     struct task_struct *barrier_next;
 
+    // Phase 26: incremental-snapshot bookkeeping. snap_last_id is the id of
+    // the last snapshot whose capture walk visited this task — the epoch
+    // its PTE_SNAP_CLEAN bits are relative to. snap_unmap_gen counts user
+    // unmaps (munmap, brk shrink); a delta capture cannot represent a page
+    // that disappeared, so a change since the parent forces a full walk.
+    uint64_t snap_last_id;
+    uint64_t snap_unmap_gen;
+
     // Phase 25 / FU24.I: pointer to the live syscall_frame on the kernel
     // stack while a syscall is executing. Set by syscall_dispatcher at
     // entry; cleared at exit. NULL outside a syscall. Used by
@@ -333,8 +347,21 @@ typedef struct task_struct {
     uint64_t last_rate_refill_tsc;         // last refill TSC
     uint64_t syscall_rate_exceeded_count;  // diagnostic
     uint8_t  syscall_rate_hard_mode;       // 0 = audit-only, 1 = return -EAGAIN
+
+    // Phase 26: this task's VMO mapping index (kernel/mm/vmo.c). NULL until
+    // the first vmo_map into the task; freed by vmo_cleanup_task at reap.
+    struct vmo_as *vmo_as;
+
+    // Phase 26: FXSAVE image of the task's x87/SSE registers, saved and
+    // restored by schedule(). User processes only (fpu_cache, 16-aligned,
+    // SCHED_FPU_STATE_SIZE bytes); kernel tasks never touch vector state
+    // and leave it NULL. Out of line because task_t must stay a 2 KiB slab
+    // object.
+    void *fpu_state;
 } task_t;
 
+#define SCHED_FPU_STATE_SIZE 512
+
 /**
  * @brief Initialize the scheduler
  */
@@ -383,11 +410,36 @@ task_t* sched_get_current_task(void);
 int sched_block_on_channel(void *channel, uint8_t dir, uint64_t timeout_ns,
                            struct task_struct **list_head);
 
+// Phase 26: like sched_block_on_channel, but the decision to sleep is made
+// under sched_lock against a waker-maintained sequence counter: if *seq no
+// longer equals `seen` the call returns 0 without blocking. Wakers bump
+// *seq before calling sched_wake_*_on_channel, so an event that lands
+// between the caller's last readiness check and the link can't be lost.
+// deadline_tick is absolute (g_timer_ticks units); 0 means wait forever.
+int sched_block_on_channel_seq(void *channel, uint8_t dir,
+                               uint64_t deadline_tick,
+                               struct task_struct **list_head,
+                               const volatile uint64_t *seq, uint64_t seen);
+
 // Wake one task off the given waiter list. Returns the woken task or NULL
 // if the list was empty.
 task_t *sched_wake_one_on_channel(struct task_struct **list_head,
                                   int32_t wait_result);
 
+// Phase 26: sched_wake_one_on_channel for request/response IPC, where the
+// waker is about to yield or block. Picks where the woken task runs:
+//   - its CPU is this one, or is idle: as sched_wake_one_on_channel
+//     (the idle case sends the doorbell IPI);
+//   - its CPU is busy, it is unpinned and this CPU has nothing else
+//     ready: migrate it here, so the caller's same-CPU yield hands over
+//     directly and the pair shares a cache;
+//   - otherwise: leave it where it is and send IPI_VEC_WAKEUP with the
+//     target runq's handoff_hint set, so the target preempts its current
+//     user-mode task now rather than at the next tick.
+// Each outcome is counted in the waker CPU's runq (handoff_*).
+task_t *sched_wake_one_on_channel_affine(struct task_struct **list_head,
+                                         int32_t wait_result);
+
 // Phase 24a W2: voluntary yield from a non-blocking caller (caller stays
 // READY; runq head gets dispatched). See sched.c for full rationale.
 // Caller must not hold spinlocks. Used by chan_send / chan_recv after
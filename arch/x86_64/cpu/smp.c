@@ -14,6 +14,7 @@
 #include "../drivers/serial/serial.h"
 #include "../../../kernel/log.h"
 #include "../../../kernel/percpu.h"
+#include "../../../kernel/snap/snapshot.h"
 
 // External assembly function from ap_start.S
 #if LIMINE_API_REVISION >= 1
@@ -137,6 +138,8 @@ void ap_main(struct limine_smp_info *info) {
     write_msr(MSR_GS_BASE, (uint64_t)&g_cpu_locals[info->processor_id]);
     idt_init();
     lapic_init();
+    // TLB shootdown / PCID state for this AP (tlb_init ran on the BSP).
+    tlb_cpu_init(info->processor_id);
     syscall_init();
 
     // Mark as active
@@ -183,6 +186,7 @@ void ap_main(struct limine_smp_info *info) {
     // dispatches this CPU's notional idle task — which is, conceptually,
     // this very loop.
     while (1) {
+        snap_barrier_help();   // Phase 26: see ap_idle_entry
         asm volatile("hlt");
     }
 }
@@ -244,6 +248,10 @@ void smp_init(volatile struct limine_mp_request *mp_request) {
     lapic_init();
     klog(KLOG_INFO, SUBSYS_CORE, "[SMP] LAPIC init done");
 
+    // TLB shootdown mailboxes + PCID probe, before any AP can run.
+    tlb_init();
+    tlb_cpu_init(0);
+
 
 
     // Verify LAPIC is working
@@ -374,6 +382,10 @@ void smp_init(volatile struct limine_smp_request *smp_request) {
 
     // Initialize BSP's LAPIC
     lapic_init();
+
+    // TLB shootdown mailboxes + PCID probe, before any AP can run.
+    tlb_init();
+    tlb_cpu_init(0);
     
     // Verify LAPIC is working
     if (!lapic_is_enabled()) {
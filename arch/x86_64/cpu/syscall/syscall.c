@@ -43,6 +43,9 @@ extern spinlock_t sched_lock;
 #include "../../../../kernel/rtc.h"
 #include "../../../../kernel/cap/deprecated.h"
 #include "../../../../kernel/ipc/channel.h"
+#include "../../../../kernel/ipc/waitset.h"
+#include "../../../../kernel/ipc/notify.h"
+#include "../../../../kernel/ipc/bcast.h"
 #include "../../../../kernel/mm/vmo.h"
 #include "../../../../kernel/io/stream.h"
 #include "../../drivers/ahci/ahci.h"
@@ -151,6 +154,37 @@ static bool user_range_mapped(uint64_t cr3, const void *ptr, size_t size) {
     return true;
 }
 
+// Phase 26: unmap and free the brk pages in [start, end). 2 MiB pages lying
+// wholly inside the range are dropped with one PD clear instead of being
+// split. Frames go back to the PMM only after their TLB shootdown.
+static void brk_release_range(uint64_t cr3, uint64_t start, uint64_t end) {
+    tlb_batch_t batch;
+    uint64_t frames[TLB_BATCH_MAX];
+    uint32_t nframes = 0;
+    tlb_batch_init(&batch, cr3);
+    for (uint64_t page = start; page < end; page += PAGE_SIZE) {
+        if ((page & (HUGE_PAGE_SIZE - 1)) == 0 && end - page >= HUGE_PAGE_SIZE) {
+            uint64_t base = vmm_unmap_huge_page_batched(cr3, page, &batch);
+            if (base) {
+                tlb_batch_flush(&batch);
+                pmm_free_pages((void *)base, HUGE_PAGE_PAGES);
+                page += HUGE_PAGE_SIZE - PAGE_SIZE;
+                continue;
+            }
+        }
+        uint64_t phys = vmm_get_physical_address(cr3, page);
+        if (!phys || !vmm_unmap_page_batched(cr3, page, &batch)) continue;
+        frames[nframes++] = phys;
+        if (nframes == TLB_BATCH_MAX) {
+            tlb_batch_flush(&batch);
+            for (uint32_t i = 0; i < nframes; i++) pmm_free_page((void *)frames[i]);
+            nframes = 0;
+        }
+    }
+    tlb_batch_flush(&batch);
+    for (uint32_t i = 0; i < nframes; i++) pmm_free_page((void *)frames[i]);
+}
+
 // Phase 15b: pledge guard helper. Called at the top of every sensitive
 // syscall handler. If the calling task lacks the named class in its
 // pledge_mask, writes an AUDIT_CAP_VIOLATION entry, stamps -EPLEDGE on
@@ -731,17 +765,26 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 // Growing heap - allocate and map new pages
                 bool success = true;
                 for (uint64_t page = old_brk_page; page < new_brk_page; page += PAGE_SIZE) {
+                    // Phase 26: every whole, aligned 2 MiB stretch of the
+                    // growth gets a large page when the PMM has an aligned
+                    // run free; otherwise fall through to 4 KiB frames.
+                    if ((page & (HUGE_PAGE_SIZE - 1)) == 0 &&
+                        new_brk_page - page >= HUGE_PAGE_SIZE) {
+                        void *run = pmm_alloc_huge_page();
+                        if (run) {
+                            if (vmm_map_huge_page_by_cr3(current->cr3, page, (uint64_t)run,
+                                                         PTE_PRESENT | PTE_WRITABLE | PTE_USER)) {
+                                page += HUGE_PAGE_SIZE - PAGE_SIZE;
+                                continue;
+                            }
+                            pmm_free_pages(run, HUGE_PAGE_PAGES);
+                        }
+                    }
+
                     void *phys = pmm_alloc_page();
                     if (!phys) {
                         // Out of memory - rollback what we allocated
-                        for (uint64_t p = old_brk_page; p < page; p += PAGE_SIZE) {
-                            // Get physical address using vmm
-                            uint64_t old_phys = vmm_get_physical_address(current->cr3, p);
-                            if (old_phys) {
-                                vmm_unmap_page_by_cr3(current->cr3, p);
-                                pmm_free_page((void*)old_phys);
-                            }
-                        }
+                        brk_release_range(current->cr3, old_brk_page, page);
                         success = false;
                         break;
                     }
@@ -751,13 +794,7 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                                             PTE_PRESENT | PTE_WRITABLE | PTE_USER)) {
                         // Mapping failed - free this page and rollback
                         pmm_free_page(phys);
-                        for (uint64_t p = old_brk_page; p < page; p += PAGE_SIZE) {
-                            uint64_t old_phys = vmm_get_physical_address(current->cr3, p);
-                            if (old_phys) {
-                                vmm_unmap_page_by_cr3(current->cr3, p);
-                                pmm_free_page((void*)old_phys);
-                            }
-                        }
+                        brk_release_range(current->cr3, old_brk_page, page);
                         success = false;
                         break;
                     }
@@ -780,13 +817,8 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 rlimit_account_free_mem(current, shrink_pages);
 
                 // Shrinking heap - unmap and free pages
-                for (uint64_t page = new_brk_page; page < old_brk_page; page += PAGE_SIZE) {
-                    uint64_t phys = vmm_get_physical_address(current->cr3, page);
-                    if (phys) {
-                        vmm_unmap_page_by_cr3(current->cr3, page);
-                        pmm_free_page((void*)phys);
-                    }
-                }
+                brk_release_range(current->cr3, new_brk_page, old_brk_page);
+                current->snap_unmap_gen++;
 
                 current->brk = (uint64_t)addr;
                 frame->rax = current->brk;
@@ -2414,6 +2446,34 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 frame->rax = cur_sre ? cur_sre->syscall_rate_exceeded_count : 0;
                 break;
             }
+            // Phase 26: TLB shootdown counters. RSI = tlb_stats_t *.
+            case DEBUG_TLB_STATS: {
+                void *ubuf = (void *)frame->rsi;
+                if (!ubuf || !is_user_pointer(ubuf, sizeof(tlb_stats_t))) {
+                    frame->rax = (uint64_t)-1;
+                    break;
+                }
+                tlb_get_stats((tlb_stats_t *)ubuf);
+                frame->rax = tlb_pcid_enabled() ? 1u : 0u;
+                break;
+            }
+            // Phase 26: page size backing a user VA. RSI = VA.
+            case DEBUG_VM_PAGE_SIZE: {
+                task_t *cur_vps = sched_get_current_task();
+                frame->rax = cur_vps ? vmm_get_page_size(cur_vps->cr3, frame->rsi) : 0;
+                break;
+            }
+            // Phase 26: executable page-cache counters. RSI = user buffer.
+            case DEBUG_ELF_CACHE_STATS: {
+                void *ubuf = (void *)frame->rsi;
+                if (!ubuf || !is_user_pointer(ubuf, sizeof(elf_cache_stats_t))) {
+                    frame->rax = (uint64_t)-1;
+                    break;
+                }
+                elf_cache_get_stats((elf_cache_stats_t *)ubuf);
+                frame->rax = 0;
+                break;
+            }
             default:
                 frame->rax = (uint64_t)-1;
                 break;
@@ -2624,6 +2684,12 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 break;
             }
 
+            // Phase 26: PLEDGE_FLAG_QUERY reads the mask; no audit entry.
+            if (frame->rdi & PLEDGE_FLAG_QUERY) {
+                frame->rax = (uint64_t)cur->pledge_mask.raw;
+                break;
+            }
+
             // Phase 26 Stage D: PLEDGE_FLAG_NARROW_EXEC branch. High bit on
             // RDI signals "atomically spawn child at args.entry_path with
             // narrowed pledges + delegated cap handles". RSI = user pointer
@@ -3089,6 +3155,423 @@ void syscall_dispatcher(struct syscall_frame *frame) {
             break;
         }
 
+        case SYS_WAITSET_CREATE: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur || (uint32_t)frame->rdi != 0) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
+            cap_token_t tok = {0};
+            int rc = waitset_create(cur->id, &tok);
+            frame->rax = rc < 0 ? (uint64_t)(long)rc : tok.raw;
+            break;
+        }
+
+        case SYS_WAITSET_CTL: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t ws_tok = { .raw = frame->rdi };
+            cap_object_t *obj = cap_token_resolve(cur->id, ws_tok, RIGHT_WRITE);
+            waitset_t *ws = (obj && obj->kind == CAP_KIND_WAITSET) ? waitset_get(obj) : NULL;
+            if (!ws) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            cap_token_t src_tok = { .raw = frame->rdx };
+            int rc = waitset_ctl(ws, cur->id, (uint32_t)frame->rsi, src_tok,
+                                 (uint32_t)frame->r10, frame->r8);
+            waitset_put(ws);
+            frame->rax = (uint64_t)(long)rc;
+            break;
+        }
+
+        case SYS_WAITSET_WAIT: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            waitset_event_t *user_ev = (waitset_event_t *)frame->rsi;
+            uint32_t max = (uint32_t)frame->rdx;
+            if (max == 0 || max > WAITSET_WAIT_MAX) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
+            if (!is_user_pointer(user_ev, sizeof(waitset_event_t) * max)) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            cap_token_t ws_tok = { .raw = frame->rdi };
+            cap_object_t *obj = cap_token_resolve(cur->id, ws_tok, RIGHT_READ);
+            waitset_t *ws = (obj && obj->kind == CAP_KIND_WAITSET) ? waitset_get(obj) : NULL;
+            if (!ws) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            // Harvest runs under spinlocks, so fill a kernel bounce buffer
+            // and copy out afterwards (1 KiB at WAITSET_WAIT_MAX).
+            waitset_event_t bounce[WAITSET_WAIT_MAX];
+            int n = waitset_wait(ws, bounce, max, frame->r10);
+            waitset_put(ws);
+            for (int i = 0; i < n; i++) user_ev[i] = bounce[i];
+            frame->rax = (uint64_t)(long)n;
+            break;
+        }
+
+        case SYS_NOTIFY_CREATE: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur || (uint32_t)frame->rdi != 0) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
+            cap_token_t tok = {0};
+            int rc = notify_create(cur->id, NULL, &tok, NULL);
+            frame->rax = rc < 0 ? (uint64_t)(long)rc : tok.raw;
+            break;
+        }
+
+        case SYS_NOTIFY_SIGNAL: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_SEND, "pledge denied: ipc_send")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t n_tok = { .raw = frame->rdi };
+            cap_object_t *obj = cap_token_resolve(cur->id, n_tok, RIGHT_WRITE);
+            if (!obj || obj->kind != CAP_KIND_NOTIFY) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            int rc = notify_signal((notify_t *)obj->kind_data, frame->rsi);
+            frame->rax = (uint64_t)(long)rc;
+            break;
+        }
+
+        case SYS_NOTIFY_WAIT: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t n_tok = { .raw = frame->rdi };
+            cap_object_t *obj = cap_token_resolve(cur->id, n_tok, RIGHT_READ);
+            if (!obj || obj->kind != CAP_KIND_NOTIFY) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            frame->rax = (uint64_t)notify_wait((notify_t *)obj->kind_data,
+                                               frame->rsi);
+            break;
+        }
+
+        case SYS_CHAN_SENDV: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_SEND, "pledge denied: ipc_send")) break;
+            cap_token_t tok = { .raw = frame->rdi };
+            const chan_msg_user_t *user_msgs = (const chan_msg_user_t *)frame->rsi;
+            uint32_t count = (uint32_t)frame->rdx;
+            uint64_t timeout = frame->r10;
+            if (count == 0 || count > CHAN_VEC_MAX) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
+            if (!is_user_pointer(user_msgs, (size_t)count * sizeof(chan_msg_user_t))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            channel_t *c = NULL;
+            uint32_t obj_idx = 0;
+            int rc = chan_resolve_endpoint(cur->id, tok, CHAN_ENDPOINT_WRITE,
+                                            RIGHT_SEND, &c, &obj_idx);
+            if (rc < 0) {
+                audit_write_chan_send(cur->id, 0, rc, "resolve failed");
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            // 16 staged slots are 5 KiB — too much for the syscall stack.
+            channel_msg_t *staged = (channel_msg_t *)kmalloc(
+                (size_t)count * sizeof(channel_msg_t), SUBSYS_CAP);
+            if (!staged) { frame->rax = (uint64_t)(long)CAP_V2_ENOMEM; break; }
+
+            // Marshal in order; a bad message ends the batch before it.
+            uint32_t ready = 0;
+            chan_msg_user_t kmsg;
+            for (; ready < count; ready++) {
+                memcpy(&kmsg, &user_msgs[ready], sizeof(kmsg));
+                rc = chan_marshal_send(cur, &kmsg, &staged[ready]);
+                if (rc < 0) {
+                    audit_write_chan_send(cur->id, obj_idx, rc, "marshal failed");
+                    break;
+                }
+            }
+            if (ready == 0) {
+                kfree(staged);
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            int sent = chan_send_batch(c, cur, staged, ready, timeout);
+            // Whatever didn't reach the ring gives its handles back.
+            for (uint32_t i = (sent > 0 ? (uint32_t)sent : 0); i < ready; i++) {
+                chan_marshal_unsend(cur, &staged[i]);
+            }
+            kfree(staged);
+            frame->rax = (uint64_t)(long)sent;
+            break;
+        }
+
+        case SYS_CHAN_RECVV: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            cap_token_t tok = { .raw = frame->rdi };
+            chan_msg_user_t *user_msgs = (chan_msg_user_t *)frame->rsi;
+            uint32_t max = (uint32_t)frame->rdx;
+            uint64_t timeout = frame->r10;
+            if (max == 0 || max > CHAN_VEC_MAX) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
+            if (!is_user_pointer(user_msgs, (size_t)max * sizeof(chan_msg_user_t))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            channel_t *c = NULL;
+            uint32_t obj_idx = 0;
+            int rc = chan_resolve_endpoint(cur->id, tok, CHAN_ENDPOINT_READ,
+                                            RIGHT_RECV, &c, &obj_idx);
+            if (rc < 0) {
+                audit_write_chan_recv(cur->id, 0, rc, "resolve failed");
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            channel_msg_t *slots = (channel_msg_t *)kmalloc(
+                (size_t)max * sizeof(channel_msg_t), SUBSYS_CAP);
+            if (!slots) { frame->rax = (uint64_t)(long)CAP_V2_ENOMEM; break; }
+            int n = chan_recv_batch(c, cur, slots, max, timeout);
+            long result = n;
+            for (int i = 0; i < n; i++) {
+                rc = chan_marshal_recv(cur, &slots[i], &user_msgs[i]);
+                if (rc < 0) {
+                    // Report what was delivered; an error only if nothing was.
+                    // The undelivered messages (slot i's handles were rolled
+                    // back) go back on the queue for the next recv.
+                    result = i ? i : rc;
+                    uint32_t back = (uint32_t)(n - i);
+                    int kept = chan_unrecv_batch(c, &slots[i], back);
+                    if ((uint32_t)kept < back) {
+                        // Senders refilled the ring meanwhile: the rest
+                        // are gone. Make the loss visible.
+                        audit_write_chan_recv(cur->id, obj_idx, CAP_V2_EAGAIN,
+                                              "recvv requeue overflow");
+                        klog(KLOG_WARN, SUBSYS_SYSCALL,
+                             "[SYS_CHAN_RECVV] pid=%lu dropped %u undelivered messages",
+                             (unsigned long)cur->id, (unsigned)(back - (uint32_t)kept));
+                    }
+                    break;
+                }
+            }
+            kfree(slots);
+            frame->rax = (uint64_t)result;
+            break;
+        }
+
+        case SYS_CHAN_SEND_LOAN: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_SEND, "pledge denied: ipc_send")) break;
+            cap_token_t tok = { .raw = frame->rdi };
+            chan_msg_user_t *user_msg = (chan_msg_user_t *)frame->rsi;
+            chan_loan_t *user_loan = (chan_loan_t *)frame->rdx;
+            uint64_t timeout = frame->r10;
+            if (!is_user_pointer(user_msg, sizeof(chan_msg_user_t)) ||
+                !is_user_pointer(user_loan, sizeof(chan_loan_t))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            channel_t *c = NULL;
+            uint32_t obj_idx = 0;
+            int rc = chan_resolve_endpoint(cur->id, tok, CHAN_ENDPOINT_WRITE,
+                                            RIGHT_SEND, &c, &obj_idx);
+            if (rc < 0) {
+                audit_write_chan_send(cur->id, 0, rc, "resolve failed");
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            chan_msg_user_t kmsg;
+            memcpy(&kmsg, user_msg, sizeof(kmsg));
+            chan_loan_t kloan;
+            memcpy(&kloan, user_loan, sizeof(kloan));
+            channel_msg_t staged;
+            rc = chan_marshal_send(cur, &kmsg, &staged);
+            if (rc < 0) {
+                audit_write_chan_send(cur->id, obj_idx, rc, "marshal failed");
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            rc = chan_loan_attach(cur, &kloan, &staged);
+            if (rc < 0) {
+                chan_marshal_unsend(cur, &staged);
+                audit_write_chan_send(cur->id, obj_idx, rc, "loan failed");
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            rc = chan_send(c, cur, &staged, timeout);
+            if (rc < 0) {
+                chan_loan_cancel(cur, &kloan, &staged);
+                chan_marshal_unsend(cur, &staged);
+            }
+            frame->rax = (uint64_t)(long)rc;
+            break;
+        }
+
+        case SYS_CHAN_RECV_LOAN: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            cap_token_t tok = { .raw = frame->rdi };
+            chan_msg_user_t *user_msg = (chan_msg_user_t *)frame->rsi;
+            chan_loan_t *user_loan = (chan_loan_t *)frame->rdx;
+            uint64_t timeout = frame->r10;
+            if (!is_user_pointer(user_msg, sizeof(chan_msg_user_t)) ||
+                !is_user_pointer(user_loan, sizeof(chan_loan_t))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            channel_t *c = NULL;
+            uint32_t obj_idx = 0;
+            int rc = chan_resolve_endpoint(cur->id, tok, CHAN_ENDPOINT_READ,
+                                            RIGHT_RECV, &c, &obj_idx);
+            if (rc < 0) {
+                audit_write_chan_recv(cur->id, 0, rc, "resolve failed");
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            chan_loan_t kloan;
+            memcpy(&kloan, user_loan, sizeof(kloan));
+            channel_msg_t slot;
+            int bytes = chan_recv(c, cur, &slot, timeout);
+            if (bytes < 0) {
+                frame->rax = (uint64_t)(long)bytes;
+                break;
+            }
+            // A failed map leaves the loan in the slot as a plain VMO handle.
+            (void)chan_loan_map(cur, &slot, &kloan);
+            rc = chan_marshal_recv(cur, &slot, user_msg);
+            if (rc < 0) {
+                // The caller never learns the address; the mapping holds
+                // the loan's only reference, so unmapping frees it.
+                if (kloan.vaddr) (void)vmo_unmap(cur, kloan.vaddr, kloan.len);
+                frame->rax = (uint64_t)(long)rc;
+                break;
+            }
+            memcpy(user_loan, &kloan, sizeof(kloan));
+            frame->rax = (uint64_t)(long)bytes;
+            break;
+        }
+
+        case SYS_CHAN_ADD_WRITER: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_SEND, "pledge denied: ipc_send")) break;
+            cap_token_t tok = { .raw = frame->rdi };
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            channel_t *c = NULL;
+            uint32_t obj_idx = 0;
+            int rc = chan_resolve_endpoint(cur->id, tok, CHAN_ENDPOINT_WRITE,
+                                            RIGHT_SEND, &c, &obj_idx);
+            if (rc < 0) { frame->rax = (uint64_t)(long)rc; break; }
+            cap_token_t wr = {0};
+            rc = chan_add_writer(c, cur->id, (int32_t)frame->rsi, &wr);
+            frame->rax = rc < 0 ? (uint64_t)(long)rc : wr.raw;
+            break;
+        }
+
+        case SYS_BCAST_CREATE: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_SEND, "pledge denied: ipc_send")) break;
+            cap_token_t *user_sub = (cap_token_t *)frame->rsi;
+            if (!is_user_pointer(user_sub, sizeof(cap_token_t))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t pub = {0}, subtok = {0};
+            int rc = bcast_create(cur->id, (uint32_t)frame->rdi, &pub, &subtok);
+            if (rc < 0) { frame->rax = (uint64_t)(long)rc; break; }
+            user_sub->raw = subtok.raw;
+            frame->rax = pub.raw;
+            break;
+        }
+
+        case SYS_BCAST_SUBSCRIBE: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t b_tok = { .raw = frame->rdi };
+            cap_object_t *obj = cap_token_resolve(cur->id, b_tok, RIGHT_READ);
+            if (!obj || obj->kind != CAP_KIND_BCAST || !obj->kind_data) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            cap_token_t s_tok = {0};
+            int rc = bcast_subscribe((bcast_t *)obj->kind_data, cur->id, &s_tok);
+            frame->rax = rc < 0 ? (uint64_t)(long)rc : s_tok.raw;
+            break;
+        }
+
+        case SYS_BCAST_PUBLISH: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_SEND, "pledge denied: ipc_send")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t b_tok = { .raw = frame->rdi };
+            cap_object_t *obj = cap_token_resolve(cur->id, b_tok, RIGHT_WRITE);
+            if (!obj || obj->kind != CAP_KIND_BCAST || !obj->kind_data) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            uint32_t len = (uint32_t)frame->rdx;
+            if (len > BCAST_MSG_MAX) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            uint8_t kbuf[BCAST_MSG_MAX];
+            if (len) {
+                if (!is_user_pointer((const void *)frame->rsi, len)) {
+                    frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                    break;
+                }
+                memcpy(kbuf, (const void *)frame->rsi, len);
+            }
+            frame->rax = (uint64_t)bcast_publish((bcast_t *)obj->kind_data,
+                                                 cur->id, kbuf, len);
+            break;
+        }
+
+        case SYS_BCAST_READ: {
+            if (!pledge_check_and_audit(frame, PLEDGE_CLASS_IPC_RECV, "pledge denied: ipc_recv")) break;
+            task_t *cur = sched_get_current_task();
+            if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            cap_token_t s_tok = { .raw = frame->rdi };
+            bcast_msg_t *user_msgs = (bcast_msg_t *)frame->rsi;
+            uint32_t max = (uint32_t)frame->rdx;
+            cap_object_t *obj = cap_token_resolve(cur->id, s_tok, RIGHT_READ);
+            if (!obj || obj->kind != CAP_KIND_BCAST_SUB || !obj->kind_data) {
+                frame->rax = (uint64_t)(long)CAP_V2_EBADF;
+                break;
+            }
+            if (max == 0 || max > BCAST_READ_MAX) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
+            if (!is_user_pointer(user_msgs, (size_t)max * sizeof(bcast_msg_t))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EFAULT;
+                break;
+            }
+            // Filled under the ring lock, so stage in kernel memory.
+            bcast_msg_t *staged = (bcast_msg_t *)kmalloc(
+                (size_t)max * sizeof(bcast_msg_t), SUBSYS_CAP);
+            if (!staged) { frame->rax = (uint64_t)(long)CAP_V2_ENOMEM; break; }
+            long n = bcast_read((bcast_sub_t *)obj->kind_data, staged, max, frame->r10);
+            if (n > 0) memcpy(user_msgs, staged, (size_t)n * sizeof(bcast_msg_t));
+            kfree(staged);
+            frame->rax = (uint64_t)n;
+            break;
+        }
+
         case SYS_VMO_CREATE: {
             if (!pledge_check_and_audit(frame, PLEDGE_CLASS_COMPUTE, "pledge denied: compute")) break;
             uint64_t size = frame->rdi;
@@ -3114,12 +3597,17 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 break;
             }
             v->cap_object_idx = (uint32_t)idx;
-            uint32_t slot = 0;
-            int rc_ins = cap_handle_insert(&cur->cap_handles, (uint32_t)idx, 0, &slot);
-            if (rc_ins < 0) {
-                cap_object_destroy((uint32_t)idx);
-                frame->rax = (uint64_t)(long)rc_ins;
-                break;
+            // Phase 26: VMO_ANON caps live only until their first map
+            // (see SYS_VMO_MAP), so they never take a handle-table slot;
+            // otherwise a malloc-heavy task would exhaust CAP_HANDLE_MAX.
+            if (!(flags & VMO_ANON)) {
+                uint32_t slot = 0;
+                int rc_ins = cap_handle_insert(&cur->cap_handles, (uint32_t)idx, 0, &slot);
+                if (rc_ins < 0) {
+                    cap_object_destroy((uint32_t)idx);
+                    frame->rax = (uint64_t)(long)rc_ins;
+                    break;
+                }
             }
             cap_object_t *vobj = g_cap_object_ptrs[idx];
             uint32_t vgen = vobj ? __atomic_load_n(&vobj->generation, __ATOMIC_ACQUIRE) : 0;
@@ -3134,6 +3622,8 @@ void syscall_dispatcher(struct syscall_frame *frame) {
             uint64_t offset = frame->rdx;
             uint64_t len = frame->r10;
             uint32_t prot = (uint32_t)frame->r8;
+            bool retire = (prot & VMO_MAP_RETIRE) != 0;
+            prot &= ~VMO_MAP_RETIRE;
 
             // Derive required rights from prot.
             uint64_t required = 0;
@@ -3141,6 +3631,7 @@ void syscall_dispatcher(struct syscall_frame *frame) {
             if (prot & PROT_WRITE) required |= RIGHT_WRITE;
             if (prot & PROT_EXEC)  required |= RIGHT_EXEC;
             if (required == 0) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
+            if (retire) required |= RIGHT_REVOKE;
 
             task_t *cur = sched_get_current_task();
             if (!cur) { frame->rax = (uint64_t)(long)CAP_V2_EINVAL; break; }
@@ -3155,9 +3646,35 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 break;
             }
             vmo_t *v = (vmo_t *)obj->kind_data;
+            // Device memory is never retired: MMIO-region caps and the
+            // VMO_MMIO framebuffer VMO keep their handle.
+            if (retire && (obj->kind != CAP_KIND_VMO || (v->flags & VMO_MMIO))) {
+                frame->rax = (uint64_t)(long)CAP_V2_EINVAL;
+                break;
+            }
             uint64_t va = vmo_map(v, cur, addr_hint, offset, len, prot);
-            if (va == 0) { frame->rax = (uint64_t)(long)CAP_V2_ENOMEM; break; }
-            frame->rax = va;
+            // Phase 26: retire an anonymous VMO's cap at its first map,
+            // successful or not. Clearing the flag first makes the
+            // retirement one-shot; on success the mapping's own reference
+            // keeps the VMO alive, so unmap frees the frames instead of
+            // waiting for owner-exit collection, and on failure the frames
+            // go now (the cap has no handle slot the caller could close).
+            uint32_t aidx = 0;
+            if (__atomic_fetch_and(&v->flags, ~VMO_ANON, __ATOMIC_ACQ_REL) & VMO_ANON) {
+                aidx = v->cap_object_idx;
+                v->cap_object_idx = 0;
+            }
+            // Phase 26: VMO_MAP_RETIRE — free the caller's slot and drop
+            // the cap's VMO reference, mapped or not (see vmo.h). Either
+            // destroy may free v, so nothing reads it past this point.
+            uint32_t oidx = retire ? cap_token_idx(tok) : 0;
+            if (retire) {
+                (void)cap_handle_remove_object(&cur->cap_handles, oidx);
+                if (v->cap_object_idx == oidx) v->cap_object_idx = 0;
+            }
+            if (aidx != 0 && aidx != oidx) cap_object_destroy(aidx);
+            if (oidx != 0) cap_object_destroy(oidx);
+            frame->rax = va ? va : (uint64_t)(long)CAP_V2_ENOMEM;
             break;
         }
 
@@ -4051,7 +4568,10 @@ void syscall_dispatcher(struct syscall_frame *frame) {
                 }
                 kname[SNAP_NAME_MAX_LEN] = '\0';
             }
-            int rc = snap_create(scope_flags, name_user ? kname : NULL);
+            // Phase 26: RDX = parent snapshot handle, read only when
+            // scope_flags carries SNAP_SCOPE_INCREMENTAL.
+            int rc = snap_create(scope_flags, name_user ? kname : NULL,
+                                 (uint32_t)frame->rdx);
             frame->rax = (uint64_t)(long)rc;
             break;
         }
@@ -131,7 +131,8 @@
 #define SYS_CHAN_POLL     1070  // RDI=array ptr, RSI=n, RDX=timeout_ns
 #define SYS_VMO_CREATE    1071  // RDI=size_bytes, RSI=flags
 #define SYS_VMO_MAP       1072  // RDI=vmo_handle, RSI=addr_hint, RDX=offset,
-                                //   R10=len, R8=prot
+                                //   R10=len, R8=prot (| VMO_MAP_RETIRE to
+                                //   consume the handle, Phase 26)
 #define SYS_VMO_UNMAP     1073  // RDI=vaddr, RSI=len
 #define SYS_VMO_CLONE     1074  // RDI=src_handle, RSI=flags
 
@@ -487,6 +488,138 @@
 // caller lacks SYS_CONTROL.  Pledge: SYS_CONTROL unless target_pid == self.
 #define SYS_SET_CPU_AFFINITY       1123
 
+// Phase 26 — wait-sets (kernel/ipc/waitset.h). Multi-handle blocking
+// readiness wait over channel endpoints, IRQ channels and streams.
+//
+// SYS_WAITSET_CREATE — new CAP_KIND_WAITSET in the caller's handle table.
+//   RDI = uint32_t flags (reserved, must be 0)
+// Returns the cap_token_t raw (>0) or -EINVAL / -ENOMEM.  Pledge: IPC_RECV.
+#define SYS_WAITSET_CREATE         1124
+// SYS_WAITSET_CTL — register / modify / remove one source handle.
+//   RDI = uint64_t waitset token (RIGHT_WRITE)
+//   RSI = uint32_t op (WAITSET_CTL_ADD / _MOD / _DEL)
+//   RDX = uint64_t source token (channel endpoint, IRQ channel or stream)
+//   R10 = uint32_t events (WAITSET_EV_* | WAITSET_EDGE | WAITSET_ONESHOT)
+//   R8  = uint64_t cookie (echoed in each event)
+// Returns 0 or -EBADF / -EINVAL / -EBUSY / -ENOMEM.  Pledge: IPC_RECV.
+#define SYS_WAITSET_CTL            1125
+// SYS_WAITSET_WAIT — block until at least one registered source is ready.
+//   RDI = uint64_t waitset token (RIGHT_READ)
+//   RSI = waitset_event_t *events (user buffer)
+//   RDX = uint32_t max_events (1..64)
+//   R10 = uint64_t timeout_ns (0 = poll, UINT64_MAX = forever)
+// Returns the number of events written (0 on timeout) or -EBADF / -EFAULT
+// / -EINVAL / -EPIPE.  Pledge: IPC_RECV.
+#define SYS_WAITSET_WAIT           1126
+
+// Phase 26 — notify objects (kernel/ipc/notify.h). A pending-bits word plus
+// wait queue used as the doorbell for shared-memory rings; signals that
+// land while the consumer has not collected the word are coalesced.
+//
+// SYS_NOTIFY_CREATE — new CAP_KIND_NOTIFY in the caller's handle table.
+//   RDI = uint32_t flags (reserved, must be 0)
+// Returns the cap_token_t raw (>0) or -EINVAL / -ENOMEM.  Pledge: IPC_RECV.
+#define SYS_NOTIFY_CREATE          1127
+// SYS_NOTIFY_SIGNAL — OR bits into the word, waking the consumer on the
+// 0 → non-zero transition only.
+//   RDI = uint64_t notify token (RIGHT_WRITE)
+//   RSI = uint64_t bits (non-zero, low 32 bits only)
+// Returns 0 or -EBADF / -EINVAL / -EPIPE.  Pledge: IPC_SEND.
+#define SYS_NOTIFY_SIGNAL          1128
+// SYS_NOTIFY_WAIT — collect and clear the pending bits.
+//   RDI = uint64_t notify token (RIGHT_READ)
+//   RSI = uint64_t timeout_ns (0 = poll, UINT64_MAX = forever)
+// Returns the bits (>0), 0 on timeout, or -EBADF / -EPIPE.  Pledge: IPC_RECV.
+#define SYS_NOTIFY_WAIT            1129
+
+// Phase 26 — vectored channel I/O. Same semantics as SYS_CHAN_SEND / RECV
+// but moves up to CHAN_VEC_MAX messages per trap under one ring-lock hold.
+//
+// SYS_CHAN_SENDV — queue as many messages as fit, in order.
+//   RDI = uint64_t write-end token (RIGHT_SEND)
+//   RSI = const chan_msg_user_t *msgs
+//   RDX = uint32_t count (1..CHAN_VEC_MAX)
+//   R10 = uint64_t timeout_ns (applies only while nothing fits)
+// Returns the number queued (>0) or the error for msgs[0]. Handles in
+// unqueued messages stay with the sender.  Pledge: IPC_SEND.
+#define SYS_CHAN_SENDV             1130
+// SYS_CHAN_RECVV — dequeue up to max messages.
+//   RDI = uint64_t read-end token (RIGHT_RECV)
+//   RSI = chan_msg_user_t *msgs (user buffer)
+//   RDX = uint32_t max (1..CHAN_VEC_MAX)
+//   R10 = uint64_t timeout_ns (applies only while the ring is empty)
+// Returns the number of messages written (>0) or a negative errno.
+// Pledge: IPC_RECV.
+#define SYS_CHAN_RECVV             1131
+
+// Phase 26 — page-loan channel transfers (kernel/ipc/channel.h chan_loan_t).
+// A message carries a page range of the sender's VMO mappings: COW-shared
+// by default, or moved outright with CHAN_LOAN_MOVE.
+//
+// SYS_CHAN_SEND_LOAN — SYS_CHAN_SEND plus one loaned range.
+//   RDI = uint64_t write-end token (RIGHT_SEND)
+//   RSI = const chan_msg_user_t *msg (nhandles <= 7: the loan takes a slot)
+//   RDX = const chan_loan_t *loan {vaddr, len, flags}
+//   R10 = uint64_t timeout_ns
+// Returns 0 or -EINVAL / -EFAULT / -EPERM / -EBUSY / -ENOMEM / any
+// SYS_CHAN_SEND error; on failure a moved range is mapped back.
+// Pledge: IPC_SEND.
+#define SYS_CHAN_SEND_LOAN         1132
+// SYS_CHAN_RECV_LOAN — SYS_CHAN_RECV that maps an attached loan.
+//   RDI = uint64_t read-end token (RIGHT_RECV)
+//   RSI = chan_msg_user_t *msg
+//   RDX = chan_loan_t *loan (in: vaddr = placement hint or 0; out: vaddr,
+//         len, prot — all 0 if the message carried no loan)
+//   R10 = uint64_t timeout_ns
+// Returns inline bytes as SYS_CHAN_RECV. If the range cannot be mapped it
+// is delivered as the message's last handle (a VMO) and loan->vaddr is 0.
+// Pledge: IPC_RECV.
+#define SYS_CHAN_RECV_LOAN         1133
+
+// Phase 26 — multi-producer channels. A channel created with
+// CHAN_MODE_MPSC OR'd into its mode may have several write endpoints; the
+// reader sees EPIPE / HUP only once the last of them closes.
+//
+// SYS_CHAN_ADD_WRITER — mint another write endpoint.
+//   RDI = uint64_t write-end token of an MPSC channel (RIGHT_SEND)
+//   RSI = int32_t peer pid added to the new cap's audience (<= 0 = none)
+// Returns the new write-end token raw (>0) or -EBADF / -EINVAL / -ENOMEM.
+// Pledge: IPC_SEND.
+#define SYS_CHAN_ADD_WRITER        1134
+
+// Phase 26 — broadcast rings (kernel/ipc/bcast.h). One publish is one copy
+// however many subscribers read it; each subscriber is a cursor with its
+// own overrun count. The publisher never blocks.
+//
+// SYS_BCAST_CREATE — new ring; caller gets the publisher cap.
+//   RDI = uint32_t capacity (1..BCAST_CAPACITY_MAX messages)
+//   RSI = cap_token_t *sub_tok_out (the public subscribe cap)
+// Returns the publisher token raw (>0) or -EINVAL / -EFAULT / -ENOMEM.
+// Pledge: IPC_SEND.
+#define SYS_BCAST_CREATE           1135
+// SYS_BCAST_SUBSCRIBE — open a cursor at the next message published.
+//   RDI = uint64_t subscribe (or publisher) token (RIGHT_READ)
+// Returns the CAP_KIND_BCAST_SUB token raw (>0) or -EBADF / -EPIPE /
+// -ENOMEM.  Pledge: IPC_RECV.
+#define SYS_BCAST_SUBSCRIBE        1136
+// SYS_BCAST_PUBLISH — copy one message into the ring.
+//   RDI = uint64_t publisher token (RIGHT_WRITE)
+//   RSI = const void *payload
+//   RDX = uint32_t len (0..BCAST_MSG_MAX)
+// Returns the message's seq (>=0) or -EBADF / -EFAULT / -EINVAL.
+// Pledge: IPC_SEND.
+#define SYS_BCAST_PUBLISH          1137
+// SYS_BCAST_READ — read past the cursor.
+//   RDI = uint64_t subscriber token (RIGHT_READ)
+//   RSI = bcast_msg_t *msgs (user buffer)
+//   RDX = uint32_t max (1..BCAST_READ_MAX)
+//   R10 = uint64_t timeout_ns (0 = poll, UINT64_MAX = forever)
+// Returns the number of messages written (0 on timeout), or -EPIPE once
+// the publisher has closed and everything has been read. msgs[0].lost
+// counts messages overwritten before this subscriber reached them.
+// Pledge: IPC_RECV.
+#define SYS_BCAST_READ             1138
+
 // Resource identifiers for SYS_SETRLIMIT / SYS_GETRLIMIT.
 #define RLIMIT_MEM            1     // pages (4 KiB each); 0 = unlimited
 #define RLIMIT_CPU            2     // ns per 1-second epoch (max 1_000_000_000); 0 = unlimited
@@ -644,6 +777,17 @@
 // gcp.json → manifest blob/hash unchanged); consistent with libtui already
 // driving DEBUG_CONSOLE_SYNTHETIC_RENDER in its present path.
 #define DEBUG_CONSOLE_MARK_DIRTY            99
+// Phase 26 (TLB shootdown): copy tlb_stats_t (arch/x86_64/mm/tlb.h) to the
+// user buffer at RSI. Returns 1 if PCID tagging is active, 0 if not, -1 on
+// a bad pointer.
+#define DEBUG_TLB_STATS                     100
+// Phase 26 (huge pages): RSI = user VA in the caller's address space.
+// Returns the size of the translation covering it (4096 or 2097152), or 0
+// if unmapped.
+#define DEBUG_VM_PAGE_SIZE                  101
+// Phase 26 (executable page cache): copy elf_cache_stats_t (kernel/elf.h)
+// to the user buffer at RSI. Returns 0, or -1 on a bad pointer.
+#define DEBUG_ELF_CACHE_STATS               102
 
 void syscall_init(void);
 void syscall_dispatcher(struct syscall_frame *frame);
@@ -85,6 +85,11 @@ volatile uint32_t* lapic_get_base(void);
 // free slot after the 16 standard device IRQs (32..47).
 #define IPI_VEC_WAKEUP  48u
 
+// TLB shootdown IPI (arch/x86_64/mm/tlb.c). Vectors 50..65 are the
+// userspace-driver IRQ pool, so the shootdown takes the first slot after
+// it. The handler drains the receiving CPU's shootdown mailbox.
+#define IPI_VEC_TLB_SHOOTDOWN  66u
+
 /**
  * @brief Send an IPI to a specific CPU. The target CPU's IDT entry for
  *        `vector` will fire. Used by Phase 20 cross-CPU wakeup to nudge a
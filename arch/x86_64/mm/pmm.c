@@ -196,6 +196,38 @@ void *pmm_alloc_pages(size_t num_pages) {
     return NULL; // Not enough contiguous pages
 }
 
+void *pmm_alloc_huge_page(void) {
+    extern int64_t g_debug_pmm_fail_nth;
+    if (g_debug_pmm_fail_nth > 0) {
+        if (--g_debug_pmm_fail_nth == 0) return NULL;
+    }
+
+    // A 2 MiB-aligned run of 512 frames is exactly 64 aligned bitmap
+    // bytes, so test it as eight uint64_t words rather than bit by bit.
+    uint64_t chunks = total_pages / PMM_HUGE_PAGE_PAGES;
+
+    spinlock_acquire(&pmm_lock);
+    for (uint64_t c = chunks; c-- > 0; ) {
+        const uint64_t *w = (const uint64_t *)(bitmap + c * (PMM_HUGE_PAGE_PAGES / 8));
+        bool free = true;
+        for (int i = 0; i < PMM_HUGE_PAGE_PAGES / 64; i++) {
+            if (w[i] != 0) { free = false; break; }
+        }
+        if (!free) continue;
+
+        uint64_t start_page = c * PMM_HUGE_PAGE_PAGES;
+        for (uint64_t j = 0; j < PMM_HUGE_PAGE_PAGES; j++) {
+            bitmap_set_bit(start_page + j);
+            pp_refcounts[start_page + j] = 1;
+        }
+        used_pages += PMM_HUGE_PAGE_PAGES;
+        spinlock_release(&pmm_lock);
+        return (void *)(start_page * PAGE_SIZE);
+    }
+    spinlock_release(&pmm_lock);
+    return NULL;
+}
+
 void pmm_free_page(void *page) {
     if (!page) return;
 
@@ -205,7 +237,10 @@ void pmm_free_page(void *page) {
 
     if (page_index < total_pages && bitmap_test_bit(page_index)) {
         // Phase 17: decrement refcount; actually free only at zero.
-        if (pp_refcounts[page_index] > 0) {
+        // Phase 26: a saturated count is sticky — once references were
+        // dropped on the floor we can no longer tell when the last one goes.
+        if (pp_refcounts[page_index] > 0 &&
+            pp_refcounts[page_index] < PMM_REF_SATURATED) {
             pp_refcounts[page_index]--;
         }
         if (pp_refcounts[page_index] == 0) {
@@ -231,7 +266,10 @@ void pmm_free_pages(void *pages, size_t num_pages) {
     for (size_t i = 0; i < num_pages; i++) {
         uint64_t page_index = start_page_index + i;
         if (page_index < total_pages && bitmap_test_bit(page_index)) {
-            if (pp_refcounts[page_index] > 0) pp_refcounts[page_index]--;
+            if (pp_refcounts[page_index] > 0 &&
+                pp_refcounts[page_index] < PMM_REF_SATURATED) {
+                pp_refcounts[page_index]--;
+            }
             if (pp_refcounts[page_index] == 0) {
                 bitmap_clear_bit(page_index);
                 used_pages--;
@@ -269,9 +307,10 @@ void pmm_page_ref(void *page) {
     uint64_t idx = (uint64_t)page / PAGE_SIZE;
     spinlock_acquire(&pmm_lock);
     if (idx < total_pages && bitmap_test_bit(idx)) {
-        // Saturate at 255. Sharing a page 256-ways pins it forever, which is
-        // acceptable for Phase 17 scale (fewer than 256 processes).
-        if (pp_refcounts[idx] < 255) pp_refcounts[idx]++;
+        // Saturate at 255. Sharing a page 256-ways pins it forever (the
+        // free paths never decrement a saturated count); cached executable
+        // text shared by a large worker fan-out reaches this.
+        if (pp_refcounts[idx] < PMM_REF_SATURATED) pp_refcounts[idx]++;
     }
     spinlock_release(&pmm_lock);
 }
@@ -27,6 +27,19 @@ void *pmm_alloc_page(void);
  */
 void *pmm_alloc_pages(size_t num_pages);
 
+// Phase 26: 4 KiB frames per 2 MiB huge page.
+#define PMM_HUGE_PAGE_PAGES 512
+
+/**
+ * @brief Allocate a 2 MiB-aligned run of PMM_HUGE_PAGE_PAGES frames
+ * Each frame gets its own refcount of 1, exactly as if it came from
+ * pmm_alloc_page, so the run may later be freed (or shared) frame by frame.
+ * Searches top-down so huge runs and the bottom-up single-page allocator
+ * fragment each other as little as possible.
+ * @return Physical address of the first frame, or NULL if no free aligned run
+ */
+void *pmm_alloc_huge_page(void);
+
 /**
  * @brief Free a previously allocated physical page
  * @param page Physical address of page to free
@@ -60,9 +73,11 @@ uint64_t pmm_get_free_memory(void);
 // call pmm_page_ref() once per additional owner. pmm_free_page() now
 // decrements; the page is returned to the bitmap only when refcount==0.
 //
-// Counts saturate at 255. Freeing a page at refcount==0 is a no-op (the
-// existing bitmap check protects against double-free).
+// Counts saturate at 255 and a saturated page is pinned: frees no longer
+// decrement it. Freeing a page at refcount==0 is a no-op (the existing
+// bitmap check protects against double-free).
 // ---------------------------------------------------------------------------
+#define PMM_REF_SATURATED 255u
 void pmm_page_ref(void *page);
 void pmm_page_unref(void *page);   // alias for pmm_free_page
 uint8_t pmm_page_get_refcount(void *page);
\ No newline at end of file
@@ -0,0 +1,388 @@
+// arch/x86_64/mm/tlb.c — cross-CPU TLB shootdown + PCID switching.
+// See tlb.h for the model and the ordering contract.
+
+#include "tlb.h"
+#include "vmm.h"
+#include "../cpu/smp.h"
+#include "../cpu/tsc.h"
+#include "../drivers/lapic/lapic.h"
+#include "../../../kernel/sync/spinlock.h"
+#include "../../../kernel/log.h"
+#include "../../../kernel/panic.h"
+
+// CR3 bits 12..51 carry the PML4 phys; 0..11 carry the PCID when
+// CR4.PCIDE=1. Bit 63 on a CR3 write means "do not flush this PCID".
+#define TLB_CR3_ADDR_MASK   0x000FFFFFFFFFF000ULL
+#define TLB_CR3_PCID_MASK   0x0000000000000FFFULL
+#define TLB_CR3_NOFLUSH     (1ULL << 63)
+#define TLB_CR4_PCIDE       (1ULL << 17)
+#define TLB_CPUID1_ECX_PCID (1u << 17)
+
+// How long a shooter waits for a peer's ack before re-sending the IPI. A
+// peer only misses that window if it sits in an interrupts-disabled section
+// or the IPI was lost; the request stays queued in its mailbox either way.
+// The shooter never proceeds without the ack — the caller is about to free
+// or reuse the pages — so after TLB_ACK_RESEND_MAX windows (~1 s) a peer
+// that still has not answered is wedged and we panic.
+#define TLB_ACK_TIMEOUT_NS  50000000ULL   // 50 ms
+#define TLB_ACK_SPIN_CAP    50000000u     // pre-TSC fallback
+#define TLB_ACK_RESEND_MAX  20u
+
+// Per-target request mailbox. Shooters append under `lock`; the target
+// drains everything up to req_seq in one IPI and publishes ack_seq.
+typedef struct tlb_mailbox {
+    spinlock_t        lock;
+    uint64_t          cr3;              // 0 with count/full set = mixed mm
+    uint32_t          count;
+    bool              full;
+    uint64_t          va[TLB_BATCH_MAX];
+    volatile uint64_t req_seq;
+    volatile uint64_t ack_seq;
+} __attribute__((aligned(64))) tlb_mailbox_t;
+
+// Per-CPU address-space state. active_cr3 is read cross-CPU by shooters;
+// slot_cr3[] entries are cleared cross-CPU (lazy invalidation) and only
+// ever written non-zero by the owning CPU.
+typedef struct tlb_cpu {
+    volatile uint64_t active_cr3;       // bare PML4 phys, 0 = not yet init
+    uint32_t          active_slot;      // index into slot_cr3, valid if pcid
+    uint32_t          next_victim;      // round-robin eviction cursor
+    volatile uint64_t slot_cr3[TLB_PCID_SLOTS];
+} __attribute__((aligned(64))) tlb_cpu_t;
+
+static tlb_mailbox_t g_tlb_mailbox[MAX_CPUS];
+static tlb_cpu_t     g_tlb_cpu[MAX_CPUS];
+static tlb_stats_t   g_tlb_stats;
+static bool          g_tlb_pcid_supported = false;
+static bool          g_tlb_pcid_enabled   = false;
+
+#define TLB_STAT_INC(field, n) \
+    __atomic_fetch_add(&g_tlb_stats.field, (uint64_t)(n), __ATOMIC_RELAXED)
+
+static inline uint64_t tlb_read_cr3(void) {
+    uint64_t v;
+    __asm__ volatile("mov %%cr3, %0" : "=r"(v));
+    return v;
+}
+
+static inline void tlb_write_cr3(uint64_t v) {
+    __asm__ volatile("mov %0, %%cr3" : : "r"(v) : "memory");
+}
+
+static inline void tlb_invlpg(uint64_t va) {
+    __asm__ volatile("invlpg (%0)" : : "r"(va) : "memory");
+}
+
+// Flush every non-global translation of the CURRENT context (current PCID
+// only when PCIDE=1). CR3 reads never return bit 63, so writing the value
+// back is a flushing load.
+static inline void tlb_flush_current(void) {
+    tlb_write_cr3(tlb_read_cr3());
+    TLB_STAT_INC(full_flushes, 1);
+}
+
+// Drop `cr3` from cpu's PCID cache unless it is the running context. Safe
+// to call cross-CPU: a racing tlb_switch_mm on that CPU is covered by the
+// active_cr3 check the caller performs after this.
+static void tlb_drop_slot(tlb_cpu_t *c, uint64_t cr3, bool count_lazy) {
+    for (uint32_t s = 0; s < TLB_PCID_SLOTS; s++) {
+        uint64_t expected = cr3;
+        if (__atomic_compare_exchange_n(&c->slot_cr3[s], &expected, 0,
+                                        false, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_RELAXED)) {
+            if (count_lazy) TLB_STAT_INC(lazy_invalidations, 1);
+        }
+    }
+}
+
+// Apply an invalidation request on the calling CPU.
+static void tlb_apply_local(uint32_t cpu, uint64_t cr3, const uint64_t *va,
+                            uint32_t count, bool full) {
+    tlb_cpu_t *c = &g_tlb_cpu[cpu];
+    uint64_t active = c->active_cr3;
+
+    if (cr3 == 0) {
+        // Mixed mailbox: we lost track of which mm each VA belonged to.
+        // Forget every cached-but-inactive context and flush the live one.
+        if (g_tlb_pcid_enabled) {
+            for (uint32_t s = 0; s < TLB_PCID_SLOTS; s++) {
+                if (s == c->active_slot) continue;
+                __atomic_store_n(&c->slot_cr3[s], 0, __ATOMIC_SEQ_CST);
+            }
+        }
+        tlb_flush_current();
+        return;
+    }
+
+    if (active == cr3) {
+        if (full) {
+            tlb_flush_current();
+        } else {
+            for (uint32_t i = 0; i < count; i++) tlb_invlpg(va[i]);
+            TLB_STAT_INC(pages_invalidated, count);
+        }
+        return;
+    }
+
+    // Not running here. Without PCID the last CR3 switch already flushed
+    // it; with PCID make sure the next switch-in does.
+    if (g_tlb_pcid_enabled) tlb_drop_slot(c, cr3, true);
+}
+
+// Drain this CPU's mailbox. Called from the IPI handler and from a
+// shooter's ack-wait loop (so mutual shootdowns with IF=0 make progress).
+static void tlb_service_mailbox(uint32_t cpu) {
+    tlb_mailbox_t *mb = &g_tlb_mailbox[cpu];
+    if (__atomic_load_n(&mb->ack_seq, __ATOMIC_ACQUIRE) ==
+        __atomic_load_n(&mb->req_seq, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    uint64_t va[TLB_BATCH_MAX];
+    spinlock_acquire(&mb->lock);
+    uint64_t seq   = mb->req_seq;
+    uint64_t cr3   = mb->cr3;
+    uint32_t count = mb->count;
+    bool     full  = mb->full;
+    for (uint32_t i = 0; i < count; i++) va[i] = mb->va[i];
+    mb->cr3   = 0;
+    mb->count = 0;
+    mb->full  = false;
+    spinlock_release(&mb->lock);
+
+    if (count != 0 || full) tlb_apply_local(cpu, cr3, va, count, full);
+    __atomic_store_n(&mb->ack_seq, seq, __ATOMIC_RELEASE);
+}
+
+// Merge a request into target's mailbox. Caller sends the IPI.
+static void tlb_post(uint32_t target, uint64_t cr3, const uint64_t *va,
+                     uint32_t count, bool full) {
+    tlb_mailbox_t *mb = &g_tlb_mailbox[target];
+    spinlock_acquire(&mb->lock);
+    bool empty = (mb->count == 0 && !mb->full);
+    if (empty) {
+        mb->cr3 = cr3;
+    } else if (mb->cr3 != cr3) {
+        // Two address spaces queued at once — degrade to mixed.
+        mb->cr3  = 0;
+        mb->full = true;
+    }
+    if (full || mb->count + count > TLB_BATCH_MAX) {
+        mb->full = true;
+    }
+    if (!mb->full) {
+        for (uint32_t i = 0; i < count; i++) mb->va[mb->count++] = va[i];
+    }
+    mb->req_seq++;
+    spinlock_release(&mb->lock);
+}
+
+static void tlb_wait_ack(uint32_t self, uint32_t target) {
+    tlb_mailbox_t *mb = &g_tlb_mailbox[target];
+    // Any ack at or past the req_seq observed now covers our post.
+    uint64_t want = __atomic_load_n(&mb->req_seq, __ATOMIC_ACQUIRE);
+    bool tsc_ok = tsc_is_ready();
+    uint64_t deadline = tsc_ok ? rdtsc() + ns_to_tsc(TLB_ACK_TIMEOUT_NS) : 0;
+    uint32_t spins = 0;
+    uint32_t resends = 0;
+    while (__atomic_load_n(&mb->ack_seq, __ATOMIC_ACQUIRE) < want) {
+        tlb_service_mailbox(self);
+        __asm__ volatile("pause" ::: "memory");
+        if (tsc_ok ? (rdtsc() > deadline) : (++spins > TLB_ACK_SPIN_CAP)) {
+            TLB_STAT_INC(ack_timeouts, 1);
+            if (++resends > TLB_ACK_RESEND_MAX) {
+                klog(KLOG_ERROR, SUBSYS_MM,
+                     "tlb: cpu %u never acked cpu %u (req=%lu ack=%lu)",
+                     (unsigned)target, (unsigned)self, (unsigned long)want,
+                     (unsigned long)mb->ack_seq);
+                kpanic("tlb: shootdown ack never arrived");
+            }
+            klog(KLOG_WARN, SUBSYS_MM,
+                 "tlb: cpu %u ack timeout from cpu %u (req=%lu ack=%lu), "
+                 "re-sending IPI",
+                 (unsigned)self, (unsigned)target, (unsigned long)want,
+                 (unsigned long)mb->ack_seq);
+            apic_send_ipi(g_cpu_info[target].lapic_id, IPI_VEC_TLB_SHOOTDOWN);
+            TLB_STAT_INC(ipis_sent, 1);
+            deadline = tsc_ok ? rdtsc() + ns_to_tsc(TLB_ACK_TIMEOUT_NS) : 0;
+            spins = 0;
+        }
+    }
+}
+
+static void tlb_shoot(uint64_t cr3, const uint64_t *va, uint32_t count,
+                      bool full) {
+    cr3 &= TLB_CR3_ADDR_MASK;
+    TLB_STAT_INC(shootdowns, 1);
+
+    uint32_t ncpu = g_cpu_count;
+    if (ncpu <= 1) {
+        tlb_apply_local(smp_get_current_cpu(), cr3, va, count, full);
+        return;
+    }
+
+    // Pin to this CPU for the duration: a migration between the local
+    // apply and the peer scan would skip the CPU we land on.
+    percpu_preempt_disable();
+    uint32_t self = smp_get_current_cpu();
+    tlb_apply_local(self, cr3, va, count, full);
+
+    // PTE stores must be globally visible before we sample active_cr3.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    uint64_t targets[MAX_CPUS / 64] = {0};
+    bool any = false;
+    for (uint32_t i = 0; i < ncpu; i++) {
+        if (i == self || !g_cpu_info[i].active) continue;
+        tlb_cpu_t *c = &g_tlb_cpu[i];
+        if (g_tlb_pcid_enabled) tlb_drop_slot(c, cr3, true);
+        if (__atomic_load_n(&c->active_cr3, __ATOMIC_SEQ_CST) != cr3) continue;
+        tlb_post(i, cr3, va, count, full);
+        apic_send_ipi(g_cpu_info[i].lapic_id, IPI_VEC_TLB_SHOOTDOWN);
+        TLB_STAT_INC(ipis_sent, 1);
+        targets[i / 64] |= 1ULL << (i % 64);
+        any = true;
+    }
+
+    if (any) {
+        for (uint32_t i = 0; i < ncpu; i++) {
+            if (targets[i / 64] & (1ULL << (i % 64))) tlb_wait_ack(self, i);
+        }
+    }
+    percpu_preempt_enable();
+}
+
+// ---------------------------------------------------------------------------
+// Public API.
+// ---------------------------------------------------------------------------
+
+void tlb_init(void) {
+    for (uint32_t i = 0; i < MAX_CPUS; i++) {
+        spinlock_init(&g_tlb_mailbox[i].lock, "tlb_mbox");
+    }
+    uint32_t eax, ebx, ecx, edx;
+    __asm__ volatile("cpuid"
+                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                     : "a"(1), "c"(0));
+    g_tlb_pcid_supported = (ecx & TLB_CPUID1_ECX_PCID) != 0;
+    klog(KLOG_INFO, SUBSYS_MM, "tlb: PCID %s",
+         g_tlb_pcid_supported ? "supported" : "not supported");
+}
+
+void tlb_cpu_init(uint32_t cpu_id) {
+    if (cpu_id >= MAX_CPUS) return;
+    tlb_cpu_t *c = &g_tlb_cpu[cpu_id];
+    uint64_t cur = tlb_read_cr3();
+
+    for (uint32_t s = 0; s < TLB_PCID_SLOTS; s++) c->slot_cr3[s] = 0;
+    c->next_victim = 0;
+
+    if (g_tlb_pcid_supported) {
+        // CR4.PCIDE may only be set while CR3[11:0] == 0 (else #GP). Every
+        // CPU must agree on PCIDE — tlb_switch_mm writes tagged CR3 values
+        // (bit 63 is reserved with PCIDE=0) — so strip PWT/PCD if the
+        // bootloader left them set rather than skipping this CPU.
+        if (cur & TLB_CR3_PCID_MASK) {
+            cur &= TLB_CR3_ADDR_MASK;
+            tlb_write_cr3(cur);
+        }
+        uint64_t cr4;
+        __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+        cr4 |= TLB_CR4_PCIDE;
+        __asm__ volatile("mov %0, %%cr4" : : "r"(cr4) : "memory");
+        if (cpu_id == 0) g_tlb_pcid_enabled = true;
+    }
+
+    // The boot PML4 runs untagged (PCID 0) until the first tlb_switch_mm.
+    __atomic_store_n(&c->active_cr3, cur & TLB_CR3_ADDR_MASK, __ATOMIC_SEQ_CST);
+    c->active_slot = TLB_PCID_SLOTS;   // "no slot" sentinel
+}
+
+void tlb_switch_mm(uint32_t cpu_id, uint64_t cr3) {
+    cr3 &= TLB_CR3_ADDR_MASK;
+    tlb_cpu_t *c = &g_tlb_cpu[cpu_id];
+    if (c->active_cr3 == cr3) return;
+
+    // Publish first — see the ordering contract in tlb.h.
+    __atomic_store_n(&c->active_cr3, cr3, __ATOMIC_SEQ_CST);
+
+    if (!g_tlb_pcid_enabled) {
+        tlb_write_cr3(cr3);
+        return;
+    }
+
+    for (uint32_t s = 0; s < TLB_PCID_SLOTS; s++) {
+        if (__atomic_load_n(&c->slot_cr3[s], __ATOMIC_SEQ_CST) == cr3) {
+            c->active_slot = s;
+            tlb_write_cr3(cr3 | (uint64_t)(s + 1) | TLB_CR3_NOFLUSH);
+            TLB_STAT_INC(pcid_hits, 1);
+            return;
+        }
+    }
+
+    uint32_t v = c->next_victim;
+    c->next_victim = (v + 1) % TLB_PCID_SLOTS;
+    __atomic_store_n(&c->slot_cr3[v], cr3, __ATOMIC_SEQ_CST);
+    c->active_slot = v;
+    tlb_write_cr3(cr3 | (uint64_t)(v + 1));   // flushing load for this PCID
+    TLB_STAT_INC(pcid_misses, 1);
+}
+
+void tlb_shootdown_page(uint64_t cr3, uint64_t va) {
+    tlb_shoot(cr3, &va, 1, false);
+}
+
+void tlb_batch_init(tlb_batch_t *b, uint64_t cr3) {
+    b->cr3   = cr3 & TLB_CR3_ADDR_MASK;
+    b->count = 0;
+    b->full  = false;
+}
+
+void tlb_batch_add(tlb_batch_t *b, uint64_t va) {
+    if (b->full) return;
+    if (b->count >= TLB_BATCH_MAX) {
+        b->full = true;
+        return;
+    }
+    b->va[b->count++] = va & ~0xFFFULL;
+}
+
+void tlb_batch_flush(tlb_batch_t *b) {
+    if (b->count == 0 && !b->full) return;
+    tlb_shoot(b->cr3, b->va, b->count, b->full);
+    b->count = 0;
+    b->full  = false;
+}
+
+void tlb_mm_release(uint64_t cr3) {
+    cr3 &= TLB_CR3_ADDR_MASK;
+    if (!g_tlb_pcid_enabled) return;
+    uint32_t ncpu = g_cpu_count ? g_cpu_count : 1;
+    for (uint32_t i = 0; i < ncpu && i < MAX_CPUS; i++) {
+        tlb_drop_slot(&g_tlb_cpu[i], cr3, false);
+    }
+}
+
+void tlb_shootdown_ipi_handler(void) {
+    tlb_service_mailbox(smp_get_current_cpu());
+}
+
+void tlb_poll_mailbox(void) {
+    tlb_service_mailbox(smp_get_current_cpu());
+}
+
+void tlb_get_stats(tlb_stats_t *out) {
+    if (!out) return;
+    out->shootdowns         = __atomic_load_n(&g_tlb_stats.shootdowns, __ATOMIC_RELAXED);
+    out->ipis_sent          = __atomic_load_n(&g_tlb_stats.ipis_sent, __ATOMIC_RELAXED);
+    out->pages_invalidated  = __atomic_load_n(&g_tlb_stats.pages_invalidated, __ATOMIC_RELAXED);
+    out->full_flushes       = __atomic_load_n(&g_tlb_stats.full_flushes, __ATOMIC_RELAXED);
+    out->pcid_hits          = __atomic_load_n(&g_tlb_stats.pcid_hits, __ATOMIC_RELAXED);
+    out->pcid_misses        = __atomic_load_n(&g_tlb_stats.pcid_misses, __ATOMIC_RELAXED);
+    out->lazy_invalidations = __atomic_load_n(&g_tlb_stats.lazy_invalidations, __ATOMIC_RELAXED);
+    out->ack_timeouts       = __atomic_load_n(&g_tlb_stats.ack_timeouts, __ATOMIC_RELAXED);
+}
+
+bool tlb_pcid_enabled(void) {
+    return g_tlb_pcid_enabled;
+}
@@ -0,0 +1,113 @@
+// arch/x86_64/mm/tlb.h
+//
+// Cross-CPU TLB shootdown + PCID-tagged address-space switching.
+//
+// Before this module every PTE update in vmm.c issued a local `invlpg`
+// only. On SMP that left stale translations on any other CPU currently
+// running the same address space (snapshot COW downgrades from
+// snap_walk_user_half, VMO unmaps, cow_fault remaps performed on behalf
+// of a task that later migrated).
+//
+// Model.
+//   - Every CPU publishes the PML4 it has loaded (tlb_switch_mm sets
+//     g_tlb_cpu[cpu].active_cr3 BEFORE the CR3 write). A shootdown for
+//     address space X only IPIs CPUs whose active_cr3 == X.
+//   - Invalidations are queued into a per-target mailbox; one IPI drains
+//     every VA queued since the target last acked. A mailbox that
+//     overflows TLB_BATCH_MAX entries (or mixes two address spaces)
+//     degrades to a full flush of the target's current context.
+//   - With PCID (CPUID.01H:ECX[17]) each CPU caches up to TLB_PCID_SLOTS
+//     address spaces. Switching back to a cached mm reloads CR3 with the
+//     no-flush bit so its translations survive the context switch. A
+//     shootdown invalidates the slot on every CPU that holds X but is not
+//     running it; that CPU then does a flushing CR3 load on next switch-in.
+//
+// Ordering contract (the Dekker pair that makes lazy slot invalidation
+// safe): tlb_switch_mm stores active_cr3 and then looks up its slot;
+// the shooter updates the PTE, then clears slots, then reads active_cr3.
+// Either the switcher sees the cleared slot (and flushes) or the shooter
+// sees the switcher active (and IPIs it).
+//
+// Locking rule: never flush an address space while holding a lock that a
+// CPU running it may spin on with IF=0. The ack-wait services only this
+// CPU's own mailbox (so two shooters cannot deadlock each other), but a
+// target spinning on our lock never takes the IPI, never acks, and
+// tlb_wait_ack panics. Flushing the caller's own address space under its
+// own locks is fine — user tasks are single-threaded, so no other CPU runs
+// it. Walks over other tasks' address spaces queue into batches under the
+// lock and flush after dropping it (see vmo.c); frames whose PTEs were
+// removed stay referenced until that flush returns.
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// VAs queued per batch / per mailbox before degrading to a full flush.
+// 32 * invlpg is still cheaper than refilling the whole TLB; past that a
+// CR3 reload wins.
+#define TLB_BATCH_MAX   32u
+
+// Address spaces cached per CPU under PCID. PCID 0 is never handed out
+// so a CR3 value with zero low bits always means "untagged".
+#define TLB_PCID_SLOTS  8u
+
+// tlb_batch_t — caller-owned accumulator for a run of PTE updates against
+// one address space. Stack-allocate, tlb_batch_init, tlb_batch_add per
+// modified VA, tlb_batch_flush once at the end. Flush is mandatory before
+// any freed page is handed back to the PMM.
+typedef struct tlb_batch {
+    uint64_t cr3;                   // PML4 phys of the address space.
+    uint32_t count;                 // Valid entries in va[].
+    bool     full;                  // Overflowed → flush everything.
+    uint64_t va[TLB_BATCH_MAX];
+} tlb_batch_t;
+
+// Counters surfaced through SYS_DEBUG DEBUG_TLB_STATS. Layout is ABI with
+// user/syscalls.h (tlb_stats_u_t).
+typedef struct tlb_stats {
+    uint64_t shootdowns;            // tlb_batch_flush / tlb_shootdown_page calls
+    uint64_t ipis_sent;             // IPIs actually delivered to peers
+    uint64_t pages_invalidated;     // invlpg executed (local + remote)
+    uint64_t full_flushes;          // CR3 reloads due to overflow / mixed mm
+    uint64_t pcid_hits;             // switch-ins that kept their PCID context
+    uint64_t pcid_misses;           // switch-ins that had to flush a slot
+    uint64_t lazy_invalidations;    // remote slots dropped without an IPI
+    uint64_t ack_timeouts;          // ack-wait windows that expired (IPI re-sent)
+} tlb_stats_t;
+
+// BSP, once, before any AP is released: probe PCID support.
+void tlb_init(void);
+
+// Every CPU, after lapic_init: enable CR4.PCIDE if supported and record
+// the currently loaded PML4 as this CPU's active address space.
+void tlb_cpu_init(uint32_t cpu_id);
+
+// Load `cr3` (a bare PML4 phys) on CPU `cpu_id`. No-op if already active.
+// Replaces the raw CR3 write in schedule().
+void tlb_switch_mm(uint32_t cpu_id, uint64_t cr3);
+
+// Invalidate one VA in `cr3` on every CPU that may cache it.
+void tlb_shootdown_page(uint64_t cr3, uint64_t va);
+
+void tlb_batch_init(tlb_batch_t *b, uint64_t cr3);
+void tlb_batch_add(tlb_batch_t *b, uint64_t va);
+void tlb_batch_flush(tlb_batch_t *b);
+
+// Drop every CPU's PCID slot for `cr3`. Must be called before a PML4 page
+// is freed — otherwise a recycled PML4 at the same phys would inherit the
+// dead address space's tagged translations.
+void tlb_mm_release(uint64_t cr3);
+
+// Vector IPI_VEC_TLB_SHOOTDOWN handler (interrupts.c).
+void tlb_shootdown_ipi_handler(void);
+
+// Drain this CPU's mailbox without an IPI. For loops that spin with
+// interrupts disabled while other CPUs may be shooting at this one (the
+// snapshot barrier owner waiting on its helpers).
+void tlb_poll_mailbox(void);
+
+// Snapshot the global counters.
+void tlb_get_stats(tlb_stats_t *out);
+
+// True once tlb_cpu_init enabled CR4.PCIDE on the BSP.
+bool tlb_pcid_enabled(void);
@@ -1,5 +1,6 @@
 #include "vmm.h"
 #include "pmm.h"
+#include "tlb.h"
 #include "../../../drivers/video/framebuffer.h"
 #include "../../../kernel/sync/spinlock.h"
 
@@ -261,6 +262,9 @@ uint64_t vmm_get_physical_address(uint64_t cr3, uint64_t virt) {
 
     uint64_t *pd = (uint64_t*)((pdpt[pdpt_index] & PAGE_MASK) + g_hhdm_offset);
     if (!(pd[pd_index] & PTE_PRESENT)) return 0;
+    if (pd[pd_index] & PTE_LARGEPAGE) {
+        return (pd[pd_index] & HUGE_PAGE_ADDR_MASK) | (virt & (HUGE_PAGE_SIZE - 1));
+    }
 
     uint64_t *pt = (uint64_t*)((pd[pd_index] & PAGE_MASK) + g_hhdm_offset);
     if (!(pt[pt_index] & PTE_PRESENT)) return 0;
@@ -269,6 +273,137 @@ uint64_t vmm_get_physical_address(uint64_t cr3, uint64_t virt) {
     return (pt[pt_index] & PAGE_MASK) | offset;
 }
 
+// ---------------------------------------------------------------------------
+// Phase 26: 2 MiB pages.
+//
+// A large PD entry maps HUGE_PAGE_PAGES consecutive PMM frames. The PMM
+// keeps per-4-KiB refcounts for them, so every owner (VMO pages[], brk,
+// snapshot tracker) keeps thinking in 4 KiB frames and a large mapping is
+// purely a TLB-reach optimisation. Any 4 KiB operation that lands inside
+// one (map, unmap, protect) splits it on demand into a page table with
+// identical translations first.
+// ---------------------------------------------------------------------------
+
+// Flags of a large PDE re-expressed as 4 KiB PTE flags: drop PS, move the
+// PAT bit from 12 down to 7.
+static uint64_t vmm_pde_to_pte_flags(uint64_t pde) {
+    uint64_t flags = pde & ~HUGE_PAGE_ADDR_MASK & ~PTE_LARGEPAGE & ~PTE_PAT_LARGE;
+    if (pde & PTE_PAT_LARGE) flags |= PTE_PAT;
+    return flags;
+}
+
+// Return a pointer to the PD entry covering `virt`, or NULL if the PML4 or
+// PDPT level is absent (or is itself a 1 GiB page). Does not allocate.
+static uint64_t *vmm_walk_pde(uint64_t cr3, uint64_t virt) {
+    uint64_t pml4_index = (virt >> 39) & 0x1FF;
+    uint64_t pdpt_index = (virt >> 30) & 0x1FF;
+    uint64_t pd_index   = (virt >> 21) & 0x1FF;
+
+    uint64_t *pml4 = (uint64_t*)(cr3 + g_hhdm_offset);
+    if (!(pml4[pml4_index] & PTE_PRESENT)) return NULL;
+    uint64_t *pdpt = (uint64_t*)((pml4[pml4_index] & PAGE_MASK) + g_hhdm_offset);
+    if (!(pdpt[pdpt_index] & PTE_PRESENT)) return NULL;
+    if (pdpt[pdpt_index] & PTE_LARGEPAGE) return NULL;
+    uint64_t *pd = (uint64_t*)((pdpt[pdpt_index] & PAGE_MASK) + g_hhdm_offset);
+    return &pd[pd_index];
+}
+
+// Replace the 2 MiB mapping at *pde with a page table of 512 PTEs over
+// the same frames and flags. No invalidation is owed here: a cached
+// large-page entry translates exactly like the new PTEs, and whichever
+// 4 KiB PTE the caller then modifies gets invlpg'd, which drops any TLB
+// entry covering that VA regardless of its page size (SDM 4.10.4.1).
+// Returns false (mapping untouched) if no page-table page is available.
+static bool vmm_split_pde(uint64_t *pde) {
+    uint64_t old = *pde;
+    void *pt_phys = pmm_alloc_page();
+    if (!pt_phys) return false;
+    uint64_t *pt = (uint64_t*)((uint64_t)pt_phys + g_hhdm_offset);
+    uint64_t base  = old & HUGE_PAGE_ADDR_MASK;
+    uint64_t flags = vmm_pde_to_pte_flags(old);
+    for (uint64_t i = 0; i < 512; i++) {
+        pt[i] = (base + i * PAGE_SIZE) | flags;
+    }
+    *pde = (uint64_t)pt_phys | PTE_PRESENT | PTE_WRITABLE | PTE_USER;
+    return true;
+}
+
+bool vmm_map_huge_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t phys,
+                              uint64_t flags) {
+    if ((virt | phys) & (HUGE_PAGE_SIZE - 1)) return false;
+
+    uint64_t pml4_index = (virt >> 39) & 0x1FF;
+    uint64_t pdpt_index = (virt >> 30) & 0x1FF;
+    uint64_t pd_index   = (virt >> 21) & 0x1FF;
+
+    uint64_t *pml4 = (uint64_t*)(cr3 + g_hhdm_offset);
+    if (!(pml4[pml4_index] & PTE_PRESENT)) {
+        void *pdpt_phys = pmm_alloc_page();
+        if (!pdpt_phys) return false;
+        vmm_memset((void *)((uint64_t)pdpt_phys + g_hhdm_offset), 0, PAGE_SIZE);
+        pml4[pml4_index] = (uint64_t)pdpt_phys | PTE_PRESENT | PTE_WRITABLE | PTE_USER;
+    }
+
+    uint64_t *pdpt = (uint64_t*)((pml4[pml4_index] & PAGE_MASK) + g_hhdm_offset);
+    if (!(pdpt[pdpt_index] & PTE_PRESENT)) {
+        void *pd_phys = pmm_alloc_page();
+        if (!pd_phys) return false;
+        vmm_memset((void *)((uint64_t)pd_phys + g_hhdm_offset), 0, PAGE_SIZE);
+        pdpt[pdpt_index] = (uint64_t)pd_phys | PTE_PRESENT | PTE_WRITABLE | PTE_USER;
+    }
+    if (pdpt[pdpt_index] & PTE_LARGEPAGE) return false;
+
+    uint64_t *pd = (uint64_t*)((pdpt[pdpt_index] & PAGE_MASK) + g_hhdm_offset);
+    uint64_t old = pd[pd_index];
+    uint64_t old_pt = 0;
+    if ((old & PTE_PRESENT) && !(old & PTE_LARGEPAGE)) {
+        // A page table is already here. Take it over only if it is empty —
+        // never silently drop 4 KiB mappings.
+        uint64_t *pt = (uint64_t*)((old & PAGE_MASK) + g_hhdm_offset);
+        for (int i = 0; i < 512; i++) {
+            if (pt[i] & PTE_PRESENT) return false;
+        }
+        old_pt = old & PAGE_MASK;
+    }
+
+    pd[pd_index] = phys | (flags & ~HUGE_PAGE_ADDR_MASK) | PTE_LARGEPAGE | PTE_PRESENT;
+    if (old & PTE_PRESENT) {
+        // Either a live 2 MiB translation or a cached pointer to the old
+        // page table — both must be flushed everywhere before old_pt can
+        // be recycled.
+        tlb_shootdown_page(cr3, virt);
+    } else {
+        asm volatile("invlpg (%0)" : : "r" (virt) : "memory");
+    }
+    if (old_pt) pmm_free_page((void *)old_pt);
+    return true;
+}
+
+uint64_t vmm_unmap_huge_page_batched(uint64_t cr3, uint64_t virt,
+                                     tlb_batch_t *batch) {
+    if (virt & (HUGE_PAGE_SIZE - 1)) return 0;
+    uint64_t *pde = vmm_walk_pde(cr3, virt);
+    if (!pde) return 0;
+    uint64_t old = *pde;
+    if (!(old & PTE_PRESENT) || !(old & PTE_LARGEPAGE)) return 0;
+    *pde = 0;
+    tlb_batch_add(batch, virt);
+    return old & HUGE_PAGE_ADDR_MASK;
+}
+
+bool vmm_protect_huge_page_batched(uint64_t cr3, uint64_t virt,
+                                   uint64_t new_flags, tlb_batch_t *batch) {
+    uint64_t *pde = vmm_walk_pde(cr3, virt);
+    if (!pde) return false;
+    uint64_t old = *pde;
+    if (!(old & PTE_PRESENT) || !(old & PTE_LARGEPAGE)) return false;
+    *pde = (old & (HUGE_PAGE_ADDR_MASK | PTE_PAT_LARGE)) |
+           (new_flags & ~HUGE_PAGE_ADDR_MASK & ~PTE_PAT) |
+           PTE_LARGEPAGE | PTE_PRESENT;
+    tlb_batch_add(batch, virt & ~(HUGE_PAGE_SIZE - 1));
+    return true;
+}
+
 bool vmm_map_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t phys, uint64_t flags) {
     // Calculate indices for each page table level
     uint64_t pml4_index = (virt >> 39) & 0x1FF;
@@ -297,6 +432,7 @@ bool vmm_map_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t phys, uint64_t fl
     }
 
     // Level 3: Page Directory (PD)
+    if (pdpt[pdpt_index] & PTE_LARGEPAGE) return false;  // 1 GiB — never created
     uint64_t *pd = (uint64_t*)((pdpt[pdpt_index] & PAGE_MASK) + g_hhdm_offset);
     if (!(pd[pd_index] & PTE_PRESENT)) {
         void *pt_phys = pmm_alloc_page();
@@ -304,16 +440,28 @@ bool vmm_map_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t phys, uint64_t fl
         uint64_t* pt_virt = (uint64_t*)((uint64_t)pt_phys + g_hhdm_offset);
         vmm_memset(pt_virt, 0, PAGE_SIZE);
         pd[pd_index] = (uint64_t)pt_phys | PTE_PRESENT | PTE_WRITABLE | PTE_USER;
+    } else if (pd[pd_index] & PTE_LARGEPAGE) {
+        // Replacing one 4 KiB page inside a 2 MiB mapping (COW resolve,
+        // snapshot restore): split it first.
+        if (!vmm_split_pde(&pd[pd_index])) return false;
     }
 
     // Level 4: Page Table (PT)
     uint64_t *pt = (uint64_t*)((pd[pd_index] & PAGE_MASK) + g_hhdm_offset);
+    uint64_t old = pt[pt_index];
     pt[pt_index] = phys | flags;
 
     // CRITICAL FIX: Invalidate TLB entry for this page
     // When mapping pages for another process, the TLB must be flushed
-    // so the CPU picks up the new mapping when the process runs
-    asm volatile("invlpg (%0)" : : "r" (virt) : "memory");
+    // so the CPU picks up the new mapping when the process runs.
+    // Replacing a present translation (COW remap) must reach every CPU
+    // running this address space; a fresh mapping was never cached, so
+    // the local invlpg is just belt-and-braces.
+    if (old & PTE_PRESENT) {
+        tlb_shootdown_page(cr3, virt);
+    } else {
+        asm volatile("invlpg (%0)" : : "r" (virt) : "memory");
+    }
 
     return true;
 }
@@ -338,7 +486,15 @@ void vmm_destroy_address_space(vmm_address_space_t *space) {
 
             for (int k = 0; k < 512; k++) {
                 if (!(pd[k] & PTE_PRESENT)) continue;
-                if (pd[k] & PTE_LARGEPAGE) continue; // 2MB huge page - skip
+                if (pd[k] & PTE_LARGEPAGE) {
+                    // 2 MiB page: one PMM reference per 4 KiB frame, the
+                    // same as 512 individual leaf PTEs would hold.
+                    uint64_t base = pd[k] & HUGE_PAGE_ADDR_MASK;
+                    for (int l = 0; l < 512; l++) {
+                        pmm_free_page((void*)(base + (uint64_t)l * PAGE_SIZE));
+                    }
+                    continue;
+                }
 
                 uint64_t *pt = (uint64_t*)((pd[k] & PAGE_MASK) + g_hhdm_offset);
 
@@ -360,8 +516,10 @@ void vmm_destroy_address_space(vmm_address_space_t *space) {
         pmm_free_page((void*)(pml4[i] & PAGE_MASK));
     }
 
-    // Free the PML4 page itself
+    // Free the PML4 page itself. Drop it from every CPU's PCID cache
+    // first so a PML4 recycled at the same phys starts with a clean TLB.
     uint64_t pml4_phys = (uint64_t)pml4 - g_hhdm_offset;
+    tlb_mm_release(pml4_phys);
     pmm_free_page((void*)pml4_phys);
 
     // Clear the pool entry so it can be reused
@@ -456,8 +614,11 @@ int vmm_clone_user_pml4(uint64_t parent_cr3, uint64_t *out_clone_cr3) {
             for (int k = 0; k < 512; k++) {
                 uint64_t pde = parent_pd[k];
                 if (!(pde & PTE_PRESENT)) continue;
-                // 2 MiB pages — skip.
-                if (pde & PTE_LARGEPAGE) continue;
+                // 2 MiB pages are leaves: copy verbatim like a leaf PTE.
+                if (pde & PTE_LARGEPAGE) {
+                    clone_pd[k] = pde;
+                    continue;
+                }
 
                 void *clone_pt_phys = pmm_alloc_page();
                 if (!clone_pt_phys) goto rollback;
@@ -532,10 +693,13 @@ void vmm_free_cloned_pml4(uint64_t clone_cr3) {
     }
 
     // Free the PML4 page itself.
+    tlb_mm_release(clone_cr3);
     pmm_free_page((void *)clone_cr3);
 }
 
-void vmm_unmap_page_by_cr3(uint64_t cr3, uint64_t virt) {
+// Clear the leaf PTE for `virt`. Returns true if a present translation
+// was removed (i.e. a TLB invalidation is owed).
+static bool vmm_clear_pte(uint64_t cr3, uint64_t virt) {
     // Calculate indices for each page table level
     uint64_t pml4_index = (virt >> 39) & 0x1FF;
     uint64_t pdpt_index = (virt >> 30) & 0x1FF;
@@ -544,19 +708,36 @@ void vmm_unmap_page_by_cr3(uint64_t cr3, uint64_t virt) {
 
     // Walk the page tables
     uint64_t *pml4 = (uint64_t*)(cr3 + g_hhdm_offset);
-    if (!(pml4[pml4_index] & PTE_PRESENT)) return;
+    if (!(pml4[pml4_index] & PTE_PRESENT)) return false;
 
     uint64_t *pdpt = (uint64_t*)((pml4[pml4_index] & PAGE_MASK) + g_hhdm_offset);
-    if (!(pdpt[pdpt_index] & PTE_PRESENT)) return;
+    if (!(pdpt[pdpt_index] & PTE_PRESENT)) return false;
 
+    if (pdpt[pdpt_index] & PTE_LARGEPAGE) return false;
     uint64_t *pd = (uint64_t*)((pdpt[pdpt_index] & PAGE_MASK) + g_hhdm_offset);
-    if (!(pd[pd_index] & PTE_PRESENT)) return;
+    if (!(pd[pd_index] & PTE_PRESENT)) return false;
+    if ((pd[pd_index] & PTE_LARGEPAGE) && !vmm_split_pde(&pd[pd_index])) {
+        return false;
+    }
 
     uint64_t *pt = (uint64_t*)((pd[pd_index] & PAGE_MASK) + g_hhdm_offset);
 
-    // Clear the page table entry and invalidate TLB
+    // Clear the page table entry
+    bool was_present = (pt[pt_index] & PTE_PRESENT) != 0;
     pt[pt_index] = 0;
-    asm volatile("invlpg (%0)" : : "r" (virt) : "memory");
+    return was_present;
+}
+
+void vmm_unmap_page_by_cr3(uint64_t cr3, uint64_t virt) {
+    if (vmm_clear_pte(cr3, virt)) {
+        tlb_shootdown_page(cr3, virt);
+    }
+}
+
+bool vmm_unmap_page_batched(uint64_t cr3, uint64_t virt, tlb_batch_t *batch) {
+    if (!vmm_clear_pte(cr3, virt)) return false;
+    tlb_batch_add(batch, virt);
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -564,21 +745,17 @@ void vmm_unmap_page_by_cr3(uint64_t cr3, uint64_t virt) {
 // ---------------------------------------------------------------------------
 
 // Return pointer to the PTE for 'virt' in the given CR3, or NULL if any of
-// the intermediate tables is absent. Does not allocate.
-static uint64_t *vmm_walk_pte(uint64_t cr3, uint64_t virt) {
-    uint64_t pml4_index = (virt >> 39) & 0x1FF;
-    uint64_t pdpt_index = (virt >> 30) & 0x1FF;
-    uint64_t pd_index   = (virt >> 21) & 0x1FF;
-    uint64_t pt_index   = (virt >> 12) & 0x1FF;
-
-    uint64_t *pml4 = (uint64_t*)(cr3 + g_hhdm_offset);
-    if (!(pml4[pml4_index] & PTE_PRESENT)) return NULL;
-    uint64_t *pdpt = (uint64_t*)((pml4[pml4_index] & PAGE_MASK) + g_hhdm_offset);
-    if (!(pdpt[pdpt_index] & PTE_PRESENT)) return NULL;
-    uint64_t *pd = (uint64_t*)((pdpt[pdpt_index] & PAGE_MASK) + g_hhdm_offset);
-    if (!(pd[pd_index] & PTE_PRESENT)) return NULL;
-    uint64_t *pt = (uint64_t*)((pd[pd_index] & PAGE_MASK) + g_hhdm_offset);
-    return &pt[pt_index];
+// the intermediate tables is absent. Does not allocate page-table levels;
+// a 2 MiB mapping in the way is split when `split` is set and otherwise
+// reported as NULL (use vmm_get_pte to read through it).
+static uint64_t *vmm_walk_pte(uint64_t cr3, uint64_t virt, bool split) {
+    uint64_t *pde = vmm_walk_pde(cr3, virt);
+    if (!pde || !(*pde & PTE_PRESENT)) return NULL;
+    if (*pde & PTE_LARGEPAGE) {
+        if (!split || !vmm_split_pde(pde)) return NULL;
+    }
+    uint64_t *pt = (uint64_t*)((*pde & PAGE_MASK) + g_hhdm_offset);
+    return &pt[(virt >> 12) & 0x1FF];
 }
 
 // Scan bottom-up from a high-enough offset to avoid the user binary's
@@ -588,8 +765,10 @@ static uint64_t *vmm_walk_pte(uint64_t cr3, uint64_t virt) {
 #define VMM_USER_SEARCH_BOTTOM  0x0000100000000000ULL  // 16 TiB
 #define VMM_USER_SEARCH_TOP     0x0000500000000000ULL  // 80 TiB
 
-uint64_t vmm_reserve_va_by_cr3(uint64_t cr3, uint64_t len) {
+uint64_t vmm_reserve_va_aligned_by_cr3(uint64_t cr3, uint64_t len,
+                                       uint64_t align) {
     if (len == 0 || (len & (PAGE_SIZE - 1)) != 0) return 0;
+    if (align < PAGE_SIZE || (align & (align - 1)) != 0) return 0;
     uint64_t npages = len / PAGE_SIZE;
 
     // Bottom-up scan. In practice user pages at this region are empty and
@@ -601,11 +780,10 @@ uint64_t vmm_reserve_va_by_cr3(uint64_t cr3, uint64_t len) {
         bool clear = true;
         for (uint64_t p = 0; p < npages; p++) {
             uint64_t va = cur + p * PAGE_SIZE;
-            uint64_t *pte = vmm_walk_pte(cr3, va);
-            if (pte && (*pte & PTE_PRESENT)) {
+            if (vmm_get_pte(cr3, va) != 0) {
                 clear = false;
                 // Jump past the occupied page so we don't rescan.
-                cur = va + PAGE_SIZE;
+                cur = (va + PAGE_SIZE + align - 1) & ~(align - 1);
                 break;
             }
         }
@@ -614,12 +792,26 @@ uint64_t vmm_reserve_va_by_cr3(uint64_t cr3, uint64_t len) {
     return 0;
 }
 
+uint64_t vmm_reserve_va_by_cr3(uint64_t cr3, uint64_t len) {
+    return vmm_reserve_va_aligned_by_cr3(cr3, len, PAGE_SIZE);
+}
+
 bool vmm_protect_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t new_flags) {
-    uint64_t *pte = vmm_walk_pte(cr3, virt);
+    uint64_t *pte = vmm_walk_pte(cr3, virt, true);
     if (!pte || !(*pte & PTE_PRESENT)) return false;
     uint64_t phys = *pte & PAGE_MASK;
     *pte = phys | (new_flags & ~PAGE_MASK) | PTE_PRESENT;
-    asm volatile("invlpg (%0)" : : "r" (virt) : "memory");
+    tlb_shootdown_page(cr3, virt);
+    return true;
+}
+
+bool vmm_protect_page_batched(uint64_t cr3, uint64_t virt, uint64_t new_flags,
+                              tlb_batch_t *batch) {
+    uint64_t *pte = vmm_walk_pte(cr3, virt, true);
+    if (!pte || !(*pte & PTE_PRESENT)) return false;
+    uint64_t phys = *pte & PAGE_MASK;
+    *pte = phys | (new_flags & ~PAGE_MASK) | PTE_PRESENT;
+    tlb_batch_add(batch, virt);
     return true;
 }
 
@@ -630,6 +822,9 @@ static vmm_pf_handler_t g_pf_handler = NULL;
 // snap_init runs cow_init(). Aligned 8-byte writes are atomic on x86_64.
 static vmm_pf_handler_t g_snap_pf_handler = NULL;
 
+// Phase 26: executable page-cache COW handler, tried between the two.
+static vmm_pf_handler_t g_image_pf_handler = NULL;
+
 void vmm_install_pf_handler(vmm_pf_handler_t fn) {
     g_pf_handler = fn;
 }
@@ -638,6 +833,10 @@ void vmm_install_snap_pf_handler(vmm_pf_handler_t fn) {
     g_snap_pf_handler = fn;
 }
 
+void vmm_install_image_pf_handler(vmm_pf_handler_t fn) {
+    g_image_pf_handler = fn;
+}
+
 int vmm_dispatch_pf(uint64_t fault_va, uint64_t error_code) {
     // Try snap COW handler first; it returns 0 only if the faulting page
     // is recorded in the cow_page_tracker hash. For everything else (no
@@ -648,15 +847,29 @@ int vmm_dispatch_pf(uint64_t fault_va, uint64_t error_code) {
         int rc = snap(fault_va, error_code);
         if (rc == 0) return 0;
     }
+    vmm_pf_handler_t image = g_image_pf_handler;
+    if (image && image(fault_va, error_code) == 0) return 0;
     vmm_pf_handler_t fn = g_pf_handler;
     if (!fn) return -1;
     return fn(fault_va, error_code);
 }
 
 uint64_t vmm_get_pte(uint64_t cr3, uint64_t virt) {
-    uint64_t *pte = vmm_walk_pte(cr3, virt);
+    uint64_t *pde = vmm_walk_pde(cr3, virt);
+    if (pde && (*pde & PTE_PRESENT) && (*pde & PTE_LARGEPAGE)) {
+        // Synthesize the 4 KiB PTE this VA would have after a split.
+        return ((*pde & HUGE_PAGE_ADDR_MASK) + (virt & (HUGE_PAGE_SIZE - PAGE_SIZE))) |
+               vmm_pde_to_pte_flags(*pde);
+    }
+    uint64_t *pte = vmm_walk_pte(cr3, virt, false);
     if (!pte) return 0;
     uint64_t v = *pte;
     if (!(v & PTE_PRESENT)) return 0;
     return v;
-}
\ No newline at end of file
+}
+
+uint64_t vmm_get_page_size(uint64_t cr3, uint64_t virt) {
+    uint64_t *pde = vmm_walk_pde(cr3, virt);
+    if (pde && (*pde & PTE_PRESENT) && (*pde & PTE_LARGEPAGE)) return HUGE_PAGE_SIZE;
+    return vmm_get_pte(cr3, virt) ? PAGE_SIZE : 0;
+}
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "../../../kernel/limine.h" // Include for struct definitions
+#include "tlb.h"                       // tlb_batch_t for the *_batched helpers
 
 // --- Global Variable Declaration ---
 // Any file that includes vmm.h can now access the HHDM offset.
@@ -18,10 +19,25 @@ extern uint64_t g_hhdm_offset;
 #define PTE_LARGEPAGE  (1ULL << 7)
 #define PTE_GLOBAL     (1ULL << 8)
 #define PTE_NX         (1ULL << 63) // No-Execute bit
+#define PTE_PAT        (1ULL << 7)  // PAT bit of a 4 KiB PTE (aliases PS)
+#define PTE_PAT_LARGE  (1ULL << 12) // PAT bit of a 2 MiB PDE
+// Phase 26: software bit (ignored by the MMU). Marks a read-only user PTE
+// that maps a shared executable page-cache frame of a writable segment;
+// the first write copies it (kernel/elf.c).
+#define PTE_IMAGE_COW  (1ULL << 9)
+// Phase 26: software bit. Set by the snapshot capture walk on every user
+// PTE it records; any path that installs or copies a PTE drops it, so a
+// present, read-only PTE that still carries it has not changed since the
+// task's last capture (kernel/snap/capture.c, incremental snapshots).
+#define PTE_SNAP_CLEAN (1ULL << 10)
 
 // --- Virtual Memory Constants ---
 #define PAGE_SIZE 4096
 #define PAGE_MASK 0xFFFFFFFFFFFFF000ULL
+// Phase 26: 2 MiB pages (PD entries with PTE_LARGEPAGE set).
+#define HUGE_PAGE_SIZE      (2ULL * 1024 * 1024)
+#define HUGE_PAGE_PAGES     512u
+#define HUGE_PAGE_ADDR_MASK 0x000FFFFFFFE00000ULL
 #define MAX_ADDRESS_SPACES 32
 // Virtual address space layout
 #define KERNEL_VIRTUAL_BASE 0xFFFFFFFF80000000ULL
@@ -131,6 +147,16 @@ bool vmm_map_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t phys, uint64_t fl
  */
 void vmm_unmap_page_by_cr3(uint64_t cr3, uint64_t virt);
 
+/**
+ * @brief Batched variant of vmm_unmap_page_by_cr3 for unmap loops.
+ * Clears the PTE and queues the VA into `batch` instead of shooting it
+ * down immediately. Caller must tlb_batch_flush(batch) before freeing the
+ * backing pages or returning to the task. Returns true if a present
+ * translation was removed (false also when a 2 MiB mapping covering
+ * `virt` could not be split for lack of memory).
+ */
+bool vmm_unmap_page_batched(uint64_t cr3, uint64_t virt, tlb_batch_t *batch);
+
 /**
  * @brief Destroys a user address space, freeing all user-half pages and page tables.
  * Only frees the lower half (entries 0-255 of PML4) which is user space.
@@ -163,9 +189,17 @@ void vmm_destroy_address_space_by_cr3(uint64_t cr3);
  */
 uint64_t vmm_reserve_va_by_cr3(uint64_t cr3, uint64_t len);
 
+/**
+ * Phase 26: as vmm_reserve_va_by_cr3, but the returned base is a multiple
+ * of `align` (a power of two >= 4 KiB). vmo_map asks for HUGE_PAGE_SIZE
+ * alignment on large mappings so they can use 2 MiB pages.
+ */
+uint64_t vmm_reserve_va_aligned_by_cr3(uint64_t cr3, uint64_t len,
+                                       uint64_t align);
+
 /**
  * Modify the flags of an already-mapped page. Used by COW to clear the
- * writable bit. Invalidates TLB for the modified page.
+ * writable bit. Shoots down the modified page on every CPU running `cr3`.
  *
  * @param cr3  Physical address of target PML4.
  * @param virt Virtual address of mapped page (must be 4-KiB aligned).
@@ -174,6 +208,55 @@ uint64_t vmm_reserve_va_by_cr3(uint64_t cr3, uint64_t len);
  */
 bool vmm_protect_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t new_flags);
 
+/**
+ * Batched variant of vmm_protect_page_by_cr3: queues the VA into `batch`
+ * rather than invalidating immediately. Used by the snapshot COW
+ * downgrade walk and VMO clone write-protect loops, which touch hundreds
+ * of PTEs of one address space in a row.
+ */
+bool vmm_protect_page_batched(uint64_t cr3, uint64_t virt, uint64_t new_flags,
+                              tlb_batch_t *batch);
+
+// ---------------------------------------------------------------------------
+// Phase 26: 2 MiB pages.
+//
+// Large mappings are leaves over HUGE_PAGE_PAGES PMM frames that keep their
+// individual 4 KiB refcounts. Every 4 KiB entry point above (map, unmap,
+// protect, get_pte) accepts a VA inside a large mapping: mutators split it
+// into a page table on demand, vmm_get_pte synthesizes the 4 KiB PTE.
+// ---------------------------------------------------------------------------
+
+/**
+ * Map [virt, virt + 2 MiB) to [phys, phys + 2 MiB) with one PD entry. Both
+ * addresses must be 2 MiB aligned. Fails (returns false) if a page table
+ * with any present 4 KiB entry already covers the range; an empty one is
+ * reclaimed. Does not touch PMM refcounts of the mapped frames.
+ */
+bool vmm_map_huge_page_by_cr3(uint64_t cr3, uint64_t virt, uint64_t phys,
+                              uint64_t flags);
+
+/**
+ * Clear the 2 MiB mapping at `virt` (2 MiB aligned) and queue its
+ * invalidation on `batch`. Returns the base physical frame, or 0 if no
+ * large page is mapped there (the caller then falls back to 4 KiB unmaps).
+ */
+uint64_t vmm_unmap_huge_page_batched(uint64_t cr3, uint64_t virt,
+                                     tlb_batch_t *batch);
+
+/**
+ * Change the flags of the 2 MiB mapping covering `virt` without splitting
+ * it. Returns false if `virt` is not inside a large mapping. Used by the
+ * snapshot COW downgrade; the first write then splits through cow_fault.
+ */
+bool vmm_protect_huge_page_batched(uint64_t cr3, uint64_t virt,
+                                   uint64_t new_flags, tlb_batch_t *batch);
+
+/**
+ * Size of the translation covering `virt`: HUGE_PAGE_SIZE, PAGE_SIZE, or 0
+ * if unmapped.
+ */
+uint64_t vmm_get_page_size(uint64_t cr3, uint64_t virt);
+
 /**
  * Page-fault hook signature. Handlers return 0 if the fault was handled
  * (caller resumes the faulting task), or a negative value to indicate
@@ -194,6 +277,13 @@ void vmm_install_pf_handler(vmm_pf_handler_t fn);
  */
 void vmm_install_snap_pf_handler(vmm_pf_handler_t fn);
 
+/**
+ * Phase 26: install the executable page-cache COW handler, tried after the
+ * snapshot handler and before the Phase 17 handler. Resolves write faults
+ * on PTE_IMAGE_COW pages.
+ */
+void vmm_install_image_pf_handler(vmm_pf_handler_t fn);
+
 /**
  * Invoke the installed page-fault handler. Called from the CPU exception
  * handler BEFORE the existing user-kill / kpanic fallback. Returns 0 if the
@@ -205,7 +295,8 @@ int vmm_dispatch_pf(uint64_t fault_va, uint64_t error_code);
  * Phase 24 W15: read the raw 64-bit PTE value for `virt` in `cr3`.
  * Returns 0 if any intermediate page table is absent or the PTE itself
  * is not present. Use PAGE_MASK to extract the physical address and the
- * remaining bits to recover flags (PTE_USER, PTE_NX, etc.).
+ * remaining bits to recover flags (PTE_USER, PTE_NX, etc.). Inside a 2 MiB
+ * mapping the 4 KiB PTE it would split into is synthesized.
  */
 uint64_t vmm_get_pte(uint64_t cr3, uint64_t virt);
 
@@ -157,8 +157,8 @@ static void audit_enqueue(const audit_entry_t *e) {
 
     // Phase 27 Stage C1: subscriber broadcast. POST-spinlock-release so a
     // slow subscriber doesn't backpressure other audit emissions (Phase 25
-    // T1/T2 regression class). Each subscriber try_locks its own ring;
-    // contention drops the entry and bumps dropped_count.
+    // T1/T2 regression class). One try_locked write into the shared
+    // subscriber ring; contention drops the entry and bumps dropped_count.
     audit_broadcast(e);
 
     // Mirror every entry to klog while the flusher is stubbed. U9 will
@@ -191,6 +191,12 @@ static void audit_enqueue(const audit_entry_t *e) {
 audit_subscriber_t g_audit_subscribers[AUDIT_SUB_MAX] = {0};
 spinlock_t          g_audit_subscribers_lock = SPINLOCK_INITIALIZER("audit_subs");
 
+// Phase 26: the one ring every subscriber reads. Lock order:
+// g_audit_subscribers_lock → g_audit_stream_lock.
+static audit_entry_t g_audit_stream_ring[AUDIT_STREAM_RING_DEPTH];
+static uint64_t      g_audit_stream_head;    // Next seq; slot = seq % depth
+static spinlock_t    g_audit_stream_lock = SPINLOCK_INITIALIZER("audit_stream");
+
 int audit_subscribe(int32_t pid, uint64_t filter_mask) {
     spinlock_acquire(&g_audit_subscribers_lock);
     int slot = -1;
@@ -207,14 +213,14 @@ int audit_subscribe(int32_t pid, uint64_t filter_mask) {
     audit_subscriber_t *s = &g_audit_subscribers[slot];
     // FU29.X.pcpu_audit: fully initialise the slot BEFORE publishing in_use,
     // so a concurrent audit_broadcast on another CPU (which reads in_use with
-    // ACQUIRE) never observes in_use==true with stale head/tail/lock.
+    // ACQUIRE) never observes in_use==true with a stale filter.
     s->pid = pid;
     s->filter_mask = filter_mask;
     s->dropped_count = 0;
-    s->head = 0;
-    s->tail = 0;
-    spinlock_init(&s->lock, "audit_sub");
+    spinlock_acquire(&g_audit_stream_lock);
+    s->cursor = g_audit_stream_head;    // Only entries from now on
     __atomic_store_n(&s->in_use, true, __ATOMIC_RELEASE);   // publish last
+    spinlock_release(&g_audit_stream_lock);
     spinlock_release(&g_audit_subscribers_lock);
     klog(KLOG_INFO, SUBSYS_AUDIT,
          "audit: subscriber %d attached (pid=%d filter=0x%lx)",
@@ -230,7 +236,6 @@ void audit_unsubscribe(int slot_idx) {
         __atomic_store_n(&s->in_use, false, __ATOMIC_RELEASE);  // FU29.X.pcpu_audit
         s->pid = -1;
         s->filter_mask = 0;
-        s->head = s->tail = 0;
     }
     spinlock_release(&g_audit_subscribers_lock);
 }
@@ -243,8 +248,7 @@ void audit_unsubscribe_all_for_pid(int32_t pid) {
             __atomic_store_n(&g_audit_subscribers[i].in_use, false,
                              __ATOMIC_RELEASE);  // FU29.X.pcpu_audit
             g_audit_subscribers[i].pid = -1;
-            g_audit_subscribers[i].head = 0;
-            g_audit_subscribers[i].tail = 0;
+            g_audit_subscribers[i].filter_mask = 0;
         }
     }
     spinlock_release(&g_audit_subscribers_lock);
@@ -255,57 +259,68 @@ int audit_stream_read(int slot_idx, int32_t caller_pid,
     if (slot_idx < 0 || (uint32_t)slot_idx >= AUDIT_SUB_MAX) return -1;
     if (!out_buf || max == 0) return -1;
     audit_subscriber_t *s = &g_audit_subscribers[slot_idx];
-    spinlock_acquire(&s->lock);
+    spinlock_acquire(&g_audit_stream_lock);
     if (!s->in_use || s->pid != caller_pid) {
-        spinlock_release(&s->lock);
+        spinlock_release(&g_audit_stream_lock);
         return -1;
     }
-    uint32_t avail = s->head - s->tail;
-    uint32_t take = (avail < max) ? avail : max;
-    for (uint32_t i = 0; i < take; i++) {
-        out_buf[i] = s->ring[(s->tail + i) % AUDIT_SUB_RING_DEPTH];
+    uint64_t head = g_audit_stream_head;
+    if (head - s->cursor > AUDIT_STREAM_RING_DEPTH) {
+        // Lapped: the entries in between have been overwritten. Their
+        // types are gone with them, so the whole gap counts, filtered
+        // or not (dropped_count is "entries skipped"; see audit.h).
+        __atomic_fetch_add(&s->dropped_count,
+                           head - AUDIT_STREAM_RING_DEPTH - s->cursor,
+                           __ATOMIC_RELAXED);
+        s->cursor = head - AUDIT_STREAM_RING_DEPTH;
+    }
+    uint32_t take = 0;
+    while (take < max && s->cursor < head) {
+        const audit_entry_t *e = &g_audit_stream_ring[s->cursor % AUDIT_STREAM_RING_DEPTH];
+        s->cursor++;
+        uint16_t ev = e->event_type;
+        uint64_t bit = (ev < 64) ? (1ull << ev) : 0ull;
+        if (bit && !(s->filter_mask & bit)) continue;
+        out_buf[take++] = *e;
     }
-    s->tail += take;
-    spinlock_release(&s->lock);
+    spinlock_release(&g_audit_stream_lock);
     return (int)take;
 }
 
 // FU29.X.pcpu_audit: producer must never block.  The critical section is a
 // single ring write (~200 ns); a multi-µs wait already means pathological
 // contention, so we surrender after this tiny budget and drop+count (exactly
-// the lossy-ring semantics the full-ring branch below already implements).
+// the lossy-ring semantics a lapped reader already gets).
 #define AUDIT_BROADCAST_TRYLOCK_NS  2000ull   // 2 µs
 
 void audit_broadcast(const audit_entry_t *entry) {
     if (!entry) return;
     uint16_t ev = entry->event_type;
     uint64_t bit = (ev < 64) ? (1ull << ev) : 0ull;
-    for (uint32_t i = 0; i < AUDIT_SUB_MAX; i++) {
+    // Lock-free hint: skip the ring write when nobody wants this entry.
+    bool wanted = false;
+    for (uint32_t i = 0; i < AUDIT_SUB_MAX && !wanted; i++) {
         audit_subscriber_t *s = &g_audit_subscribers[i];
-        // Lock-free hint: if not in_use, skip without taking the lock.
         if (!__atomic_load_n(&s->in_use, __ATOMIC_ACQUIRE)) continue;
-        if (bit && !(s->filter_mask & bit)) continue;
-        // FU29.X.pcpu_audit: audit_enqueue is MPSC (any CPU broadcasts) and is
-        // even re-entered from the spinlock-panic audit writer.  A BLOCKING
-        // acquire could spin to the 5 s budget and panic-in-panic.  Use the
-        // bounded non-panicking timeout variant; on contention drop + count.
-        if (!spinlock_acquire_with_timeout(&s->lock, AUDIT_BROADCAST_TRYLOCK_NS)) {
-            __atomic_fetch_add(&s->dropped_count, 1, __ATOMIC_RELAXED);
-            continue;
-        }
-        if (!__atomic_load_n(&s->in_use, __ATOMIC_ACQUIRE)) {
-            spinlock_release(&s->lock);
-            continue;
-        }
-        if (s->head - s->tail >= AUDIT_SUB_RING_DEPTH) {
-            // Full ring → drop oldest.
+        wanted = !bit || (s->filter_mask & bit);
+    }
+    if (!wanted) return;
+    // FU29.X.pcpu_audit: audit_enqueue is MPSC (any CPU broadcasts) and is
+    // even re-entered from the spinlock-panic audit writer.  A BLOCKING
+    // acquire could spin to the 5 s budget and panic-in-panic.  Use the
+    // bounded non-panicking timeout variant; on contention drop + count.
+    if (!spinlock_acquire_with_timeout(&g_audit_stream_lock, AUDIT_BROADCAST_TRYLOCK_NS)) {
+        for (uint32_t i = 0; i < AUDIT_SUB_MAX; i++) {
+            audit_subscriber_t *s = &g_audit_subscribers[i];
+            if (!__atomic_load_n(&s->in_use, __ATOMIC_ACQUIRE)) continue;
+            if (bit && !(s->filter_mask & bit)) continue;
             __atomic_fetch_add(&s->dropped_count, 1, __ATOMIC_RELAXED);
-            s->tail++;
         }
-        s->ring[s->head % AUDIT_SUB_RING_DEPTH] = *entry;
-        s->head++;
-        spinlock_release(&s->lock);
+        return;
     }
+    g_audit_stream_ring[g_audit_stream_head % AUDIT_STREAM_RING_DEPTH] = *entry;
+    g_audit_stream_head++;
+    spinlock_release(&g_audit_stream_lock);
 }
 
 // PLAN_* writers (Stage C1; consumed by Stage D3 grahai integration).
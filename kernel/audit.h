@@ -466,30 +466,36 @@ int audit_query(uint64_t since_ns, uint64_t until_ns, uint32_t event_mask,
 // ---------------------------------------------------------------------------
 // Phase 27 Block C (Stage C1): per-process audit subscribers.
 //
-// Each subscriber owns a 64-entry SPSC ring of audit_entry_t (16 KiB).
-// Producer side: audit_enqueue() calls audit_broadcast() POST-spinlock-release;
-// broadcast walks subscribers and try_locks each subscriber's ring lock to
-// push the entry. On contention or full ring, drop and bump dropped_count.
-// Consumer side: SYS_AUDIT_STREAM_READ copies up to N entries out of the ring
-// into a userspace buffer.
+// Phase 26: subscribers share one broadcast ring (the kernel/ipc/bcast.h
+// shape) instead of each owning a 64-entry copy. audit_enqueue() calls
+// audit_broadcast() POST-spinlock-release; broadcast try_locks the stream
+// lock once and writes the entry once, whatever the subscriber count. Each
+// subscriber is a cursor into the ring; one that falls more than
+// AUDIT_STREAM_RING_DEPTH entries behind skips to the oldest entry held,
+// and the gap is added to its dropped_count. Broadcast contention drops
+// the entry and bumps dropped_count on every subscriber that wanted it.
+// dropped_count is therefore "entries skipped", not "matches lost": a lap
+// counts every overwritten entry, including ones the filter would have
+// rejected, since they are gone before anyone can test them.
+// Consumer side: SYS_AUDIT_STREAM_READ copies up to N matching entries
+// past the cursor into a userspace buffer.
 //
 // The producer broadcast is intentionally OUTSIDE the audit_queue lock so a
 // slow subscriber doesn't backpressure other audit emissions (Phase 25 T1/T2
 // regression class). filter_mask is a bitmap of audit event_type bits
-// (1<<event_type); filter_mask=~0 receives every event.
+// (1<<event_type); filter_mask=~0 receives every event. Entries no
+// subscriber's filter wants are never written; the rest are filtered per
+// subscriber at read time.
 // ---------------------------------------------------------------------------
-#define AUDIT_SUB_RING_DEPTH       64u
+#define AUDIT_STREAM_RING_DEPTH    1024u  // Same 256 KiB as 16 x 64 private rings
 #define AUDIT_SUB_MAX              16u
 
 typedef struct {
     bool       in_use;
     int32_t    pid;
     uint64_t   filter_mask;
-    uint64_t   dropped_count;
-    spinlock_t lock;
-    uint32_t   head;
-    uint32_t   tail;
-    audit_entry_t ring[AUDIT_SUB_RING_DEPTH];
+    uint64_t   dropped_count; // Entries skipped: laps + contention (above)
+    uint64_t   cursor;        // Next stream seq to read (g_audit_stream_lock)
 } audit_subscriber_t;
 
 extern audit_subscriber_t g_audit_subscribers[AUDIT_SUB_MAX];
@@ -511,8 +517,8 @@ void audit_unsubscribe_all_for_pid(int32_t pid);
 int  audit_stream_read(int slot_idx, int32_t caller_pid,
                        audit_entry_t *out_buf, uint32_t max);
 
-// Internal: invoked from audit_enqueue post-lock-release. Walks subscribers
-// and pushes the entry into each matching ring.
+// Internal: invoked from audit_enqueue post-lock-release. Appends the entry
+// to the shared subscriber ring if any subscriber's filter wants it.
 void audit_broadcast(const audit_entry_t *entry);
 
 // Stage C1 PLAN_* writers. Driven by grahai (Stage D3) for AI agent
@@ -140,6 +140,27 @@ cap_handle_entry_t *cap_handle_lookup(cap_handle_table_t *t, uint32_t slot) {
     return e;
 }
 
+int cap_handle_remove_object(cap_handle_table_t *t, uint32_t object_idx) {
+    if (!t) return CAP_V2_EFAULT;
+    if (object_idx == CAP_OBJECT_IDX_NONE) return CAP_V2_EINVAL;
+
+    spinlock_acquire(&t->lock);
+    for (uint32_t s = 0; t->entries && s < t->capacity; s++) {
+        cap_handle_entry_t *e = &t->entries[s];
+        if (e->object_idx != object_idx) continue;
+        e->object_idx = CAP_OBJECT_IDX_NONE;
+        e->local_generation++;
+        e->token_flags = 0;
+        e->next_free   = t->next_free;
+        t->next_free   = s;
+        t->count--;
+        spinlock_release(&t->lock);
+        return CAP_V2_OK;
+    }
+    spinlock_release(&t->lock);
+    return CAP_V2_EINVAL;
+}
+
 int cap_handle_remove(cap_handle_table_t *t, uint32_t slot) {
     if (!t) return CAP_V2_EFAULT;
     if (slot >= t->capacity) return CAP_V2_EINVAL;
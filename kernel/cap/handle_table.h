@@ -73,6 +73,10 @@ cap_handle_entry_t *cap_handle_lookup(cap_handle_table_t *t, uint32_t slot);
 // Returns 0 on success, CAP_V2_EINVAL if slot is out-of-range or already free.
 int cap_handle_remove(cap_handle_table_t *t, uint32_t slot);
 
+// Phase 29: free the first slot referencing object_idx. Returns 0, or
+// CAP_V2_EINVAL if the table holds no such slot.
+int cap_handle_remove_object(cap_handle_table_t *t, uint32_t object_idx);
+
 // Grow the table by doubling capacity (up to CAP_HANDLE_MAX). Returns 0 on
 // success, CAP_V2_ENOMEM if already at max or realloc fails.
 int cap_handle_grow(cap_handle_table_t *t);
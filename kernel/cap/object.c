@@ -34,6 +34,9 @@
 #include "../panic.h"
 #include "../audit.h"
 #include "../ipc/channel.h"
+#include "../ipc/waitset.h"
+#include "../ipc/notify.h"
+#include "../ipc/bcast.h"
 #include "../mm/vmo.h"
 
 // Phase 18: stream endpoint deactivator. Forward declared here — stream.h is
@@ -408,6 +411,18 @@ void cap_object_destroy(uint32_t idx) {
         case CAP_KIND_STREAM:
             stream_endpoint_deactivate(obj);
             break;
+        case CAP_KIND_WAITSET:
+            waitset_deactivate(obj);
+            break;
+        case CAP_KIND_NOTIFY:
+            notify_deactivate(obj);
+            break;
+        case CAP_KIND_BCAST:
+            bcast_deactivate(obj);
+            break;
+        case CAP_KIND_BCAST_SUB:
+            bcast_sub_deactivate(obj);
+            break;
         default:
             break;
     }
@@ -75,6 +75,12 @@ typedef struct {
 // syscall window where it is widely-pledged (R3).
 #define PLEDGE_FLAG_NARROW_EXEC  0x80000000u
 
+// Phase 26: PLEDGE_FLAG_QUERY. SYS_PLEDGE with this bit set in RDI changes
+// nothing and returns the caller's current mask. Like narrowing it needs
+// no pledge, so a library can see what it may call before calling it
+// (libc malloc checks PLEDGE_COMPUTE before its VMO path).
+#define PLEDGE_FLAG_QUERY        0x40000000u
+
 // Phase 26 Stage D: argument struct for SYS_PLEDGE | PLEDGE_FLAG_NARROW_EXEC.
 // Mirrored verbatim in user/syscalls.h. Total size = 152 bytes.
 //
@@ -51,6 +51,10 @@ typedef struct cap_token {
 #define CAP_KIND_TRANSACTION       13   // Phase 25 — wraps a snapshot + buffered external sends
 #define CAP_KIND_SYSTEM            14   // Phase 26 FU25.F — system-privileged ops (TXN_FLAG_GLOBAL_SCOPE etc.)
 #define CAP_KIND_CONSOLE           15   // Phase 27 Block A — virtual console (cell VMO + input chan)
+#define CAP_KIND_WAITSET           16   // Phase 26 — multi-handle readiness wait (kernel/ipc/waitset.h)
+#define CAP_KIND_NOTIFY            17   // Phase 26 — doorbell word for shared-memory rings (kernel/ipc/notify.h)
+#define CAP_KIND_BCAST             18   // Phase 26 — broadcast ring, publisher or subscribe cap (kernel/ipc/bcast.h)
+#define CAP_KIND_BCAST_SUB         19   // Phase 26 — one subscriber's cursor into a broadcast ring
 
 // ------------------------------------------------------------------------
 // Rights bitmap (cap_object_t.rights_bitmap — 64 bits).
@@ -17,6 +17,7 @@
 #include "../cap/object.h"
 #include "../cap/handle_table.h"
 #include "../cap/pledge.h"
+#include "../ipc/waitset.h"
 #include "../../arch/x86_64/cpu/sched/sched.h"
 #include "../../arch/x86_64/cpu/tsc.h"
 
@@ -154,6 +155,7 @@ void drv_irq_channel_destroy(drv_irq_channel_t *c) {
     c->dead = 1;
     // Wake any blocked consumer with -ESHUTDOWN.
     sched_wake_all_on_channel(&c->base.read_waiters, -32 /* ESHUTDOWN */);
+    waitset_source_gone(&c->base.ws_watchers, &c->base.lock);
     c->base.magic = 0;
     kmem_cache_free(g_irq_chan_cache, c);
 }
@@ -192,6 +194,15 @@ bool userdrv_isr_post(drv_irq_channel_t *c, const drv_irq_msg_t *msg) {
     return true;
 }
 
+uint32_t userdrv_irq_probe(drv_irq_channel_t *c) {
+    if (!c) return 0;
+    uint32_t revents = 0;
+    if (__atomic_load_n(&c->head, __ATOMIC_ACQUIRE) !=
+        __atomic_load_n(&c->tail, __ATOMIC_RELAXED)) revents |= 0x1;
+    if (c->dead) revents |= 0x4;
+    return revents;
+}
+
 uint32_t userdrv_irq_drain(drv_irq_channel_t *c, drv_irq_msg_t *out_msgs,
                            uint32_t max) {
     if (!c || !out_msgs || max == 0) return 0;
@@ -646,6 +657,7 @@ void userdrv_isr_dispatch(uint8_t vector) {
         // Wake at most one waiter — daemon drains all available messages
         // on its next drv_irq_wait call.
         sched_wake_one_on_channel(&c->base.read_waiters, 0);
+        waitset_notify(&c->base.ws_watchers, &c->base.lock, WAITSET_EV_READABLE);
     } else {
         // Phase 21.1: throttled audit. At most 1 AUDIT_IRQ_DROPPED emit
         // per channel per wall-second. Use g_tsc_hz (calibrated at boot)
@@ -58,7 +58,9 @@ _Static_assert(sizeof(drv_irq_msg_t) == 16, "drv_irq_msg_t must be 16 bytes");
 //   Daemon consumer: ACQUIRE-load head, copy entries [tail..min(head, ...)],
 //                    RELEASE-store tail.
 // The embedded channel_t.lock is NEVER taken in either path (only by the
-// owner-death cleanup which marks the channel dead).
+// owner-death cleanup which marks the channel dead). Phase 26 exception:
+// once a wait-set watches the channel (base.ws_watchers != NULL) the ISR
+// takes it briefly to notify the watchers.
 // ===========================================================================
 typedef struct drv_irq_channel {
     channel_t      base;                          // For cap integration + wake queue.
@@ -103,6 +105,10 @@ bool userdrv_isr_post(drv_irq_channel_t *c, const drv_irq_msg_t *msg);
 uint32_t userdrv_irq_drain(drv_irq_channel_t *c, drv_irq_msg_t *out_msgs,
                            uint32_t max);
 
+// Phase 26: wait-set readiness probe, encoded like chan_poll_probe:
+// 0x1 = messages pending in the ring, 0x4 = channel dead. Lock-free.
+uint32_t userdrv_irq_probe(drv_irq_channel_t *c);
+
 // ===========================================================================
 // drv_caps_t — populated by sys_drv_register, returned via R10 user pointer.
 // Layout MUST stay in sync with user/syscalls.h::drv_caps_t.
@@ -3,9 +3,13 @@
 #include "../arch/x86_64/mm/pmm.h"
 #include "../drivers/video/framebuffer.h"
 #include "../arch/x86_64/drivers/serial/serial.h"
+#include "../arch/x86_64/cpu/sched/sched.h"
 #include <stddef.h> // For NULL
 #include <stdint.h>
+#include <string.h>
 #include "log.h"
+#include "mm/kheap.h"
+#include "sync/spinlock.h"
 
 static void *elf_memcpy(void *dest, const void *src, size_t n) {
     uint8_t *pdest = (uint8_t *)dest;
@@ -62,57 +66,313 @@ int elf_validate_header(const Elf64_Ehdr *header) {
     return 1; // Header is valid
 }
 
-bool elf_load(void *file_data, uint64_t *entry_point, uint64_t *cr3) {
-    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] elf_load called");
-
-    if (!file_data || !entry_point || !cr3) {
-        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Invalid parameters!");
-        framebuffer_draw_string("ELF: Invalid parameters", 10, 400, COLOR_RED, 0x00101828);
-        return false;
+// ---------------------------------------------------------------------------
+// Phase 26: shared executable page cache.
+//
+// Every spawn used to copy each PT_LOAD segment into fresh frames, so N
+// instances of one binary held N identical copies of its text. Images now
+// come from the initrd, which is immutable and stays mapped, so the file
+// pointer identifies the image: the first load of a binary copies its
+// segments into page-cache frames once, and every later load only maps
+// those frames.
+//
+//   - Read-only segments (text, rodata) map the cached frames read-only in
+//     every process.
+//   - Writable segments map the cached frames read-only with PTE_IMAGE_COW;
+//     the first write (user or kernel mode) copies the page privately in
+//     elf_image_pf_dispatch. Pages wholly past p_filesz (.bss) are still
+//     allocated zeroed per process.
+//
+// The PTEs are installed at load time rather than on first touch: syscalls
+// dereference user pointers directly and user_range_mapped() rejects
+// non-present pages, so lazily-mapped rodata would turn every string
+// literal passed to the kernel into -EFAULT. Load cost is now PTE writes
+// and refcount bumps, which is where the copying time went.
+//
+// The cache holds one pmm reference per frame. An image is idle when every
+// frame is back to that single reference; idle images are evicted once the
+// cache exceeds ELF_CACHE_MAX_PAGES.
+//
+// Lock order: g_elf_cache_lock → kheap / pmm_lock.
+// ---------------------------------------------------------------------------
+#define ELF_IMAGE_MAX_SEGS   8
+#define ELF_CACHE_MAX_PAGES  4096u   // 16 MiB of cached image frames
+
+typedef struct {
+    uint64_t  vbase;     // page-aligned segment start
+    uint32_t  npages;    // pages spanned in memory (p_memsz)
+    uint32_t  ncached;   // pages [0, ncached) come from frames[]
+    uint32_t  p_flags;   // PF_R | PF_W | PF_X
+    uint64_t *frames;    // ncached cache frames (kheap)
+} elf_image_seg_t;
+
+typedef struct elf_image {
+    const void       *file_data;   // initrd image; the cache key
+    uint32_t          nsegs;
+    uint32_t          npages;      // Σ segs[].ncached
+    elf_image_seg_t   segs[ELF_IMAGE_MAX_SEGS];
+    struct elf_image *next;
+} elf_image_t;
+
+static elf_image_t *g_elf_images = NULL;
+static spinlock_t g_elf_cache_lock = SPINLOCK_INITIALIZER("elf_cache");
+static elf_cache_stats_t g_elf_stats;
+
+static void elf_image_free(elf_image_t *img) {
+    for (uint32_t s = 0; s < img->nsegs; s++) {
+        elf_image_seg_t *seg = &img->segs[s];
+        if (!seg->frames) continue;
+        for (uint32_t j = 0; j < seg->ncached; j++) {
+            if (seg->frames[j]) pmm_page_unref((void *)seg->frames[j]);
+        }
+        kfree(seg->frames);
     }
+    kfree(img);
+}
 
-    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Parameters OK, validating header...");
-    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)file_data;
+// True if no address space maps any of img's frames.
+static bool elf_image_idle(const elf_image_t *img) {
+    for (uint32_t s = 0; s < img->nsegs; s++) {
+        const elf_image_seg_t *seg = &img->segs[s];
+        for (uint32_t j = 0; j < seg->ncached; j++) {
+            if (pmm_page_get_refcount((void *)seg->frames[j]) != 1) return false;
+        }
+    }
+    return true;
+}
 
-    // Validate ELF magic
-    if (ehdr->e_ident[0] != 0x7F || ehdr->e_ident[1] != 'E' ||
-        ehdr->e_ident[2] != 'L' || ehdr->e_ident[3] != 'F') {
-        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Invalid magic!");
-        framebuffer_draw_string("ELF: Invalid magic", 10, 420, COLOR_RED, 0x00101828);
-        return false;
+// Evict idle images (other than keep) until the cache fits its budget.
+// Caller holds g_elf_cache_lock; freeing only takes pmm_lock and the kheap
+// lock, which nest inside it.
+static void elf_cache_trim_locked(const elf_image_t *keep) {
+    elf_image_t **pp = &g_elf_images;
+    while (*pp && g_elf_stats.cached_pages > ELF_CACHE_MAX_PAGES) {
+        elf_image_t *img = *pp;
+        if (img == keep || !elf_image_idle(img)) {
+            pp = &img->next;
+            continue;
+        }
+        *pp = img->next;
+        g_elf_stats.images--;
+        g_elf_stats.cached_pages -= img->npages;
+        g_elf_stats.evictions++;
+        elf_image_free(img);
     }
+}
 
-    // Check if it's 64-bit
-    if (ehdr->e_ident[EI_CLASS] != ELFCLASS64) {
-        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Not 64-bit!");
-        framebuffer_draw_string("ELF: Not 64-bit", 10, 440, COLOR_RED, 0x00101828);
-        return false;
+// Copy file_data's PT_LOAD segments into a new, unpublished image.
+// Returns NULL with *declined set when the layout does not fit the cache
+// (the caller then copies privately), or NULL on allocation failure.
+static elf_image_t *elf_image_build(const void *file_data, const Elf64_Ehdr *ehdr,
+                                    bool *declined) {
+    const Elf64_Phdr *phdr =
+        (const Elf64_Phdr *)((const uint8_t *)file_data + ehdr->e_phoff);
+    *declined = true;
+
+    elf_image_t *img = (elf_image_t *)kmalloc(sizeof(*img), SUBSYS_MM);
+    if (!img) { *declined = false; return NULL; }
+    memset(img, 0, sizeof(*img));
+    img->file_data = file_data;
+
+    for (int i = 0; i < ehdr->e_phnum; i++) {
+        if (phdr[i].p_type != PT_LOAD || phdr[i].p_memsz == 0) continue;
+        if (img->nsegs == ELF_IMAGE_MAX_SEGS) { elf_image_free(img); return NULL; }
+        uint64_t vaddr = phdr[i].p_vaddr;
+        uint64_t start = vaddr & ~(uint64_t)(PAGE_SIZE - 1);
+        uint64_t end   = (vaddr + phdr[i].p_memsz + PAGE_SIZE - 1) &
+                         ~(uint64_t)(PAGE_SIZE - 1);
+        if (phdr[i].p_filesz > phdr[i].p_memsz || end <= start ||
+            end > 0x0000800000000000ULL) {
+            elf_image_free(img);
+            return NULL;
+        }
+        // A page shared by two segments would need both segments' bytes
+        // and the stricter of their protections; our linker script
+        // page-aligns every section, so just decline such images.
+        for (uint32_t s = 0; s < img->nsegs; s++) {
+            const elf_image_seg_t *o = &img->segs[s];
+            if (start < o->vbase + (uint64_t)o->npages * PAGE_SIZE && o->vbase < end) {
+                elf_image_free(img);
+                return NULL;
+            }
+        }
+
+        elf_image_seg_t *seg = &img->segs[img->nsegs++];
+        seg->vbase   = start;
+        seg->npages  = (uint32_t)((end - start) / PAGE_SIZE);
+        seg->p_flags = phdr[i].p_flags;
+        // Read-only segments cache every page; writable ones only the
+        // pages that carry file bytes (the rest is per-process .bss).
+        uint64_t file_end = (vaddr + phdr[i].p_filesz + PAGE_SIZE - 1) &
+                            ~(uint64_t)(PAGE_SIZE - 1);
+        seg->ncached = (seg->p_flags & PF_W)
+                     ? (uint32_t)((file_end - start) / PAGE_SIZE) : seg->npages;
+        if (seg->ncached == 0) continue;
+
+        seg->frames = (uint64_t *)kmalloc(sizeof(uint64_t) * seg->ncached, SUBSYS_MM);
+        if (!seg->frames) { *declined = false; elf_image_free(img); return NULL; }
+        memset(seg->frames, 0, sizeof(uint64_t) * seg->ncached);
+
+        const uint8_t *src = (const uint8_t *)file_data + phdr[i].p_offset;
+        for (uint32_t j = 0; j < seg->ncached; j++) {
+            void *pa = pmm_alloc_page();
+            if (!pa) { *declined = false; elf_image_free(img); return NULL; }
+            seg->frames[j] = (uint64_t)pa;
+            uint8_t *dst = (uint8_t *)((uint64_t)pa + g_hhdm_offset);
+            memset(dst, 0, PAGE_SIZE);
+            // Bytes of [vaddr, vaddr + filesz) that fall in this page.
+            uint64_t pva = start + (uint64_t)j * PAGE_SIZE;
+            uint64_t lo  = pva < vaddr ? vaddr : pva;
+            uint64_t hi  = pva + PAGE_SIZE;
+            if (hi > vaddr + phdr[i].p_filesz) hi = vaddr + phdr[i].p_filesz;
+            if (hi > lo) memcpy(dst + (lo - pva), src + (lo - vaddr), hi - lo);
+        }
+        img->npages += seg->ncached;
     }
+    *declined = false;
+    return img;
+}
 
-    // Check if it's executable
-    if (ehdr->e_type != ET_EXEC) {
-        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Not executable!");
-        framebuffer_draw_string("ELF: Not executable", 10, 460, COLOR_RED, 0x00101828);
-        return false;
+// Look up or build the cached image for file_data. On success the image is
+// published and g_elf_cache_lock is HELD so it cannot be evicted before the
+// caller has referenced its frames. Returns NULL (lock not held) on failure.
+static elf_image_t *elf_image_get_locked(const void *file_data,
+                                         const Elf64_Ehdr *ehdr, bool *declined) {
+    *declined = false;
+    spinlock_acquire(&g_elf_cache_lock);
+    for (elf_image_t *img = g_elf_images; img; img = img->next) {
+        if (img->file_data == file_data) {
+            g_elf_stats.hits++;
+            return img;
+        }
+    }
+    g_elf_stats.misses++;
+    spinlock_release(&g_elf_cache_lock);
+
+    // Copy outside the lock; a racing loader of the same binary may
+    // publish first, in which case ours is discarded.
+    elf_image_t *fresh = elf_image_build(file_data, ehdr, declined);
+    if (!fresh) return NULL;
+
+    spinlock_acquire(&g_elf_cache_lock);
+    for (elf_image_t *img = g_elf_images; img; img = img->next) {
+        if (img->file_data == file_data) {
+            elf_image_free(fresh);
+            return img;
+        }
     }
+    fresh->next = g_elf_images;
+    g_elf_images = fresh;
+    g_elf_stats.images++;
+    g_elf_stats.cached_pages += fresh->npages;
+    elf_cache_trim_locked(fresh);
+    return fresh;
+}
 
-    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Header validated, drawing framebuffer msg...");
-    framebuffer_draw_string("ELF: Header validated", 10, 420, COLOR_GREEN, 0x00101828);
-    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Framebuffer msg drawn");
+// Map file_data's segments into addr_space from the page cache.
+// Returns 1 on success, 0 if the cache declined the image (caller copies
+// privately), -1 on allocation failure.
+static int elf_map_cached(vmm_address_space_t *addr_space, void *file_data,
+                          const Elf64_Ehdr *ehdr) {
+    bool declined;
+    elf_image_t *img = elf_image_get_locked(file_data, ehdr, &declined);
+    if (!img) return declined ? 0 : -1;
+
+    // Pass 1, under the cache lock: map and reference the shared frames.
+    bool ok = true;
+    for (uint32_t s = 0; s < img->nsegs && ok; s++) {
+        const elf_image_seg_t *seg = &img->segs[s];
+        uint64_t flags = PTE_PRESENT | PTE_USER;
+        if (!(seg->p_flags & PF_X)) flags |= PTE_NX;
+        if (seg->p_flags & PF_W) flags |= PTE_IMAGE_COW;
+        for (uint32_t j = 0; j < seg->ncached; j++) {
+            uint64_t va = seg->vbase + (uint64_t)j * PAGE_SIZE;
+            if (!vmm_map_page(addr_space, va, seg->frames[j], flags)) { ok = false; break; }
+            pmm_page_ref((void *)seg->frames[j]);
+        }
+    }
+    // Snapshot the .bss ranges before dropping the lock.
+    uint64_t bss_va[ELF_IMAGE_MAX_SEGS];
+    uint32_t bss_n[ELF_IMAGE_MAX_SEGS];
+    uint32_t nbss = 0;
+    for (uint32_t s = 0; s < img->nsegs; s++) {
+        const elf_image_seg_t *seg = &img->segs[s];
+        if (seg->npages == seg->ncached) continue;
+        bss_va[nbss] = seg->vbase + (uint64_t)seg->ncached * PAGE_SIZE;
+        bss_n[nbss]  = seg->npages - seg->ncached;
+        nbss++;
+    }
+    spinlock_release(&g_elf_cache_lock);
+    if (!ok) return -1;
+
+    // Pass 2: private zero pages for the rest of each writable segment.
+    for (uint32_t b = 0; b < nbss; b++) {
+        for (uint32_t j = 0; j < bss_n[b]; j++) {
+            void *pa = pmm_alloc_page();
+            if (!pa) return -1;
+            memset((void *)((uint64_t)pa + g_hhdm_offset), 0, PAGE_SIZE);
+            uint64_t flags = PTE_PRESENT | PTE_USER | PTE_WRITABLE | PTE_NX;
+            if (!vmm_map_page(addr_space, bss_va[b] + (uint64_t)j * PAGE_SIZE,
+                              (uint64_t)pa, flags)) {
+                pmm_free_page(pa);
+                return -1;
+            }
+        }
+    }
+    return 1;
+}
 
-    // Create new address space
-    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Creating address space...");
-    vmm_address_space_t *addr_space = vmm_create_address_space();
-    if (!addr_space) {
-        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Failed to create address space!");
-        framebuffer_draw_string("ELF: Failed to create address space", 10, 480, COLOR_RED, 0x00101828);
-        return false;
+// Write fault on a PTE_IMAGE_COW page: give the task a private copy.
+// Kernel-mode faults count too — syscalls write results straight into user
+// .data/.bss, and CR0.WP makes those writes fault on read-only PTEs.
+static int elf_image_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
+    bool is_write   = (error_code & 0x2) != 0;
+    bool is_present = (error_code & 0x1) != 0;
+    if (!is_write || !is_present || fault_va >= 0x0000800000000000ULL) return -1;
+
+    task_t *cur = sched_get_current_task();
+    if (!cur) return -1;
+    uint64_t page_va = fault_va & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t pte = vmm_get_pte(cur->cr3, page_va);
+    if (!(pte & PTE_USER) || !(pte & PTE_IMAGE_COW) || (pte & PTE_WRITABLE)) return -1;
+
+    const uint64_t PHYS_ADDR_MASK = 0x000FFFFFFFFFF000ULL;
+    uint64_t old_phys = pte & PHYS_ADDR_MASK;
+    uint64_t flags    = (pte & ~PHYS_ADDR_MASK & ~(PTE_IMAGE_COW | PTE_SNAP_CLEAN)) |
+                        PTE_WRITABLE;
+    void *new_pa = pmm_alloc_page();
+    if (!new_pa) return -1;
+    memcpy((void *)((uint64_t)new_pa + g_hhdm_offset),
+           (void *)(old_phys + g_hhdm_offset), PAGE_SIZE);
+
+    // The cache keeps its own reference, so old_phys outlives this unref.
+    vmm_unmap_page_by_cr3(cur->cr3, page_va);
+    if (!vmm_map_page_by_cr3(cur->cr3, page_va, (uint64_t)new_pa, flags)) {
+        vmm_map_page_by_cr3(cur->cr3, page_va, old_phys, pte & ~PHYS_ADDR_MASK);
+        pmm_free_page(new_pa);
+        return -1;
     }
-    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Address space created");
+    pmm_page_unref((void *)old_phys);
+    __atomic_fetch_add(&g_elf_stats.cow_copies, 1, __ATOMIC_RELAXED);
+    return 0;
+}
 
-    // NOTE: User stack is allocated by sched_create_user_process(), not here.
-    // elf_load only loads code/data segments into the address space.
+void elf_cache_init(void) {
+    vmm_install_image_pf_handler(elf_image_pf_dispatch);
+    klog(KLOG_INFO, SUBSYS_MM, "elf_cache_init: image page cache + COW hook ready");
+}
 
+void elf_cache_get_stats(elf_cache_stats_t *out) {
+    if (!out) return;
+    spinlock_acquire(&g_elf_cache_lock);
+    *out = g_elf_stats;
+    spinlock_release(&g_elf_cache_lock);
+}
+
+// Pre-Phase-26 loader: copy every PT_LOAD segment into fresh private
+// frames. Still used for images the page cache declines.
+static bool elf_copy_segments(vmm_address_space_t *addr_space, void *file_data,
+                              const Elf64_Ehdr *ehdr) {
     // Get program headers
     klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Getting program headers...");
     Elf64_Phdr *phdr = (Elf64_Phdr *)((uint8_t *)file_data + ehdr->e_phoff);
@@ -222,6 +482,72 @@ bool elf_load(void *file_data, uint64_t *entry_point, uint64_t *cr3) {
         }
     }
 
+    return true;
+}
+
+bool elf_load(void *file_data, uint64_t *entry_point, uint64_t *cr3) {
+    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] elf_load called");
+
+    if (!file_data || !entry_point || !cr3) {
+        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Invalid parameters!");
+        framebuffer_draw_string("ELF: Invalid parameters", 10, 400, COLOR_RED, 0x00101828);
+        return false;
+    }
+
+    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Parameters OK, validating header...");
+    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)file_data;
+
+    // Validate ELF magic
+    if (ehdr->e_ident[0] != 0x7F || ehdr->e_ident[1] != 'E' ||
+        ehdr->e_ident[2] != 'L' || ehdr->e_ident[3] != 'F') {
+        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Invalid magic!");
+        framebuffer_draw_string("ELF: Invalid magic", 10, 420, COLOR_RED, 0x00101828);
+        return false;
+    }
+
+    // Check if it's 64-bit
+    if (ehdr->e_ident[EI_CLASS] != ELFCLASS64) {
+        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Not 64-bit!");
+        framebuffer_draw_string("ELF: Not 64-bit", 10, 440, COLOR_RED, 0x00101828);
+        return false;
+    }
+
+    // Check if it's executable
+    if (ehdr->e_type != ET_EXEC) {
+        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Not executable!");
+        framebuffer_draw_string("ELF: Not executable", 10, 460, COLOR_RED, 0x00101828);
+        return false;
+    }
+
+    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Header validated, drawing framebuffer msg...");
+    framebuffer_draw_string("ELF: Header validated", 10, 420, COLOR_GREEN, 0x00101828);
+    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Framebuffer msg drawn");
+
+    // Create new address space
+    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Creating address space...");
+    vmm_address_space_t *addr_space = vmm_create_address_space();
+    if (!addr_space) {
+        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Failed to create address space!");
+        framebuffer_draw_string("ELF: Failed to create address space", 10, 480, COLOR_RED, 0x00101828);
+        return false;
+    }
+    klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Address space created");
+
+    // NOTE: User stack is allocated by sched_create_user_process(), not here.
+    // elf_load only loads code/data segments into the address space.
+
+    // Phase 26: map the segments from the shared page cache; images the
+    // cache cannot describe fall back to a private copy.
+    int cached = elf_map_cached(addr_space, file_data, ehdr);
+    if (cached < 0) {
+        klog(KLOG_ERROR, SUBSYS_CORE, "[ELF] ERROR: Out of memory!");
+        framebuffer_draw_string("ELF: Out of memory", 10, 540, COLOR_RED, 0x00101828);
+        return false;
+    }
+    if (cached == 0 && !elf_copy_segments(addr_space, file_data, ehdr)) {
+        return false;
+    }
+
     klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] All pages loaded, drawing framebuffer msg...");
     framebuffer_draw_string("ELF: All segments loaded", 10, 540, COLOR_GREEN, 0x00101828);
     klog(KLOG_DEBUG, SUBSYS_CORE, "[ELF] Framebuffer msg drawn");
@@ -98,4 +98,25 @@ int elf_validate_header(const Elf64_Ehdr *header);
  * @param new_cr3 Pointer to store the physical address of the new process's PML4.
  * @return True on success, false on failure.
  */
-bool elf_load(void *elf_data, uint64_t *entry_point, uint64_t *new_cr3);
\ No newline at end of file
+bool elf_load(void *elf_data, uint64_t *entry_point, uint64_t *new_cr3);
+
+// Phase 26: shared executable page cache (see kernel/elf.c). Counters are
+// cumulative except images / cached_pages, which describe the live cache.
+typedef struct {
+    uint64_t images;        // binaries currently cached
+    uint64_t cached_pages;  // frames held by the cache
+    uint64_t hits;          // loads served from an already-cached image
+    uint64_t misses;        // loads that had to build (or decline) an image
+    uint64_t cow_copies;    // PTE_IMAGE_COW write faults resolved
+    uint64_t evictions;     // idle images dropped to fit the budget
+} elf_cache_stats_t;
+
+/**
+ * @brief Installs the page-cache COW fault handler. Call once after vmm_init.
+ */
+void elf_cache_init(void);
+
+/**
+ * @brief Copies the page-cache counters into *out.
+ */
+void elf_cache_get_stats(elf_cache_stats_t *out);
@@ -35,6 +35,7 @@
 #include "../cap/token.h"
 #include "../net/rawnet.h"
 #include "../ipc/channel.h"
+#include "../ipc/notify.h"
 #include "../../arch/x86_64/drivers/ahci/ahci.h"
 #include "../../arch/x86_64/cpu/sched/sched.h"
 #include "../../arch/x86_64/mm/vmm.h"   // g_hhdm_offset for DMA VMO kernel-virt access
@@ -93,6 +94,10 @@ static vmo_t     *g_blk_dma_vmo   = NULL;  // shared 256 KiB DMA buffer
 // back to legacy chan_send (compat with v1 ahcid builds).
 static vmo_t            *g_blk_spsc_vmo  = NULL;  // shared 4 KiB ring VMO
 static blk_spsc_slot_t  *g_blk_spsc_ring = NULL;  // HHDM kva pointer (64 slots)
+// Phase 26: request-ring doorbell. Signalled after every ready=1 store;
+// the handle itself is transferred to ahcid in the handshake and kt keeps
+// a kernel reference. NULL = fall back to chan_kick on g_blk_req_chan.
+static notify_t         *g_blk_req_notify = NULL;
 
 // --- Singleton state ----------------------------------------------------
 typedef struct {
@@ -253,6 +258,12 @@ static int blk_spsc_post_req(uint8_t op, uint8_t dev, uint64_t lba,
      * the contract source-level explicit. */
     asm volatile("mfence" ::: "memory");
     __atomic_store_n(&s->ready, 1u, __ATOMIC_RELEASE);
+    /* Phase 26: wake ahcid if it is parked in SYS_WAITSET_WAIT. The notify
+     * object coalesces: only the first post after ahcid collected the word
+     * costs a wakeup. Without one, kick the request channel instead (ahcid
+     * registers it edge-triggered). */
+    if (g_blk_req_notify) (void)notify_signal(g_blk_req_notify, 1u);
+    else                  chan_kick(g_blk_req_chan);
     return 0;
 }
 
@@ -862,17 +873,24 @@ static int kt_spawn_ahcid(task_t *self) {
 // matching the v2 schema in blk_proto.h.  Older ahcid (v1) reads only the
 // first 24 bytes and ignores the SPSC fields; newer ahcid reads 32 bytes
 // and uses spsc_vmo to map the ring.
+//
+// Phase 26: with an SPSC ring, the request-ring notify object rides along
+// as in_flight_idx[2] (notify_obj_idx == 0 → not sent).
 static int kt_send_handshake(task_t *self, channel_t *req_chan,
                              uint32_t dma_obj_idx, uint32_t dma_obj_gen,
                              uint64_t dma_size_bytes,
-                             uint32_t spsc_obj_idx, uint32_t spsc_obj_gen) {
+                             uint32_t spsc_obj_idx, uint32_t spsc_obj_gen,
+                             uint32_t notify_obj_idx) {
+    if (spsc_obj_idx == 0u) notify_obj_idx = 0u;
     channel_msg_t msg;
     memset(&msg, 0, sizeof(msg));
     msg.header.type_hash  = req_chan->type_hash;
     msg.header.inline_len = (uint16_t)sizeof(blk_connect_msg_v2_t);
-    msg.header.nhandles   = (spsc_obj_idx != 0u) ? 2u : 1u;
+    msg.header.nhandles   = (notify_obj_idx != 0u) ? 3u
+                          : (spsc_obj_idx != 0u)   ? 2u : 1u;
     msg.in_flight_idx[0]  = dma_obj_idx;
     msg.in_flight_idx[1]  = spsc_obj_idx;  /* 0 if no SPSC ring */
+    msg.in_flight_idx[2]  = notify_obj_idx;
 
     blk_connect_msg_v2_t *cm = (blk_connect_msg_v2_t *)msg.inline_payload;
     cm->magic        = BLK_PROTO_MAGIC;
@@ -887,6 +905,7 @@ static int kt_send_handshake(task_t *self, channel_t *req_chan,
                             * via its own write end (transferred at connect). */
     cm->spsc_vmo     = spsc_obj_idx;     /* 0 = legacy chan_send path */
     cm->spsc_size    = (spsc_obj_idx != 0u) ? (uint32_t)BLK_SPSC_RING_BYTES : 0u;
+    cm->req_notify   = notify_obj_idx;
     (void)dma_obj_gen;
     (void)spsc_obj_gen;
 
@@ -897,9 +916,10 @@ static int kt_send_handshake(task_t *self, channel_t *req_chan,
     for (uint32_t s = 0; s < self->cap_handles.capacity; s++) {
         cap_handle_entry_t *e = cap_handle_lookup(&self->cap_handles, s);
         if (e && (e->object_idx == dma_obj_idx ||
-                  (spsc_obj_idx != 0u && e->object_idx == spsc_obj_idx))) {
+                  (spsc_obj_idx != 0u && e->object_idx == spsc_obj_idx) ||
+                  (notify_obj_idx != 0u && e->object_idx == notify_obj_idx))) {
             cap_handle_remove(&self->cap_handles, s);
-            /* Don't break — we may have two handles to remove. */
+            /* Don't break — we may have up to three handles to remove. */
         }
     }
 
@@ -1171,6 +1191,24 @@ static void blk_client_kt_entry(void) {
              "blk_client_kt: vmo_create(SPSC 4 KiB) failed — falling back to chan_send");
     }
 
+    // Phase 26: request-ring doorbell. Only useful alongside the ring;
+    // fail-soft to chan_kick if it can't be created.
+    uint32_t notify_idx = 0;
+    if (g_blk_spsc_ring) {
+        cap_token_t ntok = {0};
+        int nrc = notify_create(self->id, aud, &ntok, &notify_idx);
+        if (nrc == 0) {
+            cap_object_t *nobj = g_cap_object_ptrs[notify_idx];
+            g_blk_req_notify = nobj ? (notify_t *)nobj->kind_data : NULL;
+            if (g_blk_req_notify) notify_ref(g_blk_req_notify);
+            else                  notify_idx = 0;
+        } else {
+            klog(KLOG_WARN, SUBSYS_CORE,
+                 "blk_client_kt: notify_create rc=%d — falling back to chan_kick",
+                 nrc);
+        }
+    }
+
     // Phase 6: resolve the request channel endpoint and ship the handshake.
     channel_t *req_chan = NULL;
     uint32_t req_chan_obj_idx = 0;
@@ -1184,7 +1222,7 @@ static void blk_client_kt_entry(void) {
 
     rc = kt_send_handshake(self, req_chan, (uint32_t)dma_idx, dma_gen,
                            256ull * 1024,
-                           (uint32_t)spsc_idx, spsc_gen);
+                           (uint32_t)spsc_idx, spsc_gen, notify_idx);
     if (rc != 0) {
         klog(KLOG_ERROR, SUBSYS_CORE,
              "blk_client_kt: chan_send(handshake) rc=%d", rc);
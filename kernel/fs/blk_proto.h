@@ -174,6 +174,12 @@ _Static_assert(sizeof(blk_batch_resp_t) <= 256,
 // existing chan_send doorbell (1 byte payload) — kt task receives, scans
 // done=1 slots, wakes their waiters via the existing F1 completion-flag
 // pattern. Net win: ~1 chan_send saved per op (the request side).
+//
+// Phase 26: the request side now has a real doorbell. The kernel signals a
+// CAP_KIND_NOTIFY object (kernel/ipc/notify.h) after every ready=1 store;
+// ahcid keeps it in its wait-set and sleeps until it fires. Signals posted
+// while ahcid has not yet collected the word are coalesced, so a burst of
+// posts costs one wakeup.
 typedef struct __attribute__((aligned(64))) blk_spsc_slot {
     /* Synchronization flags. Producer (kernel) sets ready (release) AFTER
      * writing req fields. Consumer (ahcid) reads ready (acquire) BEFORE
@@ -218,7 +224,8 @@ typedef struct __attribute__((packed)) blk_connect_msg_v2 {
     uint32_t resp_chan;    // 16..19  Response channel handle
     uint32_t spsc_vmo;     // 20..23  SPSC ring VMO handle (0 = legacy)
     uint32_t spsc_size;    // 24..27  4096 (BLK_SPSC_RING_BYTES)
-    uint32_t _pad;         // 28..31
+    uint32_t req_notify;   // 28..31  Phase 26: request-ring notify handle in
+                           //         handles[2] (0 = none; informational)
 } blk_connect_msg_v2_t;
 _Static_assert(sizeof(blk_connect_msg_v2_t) == 32,
                "blk_connect_msg_v2_t must be 32 bytes");
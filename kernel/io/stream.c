@@ -18,6 +18,7 @@
 #include "../cap/object.h"
 #include "../cap/handle_table.h"
 #include "../ipc/channel.h"
+#include "../ipc/waitset.h"
 #include "../audit.h"
 #include "../log.h"
 #include "../panic.h"
@@ -133,6 +134,7 @@ void stream_ref(stream_t *s) {
 
 static void stream_free(stream_t *s) {
     if (!s) return;
+    waitset_source_gone(&s->ws_watchers, &s->lock);
     // notify_endpoint was unref'd in stream_destroy; just make sure.
     if (s->sq_vmo) { vmo_unref(s->sq_vmo); s->sq_vmo = NULL; }
     if (s->cq_vmo) { vmo_unref(s->cq_vmo); s->cq_vmo = NULL; }
@@ -265,6 +267,7 @@ void stream_post_cqe(stream_t *s, uint64_t cookie, int64_t result,
     s->total_completed++;
 
     stream_wake_reapers(s);
+    waitset_notify(&s->ws_watchers, &s->lock, WAITSET_EV_READABLE);
     (void)stream_notify_channel(s);
 }
 
@@ -371,6 +374,7 @@ int stream_create(uint64_t type_hash, uint32_t sq_entries, uint32_t cq_entries,
     s->rejected_submissions = 0;
     s->reap_waiters = NULL;
     s->jobs_head    = NULL;
+    s->ws_watchers  = NULL;
     spinlock_init(&s->lock, "stream");
 
     if (!s->sq_meta_kva || !s->cq_meta_kva) {
@@ -553,6 +557,7 @@ void stream_destroy(stream_t *s) {
         cancelled++;
         cur = cur->job_next;
     }
+    if (s->ws_watchers) waitset_notify_locked(s->ws_watchers, WAITSET_EV_HUP);
     spinlock_release(&s->lock);
 
     if (cancelled > 0) {
@@ -561,6 +566,18 @@ void stream_destroy(stream_t *s) {
     }
 }
 
+// --- Wait-set probe -----------------------------------------------------
+uint32_t stream_poll_probe(stream_t *s) {
+    if (!s || s->magic != STREAM_MAGIC || !s->cq_meta_kva) return 0;
+    uint32_t revents = 0;
+    uint32_t tail = __atomic_load_n(ring_tail_ptr(s->cq_meta_kva), __ATOMIC_ACQUIRE);
+    spinlock_acquire(&s->lock);
+    if (s->cq_head_kernel != tail) revents |= 0x1;
+    if (s->state != STREAM_STATE_ACTIVE) revents |= 0x4;
+    spinlock_release(&s->lock);
+    return revents;
+}
+
 // --- Reap ---------------------------------------------------------------
 // Return count of CQEs currently ready. Blocks up to timeout_ns until at
 // least min_complete CQEs are available. timeout_ns == 0 probes non-blocking.
@@ -78,6 +78,7 @@ struct vmo;
 struct cap_object;
 struct task_struct;
 struct stream_job;
+struct waitset_item;
 
 // ------------------------------------------------------------------------
 // Magic canaries. Verified at every syscall entry; mismatch => kpanic.
@@ -232,6 +233,9 @@ typedef struct stream {
     // All in-flight jobs linked via stream_job_t.job_next, so stream_destroy
     // can walk them and cancel.
     struct stream_job  *jobs_head;
+    // Phase 26: wait-set items watching the CQ (kernel/ipc/waitset.h),
+    // guarded by `lock`. Detached with HUP in stream_free.
+    struct waitset_item *ws_watchers;
     spinlock_t      lock;
 } stream_t;
 
@@ -326,6 +330,10 @@ sqe_t *stream_sqe_at(stream_t *s, uint32_t idx);
 // Look up CQE slot at logical index (i % cq_entries). Same contract.
 cqe_t *stream_cqe_at(stream_t *s, uint32_t idx);
 
+// Phase 26: readiness probe for wait-sets, encoded like chan_poll_probe:
+// 0x1 = CQEs waiting to be reaped, 0x4 = stream is being destroyed.
+uint32_t stream_poll_probe(stream_t *s);
+
 // Reap helper. Returns number of CQEs ready; blocks with timeout if below
 // min_complete; returns -ETIMEDOUT if timeout expires.
 int stream_reap(stream_t *s, uint32_t min_complete, uint64_t timeout_ns);
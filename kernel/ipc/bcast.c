@@ -0,0 +1,296 @@
+// kernel/ipc/bcast.c — Phase 26.
+#include "bcast.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../mm/slab.h"
+#include "../mm/kheap.h"
+#include "../cap/token.h"
+#include "../cap/object.h"
+#include "../cap/handle_table.h"
+#include "../log.h"
+#include "../../arch/x86_64/cpu/sched/sched.h"
+
+extern volatile uint64_t g_timer_ticks;
+
+static kmem_cache_t *g_bcast_cache = NULL;
+static kmem_cache_t *g_bcast_sub_cache = NULL;
+
+void bcast_subsystem_init(void) {
+    g_bcast_cache = kmem_cache_create("bcast_t", sizeof(bcast_t),
+                                      _Alignof(bcast_t), NULL, SUBSYS_CAP);
+    g_bcast_sub_cache = kmem_cache_create("bcast_sub_t", sizeof(bcast_sub_t),
+                                          _Alignof(bcast_sub_t), NULL, SUBSYS_CAP);
+    if (!g_bcast_cache || !g_bcast_sub_cache) {
+        klog(KLOG_FATAL, SUBSYS_CAP, "bcast_subsystem_init: slab alloc failed");
+        return;
+    }
+    klog(KLOG_INFO, SUBSYS_CAP, "broadcast subsystem initialized");
+}
+
+// --- Refcount ------------------------------------------------------------
+static void bcast_put(bcast_t *b) {
+    spinlock_acquire(&b->lock);
+    bool last = (--b->refcount == 0);
+    spinlock_release(&b->lock);
+    if (last) {
+        kfree(b->ring);
+        b->magic = 0;
+        kmem_cache_free(g_bcast_cache, b);
+    }
+}
+
+// Drop one sub reference; the last one frees the cursor. Caller holds
+// s->b->lock, which this releases.
+static void bcast_sub_put_unlock(bcast_sub_t *s) {
+    bcast_t *b = s->b;
+    bool last = (--s->refs == 0);
+    if (last) b->subscribers--;
+    spinlock_release(&b->lock);
+    if (last) {
+        s->magic = 0;
+        kmem_cache_free(g_bcast_sub_cache, s);
+        bcast_put(b);
+    }
+}
+
+// Wrap kind_data in a cap_object for owner_pid and insert it into its
+// handle table. The object owns one reference on whatever kind_data is
+// only once this returns 0.
+static int bcast_cap_install(uint16_t kind, uint64_t rights,
+                             const int32_t *audience, uintptr_t kind_data,
+                             task_t *owner, cap_token_t *tok_out,
+                             uint32_t *idx_out, uint32_t *slot_out) {
+    int idx = cap_object_create(kind, rights, audience, 0, kind_data,
+                                owner->id, CAP_OBJECT_IDX_NONE);
+    if (idx < 0) return idx;
+    uint32_t slot = 0;
+    int rc = cap_handle_insert(&owner->cap_handles, (uint32_t)idx, 0, &slot);
+    if (rc < 0) {
+        // Detach first so the deactivate hook leaves kind_data alone.
+        cap_object_t *obj = g_cap_object_ptrs[idx];
+        if (obj) obj->kind_data = 0;
+        cap_object_destroy((uint32_t)idx);
+        return rc;
+    }
+    cap_object_t *obj = g_cap_object_ptrs[idx];
+    uint32_t gen = obj ? __atomic_load_n(&obj->generation, __ATOMIC_ACQUIRE) : 0;
+    *tok_out = cap_token_pack(gen, (uint32_t)idx, 0);
+    if (idx_out) *idx_out = (uint32_t)idx;
+    if (slot_out) *slot_out = slot;
+    return 0;
+}
+
+// --- Create / subscribe / destroy ------------------------------------------
+int bcast_create(int32_t owner_pid, uint32_t capacity,
+                 cap_token_t *pub_tok_out, cap_token_t *sub_tok_out) {
+    if (!pub_tok_out || !sub_tok_out || !g_bcast_cache) return CAP_V2_EINVAL;
+    if (capacity == 0 || capacity > BCAST_CAPACITY_MAX) return CAP_V2_EINVAL;
+    task_t *owner = sched_get_task(owner_pid);
+    if (!owner) return CAP_V2_EINVAL;
+
+    bcast_t *b = (bcast_t *)kmem_cache_alloc(g_bcast_cache);
+    if (!b) return CAP_V2_ENOMEM;
+    memset(b, 0, sizeof(*b));
+    b->ring = (bcast_slot_t *)kmalloc(sizeof(bcast_slot_t) * capacity, SUBSYS_CAP);
+    if (!b->ring) {
+        kmem_cache_free(g_bcast_cache, b);
+        return CAP_V2_ENOMEM;
+    }
+    b->magic     = BCAST_MAGIC;
+    b->refcount  = 1;          // The publisher cap; the subscribe cap adds one below
+    b->capacity  = capacity;
+    b->owner_pid = owner_pid;
+    spinlock_init(&b->lock, "bcast");
+
+    int32_t self_only[CAP_AUDIENCE_MAX + 1] = { owner_pid, PID_NONE };
+    uint32_t pub_idx = 0, pub_slot = 0;
+    int rc = bcast_cap_install(CAP_KIND_BCAST,
+                               RIGHT_READ | RIGHT_WRITE | RIGHT_INSPECT |
+                                   RIGHT_REVOKE,
+                               self_only, (uintptr_t)b, owner, pub_tok_out,
+                               &pub_idx, &pub_slot);
+    if (rc < 0) {
+        kfree(b->ring);
+        kmem_cache_free(g_bcast_cache, b);
+        return rc;
+    }
+
+    // The subscribe cap only lets its holder open a cursor; public so it
+    // can be handed to other processes over a channel or at spawn.
+    int32_t pub[CAP_AUDIENCE_MAX + 1] = { PID_PUBLIC, PID_NONE };
+    b->refcount++;
+    rc = bcast_cap_install(CAP_KIND_BCAST, RIGHT_READ | RIGHT_INSPECT,
+                           pub, (uintptr_t)b, owner, sub_tok_out, NULL, NULL);
+    if (rc < 0) {
+        b->refcount--;
+        cap_handle_remove(&owner->cap_handles, pub_slot);
+        cap_object_destroy(pub_idx);   // Drops the last ref and frees b
+        return rc;
+    }
+    return 0;
+}
+
+int bcast_subscribe(bcast_t *b, int32_t owner_pid, cap_token_t *tok_out) {
+    if (!b || b->magic != BCAST_MAGIC || !tok_out) return CAP_V2_EINVAL;
+    task_t *owner = sched_get_task(owner_pid);
+    if (!owner) return CAP_V2_EINVAL;
+
+    bcast_sub_t *s = (bcast_sub_t *)kmem_cache_alloc(g_bcast_sub_cache);
+    if (!s) return CAP_V2_ENOMEM;
+    memset(s, 0, sizeof(*s));
+    s->magic     = BCAST_SUB_MAGIC;
+    s->owner_pid = owner_pid;
+    s->b         = b;
+    s->refs      = 1;
+
+    spinlock_acquire(&b->lock);
+    if (b->dead) {
+        spinlock_release(&b->lock);
+        kmem_cache_free(g_bcast_sub_cache, s);
+        return CAP_V2_EPIPE;
+    }
+    b->refcount++;
+    b->subscribers++;
+    s->cursor = b->head;       // New subscribers see only what comes next
+    spinlock_release(&b->lock);
+
+    int32_t self_only[CAP_AUDIENCE_MAX + 1] = { owner_pid, PID_NONE };
+    int rc = bcast_cap_install(CAP_KIND_BCAST_SUB,
+                               RIGHT_READ | RIGHT_INSPECT | RIGHT_REVOKE,
+                               self_only, (uintptr_t)s, owner, tok_out,
+                               NULL, NULL);
+    if (rc < 0) {
+        spinlock_acquire(&b->lock);
+        bcast_sub_put_unlock(s);
+    }
+    return rc;
+}
+
+void bcast_deactivate(struct cap_object *obj) {
+    if (!obj) return;
+    bcast_t *b = (bcast_t *)obj->kind_data;
+    obj->kind_data = 0;
+    if (!b || b->magic != BCAST_MAGIC) return;
+
+    if (obj->rights_bitmap & RIGHT_WRITE) {
+        // Publisher gone: readers drain what is left, then see EPIPE.
+        spinlock_acquire(&b->lock);
+        b->dead = 1;
+        spinlock_release(&b->lock);
+        sched_wake_all_on_channel(&b->waiters, CAP_V2_EPIPE);
+    }
+    bcast_put(b);
+}
+
+void bcast_sub_deactivate(struct cap_object *obj) {
+    if (!obj) return;
+    bcast_sub_t *s = (bcast_sub_t *)obj->kind_data;
+    obj->kind_data = 0;
+    if (!s || s->magic != BCAST_SUB_MAGIC) return;
+
+    bcast_t *b = s->b;
+    spinlock_acquire(&b->lock);
+    s->closed = 1;
+    // Readers of this cursor recheck `closed`; the rest go back to sleep.
+    sched_wake_all_on_channel(&b->waiters, 0);
+    bcast_sub_put_unlock(s);
+}
+
+// --- Publish / read --------------------------------------------------------
+long bcast_publish(bcast_t *b, int32_t sender_pid, const void *payload,
+                   uint32_t len) {
+    if (!b || b->magic != BCAST_MAGIC) return CAP_V2_EINVAL;
+    if (len > BCAST_MSG_MAX || (len && !payload)) return CAP_V2_EINVAL;
+
+    spinlock_acquire(&b->lock);
+    if (b->dead) {
+        spinlock_release(&b->lock);
+        return CAP_V2_EPIPE;
+    }
+    uint64_t seq = b->head;
+    bcast_slot_t *slot = &b->ring[seq % b->capacity];
+    slot->seq        = seq;
+    slot->sender_pid = sender_pid;
+    slot->len        = (uint16_t)len;
+    if (len) memcpy(slot->payload, payload, len);
+    // Readers sleep against head (sched_block_on_channel_seq), so bumping
+    // it before the wake closes the lost-wakeup window.
+    __atomic_store_n(&b->head, seq + 1, __ATOMIC_RELEASE);
+    bool anyone = b->waiters != NULL;
+    spinlock_release(&b->lock);
+
+    if (anyone) sched_wake_all_on_channel(&b->waiters, 0);
+    return (long)seq;
+}
+
+long bcast_read(bcast_sub_t *s, bcast_msg_t *out, uint32_t max,
+                uint64_t timeout_ns) {
+    if (!s || s->magic != BCAST_SUB_MAGIC || !out) return CAP_V2_EBADF;
+    if (max == 0 || max > BCAST_READ_MAX) return CAP_V2_EINVAL;
+    bcast_t *b = s->b;
+
+    spinlock_acquire(&b->lock);
+    s->refs++;
+    spinlock_release(&b->lock);
+
+    uint64_t deadline_tick = 0;
+    if (timeout_ns != 0 && timeout_ns != (uint64_t)-1) {
+        uint64_t dt = (timeout_ns + 9999999ULL) / 10000000ULL;
+        if (dt == 0) dt = 1;
+        deadline_tick = g_timer_ticks + dt;
+    }
+
+    long result;
+    for (;;) {
+        spinlock_acquire(&b->lock);
+        if (s->closed) {
+            result = CAP_V2_EPIPE;
+            break;             // Still holding b->lock
+        }
+        uint64_t head = b->head;
+        uint64_t lost = 0;
+        if (head - s->cursor > b->capacity) {
+            // Lapped: resume at the oldest message the ring still holds.
+            lost = head - b->capacity - s->cursor;
+            s->cursor = head - b->capacity;
+            s->overruns += lost;
+        }
+        uint32_t n = 0;
+        while (n < max && s->cursor < head) {
+            const bcast_slot_t *slot = &b->ring[s->cursor % b->capacity];
+            bcast_msg_t *m = &out[n];
+            m->seq        = slot->seq;
+            m->lost       = n == 0 ? lost : 0;
+            m->sender_pid = slot->sender_pid;
+            m->len        = slot->len;
+            m->_pad       = 0;
+            memcpy(m->payload, slot->payload, slot->len);
+            s->cursor++;
+            n++;
+        }
+        bool dead = b->dead;
+        uint64_t seen = s->cursor;
+        spinlock_release(&b->lock);
+
+        if (n) { result = (long)n; goto out; }
+        if (dead) { result = CAP_V2_EPIPE; goto out; }
+        if (timeout_ns == 0) { result = 0; goto out; }
+        if (deadline_tick && g_timer_ticks >= deadline_tick) { result = 0; goto out; }
+
+        // seen == cursor == head at the check: any publish since then has
+        // moved head, and the call returns without sleeping.
+        (void)sched_block_on_channel_seq(b, WAIT_BCAST, deadline_tick,
+                                         &b->waiters, &b->head, seen);
+    }
+    bcast_sub_put_unlock(s);
+    return result;
+
+out:
+    spinlock_acquire(&b->lock);
+    bcast_sub_put_unlock(s);
+    return result;
+}
@@ -0,0 +1,114 @@
+// kernel/ipc/bcast.h — Phase 26.
+//
+// Broadcast ring: one publisher, any number of subscribers. A publish is a
+// single copy into a single ring slot under one lock, however many
+// subscribers there are; each subscriber is just a cursor into the ring.
+// This is the fan-out shape that point-to-point channels force callers to
+// build by hand (one copy and one lock per subscriber).
+//
+// The publisher never blocks. The ring keeps the last `capacity` messages;
+// a subscriber that falls further behind than that skips forward to the
+// oldest message still held, and the number skipped is added to its
+// overrun counter and reported as `lost` on the next message it reads.
+// Messages carry bytes only — no handles, since one handle can't move to N
+// receivers.
+//
+// Caps: bcast_create makes two CAP_KIND_BCAST objects over one ring. The
+// publisher cap (RIGHT_WRITE) stays with the creator. The subscribe cap
+// (RIGHT_READ, public audience) is the one to hand out: any holder passes
+// it to bcast_subscribe for a private CAP_KIND_BCAST_SUB cursor, starting
+// at the next message published. Closing the publisher cap ends the
+// stream: subscribers drain what is left, then reads return EPIPE.
+//
+// Lock order: bcast_t.lock → sched_lock.
+#pragma once
+
+#include <stdint.h>
+
+#include "../sync/spinlock.h"
+#include "../cap/token.h"       // cap_token_t
+
+struct task_struct;
+struct cap_object;
+
+#define BCAST_MAGIC         0xBCA57001u
+#define BCAST_SUB_MAGIC     0xBCA57002u
+#define BCAST_MSG_MAX       256u     // Payload bytes per message
+#define BCAST_CAPACITY_MAX  1024u
+#define BCAST_READ_MAX      16u      // Messages per bcast_read call
+
+// One ring slot.
+typedef struct bcast_slot {
+    uint64_t seq;
+    int32_t  sender_pid;
+    uint16_t len;
+    uint16_t _pad;
+    uint8_t  payload[BCAST_MSG_MAX];
+} bcast_slot_t;
+
+// One message as bcast_read returns it (user-visible layout; mirrored in
+// user/syscalls.h).
+typedef struct bcast_msg {
+    uint64_t seq;          // Publish sequence number, from 0
+    uint64_t lost;         // Messages this subscriber missed just before this one
+    int32_t  sender_pid;
+    uint16_t len;
+    uint16_t _pad;
+    uint8_t  payload[BCAST_MSG_MAX];
+} bcast_msg_t;
+
+_Static_assert(sizeof(bcast_msg_t) == 280, "bcast_msg_t must be 280 bytes");
+
+typedef struct bcast {
+    uint32_t            magic;        // BCAST_MAGIC
+    uint32_t            refcount;     // Both caps + subscribers + tasks in bcast_read
+    uint32_t            dead;         // Publisher cap closed
+    uint32_t            capacity;     // Ring slots
+    int32_t             owner_pid;
+    uint32_t            subscribers;  // Live CAP_KIND_BCAST_SUB cursors
+    uint64_t            head;         // Next seq to publish; slot = seq % capacity
+    bcast_slot_t       *ring;
+    struct task_struct *waiters;      // Subscribers blocked in bcast_read
+    spinlock_t          lock;
+} bcast_t;
+
+typedef struct bcast_sub {
+    uint32_t  magic;      // BCAST_SUB_MAGIC
+    int32_t   owner_pid;
+    bcast_t  *b;          // Holds a reference
+    uint32_t  refs;       // 1 for the cap + tasks inside bcast_read (b->lock)
+    uint32_t  closed;     // Cap destroyed (b->lock)
+    uint64_t  cursor;     // Next seq to read (b->lock)
+    uint64_t  overruns;   // Lifetime messages skipped (b->lock)
+} bcast_sub_t;
+
+// --- Lifecycle -------------------------------------------------------------
+void bcast_subsystem_init(void);
+
+// Create a ring of `capacity` slots (1..BCAST_CAPACITY_MAX) owned by
+// owner_pid. Inserts both caps into the owner's handle table and writes
+// their tokens. Returns 0 or a negative CAP_V2_* code.
+int bcast_create(int32_t owner_pid, uint32_t capacity,
+                 cap_token_t *pub_tok_out, cap_token_t *sub_tok_out);
+
+// New cursor for owner_pid, starting at the next publish. Returns 0 and the
+// CAP_KIND_BCAST_SUB token, or CAP_V2_EPIPE / ENOMEM / EINVAL.
+int bcast_subscribe(bcast_t *b, int32_t owner_pid, cap_token_t *tok_out);
+
+// cap_object_destroy hooks.
+void bcast_deactivate(struct cap_object *obj);
+void bcast_sub_deactivate(struct cap_object *obj);
+
+// --- Publish / read --------------------------------------------------------
+// Copy `len` (<= BCAST_MSG_MAX) bytes into the next slot and wake every
+// blocked subscriber. Returns the message's seq (>= 0) or CAP_V2_EINVAL /
+// EPIPE.
+long bcast_publish(bcast_t *b, int32_t sender_pid, const void *payload,
+                   uint32_t len);
+
+// Copy up to `max` (1..BCAST_READ_MAX) messages past the cursor into out[],
+// blocking up to timeout_ns (0 = poll, UINT64_MAX = forever) while there
+// are none. Returns the count (0 on timeout) or CAP_V2_EPIPE once the
+// publisher is gone and the cursor has caught up.
+long bcast_read(bcast_sub_t *s, bcast_msg_t *out, uint32_t max,
+                uint64_t timeout_ns);
@@ -1,6 +1,7 @@
 // kernel/ipc/channel.c — Phase 17.
 #include "channel.h"
 #include "manifest.h"
+#include "waitset.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -9,6 +10,7 @@
 
 #include "../mm/slab.h"
 #include "../mm/kheap.h"
+#include "../mm/vmo.h"
 #include "../cap/token.h"
 #include "../cap/object.h"
 #include "../cap/handle_table.h"
@@ -101,6 +103,9 @@ int chan_create(uint64_t type_hash, uint32_t mode, uint32_t capacity,
                 cap_token_t *rd_tok_out, cap_token_t *wr_tok_out) {
     if (!rd_tok_out || !wr_tok_out) return CAP_V2_EFAULT;
     if (capacity == 0 || capacity > CHAN_CAPACITY_MAX) return CAP_V2_EINVAL;
+    if (mode & ~(CHAN_MODE_BASE_MASK | CHAN_MODE_MPSC)) return CAP_V2_EINVAL;
+    bool mpsc = (mode & CHAN_MODE_MPSC) != 0;
+    mode &= CHAN_MODE_BASE_MASK;
     if (mode != CHAN_MODE_BLOCKING && mode != CHAN_MODE_NONBLOCKING)
         return CAP_V2_EINVAL;
     if (!manifest_type_known(type_hash)) return CAP_V2_EPROTOTYPE;
@@ -116,6 +121,8 @@ int chan_create(uint64_t type_hash, uint32_t mode, uint32_t capacity,
     c->tail        = 0;
     c->msgcount    = 0;
     c->refcount    = 2;  // two endpoint caps hold refs
+    c->writers     = 1;
+    c->flags       = mpsc ? CHAN_FLAG_MPSC : 0;
     c->seq_next    = 0;
     c->total_sends = 0;
     c->total_recvs = 0;
@@ -131,6 +138,7 @@ int chan_create(uint64_t type_hash, uint32_t mode, uint32_t capacity,
     c->saved_msgcount = 0;
     c->reg_next       = NULL;
     c->reg_prev       = NULL;
+    c->ws_watchers    = NULL;
 
     c->ring = (channel_msg_t *)kmalloc(sizeof(channel_msg_t) * capacity, SUBSYS_CAP);
     if (!c->ring) {
@@ -259,6 +267,8 @@ static void chan_free(channel_t *c) {
     // Phase 24 W18: drop from the global registry BEFORE freeing storage,
     // so chan_lookup_by_id can never observe a dangling pointer.
     chan_reg_unlink(c);
+    // Phase 26: likewise detach wait-set items before the storage goes.
+    waitset_source_gone(&c->ws_watchers, &c->lock);
     if (c->ring) {
         kfree(c->ring);
         c->ring = NULL;
@@ -284,6 +294,8 @@ channel_t *chan_create_kernel(uint64_t type_hash, uint32_t mode,
     c->tail        = 0;
     c->msgcount    = 0;
     c->refcount    = 2;  // read + write virtual endpoints
+    c->writers     = 1;
+    c->flags       = 0;
     c->seq_next    = 0;
     c->total_sends = 0;
     c->total_recvs = 0;
@@ -301,6 +313,7 @@ channel_t *chan_create_kernel(uint64_t type_hash, uint32_t mode,
     c->saved_msgcount = 0;
     c->reg_next       = NULL;
     c->reg_prev       = NULL;
+    c->ws_watchers    = NULL;
 
     c->ring = (channel_msg_t *)kmalloc(sizeof(channel_msg_t) * capacity, SUBSYS_CAP);
     if (!c->ring) {
@@ -329,11 +342,23 @@ void chan_endpoint_deactivate(cap_object_t *obj) {
     channel_t *c = ep->channel;
     if (chan_check(c)) {
         spinlock_acquire(&c->lock);
+        // Phase 26 MPSC: closing one of several write endpoints is not a
+        // hangup — the reader and the remaining writers carry on.
+        if (ep->direction == CHAN_ENDPOINT_WRITE && c->writers > 1) {
+            c->writers--;
+            c->refcount--;
+            spinlock_release(&c->lock);
+            kmem_cache_free(g_endpoint_cache, ep);
+            obj->kind_data = 0;
+            return;
+        }
+        if (ep->direction == CHAN_ENDPOINT_WRITE) c->writers = 0;
         // Wake all waiters with -EPIPE as the channel is about to die on
         // this side. This ensures no task spins forever after closure.
         sched_wake_all_on_channel(&c->read_waiters, CAP_V2_EPIPE);
         sched_wake_all_on_channel(&c->write_waiters, CAP_V2_EPIPE);
         bool last = (--c->refcount == 0);
+        if (c->ws_watchers) waitset_notify_locked(c->ws_watchers, WAITSET_EV_HUP);
         spinlock_release(&c->lock);
         if (last) chan_free(c);
     }
@@ -341,7 +366,92 @@ void chan_endpoint_deactivate(cap_object_t *obj) {
     obj->kind_data = 0;
 }
 
+int chan_add_writer(channel_t *c, int32_t caller_pid, int32_t peer_pid,
+                    cap_token_t *wr_tok_out) {
+    if (!chan_check(c) || !wr_tok_out) return CAP_V2_EINVAL;
+    if (!(c->flags & CHAN_FLAG_MPSC)) return CAP_V2_EINVAL;
+    task_t *t = sched_get_task(caller_pid);
+    if (!t) return CAP_V2_EINVAL;
+
+    chan_endpoint_t *ep = (chan_endpoint_t *)kmem_cache_alloc(g_endpoint_cache);
+    if (!ep) return CAP_V2_ENOMEM;
+    ep->channel   = c;
+    ep->direction = CHAN_ENDPOINT_WRITE;
+    ep->current_holder_pid = caller_pid;
+
+    // Take the channel ref before the cap exists so a concurrent close of
+    // the last other writer can't free the channel under us.
+    spinlock_acquire(&c->lock);
+    if (c->writers == 0 || c->writers == UINT16_MAX) {
+        spinlock_release(&c->lock);
+        kmem_cache_free(g_endpoint_cache, ep);
+        return CAP_V2_EINVAL;
+    }
+    c->writers++;
+    c->refcount++;
+    spinlock_release(&c->lock);
+
+    int32_t audience[CAP_AUDIENCE_MAX + 1];
+    audience[0] = caller_pid;
+    audience[1] = (peer_pid > 0 && peer_pid != caller_pid) ? peer_pid : PID_NONE;
+    audience[2] = PID_NONE;
+
+    int idx = cap_object_create(CAP_KIND_CHANNEL,
+                                RIGHT_WRITE | RIGHT_SEND | RIGHT_INSPECT |
+                                    RIGHT_DERIVE | RIGHT_REVOKE,
+                                audience, 0, (uintptr_t)ep, caller_pid,
+                                CAP_OBJECT_IDX_NONE);
+    if (idx < 0) {
+        spinlock_acquire(&c->lock);
+        c->writers--;
+        c->refcount--;
+        spinlock_release(&c->lock);
+        kmem_cache_free(g_endpoint_cache, ep);
+        return idx;
+    }
+    uint32_t slot = 0;
+    int rc = cap_handle_insert(&t->cap_handles, (uint32_t)idx, 0, &slot);
+    if (rc < 0) {
+        cap_object_destroy((uint32_t)idx);   // Drops the writer via deactivate
+        return rc;
+    }
+    cap_object_t *obj = g_cap_object_ptrs[idx];
+    uint32_t gen = obj ? __atomic_load_n(&obj->generation, __ATOMIC_ACQUIRE) : 0;
+    *wr_tok_out = cap_token_pack(gen, (uint32_t)idx, 0);
+    return 0;
+}
+
 // --- Core send/recv ------------------------------------------------------
+// Phase 24a W2 same-CPU fastpath shared by the send and recv paths: if the
+// task we just woke would run on this CPU, yield to it now rather than at
+// the next tick. Phase 26: the wakes go through
+// sched_wake_one_on_channel_affine, which may have just migrated it here.
+static void chan_yield_to_local(task_t *woken, task_t *self) {
+    if (!woken || woken == self) return;
+    uint32_t target_cpu = (woken->cpu_pinned >= 0 &&
+                           (uint32_t)woken->cpu_pinned < g_cpu_count)
+                            ? (uint32_t)woken->cpu_pinned
+                            : (woken->last_ran_cpu < g_cpu_count
+                                ? woken->last_ran_cpu : 0);
+    if (target_cpu == smp_get_current_cpu()) {
+        sched_yield_now();
+    }
+}
+
+// Wake up to `n` tasks on a waiter list; returns the first one woken.
+// Only the first gets the affine handoff — pulling several onto this CPU
+// would serialise them. Caller holds c->lock.
+static task_t *chan_wake_n(struct task_struct **list, uint32_t n) {
+    task_t *first = NULL;
+    for (uint32_t i = 0; i < n; i++) {
+        task_t *t = first ? sched_wake_one_on_channel(list, 0)
+                          : sched_wake_one_on_channel_affine(list, 0);
+        if (!t) break;
+        if (!first) first = t;
+    }
+    return first;
+}
+
 int chan_send(channel_t *c, task_t *sender, channel_msg_t *msg_kern,
               uint64_t timeout_ns) {
     if (!chan_check(c) || !sender || !msg_kern) return CAP_V2_EINVAL;
@@ -420,7 +530,8 @@ int chan_send(channel_t *c, task_t *sender, channel_msg_t *msg_kern,
             c->tail = (c->tail + 1) % c->capacity;
             c->msgcount++;
             c->total_sends++;
-            task_t *woken = sched_wake_one_on_channel(&c->read_waiters, 0);
+            task_t *woken = sched_wake_one_on_channel_affine(&c->read_waiters, 0);
+            if (c->ws_watchers) waitset_notify_locked(c->ws_watchers, WAITSET_EV_READABLE);
             spinlock_release(&c->lock);
             // Phase 24a W2: same-CPU IPC fastpath. If the woken receiver
             // would land on this CPU, voluntarily yield via INT 49 so the
@@ -431,16 +542,7 @@ int chan_send(channel_t *c, task_t *sender, channel_msg_t *msg_kern,
             // `chan_recv` roundtrip from ~10 ms (tick limited) to <5 µs
             // in TCG. L4 direct process switch on the wake side
             // (Liedtke 1993 / SkyBridge ATC 2020).
-            if (woken && woken != sender) {
-                uint32_t target_cpu = (woken->cpu_pinned >= 0 &&
-                                       (uint32_t)woken->cpu_pinned < g_cpu_count)
-                                        ? (uint32_t)woken->cpu_pinned
-                                        : (woken->last_ran_cpu < g_cpu_count
-                                            ? woken->last_ran_cpu : 0);
-                if (target_cpu == smp_get_current_cpu()) {
-                    sched_yield_now();
-                }
-            }
+            chan_yield_to_local(woken, sender);
             return 0;
         }
         // Full.
@@ -475,23 +577,15 @@ int chan_recv(channel_t *c, task_t *receiver, channel_msg_t *msg_kern,
             c->head = (c->head + 1) % c->capacity;
             c->msgcount--;
             c->total_recvs++;
-            task_t *woken = sched_wake_one_on_channel(&c->write_waiters, 0);
+            task_t *woken = sched_wake_one_on_channel_affine(&c->write_waiters, 0);
+            if (c->ws_watchers) waitset_notify_locked(c->ws_watchers, WAITSET_EV_WRITABLE);
             spinlock_release(&c->lock);
             // Phase 24a W2: same-CPU IPC fastpath — see chan_send for
             // full rationale. The mirror case here is: a writer was
             // blocked because the channel was full; we drained one slot
             // and woke them so they can retry the insert. Yield to them
             // if same-CPU.
-            if (woken && woken != receiver) {
-                uint32_t target_cpu = (woken->cpu_pinned >= 0 &&
-                                       (uint32_t)woken->cpu_pinned < g_cpu_count)
-                                        ? (uint32_t)woken->cpu_pinned
-                                        : (woken->last_ran_cpu < g_cpu_count
-                                            ? woken->last_ran_cpu : 0);
-                if (target_cpu == smp_get_current_cpu()) {
-                    sched_yield_now();
-                }
-            }
+            chan_yield_to_local(woken, receiver);
             return (int)msg_kern->header.inline_len;
         }
         // Empty.
@@ -510,6 +604,143 @@ int chan_recv(channel_t *c, task_t *receiver, channel_msg_t *msg_kern,
     }
 }
 
+int chan_send_batch(channel_t *c, task_t *sender, channel_msg_t *msgs,
+                    uint32_t count, uint64_t timeout_ns) {
+    if (!chan_check(c) || !sender || !msgs || count == 0) return CAP_V2_EINVAL;
+
+    // Txn routing decides per message whether to buffer or deliver; keep
+    // that exact by going through chan_send one message at a time.
+    if (sender->active_txn.current && !sender->replay_in_progress) {
+        for (uint32_t i = 0; i < count; i++) {
+            int rc = chan_send(c, sender, &msgs[i], i == 0 ? timeout_ns : 0);
+            if (rc < 0) return i ? (int)i : rc;
+        }
+        return (int)count;
+    }
+
+    // Phase 28 G.1 fault injection, sampled once per batch.
+    extern uint32_t g_debug_chan_send_fail_rate;
+    if (g_debug_chan_send_fail_rate > 0) {
+        uint64_t tsc;
+        asm volatile("rdtsc" : "=A"(tsc));
+        if ((tsc & 0xFFu) == 0) return CAP_V2_EAGAIN;
+    }
+
+    if (msgs[0].header.type_hash != c->type_hash) {
+        c->rejected_messages++;
+        audit_write_chan_type_mismatch(sender->id, c->write_cap_idx,
+                                       c->type_hash, msgs[0].header.type_hash);
+        return CAP_V2_EPROTOTYPE;
+    }
+
+    while (1) {
+        spinlock_acquire(&c->lock);
+        if (c->frozen_at_snap != 0) {
+            spinlock_release(&c->lock);
+            return CAP_V2_EFROZEN;
+        }
+        uint32_t sent = 0;
+        while (sent < count && c->msgcount < c->capacity) {
+            channel_msg_t *m = &msgs[sent];
+            // A later mismatch ends the batch; the caller's retry from
+            // msgs[sent] reports EPROTOTYPE.
+            if (m->header.type_hash != c->type_hash) break;
+            m->header.sender_pid = (uint32_t)sender->id;
+            m->header.seq        = c->seq_next++;
+            c->ring[c->tail] = *m;
+            c->tail = (c->tail + 1) % c->capacity;
+            c->msgcount++;
+            sent++;
+        }
+        if (sent > 0) {
+            c->total_sends += sent;
+            task_t *woken = chan_wake_n(&c->read_waiters, sent);
+            if (c->ws_watchers) waitset_notify_locked(c->ws_watchers, WAITSET_EV_READABLE);
+            spinlock_release(&c->lock);
+            chan_yield_to_local(woken, sender);
+            return (int)sent;
+        }
+        // Full.
+        spinlock_release(&c->lock);
+        if (c->mode == CHAN_MODE_NONBLOCKING || timeout_ns == 0) {
+            return CAP_V2_EAGAIN;
+        }
+        int rc = sched_block_on_channel(c, CHAN_WAIT_WRITE, timeout_ns,
+                                        (struct task_struct **)&c->write_waiters);
+        if (rc != 0) return rc;
+    }
+}
+
+int chan_recv_batch(channel_t *c, task_t *receiver, channel_msg_t *out,
+                    uint32_t max, uint64_t timeout_ns) {
+    if (!chan_check(c) || !receiver || !out || max == 0) return CAP_V2_EINVAL;
+
+    while (1) {
+        spinlock_acquire(&c->lock);
+        if (c->frozen_at_snap != 0) {
+            spinlock_release(&c->lock);
+            return CAP_V2_EFROZEN;
+        }
+        if (c->msgcount > 0) {
+            uint32_t n = c->msgcount < max ? c->msgcount : max;
+            for (uint32_t i = 0; i < n; i++) {
+                channel_msg_t *slot = &c->ring[c->head];
+                out[i] = *slot;
+                memset(slot->in_flight_idx, 0, sizeof(slot->in_flight_idx));
+                c->head = (c->head + 1) % c->capacity;
+            }
+            c->msgcount    -= n;
+            c->total_recvs += n;
+            task_t *woken = chan_wake_n(&c->write_waiters, n);
+            if (c->ws_watchers) waitset_notify_locked(c->ws_watchers, WAITSET_EV_WRITABLE);
+            spinlock_release(&c->lock);
+            chan_yield_to_local(woken, receiver);
+            return (int)n;
+        }
+        if (c->refcount < 2) {
+            spinlock_release(&c->lock);
+            return CAP_V2_EPIPE;
+        }
+        spinlock_release(&c->lock);
+        if (c->mode == CHAN_MODE_NONBLOCKING || timeout_ns == 0) {
+            return CAP_V2_EAGAIN;
+        }
+        int rc = sched_block_on_channel(c, CHAN_WAIT_READ, timeout_ns,
+                                        (struct task_struct **)&c->read_waiters);
+        if (rc != 0) return rc;
+    }
+}
+
+int chan_unrecv_batch(channel_t *c, const channel_msg_t *msgs, uint32_t count) {
+    if (!chan_check(c) || !msgs || count == 0) return 0;
+
+    spinlock_acquire(&c->lock);
+    // Senders may have refilled the slots the batch freed; keep the
+    // oldest messages that still fit so the queue order is preserved.
+    uint32_t room = c->capacity - c->msgcount;
+    uint32_t n = count < room ? count : room;
+    for (uint32_t i = n; i > 0; i--) {
+        c->head = (c->head + c->capacity - 1) % c->capacity;
+        c->ring[c->head] = msgs[i - 1];
+    }
+    c->msgcount    += n;
+    c->total_recvs -= n;
+    // A reader that blocked after the batch emptied the ring must see the
+    // messages again, exactly as if they had just been sent.
+    if (n > 0) (void)chan_wake_n(&c->read_waiters, n);
+    if (n > 0 && c->ws_watchers) waitset_notify_locked(c->ws_watchers, WAITSET_EV_READABLE);
+    spinlock_release(&c->lock);
+
+    // Whatever could not go back is lost; destroy the caps it carried
+    // rather than leaving them referenced by nothing.
+    for (uint32_t i = n; i < count; i++) {
+        for (uint8_t h = 0; h < msgs[i].header.nhandles && h < CHAN_MSG_HANDLES_MAX; h++) {
+            if (msgs[i].in_flight_idx[h]) cap_object_destroy(msgs[i].in_flight_idx[h]);
+        }
+    }
+    return (int)n;
+}
+
 uint32_t chan_poll_probe(channel_t *c) {
     if (!chan_check(c)) return 0;
     uint32_t revents = 0;
@@ -521,6 +752,11 @@ uint32_t chan_poll_probe(channel_t *c) {
     return revents;
 }
 
+void chan_kick(channel_t *c) {
+    if (!chan_check(c)) return;
+    waitset_notify(&c->ws_watchers, &c->lock, WAITSET_EV_READABLE);
+}
+
 // --- Phase 24 W18: snapshot freeze/thaw helpers --------------------------
 //
 // chan_freeze_locked: stamp the channel as held by a snapshot, save the
@@ -570,6 +806,11 @@ int chan_thaw_locked(channel_t *c, uint32_t restore_head, uint32_t restore_tail)
     }
     sched_wake_all_on_channel(&c->read_waiters,  0);
     sched_wake_all_on_channel(&c->write_waiters, 0);
+    if (c->ws_watchers) {
+        waitset_notify_locked(c->ws_watchers,
+                              (c->msgcount > 0 ? WAITSET_EV_READABLE : 0) |
+                              (c->msgcount < c->capacity ? WAITSET_EV_WRITABLE : 0));
+    }
     spinlock_release(&c->lock);
     return CAP_V2_OK;
 }
@@ -631,8 +872,9 @@ int chan_marshal_send(task_t *sender,
     if (user_msg->header.inline_len > CHAN_MSG_INLINE_MAX) return CAP_V2_EINVAL;
     if (user_msg->header.nhandles > CHAN_MSG_HANDLES_MAX) return CAP_V2_EINVAL;
 
-    // Copy header + inline payload.
+    // Copy header + inline payload. Only chan_loan_attach may mark a loan.
     staged->header = user_msg->header;
+    staged->header.flags &= (uint8_t)~CHAN_MSG_FLAG_LOAN;
     memset(staged->in_flight_idx, 0, sizeof(staged->in_flight_idx));
     if (user_msg->header.inline_len > 0) {
         memcpy(staged->inline_payload, user_msg->inline_payload,
@@ -667,6 +909,16 @@ int chan_marshal_send(task_t *sender,
     return 0;
 }
 
+void chan_marshal_unsend(task_t *sender, const channel_msg_t *staged) {
+    if (!sender || !staged) return;
+    for (uint8_t i = 0; i < staged->header.nhandles && i < CHAN_MSG_HANDLES_MAX; i++) {
+        uint32_t obj_idx = staged->in_flight_idx[i];
+        if (obj_idx == 0) continue;
+        uint32_t slot = 0;
+        (void)cap_handle_insert(&sender->cap_handles, obj_idx, 0, &slot);
+    }
+}
+
 // RECV (msg_copyout): copy ring slot → user-shaped message, inserting each
 // in-flight object_idx into the receiver's handle table to produce fresh
 // tokens.
@@ -721,6 +973,89 @@ int chan_marshal_recv(task_t *receiver,
     return 0;
 }
 
+// --- Page loans ----------------------------------------------------------
+_Static_assert(CHAN_LOAN_MOVE == VMO_LOAN_MOVE, "loan flags must match vmo.h");
+
+int chan_loan_attach(task_t *sender, chan_loan_t *loan, channel_msg_t *staged) {
+    if (!sender || !loan || !staged) return CAP_V2_EFAULT;
+    if (loan->flags & ~CHAN_LOAN_MOVE) return CAP_V2_EINVAL;
+    if (staged->header.nhandles >= CHAN_MSG_HANDLES_MAX) return CAP_V2_EINVAL;
+
+    vmo_t *v = NULL;
+    uint32_t prot = 0;
+    int rc = vmo_loan_create(sender, loan->vaddr, loan->len, loan->flags, &v, &prot);
+    if (rc < 0) return rc;
+    loan->prot = prot;
+
+    // The receiver isn't known until recv, so the loan is public; it is
+    // reachable only through this slot until then.
+    int32_t aud[CAP_AUDIENCE_MAX + 1] = { PID_PUBLIC, PID_NONE };
+    int idx = cap_object_create(CAP_KIND_VMO,
+                                RIGHT_READ | RIGHT_WRITE | RIGHT_INSPECT |
+                                    RIGHT_DERIVE | RIGHT_REVOKE,
+                                aud, 0, (uintptr_t)v, sender->id,
+                                CAP_OBJECT_IDX_NONE);
+    if (idx < 0) {
+        vmo_loan_cancel(sender, v, loan->vaddr, loan->flags, prot);
+        return idx;
+    }
+    v->cap_object_idx = (uint32_t)idx;
+    staged->in_flight_idx[staged->header.nhandles++] = (uint32_t)idx;
+    staged->header.flags |= CHAN_MSG_FLAG_LOAN;
+    return 0;
+}
+
+void chan_loan_cancel(task_t *sender, const chan_loan_t *loan,
+                      channel_msg_t *staged) {
+    if (!staged || !(staged->header.flags & CHAN_MSG_FLAG_LOAN)) return;
+    uint8_t last = (uint8_t)(staged->header.nhandles - 1);
+    uint32_t idx = staged->in_flight_idx[last];
+    cap_object_t *obj = g_cap_object_ptrs[idx];
+    vmo_t *v = obj ? (vmo_t *)obj->kind_data : NULL;
+    staged->in_flight_idx[last] = 0;
+    staged->header.nhandles = last;
+    staged->header.flags &= (uint8_t)~CHAN_MSG_FLAG_LOAN;
+    if (!v) return;
+    // Keep the VMO past the cap's own reference so a MOVE can be remapped.
+    vmo_ref(v);
+    v->cap_object_idx = 0;
+    cap_object_destroy(idx);
+    vmo_loan_cancel(sender, v, loan->vaddr, loan->flags, loan->prot);
+}
+
+int chan_loan_map(task_t *receiver, channel_msg_t *slot, chan_loan_t *loan) {
+    if (!receiver || !slot || !loan) return CAP_V2_EFAULT;
+    uint64_t hint = loan->vaddr;
+    loan->vaddr = 0;
+    loan->len   = 0;
+    loan->prot  = 0;
+    if (!(slot->header.flags & CHAN_MSG_FLAG_LOAN) || slot->header.nhandles == 0) {
+        return 0;
+    }
+    uint8_t last = (uint8_t)(slot->header.nhandles - 1);
+    uint32_t idx = slot->in_flight_idx[last];
+    cap_object_t *obj = g_cap_object_ptrs[idx];
+    if (!obj || obj->kind != CAP_KIND_VMO) return CAP_V2_EINVAL;
+    vmo_t *v = (vmo_t *)obj->kind_data;
+
+    // COW loans take private copies on write and MOVE loans belong to the
+    // receiver outright, so the mapping is always read-write.
+    uint32_t prot = PROT_READ | PROT_WRITE;
+    uint64_t va = vmo_map(v, receiver, hint, 0, v->size_bytes, prot);
+    if (va == 0) return CAP_V2_ENOMEM;
+
+    // The mapping now holds the only reference it needs; retire the cap
+    // the way SYS_VMO_MAP retires an anonymous VMO's.
+    v->cap_object_idx = 0;
+    cap_object_destroy(idx);
+    slot->in_flight_idx[last] = 0;
+    slot->header.nhandles = last;
+    loan->vaddr = va;
+    loan->len   = v->size_bytes;
+    loan->prot  = prot;
+    return 0;
+}
+
 // --- Endpoint resolve ----------------------------------------------------
 int chan_resolve_endpoint(int32_t caller_pid, cap_token_t tok, uint8_t dir,
                           uint64_t required_rights,
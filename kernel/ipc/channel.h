@@ -21,10 +21,19 @@
 
 struct task_struct;
 struct cap_object;
+struct waitset_item;
 
 // --- Mode + direction ----------------------------------------------------
 #define CHAN_MODE_BLOCKING     1u
 #define CHAN_MODE_NONBLOCKING  2u
+// Phase 26: OR into the mode to allow more than one write endpoint
+// (chan_add_writer). Messages from different writers interleave in ring
+// order; the read side is unchanged.
+#define CHAN_MODE_MPSC         0x100u
+#define CHAN_MODE_BASE_MASK    0xFFu
+
+// channel_t.flags bits.
+#define CHAN_FLAG_MPSC         0x01u  // Created with CHAN_MODE_MPSC
 
 #define CHAN_ENDPOINT_READ     1u
 #define CHAN_ENDPOINT_WRITE    2u
@@ -32,8 +41,12 @@ struct cap_object;
 #define CHAN_MSG_INLINE_MAX    256u
 #define CHAN_MSG_HANDLES_MAX   8u
 #define CHAN_CAPACITY_MAX      4096u
+#define CHAN_VEC_MAX           16u    // Phase 26: messages per SENDV / RECVV
 #define CHANNEL_MAGIC          0xCAFEC4A1u
 
+// chan_msg_header.flags bits.
+#define CHAN_MSG_FLAG_LOAN     0x01u  // Phase 26: last handle is a page loan
+
 // --- Message header ------------------------------------------------------
 // 32 bytes. Emitted by sender, validated by kernel, echoed to receiver.
 typedef struct chan_msg_header {
@@ -75,7 +88,7 @@ _Static_assert(sizeof(chan_msg_user_t) == 352, "chan_msg_user_t must be 352 byte
 // --- Channel struct ------------------------------------------------------
 typedef struct channel {
     uint32_t magic;                  //  0..3    CHANNEL_MAGIC
-    uint32_t mode;                   //  4..7    CHAN_MODE_*
+    uint32_t mode;                   //  4..7    CHAN_MODE_BLOCKING / _NONBLOCKING
     uint64_t id;                     //  8..15   Monotonic global id
     uint64_t type_hash;              // 16..23   Manifest-type anchor
     uint32_t capacity;               // 24..27   Ring slots (1..4096)
@@ -85,7 +98,8 @@ typedef struct channel {
     uint32_t refcount;               // 40..43   # outstanding endpoint caps
     uint32_t read_cap_idx;           // 44..47   cap_object_idx for read end
     uint32_t write_cap_idx;          // 48..51   cap_object_idx for write end
-    uint32_t _pad0;                  // 52..55
+    uint16_t writers;                // 52..53   Phase 26: live write endpoints
+    uint16_t flags;                  // 54..55   Phase 26: CHAN_FLAG_*
     struct task_struct *read_waiters;   // 56..63   list of tasks blocked on recv
     struct task_struct *write_waiters;  // 64..71   list of tasks blocked on send
     channel_msg_t   *ring;           // 72..79   kheap array of capacity slots
@@ -112,6 +126,9 @@ typedef struct channel {
     // capture can resolve a chan_endpoint_t back to its channel_t.
     struct channel *reg_next;        // 192..199
     struct channel *reg_prev;        // 200..207
+    // Phase 26: wait-set items watching this channel (kernel/ipc/waitset.h),
+    // guarded by `lock`. Detached with HUP in chan_free.
+    struct waitset_item *ws_watchers; // 208..215
 } channel_t;
 
 // --- Endpoint payload ----------------------------------------------------
@@ -143,6 +160,14 @@ int chan_create(uint64_t type_hash, uint32_t mode, uint32_t capacity,
                 int32_t caller_pid,
                 cap_token_t *rd_tok_out, cap_token_t *wr_tok_out);
 
+// Phase 26: mint another write endpoint for an MPSC channel `c`, owned by
+// caller_pid with audience [caller_pid, peer_pid] (peer_pid <= 0 = caller
+// only), and insert it into the caller's handle table. The channel only
+// reports EPIPE / HUP to its reader once every write endpoint is closed.
+// Returns 0, CAP_V2_EINVAL (not MPSC, or closed), or ENOMEM / cap errors.
+int chan_add_writer(channel_t *c, int32_t caller_pid, int32_t peer_pid,
+                    cap_token_t *wr_tok_out);
+
 // Kernel-internal: create a bare channel_t without cap_object wrapping.
 // Used by the pipe shim which operates below the capability layer.
 // Returns channel_t* on success, NULL on failure.
@@ -171,11 +196,39 @@ int chan_send(channel_t *c, struct task_struct *sender,
 int chan_recv(channel_t *c, struct task_struct *receiver,
               channel_msg_t *msg_kern, uint64_t timeout_ns);
 
+// Phase 26: vectored variants. One lock hold moves as many of `count`
+// messages as fit (send) or are queued (recv), waking one peer per message
+// moved and notifying wait-set watchers once. They block, per mode and
+// timeout, only while nothing at all can move. Return the number of
+// messages moved (>= 1) or a negative CAP_V2_* code if none were.
+//
+// chan_send_batch stops at the first message whose type_hash doesn't match
+// (EPROTOTYPE if it is the first). While the sender is inside a
+// transaction it falls back to per-message chan_send so txn buffering sees
+// every message individually.
+int chan_send_batch(channel_t *c, struct task_struct *sender,
+                    channel_msg_t *msgs, uint32_t count, uint64_t timeout_ns);
+int chan_recv_batch(channel_t *c, struct task_struct *receiver,
+                    channel_msg_t *out, uint32_t max, uint64_t timeout_ns);
+
+// Undo the tail of a chan_recv_batch whose delivery to userspace failed:
+// push msgs[0..count) back at the ring head in their original order and
+// wake blocked readers. If senders have since refilled the ring, the
+// messages that no longer fit are dropped and the caps they carry are
+// destroyed. Returns the number requeued; the caller reports any shortfall.
+int chan_unrecv_batch(channel_t *c, const channel_msg_t *msgs, uint32_t count);
+
 // Non-blocking readability/writability probe. Returns bitmask:
 //  bit 0 = readable (has messages), bit 1 = writable (has space),
 //  bit 2 = closed-peer (EPIPE on further I/O).
 uint32_t chan_poll_probe(channel_t *c);
 
+// Phase 26: report WAITSET_EV_READABLE to the channel's wait-set watchers
+// without queueing a message. Used as the doorbell for side rings that
+// share a channel's readiness (the blk SPSC request ring): the consumer
+// registers the channel edge-triggered and drains the ring on the event.
+void chan_kick(channel_t *c);
+
 // --- W18: snapshot freeze/thaw integration ------------------------------
 // Walk the global channel registry and return the channel_t whose `id`
 // matches `chan_id`, or NULL if none. Used by chan_freeze / chan_thaw to
@@ -220,6 +273,12 @@ int chan_marshal_send(struct task_struct *sender,
                       const chan_msg_user_t *user_msg,
                       channel_msg_t *staged);
 
+// Phase 26: undo chan_marshal_send for a staged message that was never
+// queued (the unsent tail of a partial SENDV): re-insert its handles into
+// the sender's table. Tokens carry the global object idx, so the sender's
+// copies of them become valid again.
+void chan_marshal_unsend(struct task_struct *sender, const channel_msg_t *staged);
+
 // chan_marshal_recv: copy a ring slot into a userspace-shaped chan_msg_user_t,
 // inserting each in-flight cap_object_idx into the receiver's handle table
 // and writing the resulting cap_tokens into user_msg->handles[]. On any
@@ -227,3 +286,38 @@ int chan_marshal_send(struct task_struct *sender,
 int chan_marshal_recv(struct task_struct *receiver,
                       const channel_msg_t *slot,
                       chan_msg_user_t *user_msg);
+
+// --- Page loans (Phase 26) -------------------------------------------------
+// A message may carry a page range of the sender's VMO mappings instead of
+// copying it through the inline payload (SYS_CHAN_SEND_LOAN /
+// SYS_CHAN_RECV_LOAN). The range travels as a CAP_KIND_VMO handle appended
+// after the message's own handles, with CHAN_MSG_FLAG_LOAN set; see
+// vmo_loan_create for the COW / MOVE semantics. A plain SYS_CHAN_RECV
+// receives that handle like any other and may map it itself.
+#define CHAN_LOAN_MOVE  0x1u   // == VMO_LOAN_MOVE
+
+typedef struct chan_loan {
+    uint64_t vaddr;   // send: range base; recv: in = placement hint (0 = any), out = mapped base
+    uint64_t len;     // send: bytes (page multiple); recv: out = bytes mapped
+    uint32_t flags;   // send: CHAN_LOAN_*
+    uint32_t prot;    // kernel-internal on send (source prot for a MOVE undo); recv: out
+} chan_loan_t;
+
+_Static_assert(sizeof(chan_loan_t) == 24, "chan_loan_t must be 24 bytes");
+
+// Detach the loan's range from the sender and append it to `staged`
+// (which must have a free handle slot). Returns 0 or a negative CAP_V2_*.
+int chan_loan_attach(struct task_struct *sender, chan_loan_t *loan,
+                     channel_msg_t *staged);
+
+// Undo chan_loan_attach after a failed send: MOVE ranges are mapped back.
+void chan_loan_cancel(struct task_struct *sender, const chan_loan_t *loan,
+                      channel_msg_t *staged);
+
+// Receiver side: if `slot` carries a loan, map it into the receiver at
+// loan->vaddr (0 = kernel's choice) and drop it from the slot's handles, so
+// chan_marshal_recv only hands out the sender's own handles. Fills
+// loan->vaddr / len / prot (zero if the message has no loan). If the map
+// fails the loan stays in the slot and is delivered as a VMO handle.
+int chan_loan_map(struct task_struct *receiver, channel_msg_t *slot,
+                  chan_loan_t *loan);
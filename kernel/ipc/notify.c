@@ -0,0 +1,164 @@
+// kernel/ipc/notify.c — Phase 26.
+#include "notify.h"
+#include "waitset.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../mm/slab.h"
+#include "../cap/token.h"
+#include "../cap/object.h"
+#include "../cap/handle_table.h"
+#include "../log.h"
+#include "../../arch/x86_64/cpu/sched/sched.h"
+
+extern volatile uint64_t g_timer_ticks;
+
+static kmem_cache_t *g_notify_cache = NULL;
+
+void notify_subsystem_init(void) {
+    g_notify_cache = kmem_cache_create("notify_t", sizeof(notify_t),
+                                       _Alignof(notify_t), NULL, SUBSYS_CAP);
+    if (!g_notify_cache) {
+        klog(KLOG_FATAL, SUBSYS_CAP, "notify_subsystem_init: slab alloc failed");
+        return;
+    }
+    klog(KLOG_INFO, SUBSYS_CAP, "notify subsystem initialized");
+}
+
+// --- Refcount ------------------------------------------------------------
+void notify_ref(notify_t *n) {
+    spinlock_acquire(&n->lock);
+    n->refcount++;
+    spinlock_release(&n->lock);
+}
+
+void notify_put(notify_t *n) {
+    spinlock_acquire(&n->lock);
+    bool last = (--n->refcount == 0);
+    spinlock_release(&n->lock);
+    if (last) {
+        waitset_source_gone(&n->ws_watchers, &n->lock);
+        n->magic = 0;
+        kmem_cache_free(g_notify_cache, n);
+    }
+}
+
+// --- Create / destroy ----------------------------------------------------
+int notify_create(int32_t owner_pid, const int32_t *audience,
+                  cap_token_t *tok_out, uint32_t *obj_idx_out) {
+    if (!tok_out || !g_notify_cache) return CAP_V2_EINVAL;
+    task_t *owner = sched_get_task(owner_pid);
+    if (!owner) return CAP_V2_EINVAL;
+
+    notify_t *n = (notify_t *)kmem_cache_alloc(g_notify_cache);
+    if (!n) return CAP_V2_ENOMEM;
+    memset(n, 0, sizeof(*n));
+    n->magic     = NOTIFY_MAGIC;
+    n->refcount  = 1;
+    n->owner_pid = owner_pid;
+    spinlock_init(&n->lock, "notify");
+
+    int32_t self_only[CAP_AUDIENCE_MAX + 1];
+    if (!audience) {
+        self_only[0] = owner_pid;
+        self_only[1] = PID_NONE;
+        audience = self_only;
+    }
+    int idx = cap_object_create(CAP_KIND_NOTIFY,
+                                RIGHT_READ | RIGHT_WRITE | RIGHT_INSPECT |
+                                    RIGHT_DERIVE | RIGHT_REVOKE,
+                                audience, 0, (uintptr_t)n, owner_pid,
+                                CAP_OBJECT_IDX_NONE);
+    if (idx < 0) {
+        kmem_cache_free(g_notify_cache, n);
+        return idx;
+    }
+    uint32_t slot = 0;
+    int rc = cap_handle_insert(&owner->cap_handles, (uint32_t)idx, 0, &slot);
+    if (rc < 0) {
+        cap_object_destroy((uint32_t)idx);
+        return rc;
+    }
+    cap_object_t *obj = g_cap_object_ptrs[idx];
+    uint32_t gen = obj ? __atomic_load_n(&obj->generation, __ATOMIC_ACQUIRE) : 0;
+    *tok_out = cap_token_pack(gen, (uint32_t)idx, 0);
+    if (obj_idx_out) *obj_idx_out = (uint32_t)idx;
+    return 0;
+}
+
+void notify_deactivate(struct cap_object *obj) {
+    if (!obj) return;
+    notify_t *n = (notify_t *)obj->kind_data;
+    obj->kind_data = 0;
+    if (!n || n->magic != NOTIFY_MAGIC) return;
+
+    spinlock_acquire(&n->lock);
+    n->dead = 1;
+    if (n->ws_watchers) waitset_notify_locked(n->ws_watchers, WAITSET_EV_HUP);
+    spinlock_release(&n->lock);
+    sched_wake_all_on_channel(&n->waiters, CAP_V2_EPIPE);
+    notify_put(n);
+}
+
+// --- Signal / wait -------------------------------------------------------
+int notify_signal(notify_t *n, uint64_t bits) {
+    if (!n || n->magic != NOTIFY_MAGIC) return CAP_V2_EINVAL;
+    if (bits == 0 || (bits & ~NOTIFY_BITS_MASK)) return CAP_V2_EINVAL;
+    if (n->dead) return CAP_V2_EPIPE;
+
+    __atomic_add_fetch(&n->signals, 1, __ATOMIC_RELAXED);
+    uint64_t old = __atomic_fetch_or(&n->bits, bits, __ATOMIC_SEQ_CST);
+    if (old != 0) return 0;   // Coalesced: the consumer is already due a wakeup.
+
+    __atomic_add_fetch(&n->wakeups, 1, __ATOMIC_RELAXED);
+    // One waiter at a time so the doorbell IPI reaches an idle CPU; the
+    // woken task collects every bit, so waking more would only spin.
+    (void)sched_wake_one_on_channel(&n->waiters, 0);
+    waitset_notify(&n->ws_watchers, &n->lock, WAITSET_EV_READABLE);
+    return 0;
+}
+
+long notify_wait(notify_t *n, uint64_t timeout_ns) {
+    if (!n || n->magic != NOTIFY_MAGIC) return CAP_V2_EBADF;
+
+    spinlock_acquire(&n->lock);
+    if (n->dead) {
+        spinlock_release(&n->lock);
+        return CAP_V2_EPIPE;
+    }
+    n->refcount++;
+    spinlock_release(&n->lock);
+
+    // Same 100 Hz tick deadline as waitset_wait; UINT64_MAX waits forever.
+    uint64_t deadline_tick = 0;
+    if (timeout_ns != 0 && timeout_ns != (uint64_t)-1) {
+        uint64_t dt = (timeout_ns + 9999999ULL) / 10000000ULL;
+        if (dt == 0) dt = 1;
+        deadline_tick = g_timer_ticks + dt;
+    }
+
+    long result;
+    for (;;) {
+        uint64_t bits = __atomic_exchange_n(&n->bits, 0, __ATOMIC_ACQ_REL);
+        if (bits || timeout_ns == 0) { result = (long)bits; break; }
+        if (n->dead) { result = CAP_V2_EPIPE; break; }
+        if (deadline_tick && g_timer_ticks >= deadline_tick) { result = 0; break; }
+
+        // seen == 0: don't sleep if a signal landed since the exchange.
+        int rc = sched_block_on_channel_seq(n, WAIT_NOTIFY, deadline_tick,
+                                            &n->waiters, &n->bits, 0);
+        if (rc == CAP_V2_EPIPE) { result = CAP_V2_EPIPE; break; }
+    }
+    notify_put(n);
+    return result;
+}
+
+uint32_t notify_poll_probe(notify_t *n) {
+    if (!n || n->magic != NOTIFY_MAGIC) return WAITSET_EV_HUP;
+    uint32_t ev = __atomic_load_n(&n->bits, __ATOMIC_ACQUIRE) ? WAITSET_EV_READABLE : 0;
+    if (n->dead) ev |= WAITSET_EV_HUP;
+    return ev;
+}
@@ -0,0 +1,84 @@
+// kernel/ipc/notify.h — Phase 26.
+//
+// Notify object: a CAP_KIND_NOTIFY doorbell for shared-memory rings. It is
+// a 64-bit pending-bits word plus a wait queue. A producer ORs bits in with
+// one SYS_NOTIFY_SIGNAL; the consumer collects and clears them with
+// SYS_NOTIFY_WAIT (or registers the handle in a wait-set, where it reports
+// WAITSET_EV_READABLE while any bit is pending).
+//
+// Coalescing: only the signal that moves the word from 0 to non-zero wakes
+// anyone. While the consumer has not yet collected the word it is either
+// already awake or about to be, so later signals are just an atomic OR —
+// no lock, no scheduler call. A ring producer can therefore signal on every
+// post and pay for a wakeup only once per consumer batch.
+//
+// The word doubles as the lost-wakeup guard: notify_wait sleeps through
+// sched_block_on_channel_seq with seen == 0, which refuses to sleep once
+// any bit is set.
+//
+// A notify object has a single logical consumer. With several tasks in
+// notify_wait, each 0 → non-zero transition wakes one of them.
+//
+// Lock order: g_waitset_lock → notify_t.lock → waitset_t.lock → sched_lock.
+#pragma once
+
+#include <stdint.h>
+
+#include "../sync/spinlock.h"
+#include "../cap/token.h"       // cap_token_t
+
+struct task_struct;
+struct cap_object;
+struct waitset_item;
+
+#define NOTIFY_MAGIC        0x4E0717F1u
+
+// Bits a signal may carry. Kept to 32 so SYS_NOTIFY_WAIT can return the
+// collected word as a non-negative long.
+#define NOTIFY_BITS_MASK    0xFFFFFFFFull
+
+typedef struct notify {
+    uint32_t             magic;        // NOTIFY_MAGIC
+    uint32_t             refcount;     // 1 for the cap + kernel holders + tasks inside notify_wait
+    uint32_t             dead;         // Set by notify_deactivate
+    int32_t              owner_pid;
+    uint64_t             bits;         // Pending bits; exchanged to 0 by the consumer
+    uint64_t             signals;      // Lifetime notify_signal calls
+    uint64_t             wakeups;      // Signals that were not coalesced
+    struct task_struct  *waiters;      // Tasks blocked in notify_wait
+    struct waitset_item *ws_watchers;  // Wait-set items watching this object (lock)
+    spinlock_t           lock;
+} notify_t;
+
+// --- Lifecycle -------------------------------------------------------------
+void notify_subsystem_init(void);
+
+// Create a notify object owned by owner_pid, wrap it in a CAP_KIND_NOTIFY
+// cap_object and insert it into the owner's handle table. `audience` is a
+// PID_NONE-terminated list as for cap_object_create (NULL = owner only;
+// kernel producers that hand the cap to a daemon pass PID_PUBLIC). Returns
+// 0 and writes the token (and, if obj_idx_out is non-NULL, the cap_object
+// index), or a negative CAP_V2_* code.
+int notify_create(int32_t owner_pid, const int32_t *audience,
+                  cap_token_t *tok_out, uint32_t *obj_idx_out);
+
+// Kernel-side references for producers that keep a notify_t* beyond the
+// life of the handle they created it through (e.g. after transferring it).
+void notify_ref(notify_t *n);
+void notify_put(notify_t *n);
+
+// cap_object_destroy hook for CAP_KIND_NOTIFY.
+void notify_deactivate(struct cap_object *obj);
+
+// --- Signal / wait -----------------------------------------------------------
+// OR `bits` (non-zero, within NOTIFY_BITS_MASK) into the word. Safe from any
+// context that may take a spinlock. Returns 0 or CAP_V2_EINVAL / EPIPE.
+int notify_signal(notify_t *n, uint64_t bits);
+
+// Collect and clear the pending bits, blocking up to timeout_ns (0 = poll,
+// UINT64_MAX = forever) while none are set. Returns the bits (> 0), 0 on
+// timeout, or CAP_V2_EPIPE if the object is destroyed while waiting.
+long notify_wait(notify_t *n, uint64_t timeout_ns);
+
+// Wait-set probe: WAITSET_EV_READABLE while any bit is pending.
+uint32_t notify_poll_probe(notify_t *n);
@@ -0,0 +1,527 @@
+// kernel/ipc/waitset.c — Phase 26.
+#include "waitset.h"
+#include "channel.h"
+#include "notify.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../mm/slab.h"
+#include "../cap/token.h"
+#include "../cap/object.h"
+#include "../cap/handle_table.h"
+#include "../io/stream.h"
+#include "../driver/userdrv.h"
+#include "../log.h"
+#include "../../arch/x86_64/cpu/sched/sched.h"
+
+extern volatile uint64_t g_timer_ticks;
+
+// --- Subsystem globals ---------------------------------------------------
+static kmem_cache_t *g_waitset_cache = NULL;
+static kmem_cache_t *g_waitset_item_cache = NULL;
+
+// Serialises item membership on source watcher lists (ADD / DEL / set
+// teardown / source teardown) against harvest, which dereferences
+// item->src. Never taken on the notify path.
+static spinlock_t g_waitset_lock = SPINLOCK_INITIALIZER("waitset");
+
+void waitset_subsystem_init(void) {
+    g_waitset_cache = kmem_cache_create("waitset_t", sizeof(waitset_t),
+                                        _Alignof(waitset_t), NULL, SUBSYS_CAP);
+    g_waitset_item_cache = kmem_cache_create("waitset_item_t",
+                                             sizeof(waitset_item_t),
+                                             _Alignof(waitset_item_t), NULL,
+                                             SUBSYS_CAP);
+    if (!g_waitset_cache || !g_waitset_item_cache) {
+        klog(KLOG_FATAL, SUBSYS_CAP, "waitset_subsystem_init: slab alloc failed");
+        return;
+    }
+    klog(KLOG_INFO, SUBSYS_CAP, "waitset subsystem initialized");
+}
+
+// --- Refcount ------------------------------------------------------------
+void waitset_put(waitset_t *ws) {
+    spinlock_acquire(&ws->lock);
+    bool last = (--ws->refcount == 0);
+    spinlock_release(&ws->lock);
+    if (last) {
+        ws->magic = 0;
+        kmem_cache_free(g_waitset_cache, ws);
+    }
+}
+
+// --- Readiness -----------------------------------------------------------
+// Record `events` on an item and queue it for harvest. Caller holds either
+// the item's source lock or g_waitset_lock, which keeps the item (and so
+// its set) alive.
+static void waitset_mark_ready(waitset_item_t *it, uint32_t events) {
+    waitset_t *ws = it->ws;
+    events &= it->events | WAITSET_EV_HUP;
+    if (!events) return;
+
+    spinlock_acquire(&ws->lock);
+    if (!it->armed) {
+        spinlock_release(&ws->lock);
+        return;
+    }
+    it->pending |= events;
+    // Already queued means no harvest has run since the last notify, so
+    // that notify's seq bump and wake still cover this one.
+    bool queued = it->on_ready;
+    if (!queued) {
+        it->on_ready   = 1;
+        it->ready_next = NULL;
+        if (ws->ready_tail) ws->ready_tail->ready_next = it;
+        else                ws->ready_head = it;
+        ws->ready_tail = it;
+        __atomic_add_fetch(&ws->seq, 1, __ATOMIC_RELEASE);
+    }
+    spinlock_release(&ws->lock);
+    // Wake one at a time: sched_wake_one_on_channel sends the doorbell IPI
+    // to an idle target CPU, so a cross-CPU waiter runs within microseconds
+    // instead of at its next tick.
+    if (!queued) {
+        while (sched_wake_one_on_channel(&ws->waiters, 0)) {}
+    }
+}
+
+void waitset_notify_locked(waitset_item_t *watchers, uint32_t events) {
+    for (waitset_item_t *it = watchers; it; it = it->src_next) {
+        waitset_mark_ready(it, events);
+    }
+}
+
+void waitset_notify_slow(waitset_item_t **watchers, spinlock_t *lock,
+                         uint32_t events) {
+    spinlock_acquire(lock);
+    waitset_notify_locked(*watchers, events);
+    spinlock_release(lock);
+}
+
+// Current level of an item's source, in WAITSET_EV_* bits. Caller holds
+// g_waitset_lock so item->src can't be freed underneath us.
+static uint32_t waitset_probe(const waitset_item_t *it) {
+    if (!it->src) return WAITSET_EV_HUP;
+    switch (it->kind) {
+        case CAP_KIND_CHANNEL:
+            return chan_poll_probe((channel_t *)it->src);
+        case CAP_KIND_IRQ_CHANNEL:
+            return userdrv_irq_probe((drv_irq_channel_t *)it->src);
+        case CAP_KIND_STREAM:
+            return stream_poll_probe((stream_t *)it->src);
+        case CAP_KIND_NOTIFY:
+            return notify_poll_probe((notify_t *)it->src);
+        default:
+            return 0;
+    }
+}
+
+// Unlink an item from its source's watcher list. Caller holds
+// g_waitset_lock.
+static void waitset_item_detach_src(waitset_item_t *it) {
+    if (!it->src) return;
+    spinlock_acquire(it->src_lock);
+    waitset_item_t **pp = it->src_head;
+    while (*pp && *pp != it) pp = &(*pp)->src_next;
+    if (*pp) *pp = it->src_next;
+    spinlock_release(it->src_lock);
+    it->src      = NULL;
+    it->src_lock = NULL;
+    it->src_head = NULL;
+    it->src_next = NULL;
+}
+
+void waitset_source_gone(waitset_item_t **watchers, spinlock_t *lock) {
+    if (!__atomic_load_n(watchers, __ATOMIC_ACQUIRE)) return;
+    spinlock_acquire(&g_waitset_lock);
+    spinlock_acquire(lock);
+    waitset_item_t *it = *watchers;
+    *watchers = NULL;
+    spinlock_release(lock);
+    while (it) {
+        waitset_item_t *next = it->src_next;
+        it->src      = NULL;
+        it->src_lock = NULL;
+        it->src_head = NULL;
+        it->src_next = NULL;
+        waitset_mark_ready(it, WAITSET_EV_HUP);
+        it = next;
+    }
+    spinlock_release(&g_waitset_lock);
+}
+
+// --- Create / destroy ----------------------------------------------------
+int waitset_create(int32_t owner_pid, cap_token_t *tok_out) {
+    if (!tok_out || !g_waitset_cache) return CAP_V2_EINVAL;
+    task_t *owner = sched_get_task(owner_pid);
+    if (!owner) return CAP_V2_EINVAL;
+
+    waitset_t *ws = (waitset_t *)kmem_cache_alloc(g_waitset_cache);
+    if (!ws) return CAP_V2_ENOMEM;
+    memset(ws, 0, sizeof(*ws));
+    ws->magic     = WAITSET_MAGIC;
+    ws->refcount  = 1;
+    ws->owner_pid = owner_pid;
+    spinlock_init(&ws->lock, "waitset");
+
+    int32_t audience[CAP_AUDIENCE_MAX + 1];
+    audience[0] = owner_pid;
+    audience[1] = PID_NONE;
+    int idx = cap_object_create(CAP_KIND_WAITSET,
+                                RIGHT_READ | RIGHT_WRITE | RIGHT_INSPECT |
+                                    RIGHT_DERIVE | RIGHT_REVOKE,
+                                audience, 0, (uintptr_t)ws, owner_pid,
+                                CAP_OBJECT_IDX_NONE);
+    if (idx < 0) {
+        kmem_cache_free(g_waitset_cache, ws);
+        return idx;
+    }
+    uint32_t slot = 0;
+    int rc = cap_handle_insert(&owner->cap_handles, (uint32_t)idx, 0, &slot);
+    if (rc < 0) {
+        cap_object_destroy((uint32_t)idx);
+        return rc;
+    }
+    cap_object_t *obj = g_cap_object_ptrs[idx];
+    uint32_t gen = obj ? __atomic_load_n(&obj->generation, __ATOMIC_ACQUIRE) : 0;
+    *tok_out = cap_token_pack(gen, (uint32_t)idx, 0);
+    return 0;
+}
+
+// The set behind a resolved CAP_KIND_WAITSET object, with a reference held
+// for the caller's syscall; NULL once a close has started tearing it down.
+// Taking kind_data under g_waitset_lock orders this against
+// waitset_deactivate, which clears it under the same lock.
+waitset_t *waitset_get(struct cap_object *obj) {
+    if (!obj) return NULL;
+    spinlock_acquire(&g_waitset_lock);
+    waitset_t *ws = obj->kind == CAP_KIND_WAITSET ? (waitset_t *)obj->kind_data
+                                                   : NULL;
+    if (ws && ws->magic == WAITSET_MAGIC) {
+        spinlock_acquire(&ws->lock);
+        if (ws->dead) {
+            spinlock_release(&ws->lock);
+            ws = NULL;
+        } else {
+            ws->refcount++;
+            spinlock_release(&ws->lock);
+        }
+    } else {
+        ws = NULL;
+    }
+    spinlock_release(&g_waitset_lock);
+    return ws;
+}
+
+void waitset_deactivate(struct cap_object *obj) {
+    if (!obj) return;
+    spinlock_acquire(&g_waitset_lock);
+    waitset_t *ws = (waitset_t *)obj->kind_data;
+    obj->kind_data = 0;
+    if (!ws || ws->magic != WAITSET_MAGIC) {
+        spinlock_release(&g_waitset_lock);
+        return;
+    }
+
+    waitset_item_t *it = ws->items;
+    while (it) {
+        waitset_item_t *next = it->ws_next;
+        waitset_item_detach_src(it);
+        kmem_cache_free(g_waitset_item_cache, it);
+        it = next;
+    }
+    spinlock_acquire(&ws->lock);
+    ws->items      = NULL;
+    ws->ready_head = NULL;
+    ws->ready_tail = NULL;
+    ws->nitems     = 0;
+    ws->dead       = 1;
+    __atomic_add_fetch(&ws->seq, 1, __ATOMIC_RELEASE);
+    spinlock_release(&ws->lock);
+    spinlock_release(&g_waitset_lock);
+
+    sched_wake_all_on_channel(&ws->waiters, CAP_V2_EPIPE);
+    waitset_put(ws);
+}
+
+// --- Control -------------------------------------------------------------
+// Resolve a source handle to its watcher list. Returns the kind-specific
+// mask of events the source can ever report, or 0 if the handle can't be
+// watched.
+static uint32_t waitset_resolve_src(cap_object_t *obj, void **src,
+                                    spinlock_t **lock,
+                                    waitset_item_t ***head) {
+    switch (obj->kind) {
+        case CAP_KIND_CHANNEL: {
+            chan_endpoint_t *ep = (chan_endpoint_t *)obj->kind_data;
+            if (!ep || !ep->channel) return 0;
+            channel_t *c = ep->channel;
+            *src = c; *lock = &c->lock; *head = &c->ws_watchers;
+            return (ep->direction == CHAN_ENDPOINT_READ ? WAITSET_EV_READABLE
+                                                        : WAITSET_EV_WRITABLE) |
+                   WAITSET_EV_HUP;
+        }
+        case CAP_KIND_IRQ_CHANNEL: {
+            drv_irq_channel_t *ic = (drv_irq_channel_t *)obj->kind_data;
+            if (!ic) return 0;
+            *src = ic; *lock = &ic->base.lock; *head = &ic->base.ws_watchers;
+            return WAITSET_EV_READABLE | WAITSET_EV_HUP;
+        }
+        case CAP_KIND_STREAM: {
+            stream_endpoint_t *ep = (stream_endpoint_t *)obj->kind_data;
+            if (!ep || !ep->stream) return 0;
+            stream_t *s = ep->stream;
+            *src = s; *lock = &s->lock; *head = &s->ws_watchers;
+            return WAITSET_EV_READABLE | WAITSET_EV_HUP;
+        }
+        case CAP_KIND_NOTIFY: {
+            notify_t *n = (notify_t *)obj->kind_data;
+            if (!n) return 0;
+            *src = n; *lock = &n->lock; *head = &n->ws_watchers;
+            return WAITSET_EV_READABLE | WAITSET_EV_HUP;
+        }
+        default:
+            return 0;
+    }
+}
+
+static waitset_item_t *waitset_find(waitset_t *ws, uint32_t obj_idx) {
+    for (waitset_item_t *it = ws->items; it; it = it->ws_next) {
+        if (it->obj_idx == obj_idx) return it;
+    }
+    return NULL;
+}
+
+// Drop an item from ws->ready_head. Caller holds ws->lock.
+static void waitset_unqueue(waitset_t *ws, waitset_item_t *it) {
+    if (!it->on_ready) return;
+    waitset_item_t *prev = NULL;
+    for (waitset_item_t *r = ws->ready_head; r; prev = r, r = r->ready_next) {
+        if (r != it) continue;
+        if (prev) prev->ready_next = r->ready_next;
+        else      ws->ready_head   = r->ready_next;
+        if (ws->ready_tail == r) ws->ready_tail = prev;
+        break;
+    }
+    it->on_ready   = 0;
+    it->ready_next = NULL;
+}
+
+int waitset_ctl(waitset_t *ws, int32_t caller_pid, uint32_t op,
+                cap_token_t handle, uint32_t events, uint64_t cookie) {
+    if (!ws || ws->magic != WAITSET_MAGIC) return CAP_V2_EBADF;
+    uint32_t interest = events & WAITSET_EV_MASK;
+    uint32_t mode     = events & (WAITSET_EDGE | WAITSET_ONESHOT);
+    if (events & ~(WAITSET_EV_MASK | WAITSET_EDGE | WAITSET_ONESHOT))
+        return CAP_V2_EINVAL;
+
+    uint32_t obj_idx = cap_token_idx(handle);
+
+    // DEL matches on the object index alone so a registration can still be
+    // dropped after its source handle has been closed.
+    if (op == WAITSET_CTL_DEL) {
+        spinlock_acquire(&g_waitset_lock);
+        waitset_item_t *it = waitset_find(ws, obj_idx);
+        if (!it) {
+            spinlock_release(&g_waitset_lock);
+            return CAP_V2_EINVAL;
+        }
+        waitset_item_detach_src(it);
+        spinlock_acquire(&ws->lock);
+        waitset_item_t **pp = &ws->items;
+        while (*pp != it) pp = &(*pp)->ws_next;
+        *pp = it->ws_next;
+        waitset_unqueue(ws, it);
+        ws->nitems--;
+        spinlock_release(&ws->lock);
+        spinlock_release(&g_waitset_lock);
+        kmem_cache_free(g_waitset_item_cache, it);
+        return 0;
+    }
+    if (op != WAITSET_CTL_ADD && op != WAITSET_CTL_MOD) return CAP_V2_EINVAL;
+
+    cap_object_t *obj = cap_token_resolve(caller_pid, handle, RIGHT_INSPECT);
+    if (!obj) return CAP_V2_EBADF;
+
+    void *src = NULL;
+    spinlock_t *src_lock = NULL;
+    waitset_item_t **src_head = NULL;
+    uint32_t supported = waitset_resolve_src(obj, &src, &src_lock, &src_head);
+    if (!supported) return CAP_V2_EBADF;
+    interest &= supported;
+    if (!interest) return CAP_V2_EINVAL;
+
+    waitset_item_t *fresh = NULL;
+    if (op == WAITSET_CTL_ADD) {
+        fresh = (waitset_item_t *)kmem_cache_alloc(g_waitset_item_cache);
+        if (!fresh) return CAP_V2_ENOMEM;
+        memset(fresh, 0, sizeof(*fresh));
+    }
+
+    spinlock_acquire(&g_waitset_lock);
+    waitset_item_t *it = waitset_find(ws, obj_idx);
+    if (op == WAITSET_CTL_ADD) {
+        if (it || ws->nitems >= WAITSET_MAX_ITEMS || ws->dead) {
+            spinlock_release(&g_waitset_lock);
+            kmem_cache_free(g_waitset_item_cache, fresh);
+            return it ? CAP_V2_EBUSY : CAP_V2_ENOMEM;
+        }
+        it = fresh;
+        it->ws       = ws;
+        it->kind     = obj->kind;
+        it->obj_idx  = obj_idx;
+        it->src      = src;
+        it->src_lock = src_lock;
+        it->src_head = src_head;
+        it->events   = interest;
+        it->flags    = mode;
+        it->cookie   = cookie;
+        it->armed    = 1;
+        spinlock_acquire(&ws->lock);
+        it->ws_next = ws->items;
+        ws->items   = it;
+        ws->nitems++;
+        spinlock_release(&ws->lock);
+        // Link last: from here on notifies reach the item, and the probe
+        // below (after the lock's full barrier) catches anything earlier.
+        spinlock_acquire(src_lock);
+        it->src_next = *src_head;
+        *src_head    = it;
+        spinlock_release(src_lock);
+    } else {
+        if (!it) {
+            spinlock_release(&g_waitset_lock);
+            return CAP_V2_EINVAL;
+        }
+        spinlock_acquire(&ws->lock);
+        it->events  = interest;
+        it->flags   = mode;
+        it->cookie  = cookie;
+        it->armed   = 1;
+        it->pending = 0;
+        waitset_unqueue(ws, it);
+        spinlock_release(&ws->lock);
+    }
+    // Report a source that is already ready, for both trigger modes — an
+    // edge-triggered item would otherwise miss data queued before the ADD.
+    waitset_mark_ready(it, waitset_probe(it));
+    spinlock_release(&g_waitset_lock);
+    return 0;
+}
+
+// --- Wait ----------------------------------------------------------------
+// Move up to `max` events from the ready list into `out`. Level-triggered
+// items are re-probed and re-queued while still ready; edge-triggered
+// items report their pending bits once.
+static uint32_t waitset_harvest(waitset_t *ws, waitset_event_t *out,
+                                uint32_t max) {
+    uint32_t n = 0;
+    spinlock_acquire(&g_waitset_lock);
+    spinlock_acquire(&ws->lock);
+    waitset_item_t *list = ws->ready_head;
+    ws->ready_head = NULL;
+    ws->ready_tail = NULL;
+    spinlock_release(&ws->lock);
+
+    waitset_item_t *requeue_head = NULL, *requeue_tail = NULL;
+    while (list) {
+        waitset_item_t *it = list;
+        list = it->ready_next;
+        it->ready_next = NULL;
+
+        if (n == max) {
+            // Out of room: keep it queued for the next call.
+            if (requeue_tail) requeue_tail->ready_next = it;
+            else              requeue_head = it;
+            requeue_tail = it;
+            continue;
+        }
+
+        spinlock_acquire(&ws->lock);
+        it->on_ready = 0;
+        uint32_t pending = it->pending;
+        it->pending = 0;
+        spinlock_release(&ws->lock);
+
+        bool edge = (it->flags & WAITSET_EDGE) != 0;
+        uint32_t ev = edge ? pending : (waitset_probe(it) | (pending & WAITSET_EV_HUP));
+        ev &= it->events | WAITSET_EV_HUP;
+        if (!ev || !it->armed) continue;
+
+        out[n].cookie = it->cookie;
+        out[n].events = ev;
+        out[n]._pad   = 0;
+        n++;
+
+        if (it->flags & WAITSET_ONESHOT) {
+            it->armed = 0;
+        } else if (!edge) {
+            // Level-triggered and still ready: stays on the ready list so
+            // the next wait re-probes it. waitset_mark_ready may have
+            // queued it again meanwhile; on_ready tells us.
+            spinlock_acquire(&ws->lock);
+            if (!it->on_ready) {
+                it->on_ready   = 1;
+                it->ready_next = NULL;
+                if (ws->ready_tail) ws->ready_tail->ready_next = it;
+                else                ws->ready_head = it;
+                ws->ready_tail = it;
+            }
+            spinlock_release(&ws->lock);
+        }
+    }
+    if (requeue_head) {
+        // Overflow items go back in front, ahead of anything that arrived
+        // during the harvest, so busy sources can't starve them.
+        spinlock_acquire(&ws->lock);
+        requeue_tail->ready_next = ws->ready_head;
+        ws->ready_head = requeue_head;
+        if (!ws->ready_tail) ws->ready_tail = requeue_tail;
+        spinlock_release(&ws->lock);
+    }
+    spinlock_release(&g_waitset_lock);
+    return n;
+}
+
+int waitset_wait(waitset_t *ws, waitset_event_t *out, uint32_t max,
+                 uint64_t timeout_ns) {
+    if (!ws || ws->magic != WAITSET_MAGIC) return CAP_V2_EBADF;
+    if (!out || max == 0) return CAP_V2_EINVAL;
+    if (max > WAITSET_WAIT_MAX) max = WAITSET_WAIT_MAX;
+
+    spinlock_acquire(&ws->lock);
+    if (ws->dead) {
+        spinlock_release(&ws->lock);
+        return CAP_V2_EPIPE;
+    }
+    ws->refcount++;
+    spinlock_release(&ws->lock);
+
+    // Same 100 Hz tick deadline as stream_reap; UINT64_MAX waits forever.
+    uint64_t deadline_tick = 0;
+    if (timeout_ns != 0 && timeout_ns != (uint64_t)-1) {
+        uint64_t dt = (timeout_ns + 9999999ULL) / 10000000ULL;
+        if (dt == 0) dt = 1;
+        deadline_tick = g_timer_ticks + dt;
+    }
+
+    int result;
+    for (;;) {
+        uint64_t seen = __atomic_load_n(&ws->seq, __ATOMIC_ACQUIRE);
+        uint32_t n = waitset_harvest(ws, out, max);
+        if (n > 0 || timeout_ns == 0) { result = (int)n; break; }
+        if (ws->dead) { result = CAP_V2_EPIPE; break; }
+        if (deadline_tick && g_timer_ticks >= deadline_tick) { result = 0; break; }
+
+        int rc = sched_block_on_channel_seq(ws, WAIT_WAITSET, deadline_tick,
+                                            &ws->waiters, &ws->seq, seen);
+        if (rc == CAP_V2_EPIPE) { result = CAP_V2_EPIPE; break; }
+        // 0 (notify / seq moved) or -ETIMEDOUT: harvest again; the deadline
+        // check above turns a true timeout into a 0 return.
+    }
+    waitset_put(ws);
+    return result;
+}
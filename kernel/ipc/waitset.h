@@ -0,0 +1,162 @@
+// kernel/ipc/waitset.h — Phase 26.
+//
+// Wait-set: a CAP_KIND_WAITSET object that multiplexes readiness across
+// channel endpoints, IRQ channels and submission streams. A daemon
+// registers each handle once (SYS_WAITSET_CTL) and then blocks in a single
+// SYS_WAITSET_WAIT that returns a batch of {cookie, events} records. It
+// replaces the probe-only SYS_CHAN_POLL loop, so an idle daemon costs no
+// CPU and a busy one is woken as soon as the event is posted.
+//
+// Readiness tracking:
+//   - Each source (channel_t, and through its embedded base the
+//     drv_irq_channel_t; stream_t; notify_t) carries a `ws_watchers` list
+//     of the waitset_item_t's registered on it, guarded by the source's
+//     own lock.
+//   - Sources call waitset_notify[_locked] when they change state (message
+//     queued / slot freed / IRQ posted / CQE posted / notify signalled /
+//     peer closed). The item is queued on its set's ready list and the
+//     set's waiters woken.
+//   - Level-triggered items (default) are re-probed at harvest and stay on
+//     the ready list while the condition holds. WAITSET_EDGE items report
+//     the bits accumulated since the last harvest, once. WAITSET_ONESHOT
+//     disarms the item after one report until the next WAITSET_CTL_MOD.
+//   - waitset_source_gone detaches every item from a source that is being
+//     freed and reports WAITSET_EV_HUP on it.
+//
+// Lost wakeups are closed by ws->seq: waitset_wait samples it before
+// harvesting and sleeps through sched_block_on_channel_seq, which refuses
+// to sleep if a notify bumped it in between.
+//
+// Lock order: g_waitset_lock → source lock (channel_t.lock / stream_t.lock)
+//             → waitset_t.lock → sched_lock.
+#pragma once
+
+#include <stdint.h>
+
+#include "../sync/spinlock.h"
+#include "../cap/token.h"       // cap_token_t
+
+struct task_struct;
+struct cap_object;
+
+#define WAITSET_MAGIC          0xCAFE3A17u
+
+// --- Event bits (same encoding as chan_poll_probe) -------------------------
+#define WAITSET_EV_READABLE    0x1u
+#define WAITSET_EV_WRITABLE    0x2u
+#define WAITSET_EV_HUP         0x4u   // Peer closed / source destroyed; always reported
+#define WAITSET_EV_MASK        0x7u
+
+// --- Item mode flags (OR'd into the events argument of WAITSET_CTL) ---------
+#define WAITSET_EDGE           0x100u
+#define WAITSET_ONESHOT        0x200u
+
+// --- WAITSET_CTL ops ---------------------------------------------------------
+#define WAITSET_CTL_ADD        1u
+#define WAITSET_CTL_MOD        2u
+#define WAITSET_CTL_DEL        3u
+
+#define WAITSET_MAX_ITEMS      1024u  // Registered handles per set
+#define WAITSET_WAIT_MAX       64u    // Events returned per SYS_WAITSET_WAIT
+
+// --- Userspace-visible event record ----------------------------------------
+typedef struct waitset_event {
+    uint64_t cookie;         //  0..7   Caller-chosen tag from WAITSET_CTL
+    uint32_t events;         //  8..11  WAITSET_EV_* bits that fired
+    uint32_t _pad;           // 12..15
+} waitset_event_t;
+
+_Static_assert(sizeof(waitset_event_t) == 16, "waitset_event_t must be 16 bytes");
+
+struct waitset;
+
+// One registration of a source handle in a set. Linked on three lists:
+// the source's ws_watchers (src_next), the set's item list (ws_next) and,
+// while it has something to report, the set's ready list (ready_next).
+typedef struct waitset_item {
+    struct waitset        *ws;
+    uint16_t               kind;       // CAP_KIND_CHANNEL / _IRQ_CHANNEL / _STREAM / _NOTIFY
+    uint8_t                on_ready;   // Linked on ws->ready_head (ws->lock)
+    uint8_t                armed;      // Cleared after a ONESHOT report
+    uint32_t               obj_idx;    // cap_object idx the item was added by
+    void                  *src;        // channel_t / drv_irq_channel_t / stream_t / notify_t; NULL once gone
+    spinlock_t            *src_lock;
+    struct waitset_item  **src_head;   // &src->ws_watchers
+    uint32_t               events;     // Interest mask (WAITSET_EV_*)
+    uint32_t               flags;      // WAITSET_EDGE | WAITSET_ONESHOT
+    uint32_t               pending;    // Bits notified since the last harvest (ws->lock)
+    uint32_t               _pad;
+    uint64_t               cookie;
+    struct waitset_item   *src_next;
+    struct waitset_item   *ws_next;
+    struct waitset_item   *ready_next;
+} waitset_item_t;
+
+typedef struct waitset {
+    uint32_t           magic;          // WAITSET_MAGIC
+    uint32_t           nitems;
+    uint32_t           refcount;       // 1 for the cap + 1 per task in a CTL / WAIT call
+    uint32_t           dead;           // Set by waitset_deactivate
+    int32_t            owner_pid;
+    uint32_t           _pad0;
+    uint64_t           seq;            // Bumped on every new readiness (lost-wakeup guard)
+    waitset_item_t    *items;
+    waitset_item_t    *ready_head;
+    waitset_item_t    *ready_tail;
+    struct task_struct *waiters;       // Tasks blocked in waitset_wait
+    spinlock_t         lock;
+} waitset_t;
+
+// --- Lifecycle -------------------------------------------------------------
+void waitset_subsystem_init(void);
+
+// Create a set owned by owner_pid, wrap it in a CAP_KIND_WAITSET cap_object
+// and insert it into the owner's handle table. Returns 0 and writes the
+// token, or a negative CAP_V2_* code.
+int waitset_create(int32_t owner_pid, cap_token_t *tok_out);
+
+// Add / modify / remove the registration for `handle`. `events` carries the
+// WAITSET_EV_* interest bits plus WAITSET_EDGE / WAITSET_ONESHOT. Returns 0
+// or a negative CAP_V2_* code (EBADF unknown handle or unsupported kind,
+// EBUSY duplicate ADD, EINVAL bad op/mask or MOD/DEL of an unregistered
+// handle, ENOMEM item limit).
+int waitset_ctl(waitset_t *ws, int32_t caller_pid, uint32_t op,
+                cap_token_t handle, uint32_t events, uint64_t cookie);
+
+// Harvest up to `max` ready events into the kernel buffer `out`, blocking
+// up to timeout_ns (0 = poll, UINT64_MAX = forever) if none are ready.
+// Returns the event count (0 on timeout) or CAP_V2_EPIPE if the set is
+// destroyed while waiting.
+int waitset_wait(waitset_t *ws, waitset_event_t *out, uint32_t max,
+                 uint64_t timeout_ns);
+
+// cap_object_destroy hook for CAP_KIND_WAITSET.
+void waitset_deactivate(struct cap_object *obj);
+
+// SYS_WAITSET_CTL / _WAIT: pin the set behind a resolved cap for the call,
+// so a concurrent close cannot free it underneath. NULL if it is going away.
+waitset_t *waitset_get(struct cap_object *obj);
+void waitset_put(waitset_t *ws);
+
+// --- Source hooks ------------------------------------------------------------
+// Report `events` to every item on a source's watcher list. Caller holds the
+// source lock.
+void waitset_notify_locked(waitset_item_t *watchers, uint32_t events);
+
+// Unlocked-caller variant with a no-watcher fast path, for sources whose
+// state change is published without the source lock (IRQ ring post, CQE
+// post). The fence orders the caller's publish before the watcher check,
+// pairing with WAITSET_CTL_ADD which links the item before probing.
+void waitset_notify_slow(waitset_item_t **watchers, spinlock_t *lock,
+                         uint32_t events);
+static inline void waitset_notify(waitset_item_t **watchers, spinlock_t *lock,
+                                  uint32_t events) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(watchers, __ATOMIC_RELAXED)) {
+        waitset_notify_slow(watchers, lock, events);
+    }
+}
+
+// Detach all items from a source about to be freed and report HUP on them.
+// Must be called before the source's storage is released.
+void waitset_source_gone(waitset_item_t **watchers, spinlock_t *lock);
@@ -46,6 +46,9 @@
 #include "ipc/manifest.h"
 #include "mm/vmo.h"
 #include "ipc/channel.h"
+#include "ipc/waitset.h"
+#include "ipc/notify.h"
+#include "ipc/bcast.h"
 #include "snap/snapshot.h"
 #include "io/stream.h"
 
@@ -448,10 +451,19 @@ void kmain(void) {
     framebuffer_draw_string("Phase 17 VMOs Ready.", 50, y_pos, COLOR_GREEN, 0x00101828);
     y_pos += 20;
 
+    // Phase 26: executable page cache. Installs the PTE_IMAGE_COW fault
+    // hook; must run before the first elf_load.
+    elf_cache_init();
+
     // Phase 17: channel subsystem. Registers channel_t + chan_endpoint_t
     // slab caches. Must run after manifest_init (channels consume type hashes).
     klog(KLOG_INFO, SUBSYS_CORE, "Phase 17: channel_subsystem_init...");
     channel_subsystem_init();
+    // Phase 26: wait-set, notify and broadcast slab caches (multi-handle
+    // readiness wait, shared-ring doorbells, pub/sub rings).
+    waitset_subsystem_init();
+    notify_subsystem_init();
+    bcast_subsystem_init();
     framebuffer_draw_string("Phase 17 Channels Ready.", 50, y_pos, COLOR_GREEN, 0x00101828);
     y_pos += 20;
 
@@ -981,7 +993,8 @@ void kmain(void) {
                 asm volatile("cli; hlt");
             }
         }
-        
+
+        snap_barrier_help();   // Phase 26: see ap_idle_entry
         asm volatile("hlt");
     }
 
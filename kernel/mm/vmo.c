@@ -22,19 +22,39 @@ static kmem_cache_t *g_vmo_cache = NULL;
 static uint64_t g_next_vmo_id = 1;
 static spinlock_t g_vmo_id_lock = SPINLOCK_INITIALIZER("vmo_id");
 
-// Per-task mapping table. Indexed by task_id. Each task has up to
-// VMO_MAPPINGS_PER_TASK slots. A slot with vaddr==0 is free.
+// Phase 26: per-address-space mapping index. Each task that maps a VMO owns
+// one vmo_as_t (task_t.vmo_as, created on first vmo_map). Mappings of one
+// address space never overlap, so a balanced BST keyed on the base VA is a
+// complete interval index: "which mapping contains va" is a predecessor
+// search. AVL keeps the depth ≤ 1.44·log2(n), so the fault path is O(log n)
+// and takes only the faulting address space's lock.
 //
-// Phase 23 Stage 2 cutover: bumped 64 → 256 because the cutover added a
-// kernel-side blk_client kt task that consumes a pid slot, which pushed
-// late-spawned daemons (e1000d etc.) past the previous 64-pid cap and
-// caused vmo_map → vmo_alloc_map_slot to silently return -1 (mapping the
-// MMIO BAR fails, daemon exits with status=2). 256 leaves headroom for
-// the gate's typical ~70-pid workload plus the new kt + ahcid + future
-// driver daemons. BSS impact: 256 * 8 * 32 B = 64 KB.
-#define VMO_MAX_TASKS 256
-static vmo_mapping_t g_vmo_task_maps[VMO_MAX_TASKS][VMO_MAPPINGS_PER_TASK];
-static spinlock_t g_vmo_map_lock = SPINLOCK_INITIALIZER("vmo_map");
+// This replaces the Phase 17 g_vmo_task_maps[256][64] table, which failed
+// vmo_map for any task_id ≥ 256 and walked all 64 slots under one global
+// lock on every COW fault.
+typedef struct vmo_map_node {
+    vmo_mapping_t        m;       //  0..31
+    struct vmo_map_node *left;    // 32..39
+    struct vmo_map_node *right;   // 40..47
+    int32_t              height;  // 48..51  AVL height; leaf = 1
+} vmo_map_node_t;
+
+typedef struct vmo_as {
+    spinlock_t      lock;    // Protects root, count and every node's m
+    vmo_map_node_t *root;
+    uint32_t        count;
+    task_t         *owner;
+    // g_vmo_as_head registry link, walked by the vmo_clone_cow downgrade
+    // to find other address spaces that map the source VMO.
+    struct vmo_as  *next;
+    struct vmo_as  *prev;
+} vmo_as_t;
+
+static kmem_cache_t *g_vmo_node_cache = NULL;
+static kmem_cache_t *g_vmo_as_cache   = NULL;
+static vmo_as_t     *g_vmo_as_head    = NULL;
+static spinlock_t g_vmo_as_list_lock = SPINLOCK_INITIALIZER("vmo_as_list");
+static uint32_t      g_vmo_as_count   = 0;   // registry length, list lock
 
 static uint64_t next_vmo_id(void) {
     spinlock_acquire(&g_vmo_id_lock);
@@ -50,10 +70,14 @@ void vmo_init(void) {
         klog(KLOG_FATAL, SUBSYS_MM, "vmo_init: kmem_cache_create failed");
         return;
     }
-    // Zero the per-task mapping table.
-    for (int t = 0; t < VMO_MAX_TASKS; t++)
-        for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++)
-            g_vmo_task_maps[t][s].vaddr = 0;
+    g_vmo_node_cache = kmem_cache_create("vmo_map_node", sizeof(vmo_map_node_t),
+                                         _Alignof(vmo_map_node_t), NULL, SUBSYS_MM);
+    g_vmo_as_cache = kmem_cache_create("vmo_as", sizeof(vmo_as_t),
+                                       _Alignof(vmo_as_t), NULL, SUBSYS_MM);
+    if (!g_vmo_node_cache || !g_vmo_as_cache) {
+        klog(KLOG_FATAL, SUBSYS_MM, "vmo_init: mapping index caches failed");
+        return;
+    }
     // Install the page-fault hook.
     vmm_install_pf_handler(vmo_pf_dispatch);
     klog(KLOG_INFO, SUBSYS_MM, "vmo_init: slab + pf hook ready");
@@ -133,6 +157,22 @@ vmo_t *vmo_create(uint64_t size_bytes, uint32_t flags,
     // Eager allocation unless VMO_ONDEMAND is set.
     if (!(flags & VMO_ONDEMAND)) {
         for (uint64_t p = 0; p < npages; p++) {
+            // Phase 26: back every whole 2 MiB stretch with an aligned run
+            // so vmo_map can use large pages; fall back to single frames
+            // when the PMM has no free aligned run left.
+            if ((p % HUGE_PAGE_PAGES) == 0 && npages - p >= HUGE_PAGE_PAGES) {
+                void *run = pmm_alloc_huge_page();
+                if (run) {
+                    for (uint64_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+                        v->pages[p + i] = (uint64_t)run + i * 4096ull;
+                    }
+                    if (flags & VMO_ZEROED) {
+                        memset(phys_to_kv((uint64_t)run), 0, HUGE_PAGE_SIZE);
+                    }
+                    p += HUGE_PAGE_PAGES - 1;
+                    continue;
+                }
+            }
             void *pa = pmm_alloc_page();
             if (!pa) {
                 // Roll back all previously allocated pages.
@@ -151,6 +191,43 @@ vmo_t *vmo_create(uint64_t size_bytes, uint32_t flags,
     return v;
 }
 
+int vmo_grow(vmo_t *v, uint64_t new_size_bytes) {
+    if (!vmo_check(v)) return CAP_V2_EINVAL;
+    if ((new_size_bytes & 0xFFFu) || new_size_bytes <= v->size_bytes ||
+        new_size_bytes > VMO_MAX_SIZE) {
+        return CAP_V2_EINVAL;
+    }
+    if (v->flags & (VMO_ONDEMAND | VMO_COW_CHILD | VMO_MMIO | VMO_CONTIGUOUS) ||
+        v->parent) {
+        return CAP_V2_EINVAL;
+    }
+
+    uint32_t old_n = v->npages;
+    uint32_t new_n = (uint32_t)(new_size_bytes / 4096);
+    uint64_t *pages = (uint64_t *)kmalloc(sizeof(uint64_t) * new_n, SUBSYS_MM);
+    if (!pages) return CAP_V2_ENOMEM;
+    memcpy(pages, v->pages, sizeof(uint64_t) * old_n);
+    for (uint32_t p = old_n; p < new_n; p++) {
+        void *pa = pmm_alloc_page();
+        if (!pa) {
+            for (uint32_t q = old_n; q < p; q++) pmm_page_unref((void *)pages[q]);
+            kfree(pages);
+            return CAP_V2_ENOMEM;
+        }
+        pages[p] = (uint64_t)pa;
+        if (v->flags & VMO_ZEROED) memset(phys_to_kv(pages[p]), 0, 4096);
+    }
+
+    spinlock_acquire(&v->lock);
+    uint64_t *old = v->pages;
+    v->pages      = pages;
+    v->npages     = new_n;
+    v->size_bytes = new_size_bytes;
+    spinlock_release(&v->lock);
+    kfree(old);
+    return 0;
+}
+
 uint64_t vmo_get_phys(vmo_t *v, uint32_t page_idx) {
     if (!vmo_check(v)) return 0;
     if (page_idx >= v->npages) return 0;
@@ -201,34 +278,149 @@ void vmo_unref(vmo_t *v) {
     if (zero) vmo_free(v);
 }
 
-// --- Per-task mapping helpers --------------------------------------------
-static int vmo_alloc_map_slot(int32_t task_id) {
-    if (task_id < 0 || task_id >= VMO_MAX_TASKS) return -1;
-    for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++) {
-        if (g_vmo_task_maps[task_id][s].vaddr == 0) return s;
+// --- Per-address-space mapping index -------------------------------------
+static inline uint64_t vmo_map_end(const vmo_mapping_t *m) {
+    return m->vaddr + (uint64_t)m->len_pages * 4096;
+}
+
+static inline int32_t vmo_node_height(const vmo_map_node_t *n) {
+    return n ? n->height : 0;
+}
+
+static void vmo_node_fix_height(vmo_map_node_t *n) {
+    int32_t l = vmo_node_height(n->left), r = vmo_node_height(n->right);
+    n->height = 1 + (l > r ? l : r);
+}
+
+static vmo_map_node_t *vmo_node_rotate_right(vmo_map_node_t *n) {
+    vmo_map_node_t *l = n->left;
+    n->left = l->right;
+    l->right = n;
+    vmo_node_fix_height(n);
+    vmo_node_fix_height(l);
+    return l;
+}
+
+static vmo_map_node_t *vmo_node_rotate_left(vmo_map_node_t *n) {
+    vmo_map_node_t *r = n->right;
+    n->right = r->left;
+    r->left = n;
+    vmo_node_fix_height(n);
+    vmo_node_fix_height(r);
+    return r;
+}
+
+static vmo_map_node_t *vmo_node_rebalance(vmo_map_node_t *n) {
+    vmo_node_fix_height(n);
+    int32_t bal = vmo_node_height(n->left) - vmo_node_height(n->right);
+    if (bal > 1) {
+        if (vmo_node_height(n->left->left) < vmo_node_height(n->left->right))
+            n->left = vmo_node_rotate_left(n->left);
+        return vmo_node_rotate_right(n);
     }
-    return -1;
+    if (bal < -1) {
+        if (vmo_node_height(n->right->right) < vmo_node_height(n->right->left))
+            n->right = vmo_node_rotate_right(n->right);
+        return vmo_node_rotate_left(n);
+    }
+    return n;
+}
+
+static vmo_map_node_t *vmo_node_insert(vmo_map_node_t *root, vmo_map_node_t *n) {
+    if (!root) return n;
+    if (n->m.vaddr < root->m.vaddr) root->left  = vmo_node_insert(root->left, n);
+    else                            root->right = vmo_node_insert(root->right, n);
+    return vmo_node_rebalance(root);
 }
 
-static int vmo_find_map_slot(int32_t task_id, uint64_t vaddr) {
-    if (task_id < 0 || task_id >= VMO_MAX_TASKS) return -1;
-    for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++) {
-        if (g_vmo_task_maps[task_id][s].vaddr == vaddr &&
-            g_vmo_task_maps[task_id][s].vaddr != 0) return s;
+static vmo_map_node_t *vmo_node_unlink_min(vmo_map_node_t *root,
+                                           vmo_map_node_t **min) {
+    if (!root->left) {
+        *min = root;
+        return root->right;
     }
-    return -1;
+    root->left = vmo_node_unlink_min(root->left, min);
+    return vmo_node_rebalance(root);
 }
 
-// Find the mapping slot that contains the given VA (any page in range).
-static int vmo_find_map_slot_containing(int32_t task_id, uint64_t va) {
-    if (task_id < 0 || task_id >= VMO_MAX_TASKS) return -1;
-    for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++) {
-        vmo_mapping_t *m = &g_vmo_task_maps[task_id][s];
-        if (m->vaddr == 0) continue;
-        uint64_t end = m->vaddr + ((uint64_t)m->len_pages * 4096);
-        if (va >= m->vaddr && va < end) return s;
+// Unlink the node whose base is exactly `vaddr`; *out receives it (or NULL).
+static vmo_map_node_t *vmo_node_remove(vmo_map_node_t *root, uint64_t vaddr,
+                                       vmo_map_node_t **out) {
+    if (!root) return NULL;
+    if (vaddr < root->m.vaddr) {
+        root->left = vmo_node_remove(root->left, vaddr, out);
+    } else if (vaddr > root->m.vaddr) {
+        root->right = vmo_node_remove(root->right, vaddr, out);
+    } else {
+        *out = root;
+        if (!root->left)  return root->right;
+        if (!root->right) return root->left;
+        vmo_map_node_t *succ;
+        vmo_map_node_t *right = vmo_node_unlink_min(root->right, &succ);
+        succ->left  = root->left;
+        succ->right = right;
+        return vmo_node_rebalance(succ);
     }
-    return -1;
+    return vmo_node_rebalance(root);
+}
+
+// The mapping with the greatest base ≤ va, i.e. the only one that can
+// contain va. Caller checks va < end.
+static vmo_map_node_t *vmo_node_floor(vmo_map_node_t *n, uint64_t va) {
+    vmo_map_node_t *best = NULL;
+    while (n) {
+        if (va < n->m.vaddr) {
+            n = n->left;
+        } else {
+            best = n;
+            n = n->right;
+        }
+    }
+    return best;
+}
+
+static vmo_map_node_t *vmo_as_find(vmo_as_t *as, uint64_t vaddr) {
+    vmo_map_node_t *n = vmo_node_floor(as->root, vaddr);
+    return (n && n->m.vaddr == vaddr) ? n : NULL;
+}
+
+// Find the mapping that contains the given VA (any page in range).
+static vmo_map_node_t *vmo_as_find_containing(vmo_as_t *as, uint64_t va) {
+    vmo_map_node_t *n = vmo_node_floor(as->root, va);
+    return (n && va < vmo_map_end(&n->m)) ? n : NULL;
+}
+
+// True if [start, end) intersects any mapping already in the index.
+static bool vmo_as_overlaps(vmo_as_t *as, uint64_t start, uint64_t end) {
+    vmo_map_node_t *n = vmo_node_floor(as->root, end - 1);
+    return n && vmo_map_end(&n->m) > start;
+}
+
+// Return t's mapping index, creating and registering it on first use.
+// Creation runs under the registry lock so two racing first maps of the
+// same task cannot both install one.
+static vmo_as_t *vmo_as_get(task_t *t) {
+    vmo_as_t *as = __atomic_load_n(&t->vmo_as, __ATOMIC_ACQUIRE);
+    if (as) return as;
+    spinlock_acquire(&g_vmo_as_list_lock);
+    as = t->vmo_as;
+    if (!as) {
+        as = (vmo_as_t *)kmem_cache_alloc(g_vmo_as_cache);
+        if (as) {
+            spinlock_init(&as->lock, "vmo_as");
+            as->root  = NULL;
+            as->count = 0;
+            as->owner = t;
+            as->prev  = NULL;
+            as->next  = g_vmo_as_head;
+            if (g_vmo_as_head) g_vmo_as_head->prev = as;
+            g_vmo_as_head = as;
+            g_vmo_as_count++;
+            __atomic_store_n(&t->vmo_as, as, __ATOMIC_RELEASE);
+        }
+    }
+    spinlock_release(&g_vmo_as_list_lock);
+    return as;
 }
 
 static uint64_t prot_to_pte_flags(uint32_t prot) {
@@ -238,7 +430,43 @@ static uint64_t prot_to_pte_flags(uint32_t prot) {
     return f;
 }
 
+// Phase 26: true if pages[idx .. idx + 512) is one 2 MiB-aligned physically
+// contiguous run that a single large PD entry can map.
+static bool vmo_huge_run(const vmo_t *v, uint64_t idx) {
+    uint64_t base = v->pages[idx];
+    if (base == 0 || (base & (HUGE_PAGE_SIZE - 1))) return false;
+    for (uint32_t i = 1; i < HUGE_PAGE_PAGES; i++) {
+        if (v->pages[idx + i] != base + (uint64_t)i * 4096) return false;
+    }
+    return true;
+}
+
+// Clear the PTEs of [vaddr, vaddr + npages pages) and shoot the range down
+// once. 2 MiB mappings are cleared whole rather than split. PMM references
+// are the caller's to drop, after this returns.
+static void vmo_unmap_ptes(uint64_t cr3, uint64_t vaddr, uint64_t npages) {
+    tlb_batch_t batch;
+    tlb_batch_init(&batch, cr3);
+    for (uint64_t p = 0; p < npages; p++) {
+        uint64_t va = vaddr + p * 4096;
+        if (npages - p >= HUGE_PAGE_PAGES &&
+            vmm_unmap_huge_page_batched(cr3, va, &batch) != 0) {
+            p += HUGE_PAGE_PAGES - 1;
+            continue;
+        }
+        vmm_unmap_page_batched(cr3, va, &batch);
+    }
+    tlb_batch_flush(&batch);
+}
+
 // --- vmo_map -------------------------------------------------------------
+// Failure exit for vmo_map once as->lock is held.
+static uint64_t vmo_map_abort(vmo_as_t *as, vmo_map_node_t *node) {
+    spinlock_release(&as->lock);
+    kmem_cache_free(g_vmo_node_cache, node);
+    return 0;
+}
+
 uint64_t vmo_map(vmo_t *v, task_t *t,
                  uint64_t addr_hint, uint64_t offset, uint64_t len,
                  uint32_t prot) {
@@ -250,12 +478,27 @@ uint64_t vmo_map(vmo_t *v, task_t *t,
     uint64_t start_page = offset / 4096;
     uint64_t npages = len / 4096;
 
-    spinlock_acquire(&g_vmo_map_lock);
-    int slot = vmo_alloc_map_slot(t->id);
-    if (slot < 0) { spinlock_release(&g_vmo_map_lock); return 0; }
+    vmo_as_t *as = vmo_as_get(t);
+    if (!as) return 0;
+    vmo_map_node_t *node = (vmo_map_node_t *)kmem_cache_alloc(g_vmo_node_cache);
+    if (!node) return 0;
+
+    spinlock_acquire(&as->lock);
+    if (as->count >= VMO_MAPPINGS_PER_TASK) return vmo_map_abort(as, node);
+    // The index assumes disjoint ranges; a caller-chosen address may not
+    // land on top of an existing VMO mapping.
+    if (addr_hint && vmo_as_overlaps(as, addr_hint, addr_hint + len)) {
+        return vmo_map_abort(as, node);
+    }
 
-    uint64_t vaddr = addr_hint ? addr_hint : vmm_reserve_va_by_cr3(t->cr3, len);
-    if (!vaddr) { spinlock_release(&g_vmo_map_lock); return 0; }
+    // Phase 26: mappings of 2 MiB or more get a 2 MiB-aligned VA so the
+    // huge-backed part of the VMO can use large pages.
+    uint64_t vaddr = addr_hint;
+    if (!vaddr && npages >= HUGE_PAGE_PAGES) {
+        vaddr = vmm_reserve_va_aligned_by_cr3(t->cr3, len, HUGE_PAGE_SIZE);
+    }
+    if (!vaddr) vaddr = vmm_reserve_va_by_cr3(t->cr3, len);
+    if (!vaddr) return vmo_map_abort(as, node);
 
     uint64_t pte_flags = prot_to_pte_flags(prot);
 
@@ -273,17 +516,31 @@ uint64_t vmo_map(vmo_t *v, task_t *t,
     }
 
     for (uint64_t p = 0; p < npages; p++) {
+        // Phase 26: a 2 MiB-aligned VA over a 2 MiB-aligned contiguous run
+        // of already-backed frames (huge-backed eager VMOs, framebuffer and
+        // BAR MMIO) takes one PD entry instead of 512 PTEs.
+        uint64_t va = vaddr + p * 4096;
+        if ((va & (HUGE_PAGE_SIZE - 1)) == 0 && npages - p >= HUGE_PAGE_PAGES &&
+            vmo_huge_run(v, start_page + p) &&
+            vmm_map_huge_page_by_cr3(t->cr3, va, v->pages[start_page + p],
+                                     pte_flags)) {
+            if (!(v->flags & VMO_MMIO)) {
+                for (uint32_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+                    pmm_page_ref((void *)v->pages[start_page + p + i]);
+                }
+            }
+            p += HUGE_PAGE_PAGES - 1;
+            continue;
+        }
+
         uint64_t phys = v->pages[start_page + p];
         // MMIO VMOs always have phys != 0 (set at create time); skip the
         // on-demand allocation + rlimit_check_mem block entirely.
         if (phys != 0 && (v->flags & VMO_MMIO)) {
             // Just map; don't pmm_page_ref (page is not pmm-tracked).
             if (!vmm_map_page_by_cr3(t->cr3, vaddr + p * 4096, phys, pte_flags)) {
-                for (uint64_t q = 0; q < p; q++) {
-                    vmm_unmap_page_by_cr3(t->cr3, vaddr + q * 4096);
-                }
-                spinlock_release(&g_vmo_map_lock);
-                return 0;
+                vmo_unmap_ptes(t->cr3, vaddr, p);
+                return vmo_map_abort(as, node);
             }
             continue;
         }
@@ -295,13 +552,12 @@ uint64_t vmo_map(vmo_t *v, task_t *t,
             // the same rollback path used for pmm exhaustion.
             int mrc = rlimit_check_mem(t, 1);
             if (mrc < 0) {
+                vmo_unmap_ptes(t->cr3, vaddr, p);
                 for (uint64_t q = 0; q < p; q++) {
-                    vmm_unmap_page_by_cr3(t->cr3, vaddr + q * 4096);
                     pmm_page_unref((void *)(v->pages[start_page + q]));
                     rlimit_account_free_mem(t, 1);
                 }
-                spinlock_release(&g_vmo_map_lock);
-                return 0;
+                return vmo_map_abort(as, node);
             }
             // On-demand page — allocate now. (Simple eager-on-first-map for
             // Phase 17; true demand-paging can land in Phase 18.)
@@ -309,13 +565,12 @@ uint64_t vmo_map(vmo_t *v, task_t *t,
             if (!pa) {
                 rlimit_account_free_mem(t, 1);  // refund our own reservation
                 // Roll back the partial map.
+                vmo_unmap_ptes(t->cr3, vaddr, p);
                 for (uint64_t q = 0; q < p; q++) {
-                    vmm_unmap_page_by_cr3(t->cr3, vaddr + q * 4096);
                     pmm_page_unref((void *)(v->pages[start_page + q]));
                     rlimit_account_free_mem(t, 1);
                 }
-                spinlock_release(&g_vmo_map_lock);
-                return 0;
+                return vmo_map_abort(as, node);
             }
             v->pages[start_page + p] = (uint64_t)pa;
             if (v->flags & VMO_ZEROED) memset(phys_to_kv((uint64_t)pa), 0, 4096);
@@ -328,44 +583,52 @@ uint64_t vmo_map(vmo_t *v, task_t *t,
         }
 
         if (!vmm_map_page_by_cr3(t->cr3, vaddr + p * 4096, phys, pte_flags)) {
+            vmo_unmap_ptes(t->cr3, vaddr, p);
             for (uint64_t q = 0; q <= p; q++) {
-                vmm_unmap_page_by_cr3(t->cr3, vaddr + q * 4096);
                 pmm_page_unref((void *)(v->pages[start_page + q]));
             }
-            spinlock_release(&g_vmo_map_lock);
-            return 0;
+            return vmo_map_abort(as, node);
         }
     }
 
     // Record the mapping and reference the vmo.
-    g_vmo_task_maps[t->id][slot].vaddr     = vaddr;
-    g_vmo_task_maps[t->id][slot].vmo       = v;
-    g_vmo_task_maps[t->id][slot].offset    = offset;
-    g_vmo_task_maps[t->id][slot].len_pages = (uint32_t)npages;
-    g_vmo_task_maps[t->id][slot].prot      = prot;
+    node->m.vaddr     = vaddr;
+    node->m.vmo       = v;
+    node->m.offset    = offset;
+    node->m.len_pages = (uint32_t)npages;
+    node->m.prot      = prot;
+    node->left   = NULL;
+    node->right  = NULL;
+    node->height = 1;
+    as->root = vmo_node_insert(as->root, node);
+    as->count++;
     vmo_ref(v);
-    spinlock_release(&g_vmo_map_lock);
+    spinlock_release(&as->lock);
     return vaddr;
 }
 
 // --- vmo_unmap -----------------------------------------------------------
 int vmo_unmap(task_t *t, uint64_t vaddr, uint64_t len) {
     if (!t || vaddr == 0 || (vaddr & 0xFFFu) || (len & 0xFFFu)) return CAP_V2_EINVAL;
-    spinlock_acquire(&g_vmo_map_lock);
-    int slot = vmo_find_map_slot(t->id, vaddr);
-    if (slot < 0) { spinlock_release(&g_vmo_map_lock); return CAP_V2_EINVAL; }
-    vmo_mapping_t *m = &g_vmo_task_maps[t->id][slot];
-    if ((uint64_t)m->len_pages * 4096 != len) {
-        spinlock_release(&g_vmo_map_lock);
+    vmo_as_t *as = __atomic_load_n(&t->vmo_as, __ATOMIC_ACQUIRE);
+    if (!as) return CAP_V2_EINVAL;
+    spinlock_acquire(&as->lock);
+    vmo_map_node_t *n = vmo_as_find(as, vaddr);
+    if (!n || (uint64_t)n->m.len_pages * 4096 != len) {
+        spinlock_release(&as->lock);
         return CAP_V2_EINVAL;
     }
+    vmo_mapping_t *m = &n->m;
     vmo_t *v = m->vmo;
     uint64_t start_page = m->offset / 4096;
     bool is_mmio = (v->flags & VMO_MMIO) != 0;
+    // Phase 26: clear every PTE first and shoot the whole range down once;
+    // only then drop the page refs — a peer CPU must not keep a stale
+    // translation to a frame the PMM has already recycled.
+    vmo_unmap_ptes(t->cr3, m->vaddr, m->len_pages);
+    t->snap_unmap_gen++;
     for (uint32_t p = 0; p < m->len_pages; p++) {
-        uint64_t va = m->vaddr + (uint64_t)p * 4096;
         uint64_t phys = v->pages[start_page + p];
-        vmm_unmap_page_by_cr3(t->cr3, va);
         if (phys && !is_mmio) {
             pmm_page_unref((void *)phys);
             // Phase 20 U10b: refund mem accounting for the page that was
@@ -375,9 +638,11 @@ int vmo_unmap(task_t *t, uint64_t vaddr, uint64_t len) {
             rlimit_account_free_mem(t, 1);
         }
     }
-    m->vaddr = 0;
-    m->vmo   = NULL;
-    spinlock_release(&g_vmo_map_lock);
+    vmo_map_node_t *gone = NULL;
+    as->root = vmo_node_remove(as->root, vaddr, &gone);
+    as->count--;
+    spinlock_release(&as->lock);
+    kmem_cache_free(g_vmo_node_cache, gone);
     vmo_unref(v);
     return 0;
 }
@@ -396,43 +661,120 @@ int vmo_unmap(task_t *t, uint64_t vaddr, uint64_t len) {
 // v->pages[] — which is exactly what vmo_unmap()/vmo destroy walk and unref.
 // new_pages must hold v->npages entries.  Returns #PTEs updated, <0 on error.
 // Pages with no present PTE are skipped; the console cell-VMO is eager
-// (VMO_ZEROED), so every mapped page is present and gets remapped.  invlpg is
-// local-only — TX syscalls run in the owner's own CPU context (owner==caller
-// is enforced in cell_tx.c), matching the cow_fault/vmo_pf_dispatch model.
+// (VMO_ZEROED), so every mapped page is present and gets remapped.  Each
+// vmm_*_by_cr3 shoots down every CPU running t; owner==caller is enforced in
+// cell_tx.c, so the only such CPU is this one and flushing under as->lock
+// (and cell_tx's g_tx_lock) keeps the tlb.h rule.
 #define VMO_PTE_PHYS_MASK 0x000FFFFFFFFFF000ULL
-int vmo_remap_pages_for_task(task_t *t, vmo_t *v, const uint64_t *new_pages) {
-    if (!t || !vmo_check(v) || !new_pages) return CAP_V2_EINVAL;
-    if (t->id < 0 || t->id >= VMO_MAX_TASKS) return CAP_V2_EINVAL;
-    if (v->flags & VMO_MMIO) return 0;   // MMIO frames are not pmm-tracked
-
-    spinlock_acquire(&g_vmo_map_lock);
-    int updated = 0;
-    for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++) {
-        vmo_mapping_t *m = &g_vmo_task_maps[t->id][s];
-        if (m->vaddr == 0 || m->vmo != v) continue;
+// In-order walk of one address space's index; remaps every mapping of v.
+static int vmo_remap_subtree(uint64_t cr3, vmo_map_node_t *n, vmo_t *v,
+                             const uint64_t *new_pages) {
+    if (!n) return 0;
+    int updated = vmo_remap_subtree(cr3, n->left, v, new_pages);
+    vmo_mapping_t *m = &n->m;
+    if (m->vmo == v) {
         uint64_t start_page = m->offset / 4096;
         for (uint32_t p = 0; p < m->len_pages; p++) {
             uint64_t idx = start_page + p;
             if (idx >= v->npages) break;
             uint64_t va      = m->vaddr + (uint64_t)p * 4096;
-            uint64_t old_pte = vmm_get_pte(t->cr3, va);
+            uint64_t old_pte = vmm_get_pte(cr3, va);
             if (!(old_pte & 1ULL)) continue;             // not present
             uint64_t old_phys = old_pte & VMO_PTE_PHYS_MASK;
             uint64_t new_phys = new_pages[idx];
             if (new_phys == 0 || new_phys == old_phys) continue;
-            uint64_t flags = old_pte & ~VMO_PTE_PHYS_MASK; // keep P/RW/US/NX
-            vmm_unmap_page_by_cr3(t->cr3, va);
+            // Keep P/RW/US/NX; a new frame is never snapshot-clean.
+            uint64_t flags = old_pte & ~VMO_PTE_PHYS_MASK & ~PTE_SNAP_CLEAN;
+            vmm_unmap_page_by_cr3(cr3, va);
             pmm_page_ref((void *)new_phys);
             if (old_phys) pmm_page_unref((void *)old_phys);
-            vmm_map_page_by_cr3(t->cr3, va, new_phys, flags);
+            vmm_map_page_by_cr3(cr3, va, new_phys, flags);
             updated++;
         }
     }
-    spinlock_release(&g_vmo_map_lock);
+    return updated + vmo_remap_subtree(cr3, n->right, v, new_pages);
+}
+
+int vmo_remap_pages_for_task(task_t *t, vmo_t *v, const uint64_t *new_pages) {
+    if (!t || !vmo_check(v) || !new_pages) return CAP_V2_EINVAL;
+    if (v->flags & VMO_MMIO) return 0;   // MMIO frames are not pmm-tracked
+    vmo_as_t *as = __atomic_load_n(&t->vmo_as, __ATOMIC_ACQUIRE);
+    if (!as) return 0;
+
+    spinlock_acquire(&as->lock);
+    int updated = vmo_remap_subtree(t->cr3, as->root, v, new_pages);
+    spinlock_release(&as->lock);
     return updated;
 }
 
+// --- Deferred cross-address-space shootdowns -----------------------------
+// The walks below edit other tasks' PTEs under g_vmo_as_list_lock and each
+// as->lock, but must not flush there: a CPU running that address space can
+// be spinning on the same lock with IF=0 in vmo_pf_dispatch, and it never
+// acks (tlb.h). They queue into one batch per address space instead and
+// flush once the list lock is dropped. The batches are allocated before the
+// lock is taken, sized from g_vmo_as_count and re-sized if it grew.
+typedef struct vmo_shoot {
+    tlb_batch_t *batch;
+    uint32_t     cap;
+    uint32_t     used;
+} vmo_shoot_t;
+
+// Returns with g_vmo_as_list_lock held, or false (lock not held) on OOM.
+static bool vmo_shoot_begin(vmo_shoot_t *s) {
+    uint32_t want = __atomic_load_n(&g_vmo_as_count, __ATOMIC_RELAXED);
+    for (;;) {
+        s->cap   = want ? want : 1;
+        s->used  = 0;
+        s->batch = (tlb_batch_t *)kmalloc(sizeof(tlb_batch_t) * s->cap, SUBSYS_MM);
+        if (!s->batch) return false;
+        spinlock_acquire(&g_vmo_as_list_lock);
+        if (g_vmo_as_count <= s->cap) return true;
+        want = g_vmo_as_count;
+        spinlock_release(&g_vmo_as_list_lock);
+        kfree(s->batch);
+    }
+}
+
+static tlb_batch_t *vmo_shoot_batch(vmo_shoot_t *s, uint64_t cr3) {
+    tlb_batch_t *b = &s->batch[s->used++];
+    tlb_batch_init(b, cr3);
+    return b;
+}
+
+// Drops g_vmo_as_list_lock, then flushes. A task that exits in between
+// leaves a batch for a dead CR3, which no CPU has active: a no-op flush.
+static void vmo_shoot_end(vmo_shoot_t *s) {
+    spinlock_release(&g_vmo_as_list_lock);
+    for (uint32_t i = 0; i < s->used; i++) tlb_batch_flush(&s->batch[i]);
+    kfree(s->batch);
+}
+
 // --- vmo_clone_cow -------------------------------------------------------
+// Write-protect every mapping of src in one address space's index.
+static void vmo_downgrade_subtree(uint64_t cr3, vmo_map_node_t *n, vmo_t *src,
+                                  tlb_batch_t *batch) {
+    if (!n) return;
+    vmo_downgrade_subtree(cr3, n->left, src, batch);
+    vmo_mapping_t *m = &n->m;
+    if (m->vmo == src) {
+        uint64_t flags_ro = prot_to_pte_flags(m->prot) & ~PTE_WRITABLE;
+        for (uint32_t p = 0; p < m->len_pages; p++) {
+            uint64_t va = m->vaddr + (uint64_t)p * 4096;
+            // Downgrade a 2 MiB mapping whole; the first write fault
+            // splits it and copies just the faulting 4 KiB page.
+            if ((va & (HUGE_PAGE_SIZE - 1)) == 0 &&
+                m->len_pages - p >= HUGE_PAGE_PAGES &&
+                vmm_protect_huge_page_batched(cr3, va, flags_ro, batch)) {
+                p += HUGE_PAGE_PAGES - 1;
+                continue;
+            }
+            vmm_protect_page_batched(cr3, va, flags_ro, batch);
+        }
+    }
+    vmo_downgrade_subtree(cr3, n->right, src, batch);
+}
+
 vmo_t *vmo_clone_cow(vmo_t *src, int32_t owner_pid) {
     if (!vmo_check(src)) return NULL;
 
@@ -454,6 +796,12 @@ vmo_t *vmo_clone_cow(vmo_t *src, int32_t owner_pid) {
         kmem_cache_free(g_vmo_cache, child);
         return NULL;
     }
+    vmo_shoot_t shoot;
+    if (!vmo_shoot_begin(&shoot)) {
+        kfree(child->pages);
+        kmem_cache_free(g_vmo_cache, child);
+        return NULL;
+    }
 
     // Share pages and bump refcounts. Mark all currently mapped pages of
     // src as read-only in every existing task mapping so the first write
@@ -466,26 +814,165 @@ vmo_t *vmo_clone_cow(vmo_t *src, int32_t owner_pid) {
     src->refcount++;  // parent gets a reference from the child
     spinlock_release(&src->lock);
 
-    // Downgrade every mapping of src (in any task) to read-only.
-    spinlock_acquire(&g_vmo_map_lock);
-    for (int t = 0; t < VMO_MAX_TASKS; t++) {
-        for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++) {
-            vmo_mapping_t *m = &g_vmo_task_maps[t][s];
-            if (m->vmo != src || m->vaddr == 0) continue;
-            uint64_t cr3 = 0;
-            task_t *tt = sched_get_task(t);
-            if (tt) cr3 = tt->cr3;
-            if (!cr3) continue;
-            uint64_t flags_ro = prot_to_pte_flags(m->prot) & ~PTE_WRITABLE;
-            for (uint32_t p = 0; p < m->len_pages; p++) {
-                vmm_protect_page_by_cr3(cr3, m->vaddr + (uint64_t)p * 4096, flags_ro);
-            }
+    // Downgrade every mapping of src (in any task) to read-only. The child
+    // is only returned after the flush, so no stale writable entry outlives
+    // the share.
+    for (vmo_as_t *as = g_vmo_as_head; as; as = as->next) {
+        uint64_t cr3 = as->owner ? as->owner->cr3 : 0;
+        if (!cr3) continue;
+        tlb_batch_t *batch = vmo_shoot_batch(&shoot, cr3);
+        spinlock_acquire(&as->lock);
+        vmo_downgrade_subtree(cr3, as->root, src, batch);
+        spinlock_release(&as->lock);
+    }
+    vmo_shoot_end(&shoot);
+    return child;
+}
+
+// --- Page loans (Phase 26) ----------------------------------------------
+// Write-protect pages [first, first + n) of src in every mapping of it in one
+// address space's index. Only the loaned pages are downgraded, so the rest
+// of a large source mapping keeps writing without faults.
+static void vmo_downgrade_range_subtree(uint64_t cr3, vmo_map_node_t *node,
+                                        vmo_t *src, uint64_t first, uint64_t n,
+                                        tlb_batch_t *batch) {
+    if (!node) return;
+    vmo_downgrade_range_subtree(cr3, node->left, src, first, n, batch);
+    vmo_mapping_t *m = &node->m;
+    uint64_t mfirst = m->offset / 4096;
+    uint64_t lo = first > mfirst ? first : mfirst;
+    uint64_t hi = first + n < mfirst + m->len_pages ? first + n : mfirst + m->len_pages;
+    if (m->vmo == src && lo < hi) {
+        uint64_t flags_ro = prot_to_pte_flags(m->prot) & ~PTE_WRITABLE;
+        for (uint64_t p = lo; p < hi; p++) {
+            vmm_protect_page_batched(cr3, m->vaddr + (p - mfirst) * 4096,
+                                     flags_ro, batch);
         }
     }
-    spinlock_release(&g_vmo_map_lock);
+    vmo_downgrade_range_subtree(cr3, node->right, src, first, n, batch);
+}
+
+// COW child holding only pages [first, first + n) of src.
+static vmo_t *vmo_clone_cow_range(vmo_t *src, uint64_t first, uint64_t n,
+                                  int32_t owner_pid) {
+    vmo_t *child = (vmo_t *)kmem_cache_alloc(g_vmo_cache);
+    if (!child) return NULL;
+    child->magic       = VMO_MAGIC;
+    child->flags       = (src->flags | VMO_COW_CHILD) &
+                         ~(VMO_ZEROED | VMO_ANON | VMO_CONTIGUOUS);
+    child->id          = next_vmo_id();
+    child->size_bytes  = n * 4096;
+    child->npages      = (uint32_t)n;
+    child->refcount    = 1;
+    child->parent      = src;
+    child->owner_pid   = owner_pid;
+    child->cap_object_idx = 0;
+    spinlock_init(&child->lock, "vmo");
+
+    child->pages = (uint64_t *)kmalloc(sizeof(uint64_t) * n, SUBSYS_MM);
+    if (!child->pages) {
+        kmem_cache_free(g_vmo_cache, child);
+        return NULL;
+    }
+    // Flushed after the locks drop, as in vmo_clone_cow.
+    vmo_shoot_t shoot;
+    if (!vmo_shoot_begin(&shoot)) {
+        kfree(child->pages);
+        kmem_cache_free(g_vmo_cache, child);
+        return NULL;
+    }
+    spinlock_acquire(&src->lock);
+    for (uint64_t p = 0; p < n; p++) {
+        child->pages[p] = src->pages[first + p];
+        if (child->pages[p]) pmm_page_ref((void *)child->pages[p]);
+    }
+    src->refcount++;
+    spinlock_release(&src->lock);
+
+    for (vmo_as_t *as = g_vmo_as_head; as; as = as->next) {
+        uint64_t cr3 = as->owner ? as->owner->cr3 : 0;
+        if (!cr3) continue;
+        tlb_batch_t *batch = vmo_shoot_batch(&shoot, cr3);
+        spinlock_acquire(&as->lock);
+        vmo_downgrade_range_subtree(cr3, as->root, src, first, n, batch);
+        spinlock_release(&as->lock);
+    }
+    vmo_shoot_end(&shoot);
     return child;
 }
 
+int vmo_loan_create(task_t *t, uint64_t vaddr, uint64_t len, uint32_t flags,
+                    vmo_t **out, uint32_t *prot_out) {
+    if (!t || !out || vaddr == 0 || len == 0) return CAP_V2_EINVAL;
+    if ((vaddr & 0xFFFu) || (len & 0xFFFu)) return CAP_V2_EINVAL;
+    vmo_as_t *as = __atomic_load_n(&t->vmo_as, __ATOMIC_ACQUIRE);
+    if (!as) return CAP_V2_EFAULT;
+
+    spinlock_acquire(&as->lock);
+    vmo_map_node_t *n = vmo_as_find_containing(as, vaddr);
+    if (!n || vaddr + len > vmo_map_end(&n->m)) {
+        spinlock_release(&as->lock);
+        return CAP_V2_EFAULT;
+    }
+    vmo_mapping_t m = n->m;
+    // A COW loan pins the source while it clones; a MOVE checks below that
+    // this mapping is the only reference.
+    if (!(flags & VMO_LOAN_MOVE)) vmo_ref(m.vmo);
+    spinlock_release(&as->lock);
+
+    // Devices address MMIO, CONTIGUOUS and PINNED VMOs by physical frame,
+    // so their frames must never move: a COW loan's source break would
+    // swap them under a DMA in flight, and a MOVE would hand them away.
+    vmo_t *src = m.vmo;
+    if (!vmo_check(src) ||
+        (src->flags & (VMO_MMIO | VMO_CONTIGUOUS | VMO_PINNED)) ||
+        !(m.prot & PROT_READ)) {
+        if (!(flags & VMO_LOAN_MOVE)) vmo_unref(src);
+        return CAP_V2_EPERM;
+    }
+    if (prot_out) *prot_out = m.prot;
+
+    if (flags & VMO_LOAN_MOVE) {
+        // Only a whole mapping that is the VMO's sole reference can move:
+        // anything else would leave another holder writing into the frames
+        // the receiver now owns.
+        if (vaddr != m.vaddr || len != (uint64_t)m.len_pages * 4096 ||
+            m.offset != 0 || len != src->size_bytes) {
+            return CAP_V2_EINVAL;
+        }
+        spinlock_acquire(&src->lock);
+        bool sole = (src->refcount == 1);
+        if (sole) src->refcount++;
+        spinlock_release(&src->lock);
+        if (!sole) return CAP_V2_EBUSY;
+        int rc = vmo_unmap(t, vaddr, len);
+        if (rc < 0) {
+            vmo_unref(src);
+            return rc;
+        }
+        *out = src;
+        return 0;
+    }
+
+    uint64_t first = (m.offset + (vaddr - m.vaddr)) / 4096;
+    vmo_t *child = vmo_clone_cow_range(src, first, len / 4096, t->id);
+    vmo_unref(src);
+    if (!child) return CAP_V2_ENOMEM;
+    *out = child;
+    return 0;
+}
+
+void vmo_loan_cancel(task_t *t, vmo_t *loan, uint64_t vaddr, uint32_t flags,
+                     uint32_t prot) {
+    if (!vmo_check(loan)) return;
+    if ((flags & VMO_LOAN_MOVE) && t) {
+        // Put the range back where it was; the address is free because the
+        // sender has been inside the syscall since it was unmapped.
+        (void)vmo_map(loan, t, vaddr, 0, loan->size_bytes, prot);
+    }
+    vmo_unref(loan);
+}
+
 // --- vmo_clone_shared ----------------------------------------------------
 // Phase 22 Stage B: produce a SHARED child VMO. Same physical pages, no
 // COW machinery — both parent and child have RW access and writes are
@@ -542,6 +1029,83 @@ vmo_t *vmo_clone_shared(vmo_t *src, int32_t owner_pid) {
     return child;
 }
 
+// Phase 26: source side of a COW share. Give v a private copy of page
+// page_idx, repoint every mapping of it (in every address space) at the
+// copy with its own write permission, and leave the old frame to the
+// clone / loan that still shares it. Called without any as->lock held.
+static void vmo_swap_page_subtree(uint64_t cr3, vmo_map_node_t *n, vmo_t *v,
+                                  uint32_t page_idx, uint64_t old_phys,
+                                  uint64_t new_phys, tlb_batch_t *batch) {
+    if (!n) return;
+    vmo_swap_page_subtree(cr3, n->left, v, page_idx, old_phys, new_phys, batch);
+    vmo_mapping_t *m = &n->m;
+    uint64_t mfirst = m->offset / 4096;
+    if (m->vmo == v && page_idx >= mfirst && page_idx < mfirst + m->len_pages) {
+        uint64_t va = m->vaddr + (uint64_t)(page_idx - mfirst) * 4096;
+        if (vmm_unmap_page_batched(cr3, va, batch)) {
+            pmm_page_unref((void *)old_phys);
+            pmm_page_ref((void *)new_phys);
+            vmm_map_page_by_cr3(cr3, va, new_phys, prot_to_pte_flags(m->prot));
+        }
+    }
+    vmo_swap_page_subtree(cr3, n->right, v, page_idx, old_phys, new_phys, batch);
+}
+
+static int vmo_cow_break_source(task_t *cur, vmo_t *v, uint32_t page_idx,
+                                uint64_t old_phys, uint64_t fault_va) {
+    if (rlimit_check_mem(cur, 1) < 0) {
+        audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va,
+                              CAP_V2_ENOMEM, "cow rlimit denied");
+        return -1;
+    }
+    void *new_pa = pmm_alloc_page();
+    if (!new_pa) {
+        rlimit_account_free_mem(cur, 1);
+        audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va,
+                              CAP_V2_ENOMEM, "cow alloc failed");
+        return -1;
+    }
+    memcpy(phys_to_kv((uint64_t)new_pa), phys_to_kv(old_phys), 4096);
+
+    vmo_shoot_t shoot;
+    if (!vmo_shoot_begin(&shoot)) {
+        pmm_page_unref(new_pa);
+        rlimit_account_free_mem(cur, 1);
+        audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va,
+                              CAP_V2_ENOMEM, "cow alloc failed");
+        return -1;
+    }
+    spinlock_acquire(&v->lock);
+    bool stale = (v->pages[page_idx] != old_phys);
+    if (!stale) v->pages[page_idx] = (uint64_t)new_pa;
+    spinlock_release(&v->lock);
+    if (stale) {
+        // Another mapper broke the share first and already repointed us;
+        // returning 0 retries the write against the new PTE.
+        vmo_shoot_end(&shoot);
+        pmm_page_unref(new_pa);
+        rlimit_account_free_mem(cur, 1);
+        return 0;
+    }
+    for (vmo_as_t *as = g_vmo_as_head; as; as = as->next) {
+        uint64_t cr3 = as->owner ? as->owner->cr3 : 0;
+        if (!cr3) continue;
+        tlb_batch_t *batch = vmo_shoot_batch(&shoot, cr3);
+        spinlock_acquire(&as->lock);
+        vmo_swap_page_subtree(cr3, as->root, v, page_idx, old_phys,
+                              (uint64_t)new_pa, batch);
+        spinlock_release(&as->lock);
+    }
+    vmo_shoot_end(&shoot);
+    // pages[] handed its reference on the old frame to nobody: the clone
+    // holds its own, so drop ours. new_pa's allocation ref is pages[]'s.
+    // Only now, after the flush, can no CPU still translate to old_phys.
+    pmm_page_unref((void *)old_phys);
+    audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va, 0,
+                          "cow source copy satisfied");
+    return 0;
+}
+
 // --- vmo_pf_dispatch -----------------------------------------------------
 int vmo_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
     // We only handle user-mode write faults on present pages.
@@ -554,21 +1118,25 @@ int vmo_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
     task_t *cur = sched_get_current_task();
     if (!cur) return -1;
 
-    spinlock_acquire(&g_vmo_map_lock);
-    int slot = vmo_find_map_slot_containing(cur->id, fault_va & ~0xFFFull);
-    if (slot < 0) { spinlock_release(&g_vmo_map_lock); return -1; }
-    vmo_mapping_t *m = &g_vmo_task_maps[cur->id][slot];
+    // Tasks that never mapped a VMO have no index; that is most faults.
+    vmo_as_t *as = __atomic_load_n(&cur->vmo_as, __ATOMIC_ACQUIRE);
+    if (!as) return -1;
+
+    spinlock_acquire(&as->lock);
+    vmo_map_node_t *n = vmo_as_find_containing(as, fault_va & ~0xFFFull);
+    if (!n) { spinlock_release(&as->lock); return -1; }
+    vmo_mapping_t *m = &n->m;
     if (!(m->prot & PROT_WRITE)) {
         // Handle had no write right — audit and deny.
         uint32_t obj = m->vmo ? m->vmo->cap_object_idx : 0;
-        spinlock_release(&g_vmo_map_lock);
+        spinlock_release(&as->lock);
         audit_write_vmo_fault(cur->id, obj, fault_va,
                               CAP_V2_EPERM, "write denied (RO mapping)");
         return -1;  // Let the generic handler kill the task
     }
     vmo_t *v = m->vmo;
-    if (!vmo_check(v) || !(v->flags & VMO_COW_CHILD)) {
-        spinlock_release(&g_vmo_map_lock);
+    if (!vmo_check(v) || (v->flags & VMO_MMIO)) {
+        spinlock_release(&as->lock);
         return -1;
     }
 
@@ -576,22 +1144,39 @@ int vmo_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
     uint64_t off_bytes = page_va - m->vaddr;
     uint32_t page_idx  = (uint32_t)((m->offset + off_bytes) / 4096);
     if (page_idx >= v->npages) {
-        spinlock_release(&g_vmo_map_lock);
+        spinlock_release(&as->lock);
         return -1;
     }
     uint64_t old_phys = v->pages[page_idx];
     if (!old_phys) {
-        spinlock_release(&g_vmo_map_lock);
+        spinlock_release(&as->lock);
         return -1;
     }
 
+    // Phase 26: a writable mapping of a source VMO that a clone or page
+    // loan write-protected. The source takes the copy instead — never for
+    // a VMO whose frames a device may hold (see vmo_loan_create).
+    if (!(v->flags & VMO_COW_CHILD)) {
+        if (v->flags & (VMO_CONTIGUOUS | VMO_PINNED)) {
+            spinlock_release(&as->lock);
+            audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va,
+                                  CAP_V2_EPERM, "cow break on fixed frames");
+            return -1;
+        }
+        vmo_ref(v);
+        spinlock_release(&as->lock);
+        int brc = vmo_cow_break_source(cur, v, page_idx, old_phys, fault_va);
+        vmo_unref(v);
+        return brc;
+    }
+
     // Phase 20 U10b: COW first-write counts the freshly-allocated private
     // page against the faulting task's mem_limit. The shared parent page
     // doesn't decrement on the child here (it's still mapped by the parent
     // — the symmetric refund happens when the parent unmaps).
     int mrc_cow = rlimit_check_mem(cur, 1);
     if (mrc_cow < 0) {
-        spinlock_release(&g_vmo_map_lock);
+        spinlock_release(&as->lock);
         audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va,
                               CAP_V2_ENOMEM, "cow rlimit denied");
         return -1;
@@ -600,7 +1185,7 @@ int vmo_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
     void *new_pa = pmm_alloc_page();
     if (!new_pa) {
         rlimit_account_free_mem(cur, 1);  // refund our reservation
-        spinlock_release(&g_vmo_map_lock);
+        spinlock_release(&as->lock);
         audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va,
                               CAP_V2_ENOMEM, "cow alloc failed");
         return -1;
@@ -616,7 +1201,7 @@ int vmo_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
     vmm_map_page_by_cr3(cur->cr3, page_va, (uint64_t)new_pa, flags);
     v->pages[page_idx] = (uint64_t)new_pa;  // child now owns this frame
 
-    spinlock_release(&g_vmo_map_lock);
+    spinlock_release(&as->lock);
     audit_write_vmo_fault(cur->id, v->cap_object_idx, fault_va, 0,
                           "cow copy-on-write satisfied");
     return 0;
@@ -632,29 +1217,42 @@ void vmo_cap_deactivate(cap_object_t *obj) {
 
 // Called from sched_reap_zombie to release any mappings the exiting task
 // still holds. Prevents handle leaks across process death.
-void vmo_cleanup_task(int32_t task_id) {
-    if (task_id < 0 || task_id >= VMO_MAX_TASKS) return;
-    spinlock_acquire(&g_vmo_map_lock);
-    for (int s = 0; s < VMO_MAPPINGS_PER_TASK; s++) {
-        vmo_mapping_t *m = &g_vmo_task_maps[task_id][s];
-        if (m->vaddr == 0) continue;
-        vmo_t *v = m->vmo;
-        // PTEs are torn down by vmm_destroy_address_space_by_cr3; we just
-        // release refcount accounting.
+static void vmo_release_subtree(vmo_map_node_t *n) {
+    if (!n) return;
+    vmo_release_subtree(n->left);
+    vmo_release_subtree(n->right);
+    vmo_mapping_t *m = &n->m;
+    vmo_t *v = m->vmo;
+    // PTEs are torn down by vmm_destroy_address_space_by_cr3; we just
+    // release refcount accounting.
+    if (v && v->pages) {
+        uint64_t start_page = m->offset / 4096;
         for (uint32_t p = 0; p < m->len_pages; p++) {
-            if (v && v->pages) {
-                uint64_t start_page = m->offset / 4096;
-                uint64_t phys = v->pages[start_page + p];
-                if (phys) pmm_page_unref((void *)phys);
-            }
-        }
-        m->vaddr = 0;
-        m->vmo = NULL;
-        if (v) {
-            spinlock_release(&g_vmo_map_lock);
-            vmo_unref(v);
-            spinlock_acquire(&g_vmo_map_lock);
+            uint64_t phys = v->pages[start_page + p];
+            if (phys) pmm_page_unref((void *)phys);
         }
     }
-    spinlock_release(&g_vmo_map_lock);
+    kmem_cache_free(g_vmo_node_cache, n);
+    if (v) vmo_unref(v);
+}
+
+void vmo_cleanup_task(task_t *t) {
+    if (!t) return;
+    // Unregister first: once off the list no vmo_clone_cow walk can reach
+    // the index, and the dying task cannot map or fault any more, so the
+    // tree is ours without holding as->lock across the vmo_unref calls.
+    spinlock_acquire(&g_vmo_as_list_lock);
+    vmo_as_t *as = t->vmo_as;
+    if (as) {
+        if (as->prev) as->prev->next = as->next;
+        else          g_vmo_as_head  = as->next;
+        if (as->next) as->next->prev = as->prev;
+        g_vmo_as_count--;
+        t->vmo_as = NULL;
+    }
+    spinlock_release(&g_vmo_as_list_lock);
+    if (!as) return;
+
+    vmo_release_subtree(as->root);
+    kmem_cache_free(g_vmo_as_cache, as);
 }
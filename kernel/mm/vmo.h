@@ -9,7 +9,7 @@
 // CAP_KIND_VMO whose kind_data stores the vmo_t pointer. Handle-holders
 // derive weaker rights via cap_object_derive (e.g., RIGHT_READ-only).
 //
-// Lock order: task.vmo_mappings.lock → vmo.lock → pmm_lock.
+// Lock order: vmo_as registry → task.vmo_as.lock → vmo.lock → pmm_lock.
 //
 // All VMOs are laid out as an array of 4-KiB physical frames. For eager
 // VMOs (default) every frame is allocated at vmo_create. For VMO_ONDEMAND
@@ -34,16 +34,20 @@
                                 // userspace driver daemons for DMA descriptor
                                 // rings + buffer pools where the device needs
                                 // a stable bus-master address range.
+#define VMO_ANON         0x40u  // Phase 26: anonymous memory. SYS_VMO_CREATE
+                                // takes no handle-table slot and the first
+                                // SYS_VMO_MAP retires the cap, so the mapping
+                                // holds the only reference and SYS_VMO_UNMAP
+                                // returns the frames (a failed map frees them
+                                // at once). Used by
+                                // libc malloc for large allocations.
 
 // --- Limits --------------------------------------------------------------
 #define VMO_MAX_SIZE    (256ull * 1024 * 1024)  // 256 MiB per VMO
-// Phase 23 Stage-2 cutover: bumped 8 → 64.  Each ahcid port allocates
-// 1 cmd_list + 1 FIS-receive + 32 cmd_tables = 34 VMO mappings; ahcid
-// also maps the IDENTIFY VMO + 4 channel-publish caches; total per-task
-// peak around ~40 mappings with one port active.  Keeping headroom for
-// multi-port + future drivers that touch more DMA buffers.  BSS impact
-// per task is 64 * 32 B = 2 KiB; full table = 256 * 2 KiB = 512 KiB.
-#define VMO_MAPPINGS_PER_TASK 64
+// Phase 26: mappings live in a per-address-space AVL index (task_t.vmo_as)
+// instead of a fixed 64-slot row, so this is only a runaway guard on the
+// kernel heap one task can pin through mapping nodes (56 B each).
+#define VMO_MAPPINGS_PER_TASK 16384
 
 struct task_struct;  // forward decl — vmo_mapping_t holds no task pointer
 struct cap_object;   // forward decl — vmo_cap_deactivate only takes a pointer
@@ -63,8 +67,8 @@ typedef struct vmo {
     spinlock_t lock;          //  56..103  Protects refcount + pages[]
 } vmo_t;
 
-// vmo_mapping_t lives inside task_t.vmo_mappings[]. One entry per live
-// vmo_map() result. Torn down by vmo_unmap.
+// vmo_mapping_t lives in a node of the mapping task's task_t.vmo_as index.
+// One entry per live vmo_map() result. Torn down by vmo_unmap.
 typedef struct vmo_mapping {
     uint64_t vaddr;      // Base virtual address; 0 ⇒ slot empty
     vmo_t   *vmo;        // Backing vmo_t (live reference held)
@@ -85,6 +89,14 @@ void vmo_init(void);
 vmo_t *vmo_create(uint64_t size_bytes, uint32_t flags,
                   int32_t owner_pid, int32_t audience_pid);
 
+// Phase 26: extend an eager, never-mapped VMO to new_size_bytes (4 KiB
+// aligned, > size_bytes) with fresh frames, zeroed if VMO_ZEROED. Existing
+// frames keep their place, so byte offsets stay valid. Kernel-private
+// buffers only (the txn replay buffer): mapped, COW, MMIO, contiguous and
+// on-demand VMOs are refused. Returns 0, CAP_V2_EINVAL or CAP_V2_ENOMEM;
+// on failure the VMO is unchanged.
+int vmo_grow(vmo_t *v, uint64_t new_size_bytes);
+
 // Destroy a VMO. For each page, decrement pp_refcount via pmm_page_unref.
 // Free pages[] array. Slab-free the vmo_t.
 void vmo_free(vmo_t *v);
@@ -132,7 +144,36 @@ vmo_t *vmo_clone_cow(vmo_t *src, int32_t owner_pid);
 // both sides unmap.
 vmo_t *vmo_clone_shared(vmo_t *src, int32_t owner_pid);
 
+// --- Page loans (Phase 26) -----------------------------------------------
+// Detach [vaddr, vaddr + len) of t's VMO mappings into a VMO that can ride
+// a channel message (SYS_CHAN_SEND_LOAN). The range must lie inside one
+// mapping.
+//
+//   default        COW: a child VMO holding just those pages. The source's
+//                  mappings of them turn read-only; whichever side writes
+//                  first gets a private copy (the source side through
+//                  vmo_pf_dispatch as well as the child side).
+//   VMO_LOAN_MOVE  the range must be a whole mapping of a VMO with no other
+//                  reference (e.g. a large malloc block). It is unmapped
+//                  from t and the VMO itself is the loan — no page is
+//                  shared, copied or write-protected.
+//
+// On success *out carries one reference for the caller and *prot_out the
+// source mapping's prot. Returns 0 or CAP_V2_EINVAL / EFAULT (no mapping
+// there) / EPERM / EBUSY (MOVE of a shared VMO) / ENOMEM.
+#define VMO_LOAN_MOVE  0x1u
+int vmo_loan_create(struct task_struct *t, uint64_t vaddr, uint64_t len,
+                    uint32_t flags, vmo_t **out, uint32_t *prot_out);
+
+// Undo vmo_loan_create for a loan that was never delivered: a MOVE loan is
+// mapped back at vaddr with prot; either way the caller's reference drops.
+void vmo_loan_cancel(struct task_struct *t, vmo_t *loan, uint64_t vaddr,
+                     uint32_t flags, uint32_t prot);
+
 // --- Page fault handler --------------------------------------------------
+// Handles COW first writes on both sides of a share: a VMO_COW_CHILD
+// mapping copies into the child, and (Phase 26) a write-protected source
+// mapping copies into the source, repointing all of the source's mappings.
 // Returns 0 if the fault was handled (caller should resume). Negative
 // otherwise. Registered into vmm's PF hook via vmm_install_pf_handler at
 // vmo_init.
@@ -144,8 +185,9 @@ int vmo_pf_dispatch(uint64_t fault_va, uint64_t error_code);
 void vmo_cap_deactivate(struct cap_object *obj);
 
 // Called from sched_reap_zombie to release any residual VMO mappings held
-// by the exiting task. Idempotent; no-op if the task had no mappings.
-void vmo_cleanup_task(int32_t task_id);
+// by the exiting task and free its mapping index. Idempotent; no-op if the
+// task never mapped a VMO.
+void vmo_cleanup_task(struct task_struct *t);
 
 // Phase 21: physical-address discovery for driver daemons. Returns the
 // physical address backing page `page_idx` of the VMO, or 0 if the page is
@@ -159,5 +201,13 @@ uint64_t vmo_get_phys(vmo_t *v, uint32_t page_idx);
 #define PROT_READ   0x1u
 #define PROT_WRITE  0x2u
 #define PROT_EXEC   0x4u
+// Phase 26: SYS_VMO_MAP prot modifier. The caller gives the cap up with the
+// call — its handle-table slot is freed and the cap destroyed whether or
+// not the map succeeds — so a successful mapping holds the caller's last
+// reference and SYS_VMO_UNMAP drops it. This is how a long-lived process
+// closes a VMO handle it has no further use for (e.g. a ring VMO it has
+// already cloned for a peer). Needs RIGHT_REVOKE on the token; MMIO caps
+// refuse it with EINVAL.
+#define VMO_MAP_RETIRE  0x100u
 
 #define VMO_MAGIC  0xCAFEF00Du
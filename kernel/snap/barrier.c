@@ -17,6 +17,15 @@
 //      every task as READY. Sends a wake-up IPI so any idle CPU dispatches
 //      promptly rather than waiting a tick.
 //
+// Parallel work (Phase 26). Parking leaves every non-owner CPU in its
+// idle loop. snap_barrier_run publishes an array of independent items and
+// IPIs those CPUs; each idle loop calls snap_barrier_help, which claims
+// items off a shared counter until none remain. The owner claims items
+// too, so with one CPU (or no helper waking in time) the run is simply
+// serial. The owner spins with interrupts disabled (it is in a syscall),
+// so its wait loop drains its own TLB-shootdown mailbox: helpers write-
+// protect PTEs of the very address space the owner has loaded.
+//
 // Why the watchdog. Without it, a CPU stuck in a long-held kernel-context
 // spinlock (audit-flusher, grahafs lock-drop window, etc.) would hold the
 // entire system. The watchdog turns "stuck barrier" into a clean -ETIME
@@ -35,6 +44,7 @@
 #include "../../arch/x86_64/cpu/smp.h"
 #include "../../arch/x86_64/cpu/tsc.h"
 #include "../../arch/x86_64/drivers/lapic/lapic.h"
+#include "../../arch/x86_64/mm/tlb.h"
 
 // Local errno mirrors (the kernel uses raw -errno integers everywhere).
 #define BARRIER_EBUSY  16
@@ -172,3 +182,72 @@ void snap_end_barrier(void) {
         apic_send_ipi(info->lapic_id, IPI_VEC_WAKEUP);
     }
 }
+
+// ---------------------------------------------------------------------------
+// Phase 26 — parallel barrier work.
+// ---------------------------------------------------------------------------
+static uint32_t snap_barrier_drain(snap_work_fn_t fn) {
+    void    *ctx = g_snap_barrier.work_ctx;
+    uint32_t n   = g_snap_barrier.work_items;
+    uint32_t ran = 0;
+    for (;;) {
+        uint32_t i = __atomic_fetch_add(&g_snap_barrier.work_next, 1u,
+                                        __ATOMIC_ACQ_REL);
+        if (i >= n) break;
+        fn(ctx, i);
+        ran++;
+        __atomic_add_fetch(&g_snap_barrier.work_done, 1u, __ATOMIC_RELEASE);
+    }
+    return ran;
+}
+
+void snap_barrier_help(void) {
+    if (!__atomic_load_n(&g_snap_barrier.work_fn, __ATOMIC_RELAXED)) return;
+    // Announce first, then re-read: the owner waits for work_helpers to
+    // drain after clearing work_fn, so a helper that still sees the
+    // function also sees the ctx / item count published before it.
+    __atomic_add_fetch(&g_snap_barrier.work_helpers, 1u, __ATOMIC_ACQ_REL);
+    snap_work_fn_t fn = __atomic_load_n(&g_snap_barrier.work_fn, __ATOMIC_ACQUIRE);
+    if (fn) {
+        uint32_t ran = snap_barrier_drain(fn);
+        if (ran) __atomic_add_fetch(&g_snap_barrier.work_items_helped, ran,
+                                    __ATOMIC_RELAXED);
+    }
+    __atomic_sub_fetch(&g_snap_barrier.work_helpers, 1u, __ATOMIC_RELEASE);
+}
+
+void snap_barrier_run(snap_work_fn_t fn, void *ctx, uint32_t n_items) {
+    if (!fn || n_items == 0) return;
+    if (n_items == 1 || g_cpu_count <= 1) {
+        for (uint32_t i = 0; i < n_items; i++) fn(ctx, i);
+        return;
+    }
+
+    g_snap_barrier.work_ctx   = ctx;
+    g_snap_barrier.work_items = n_items;
+    __atomic_store_n(&g_snap_barrier.work_next, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_snap_barrier.work_done, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_snap_barrier.work_fn, fn, __ATOMIC_RELEASE);
+
+    // Kick the parked CPUs out of hlt; vector 48 keeps them on their idle
+    // task while the barrier flag is set, and the idle loop then helps.
+    uint32_t self_cpu = smp_get_current_cpu();
+    for (uint32_t i = 0; i < g_cpu_count; i++) {
+        if (i == self_cpu) continue;
+        cpu_info_t *info = smp_get_cpu_info(i);
+        if (!info) continue;
+        apic_send_ipi(info->lapic_id, IPI_VEC_WAKEUP);
+    }
+
+    (void)snap_barrier_drain(fn);
+    while (__atomic_load_n(&g_snap_barrier.work_done, __ATOMIC_ACQUIRE) < n_items) {
+        tlb_poll_mailbox();
+        __asm__ volatile("pause" ::: "memory");
+    }
+
+    __atomic_store_n(&g_snap_barrier.work_fn, (snap_work_fn_t)NULL, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&g_snap_barrier.work_helpers, __ATOMIC_ACQUIRE) != 0) {
+        tlb_poll_mailbox();
+        __asm__ volatile("pause" ::: "memory");
+    }
+}
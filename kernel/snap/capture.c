@@ -6,6 +6,8 @@
 //   - snapshot_task_entry_t per task: regs / FD-table copy / pledge mask
 //   - snap_captured_page_t per present user-half PTE: marks the parent's
 //     PTE read-only, bumps cow_page_tracker_t refcount, bumps pmm_page_ref
+//     (Phase 26 SNAP_SCOPE_INCREMENTAL: only PTEs changed since the parent
+//     snapshot; see the W14.4 comment)
 //   - snapshot_vmo_entry_t per VMO mapped into a captured task: bumps
 //     vmo_ref so the backing pages survive even if the parent unmaps
 //   - snapshot_chan_entry_t per channel held (W18 chan_freeze)
@@ -17,7 +19,9 @@
 // All four capture passes are O(N_tasks * N_per_task_things). Inside the
 // barrier window only the owner CPU is running real work; the captures
 // can therefore allocate kheap and acquire VFS / channel registry locks
-// without worrying about preemption.
+// without worrying about preemption. Phase 26: the page walk, the bulk of
+// the work, is the exception — it is split across the parked CPUs with
+// snap_barrier_run (see snap_walk_unit_t).
 
 #include "snapshot.h"
 
@@ -48,7 +52,7 @@
 // it became a problem, but 64 captured tasks is well above what any test
 // or interactive session creates).
 #define SNAP_TASKS_MAX  64u
-#define SNAP_VMOS_PER_TASK_MAX  64u  // matches VMO_MAPPINGS_PER_TASK
+#define SNAP_VMOS_PER_TASK_MAX  64u
 #define SNAP_CHANS_MAX          64u
 #define SNAP_FSPINS_PER_TASK_MAX 16u  // matches PROC_MAX_FDS
 
@@ -93,10 +97,21 @@ static int snap_record_page(snapshot_task_entry_t *te,
 //
 // Skips:
 //   - non-present entries
-//   - 2 MiB large pages (PTE_LARGEPAGE bit on PD entry) — Phase 24 v1
-//     does not snapshot huge pages; the kernel doesn't allocate any
-//     in user space yet
+//   - 1 GiB pages (PTE_LARGEPAGE on a PDPT entry) — never created
 //   - kernel-only mappings (PTE_USER==0)
+// 2 MiB pages (Phase 26) are captured per 4 KiB frame; see
+// snap_capture_huge.
+//
+// Phase 26 incremental walk (`delta`): every PTE a walk records is left
+// read-only with PTE_SNAP_CLEAN set. Nothing else sets that bit, and every
+// path that changes what a PTE maps — the COW copy, the image-COW copy, a
+// VMO remap, a fresh mapping — installs a PTE without it. So a present,
+// read-only PTE that still carries it maps the same frame, with the same
+// contents, as at the task's previous capture; when that capture was the
+// parent's, the frame is already on the parent chain and the walk moves on
+// without touching the tracker, the PMM refcount or the TLB. The walk
+// still visits every table, but the per-page cost of an unchanged page is
+// one load. 2 MiB mappings are always captured whole.
 //
 // PHYS_ADDR_MASK isolates bits 12..51 (the actual physical-address
 // payload). PAGE_MASK in vmm.h is 0xFFFFFFFFFFFFF000 which retains the
@@ -106,7 +121,145 @@ static int snap_record_page(snapshot_task_entry_t *te,
 #define PHYS_ADDR_MASK  0x000FFFFFFFFFF000ULL
 #define PHYS_FLAGS_MASK (~PHYS_ADDR_MASK)
 
-static int snap_walk_user_half(uint64_t cr3, snapshot_task_entry_t *te) {
+// Phase 26: a 2 MiB mapping is captured as its 512 constituent 4 KiB frames
+// (the PMM and cow_page_tracker count per frame) but write-protected with a
+// single PD entry update. The first write fault splits it on demand and
+// copies only the faulting 4 KiB page; the other 511 stay shared.
+static int snap_capture_huge(uint64_t cr3, snapshot_task_entry_t *te,
+                             tlb_batch_t *live, tlb_batch_t *snap,
+                             uint64_t pml4_idx, uint64_t pdpt_idx,
+                             uint64_t pd_idx, uint64_t pde) {
+    if (!(pde & PTE_USER)) return 0;
+    uint64_t base_va = (pml4_idx << 39) | (pdpt_idx << 30) | (pd_idx << 21);
+    uint64_t base_pa = pde & HUGE_PAGE_ADDR_MASK;
+    // Flags as the split 4 KiB PTEs will carry them (PS dropped, PAT moved).
+    uint64_t flags = vmm_get_pte(cr3, base_va) & PHYS_FLAGS_MASK;
+    for (uint64_t i = 0; i < HUGE_PAGE_PAGES; i++) {
+        uint64_t virt = base_va + i * PAGE_SIZE;
+        uint64_t phys = base_pa + i * PAGE_SIZE;
+        int rc = snap_record_page(te, virt, phys, flags);
+        if (rc < 0) return rc;
+        pmm_page_ref((void *)phys);
+    }
+    if (flags & PTE_WRITABLE) {
+        (void)vmm_protect_huge_page_batched(cr3, base_va,
+                                            flags & ~PTE_WRITABLE, live);
+        if (te->cr3_snapshot != 0 && te->cr3_snapshot != cr3) {
+            (void)vmm_protect_huge_page_batched(te->cr3_snapshot, base_va,
+                                                flags & ~PTE_WRITABLE, snap);
+        }
+    }
+    return 0;
+}
+
+// Walk the page directory under one PDPT entry (1 GiB of user VA). The
+// cow_page_tracker bumps for the recorded pages are left to the caller,
+// which publishes them in bulk with cow_page_tracker_bump_many once the
+// unit is done — before the barrier drops, so no write can reach a page
+// whose tracker is not yet in place.
+static int snap_walk_pd(uint64_t cr3, snapshot_task_entry_t *te,
+                        tlb_batch_t *live, tlb_batch_t *snap, bool delta,
+                        uint64_t pml4_idx, uint64_t pdpt_idx, uint64_t *pd) {
+    for (uint64_t pd_idx = 0; pd_idx < 512u; pd_idx++) {
+        uint64_t pde = pd[pd_idx];
+        if (!(pde & PTE_PRESENT)) continue;
+        if (pde & PTE_LARGEPAGE) {
+            int rc = snap_capture_huge(cr3, te, live, snap,
+                                       pml4_idx, pdpt_idx, pd_idx, pde);
+            if (rc < 0) return rc;
+            continue;
+        }
+        uint64_t *pt = (uint64_t *)((pde & PHYS_ADDR_MASK) + g_hhdm_offset);
+        for (uint64_t pt_idx = 0; pt_idx < 512u; pt_idx++) {
+            uint64_t pte = pt[pt_idx];
+            if (!(pte & PTE_PRESENT)) continue;
+            if (!(pte & PTE_USER)) continue;
+            uint64_t virt = (pml4_idx << 39) | (pdpt_idx << 30) |
+                            (pd_idx   << 21) | (pt_idx   << 12);
+            uint64_t phys = pte & PHYS_ADDR_MASK;
+            uint64_t flags = pte & PHYS_FLAGS_MASK & ~PTE_SNAP_CLEAN;
+            // Sanity: don't snapshot HHDM/kernel-half VAs.
+            if (virt >= 0xFFFF800000000000ULL) continue;
+
+            if (delta && (pte & PTE_SNAP_CLEAN) && !(pte & PTE_WRITABLE)) {
+                te->pages_inherited++;
+                continue;
+            }
+
+            int rc = snap_record_page(te, virt, phys, flags);
+            if (rc < 0) return rc;
+            pmm_page_ref((void *)phys);
+
+            if (!(flags & PTE_WRITABLE)) {
+                // Already read-only: only the software bit changes,
+                // which the MMU ignores — no shootdown.
+                pt[pt_idx] = pte | PTE_SNAP_CLEAN;
+                continue;
+            }
+            // Clear the writable bit. The invalidation is queued on
+            // `live` and shot down once per unit.
+            (void)vmm_protect_page_batched(cr3, virt,
+                                           (flags & ~PTE_WRITABLE) |
+                                               PTE_SNAP_CLEAN,
+                                           live);
+            // Phase 25 / FU24.H: when te->cr3_snapshot is a truly
+            // divergent tree (not aliasing cr3), mirror the RO mark into
+            // the snapshot's PTE so a future walk of the snapshot CR3
+            // sees real W^X. The current default (cr3_snapshot ==
+            // cr3_original) skips this work — the parent's RO mark is
+            // the snapshot's RO mark.
+            if (te->cr3_snapshot != 0 && te->cr3_snapshot != cr3) {
+                (void)vmm_protect_page_batched(te->cr3_snapshot, virt,
+                                               flags & ~PTE_WRITABLE, snap);
+            }
+        }
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Phase 26 — parallel walk. The user halves of all captured tasks are cut
+// into units of one PDPT entry each, and snap_barrier_run spreads the units
+// over the CPUs the barrier parked. Units touch disjoint page tables, so
+// the only shared state is the cow_page_tracker hash and the PMM refcounts.
+// Each unit records into a private page list (its CPU's shard) and, when
+// done, flushes its own TLB batches and bumps its trackers in bulk; the
+// owner then concatenates the shards per task in VA order.
+// ---------------------------------------------------------------------------
+typedef struct snap_walk_unit {
+    uint64_t               cr3;
+    uint32_t               task;        // Index into snap->tasks.
+    uint16_t               pml4_idx;
+    uint16_t               pdpt_idx;
+    bool                   delta;
+    int                    rc;
+    snapshot_task_entry_t  part;        // Private page list for this unit.
+} snap_walk_unit_t;
+
+static void snap_walk_unit_fn(void *ctx, uint32_t item) {
+    snap_walk_unit_t *u = &((snap_walk_unit_t *)ctx)[item];
+    uint64_t *pml4 = (uint64_t *)(u->cr3 + g_hhdm_offset);
+    uint64_t *pdpt = (uint64_t *)((pml4[u->pml4_idx] & PHYS_ADDR_MASK) +
+                                  g_hhdm_offset);
+    uint64_t *pd   = (uint64_t *)((pdpt[u->pdpt_idx] & PHYS_ADDR_MASK) +
+                                  g_hhdm_offset);
+    // Both batches are flushed on every exit path — including the error
+    // return — because PTEs already downgraded stay downgraded.
+    tlb_batch_t live, snap;
+    tlb_batch_init(&live, u->cr3);
+    tlb_batch_init(&snap, u->part.cr3_snapshot);
+    u->rc = snap_walk_pd(u->cr3, &u->part, &live, &snap, u->delta,
+                         u->pml4_idx, u->pdpt_idx, pd);
+    tlb_batch_flush(&live);
+    tlb_batch_flush(&snap);
+    cow_page_tracker_bump_many(u->part.pages, u->part.page_count);
+}
+
+// Count (units == NULL) or fill the walk units of one task.
+static uint32_t snap_walk_units_for_task(uint64_t cr3, uint32_t task,
+                                         const snapshot_task_entry_t *te,
+                                         bool delta, snap_walk_unit_t *units) {
+    uint32_t n = 0;
     uint64_t *pml4 = (uint64_t *)(cr3 + g_hhdm_offset);
     for (uint64_t pml4_idx = 0; pml4_idx < 256u; pml4_idx++) {
         uint64_t pml4e = pml4[pml4_idx];
@@ -117,62 +270,24 @@ static int snap_walk_user_half(uint64_t cr3, snapshot_task_entry_t *te) {
             if (!(pdpte & PTE_PRESENT)) continue;
             // 1 GiB pages — skip in v1.
             if (pdpte & PTE_LARGEPAGE) continue;
-            uint64_t *pd = (uint64_t *)((pdpte & PHYS_ADDR_MASK) + g_hhdm_offset);
-            for (uint64_t pd_idx = 0; pd_idx < 512u; pd_idx++) {
-                uint64_t pde = pd[pd_idx];
-                if (!(pde & PTE_PRESENT)) continue;
-                if (pde & PTE_LARGEPAGE) continue;
-                uint64_t *pt = (uint64_t *)((pde & PHYS_ADDR_MASK) + g_hhdm_offset);
-                for (uint64_t pt_idx = 0; pt_idx < 512u; pt_idx++) {
-                    uint64_t pte = pt[pt_idx];
-                    if (!(pte & PTE_PRESENT)) continue;
-                    if (!(pte & PTE_USER)) continue;
-                    uint64_t virt = (pml4_idx << 39) | (pdpt_idx << 30) |
-                                    (pd_idx   << 21) | (pt_idx   << 12);
-                    uint64_t phys = pte & PHYS_ADDR_MASK;
-                    uint64_t flags = pte & PHYS_FLAGS_MASK;
-                    // Sanity: don't snapshot HHDM/kernel-half VAs.
-                    if (virt >= 0xFFFF800000000000ULL) continue;
-                    // Sign-extend the canonical bits before checking
-                    // canonicality just in case some strange entry
-                    // landed in the upper user half.
-
-                    int rc = snap_record_page(te, virt, phys, flags);
-                    if (rc < 0) return rc;
-
-                    // Bump cow tracker + pmm refcount BEFORE marking RO so
-                    // a concurrent write-fault (race with another CPU)
-                    // sees the tracker. The barrier guarantees no other
-                    // CPU is executing user mode, but a kernel-mode
-                    // pagetable observer (e.g., the audit flusher) could
-                    // resolve a pointer.
-                    cow_page_tracker_bump(phys);
-                    pmm_page_ref((void *)phys);
-
-                    if (flags & PTE_WRITABLE) {
-                        // Clear the writable bit. invlpg is issued by
-                        // vmm_protect_page_by_cr3 itself.
-                        (void)vmm_protect_page_by_cr3(cr3, virt,
-                                                      flags & ~PTE_WRITABLE);
-                        // Phase 25 / FU24.H: when te->cr3_snapshot is a
-                        // truly divergent tree (not aliasing cr3), mirror
-                        // the RO mark into the snapshot's PTE so a future
-                        // walk of the snapshot CR3 sees real W^X. The
-                        // current default (cr3_snapshot == cr3_original)
-                        // skips this work — the parent's RO mark is the
-                        // snapshot's RO mark.
-                        if (te->cr3_snapshot != 0 &&
-                            te->cr3_snapshot != cr3) {
-                            (void)vmm_protect_page_by_cr3(
-                                te->cr3_snapshot, virt,
-                                flags & ~PTE_WRITABLE);
-                        }
-                    }
-                }
+            if (units) {
+                snap_walk_unit_t *u = &units[n];
+                memset(u, 0, sizeof(*u));
+                u->cr3      = cr3;
+                u->task     = task;
+                u->pml4_idx = (uint16_t)pml4_idx;
+                u->pdpt_idx = (uint16_t)pdpt_idx;
+                u->delta    = delta;
+                // Enough of the entry for snap_record_page, the RO mirror
+                // and (on rollback) snap_destroy_task_entry.
+                u->part.pid          = te->pid;
+                u->part.cr3_original = te->cr3_original;
+                u->part.cr3_snapshot = te->cr3_snapshot;
             }
+            n++;
         }
     }
-    return 0;
+    return n;
 }
 
 // ---------------------------------------------------------------------------
@@ -226,7 +341,7 @@ static void snap_destroy_task_entry(snapshot_task_entry_t *te) {
         // Phase 24 W14.6 closeout: before dropping snap's claims on the
         // captured pages, walk the parent's live PTEs. For pages that
         // STILL map to the captured phys (parent never COW'd them), the
-        // parent's PTE_WRITABLE is still cleared from snap_walk_user_half.
+        // parent's PTE_WRITABLE is still cleared from the capture walk.
         // After we drop the tracker the cow_fault path can no longer
         // resolve a write — the page would page-fault and the kernel
         // would kill the process. Restore the original flags (which
@@ -272,21 +387,15 @@ static void snap_destroy_task_entry(snapshot_task_entry_t *te) {
 }
 
 // ---------------------------------------------------------------------------
-// W14.5 — VMO capture. Looks at the global g_vmo_task_maps[] indirectly via
-// vmo_ref() which is publicly exported. We just walk the per-task mapping
-// array and bump refcounts.
+// W14.5 — VMO capture. A no-op in v1: it records nothing and returns 0.
 // ---------------------------------------------------------------------------
 //
-// vmo_mapping_t is internal to vmo.c; instead of pulling its array out we
-// use a tiny accessor here that lives in vmo.c. To keep this file
-// independent of new API surface, we declare an extern accessor that
-// vmo.c provides — but to avoid changing vmo.c's surface in this commit
-// we use a simple iteration over task_t's vmo_mapping_t[] if such a field
-// existed. It does NOT today (mappings live in g_vmo_task_maps[]). For v1
-// we skip VMO capture entirely; the cow_page_tracker + pmm_page_ref work
-// already done by W14.4 keeps every actually-mapped page alive. The VMO
-// header itself does not need to survive snap_create — the snapshot's
-// recorded pages reference the underlying physical frames directly.
+// The task's mappings live in its VMO interval index (task_t.vmo_as),
+// which is private to vmo.c, and no VMO is ref'd here. None needs to be:
+// the cow_page_tracker + pmm_page_ref work already done by W14.4 keeps
+// every actually-mapped page alive, and the snapshot's recorded pages
+// reference the underlying physical frames directly, so the VMO header
+// itself does not need to survive snap_create.
 // ---------------------------------------------------------------------------
 static int snap_capture_vmos_for_task(task_t *t,
                                        snapshot_t *snap) {
@@ -448,6 +557,83 @@ static void snap_pid_filter_cb(struct task_struct *t, void *ctx_v) {
     ctx->captured_tasks[ctx->n_captured++] = (task_t *)t;
 }
 
+// Phase 26: W14.4 for every captured task, spread over the barrier CPUs
+// (see snap_walk_unit_t). Each task's shards are concatenated into
+// te->pages in unit order, which is VA order. A task whose units failed,
+// or whose total exceeds SNAP_PAGES_PER_TASK_MAX, has its shards rolled
+// back on the spot; the error is returned after every task is merged.
+static int snap_capture_pages(snapshot_t *snap, task_t **tasks, uint32_t n_tasks) {
+    uint32_t n_units = 0;
+    for (uint32_t i = 0; i < n_tasks; i++) {
+        n_units += snap_walk_units_for_task(tasks[i]->cr3, i, &snap->tasks[i],
+                                            snap->tasks[i].delta != 0, NULL);
+    }
+    if (n_units == 0) return 0;
+
+    snap_walk_unit_t *units =
+        (snap_walk_unit_t *)kmalloc(sizeof(snap_walk_unit_t) * n_units,
+                                    SUBSYS_CORE);
+    if (!units) return -CAP_ENOMEM;
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n_tasks; i++) {
+        k += snap_walk_units_for_task(tasks[i]->cr3, i, &snap->tasks[i],
+                                      snap->tasks[i].delta != 0, &units[k]);
+    }
+
+    snap_barrier_run(snap_walk_unit_fn, units, n_units);
+
+    int rc = 0;
+    for (uint32_t first = 0; first < n_units; ) {
+        uint32_t ti = units[first].task;
+        snapshot_task_entry_t *te = &snap->tasks[ti];
+        uint32_t last  = first;
+        uint32_t total = 0;
+        int      trc   = 0;
+        while (last < n_units && units[last].task == ti) {
+            total += units[last].part.page_count;
+            te->pages_inherited += units[last].part.pages_inherited;
+            if (units[last].rc < 0 && trc == 0) trc = units[last].rc;
+            last++;
+        }
+        if (trc == 0 && total > SNAP_PAGES_PER_TASK_MAX) trc = -CAP_E2BIG;
+        if (trc == 0 && total > 0) {
+            te->pages = (snap_captured_page_t *)kmalloc(
+                sizeof(snap_captured_page_t) * total, SUBSYS_CORE);
+            if (te->pages) te->page_cap = total;
+            else           trc = -CAP_ENOMEM;
+        }
+        for (uint32_t u = first; u < last; u++) {
+            snapshot_task_entry_t *part = &units[u].part;
+            if (trc < 0) {
+                // Undo this shard's downgrades, trackers and PMM refs. The
+                // cloned PML4 belongs to te, so hide it from the teardown.
+                part->cr3_snapshot = 0;
+                snap_destroy_task_entry(part);
+                continue;
+            }
+            if (part->page_count) {
+                memcpy(&te->pages[te->page_count], part->pages,
+                       sizeof(snap_captured_page_t) * part->page_count);
+                te->page_count += part->page_count;
+            }
+            if (part->pages) kfree(part->pages);
+        }
+        if (trc < 0 && rc == 0) rc = trc;
+        snap->pages_shared += te->page_count;
+        first = last;
+    }
+    kfree(units);
+    return rc;
+}
+
+snapshot_task_entry_t *snap_find_task_entry(snapshot_t *snap, int32_t pid) {
+    if (!snap || !snap->tasks) return NULL;
+    for (uint32_t i = 0; i < snap->task_count; i++) {
+        if (snap->tasks[i].pid == pid) return &snap->tasks[i];
+    }
+    return NULL;
+}
+
 int snap_run_capture(snapshot_t *snap, task_t *self) {
     if (!snap || !self) return -CAP_EINVAL;
     snap_capture_ctx_t ctx = { .snap = snap, .n_captured = 0, .err = 0 };
@@ -473,7 +659,8 @@ int snap_run_capture(snapshot_t *snap, task_t *self) {
     memset(snap->tasks, 0, sizeof(snapshot_task_entry_t) * ctx.n_captured);
     snap->task_count = ctx.n_captured;
 
-    // For each task: regs / FD / pledge / page walk / VMO ref / FS pin.
+    // For each task: regs / FD / pledge, then (below) the page walk of
+    // every task at once, then VMO ref / FS pin.
     for (uint32_t i = 0; i < ctx.n_captured; i++) {
         task_t *t = ctx.captured_tasks[i];
         snapshot_task_entry_t *te = &snap->tasks[i];
@@ -481,11 +668,27 @@ int snap_run_capture(snapshot_t *snap, task_t *self) {
         int rc = snap_capture_one_task(t, te);
         if (rc < 0) return rc;
 
-        rc = snap_walk_user_half(t->cr3, te);
-        if (rc < 0) return rc;
-        snap->pages_shared += te->page_count;
+        // Phase 26: a delta is only sound when this task's clean bits are
+        // relative to the parent (its last capture was the parent's) and
+        // nothing was unmapped since. Anything else — a task new to the
+        // chain, an intervening snapshot, a munmap — gets a full walk.
+        // snap_last_id moves before the walk: even a walk that fails part
+        // way has re-stamped clean bits.
+        snapshot_task_entry_t *pte_parent =
+            snap->parent ? snap_find_task_entry(snap->parent, te->pid) : NULL;
+        bool delta = pte_parent && t->snap_last_id == snap->parent->id &&
+                     t->snap_unmap_gen == pte_parent->unmap_gen;
+        te->delta     = delta ? 1u : 0u;
+        te->unmap_gen = t->snap_unmap_gen;
+        t->snap_last_id = snap->id;
+    }
+
+    int prc = snap_capture_pages(snap, ctx.captured_tasks, ctx.n_captured);
+    if (prc < 0) return prc;
 
-        rc = snap_capture_vmos_for_task(t, snap);
+    for (uint32_t i = 0; i < ctx.n_captured; i++) {
+        task_t *t = ctx.captured_tasks[i];
+        int rc = snap_capture_vmos_for_task(t, snap);
         if (rc < 0) return rc;
 
         rc = snap_capture_fs_pins_for_task(t, snap);
@@ -25,9 +25,13 @@
 // the VMO COW handler from accidentally allocating a second private page
 // when the snap COW handler would have resolved it via promote-in-place).
 //
-// Lookups under a single global spinlock with 256 hash buckets. Per-CPU
-// caches are deferred until measurement shows lookup contention (the plan
-// flags this as W15 future work).
+// Phase 26: the hash is sharded — 1024 buckets, each with its own
+// cache-line-aligned spinlock — so faults on different pages no longer
+// serialize on one global lock after a snapshot. The fault path holds a
+// bucket lock only for the lookup. Step 3 is live again: a tracker whose
+// refcount is 1 on a frame nothing else maps (pmm refcount 1) belongs to
+// no snapshot any more, so it is reaped and the PTE promoted in place
+// without the page allocation, copy and remap of step 4.
 //
 // Test harness: the hash table primitives + handler chain land here in W15;
 // the actual fault is exercised once W14.4 (PML4 deep walk) marks pages RO
@@ -53,16 +57,21 @@
 // ---------------------------------------------------------------------------
 // Hash table for cow_page_tracker_t lookups, keyed on (phys >> 12) & MASK.
 // ---------------------------------------------------------------------------
-#define COW_HASH_BUCKETS  256u
+#define COW_HASH_BUCKETS  1024u
 #define COW_HASH_MASK     (COW_HASH_BUCKETS - 1u)
 
-static cow_page_tracker_t *g_cow_buckets[COW_HASH_BUCKETS];
-static spinlock_t          g_cow_lock = SPINLOCK_INITIALIZER("cow_track");
-static kmem_cache_t       *g_cow_tracker_cache;
+// One lock per bucket, each on its own cache line.
+typedef struct cow_bucket {
+    spinlock_t          lock;
+    cow_page_tracker_t *head;
+} __attribute__((aligned(64))) cow_bucket_t;
+
+static cow_bucket_t  g_cow_buckets[COW_HASH_BUCKETS];
+static kmem_cache_t *g_cow_tracker_cache;
 
 // Fast path: when this counter is 0, NO snapshot is tracking any page and
 // snap_cow_pf_dispatch can short-circuit without walking the faulting PTE
-// or acquiring g_cow_lock. Bumped on tracker insert, decremented on
+// or taking a bucket lock. Bumped on tracker insert, decremented on
 // tracker reap. Read with __ATOMIC_RELAXED — false negatives (count
 // momentarily looks 0 mid-insert) just send the fault through the slow
 // path that re-checks under the lock.
@@ -91,7 +100,8 @@ void cow_init(void) {
     }
 
     for (uint32_t i = 0; i < COW_HASH_BUCKETS; i++) {
-        g_cow_buckets[i] = NULL;
+        spinlock_init(&g_cow_buckets[i].lock, "cow_bucket");
+        g_cow_buckets[i].head = NULL;
     }
 
     vmm_install_snap_pf_handler(snap_cow_pf_dispatch);
@@ -101,14 +111,18 @@ void cow_init(void) {
 }
 
 // ---------------------------------------------------------------------------
-// Lookup helpers (caller must hold g_cow_lock).
+// Lookup helpers (caller must hold the phys's bucket lock).
 // ---------------------------------------------------------------------------
 static inline uint32_t cow_hash(uint64_t phys) {
     return (uint32_t)((phys >> 12) & COW_HASH_MASK);
 }
 
+static inline cow_bucket_t *cow_bucket(uint64_t phys) {
+    return &g_cow_buckets[cow_hash(phys)];
+}
+
 static cow_page_tracker_t *cow_lookup_locked(uint64_t phys) {
-    cow_page_tracker_t *t = g_cow_buckets[cow_hash(phys)];
+    cow_page_tracker_t *t = cow_bucket(phys)->head;
     while (t) {
         if (t->phys_page == phys) return t;
         t = t->next;
@@ -117,7 +131,7 @@ static cow_page_tracker_t *cow_lookup_locked(uint64_t phys) {
 }
 
 static void cow_unlink_locked(cow_page_tracker_t *t) {
-    cow_page_tracker_t **slot = &g_cow_buckets[cow_hash(t->phys_page)];
+    cow_page_tracker_t **slot = &cow_bucket(t->phys_page)->head;
     while (*slot) {
         if (*slot == t) {
             *slot = t->next;
@@ -141,18 +155,19 @@ cow_page_tracker_t *cow_page_tracker_get(uint64_t phys) {
     phys &= PAGE_MASK;
     if (!phys) return NULL;
 
-    spinlock_acquire(&g_cow_lock);
+    cow_bucket_t *b = cow_bucket(phys);
+    spinlock_acquire(&b->lock);
     cow_page_tracker_t *t = cow_lookup_locked(phys);
     if (t) {
         // Saturate at UINT32_MAX-1 to leave headroom for future +1 ops.
         if (t->refcount < 0xFFFFFFFFu) t->refcount++;
-        spinlock_release(&g_cow_lock);
+        spinlock_release(&b->lock);
         return t;
     }
-    spinlock_release(&g_cow_lock);
+    spinlock_release(&b->lock);
 
     // Drop the lock to call the slab allocator (kmem_cache_alloc may take
-    // its own spinlock; hold time of g_cow_lock should stay short).
+    // its own spinlock; bucket lock hold times should stay short).
     cow_page_tracker_t *fresh =
         (cow_page_tracker_t *)kmem_cache_alloc(g_cow_tracker_cache);
     if (!fresh) return NULL;
@@ -161,20 +176,20 @@ cow_page_tracker_t *cow_page_tracker_get(uint64_t phys) {
     fresh->owner_snap_id = 0;
     fresh->next          = NULL;
 
-    spinlock_acquire(&g_cow_lock);
+    spinlock_acquire(&b->lock);
     // Re-check: someone else could have inserted the same phys while we
     // were unlocked.
     cow_page_tracker_t *winner = cow_lookup_locked(phys);
     if (winner) {
         if (winner->refcount < 0xFFFFFFFFu) winner->refcount++;
-        spinlock_release(&g_cow_lock);
+        spinlock_release(&b->lock);
         kmem_cache_free(g_cow_tracker_cache, fresh);
         return winner;
     }
-    fresh->next = g_cow_buckets[cow_hash(phys)];
-    g_cow_buckets[cow_hash(phys)] = fresh;
+    fresh->next = b->head;
+    b->head = fresh;
     __atomic_fetch_add(&g_cow_tracker_count, 1, __ATOMIC_RELAXED);
-    spinlock_release(&g_cow_lock);
+    spinlock_release(&b->lock);
     return fresh;
 }
 
@@ -182,15 +197,78 @@ void cow_page_tracker_bump(uint64_t phys) {
     (void)cow_page_tracker_get(phys);
 }
 
+// Phase 26: batched bump. Per chunk: one pass bumps every tracker that
+// exists, the misses get fresh trackers from the slab in one go, and a
+// second pass inserts them (or bumps a tracker some other CPU inserted
+// meanwhile and returns the spare). Each page takes only its own bucket
+// lock, so capture units running on several CPUs rarely meet.
+#define COW_BUMP_CHUNK 32u
+
+void cow_page_tracker_bump_many(const snap_captured_page_t *pages, uint32_t n) {
+    if (!g_cow_tracker_cache || !pages) return;
+    for (uint32_t base = 0; base < n; base += COW_BUMP_CHUNK) {
+        uint32_t cnt = n - base;
+        if (cnt > COW_BUMP_CHUNK) cnt = COW_BUMP_CHUNK;
+        uint64_t miss[COW_BUMP_CHUNK];
+        uint32_t nmiss = 0;
+
+        for (uint32_t i = 0; i < cnt; i++) {
+            uint64_t phys = pages[base + i].phys & PAGE_MASK;
+            if (!phys) continue;
+            cow_bucket_t *b = cow_bucket(phys);
+            spinlock_acquire(&b->lock);
+            cow_page_tracker_t *t = cow_lookup_locked(phys);
+            if (t) {
+                if (t->refcount < 0xFFFFFFFFu) t->refcount++;
+            } else {
+                miss[nmiss++] = phys;
+            }
+            spinlock_release(&b->lock);
+        }
+        if (nmiss == 0) continue;
+
+        cow_page_tracker_t *fresh[COW_BUMP_CHUNK];
+        for (uint32_t i = 0; i < nmiss; i++) {
+            fresh[i] = (cow_page_tracker_t *)kmem_cache_alloc(g_cow_tracker_cache);
+        }
+
+        for (uint32_t i = 0; i < nmiss; i++) {
+            cow_bucket_t *b = cow_bucket(miss[i]);
+            spinlock_acquire(&b->lock);
+            // Re-check: an earlier miss in this chunk, or another CPU,
+            // may have inserted the same phys.
+            cow_page_tracker_t *winner = cow_lookup_locked(miss[i]);
+            if (winner) {
+                if (winner->refcount < 0xFFFFFFFFu) winner->refcount++;
+            } else if (fresh[i]) {
+                cow_page_tracker_t *t = fresh[i];
+                fresh[i] = NULL;
+                t->phys_page     = miss[i];
+                t->refcount      = 1;
+                t->owner_snap_id = 0;
+                t->next          = b->head;
+                b->head          = t;
+                __atomic_fetch_add(&g_cow_tracker_count, 1, __ATOMIC_RELAXED);
+            }
+            spinlock_release(&b->lock);
+        }
+
+        for (uint32_t i = 0; i < nmiss; i++) {
+            if (fresh[i]) kmem_cache_free(g_cow_tracker_cache, fresh[i]);
+        }
+    }
+}
+
 void cow_page_tracker_put(uint64_t phys) {
     if (!g_cow_tracker_cache) return;
     phys &= PAGE_MASK;
     if (!phys) return;
 
-    spinlock_acquire(&g_cow_lock);
+    cow_bucket_t *b = cow_bucket(phys);
+    spinlock_acquire(&b->lock);
     cow_page_tracker_t *t = cow_lookup_locked(phys);
     if (!t) {
-        spinlock_release(&g_cow_lock);
+        spinlock_release(&b->lock);
         return;
     }
     if (t->refcount > 0) t->refcount--;
@@ -199,7 +277,7 @@ void cow_page_tracker_put(uint64_t phys) {
         cow_unlink_locked(t);
         __atomic_fetch_sub(&g_cow_tracker_count, 1, __ATOMIC_RELAXED);
     }
-    spinlock_release(&g_cow_lock);
+    spinlock_release(&b->lock);
 
     if (reap) kmem_cache_free(g_cow_tracker_cache, t);
 }
@@ -213,7 +291,7 @@ void cow_page_tracker_put(uint64_t phys) {
 static int snap_cow_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
     // Fast path: when no snapshot is tracking any page, every fault here
     // is going to fall through to vmo_pf_dispatch anyway. Skip the PTE
-    // walk + lock acquire to keep the snap handler at single-load cost
+    // walk + bucket lock to keep the snap handler at single-load cost
     // for the steady-state workload. Reading g_cow_tracker_count with
     // __ATOMIC_RELAXED is fine — a stale 0 just sends a real snap fault
     // through the slow path one extra cycle later, which is harmless.
@@ -235,8 +313,8 @@ static int snap_cow_pf_dispatch(uint64_t fault_va, uint64_t error_code) {
 
 // ---------------------------------------------------------------------------
 // cow_fault_handle — declared in snapshot.h. Resolves a write fault on a
-// snap-tracked RO page by either promoting in place (refcount==1) or
-// allocating a private copy (refcount>1).
+// snap-tracked RO page by either promoting in place (no snapshot left
+// holding the frame) or allocating a private copy.
 // ---------------------------------------------------------------------------
 int cow_fault_handle(uint64_t fault_va, uint64_t error_code,
                      struct interrupt_frame *regs) {
@@ -265,13 +343,33 @@ int cow_fault_handle(uint64_t fault_va, uint64_t error_code,
     // matches QEMU's TCG x86_64 default, which is what we run under).
     const uint64_t PHYS_ADDR_MASK = 0x000FFFFFFFFFF000ULL;
     uint64_t old_phys  = pte & PHYS_ADDR_MASK;
-    uint64_t old_flags = pte & ~PHYS_ADDR_MASK;
-
-    spinlock_acquire(&g_cow_lock);
+    // The private copy is a change since the last capture: drop
+    // PTE_SNAP_CLEAN so an incremental snapshot records it.
+    uint64_t old_flags = pte & ~PHYS_ADDR_MASK & ~PTE_SNAP_CLEAN;
+
+    // Phase 26: promote in place. Every snapshot claim on a frame is both
+    // a tracker ref and a pmm ref, so a tracker at refcount 1 on a frame
+    // whose pmm refcount is 1 is only the live mapping's own claim (the
+    // one snap_restore adds) — the snapshots that shared it are gone.
+    // Reap the tracker under the bucket lock and flip the PTE writable;
+    // no allocation, no copy, and no global lock beyond the pmm read.
+    cow_bucket_t *b = cow_bucket(old_phys);
+    spinlock_acquire(&b->lock);
     cow_page_tracker_t *t = cow_lookup_locked(old_phys);
-    spinlock_release(&g_cow_lock);
+    bool promote = t && t->refcount == 1 &&
+                   pmm_page_get_refcount((void *)old_phys) == 1;
+    if (promote) {
+        cow_unlink_locked(t);
+        __atomic_fetch_sub(&g_cow_tracker_count, 1, __ATOMIC_RELAXED);
+    }
+    spinlock_release(&b->lock);
 
     if (!t) return -1;
+    if (promote) {
+        kmem_cache_free(g_cow_tracker_cache, t);
+        return vmm_protect_page_by_cr3(cur->cr3, page_va,
+                                       old_flags | PTE_WRITABLE) ? 0 : -1;
+    }
 
     // Phase 24 v1: always COW. The W14.4 page-table cloning ("clone the
     // user-half PML4 so the snapshot has its own PTEs") is deferred —
@@ -21,6 +21,8 @@
 //     If it points at a different phys (because the parent COW'd), we
 //     unmap + pmm_unref the new phys and install the captured one with a
 //     fresh pmm_page_ref.
+//   - Phase 26 incremental snapshots replay the parent chain per task
+//     (restore_task_chain); regs, FDs and FS pins come from the leaf only.
 //   - FS revert: for every fs_pin we call grahafs_revert_to_version which
 //     pushes a VE_FLAG_REVERT_CREATED entry making the pinned version the
 //     new HEAD.
@@ -29,7 +31,8 @@
 //
 // All page-restore loops are O(N_captured_pages) per task. Inside the
 // barrier, the only concurrent state mutator is the snap_create caller
-// itself — there is no preemption to worry about.
+// itself — there is no preemption to worry about. Phase 26: the caller
+// hands chunks of large page lists to the parked CPUs (restore_pages).
 
 #include "snapshot.h"
 
@@ -47,7 +50,9 @@
 
 #include "../../arch/x86_64/mm/vmm.h"
 #include "../../arch/x86_64/mm/pmm.h"
+#include "../../arch/x86_64/mm/tlb.h"
 #include "../../arch/x86_64/cpu/sched/sched.h"
+#include "../../arch/x86_64/cpu/smp.h"
 #include "../../arch/x86_64/cpu/interrupts.h"
 #include "../pid_hash.h"
 
@@ -61,6 +66,146 @@
 // from a PTE; see the explanation in capture.c.
 #define PHYS_ADDR_MASK  0x000FFFFFFFFFF000ULL
 
+// Phase 26: tasks with at least this many captured pages are restored in
+// RESTORE_CHUNK_PAGES chunks on the CPUs the barrier parks.
+#define RESTORE_PARALLEL_MIN   256u
+#define RESTORE_CHUNK_PAGES    256u
+
+typedef struct restore_stats {
+    uint64_t replaced;
+    uint64_t reflags;
+    uint64_t skipped;
+    uint64_t skipped_active_stack;
+} restore_stats_t;
+
+// Live frames a parallel chunk unmapped. Other CPUs may still hold TLB
+// entries for them until the chunk's batch is flushed, so their refs are
+// dropped only after that.
+typedef struct restore_unrefs {
+    uint32_t count;
+    uint64_t phys[RESTORE_CHUNK_PAGES];
+} restore_unrefs_t;
+
+// ---------------------------------------------------------------------------
+// Restore one captured page into a live task's CR3.
+//
+// With `batch` == NULL this is the serial path: any page table the remap
+// needs is allocated and a 2 MiB mapping in the way is split. With a batch
+// (a parallel chunk) the page is only handled when its live mapping is a
+// present 4 KiB PTE — the chunk then touches nothing but that PTE slot, so
+// chunks on other CPUs cannot race it — and the invalidations go to the
+// chunk's batch. Anything else returns false and is left to the owner.
+// A live frame unmapped under a batch goes to `unrefs`, which the caller
+// releases after tlb_batch_flush.
+// ---------------------------------------------------------------------------
+static bool restore_one_page(uint64_t cr3, const snap_captured_page_t *cap,
+                             uint64_t skip_page_va, tlb_batch_t *batch,
+                             restore_unrefs_t *unrefs, restore_stats_t *st) {
+    // Sanity: skip entries pointing at clearly bogus addresses.
+    if (cap->phys == 0) { st->skipped++; return true; }
+    // Phase 25 / FU24.I: skip the active stack page (in-flight syscall
+    // return frame lives here; rewriting would corrupt iretq's pop).
+    if (skip_page_va != 0 && cap->virt == skip_page_va) {
+        st->skipped_active_stack++;
+        return true;
+    }
+
+    uint64_t live_pte = vmm_get_pte(cr3, cap->virt);
+    uint64_t live_phys = live_pte & PHYS_ADDR_MASK;
+    if (batch && (!(live_pte & PTE_PRESENT) ||
+                  vmm_get_page_size(cr3, cap->virt) != PAGE_SIZE)) {
+        return false;
+    }
+    // Restore semantics: install captured phys at virt with the
+    // captured flags but force the writable bit clear so subsequent
+    // writes trigger cow_fault. The captured cow_page_tracker
+    // refcount keeps the page alive (already bumped at snap_create).
+    uint64_t restore_flags = (cap->flags & ~PTE_WRITABLE) | PTE_PRESENT;
+
+    if (live_pte != 0 && live_phys == cap->phys) {
+        // Already the same phys; just sync flags (might have been
+        // promoted to writable by cow_fault). Force RO so the
+        // snapshot-shared invariant is restored.
+        if (batch) (void)vmm_protect_page_batched(cr3, cap->virt, restore_flags, batch);
+        else       (void)vmm_protect_page_by_cr3(cr3, cap->virt, restore_flags);
+        st->reflags++;
+        return true;
+    }
+
+    // Different physical page — undo the COW. Unmap the live mapping
+    // (drops one pmm refcount on live_phys), bump pmm_page_ref on the
+    // captured phys (we are about to add a second reference besides
+    // the snapshot's), and map.
+    if (live_pte != 0) {
+        if (batch) {
+            (void)vmm_unmap_page_batched(cr3, cap->virt, batch);
+            unrefs->phys[unrefs->count++] = live_phys;
+        } else {
+            vmm_unmap_page_by_cr3(cr3, cap->virt);
+            pmm_page_unref((void *)live_phys);
+        }
+    }
+    // Bump pmm refcount for the parent's restored mapping. The
+    // snapshot already holds one ref; this adds the parent's ref
+    // back, which will be dropped if the parent later COWs.
+    pmm_page_ref((void *)cap->phys);
+    // The cow_page_tracker for this phys may still be live (we
+    // bumped it at snap_create). We re-bump so refcount reflects
+    // both the snapshot and the freshly-restored parent mapping.
+    cow_page_tracker_bump(cap->phys);
+
+    if (!vmm_map_page_by_cr3(cr3, cap->virt, cap->phys, restore_flags)) {
+        klog(KLOG_WARN, SUBSYS_CORE,
+             "snap_restore: vmm_map_page_by_cr3 failed va=0x%lx phys=0x%lx",
+             (unsigned long)cap->virt, (unsigned long)cap->phys);
+        // Roll back the bumps to keep accounting balanced.
+        cow_page_tracker_put(cap->phys);
+        pmm_page_unref((void *)cap->phys);
+        st->skipped++;
+        return true;
+    }
+    st->replaced++;
+    return true;
+}
+
+// One RESTORE_CHUNK_PAGES slice of a task's pages, run by snap_barrier_run.
+typedef struct restore_chunk_ctx {
+    snapshot_task_entry_t *te;
+    uint64_t               cr3;
+    uint64_t               skip_page_va;
+    uint8_t               *deferred;    // Per page: left for the owner.
+    restore_stats_t        stats;       // Summed atomically by the chunks.
+} restore_chunk_ctx_t;
+
+static void restore_chunk_fn(void *ctx, uint32_t item) {
+    restore_chunk_ctx_t *c = (restore_chunk_ctx_t *)ctx;
+    uint32_t first = item * RESTORE_CHUNK_PAGES;
+    uint32_t last  = first + RESTORE_CHUNK_PAGES;
+    if (last > c->te->page_count) last = c->te->page_count;
+
+    restore_stats_t st = { 0, 0, 0, 0 };
+    restore_unrefs_t unrefs;
+    unrefs.count = 0;
+    tlb_batch_t batch;
+    tlb_batch_init(&batch, c->cr3);
+    for (uint32_t i = first; i < last; i++) {
+        if (!restore_one_page(c->cr3, &c->te->pages[i], c->skip_page_va,
+                              &batch, &unrefs, &st)) {
+            c->deferred[i] = 1;
+        }
+    }
+    tlb_batch_flush(&batch);
+    for (uint32_t i = 0; i < unrefs.count; i++) {
+        pmm_page_unref((void *)unrefs.phys[i]);
+    }
+
+    __atomic_add_fetch(&c->stats.replaced, st.replaced, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&c->stats.reflags, st.reflags, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&c->stats.skipped, st.skipped, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&c->stats.skipped_active_stack,
+                       st.skipped_active_stack, __ATOMIC_RELAXED);
+}
+
 // ---------------------------------------------------------------------------
 // Restore captured pages into a live task's CR3.
 //
@@ -70,6 +215,10 @@
 // rounded down) so the in-flight syscall's user-mode return frame stays
 // intact. Pre-FU24.I callers passed 0; the SCOPE_SELF caller branch in
 // snap_restore now passes a real VA.
+//
+// Phase 26: large entries go through restore_chunk_fn on every parked CPU
+// first; the pages a chunk declined (no 4 KiB PTE to rewrite in place) are
+// then restored here, serially, since they may allocate or split tables.
 // ---------------------------------------------------------------------------
 static int restore_pages(snapshot_task_entry_t *te, task_t *live,
                          uint64_t skip_page_va) {
@@ -77,80 +226,64 @@ static int restore_pages(snapshot_task_entry_t *te, task_t *live,
     if (te->page_count == 0) return 0;
 
     uint64_t cr3 = live->cr3;
-    uint64_t restored = 0;
-    uint64_t replaced = 0;
-    uint64_t reflags  = 0;
-    uint64_t skipped  = 0;
-    uint64_t skipped_active_stack = 0;
-
-    for (uint32_t i = 0; i < te->page_count; i++) {
-        snap_captured_page_t *cap = &te->pages[i];
-        // Sanity: skip entries pointing at clearly bogus addresses.
-        if (cap->phys == 0) { skipped++; continue; }
-        // Phase 25 / FU24.I: skip the active stack page (in-flight syscall
-        // return frame lives here; rewriting would corrupt iretq's pop).
-        if (skip_page_va != 0 && cap->virt == skip_page_va) {
-            skipped_active_stack++;
-            continue;
-        }
-
-        uint64_t live_pte = vmm_get_pte(cr3, cap->virt);
-        uint64_t live_phys = live_pte & PHYS_ADDR_MASK;
-        // Restore semantics: install captured phys at virt with the
-        // captured flags but force the writable bit clear so subsequent
-        // writes trigger cow_fault. The captured cow_page_tracker
-        // refcount keeps the page alive (already bumped at snap_create).
-        uint64_t restore_flags = (cap->flags & ~PTE_WRITABLE) | PTE_PRESENT;
-
-        if (live_pte != 0 && live_phys == cap->phys) {
-            // Already the same phys; just sync flags (might have been
-            // promoted to writable by cow_fault). Force RO so the
-            // snapshot-shared invariant is restored.
-            (void)vmm_protect_page_by_cr3(cr3, cap->virt, restore_flags);
-            reflags++;
-            continue;
-        }
+    restore_chunk_ctx_t c = { .te = te, .cr3 = cr3,
+                              .skip_page_va = skip_page_va,
+                              .deferred = NULL };
+    if (te->page_count >= RESTORE_PARALLEL_MIN && g_cpu_count > 1) {
+        // On allocation failure the whole entry just goes serial.
+        c.deferred = (uint8_t *)kmalloc(te->page_count, SUBSYS_CORE);
+    }
 
-        // Different physical page — undo the COW. Unmap the live mapping
-        // (drops one pmm refcount on live_phys), bump pmm_page_ref on the
-        // captured phys (we are about to add a second reference besides
-        // the snapshot's), and map.
-        if (live_pte != 0) {
-            vmm_unmap_page_by_cr3(cr3, cap->virt);
-            pmm_page_unref((void *)live_phys);
+    if (c.deferred) {
+        memset(c.deferred, 0, te->page_count);
+        snap_barrier_run(restore_chunk_fn, &c,
+                         (te->page_count + RESTORE_CHUNK_PAGES - 1) /
+                             RESTORE_CHUNK_PAGES);
+        for (uint32_t i = 0; i < te->page_count; i++) {
+            if (c.deferred[i]) {
+                (void)restore_one_page(cr3, &te->pages[i], skip_page_va,
+                                       NULL, NULL, &c.stats);
+            }
         }
-        // Bump pmm refcount for the parent's restored mapping. The
-        // snapshot already holds one ref; this adds the parent's ref
-        // back, which will be dropped if the parent later COWs.
-        pmm_page_ref((void *)cap->phys);
-        // The cow_page_tracker for this phys may still be live (we
-        // bumped it at snap_create). We re-bump so refcount reflects
-        // both the snapshot and the freshly-restored parent mapping.
-        cow_page_tracker_bump(cap->phys);
-
-        if (!vmm_map_page_by_cr3(cr3, cap->virt, cap->phys, restore_flags)) {
-            klog(KLOG_WARN, SUBSYS_CORE,
-                 "snap_restore: vmm_map_page_by_cr3 failed va=0x%lx phys=0x%lx",
-                 (unsigned long)cap->virt, (unsigned long)cap->phys);
-            // Roll back the bumps to keep accounting balanced.
-            cow_page_tracker_put(cap->phys);
-            pmm_page_unref((void *)cap->phys);
-            skipped++;
-            continue;
+        kfree(c.deferred);
+    } else {
+        for (uint32_t i = 0; i < te->page_count; i++) {
+            (void)restore_one_page(cr3, &te->pages[i], skip_page_va,
+                                   NULL, NULL, &c.stats);
         }
-        replaced++;
-        restored++;
     }
 
     klog(KLOG_INFO, SUBSYS_CORE,
          "snap_restore: pid=%d pages=%u replaced=%lu reflagged=%lu "
          "skipped=%lu skipped_active_stack=%lu",
          (int)live->id, (unsigned)te->page_count,
-         (unsigned long)replaced, (unsigned long)reflags,
-         (unsigned long)skipped, (unsigned long)skipped_active_stack);
+         (unsigned long)c.stats.replaced, (unsigned long)c.stats.reflags,
+         (unsigned long)c.stats.skipped,
+         (unsigned long)c.stats.skipped_active_stack);
     return 0;
 }
 
+// ---------------------------------------------------------------------------
+// Phase 26: restore one task's pages through an incremental chain. A delta
+// entry only holds what changed since the parent, so the parent's entry for
+// the same pid is replayed first, oldest link first, and each newer link
+// overwrites the pages it recorded. The chain is bounded by
+// SNAP_CHAIN_DEPTH_MAX and pinned by the children counts.
+// ---------------------------------------------------------------------------
+static void restore_task_chain(snapshot_t *s, snapshot_task_entry_t *te,
+                               task_t *live, uint64_t skip_page_va) {
+    snapshot_task_entry_t *chain[SNAP_CHAIN_DEPTH_MAX + 1];
+    uint32_t n = 0;
+    chain[n++] = te;
+    while (te->delta && s->parent && n < SNAP_CHAIN_DEPTH_MAX + 1) {
+        s  = s->parent;
+        te = snap_find_task_entry(s, te->pid);
+        if (!te) break;
+        chain[n++] = te;
+    }
+    while (n > 0) (void)restore_pages(chain[--n], live, skip_page_va);
+}
+
 // ---------------------------------------------------------------------------
 // Restore a non-caller task's regs + FD table.
 // ---------------------------------------------------------------------------
@@ -222,7 +355,7 @@ int snap_restore_internal(snapshot_t *s, task_t *current) {
                 skip_va = current->syscall_frame_ptr->user_rsp &
                           ~((uint64_t)0xFFFu);
             }
-            (void)restore_pages(te, (task_t *)live, skip_va);
+            restore_task_chain(s, te, (task_t *)live, skip_va);
             // Copy FD table + pledge mask. Safe to do for the caller
             // because these don't affect iretq. Do NOT touch regs (the
             // syscall_frame on the kernel stack must keep its iretq path
@@ -234,7 +367,7 @@ int snap_restore_internal(snapshot_t *s, task_t *current) {
             ((task_t *)live)->pledge_mask.raw = te->pledge_snapshot;
             continue;
         }
-        (void)restore_pages(te, (task_t *)live, /*skip_page_va=*/0);
+        restore_task_chain(s, te, (task_t *)live, /*skip_page_va=*/0);
         restore_regs_and_fds(te, (task_t *)live);
     }
 
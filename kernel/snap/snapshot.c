@@ -131,6 +131,19 @@ static void snap_unlink_locked(snapshot_t *s) {
 // ---------------------------------------------------------------------------
 int snap_create_internal(uint32_t scope_flags, const char *name,
                          snapshot_t **out_snap) {
+    return snap_create_child_internal(scope_flags, name, NULL, out_snap);
+}
+
+// Phase 26: drop s's reference on its parent (incremental chain).
+static void snap_release_parent(snapshot_t *s) {
+    spinlock_acquire(&g_snap_live_lock);
+    if (s->parent && s->parent->children) s->parent->children--;
+    s->parent = NULL;
+    spinlock_release(&g_snap_live_lock);
+}
+
+int snap_create_child_internal(uint32_t scope_flags, const char *name,
+                               snapshot_t *parent, snapshot_t **out_snap) {
     if (out_snap) *out_snap = NULL;
     if (!snap_cache) return -SNAP_EINVAL;
 
@@ -138,6 +151,7 @@ int snap_create_internal(uint32_t scope_flags, const char *name,
     if ((scope_flags & (SNAP_SCOPE_SELF | SNAP_SCOPE_GLOBAL)) == 0) {
         return -SNAP_EINVAL;
     }
+    if (!(scope_flags & SNAP_SCOPE_INCREMENTAL) != !parent) return -SNAP_EINVAL;
 
     task_t *current = sched_get_current_task();
     if (!current) return -SNAP_EPERM;
@@ -146,6 +160,26 @@ int snap_create_internal(uint32_t scope_flags, const char *name,
     if (!s) return -SNAP_ENOMEM;
 
     memset(s, 0, sizeof(*s));
+
+    // Pin the parent before the capture reads its task entries. A chain
+    // already SNAP_CHAIN_DEPTH_MAX deep is not extended; the request is
+    // served by a full capture instead.
+    if (parent) {
+        spinlock_acquire(&g_snap_live_lock);
+        if (parent->state != SNAP_STATE_ACTIVE) {
+            spinlock_release(&g_snap_live_lock);
+            kmem_cache_free(snap_cache, s);
+            return -SNAP_EBUSY;
+        }
+        if (parent->depth + 1 > SNAP_CHAIN_DEPTH_MAX) {
+            scope_flags &= ~SNAP_SCOPE_INCREMENTAL;
+        } else {
+            parent->children++;
+            s->parent = parent;
+            s->depth  = parent->depth + 1;
+        }
+        spinlock_release(&g_snap_live_lock);
+    }
     s->scope_flags = scope_flags;
     s->state       = SNAP_STATE_ACTIVE;
     s->creator_pid = current->id;
@@ -166,6 +200,7 @@ int snap_create_internal(uint32_t scope_flags, const char *name,
     // Capture under the scheduler barrier (same as snap_create).
     int barrier_rc = snap_begin_barrier();
     if (barrier_rc != 0) {
+        snap_release_parent(s);
         kmem_cache_free(snap_cache, s);
         klog(KLOG_WARN, SUBSYS_CORE,
              "snap_create_internal: snap_begin_barrier rc=%d", barrier_rc);
@@ -177,6 +212,7 @@ int snap_create_internal(uint32_t scope_flags, const char *name,
 
     if (cap_rc < 0) {
         snap_destroy_captures(s);
+        snap_release_parent(s);
         kmem_cache_free(snap_cache, s);
         klog(KLOG_WARN, SUBSYS_CORE,
              "snap_create_internal: snap_run_capture rc=%d", cap_rc);
@@ -189,10 +225,14 @@ int snap_create_internal(uint32_t scope_flags, const char *name,
 
     if (out_snap) *out_snap = s;
 
+    uint64_t inherited = 0;
+    for (uint32_t i = 0; i < s->task_count; i++) inherited += s->tasks[i].pages_inherited;
     klog(KLOG_INFO, SUBSYS_CORE,
-         "snap_create_internal: id=%lu pid=%d scope=0x%x tasks=%u pages=%lu fs_pins=%u name='%s'",
+         "snap_create_internal: id=%lu pid=%d scope=0x%x tasks=%u pages=%lu inherited=%lu parent=%lu fs_pins=%u name='%s'",
          (unsigned long)id, current->id, (unsigned)scope_flags,
          (unsigned)s->task_count, (unsigned long)s->pages_shared,
+         (unsigned long)inherited,
+         (unsigned long)(s->parent ? s->parent->id : 0),
          (unsigned)s->fs_pin_count, s->name);
     return 0;
 }
@@ -213,6 +253,7 @@ void snap_destroy_internal(snapshot_t *s) {
     spinlock_release(&g_snap_live_lock);
 
     snap_destroy_captures(s);
+    snap_release_parent(s);
     kmem_cache_free(snap_cache, s);
 }
 
@@ -222,20 +263,27 @@ void snap_destroy_internal(snapshot_t *s) {
 // a handle in the caller's table. Stage D refactor: every behavioural
 // change goes in snap_create_internal so txn_begin shares it.
 // ---------------------------------------------------------------------------
-int snap_create(uint32_t scope_flags, const char *name) {
+int snap_create(uint32_t scope_flags, const char *name, uint32_t parent_handle) {
+    task_t *current = sched_get_current_task();
+    if (!current) return -SNAP_EPERM;
+
+    // Phase 26: resolve the delta parent from the caller's own handle.
+    snapshot_t *parent = NULL;
+    if (scope_flags & SNAP_SCOPE_INCREMENTAL) {
+        cap_handle_entry_t *pe = cap_handle_lookup(&current->cap_handles,
+                                                   parent_handle);
+        if (!pe) return -SNAP_EINVAL;
+        cap_object_t *pobj = cap_object_get(pe->object_idx);
+        if (!pobj || pobj->kind != CAP_KIND_SNAPSHOT) return -SNAP_EINVAL;
+        parent = (snapshot_t *)pobj->kind_data;
+        if (!parent) return -SNAP_EINVAL;
+    }
+
     snapshot_t *s = NULL;
-    int rc = snap_create_internal(scope_flags, name, &s);
+    int rc = snap_create_child_internal(scope_flags, name, parent, &s);
     if (rc < 0) return rc;
     if (!s) return -SNAP_EINVAL;
 
-    task_t *current = sched_get_current_task();
-    if (!current) {
-        // Should not happen — snap_create_internal already checked. Guard
-        // anyway so we don't leak the snapshot on the impossible path.
-        snap_destroy_internal(s);
-        return -SNAP_EPERM;
-    }
-
     // Allocate the kernel-side cap_object. W19.4: snapshot tokens carry
     // RIGHT_RESTORE + RIGHT_DELETE alongside RIGHT_INSPECT / RIGHT_REVOKE
     // / RIGHT_DERIVE.
@@ -297,24 +345,30 @@ int snap_delete(uint32_t handle) {
     snapshot_t *s = (snapshot_t *)obj->kind_data;
     if (!s) return -SNAP_EINVAL;
     if (s->state == SNAP_STATE_RESTORING) return -SNAP_EBUSY;
-
     // Capture identifiers before any frees: entry points into a slot that
     // we're about to release, and obj/s themselves get freed below.
     uint32_t obj_idx = entry->object_idx;
     uint64_t snap_id = s->id;
 
-    // 1. Drop the caller's handle FIRST so concurrent syscalls on this
-    //    pid cannot resolve the token after this point.
-    cap_handle_remove(&current->cap_handles, handle);
-
-    // 2. Mark deleted + unlink under the live list lock. Concurrent
+    // 1. Mark deleted + unlink under the live list lock. Concurrent
     //    snap_list readers either see state == ACTIVE before this point
     //    (and copy out the record) or state == DELETED after (and skip).
+    //    Phase 26: refuse while an incremental child still restores
+    //    through our pages; the same lock section keeps a new child from
+    //    pinning us after the check.
     spinlock_acquire(&g_snap_live_lock);
+    if (s->children != 0) {
+        spinlock_release(&g_snap_live_lock);
+        return -SNAP_EBUSY;
+    }
     s->state = SNAP_STATE_DELETED;
     snap_unlink_locked(s);
     spinlock_release(&g_snap_live_lock);
 
+    // 2. Drop the caller's handle so concurrent syscalls on this pid
+    //    cannot resolve the token after this point.
+    cap_handle_remove(&current->cap_handles, handle);
+
     // 3. Revoke + destroy the cap_object. cap_object_destroy slab-frees
     //    the kernel-side cap_object_t; the snapshot body is freed last
     //    so nothing dereferences a stale obj->kind_data.
@@ -326,6 +380,7 @@ int snap_delete(uint32_t handle) {
     // physical pages are reclaimable by the page allocator and the
     // grahafs version chains can be GC'd by gc_prune_inode.
     snap_destroy_captures(s);
+    snap_release_parent(s);
 
     klog(KLOG_INFO, SUBSYS_CORE,
          "snap_delete: id=%lu pid=%d slot=%u",
@@ -29,9 +29,11 @@
 #define SNAP_SCOPE_SELF             0x00000001u   // Caller's process tree only
 #define SNAP_SCOPE_GLOBAL           0x00000002u   // Every task (requires CAP_KIND_SYSTEM)
 #define SNAP_SCOPE_FREEZE_ALL_CHANS 0x00000004u   // Freeze even out-of-scope-peer chans
+#define SNAP_SCOPE_INCREMENTAL      0x00000008u   // Delta against a parent snapshot (Phase 26)
 #define SNAP_SCOPE_VALID_MASK       (SNAP_SCOPE_SELF | \
                                      SNAP_SCOPE_GLOBAL | \
-                                     SNAP_SCOPE_FREEZE_ALL_CHANS)
+                                     SNAP_SCOPE_FREEZE_ALL_CHANS | \
+                                     SNAP_SCOPE_INCREMENTAL)
 
 // ---------------------------------------------------------------------------
 // Lifecycle states (snapshot_t.state).
@@ -52,6 +54,10 @@
 #define SNAP_MAX_LIVE         128u   // System-wide concurrent live snapshots
 #define SNAP_NAME_MAX_LEN     31u    // + 1 for null terminator
 #define SNAP_BARRIER_TIMEOUT_NS  100000000ULL  // 100 ms watchdog (AW-24.4)
+// Phase 26: longest parent chain behind an incremental snapshot. Restore
+// replays every link, so a request that would exceed it takes a full
+// capture instead (and drops SNAP_SCOPE_INCREMENTAL from its scope_flags).
+#define SNAP_CHAIN_DEPTH_MAX  16u
 
 // ---------------------------------------------------------------------------
 // snap_captured_page_t — one record per user-half PTE captured at snap time.
@@ -96,6 +102,14 @@ typedef struct snapshot_task_entry {
     snap_captured_page_t *pages;        // kheap array; NULL if empty.
     uint32_t              page_count;   // Used entries in pages[].
     uint32_t              page_cap;     // Allocated entries in pages[].
+    // Phase 26 incremental capture. A delta entry records only the pages
+    // that changed since the parent snapshot's entry for the same pid;
+    // the other `pages_inherited` pages are still the parent's frames and
+    // restore replays the parent chain first. unmap_gen is the task's
+    // snap_unmap_gen at capture.
+    uint32_t              delta;        // 1 if pages[] is relative to the parent
+    uint32_t              pages_inherited;
+    uint64_t              unmap_gen;
 } snapshot_task_entry_t;
 
 // ---------------------------------------------------------------------------
@@ -128,7 +142,8 @@ typedef struct snapshot_fs_pin {
 
 // ---------------------------------------------------------------------------
 // cow_page_tracker_t — refcount record per shared physical page (W15).
-// Linked into a hash bucket keyed on (phys_page >> 12) & (COW_HASH_BUCKETS-1).
+// Linked into a hash bucket keyed on (phys_page >> 12) & (COW_HASH_BUCKETS-1);
+// each bucket has its own lock (Phase 26).
 // ---------------------------------------------------------------------------
 struct cow_page_tracker;
 typedef struct cow_page_tracker {
@@ -144,6 +159,10 @@ typedef struct cow_page_tracker {
 // by snap_barrier_state_t.lock.
 // ---------------------------------------------------------------------------
 struct task_struct;
+
+// Phase 26: one item of barrier work (see snap_barrier_run).
+typedef void (*snap_work_fn_t)(void *ctx, uint32_t item);
+
 typedef struct snap_barrier_state {
     volatile uint32_t barrier_flag;     // 0 = normal, 1 = snapshot in progress.
     volatile uint32_t acks;             // Per-CPU ack count (info only).
@@ -152,6 +171,18 @@ typedef struct snap_barrier_state {
     struct task_struct *parked_head;    // Singly-linked via task->barrier_next.
     struct task_struct *owner_task;     // The snap_create caller (skip-park).
     uint32_t           barrier_seq;     // Bumped each begin; per-CPU dedup.
+
+    // Phase 26: work shared with the CPUs the barrier leaves idle. The
+    // owner fills ctx/items and resets the counters, then publishes
+    // work_fn (release); idle loops claim items with work_next. All
+    // lock-free — helpers run with interrupts enabled in their idle task.
+    snap_work_fn_t     work_fn;         // NULL = nothing to help with.
+    void              *work_ctx;
+    uint32_t           work_items;
+    volatile uint32_t  work_next;       // Next unclaimed item.
+    volatile uint32_t  work_done;       // Items finished.
+    volatile uint32_t  work_helpers;    // CPUs inside snap_barrier_help.
+    volatile uint64_t  work_items_helped;  // Lifetime items run off-owner.
 } snap_barrier_state_t;
 
 // ---------------------------------------------------------------------------
@@ -182,6 +213,14 @@ typedef struct snapshot {
     uint32_t                  state;
     char                      name[SNAP_NAME_MAX_LEN + 1];
 
+    // Phase 26 incremental chain. `parent` is pinned while this snapshot
+    // lives: snap_delete of a snapshot with children returns -EBUSY.
+    // depth is 0 for a full snapshot. Both children and the links are
+    // protected by the live-list lock.
+    struct snapshot          *parent;
+    uint32_t                  children;
+    uint32_t                  depth;
+
     // Linkage in the global live-snapshot list (g_snap_live_head). NULL if
     // this is the tail or the snapshot has been removed.
     struct snapshot          *next;
@@ -229,7 +268,9 @@ void snap_init(void);
 // On success returns the cap_handle slot installed in the caller's
 // handle table; on error, a negative -errno (EINVAL, EPERM, ENOMEM,
 // EBUSY, ETIME). W14 implementation; W13 stub returns -ENOSYS.
-int snap_create(uint32_t scope_flags, const char *name);
+// Phase 26: with SNAP_SCOPE_INCREMENTAL, parent_handle names the caller's
+// CAP_KIND_SNAPSHOT to take the delta against; otherwise it is ignored.
+int snap_create(uint32_t scope_flags, const char *name, uint32_t parent_handle);
 
 // Phase 25 — kernel-internal entry. Same capture semantics as snap_create
 // but does NOT create a cap_object + does NOT insert a handle into the
@@ -241,6 +282,13 @@ int snap_create(uint32_t scope_flags, const char *name);
 int snap_create_internal(uint32_t scope_flags, const char *name,
                          struct snapshot **out_snap);
 
+// Phase 26 — snap_create_internal with a parent for SNAP_SCOPE_INCREMENTAL
+// (NULL otherwise). The parent must be SNAP_STATE_ACTIVE; it gains a child
+// reference that the new snapshot drops when it is destroyed.
+int snap_create_child_internal(uint32_t scope_flags, const char *name,
+                               struct snapshot *parent,
+                               struct snapshot **out_snap);
+
 // Phase 25 — kernel-internal counterpart of snap_delete.
 // Drops the snapshot's live-list entry, reclaims captured pages via
 // snap_destroy_captures, and frees the body. Caller has already
@@ -258,7 +306,8 @@ int snap_restore_internal(struct snapshot *s, struct task_struct *caller);
 int snap_restore(uint32_t handle);
 
 // Release the snapshot and reclaim any uniquely-referenced pages.
-// W17 implementation; W13 stub returns -ENOSYS.
+// W17 implementation; W13 stub returns -ENOSYS. Phase 26: -EBUSY while
+// an incremental snapshot still names it as parent.
 int snap_delete(uint32_t handle);
 
 // Enumerate live snapshots into the caller's buffer. Returns the
@@ -280,6 +329,16 @@ void snap_end_barrier(void);
 // the barrier lock). Defined in kernel/snap/barrier.c.
 void snap_barrier_park_locked(struct task_struct *cur);
 
+// Phase 26: run fn(ctx, i) for every i < n_items on the owner CPU and on
+// every CPU the barrier has parked in its idle task, returning once all
+// items are done. Owner only, inside the barrier window. Items must not
+// block; they may take spinlocks and shoot down TLBs.
+void snap_barrier_run(snap_work_fn_t fn, void *ctx, uint32_t n_items);
+
+// Phase 26: idle-loop hook. Claims and runs published barrier work; a
+// single relaxed load when there is none.
+void snap_barrier_help(void);
+
 // W14.3-W14.7 capture orchestrator + rollback (defined in capture.c).
 // snap_run_capture is invoked by snap_create after snap_begin_barrier;
 // snap_destroy_captures rolls back every capture-side ref taken by
@@ -289,6 +348,9 @@ void snap_barrier_park_locked(struct task_struct *cur);
 int  snap_run_capture(struct snapshot *snap, struct task_struct *self);
 void snap_destroy_captures(struct snapshot *snap);
 
+// Phase 26: the entry for `pid` in snap->tasks, or NULL.
+snapshot_task_entry_t *snap_find_task_entry(struct snapshot *snap, int32_t pid);
+
 // Pre-Phase-28 sweep B.3 (FU25.A.3) — append a single (inode, version)
 // pin to a SNAP_STATE_ACTIVE snapshot's fs_pins[] mid-flight. Used by the
 // SYS_TXN_PIN_PATH syscall so userspace can request a pin captured for
@@ -310,6 +372,11 @@ int  cow_fault_handle(uint64_t fault_addr, uint64_t error_code,
 cow_page_tracker_t *cow_page_tracker_get(uint64_t phys);
 void                cow_page_tracker_put(uint64_t phys);
 void                cow_page_tracker_bump(uint64_t phys);
+// Phase 26: bump the trackers of n captured pages, allocating the missing
+// ones in batches outside the bucket locks. Used by the parallel capture
+// walk, where each CPU stages its pages privately and publishes them in bulk.
+void                cow_page_tracker_bump_many(const snap_captured_page_t *pages,
+                                               uint32_t n);
 
 // Channel freeze/thaw/drain helpers (W18).
 int  chan_freeze(uint64_t chan_id, uint64_t snap_id);
@@ -100,6 +100,10 @@ void state_collect_system(state_system_t *out) {
         out->cpus[i].ctx_switches    = rq->context_switches;
         out->cpus[i].steal_successes = rq->steal_successes;
         out->cpus[i].steal_failures  = rq->steal_failures;
+        out->cpus[i].handoff_local       = rq->handoff_local;
+        out->cpus[i].handoff_ipi_idle    = rq->handoff_ipi_idle;
+        out->cpus[i].handoff_migrate     = rq->handoff_migrate;
+        out->cpus[i].handoff_ipi_preempt = rq->handoff_ipi_preempt;
         task_t *cur = rq->current;
         out->cpus[i].current_pid = cur ? cur->id : -1;
     }
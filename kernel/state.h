@@ -112,6 +112,8 @@ typedef struct {
     //   ctx_switches      - per-CPU context switch counter (runq.context_switches)
     //   steal_successes   - count of successful work-steals AS THIEF on this CPU
     //   steal_failures    - trylock failures during work-steal attempts
+    //   handoff_*         - Phase 26: IPC wake handoff choices made with
+    //                       this CPU as the waker (runq.handoff_*)
     // Older userspace that reads only lapic_id+active keeps working; the
     // psinfo --per-cpu builtin in gash reads the full struct.
     struct {
@@ -122,6 +124,10 @@ typedef struct {
         uint64_t ctx_switches;
         uint64_t steal_successes;
         uint64_t steal_failures;
+        uint64_t handoff_local;
+        uint64_t handoff_ipi_idle;
+        uint64_t handoff_migrate;
+        uint64_t handoff_ipi_preempt;
     } cpus[STATE_MAX_CPUS];
     uint32_t cpu_entries;
     uint32_t _pad;
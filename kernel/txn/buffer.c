@@ -7,8 +7,9 @@
 //
 // The buffer is a kernel-only VMO allocated lazily on the first external
 // send (Plan-agent Q5: most txns have no external sends; deferring the
-// VMO creation until needed avoids paying the 4-MiB allocation cost
-// universally). Layout per record:
+// VMO creation until needed avoids paying the allocation cost
+// universally). Phase 26: it starts at TXN_BUFFER_INITIAL_BYTES and
+// doubles through vmo_grow up to t->buffer_vmo_limit. Layout per record:
 //
 //   [HEAD MAGIC u32 0xBEADF00D] [target_chan_id u64] [payload_len u32]
 //   [flags u32] [original_send_seq u64] [payload bytes ROUND_UP_8]
@@ -47,9 +48,9 @@
 #include "../../arch/x86_64/mm/vmm.h"   // g_hhdm_offset
 
 // ---------------------------------------------------------------------------
-// Page-walk helpers. The VMO holds 1024 separately-allocated 4 KiB pages
-// (2 MiB → 512 pages, 4 MiB → 1024 pages, 8 MiB → 2048 pages). Each page
-// is reachable via the higher-half direct map at phys + g_hhdm_offset.
+// Page-walk helpers. The VMO holds separately-allocated 4 KiB pages
+// (64 KiB → 16 pages, 4 MiB → 1024 pages, ...). Each page is reachable
+// via the higher-half direct map at phys + g_hhdm_offset.
 // We never need more than two adjacent pages for any single record (max
 // record size = 32 + 320 + 4 = 356 bytes ≪ 4096), so the per-page split
 // only matters when an entry crosses a page boundary.
@@ -110,10 +111,13 @@ static int txn_buffer_lazy_alloc(transaction_t *t) {
     if (!t) return TXN_EINVAL;
     if (t->buffer_vmo) return 0;
 
-    uint32_t cap = t->buffer_vmo_capacity;
-    if (cap == 0) cap = TXN_DEFAULT_BUFFER_BYTES;
+    uint32_t limit = t->buffer_vmo_limit;
+    if (limit == 0) limit = TXN_DEFAULT_BUFFER_BYTES;
     // Round up to PAGE_SIZE (vmo_create requires that).
-    if (cap & 0xFFFu) cap = (cap + 0xFFFu) & ~0xFFFu;
+    if (limit & 0xFFFu) limit = (limit + 0xFFFu) & ~0xFFFu;
+    t->buffer_vmo_limit = limit;
+    uint32_t cap = limit < TXN_BUFFER_INITIAL_BYTES ? limit
+                                                    : TXN_BUFFER_INITIAL_BYTES;
 
     // Owner = -1 (PID_NONE), audience = -1 — kernel-only, no userspace map.
     // VMO_ZEROED so iterator never reads uninitialised bytes for a partial
@@ -128,6 +132,21 @@ static int txn_buffer_lazy_alloc(transaction_t *t) {
     return 0;
 }
 
+// Phase 26: make room for `need` more bytes, doubling the VMO up to the
+// limit. Returns 0, -ENOSPC at the limit, or TXN_ENOMEM.
+static int txn_buffer_reserve(transaction_t *t, uint32_t need) {
+    uint64_t want = (uint64_t)t->buffer_vmo_head + need;
+    if (want <= t->buffer_vmo_capacity) return 0;
+    if (want > t->buffer_vmo_limit) return -28;  // -ENOSPC
+
+    uint64_t cap = t->buffer_vmo_capacity;
+    while (cap < want) cap *= 2u;
+    if (cap > t->buffer_vmo_limit) cap = t->buffer_vmo_limit;
+    if (vmo_grow(t->buffer_vmo, cap) < 0) return TXN_ENOMEM;
+    t->buffer_vmo_capacity = (uint32_t)cap;
+    return 0;
+}
+
 // ---------------------------------------------------------------------------
 // txn_buffer_append — invoked by chan_send when peer is external for `t`.
 //
@@ -161,9 +180,8 @@ int txn_buffer_append(transaction_t *t, uint64_t target_chan_id,
                                    + (uint32_t)sizeof(uint32_t);
 
     // Capacity check (Plan-agent Q5): strict-greater so we never overrun.
-    if ((uint64_t)t->buffer_vmo_head + entry_size > t->buffer_vmo_capacity) {
-        return -28;  // -ENOSPC
-    }
+    rc = txn_buffer_reserve(t, entry_size);
+    if (rc < 0) return rc;
 
     uint32_t off = t->buffer_vmo_head;
 
@@ -256,6 +274,17 @@ int txn_buffer_iter_next(txn_replay_context_t *ctx,
     return 0;
 }
 
+// Phase 26: flag the record at rec_offset delivered (see
+// TXN_BUFFER_REC_DELIVERED). hdr is the header txn_buffer_iter_next read.
+void txn_buffer_mark_delivered(transaction_t *t, uint32_t rec_offset,
+                               const buffered_msg_header_t *hdr) {
+    if (!t || !t->buffer_vmo || !hdr) return;
+    uint32_t flags = hdr->flags | TXN_BUFFER_REC_DELIVERED;
+    txn_buffer_write_bytes(t->buffer_vmo,
+                           rec_offset + (uint32_t)offsetof(buffered_msg_header_t, flags),
+                           &flags, (uint32_t)sizeof(flags));
+}
+
 // ---------------------------------------------------------------------------
 // txn_buffer_free_drop — release the buffer VMO and clear counters.
 // Idempotent (safe to call when buffer was never allocated). Called from
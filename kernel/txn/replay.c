@@ -18,8 +18,10 @@
 //      remaining > 0 — i.e., some packets were already on the wire.
 //
 // Stall path: chan_lookup_by_id returns NULL (channel destroyed) or
-// chan_send returns < 0. We save ctx->failed_chan_id + ctx->current_offset
+// the send fails. We save ctx->failed_chan_id + ctx->current_offset
 // so a subsequent SYS_TXN_COMMIT call can resume from where we stopped.
+// Phase 26: replay is grouped per channel (see txn_replay_all), so a
+// stall only holds back the stalled channel's records.
 // If the user gives up and aborts, the rollback warning fires with the
 // (delivered, remaining) split.
 
@@ -33,84 +35,253 @@
 #include "../audit.h"
 #include "../ipc/channel.h"
 #include "../log.h"
+#include "../mm/kheap.h"
 
 #include "../../arch/x86_64/cpu/sched/sched.h"
 
-// ---------------------------------------------------------------------------
-// txn_replay_all — drain every buffered record into its target channel.
-//
-// Returns 0 on full drain; TXN_ETXNREPLAY (-200) on stall (caller may
-// retry or abort); TXN_EINVAL on internal magic mismatch (corrupted
-// buffer — shouldn't happen).
-//
-// The iter is initialised by txn_replay_all on first entry; on retry,
-// callers pass the same ctx without re-init so current_offset / delivered
-// persist across calls. txn_replay_resume is a thin alias used by Stage F
-// retry tests for clarity.
-// ---------------------------------------------------------------------------
-int txn_replay_all(transaction_t *t, txn_replay_context_t *ctx, task_t *caller) {
-    if (!t || !ctx || !caller) return TXN_EINVAL;
-    if (!t->buffer_vmo || t->buffered_count == 0) {
-        // Nothing to replay; trivial success.
-        ctx->delivered_count = 0;
-        return 0;
-    }
+// Phase 26: messages per chan_send_batch call during grouped replay.
+#define TXN_REPLAY_BATCH   8u
 
-    // Set the per-task bypass so chan_send's prologue does NOT re-buffer
-    // these sends into the active_txn. The flag is RELEASE-stored so
-    // observers (other CPUs scheduling chan_send concurrently) see it.
-    __atomic_store_n(&caller->replay_in_progress, 1u, __ATOMIC_RELEASE);
+// Per-target-channel group. Its records are chained through rec_next in
+// buffer order, which is the only order replay has to preserve.
+typedef struct txn_replay_group {
+    uint64_t chan_id;
+    uint32_t head;          // first record index
+    uint32_t tail;          // last record index
+    uint32_t hnext;         // next group in the same hash slot, or NONE
+} txn_replay_group_t;
+
+#define TXN_REPLAY_HASH    64u
+#define TXN_REPLAY_NONE    0xFFFFFFFFu
+
+typedef struct txn_replay_index {
+    uint32_t           *rec_off;    // record byte offsets, buffer order
+    uint32_t           *rec_next;   // next record of the same group
+    uint8_t            *rec_done;   // delivered during this call
+    txn_replay_group_t *groups;     // in order of first appearance
+    uint32_t            n_recs;
+    uint32_t            n_groups;
+    uint32_t            hash[TXN_REPLAY_HASH];
+    channel_msg_t       msgs[TXN_REPLAY_BATCH];
+} txn_replay_index_t;
 
+// Read one record header + payload at `off`. Returns iter_next's code.
+static int txn_replay_read(transaction_t *t, uint32_t off,
+                           buffered_msg_header_t *hdr, channel_msg_t *payload,
+                           uint32_t *next_off) {
+    txn_replay_context_t it = { .txn = t, .current_offset = off };
+    return txn_buffer_iter_next(&it, hdr, payload, next_off);
+}
+
+// ---------------------------------------------------------------------------
+// Serial replay: the Stage F loop, one chan_send per record, stopping at
+// the first stall. Used when the grouping index cannot be allocated.
+// Records an earlier grouped attempt delivered are skipped.
+// ---------------------------------------------------------------------------
+static int txn_replay_serial(transaction_t *t, txn_replay_context_t *ctx,
+                             task_t *caller) {
     int last_rc = 0;
-    while (ctx->current_offset < t->buffer_vmo_head) {
+    uint32_t off = ctx->current_offset;
+    bool prefix = true;     // still inside the delivered prefix
+    while (off < t->buffer_vmo_head) {
         buffered_msg_header_t hdr;
         channel_msg_t payload;
-        uint32_t next_offset = ctx->current_offset;
+        uint32_t next_offset = off;
 
-        ctx->failed_chan_id = 0;
-        int rc = txn_buffer_iter_next(ctx, &hdr, &payload, &next_offset);
+        int rc = txn_replay_read(t, off, &hdr, &payload, &next_offset);
         if (rc < 0) {
             // Buffer corruption (magic mismatch) or end-of-data sentinel.
             // Treat ENODATA (-61) as full drain; anything else as stall.
-            if (rc == -61) { last_rc = 0; break; }
-            last_rc = rc;
+            if (rc != -61) last_rc = rc;
             break;
         }
+        if (hdr.flags & TXN_BUFFER_REC_DELIVERED) {
+            off = next_offset;
+            if (prefix) ctx->current_offset = off;
+            continue;
+        }
 
         // Resolve the target channel. If it was destroyed mid-txn, mark
         // failure and exit (the caller can either retry once the channel
         // is recreated or abort).
         channel_t *c = chan_lookup_by_id(hdr.target_chan_id);
-        if (!c) {
-            ctx->failed_chan_id = hdr.target_chan_id;
-            last_rc = TXN_ETXNREPLAY;
-            klog(KLOG_WARN, SUBSYS_CORE,
-                 "txn_replay_all: target chan_id=%lu not found at offset=%u",
-                 (unsigned long)hdr.target_chan_id,
-                 (unsigned)ctx->current_offset);
-            break;
-        }
-
         // Re-run chan_send. With replay_in_progress=1 the prologue falls
         // through to the live ring directly. timeout_ns=0 to avoid blocking
         // the caller indefinitely if the receiver is gone.
-        int srv = chan_send(c, caller, &payload, /*timeout_ns=*/0);
+        int srv = c ? chan_send(c, caller, &payload, /*timeout_ns=*/0)
+                    : TXN_ETXNREPLAY;
         if (srv < 0) {
-            // Receiver gone, full ring on a non-blocking peer, or any other
-            // chan_send failure. Save failed chan + cursor for retry.
             ctx->failed_chan_id = hdr.target_chan_id;
             last_rc = TXN_ETXNREPLAY;
             klog(KLOG_WARN, SUBSYS_CORE,
-                 "txn_replay_all: chan_send rc=%d on chan_id=%lu offset=%u",
-                 srv, (unsigned long)hdr.target_chan_id,
-                 (unsigned)ctx->current_offset);
+                 "txn_replay_all: chan_id=%lu %s at offset=%u (rc=%d)",
+                 (unsigned long)hdr.target_chan_id,
+                 c ? "send failed" : "not found", (unsigned)off, srv);
             break;
         }
 
-        ctx->current_offset = next_offset;
+        txn_buffer_mark_delivered(t, off, &hdr);
         ctx->delivered_count++;
+        off = next_offset;
+        if (prefix) ctx->current_offset = off;
+    }
+    return last_rc;
+}
+
+// Index every undelivered record from ctx->current_offset on into its
+// channel group. Returns 0 or the iterator's corruption code.
+static int txn_replay_build_index(transaction_t *t, txn_replay_context_t *ctx,
+                                  txn_replay_index_t *ix, uint32_t max_recs) {
+    for (uint32_t h = 0; h < TXN_REPLAY_HASH; h++) ix->hash[h] = TXN_REPLAY_NONE;
+    uint32_t off = ctx->current_offset;
+    while (off < t->buffer_vmo_head && ix->n_recs < max_recs) {
+        buffered_msg_header_t hdr;
+        uint32_t next_offset = off;
+        int rc = txn_replay_read(t, off, &hdr, &ix->msgs[0], &next_offset);
+        if (rc == -61) break;
+        if (rc < 0) return rc;
+        if (hdr.flags & TXN_BUFFER_REC_DELIVERED) { off = next_offset; continue; }
+
+        uint32_t r = ix->n_recs++;
+        ix->rec_off[r]  = off;
+        ix->rec_next[r] = TXN_REPLAY_NONE;
+        ix->rec_done[r] = 0;
+
+        uint32_t h = (uint32_t)(hdr.target_chan_id * 0x9E3779B97F4A7C15ull >> 58);
+        uint32_t g = ix->hash[h];
+        while (g != TXN_REPLAY_NONE && ix->groups[g].chan_id != hdr.target_chan_id) {
+            g = ix->groups[g].hnext;
+        }
+        if (g == TXN_REPLAY_NONE) {
+            g = ix->n_groups++;
+            ix->groups[g].chan_id = hdr.target_chan_id;
+            ix->groups[g].head    = r;
+            ix->groups[g].hnext   = ix->hash[h];
+            ix->hash[h] = g;
+        } else {
+            ix->rec_next[ix->groups[g].tail] = r;
+        }
+        ix->groups[g].tail = r;
+        off = next_offset;
+    }
+    return 0;
+}
+
+// Deliver one channel's records in order, TXN_REPLAY_BATCH per lock hold.
+// Returns false if the channel stalled (records from the stall on stay
+// buffered for the retry).
+static bool txn_replay_group(transaction_t *t, txn_replay_context_t *ctx,
+                             txn_replay_index_t *ix, txn_replay_group_t *g,
+                             task_t *caller) {
+    channel_t *c = chan_lookup_by_id(g->chan_id);
+    if (!c) {
+        klog(KLOG_WARN, SUBSYS_CORE,
+             "txn_replay_all: target chan_id=%lu not found at offset=%u",
+             (unsigned long)g->chan_id, (unsigned)ix->rec_off[g->head]);
+        return false;
+    }
+
+    buffered_msg_header_t hdrs[TXN_REPLAY_BATCH];
+    uint32_t              recs[TXN_REPLAY_BATCH];
+    uint32_t r = g->head;
+    while (r != TXN_REPLAY_NONE) {
+        uint32_t k = 0;
+        for (; k < TXN_REPLAY_BATCH && r != TXN_REPLAY_NONE; k++) {
+            uint32_t next_offset;
+            if (txn_replay_read(t, ix->rec_off[r], &hdrs[k], &ix->msgs[k],
+                                &next_offset) < 0) {
+                return false;   // indexed a moment ago; cannot happen
+            }
+            recs[k] = r;
+            r = ix->rec_next[r];
+        }
+        int sent = chan_send_batch(c, caller, ix->msgs, k, /*timeout_ns=*/0);
+        uint32_t n = sent > 0 ? (uint32_t)sent : 0u;
+        for (uint32_t i = 0; i < n; i++) {
+            txn_buffer_mark_delivered(t, ix->rec_off[recs[i]], &hdrs[i]);
+            ix->rec_done[recs[i]] = 1;
+        }
+        ctx->delivered_count += n;
+        if (n < k) {
+            klog(KLOG_WARN, SUBSYS_CORE,
+                 "txn_replay_all: chan_send_batch rc=%d on chan_id=%lu offset=%u",
+                 sent, (unsigned long)g->chan_id,
+                 (unsigned)ix->rec_off[recs[n]]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// txn_replay_all — drain every buffered record into its target channel.
+//
+// Returns 0 on full drain; TXN_ETXNREPLAY (-200) on stall (caller may
+// retry or abort); TXN_EINVAL on internal magic mismatch (corrupted
+// buffer — shouldn't happen).
+//
+// Phase 26: the only ordering a receiver can observe is per channel, so
+// the records are grouped by target channel (txn_replay_build_index) and
+// each group is delivered in buffer order with chan_send_batch — one
+// channel lock hold and one wait-set notification per TXN_REPLAY_BATCH
+// messages instead of per message. A stalled channel stops only its own
+// group; the others still drain. Delivered records are flagged in the
+// buffer, and ctx->current_offset advances over the delivered prefix.
+//
+// The iter is initialised by txn_replay_all on first entry; on retry,
+// callers pass the same ctx without re-init so current_offset / delivered
+// persist across calls. txn_replay_resume is a thin alias used by Stage F
+// retry tests for clarity.
+// ---------------------------------------------------------------------------
+int txn_replay_all(transaction_t *t, txn_replay_context_t *ctx, task_t *caller) {
+    if (!t || !ctx || !caller) return TXN_EINVAL;
+    if (!t->buffer_vmo || t->buffered_count == 0) {
+        // Nothing to replay; trivial success.
+        ctx->delivered_count = 0;
+        return 0;
+    }
+
+    // Set the per-task bypass so chan_send's prologue does NOT re-buffer
+    // these sends into the active_txn. The flag is RELEASE-stored so
+    // observers (other CPUs scheduling chan_send concurrently) see it.
+    __atomic_store_n(&caller->replay_in_progress, 1u, __ATOMIC_RELEASE);
+    ctx->failed_chan_id = 0;
+
+    // One allocation for the whole index; without it, fall back to the
+    // record-at-a-time loop.
+    uint32_t n = t->buffered_count;
+    txn_replay_index_t *ix = (txn_replay_index_t *)kmalloc(
+        sizeof(*ix) + (uint64_t)n * (2u * sizeof(uint32_t) + 1u) +
+            (uint64_t)n * sizeof(txn_replay_group_t),
+        SUBSYS_CORE);
+    if (!ix) {
+        int rc = txn_replay_serial(t, ctx, caller);
+        __atomic_store_n(&caller->replay_in_progress, 0u, __ATOMIC_RELEASE);
+        return rc;
+    }
+    ix->groups   = (txn_replay_group_t *)(ix + 1);
+    ix->rec_off  = (uint32_t *)(ix->groups + n);
+    ix->rec_next = ix->rec_off + n;
+    ix->rec_done = (uint8_t *)(ix->rec_next + n);
+    ix->n_recs   = 0;
+    ix->n_groups = 0;
+
+    int last_rc = txn_replay_build_index(t, ctx, ix, n);
+    if (last_rc == 0) {
+        for (uint32_t g = 0; g < ix->n_groups; g++) {
+            if (!txn_replay_group(t, ctx, ix, &ix->groups[g], caller)) {
+                if (last_rc == 0) ctx->failed_chan_id = ix->groups[g].chan_id;
+                last_rc = TXN_ETXNREPLAY;
+            }
+        }
+        // Advance the cursor over the delivered prefix.
+        uint32_t r = 0;
+        while (r < ix->n_recs && ix->rec_done[r]) r++;
+        ctx->current_offset = (r < ix->n_recs) ? ix->rec_off[r]
+                                               : t->buffer_vmo_head;
     }
 
+    kfree(ix);
     __atomic_store_n(&caller->replay_in_progress, 0u, __ATOMIC_RELEASE);
     return last_rc;
 }
@@ -92,6 +92,7 @@ static int populate_scope_pids(transaction_t *t, snapshot_t *s) {
 static uint32_t txn_buffer_bytes_for_flags(uint32_t flags) {
     if (flags & TXN_FLAG_BUFFER_2MB) return 2u * 1024u * 1024u;
     if (flags & TXN_FLAG_BUFFER_8MB) return 8u * 1024u * 1024u;
+    if (flags & TXN_FLAG_BUFFER_64MB) return TXN_MAX_BUFFER_BYTES;
     return TXN_DEFAULT_BUFFER_BYTES;  // default 4 MiB
 }
 
@@ -152,7 +153,7 @@ int txn_begin(uint32_t flags, const char *name, task_t *caller) {
     t->state = TXN_STATE_ACTIVE;
     t->flags = flags;
     t->creator_pid = caller->id;
-    t->buffer_vmo_capacity = txn_buffer_bytes_for_flags(flags);
+    t->buffer_vmo_limit = txn_buffer_bytes_for_flags(flags);
     spinlock_init(&t->state_waitq_lock, "txn_state_waitq");
     t->id = __atomic_fetch_add(&g_txn_next_id, 1, __ATOMIC_RELAXED);
 
@@ -41,6 +41,11 @@ struct vmo;
 #define TXN_MAX_NESTING            4u    // depth limit per task
 #define TXN_MAX_SCOPE_TASKS        256u  // sorted PID array bound (Q2)
 #define TXN_DEFAULT_BUFFER_BYTES   (4u * 1024u * 1024u)  // 4 MiB
+// Phase 26: the buffer starts small and doubles on demand up to the
+// TXN_FLAG_BUFFER_* size (TXN_DEFAULT_BUFFER_BYTES without one).
+// TXN_MAX_BUFFER_BYTES is only reached with TXN_FLAG_BUFFER_64MB.
+#define TXN_BUFFER_INITIAL_BYTES   (64u * 1024u)         // 64 KiB
+#define TXN_MAX_BUFFER_BYTES       (64u * 1024u * 1024u) // 64 MiB
 #define TXN_NAME_MAX_LEN           31u   // matches snapshot_t.name
 
 // Buffered-message frame magic (Plan agent Q5: head + tail magic catch
@@ -48,6 +53,10 @@ struct vmo;
 #define TXN_BUFFER_MAGIC_HEAD      0xBEADF00Du
 #define TXN_BUFFER_MAGIC_TAIL      0xDEADC0DEu
 
+// buffered_msg_header_t.flags bit set in place once replay has delivered
+// the record, so a retried commit skips it (Phase 26).
+#define TXN_BUFFER_REC_DELIVERED   0x80000000u
+
 // ---------------------------------------------------------------------------
 // Flags (passed to SYS_TXN_BEGIN; preserved on transaction_t.flags).
 // ---------------------------------------------------------------------------
@@ -56,11 +65,13 @@ struct vmo;
 #define TXN_FLAG_BUFFER_2MB        0x00000010u
 #define TXN_FLAG_BUFFER_4MB        0x00000020u  // default
 #define TXN_FLAG_BUFFER_8MB        0x00000040u
+#define TXN_FLAG_BUFFER_64MB       0x00000080u  // opt-in large buffer
 #define TXN_FLAG_VALID_MASK        (TXN_FLAG_SELF_SCOPE   | \
                                     TXN_FLAG_GLOBAL_SCOPE | \
                                     TXN_FLAG_BUFFER_2MB   | \
                                     TXN_FLAG_BUFFER_4MB   | \
-                                    TXN_FLAG_BUFFER_8MB)
+                                    TXN_FLAG_BUFFER_8MB   | \
+                                    TXN_FLAG_BUFFER_64MB)
 
 // ---------------------------------------------------------------------------
 // State machine (spec-mandated).
@@ -111,7 +122,8 @@ typedef struct transaction {
 
     // Buffered messages (Stage E populates).
     struct vmo *buffer_vmo;            // NULL until first external send
-    uint32_t   buffer_vmo_capacity;    // configured at begin (per FLAG_BUFFER_*)
+    uint32_t   buffer_vmo_capacity;    // current VMO size; grows up to _limit
+    uint32_t   buffer_vmo_limit;       // configured at begin (per FLAG_BUFFER_*)
     uint32_t   buffer_vmo_head;        // write offset within buffer_vmo
     uint32_t   buffered_count;         // records written
 
@@ -156,7 +168,7 @@ typedef struct task_txn_frame {
 // ---------------------------------------------------------------------------
 typedef struct txn_replay_context {
     transaction_t *txn;
-    uint32_t       current_offset;
+    uint32_t       current_offset;     // first record not yet delivered
     uint32_t       delivered_count;
     uint64_t       failed_chan_id;
 } txn_replay_context_t;
@@ -222,11 +234,17 @@ int  txn_buffer_iter_next(txn_replay_context_t *ctx,
                           struct channel_msg *out_payload,
                           uint32_t *out_next_offset);
 
+// Phase 26: set TXN_BUFFER_REC_DELIVERED on the record at rec_offset.
+void txn_buffer_mark_delivered(transaction_t *t, uint32_t rec_offset,
+                               const buffered_msg_header_t *hdr);
+
 // ---------------------------------------------------------------------------
 // Stage F replay engine. Lands in kernel/txn/replay.c.
 // ---------------------------------------------------------------------------
 
-// Drain every buffered record into its target channel via chan_send. Sets
+// Drain every buffered record into its target channel. Phase 26: records
+// are grouped by channel and each group is delivered in order with
+// chan_send_batch; a stalled channel does not hold back the others. Sets
 // caller->replay_in_progress=1 across the loop so the prologue doesn't
 // re-buffer (Plan-agent Q3). Returns 0 on full drain; TXN_ETXNREPLAY on
 // stall (caller may retry SYS_TXN_COMMIT or fall back to abort).
@@ -234,7 +252,8 @@ int  txn_replay_all(transaction_t *t, txn_replay_context_t *ctx,
                     struct task_struct *caller);
 
 // Same loop starting from ctx->current_offset (caller preserves it for
-// retry). Used by gate test txn_commit_retry.
+// retry; records already delivered past it are skipped). Used by gate
+// test txn_commit_retry.
 int  txn_replay_resume(transaction_t *t, txn_replay_context_t *ctx,
                        struct task_struct *caller);
 
@@ -0,0 +1,36 @@
+// libc/include/malloc.h
+// Phase 26: malloc introspection and tuning.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One row per allocator pool, laid out like the kernel's SYS_KHEAP_STATS
+// kheap_stats_entry_t so the same tooling can print both. Rows are the
+// small size classes ("malloc-16" .. "malloc-2048"), then "malloc-medium"
+// (run-granular heap blocks), "malloc-large" (dedicated VMO mappings) and
+// "malloc-heap" (the brk region itself).
+typedef struct malloc_stats_entry {
+    char     name[32];
+    uint32_t object_size;  // Class size in bytes; 0 for variable-size rows
+    uint32_t _pad0;
+    uint64_t in_use;       // Live allocations (bytes for "malloc-heap")
+    uint64_t free;         // Free objects (bytes for "malloc-heap")
+    uint32_t pages;        // 4 KiB pages currently backing the row
+    uint32_t _pad1;
+    uint64_t allocs;       // Lifetime malloc count
+    uint64_t frees;        // Lifetime free count
+    uint64_t cache_hits;   // Small classes: mallocs served by the thread cache
+    uint64_t released;     // Bytes handed back to the kernel
+} malloc_stats_entry_t;
+
+// Fill `out` with up to `max` rows. Returns the number written.
+int malloc_stats(malloc_stats_entry_t *out, int max);
+
+// Flush the calling thread's cache, release empty runs and shrink the
+// program break, keeping at most `pad` free bytes at the top of the heap.
+// Returns 1 if memory was returned to the kernel, 0 otherwise.
+int malloc_trim(size_t pad);
+
+// Usable size of a live allocation (>= the size requested), or 0.
+size_t malloc_usable_size(void *ptr);
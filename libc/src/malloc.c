@@ -1,313 +1,567 @@
 // libc/src/malloc.c
 // Phase 7c: Dynamic memory allocation with free-list algorithm
+// Phase 26: Replaced the first-fit list with a size-class allocator.
+//
+// Three tiers, picked by request size:
+//   small  (<= 2048 B)   24 size classes, four per power of two. Objects
+//                        are carved from 16 KiB runs; a per-thread cache
+//                        of free objects per class makes the common
+//                        malloc/free pair O(1) without touching the run.
+//   medium (< 128 KiB)   whole runs, taken best-fit from an address-ordered
+//                        list of free extents that coalesces on free.
+//   large  (>= 128 KiB)  one VMO_ANON mapping per allocation; free unmaps
+//                        it and the frames go straight back to the kernel.
+//                        Falls back to medium extents when the VMO path is
+//                        refused (pledge) or the mapping fails.
+//
+// Runs and extents live in the brk region and are RUN_SIZE aligned, so a
+// heap pointer finds its header by masking. When the free extent at the
+// top of the heap passes TRIM_THRESHOLD the break is lowered again.
+//
+// There are no user threads yet, so there is one arena and one thread
+// cache, reached only through malloc_tcache(). When threads land that
+// returns the caller's TLS cache and the arena grows a lock; the tiers
+// above stay as they are.
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <malloc.h>
+
+#define PAGE_SIZE       4096
+#define RUN_SHIFT       14
+#define RUN_SIZE        ((size_t)1 << RUN_SHIFT)   // 16 KiB
+#define RUN_HDR_SIZE    64                         // Header at each run base
+#define SPAN_RUNS       4                          // Heap grows >= 64 KiB at a time
+#define SMALL_MAX       2048                       // Classes are multiples of 16
+#define NUM_CLASSES     24
+#define LARGE_MIN       (128 * 1024)
+#define LARGE_HDR_SIZE  64
+#define MALLOC_MAX      ((size_t)1 << 40)          // Sanity cap on one request
+#define TRIM_THRESHOLD  (256 * 1024)               // Free top extent that triggers a trim
+#define TRIM_KEEP_RUNS  SPAN_RUNS                  // ...and how much of it to keep
+#define TCACHE_MAX      32                         // Cached objects per class
+#define TCACHE_BATCH    16                         // Refill / flush unit
+
+#define RUN_MAGIC_SMALL  0x52554E53u  // 'RUNS'
+#define RUN_MAGIC_MEDIUM 0x52554E4Du  // 'RUNM'
+#define RUN_MAGIC_FREE   0x52554E46u  // 'RUNF'
+#define LARGE_MAGIC      0x4C524745u  // 'LRGE'
+
+// CAP_V2_EPLEDGE: the task gave up PLEDGE_CLASS_COMPUTE's VMO syscalls.
+#define VM_EPLEDGE      -7
+
+// Free small objects are linked through their first word.
+typedef struct free_obj {
+    struct free_obj *next;
+} free_obj_t;
+
+// Header at the base of every run-aligned extent: a small run of one
+// class, a medium allocation, or a free extent.
+typedef struct run_header {
+    uint32_t magic;
+    uint32_t nruns;            // Extent length in runs (1 for small runs)
+    uint16_t cls;              // Small runs: size class
+    uint16_t nfree;            // Small runs: free objects (incl. never used)
+    uint16_t capacity;         // Small runs: objects per run
+    uint16_t _pad;
+    free_obj_t *free;          // Small runs: objects returned to the run
+    uint8_t *bump;             // Small runs: start of the never-used tail
+    struct run_header *next;   // Class partial list or free-extent list
+    struct run_header *prev;
+} run_header_t;
+
+_Static_assert(sizeof(run_header_t) <= RUN_HDR_SIZE, "run_header_t exceeds RUN_HDR_SIZE");
+
+// Header at the base of a large (VMO-backed) mapping.
+typedef struct large_header {
+    uint32_t magic;
+    uint32_t _pad;
+    size_t   map_len;          // Bytes mapped, header included
+    struct large_header *next;
+    struct large_header *prev;
+} large_header_t;
+
+_Static_assert(sizeof(large_header_t) <= LARGE_HDR_SIZE, "large_header_t exceeds LARGE_HDR_SIZE");
+
+typedef struct size_class {
+    run_header_t *partial;     // Runs with at least one free object
+    uint32_t nruns;            // Runs owned by this class
+    uint64_t run_free;         // Free objects across those runs
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t cache_hits;
+} size_class_t;
+
+typedef struct malloc_arena {
+    size_class_t cls[NUM_CLASSES];
+    run_header_t *extents;     // Free extents, address-ordered
+    large_header_t *large;     // Live VMO-backed allocations
+    uint8_t *heap_base;        // RUN_SIZE-aligned start of our brk space
+    uint8_t *heap_top;         // End of our brk space
+    bool vmo_disabled;         // VMO syscalls refused; large -> medium
+    uint64_t medium_live;
+    uint64_t medium_runs;
+    uint64_t medium_allocs;
+    uint64_t medium_frees;
+    uint64_t large_live;
+    uint64_t large_pages;
+    uint64_t large_allocs;
+    uint64_t large_frees;
+    uint64_t large_released;   // Bytes unmapped
+    uint64_t heap_released;    // Bytes given back by lowering the break
+} malloc_arena_t;
+
+// Per-thread cache of free small objects, one LIFO list per class.
+typedef struct malloc_tcache {
+    malloc_arena_t *arena;
+    free_obj_t *head[NUM_CLASSES];
+    uint16_t count[NUM_CLASSES];
+} malloc_tcache_t;
+
+static malloc_arena_t g_arena;
+static malloc_tcache_t g_tcache = { .arena = &g_arena };
+
+// Anonymous mappings (syscalls.c).
+long __vm_map_anon(size_t len);
+int __vm_unmap(void *addr, size_t len);
+
+static inline malloc_tcache_t *malloc_tcache(void) {
+    return &g_tcache;
+}
 
-// Memory alignment (16 bytes for x86_64)
-#define ALIGNMENT 16
-#define ALIGN(size) (((size) + (ALIGNMENT - 1)) & ~(ALIGNMENT - 1))
+// ---- Size classes ------------------------------------------------------
 
-// Minimum allocation size (including header)
-#define MIN_ALLOC_SIZE 32
+// 16..128 in steps of 16, then four classes per power of two up to 2048.
+static size_t class_size(unsigned c) {
+    if (c < 8) return (size_t)(c + 1) * 16;
+    unsigned lg = 7 + (c - 8) / 4;
+    return ((size_t)1 << lg) + (size_t)((c - 8) % 4 + 1) * ((size_t)1 << (lg - 2));
+}
 
-// Magic number for heap corruption detection
-#define BLOCK_MAGIC 0xDEADBEEF
+// size must be 1..SMALL_MAX.
+static inline unsigned size_class(size_t size) {
+    if (size <= 128) return (unsigned)((size + 15) >> 4) - 1;
+    unsigned lg = 63 - (unsigned)__builtin_clzll((unsigned long long)(size - 1));
+    return 8 + (lg - 7) * 4 + (unsigned)(((size - 1) >> (lg - 2)) & 3);
+}
 
-// Block header structure
-typedef struct block_header {
-    size_t size;              // Size of the data region (not including header)
-    bool is_free;             // Free flag
-    uint32_t magic;           // Magic number for corruption detection
-    struct block_header *next; // Next block in free list
-    struct block_header *prev; // Previous block in free list
-} block_header_t;
+// ---- Extents -----------------------------------------------------------
 
-// Head of the free list
-static block_header_t *free_list_head = NULL;
+static inline run_header_t *run_of(const void *p) {
+    return (run_header_t *)((uintptr_t)p & ~(uintptr_t)(RUN_SIZE - 1));
+}
 
-// Heap boundaries for safety checks
-static void *heap_start = NULL;
-static void *heap_end = NULL;
+static inline uint8_t *extent_end(const run_header_t *e) {
+    return (uint8_t *)e + (size_t)e->nruns * RUN_SIZE;
+}
 
-// Heap statistics
-static size_t total_allocated = 0;
-static size_t total_freed = 0;
+static inline bool in_heap(const malloc_arena_t *a, const void *p) {
+    return a->heap_base != NULL &&
+           (const uint8_t *)p >= a->heap_base && (const uint8_t *)p < a->heap_top;
+}
 
-// Forward declarations
-static block_header_t *find_free_block(size_t size);
-static block_header_t *request_space(size_t size);
-static void split_block(block_header_t *block, size_t size);
-static void coalesce_blocks(block_header_t *block);
-static void add_to_free_list(block_header_t *block);
-static void remove_from_free_list(block_header_t *block);
+static void extent_unlink(malloc_arena_t *a, run_header_t *e) {
+    if (e->prev) e->prev->next = e->next;
+    else a->extents = e->next;
+    if (e->next) e->next->prev = e->prev;
+    e->next = NULL;
+    e->prev = NULL;
+}
 
-/**
- * @brief Find a suitable free block using first-fit strategy
- */
-static block_header_t *find_free_block(size_t size) {
-    block_header_t *current = free_list_head;
+// Put [e, e + nruns runs) on the free list, merging with its address
+// neighbours. Returns the extent that now contains it.
+static run_header_t *extent_insert(malloc_arena_t *a, run_header_t *e, uint32_t nruns) {
+    run_header_t *prev = NULL;
+    run_header_t *next = a->extents;
+    while (next && next < e) {
+        prev = next;
+        next = next->next;
+    }
 
-    while (current != NULL) {
-        // Verify magic number
-        if (current->magic != BLOCK_MAGIC) {
-            // Heap corruption detected
-            return NULL;
-        }
+    e->magic = RUN_MAGIC_FREE;
+    e->nruns = nruns;
+    if (prev && extent_end(prev) == (uint8_t *)e) {
+        prev->nruns += nruns;
+        e->magic = 0;  // No stale header inside a merged extent
+        e = prev;
+    } else {
+        e->prev = prev;
+        e->next = next;
+        if (prev) prev->next = e;
+        else a->extents = e;
+        if (next) next->prev = e;
+    }
 
-        // Check if block is free and large enough
-        if (current->is_free && current->size >= size) {
-            return current;
-        }
+    if (next && extent_end(e) == (uint8_t *)next) {
+        e->nruns += next->nruns;
+        extent_unlink(a, next);
+        next->magic = 0;
+    }
+    return e;
+}
 
-        current = current->next;
+// Split the first `nruns` runs off free extent e and hand them out.
+static run_header_t *extent_take(malloc_arena_t *a, run_header_t *e, uint32_t nruns) {
+    if (e->nruns > nruns) {
+        run_header_t *rest = (run_header_t *)((uint8_t *)e + (size_t)nruns * RUN_SIZE);
+        rest->magic = RUN_MAGIC_FREE;
+        rest->nruns = e->nruns - nruns;
+        rest->prev = e->prev;
+        rest->next = e->next;
+        if (rest->prev) rest->prev->next = rest;
+        else a->extents = rest;
+        if (rest->next) rest->next->prev = rest;
+        e->next = NULL;
+        e->prev = NULL;
+    } else {
+        extent_unlink(a, e);
     }
+    e->nruns = nruns;
+    return e;
+}
 
-    return NULL;
+// Lower the break over free extent e (which must end at the heap top),
+// keeping `keep_runs` of it. Returns true if the break moved.
+static bool heap_trim(malloc_arena_t *a, run_header_t *e, uint32_t keep_runs) {
+    if (extent_end(e) != a->heap_top || e->nruns <= keep_runs) return false;
+    // Someone else moved the break past us; the top is not ours to drop.
+    if ((uint8_t *)sbrk(0) != a->heap_top) return false;
+
+    uint8_t *new_top = (uint8_t *)e + (size_t)keep_runs * RUN_SIZE;
+    if (brk(new_top) != 0) return false;
+
+    a->heap_released += (uint64_t)(a->heap_top - new_top);
+    a->heap_top = new_top;
+    if (keep_runs) e->nruns = keep_runs;
+    else extent_unlink(a, e);
+    return true;
 }
 
-/**
- * @brief Request more memory from the kernel using sbrk
- */
-static block_header_t *request_space(size_t size) {
-    // Calculate total size needed (header + data)
-    size_t total_size = ALIGN(sizeof(block_header_t) + size);
-
-    // Request memory from kernel
-    void *ptr = sbrk(total_size);
-    if (ptr == (void *)-1) {
-        // sbrk failed
-        return NULL;
+// Grow the break by at least `nruns` runs (SPAN_RUNS minimum) and free
+// the new space. Returns the free extent ending at the new heap top, or
+// NULL if the kernel refused.
+static run_header_t *heap_grow(malloc_arena_t *a, uint32_t nruns) {
+    uint8_t *cur = sbrk(0);
+    if (cur == (void *)-1) return NULL;
+    uint8_t *base = (uint8_t *)(((uintptr_t)cur + RUN_SIZE - 1) & ~(uintptr_t)(RUN_SIZE - 1));
+
+    // If our top extent is free and the break is still ours, only the
+    // shortfall is needed; it is shorter than nruns or best-fit would
+    // have found it.
+    uint32_t have = 0;
+    if (a->heap_top && base == a->heap_top) {
+        run_header_t *last = a->extents;
+        while (last && last->next) last = last->next;
+        if (last && extent_end(last) == a->heap_top) have = last->nruns;
     }
-
-    // Update heap boundaries
-    if (heap_start == NULL) {
-        heap_start = ptr;
+    uint32_t need = nruns - have;
+    uint32_t grow = need < SPAN_RUNS ? SPAN_RUNS : need;
+    size_t pad = (size_t)(base - cur);
+
+    if (sbrk((ptrdiff_t)(pad + (size_t)grow * RUN_SIZE)) == (void *)-1) {
+        // Near the memory limit: retry without the span rounding.
+        if (grow == need) return NULL;
+        if (sbrk((ptrdiff_t)(pad + (size_t)need * RUN_SIZE)) == (void *)-1) return NULL;
+        grow = need;
     }
-    heap_end = (void *)((uint8_t *)ptr + total_size);
 
-    // Initialize block header
-    block_header_t *block = (block_header_t *)ptr;
-    block->size = size;
-    block->is_free = false;
-    block->magic = BLOCK_MAGIC;
-    block->next = NULL;
-    block->prev = NULL;
-
-    total_allocated += size;
-
-    return block;
+    if (!a->heap_base) a->heap_base = base;
+    a->heap_top = base + (size_t)grow * RUN_SIZE;
+    return extent_insert(a, (run_header_t *)base, grow);
 }
 
-/**
- * @brief Split a block if it's larger than needed
- */
-static void split_block(block_header_t *block, size_t size) {
-    // Only split if remaining space is large enough for a new block
-    size_t remaining = block->size - size;
-    size_t min_split_size = ALIGN(sizeof(block_header_t) + MIN_ALLOC_SIZE);
-
-    if (remaining >= min_split_size) {
-        // Create new block from the remaining space
-        block_header_t *new_block = (block_header_t *)((uint8_t *)(block + 1) + size);
-
-        // CRITICAL: Validate new block is within heap bounds
-        if ((void *)new_block < heap_start || (void *)new_block >= heap_end) {
-            // New block would be outside heap, don't split
-            return;
-        }
+// Best-fit `nruns` runs from the free list, growing the heap on a miss.
+static run_header_t *extent_alloc(malloc_arena_t *a, uint32_t nruns) {
+    run_header_t *best = NULL;
+    for (run_header_t *e = a->extents; e; e = e->next) {
+        if (e->nruns < nruns) continue;
+        if (!best || e->nruns < best->nruns) best = e;
+        if (e->nruns == nruns) break;
+    }
+    if (!best) best = heap_grow(a, nruns);
+    if (!best) return NULL;
+    return extent_take(a, best, nruns);
+}
 
-        if ((void *)((uint8_t *)new_block + sizeof(block_header_t)) > heap_end) {
-            // Not enough space for new block header, don't split
-            return;
-        }
+// Return an extent and trim the heap if the top has gone idle.
+static void extent_free(malloc_arena_t *a, run_header_t *e, uint32_t nruns) {
+    e = extent_insert(a, e, nruns);
+    if ((size_t)e->nruns * RUN_SIZE >= TRIM_THRESHOLD) {
+        heap_trim(a, e, TRIM_KEEP_RUNS);
+    }
+}
 
-        new_block->size = remaining - sizeof(block_header_t);
-        new_block->is_free = true;
-        new_block->magic = BLOCK_MAGIC;
-        new_block->next = NULL;
-        new_block->prev = NULL;
+// ---- Small objects -----------------------------------------------------
 
-        // Update original block size
-        block->size = size;
+static void partial_push(size_class_t *sc, run_header_t *r) {
+    r->prev = NULL;
+    r->next = sc->partial;
+    if (sc->partial) sc->partial->prev = r;
+    sc->partial = r;
+}
 
-        // Add new block to free list
-        add_to_free_list(new_block);
-    }
+static void partial_unlink(size_class_t *sc, run_header_t *r) {
+    if (r->prev) r->prev->next = r->next;
+    else sc->partial = r->next;
+    if (r->next) r->next->prev = r->prev;
+    r->next = NULL;
+    r->prev = NULL;
 }
 
-/**
- * @brief Coalesce adjacent free blocks
- */
-static void coalesce_blocks(block_header_t *block) {
-    if (!block || !block->is_free) {
-        return;
-    }
+// Carve a fresh run for class c and put it on the partial list.
+static run_header_t *small_run_new(malloc_arena_t *a, unsigned c) {
+    run_header_t *r = extent_alloc(a, 1);
+    if (!r) return NULL;
+
+    size_class_t *sc = &a->cls[c];
+    r->magic    = RUN_MAGIC_SMALL;
+    r->cls      = (uint16_t)c;
+    r->capacity = (uint16_t)((RUN_SIZE - RUN_HDR_SIZE) / class_size(c));
+    r->nfree    = r->capacity;
+    r->free     = NULL;
+    r->bump     = (uint8_t *)r + RUN_HDR_SIZE;
+    partial_push(sc, r);
+    sc->nruns++;
+    sc->run_free += r->capacity;
+    return r;
+}
 
-    // Calculate where next block would be
-    block_header_t *next_block = (block_header_t *)((uint8_t *)(block + 1) + block->size);
+// Hand an empty run back to the extent list.
+static void small_run_release(malloc_arena_t *a, run_header_t *r) {
+    size_class_t *sc = &a->cls[r->cls];
+    partial_unlink(sc, r);
+    sc->nruns--;
+    sc->run_free -= r->capacity;
+    extent_free(a, r, 1);
+}
 
-    // CRITICAL FIX: Check if next_block is within heap bounds before dereferencing!
-    // This prevents page faults when the block is at the end of the heap.
-    if ((void *)next_block >= heap_end || (void *)next_block < heap_start) {
-        // Next block is outside heap boundaries, cannot coalesce
-        return;
+static void *small_run_pop(malloc_arena_t *a, run_header_t *r) {
+    size_class_t *sc = &a->cls[r->cls];
+    void *p;
+    if (r->free) {
+        p = r->free;
+        r->free = r->free->next;
+    } else {
+        p = r->bump;
+        r->bump += class_size(r->cls);
     }
+    r->nfree--;
+    sc->run_free--;
+    if (r->nfree == 0) partial_unlink(sc, r);
+    return p;
+}
 
-    // Check if next block has enough space for a valid header
-    if ((void *)((uint8_t *)next_block + sizeof(block_header_t)) > heap_end) {
-        // Not enough space for a valid block header
-        return;
+static void small_run_push(malloc_arena_t *a, void *p) {
+    run_header_t *r = run_of(p);
+    size_class_t *sc = &a->cls[r->cls];
+    free_obj_t *o = (free_obj_t *)p;
+    o->next = r->free;
+    r->free = o;
+    if (r->nfree++ == 0) partial_push(sc, r);
+    sc->run_free++;
+    // Keep one empty run per class so a malloc/free loop at a run
+    // boundary doesn't bounce runs through the extent list.
+    if (r->nfree == r->capacity && (r->prev || r->next)) {
+        small_run_release(a, r);
     }
+}
 
-    // Now it's safe to check the magic number and is_free flag
-    if (next_block->magic == BLOCK_MAGIC && next_block->is_free) {
-        // Remove next block from free list
-        remove_from_free_list(next_block);
-
-        // Merge blocks
-        block->size += sizeof(block_header_t) + next_block->size;
+// Move up to TCACHE_BATCH objects of class c from runs into the cache,
+// in address order. Returns false if none could be had.
+static bool tcache_refill(malloc_tcache_t *tc, unsigned c) {
+    malloc_arena_t *a = tc->arena;
+    free_obj_t *first = NULL;
+    free_obj_t *last = NULL;
+    int n = 0;
+    while (n < TCACHE_BATCH) {
+        run_header_t *r = a->cls[c].partial;
+        if (!r) r = small_run_new(a, c);
+        if (!r) break;
+        free_obj_t *o = (free_obj_t *)small_run_pop(a, r);
+        if (last) last->next = o;
+        else first = o;
+        last = o;
+        n++;
     }
+    if (n == 0) return false;
+    last->next = tc->head[c];
+    tc->head[c] = first;
+    tc->count[c] = (uint16_t)(tc->count[c] + n);
+    return true;
 }
 
-/**
- * @brief Add block to free list
- */
-static void add_to_free_list(block_header_t *block) {
-    if (!block) return;
-
-    // CRITICAL: Validate block is within heap bounds
-    if (heap_start != NULL) {
-        if ((void *)block < heap_start || (void *)block >= heap_end) {
-            // Block outside heap, don't add to free list
-            return;
-        }
+static void tcache_flush(malloc_tcache_t *tc, unsigned c, unsigned n) {
+    while (n-- > 0 && tc->head[c]) {
+        free_obj_t *o = tc->head[c];
+        tc->head[c] = o->next;
+        tc->count[c]--;
+        small_run_push(tc->arena, o);
     }
+}
 
-    // CRITICAL: Validate magic number before adding to list
-    if (block->magic != BLOCK_MAGIC) {
-        // Corrupted block, don't add to free list
-        return;
-    }
+// Is p the start of an object handed out from small run r?
+static bool small_ptr_valid(const run_header_t *r, const void *p) {
+    const uint8_t *objs = (const uint8_t *)r + RUN_HDR_SIZE;
+    if ((const uint8_t *)p < objs || (const uint8_t *)p >= r->bump) return false;
+    if (r->cls >= NUM_CLASSES) return false;
+    return ((size_t)((const uint8_t *)p - objs) % class_size(r->cls)) == 0;
+}
 
-    block->is_free = true;
+// ---- Medium and large --------------------------------------------------
+
+static void *medium_alloc(malloc_arena_t *a, size_t size) {
+    uint32_t nruns = (uint32_t)((size + RUN_HDR_SIZE + RUN_SIZE - 1) >> RUN_SHIFT);
+    run_header_t *e = extent_alloc(a, nruns);
+    if (!e) return NULL;
+    e->magic = RUN_MAGIC_MEDIUM;
+    a->medium_live++;
+    a->medium_runs += nruns;
+    a->medium_allocs++;
+    return (uint8_t *)e + RUN_HDR_SIZE;
+}
 
-    // Insert at head of free list
-    block->next = free_list_head;
-    block->prev = NULL;
+static void medium_free(malloc_arena_t *a, run_header_t *e) {
+    a->medium_live--;
+    a->medium_runs -= e->nruns;
+    a->medium_frees++;
+    extent_free(a, e, e->nruns);
+}
 
-    if (free_list_head) {
-        free_list_head->prev = block;
+static void *large_alloc(malloc_arena_t *a, size_t size) {
+    size_t map_len = (size + LARGE_HDR_SIZE + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+    long va = __vm_map_anon(map_len);
+    if (va <= 0) {
+        if (va == VM_EPLEDGE) a->vmo_disabled = true;
+        return NULL;
     }
 
-    free_list_head = block;
+    large_header_t *h = (large_header_t *)va;
+    h->magic = LARGE_MAGIC;
+    h->map_len = map_len;
+    h->prev = NULL;
+    h->next = a->large;
+    if (a->large) a->large->prev = h;
+    a->large = h;
+    a->large_live++;
+    a->large_pages += map_len / PAGE_SIZE;
+    a->large_allocs++;
+    return (uint8_t *)h + LARGE_HDR_SIZE;
 }
 
-/**
- * @brief Remove block from free list
- */
-static void remove_from_free_list(block_header_t *block) {
-    if (!block) return;
-
-    if (block->prev) {
-        block->prev->next = block->next;
-    } else {
-        // This is the head
-        free_list_head = block->next;
-    }
-
-    if (block->next) {
-        block->next->prev = block->prev;
+// Look p up among live large allocations. Walking the list (instead of
+// trusting a header in front of p) keeps free() of a stray pointer from
+// reading unmapped memory; large allocations are few by construction.
+static large_header_t *large_find(malloc_arena_t *a, const void *p) {
+    if (((uintptr_t)p & (PAGE_SIZE - 1)) != LARGE_HDR_SIZE) return NULL;
+    const uint8_t *hdr = (const uint8_t *)p - LARGE_HDR_SIZE;
+    for (large_header_t *h = a->large; h; h = h->next) {
+        if ((const uint8_t *)h == hdr) return h;
     }
+    return NULL;
+}
 
-    block->next = NULL;
-    block->prev = NULL;
-    block->is_free = false;
+static void large_free(malloc_arena_t *a, large_header_t *h) {
+    if (h->prev) h->prev->next = h->next;
+    else a->large = h->next;
+    if (h->next) h->next->prev = h->prev;
+
+    size_t map_len = h->map_len;
+    h->magic = 0;
+    a->large_live--;
+    a->large_pages -= map_len / PAGE_SIZE;
+    a->large_frees++;
+    if (__vm_unmap(h, map_len) == 0) a->large_released += map_len;
 }
 
+// ---- Public API --------------------------------------------------------
+
 /**
  * @brief Allocate memory
  */
 void *malloc(size_t size) {
-    if (size == 0) {
+    if (size == 0 || size > MALLOC_MAX) {
         return NULL;
     }
 
-    // Align size
-    size = ALIGN(size);
-
-    // Try to find a free block
-    block_header_t *block = find_free_block(size);
+    malloc_tcache_t *tc = malloc_tcache();
+    malloc_arena_t *a = tc->arena;
 
-    if (block) {
-        // Found a free block
-        remove_from_free_list(block);
-
-        // Split if block is too large
-        split_block(block, size);
-
-        // Return pointer to data region
-        return (void *)(block + 1);
+    if (size <= SMALL_MAX) {
+        unsigned c = size_class(size);
+        if (tc->head[c]) {
+            a->cls[c].cache_hits++;
+        } else if (!tcache_refill(tc, c)) {
+            return NULL;
+        }
+        free_obj_t *o = tc->head[c];
+        tc->head[c] = o->next;
+        tc->count[c]--;
+        a->cls[c].allocs++;
+        return o;
     }
 
-    // No suitable free block, request more space
-    block = request_space(size);
-    if (!block) {
-        return NULL;
+    if (size >= LARGE_MIN && !a->vmo_disabled) {
+        void *p = large_alloc(a, size);
+        if (p) return p;
     }
-
-    // Return pointer to data region
-    return (void *)(block + 1);
+    return medium_alloc(a, size);
 }
 
 /**
  * @brief Free allocated memory
+ *
+ * Pointers this allocator never returned are ignored, as before.
  */
 void free(void *ptr) {
     if (!ptr) {
         return;
     }
 
-    // CRITICAL: Validate pointer is in heap bounds BEFORE dereferencing
-    if (heap_start != NULL) {  // Only check if heap has been initialized
-        if (ptr < heap_start || ptr >= heap_end) {
-            // Pointer outside heap boundaries, invalid
-            return;
+    malloc_tcache_t *tc = malloc_tcache();
+    malloc_arena_t *a = tc->arena;
+
+    if (in_heap(a, ptr)) {
+        run_header_t *r = run_of(ptr);
+        if (r->magic == RUN_MAGIC_SMALL) {
+            if (!small_ptr_valid(r, ptr)) return;
+            unsigned c = r->cls;
+            // Cheap catch for the common back-to-back double free.
+            if (tc->head[c] == ptr) return;
+            free_obj_t *o = (free_obj_t *)ptr;
+            o->next = tc->head[c];
+            tc->head[c] = o;
+            a->cls[c].frees++;
+            if (++tc->count[c] > TCACHE_MAX) tcache_flush(tc, c, TCACHE_BATCH);
+        } else if (r->magic == RUN_MAGIC_MEDIUM &&
+                   (uint8_t *)ptr == (uint8_t *)r + RUN_HDR_SIZE) {
+            medium_free(a, r);
         }
-    }
-
-    // Get block header
-    block_header_t *block = (block_header_t *)ptr - 1;
-
-    // CRITICAL: Validate block header is also in heap bounds
-    if (heap_start != NULL) {
-        if ((void *)block < heap_start || (void *)block >= heap_end) {
-            // Block header outside heap, invalid
-            return;
-        }
-    }
-
-    // Verify magic number
-    if (block->magic != BLOCK_MAGIC) {
-        // Heap corruption or invalid pointer
         return;
     }
 
-    // Already free?
-    if (block->is_free) {
-        // Double free detected
-        return;
-    }
+    large_header_t *h = large_find(a, ptr);
+    if (h) large_free(a, h);
+}
 
-    total_freed += block->size;
+size_t malloc_usable_size(void *ptr) {
+    if (!ptr) return 0;
+    malloc_arena_t *a = malloc_tcache()->arena;
 
-    // Add to free list
-    add_to_free_list(block);
+    if (in_heap(a, ptr)) {
+        run_header_t *r = run_of(ptr);
+        if (r->magic == RUN_MAGIC_SMALL && small_ptr_valid(r, ptr)) {
+            return class_size(r->cls);
+        }
+        if (r->magic == RUN_MAGIC_MEDIUM && (uint8_t *)ptr == (uint8_t *)r + RUN_HDR_SIZE) {
+            return (size_t)r->nruns * RUN_SIZE - RUN_HDR_SIZE;
+        }
+        return 0;
+    }
 
-    // Coalesce with adjacent blocks
-    coalesce_blocks(block);
+    large_header_t *h = large_find(a, ptr);
+    return h ? h->map_len - LARGE_HDR_SIZE : 0;
 }
 
 /**
@@ -321,11 +575,15 @@ void *calloc(size_t nmemb, size_t size) {
 
     size_t total_size = nmemb * size;
     void *ptr = malloc(total_size);
-
-    if (ptr) {
-        memset(ptr, 0, total_size);
+    if (!ptr) {
+        return NULL;
     }
 
+    // Fresh VMO_ZEROED mappings are already clear.
+    if (total_size >= LARGE_MIN && large_find(malloc_tcache()->arena, ptr)) {
+        return ptr;
+    }
+    memset(ptr, 0, total_size);
     return ptr;
 }
 
@@ -342,46 +600,118 @@ void *realloc(void *ptr, size_t size) {
         return NULL;
     }
 
-    // CRITICAL: Validate pointer is within heap bounds
-    if (heap_start != NULL) {
-        if (ptr < heap_start || ptr >= heap_end) {
-            // Invalid pointer
-            return NULL;
-        }
-    }
-
-    // Get current block
-    block_header_t *block = (block_header_t *)ptr - 1;
-
-    // CRITICAL: Validate block header is within heap bounds
-    if (heap_start != NULL) {
-        if ((void *)block < heap_start || (void *)block >= heap_end) {
-            // Invalid block header
-            return NULL;
-        }
-    }
-
-    // Verify magic number
-    if (block->magic != BLOCK_MAGIC) {
+    size_t have = malloc_usable_size(ptr);
+    if (have == 0) {
+        // Not one of ours
         return NULL;
     }
 
     // If new size fits in current block, just return it
-    if (size <= block->size) {
+    if (size <= have) {
         return ptr;
     }
 
-    // Allocate new block
     void *new_ptr = malloc(size);
     if (!new_ptr) {
         return NULL;
     }
+    memcpy(new_ptr, ptr, have);
+    free(ptr);
+    return new_ptr;
+}
 
-    // Copy data
-    memcpy(new_ptr, ptr, block->size);
+int malloc_trim(size_t pad) {
+    malloc_tcache_t *tc = malloc_tcache();
+    malloc_arena_t *a = tc->arena;
+    uint64_t before = a->heap_released;
+
+    for (unsigned c = 0; c < NUM_CLASSES; c++) {
+        tcache_flush(tc, c, tc->count[c]);
+        run_header_t *r = a->cls[c].partial;
+        while (r) {
+            run_header_t *next = r->next;
+            if (r->nfree == r->capacity) small_run_release(a, r);
+            r = next;
+        }
+    }
 
-    // Free old block
-    free(ptr);
+    run_header_t *last = a->extents;
+    while (last && last->next) last = last->next;
+    if (last) {
+        heap_trim(a, last, (uint32_t)((pad + RUN_SIZE - 1) >> RUN_SHIFT));
+    }
+    return a->heap_released != before;
+}
 
-    return new_ptr;
+// Write "<prefix><n>" (just "<prefix>" when n is 0) into a stats name.
+static void stats_name(char *dst, const char *prefix, size_t n) {
+    size_t i = 0;
+    while (*prefix && i < 31) dst[i++] = *prefix++;
+    char digits[20];
+    int nd = 0;
+    while (n && nd < 20) {
+        digits[nd++] = (char)('0' + n % 10);
+        n /= 10;
+    }
+    while (nd > 0 && i < 31) dst[i++] = digits[--nd];
+    dst[i] = '\0';
+}
+
+int malloc_stats(malloc_stats_entry_t *out, int max) {
+    if (!out || max <= 0) return 0;
+    malloc_tcache_t *tc = malloc_tcache();
+    malloc_arena_t *a = tc->arena;
+    int n = 0;
+
+    for (unsigned c = 0; c < NUM_CLASSES && n < max; c++, n++) {
+        const size_class_t *sc = &a->cls[c];
+        malloc_stats_entry_t *e = &out[n];
+        memset(e, 0, sizeof(*e));
+        stats_name(e->name, "malloc-", class_size(c));
+        e->object_size = (uint32_t)class_size(c);
+        e->in_use      = sc->allocs - sc->frees;
+        e->free        = sc->run_free + tc->count[c];
+        e->pages       = (uint32_t)(sc->nruns * (RUN_SIZE / PAGE_SIZE));
+        e->allocs      = sc->allocs;
+        e->frees       = sc->frees;
+        e->cache_hits  = sc->cache_hits;
+    }
+
+    if (n < max) {
+        malloc_stats_entry_t *e = &out[n++];
+        memset(e, 0, sizeof(*e));
+        stats_name(e->name, "malloc-medium", 0);
+        e->in_use = a->medium_live;
+        e->pages  = (uint32_t)(a->medium_runs * (RUN_SIZE / PAGE_SIZE));
+        e->allocs = a->medium_allocs;
+        e->frees  = a->medium_frees;
+    }
+
+    if (n < max) {
+        malloc_stats_entry_t *e = &out[n++];
+        memset(e, 0, sizeof(*e));
+        stats_name(e->name, "malloc-large", 0);
+        e->in_use   = a->large_live;
+        e->pages    = (uint32_t)a->large_pages;
+        e->allocs   = a->large_allocs;
+        e->frees    = a->large_frees;
+        e->released = a->large_released;
+    }
+
+    if (n < max) {
+        malloc_stats_entry_t *e = &out[n++];
+        memset(e, 0, sizeof(*e));
+        stats_name(e->name, "malloc-heap", 0);
+        uint64_t heap_bytes = (uint64_t)(a->heap_top - a->heap_base);
+        uint64_t free_bytes = 0;
+        for (run_header_t *x = a->extents; x; x = x->next) {
+            free_bytes += (uint64_t)x->nruns * RUN_SIZE;
+        }
+        e->in_use   = heap_bytes - free_bytes;
+        e->free     = free_bytes;
+        e->pages    = (uint32_t)(heap_bytes / PAGE_SIZE);
+        e->released = a->heap_released;
+    }
+
+    return n;
 }
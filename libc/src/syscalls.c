@@ -33,6 +33,21 @@
 #define SYS_KLOG_READ   1054
 #define SYS_KLOG_WRITE  1055
 #define SYS_DEBUG       1056
+#define SYS_PLEDGE      1062
+#define SYS_VMO_CREATE  1071
+#define SYS_VMO_MAP     1072
+#define SYS_VMO_UNMAP   1073
+
+// VMO flags / prot bits (mirror kernel/mm/vmo.h)
+#define VMO_ZEROED      0x1u
+#define VMO_ANON        0x40u
+#define PROT_READ       0x1u
+#define PROT_WRITE      0x2u
+
+// Pledge query (mirror kernel/cap/pledge.h)
+#define PLEDGE_FLAG_QUERY  0x40000000u
+#define PLEDGE_COMPUTE     (1u << 10)
+#define CAP_V2_EPLEDGE     -7
 
 // Generic syscall functions
 static inline long syscall0(long n) {
@@ -59,6 +74,15 @@ static inline long syscall3(long n, long a1, long a2, long a3) {
     return ret;
 }
 
+static inline long syscall5(long n, long a1, long a2, long a3, long a4, long a5) {
+    long ret;
+    register long r10 asm("r10") = a4;
+    register long r8 asm("r8") = a5;
+    asm volatile("syscall" : "=a"(ret) : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
 // ===== FILE OPERATIONS =====
 
 int open(const char *pathname, int flags, ...) {
@@ -140,7 +164,9 @@ void (*signal(int sig, void (*handler)(int)))(int) {
 // Program break syscall
 int brk(void *addr) {
     long ret = syscall1(SYS_BRK, (long)addr);
-    if (ret == (long)-1) {
+    // The kernel reports failure as -1 or as a negative errno (-12 when
+    // the memory rlimit refuses the growth).
+    if (ret < 0) {
         return -1;
     }
     return 0;
@@ -150,7 +176,7 @@ int brk(void *addr) {
 void *sbrk(intptr_t increment) {
     // Get current break
     long current_brk = syscall1(SYS_BRK, 0);
-    if (current_brk == (long)-1) {
+    if (current_brk < 0) {
         return (void *)-1;
     }
 
@@ -160,7 +186,7 @@ void *sbrk(intptr_t increment) {
 
     // Set new break
     long new_brk = syscall1(SYS_BRK, current_brk + increment);
-    if (new_brk == (long)-1) {
+    if (new_brk < 0) {
         return (void *)-1;
     }
 
@@ -168,6 +194,28 @@ void *sbrk(intptr_t increment) {
     return (void *)current_brk;
 }
 
+// Phase 26: anonymous mappings for malloc's large allocations. A VMO_ANON
+// object's cap is retired by its first map, so the mapping is the only
+// reference and __vm_unmap hands the frames straight back to the kernel.
+// Returns the mapping address, or a negative CAP_V2_* code. A task that
+// pledged PLEDGE_COMPUTE away gets CAP_V2_EPLEDGE without the VMO calls
+// being made, so the fallback leaves no pledge violation in the audit log.
+long __vm_map_anon(size_t len) {
+    long mask = syscall1(SYS_PLEDGE, (long)PLEDGE_FLAG_QUERY);
+    if (mask >= 0 && !(mask & PLEDGE_COMPUTE)) {
+        return CAP_V2_EPLEDGE;
+    }
+    long tok = syscall2(SYS_VMO_CREATE, (long)len, VMO_ZEROED | VMO_ANON);
+    if (tok <= 0) {
+        return tok < 0 ? tok : -1;
+    }
+    return syscall5(SYS_VMO_MAP, tok, 0, 0, (long)len, PROT_READ | PROT_WRITE);
+}
+
+int __vm_unmap(void *addr, size_t len) {
+    return (int)syscall2(SYS_VMO_UNMAP, (long)addr, (long)len);
+}
+
 // ===== FILE SYSTEM OPERATIONS =====
 
 // Create a file
@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+# scripts/run_http_keepalive_server.sh — Phase 29 keep-alive pool gate.
+#
+# Plaintext HTTP/1.1 server consumed by user/tests/libhttp_keepalive.tap.
+# Listens on 127.0.0.1:8081; the guest reaches it as 10.0.2.2:8081 through
+# QEMU's user-mode network (8080 is taken by the hostfwd to the guest).
+#
+# Usage:
+#   scripts/run_http_keepalive_server.sh &     # background
+#   PID=$!
+#   ...
+#   kill $PID
+#
+# Every response body is "conn=<C> req=<R> path=<P>": C numbers the TCP
+# connections the server accepted, R counts requests on that connection,
+# so the test can tell a pooled connection from a fresh one.
+#
+#   GET /n/<anything>  200, connection stays open
+#   GET /drop          200 framed as keep-alive, then the server closes the
+#                      connection — what an idle timeout looks like to a
+#                      client that already pooled it
+
+set -euo pipefail
+
+PORT="${HTTP_KA_PORT:-8081}"
+
+python3 - "$PORT" <<'PY'
+import http.server, itertools, sys
+port = int(sys.argv[1])
+conn_ids = itertools.count(1)
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    def log_message(self, *a, **k): pass  # quiet
+    def setup(self):
+        super().setup()
+        self.conn_id = next(conn_ids)
+        self.nreq = 0
+    def do_GET(self):
+        self.nreq += 1
+        body = ("conn=%d req=%d path=%s\n" %
+                (self.conn_id, self.nreq, self.path)).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+        if self.path == "/drop":
+            self.close_connection = True
+
+httpd = http.server.ThreadingHTTPServer(("127.0.0.1", port), Handler)
+print("keep-alive test server on 127.0.0.1:%d" % port, flush=True)
+httpd.serve_forever()
+PY
@@ -12,7 +12,9 @@
 //      tables, write phys addrs to PxCLB/PxFB, start CMD engine, IDENTIFY.
 //   5. Publish /sys/blk/service via SYS_CHAN_PUBLISH.
 //   6. Main loop: drv_irq_wait + non-blocking accept on /sys/blk/service +
-//      non-blocking drain of per-client request channels.
+//      non-blocking drain of per-client request channels. Phase 26: all of
+//      these are registered in one wait-set and the loop sleeps in
+//      SYS_WAITSET_WAIT until one of them is ready.
 //
 // Phase 23 S3 is a structural delivery — the daemon exists, builds, links,
 // passes ahcid_register tests when run standalone. Production cutover
@@ -826,7 +828,10 @@ static int dispatch_one_request(ahcid_client_t *cli,
     }
 }
 
-static void handle_client_request(ahcid_client_t *cli) {
+/* Returns 1 if a message was consumed from client_chan_read (even a
+ * malformed one), 0 if the channel was empty — the wait-set loop drains
+ * an edge-triggered client until this returns 0. */
+static int handle_client_request(ahcid_client_t *cli) {
     /* Phase 24a W3: receive up to CHAN_MSG_INLINE_MAX bytes — large enough
      * for both a 32-byte single blk_req_msg_t and a 200-byte
      * blk_batch_req_t. Dispatch on the first byte (kind tag) when the
@@ -834,12 +839,13 @@ static void handle_client_request(ahcid_client_t *cli) {
     uint8_t buf[256];  /* CHAN_MSG_INLINE_MAX */
     cap_token_u_t tok = {.raw = (uint64_t)cli->client_chan_read};
     long n = recv_payload(tok, buf, sizeof(buf), 0);  /* non-block */
-    if (n < (long)sizeof(blk_req_msg_t)) return;
+    if (n < 0) return 0;
+    if (n < (long)sizeof(blk_req_msg_t)) return 1;
 
     if ((size_t)n >= sizeof(blk_batch_req_t) && buf[0] == BLK_KIND_BATCH_REQ) {
         const blk_batch_req_t *batch = (const blk_batch_req_t *)buf;
         uint8_t count = batch->count;
-        if (count == 0u || count > BLK_BATCH_MAX) return;
+        if (count == 0u || count > BLK_BATCH_MAX) return 1;
 
         /* Issue each command. ahcid_do_read/write etc. queue the command
          * into an HBA slot and write PxCI bit immediately; AHCI HBA
@@ -863,13 +869,13 @@ static void handle_client_request(ahcid_client_t *cli) {
             }
             cli->reqs_handled++;
         }
-        return;
+        return 1;
     }
 
     /* Single-op (legacy) path. */
     const blk_req_msg_t *req = (const blk_req_msg_t *)buf;
     int op_rc = dispatch_one_request(cli, req);
-    if (op_rc == -1) return;  /* IDENTIFY sent inline */
+    if (op_rc == -1) return 1;  /* IDENTIFY sent inline */
 
     if (op_rc != 0) {
         blk_resp_msg_t resp = {0};
@@ -881,6 +887,7 @@ static void handle_client_request(ahcid_client_t *cli) {
                            &resp, sizeof(resp));
     }
     cli->reqs_handled++;
+    return 1;
 }
 
 // Phase 24a W5: drain SPSC ring slots. Polls all 64 slots; for each
@@ -945,7 +952,8 @@ static void drain_spsc_ring(ahcid_client_t *cli) {
     }
 }
 
-static void try_accept_new_client(void) {
+// Returns the newly connected client, or NULL if nothing was accepted.
+static ahcid_client_t *try_accept_new_client(void) {
     // Phase 22 chan-publish/connect mints a new pair on accept; the new
     // pair's read+write endpoints arrive as handles on s_accept_chan_rd.
     uint8_t nh = 0;
@@ -953,13 +961,13 @@ static void try_accept_new_client(void) {
     uint8_t inline_buf[CHAN_MSG_INLINE_MAX];
     long rc = recv_payload_h(s_accept_chan_rd, inline_buf, sizeof(inline_buf),
                              handles, &nh, 0);
-    if (rc < 0) return;
-    if (nh < 2) return;
+    if (rc < 0) return NULL;
+    if (nh < 2) return NULL;
 
     ahcid_client_t *cli = new_client_slot();
     if (!cli) {
         printf("[ahcid] client table full\n");
-        return;
+        return NULL;
     }
     cli->client_chan_read  = handles[0].raw;
     cli->client_chan_write = handles[1].raw;
@@ -988,12 +996,12 @@ static void try_accept_new_client(void) {
         printf("[ahcid] bad connect handshake from client crc=%ld magic=0x%x ver=%u nh=%u\n",
                crc, (unsigned)cm.magic, (unsigned)cm.version, (unsigned)cm_nh);
         cli->in_use = 0;
-        return;
+        return NULL;
     }
     if (cm_nh < 1 || cm_handles[0].raw == 0) {
         printf("[ahcid] connect handshake missing DMA VMO handle\n");
         cli->in_use = 0;
-        return;
+        return NULL;
     }
     cli->dma_vmo_handle = cm_handles[0].raw;
 
@@ -1017,85 +1025,153 @@ static void try_accept_new_client(void) {
             cli->spsc_ring       = NULL;
         } else {
             cli->spsc_ring = (void *)mrc;
-            printf("[ahcid] client connected dma_vmo=0x%llx spsc_vmo=0x%llx ring=%p\n",
+            /* Phase 26: the kernel signals handles[2] (a notify object)
+             * after each ring post; without it we rely on chan_kick. */
+            if (cm_nh >= 3 && cm_handles[2].raw != 0) {
+                cli->req_notify = cm_handles[2].raw;
+            }
+            printf("[ahcid] client connected dma_vmo=0x%llx spsc_vmo=0x%llx ring=%p notify=%s\n",
                    (unsigned long long)cli->dma_vmo_handle,
                    (unsigned long long)cli->spsc_vmo_handle,
-                   cli->spsc_ring);
-            return;
+                   cli->spsc_ring, cli->req_notify ? "yes" : "no");
+            return cli;
         }
     }
     printf("[ahcid] client connected dma_vmo=0x%llx (legacy chan path)\n",
            (unsigned long long)cli->dma_vmo_handle);
+    return cli;
 }
 
-void ahcid_main_loop(void) {
+// Phase 26: wait-set cookies. Clients use their g_ahcid.clients[] index.
+#define AHCID_WS_IRQ     0x100u
+#define AHCID_WS_ACCEPT  0x101u
+
+static uint64_t s_waitset = 0;
+
+// True while any HBA command slot is still outstanding; the wait-set loop
+// then bounds its sleep so poll_complete_slots still backstops a lost IRQ.
+static int any_slot_in_flight(void) {
+    for (uint32_t p = 0; p < AHCID_MAX_PORTS; p++) {
+        for (uint32_t s = 0; s < g_ahcid.ncs; s++) {
+            if (g_ahcid.ports[p].slot[s].in_use) return 1;
+        }
+    }
+    return 0;
+}
+
+// Register a client's request channel edge-triggered: the kernel kicks it
+// both for chan_send'd requests and, when it has no notify object, for
+// SPSC ring posts (chan_kick). The ring notify, if any, is registered
+// under the same cookie; it stays readable until service_client collects
+// it, and service_client drains the ring and the channel until empty.
+static void ws_add_client(ahcid_client_t *cli) {
+    if (!s_waitset) return;
+    uint32_t i = (uint32_t)(cli - g_ahcid.clients);
+    long rc = syscall_waitset_ctl(s_waitset, WAITSET_CTL_ADD,
+                                  cli->client_chan_read,
+                                  WAITSET_EV_READABLE | WAITSET_EDGE, i);
+    if (rc < 0) printf("[ahcid] waitset add client %u rc=%ld\n", i, rc);
+    if (cli->req_notify) {
+        rc = syscall_waitset_ctl(s_waitset, WAITSET_CTL_ADD, cli->req_notify,
+                                 WAITSET_EV_READABLE, i);
+        if (rc < 0) printf("[ahcid] waitset add notify %u rc=%ld\n", i, rc);
+    }
+}
+
+static void service_client(ahcid_client_t *cli) {
+    /* Collect the doorbell BEFORE scanning the ring: a post that lands
+     * after the scan re-signals an empty word and wakes us again. */
+    if (cli->req_notify) (void)syscall_notify_wait(cli->req_notify, 0);
+    if (cli->spsc_ring) drain_spsc_ring(cli);
+    while (handle_client_request(cli)) { }
+}
+
+// Pre-Phase-26 loop, kept for kernels without SYS_WAITSET_*. Services every
+// source each iteration and spins on the SPSC rings while any are mapped.
+static void ahcid_poll_loop(void) {
     drv_irq_msg_t irq_msgs[8];
     uint64_t cap_irq_handle = g_ahcid.caps.irq_channel_handle;
     while (1) {
-        /* Phase 23 Step 3.C latency optimisation: drain pending client
-         * requests FIRST so a kernel blk_req that arrived during the last
-         * iteration is seen immediately (rather than after the 5 ms IRQ
-         * wait).  Then handle any completed IRQs.  Then drv_irq_wait
-         * with a SHORT 1 ms cap (was 5) — keeps idle CPU low while
-         * minimising the IRQ-to-response window.
-         *
-         * Phase 24a W5: when any client has the SPSC ring mapped, the
-         * 1 ms drv_irq_wait timeout is the dominant per-op latency cost
-         * (kernel writes to ring → ahcid only sees it on next loop iter
-         * up to 1 ms later). Switch to non-blocking drv_irq_wait + a
-         * userspace sched_yield to give other tasks a chance without
-         * adding wake-up latency. Burns CPU on ahcid's pinning but in
-         * the gate (4 CPUs, ahcid mostly alone on its CPU) that's
-         * acceptable. The yield itself is a syscall with ~us overhead;
-         * total per-iter cost is ~us instead of ~ms. */
         int spsc_active = 0;
-
-        // 1. Try to accept a new client on /sys/blk/service.
-        try_accept_new_client();
-
-        // 2. Drain per-client request paths FIRST (latency-critical).
-        // Phase 24a W5: poll the shared SPSC ring (if mapped) before the
-        // legacy chan_recv path. Ring polling is lock-free and ~ns per
-        // slot; the legacy path stays as a compat fallback for v1
-        // connect frames.
+        (void)try_accept_new_client();
         for (uint32_t i = 0; i < AHCID_MAX_CLIENTS; i++) {
             if (!g_ahcid.clients[i].in_use) continue;
             if (g_ahcid.clients[i].spsc_ring) {
                 drain_spsc_ring(&g_ahcid.clients[i]);
                 spsc_active = 1;
             }
-            handle_client_request(&g_ahcid.clients[i]);
+            (void)handle_client_request(&g_ahcid.clients[i]);
         }
-
-        // 3. Wait for IRQs. With SPSC ring active, use timeout=0
-        //    (non-blocking) so we can re-check the ring next iteration
-        //    without sleeping; without SPSC, retain the 1 ms cap.
         uint32_t to = spsc_active ? 0u : 1u;
         long n = drv_irq_wait(cap_irq_handle, irq_msgs, 8, to);
-        if (n > 0) {
-            for (long i = 0; i < n; i++) handle_irq();
-        }
-
-        // 3b. FU24.A/B (#660): unconditionally poll-harvest completed HBA
-        //     slots every iteration, independent of whether an IRQ arrived.
-        //     Closes the lost/missed-IRQ window in handle_irq that otherwise
-        //     strands a finished command until the kernel's 5 s timeout,
-        //     compounding into the per-op grind that tips the gate past its
-        //     watchdog. Cheap: one PxCI MMIO read per present port + a scan
-        //     that early-outs on !in_use slots.
+        for (long i = 0; i < n; i++) handle_irq();
         poll_complete_slots();
-
-        // 4. With SPSC active and no IRQs, emit `pause` instructions so
-        //    we don't burn 100% CPU for nothing while still resuming the
-        //    ring poll within ~ns. SMT-friendly hint to the CPU; in TCG
-        //    it's basically a NOP. No syscall = no context switch =
-        //    request seen on next iteration with no added wake latency.
         if (spsc_active && n == 0) {
             for (int p = 0; p < 16; p++) asm volatile("pause" ::: "memory");
         }
     }
 }
 
+void ahcid_main_loop(void) {
+    /* Phase 26: one SYS_WAITSET_WAIT covers the IRQ channel, the accept
+     * channel and every client request channel, so ahcid sleeps until
+     * there is work instead of spinning with `pause` on the SPSC rings or
+     * ticking drv_irq_wait at 1 ms. The kernel's blk_spsc_post_req signals
+     * the client's ring notify object (or kicks the request channel) after
+     * publishing a slot, which wakes us with the client's cookie; request
+     * latency is one wakeup instead of up to one loop iteration.
+     *
+     * FU24.A/B (#660) is preserved: poll_complete_slots still runs after
+     * every wakeup, and while any command is in flight the wait is bounded
+     * (one scheduler tick) so a lost completion IRQ can't strand a slot
+     * until the kernel's 5 s timeout. With nothing in flight we block
+     * indefinitely. */
+    drv_irq_msg_t irq_msgs[8];
+    waitset_event_t ev[AHCID_MAX_CLIENTS + 2];
+    uint64_t cap_irq_handle = g_ahcid.caps.irq_channel_handle;
+
+    long ws = syscall_waitset_create();
+    if (ws <= 0) {
+        printf("[ahcid] waitset_create rc=%ld; falling back to polling\n", ws);
+        ahcid_poll_loop();
+        return;
+    }
+    s_waitset = (uint64_t)ws;
+    if (syscall_waitset_ctl(s_waitset, WAITSET_CTL_ADD, cap_irq_handle,
+                            WAITSET_EV_READABLE, AHCID_WS_IRQ) < 0 ||
+        syscall_waitset_ctl(s_waitset, WAITSET_CTL_ADD, s_accept_chan_rd.raw,
+                            WAITSET_EV_READABLE, AHCID_WS_ACCEPT) < 0) {
+        printf("[ahcid] waitset registration failed; falling back to polling\n");
+        s_waitset = 0;
+        ahcid_poll_loop();
+        return;
+    }
+
+    while (1) {
+        uint64_t to = any_slot_in_flight() ? 1000ull * 1000 : WAITSET_FOREVER;
+        long n = syscall_waitset_wait(s_waitset, ev, AHCID_MAX_CLIENTS + 2, to);
+        for (long e = 0; e < n; e++) {
+            uint64_t ck = ev[e].cookie;
+            if (ck == AHCID_WS_IRQ) {
+                long k = drv_irq_wait(cap_irq_handle, irq_msgs, 8, 0);
+                for (long i = 0; i < k; i++) handle_irq();
+            } else if (ck == AHCID_WS_ACCEPT) {
+                ahcid_client_t *cli;
+                while ((cli = try_accept_new_client()) != NULL) {
+                    ws_add_client(cli);
+                    // A post or kick that landed before the registration
+                    // raised no event (the channel is edge-triggered), so
+                    // drain whatever is already there.
+                    service_client(cli);
+                }
+            } else if (ck < AHCID_MAX_CLIENTS && g_ahcid.clients[ck].in_use) {
+                service_client(&g_ahcid.clients[ck]);
+            }
+        }
+        poll_complete_slots();
+    }
+}
+
 // ===========================================================================
 // ENTRY
 // ===========================================================================
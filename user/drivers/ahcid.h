@@ -212,6 +212,7 @@ typedef struct {
     uint64_t dma_vmo_handle;     /* Caller's shared DMA VMO (full 64-bit) */
     uint64_t spsc_vmo_handle;    /* W5: SPSC ring VMO (0 = legacy path) */
     void    *spsc_ring;          /* W5: mapped ring (NULL = legacy path) */
+    uint64_t req_notify;         /* Phase 26: ring doorbell notify (0 = none) */
     int32_t  client_pid;         /* For audit + cleanup */
     uint32_t reqs_handled;
 } ahcid_client_t;
@@ -11,11 +11,14 @@
 //      filtering, init RX/TX descriptor rings.
 //   3. Send ANNOUNCE message on caps.downstream_handle so the kernel-side
 //      proxy can cache MAC + link + ring physical addresses.
-//   4. Enable interrupts (IMS = RXT0 | RXSEQ | LSC | TXDW).
+//   4. Program interrupt moderation (ITR/RDTR/RADV), enable interrupts
+//      (IMS = RXT0 | RXDMT0 | RXO | RXSEQ | LSC | TXDW).
 //   5. Main loop:
-//        - drv_irq_wait(caps.irq_channel_handle, msgs, 16, 100)
-//        - For each IRQ: read ICR, drain RX descriptors → RX_NOTIFY,
-//          handle LSC link-state changes, ack TX completions
+//        - drv_irq_wait(caps.irq_channel_handle, msgs, 16, 100), or a
+//          zero-timeout poll while RX is in NAPI polling mode
+//        - For each IRQ: read ICR, drain RX descriptors → RX_NOTIFY (or
+//          the shared ring index block, Phase 26), handle LSC link-state
+//          changes, ack TX completions
 //        - Non-blocking chan_recv on caps.upstream_handle for TX_NOTIFY:
 //          copy slot data into next free TX descriptor + bump TDT.
 //   6. On any -EPIPE / -EBADF from channels (kernel revoked our caps),
@@ -52,6 +55,12 @@ static int                  s_rawframe_ready = 0;
 static int                  s_rawframe_accepts = 0;
 static rawframe_peer_t      s_rawframe_peers[E1000D_MAX_RAWFRAME_PEERS];
 
+// Phase 26: ring index VMO (rawframe_ring_ctl_t + one entry per slot and
+// direction). The NIC never touches it; it is a DMA allocation only so it
+// can be cloned SHARED like the frame rings.
+#define E1000D_CTL_PAGES  ((RAWFRAME_RING_BYTES(E1000D_RING_SLOTS) + 4095u) / 4096u)
+_Static_assert(E1000D_CTL_PAGES <= 64, "ring index VMO over the contiguous cap");
+
 // ====================================================================
 // MMIO accessors. The mapped BAR pointer is set in _start after
 // drv_mmio_map returns. Volatile reads/writes; mfence as needed for
@@ -149,11 +158,13 @@ static uint8_t    s_mac[6];
 
 // Frame ring VMOs (shared with kernel proxy via phys addresses in ANNOUNCE,
 // and with netd via VMO_CLONE_SHARED — see Phase 22 Stage B rawframe ANNOUNCE).
+// Phase 26: the rings are scatter VMOs, so we keep one phys address per
+// page and resolve slot → phys through slot_phys().
 static uint8_t    *s_rx_ring_va = (uint8_t *)0;
-static uint64_t    s_rx_ring_phys = 0;
+static uint64_t    s_rx_page_phys[E1000D_RING_PAGES];
 static cap_token_u_t s_rx_ring_handle = {.raw = 0};    // Phase 22 Stage B
 static uint8_t    *s_tx_ring_va = (uint8_t *)0;
-static uint64_t    s_tx_ring_phys = 0;
+static uint64_t    s_tx_page_phys[E1000D_RING_PAGES];
 static cap_token_u_t s_tx_ring_handle = {.raw = 0};    // Phase 22 Stage B
 
 // Descriptor rings (separate from frame-data rings — the NIC's RDBAL/RDBAH
@@ -176,6 +187,337 @@ static uint32_t s_tx_tail = 0;
 // Last observed link state — used to emit LINK_UP / LINK_DOWN deltas.
 static uint8_t  s_link_state_last = 0;
 
+// Phase 26: NAPI-style RX state. While s_rx_polling is set the RX causes
+// are masked in IMS and the main loop drains the ring without blocking.
+static uint8_t  s_rx_polling = 0;
+static uint32_t s_rx_idle_polls = 0;
+// Lifetime MPC / RNBC totals (both registers clear on read).
+static uint32_t s_rx_missed = 0;
+static uint32_t s_rx_nobuf = 0;
+static uint32_t s_rx_overruns = 0;   // Samples that saw either move
+
+// Phase 26: ring hand-off state. s_ring_peer is the one rawframe peer the
+// index block was announced to (-1 = none; every frame then goes out as
+// RX_NOTIFY and its descriptor is recycled at once). The counters are
+// free-running like the ones in the block; frame k is in slot k % N.
+static rawframe_ring_ctl_t *s_ring = (rawframe_ring_ctl_t *)0;
+static cap_token_u_t s_ring_handle = {.raw = 0};
+static int      s_ring_peer = -1;
+static uint32_t s_rx_prod = 0;       // Frames taken off the NIC
+static uint32_t s_rx_recycled = 0;   // Frames whose descriptor is back with the NIC
+static uint32_t s_tx_taken = 0;      // TX entries handed to tx_submit
+static uint32_t s_tx_reaped = 0;     // TX entries the NIC is done with (= tx_cons)
+#define E1000D_TX_PEND_NONE  0xFFFFFFFFu
+static uint32_t s_tx_pend_desc[E1000D_RING_SLOTS];  // Last descriptor per taken entry
+
+static inline uint64_t slot_phys(const uint64_t *page_phys, uint32_t slot) {
+    return page_phys[slot / E1000D_SLOTS_PER_PAGE] +
+           (uint64_t)(slot % E1000D_SLOTS_PER_PAGE) * E1000D_SLOT_SIZE;
+}
+
+// ====================================================================
+// RX drain. Any descriptor with DD set has a fresh frame already DMA'd
+// into the shared rx_ring VMO at slot s_rx_tail. No copy needed: just
+// notify each rawframe peer. (Zero-copy RX.)
+//
+// Phase 22 Stage F: dual-fanout retired.  The kernel-side proxy is gone
+// with Mongoose, so RX_NOTIFY only flows to userspace rawframe peers
+// (netd today; future named clients).
+//
+// Phase 26: at most `budget` frames per call, and RDT is written once for
+// the whole batch instead of once per frame. Returns the frames consumed.
+// The ring peer gets the batch through the index block with at most one
+// RX_KICK, and its descriptors go back to the NIC only once it releases
+// them (rx_refill); other peers still get one RX_NOTIFY per frame.
+// ====================================================================
+// Phase 26: translate the descriptor's checksum verdict (RXCSUM offload)
+// into RAWFRAME_RX_* bits. IXSM means the NIC did not look at all.
+static uint8_t rx_csum_flags(const e1000_rx_desc_t *d) {
+    if (d->status & E1000_RXD_STAT_IXSM) return 0;
+    uint8_t f = 0;
+    if ((d->status & E1000_RXD_STAT_IPCS) && !(d->errors & E1000_RXD_ERR_IPE))
+        f |= RAWFRAME_RX_IP_CSUM_OK;
+    if ((d->status & E1000_RXD_STAT_TCPCS) && !(d->errors & E1000_RXD_ERR_TCPE))
+        f |= RAWFRAME_RX_L4_CSUM_OK;
+    return f;
+}
+
+static void rawframe_peer_drop(int pi) {
+    s_rawframe_peers[pi].in_use = 0;
+    if (pi == s_ring_peer) s_ring_peer = -1;   // rx_refill stops waiting on it
+}
+
+static int rawframe_peer_send(int pi, uint8_t op, uint8_t flags,
+                              uint32_t slot, uint32_t length) {
+    chan_msg_user_t rm;
+    memset(&rm, 0, sizeof(rm));
+    rm.header.inline_len = (uint16_t)sizeof(rawframe_slot_msg_t);
+    rm.header.type_hash  = s_rawframe_svc.payload_type_hash;
+    rawframe_slot_msg_t *sm = (rawframe_slot_msg_t *)rm.inline_payload;
+    sm->op     = op;
+    sm->flags  = flags;
+    sm->slot   = slot;
+    sm->length = length;
+    long rcp = syscall_chan_send(s_rawframe_peers[pi].wr_resp, &rm, 0);
+    if (rcp == -32 /*-EPIPE*/) rawframe_peer_drop(pi);
+    return (int)rcp;
+}
+
+// Phase 26: give released descriptors back to the NIC, up to the ring
+// peer's rx_cons or, without one, everything drained so far. One RDT
+// write per call.
+static void rx_refill(void) {
+    uint32_t upto = s_rx_prod;
+    if (s_ring_peer >= 0) {
+        uint32_t cons = __atomic_load_n(&s_ring->rx_cons, __ATOMIC_ACQUIRE);
+        // Ignore a cursor outside [recycled, prod]: the peer is confused.
+        upto = (cons - s_rx_recycled <= s_rx_prod - s_rx_recycled)
+                   ? cons : s_rx_recycled;
+    }
+    if (upto == s_rx_recycled) return;
+    uint32_t last = 0;
+    while (s_rx_recycled != upto) {
+        last = s_rx_recycled & (E1000D_RING_SLOTS - 1u);
+        s_rx_descs[last].status = 0;
+        s_rx_recycled++;
+    }
+    mfence();  // Cleared status words visible before the NIC reuses them.
+    mmio_write(E1000_RDT, last);
+}
+
+static uint32_t rx_drain(uint32_t budget) {
+    uint32_t done = 0;
+    rawframe_ring_ent_t *ents =
+        (s_ring_peer >= 0) ? rawframe_ring_rx(s_ring) : (rawframe_ring_ent_t *)0;
+    // An unreleased descriptor keeps DD set, so stop before lapping one.
+    while (done < budget &&
+           s_rx_prod - s_rx_recycled < E1000D_RING_SLOTS &&
+           (s_rx_descs[s_rx_tail].status & E1000_DESC_DD)) {
+        uint16_t pkt_len = s_rx_descs[s_rx_tail].length;
+        if (pkt_len > E1000D_SLOT_SIZE) pkt_len = E1000D_SLOT_SIZE;
+        uint8_t flags = rx_csum_flags(&s_rx_descs[s_rx_tail]);
+        if (ents) {
+            rawframe_ring_ent_t *e = &ents[s_rx_tail];
+            e->slot   = s_rx_tail;
+            e->length = pkt_len;
+            e->flags  = flags;
+            e->_pad   = 0;
+            e->mss    = 0;
+        }
+        if (pkt_len > 0) {
+            // Per-frame fanout to the peers without the ring.
+            for (int pi = 0; pi < E1000D_MAX_RAWFRAME_PEERS; pi++) {
+                if (!s_rawframe_peers[pi].in_use || pi == s_ring_peer) continue;
+                (void)rawframe_peer_send(pi, RAWFRAME_OP_RX_NOTIFY, flags,
+                                         s_rx_tail, pkt_len);
+            }
+        }
+        s_rx_tail = (s_rx_tail + 1) & (E1000D_RING_SLOTS - 1u);
+        s_rx_prod++;
+        done++;
+    }
+    if (done && s_ring_peer >= 0) {
+        // Publish the batch, then kick only if the peer armed it; the
+        // seq-cst pair closes the race with its arm-then-recheck.
+        __atomic_store_n(&s_ring->rx_prod, s_rx_prod, __ATOMIC_SEQ_CST);
+        if (__atomic_exchange_n(&s_ring->rx_kick, 0, __ATOMIC_SEQ_CST)) {
+            (void)rawframe_peer_send(s_ring_peer, RAWFRAME_OP_RX_KICK, 0,
+                                     0, 0);
+        }
+    }
+    rx_refill();
+    return done;
+}
+
+// Fold the clear-on-read drop counters into the lifetime totals and log
+// when they move. Any growth means the ring ran dry under load. A flood
+// raises RXO on every ITR interval, so only the 1st, 2nd, 4th, 8th, ...
+// overrun is logged; the totals stay exact either way.
+static void rx_account_drops(void) {
+    uint32_t mpc  = mmio_read(E1000_MPC);
+    uint32_t rnbc = mmio_read(E1000_RNBC);
+    if (mpc == 0 && rnbc == 0) return;
+    s_rx_missed += mpc;
+    s_rx_nobuf  += rnbc;
+    s_rx_overruns++;
+    if ((s_rx_overruns & (s_rx_overruns - 1u)) != 0) return;
+    printf("[e1000d] rx overrun #%u: missed=%u nobuf=%u (ring=%u)\n",
+           (unsigned)s_rx_overruns, (unsigned)s_rx_missed,
+           (unsigned)s_rx_nobuf, (unsigned)E1000D_RING_SLOTS);
+}
+
+// ====================================================================
+// TX submit. Points descriptors straight at the shared TX ring slot(s)
+// the producer filled (zero-copy; the descriptor index and the slot index
+// are independent — descriptors round-robin via s_tx_tail, slots
+// round-robin in the producer via its own cursor).
+//
+// Phase 26: `flags` (RAWFRAME_TX_*) asks for checksum insertion and TSO.
+// Those go through one context descriptor followed by extended data
+// descriptors, one per 2 KiB slot; a TSO super-segment spans consecutive
+// slots. The checksum context stays loaded in the NIC between frames, so
+// it is only re-sent when the header layout changes. Returns 0, -1 if the
+// request is malformed, or -2 if the ring has no room (the message paths
+// drop the frame; the ring path retries it on the next pass).
+// ====================================================================
+static uint32_t s_tx_ctx_key = 0;   // Last checksum context loaded; 0 = none
+
+// Phase 26: retire ring TX entries whose last descriptor the NIC has
+// written back, in order, and publish the count as tx_cons so the peer
+// may reuse their slots. tx_submit runs this before it overwrites any
+// completed descriptor, so no completion is lost to reuse.
+static void tx_reap(void) {
+    while (s_tx_reaped != s_tx_taken) {
+        uint32_t d = s_tx_pend_desc[s_tx_reaped & (E1000D_RING_SLOTS - 1u)];
+        if (d != E1000D_TX_PEND_NONE && !(s_tx_descs[d].status & E1000_DESC_DD))
+            break;
+        s_tx_reaped++;
+    }
+    if (s_ring_peer >= 0) {
+        __atomic_store_n(&s_ring->tx_cons, s_tx_reaped, __ATOMIC_RELEASE);
+    }
+}
+
+static int tx_submit(uint32_t slot, uint32_t len, uint8_t flags, uint16_t mss) {
+    if (slot >= E1000D_RING_SLOTS || len == 0) return -1;
+    uint32_t nslots = (len + E1000D_SLOT_SIZE - 1u) / E1000D_SLOT_SIZE;
+    if (nslots > 1 && (!(flags & RAWFRAME_TX_TSO) ||
+                       len > RAWFRAME_TSO_MAX_BYTES ||
+                       slot + nslots > E1000D_RING_SLOTS)) {
+        return -1;
+    }
+
+    // Header geometry for the offload context: Ethernet + IPv4 + TCP/UDP.
+    e1000_tx_ctx_desc_t ctx = {0};
+    uint32_t ctx_key = 0;
+    uint8_t  popts = 0;
+    if (flags) {
+        const uint8_t *f = s_tx_ring_va + (uint64_t)slot * E1000D_SLOT_SIZE;
+        if (len < 14 + 20 || f[12] != 0x08 || f[13] != 0x00) return -1;
+        uint32_t ihl = (uint32_t)(f[14] & 0x0Fu) * 4u;
+        uint8_t  proto = f[14 + 9];
+        uint8_t  is_tcp = (proto == 6) ? 1u : 0u;
+        if (ihl < 20 || (!is_tcp && proto != 17)) return -1;
+        if ((flags & RAWFRAME_TX_TSO) && (!is_tcp || mss == 0)) return -1;
+        uint32_t l4 = 14u + ihl;
+        if (len < l4 + (is_tcp ? 20u : 8u)) return -1;
+
+        ctx.ipcss = 14;
+        ctx.ipcso = 14 + 10;
+        ctx.ipcse = (uint16_t)(l4 - 1u);
+        ctx.tucss = (uint8_t)l4;
+        ctx.tucso = (uint8_t)(l4 + (is_tcp ? 16u : 6u));
+        ctx.tucse = 0;
+        uint32_t tucmd = E1000_TXD_CMD_DEXT | E1000_TXD_CMD_RS |
+                         E1000_TXC_TUCMD_IP | (is_tcp ? E1000_TXC_TUCMD_TCP : 0u);
+        if (flags & RAWFRAME_TX_TSO) {
+            uint32_t hdr = l4 + (uint32_t)(f[l4 + 12] >> 4) * 4u;
+            if (hdr >= len || hdr > 255u) return -1;
+            tucmd |= E1000_TXD_CMD_TSE;
+            ctx.hdr_len = (uint8_t)hdr;
+            ctx.mss     = mss;
+            ctx.cmd_len = (len - hdr) | (E1000_TXD_DTYP_CTX << 20) | (tucmd << 24);
+            ctx_key = 0;    // Per-frame PAYLEN: never reusable.
+            popts = E1000_TXD_POPTS_IXSM | E1000_TXD_POPTS_TXSM;
+        } else {
+            ctx.cmd_len = (E1000_TXD_DTYP_CTX << 20) | (tucmd << 24);
+            ctx_key = 0x80000000u | (l4 << 8) | ctx.tucso;
+            if (flags & RAWFRAME_TX_IP_CSUM) popts |= E1000_TXD_POPTS_IXSM;
+            if (flags & RAWFRAME_TX_L4_CSUM) popts |= E1000_TXD_POPTS_TXSM;
+        }
+    }
+    uint32_t need_ctx = (flags && (ctx_key == 0 || ctx_key != s_tx_ctx_key)) ? 1u : 0u;
+    uint32_t need = need_ctx + nslots;
+
+    // Wait for the last descriptor we need to be free (DD set). The NIC
+    // completes in order, so every earlier one is free too. Brief spin —
+    // under load this should always succeed quickly.
+    uint32_t last = (s_tx_tail + need - 1u) & (E1000D_RING_SLOTS - 1u);
+    int spin = 0;
+    while (!(s_tx_descs[last].status & E1000_DESC_DD) && spin++ < 1000) {
+        cpu_pause();
+    }
+    if (!(s_tx_descs[last].status & E1000_DESC_DD)) return -2;
+    tx_reap();
+
+    if (need_ctx) {
+        ctx.status = 0;
+        *(e1000_tx_ctx_desc_t *)&s_tx_descs[s_tx_tail] = ctx;
+        s_tx_ctx_key = ctx_key;
+        s_tx_tail = (s_tx_tail + 1) & (E1000D_RING_SLOTS - 1u);
+    }
+    for (uint32_t i = 0; i < nslots; i++) {
+        uint32_t chunk = len - i * E1000D_SLOT_SIZE;
+        if (chunk > E1000D_SLOT_SIZE) chunk = E1000D_SLOT_SIZE;
+        uint32_t cmd = E1000_TXD_CMD_IFCS | E1000_TXD_CMD_RS |
+                       ((i + 1 == nslots) ? E1000_TXD_CMD_EOP : 0u);
+        if (flags) {
+            e1000_tx_data_desc_t *d =
+                (e1000_tx_data_desc_t *)&s_tx_descs[s_tx_tail];
+            cmd |= E1000_TXD_CMD_DEXT |
+                   ((flags & RAWFRAME_TX_TSO) ? E1000_TXD_CMD_TSE : 0u);
+            d->addr    = slot_phys(s_tx_page_phys, slot + i);
+            d->cmd_len = chunk | (E1000_TXD_DTYP_DATA << 20) | (cmd << 24);
+            d->popts   = popts;
+            d->special = 0;
+            d->status  = 0;  // NIC sets DD when done
+        } else {
+            e1000_tx_desc_t *d = &s_tx_descs[s_tx_tail];
+            d->addr    = slot_phys(s_tx_page_phys, slot + i);
+            d->length  = (uint16_t)chunk;
+            d->cmd     = (uint8_t)cmd;
+            d->cso     = 0;
+            d->css     = 0;
+            d->special = 0;
+            d->status  = 0;  // NIC sets DD when done
+        }
+        s_tx_tail = (s_tx_tail + 1) & (E1000D_RING_SLOTS - 1u);
+    }
+
+    mfence();  // Ensure descriptors visible before TDT poke.
+    mmio_write(E1000_TDT, s_tx_tail);
+    return 0;
+}
+
+// Phase 26: submit whatever the ring peer queued since the last pass
+// (bounded like the TX_REQ drain) and retire what the NIC finished.
+static void tx_ring_poll(void) {
+    if (s_ring_peer < 0) return;
+    const rawframe_ring_ent_t *ents = rawframe_ring_tx(s_ring, E1000D_RING_SLOTS);
+    uint32_t prod = __atomic_load_n(&s_ring->tx_prod, __ATOMIC_ACQUIRE);
+    if (prod - s_tx_reaped > E1000D_RING_SLOTS) prod = s_tx_taken;  // Overrun: ignore
+    for (uint32_t n = 0; n < E1000D_NAPI_BUDGET && s_tx_taken != prod; n++) {
+        rawframe_ring_ent_t e = ents[s_tx_taken & (E1000D_RING_SLOTS - 1u)];
+        int rc = tx_submit(e.slot, e.length, e.flags, e.mss);
+        if (rc == -2) break;   // NIC ring full: leave it queued
+        s_tx_pend_desc[s_tx_taken & (E1000D_RING_SLOTS - 1u)] =
+            (rc < 0) ? E1000D_TX_PEND_NONE
+                     : ((s_tx_tail - 1u) & (E1000D_RING_SLOTS - 1u));
+        s_tx_taken++;
+    }
+    tx_reap();
+}
+
+// Phase 26: reset the index block for a newly announced ring peer. It
+// starts at the current counters: every earlier RX frame has already been
+// recycled (no peer held them) and stale TX entries are skipped.
+static void ring_bind_prepare(void) {
+    s_tx_taken  = s_ring->tx_prod;
+    s_tx_reaped = s_tx_taken;
+    s_ring->tx_cons = s_tx_taken;
+    s_ring->rx_prod = s_rx_prod;
+    s_ring->rx_cons = s_rx_prod;
+    __atomic_store_n(&s_ring->rx_kick, 1u, __ATOMIC_SEQ_CST);
+}
+
+// Phase 26: give back a ring clone nobody received. A retiring map is the
+// one call that frees a handle-table slot (see VMO_MAP_RETIRE).
+static void ring_clone_drop(cap_token_u_t clone) {
+    if (clone.raw == 0) return;
+    long va = syscall_vmo_map(clone, 0, 0, 4096u, PROT_READ | VMO_MAP_RETIRE);
+    if (va > 0) (void)syscall_vmo_unmap((uint64_t)va, 4096u);
+}
+
 // ====================================================================
 // Send the ANNOUNCE message on the downstream channel. The proxy will
 // receive this on its first proxy_try_bind() poll and transition to
@@ -192,8 +534,8 @@ static int send_announce(void) {
     body->op = E1000_OP_ANNOUNCE;
     for (int i = 0; i < 6; i++) body->mac[i] = s_mac[i];
     body->link_up      = (mmio_read(E1000_STATUS) & E1000_STATUS_LU) ? 1u : 0u;
-    body->rx_ring_phys = s_rx_ring_phys;
-    body->tx_ring_phys = s_tx_ring_phys;
+    body->rx_ring_phys = s_rx_page_phys[0];
+    body->tx_ring_phys = s_tx_page_phys[0];
     body->slot_count   = E1000D_RING_SLOTS;
     body->slot_size    = E1000D_SLOT_SIZE;
 
@@ -245,34 +587,46 @@ void _start(void) {
     //    and with netd via the rawframe ANNOUNCE path — see Phase 22
     //    Stage B). We now surface the VMO handles via drv_dma_alloc_ex so
     //    we can vmo_clone(SHARED) + hand off to netd.
-    //    16 slots × 4 KiB each = 64 KiB per direction.
-    s_rx_ring_va = (uint8_t *)drv_dma_alloc_ex(E1000D_RING_SLOTS,
-                                               &s_rx_ring_phys,
+    //    Phase 26: E1000D_RING_SLOTS × 2 KiB per direction (2 MiB at the
+    //    default 1024) — past the 64-page contiguous cap, so these are
+    //    scatter VMOs; a 2 KiB slot never straddles a page.
+    s_rx_ring_va = (uint8_t *)drv_dma_alloc_sg(E1000D_RING_PAGES,
+                                               s_rx_page_phys,
                                                &s_rx_ring_handle);
-    s_tx_ring_va = (uint8_t *)drv_dma_alloc_ex(E1000D_RING_SLOTS,
-                                               &s_tx_ring_phys,
+    s_tx_ring_va = (uint8_t *)drv_dma_alloc_sg(E1000D_RING_PAGES,
+                                               s_tx_page_phys,
                                                &s_tx_ring_handle);
     if (!s_rx_ring_va || !s_tx_ring_va) {
-        printf("[e1000d] FATAL: drv_dma_alloc(rx/tx ring) failed\n");
+        printf("[e1000d] FATAL: drv_dma_alloc_sg(rx/tx ring) failed\n");
         syscall_exit(3);
     }
-    printf("[e1000d] frame rings: rx_phys=0x%lx tx_phys=0x%lx (16 × 4 KiB each)\n",
-           (unsigned long)s_rx_ring_phys, (unsigned long)s_tx_ring_phys);
-
-    // 5. Allocate descriptor rings (separate VMOs — 1 page each).
-    //    Each ring holds E1000D_RING_SLOTS (16) × 16-byte descriptors = 256
-    //    bytes — well under one page, so a single page per ring is plenty.
-    //    Phase 21.1 trims the ring depth from the kernel driver's 256 since
-    //    QEMU under normal traffic never needs more.
-    s_rx_descs = (e1000_rx_desc_t *)drv_dma_alloc(1, &s_rx_descs_phys);
-    s_tx_descs = (e1000_tx_desc_t *)drv_dma_alloc(1, &s_tx_descs_phys);
+    printf("[e1000d] frame rings: %u slots × %u B per direction\n",
+           (unsigned)E1000D_RING_SLOTS, (unsigned)E1000D_SLOT_SIZE);
+
+    // 4b. Phase 26: ring index block for the batched hand-off. Optional —
+    //     without it every peer gets the per-frame message path.
+    {
+        uint64_t ctl_phys = 0;
+        s_ring = (rawframe_ring_ctl_t *)drv_dma_alloc_ex(E1000D_CTL_PAGES,
+                                                         &ctl_phys,
+                                                         &s_ring_handle);
+        if (!s_ring) {
+            printf("[e1000d] WARN: ring index alloc failed — per-frame messages only\n");
+        }
+    }
+
+    // 5. Allocate descriptor rings (separate contiguous VMOs). Phase 26:
+    //    E1000D_RING_SLOTS × 16-byte descriptors is 4 KiB at 256 slots and
+    //    64 KiB at 4096 — within the contiguous cap either way.
+    s_rx_descs = (e1000_rx_desc_t *)drv_dma_alloc(E1000D_DESC_PAGES, &s_rx_descs_phys);
+    s_tx_descs = (e1000_tx_desc_t *)drv_dma_alloc(E1000D_DESC_PAGES, &s_tx_descs_phys);
     if (!s_rx_descs || !s_tx_descs) {
         printf("[e1000d] FATAL: drv_dma_alloc(descriptor rings) failed\n");
         syscall_exit(4);
     }
     // Zero descriptor rings (drv_dma_alloc passes VMO_ZEROED, but be paranoid).
-    memset(s_rx_descs, 0, 4096);
-    memset(s_tx_descs, 0, 4096);
+    memset(s_rx_descs, 0, E1000D_DESC_PAGES * 4096u);
+    memset(s_tx_descs, 0, E1000D_DESC_PAGES * 4096u);
 
     // Phase 21.1: no separate hw-buffer allocations. Descriptor[i].addr
     // points directly at slot i of the shared rx/tx ring VMOs (zero-copy
@@ -299,7 +653,7 @@ void _start(void) {
     //    RDBAL/RDBAH/RDLEN program the ring base + length; RDH=0; RDT = N-1
     //    means all descriptors are owned by the NIC initially.
     for (uint32_t i = 0; i < E1000D_RING_SLOTS; i++) {
-        s_rx_descs[i].addr   = s_rx_ring_phys + (uint64_t)i * E1000D_SLOT_SIZE;
+        s_rx_descs[i].addr   = slot_phys(s_rx_page_phys, i);
         s_rx_descs[i].status = 0;
     }
     mmio_write(E1000_RDBAL, (uint32_t)(s_rx_descs_phys & 0xFFFFFFFFu));
@@ -308,6 +662,9 @@ void _start(void) {
     mmio_write(E1000_RDH, 0);
     mmio_write(E1000_RDT, E1000D_RING_SLOTS - 1);
     s_rx_tail = 0;
+    // Phase 26: have the NIC verify IPv4 and TCP/UDP checksums on receive;
+    // the verdict rides along in each RX_NOTIFY (RAWFRAME_RX_*_OK).
+    mmio_write(E1000_RXCSUM, E1000_RXCSUM_IPOFL | E1000_RXCSUM_TUOFL);
     mmio_write(E1000_RCTL,
                E1000_RCTL_EN | E1000_RCTL_BAM |
                E1000_RCTL_BSIZE_2K | E1000_RCTL_SECRC);
@@ -370,18 +727,31 @@ void _start(void) {
         syscall_exit(7);
     }
 
-    // 11. Enable device interrupts. RXT0 = packet RX, RXSEQ = sequence error
-    //     (sometimes seen during startup), LSC = link-status change, TXDW =
-    //     TX descriptor write-back done. The kernel ISR forwarder posts a
-    //     drv_irq_msg into our SPSC ring on every fire.
-    mmio_write(E1000_IMS, E1000_IMS_RXT0 | E1000_IMS_RXSEQ |
+    // 11. Phase 26: interrupt moderation. ITR bounds the interrupt rate
+    //     for every cause; RDTR/RADV coalesce RX so one interrupt covers a
+    //     burst of frames rather than each frame raising its own.
+    mmio_write(E1000_ITR,  E1000D_ITR_VALUE);
+    mmio_write(E1000_RDTR, E1000D_RDTR_US * 1000u / 1024u);
+    mmio_write(E1000_RADV, E1000D_RADV_US * 1000u / 1024u);
+
+    // 11b. Enable device interrupts. RXT0 = packet RX, RXDMT0 = ring half
+    //      empty (fires ahead of the delay timers under load), RXO = ring
+    //      overrun, RXSEQ = sequence error (sometimes seen during startup),
+    //      LSC = link-status change, TXDW = TX descriptor write-back done.
+    //      The kernel ISR forwarder posts a drv_irq_msg into our SPSC ring
+    //      on every fire.
+    mmio_write(E1000_IMS, E1000D_RX_IRQ_MASK | E1000_IMS_RXSEQ |
                           E1000_IMS_LSC | E1000_IMS_TXDW);
 
     // 12. Main loop. Two paths interleave:
-    //     (a) Block on the IRQ channel (1 s timeout). On any IRQ, read+ack
-    //         ICR, walk RX descriptor ring while DD set, copy frames into
-    //         shared-VMO slots + send RX_NOTIFY, recycle descriptor + bump
-    //         RDT. Handle LSC link-state changes and TX completion.
+    //     (a) Block on the IRQ channel (100 ms timeout). On any IRQ,
+    //         read+ack ICR, walk RX descriptor ring while DD set, send
+    //         RX_NOTIFY per frame, recycle descriptors + bump RDT once.
+    //         Handle LSC link-state changes and TX completion.
+    //         Phase 26: a drain that fills E1000D_NAPI_BUDGET masks the RX
+    //         causes and flips to polling (zero-timeout wait, drain every
+    //         pass); E1000D_NAPI_IDLE_POLLS empty passes flip back.
+    //         Phase 26: the ring peer gets one RX_KICK per batch instead.
     //     (b) Non-blocking chan_recv on the upstream channel for TX_NOTIFY.
     //         Each TX_NOTIFY says "slot X has a frame of len Y ready" —
     //         copy from shared TX VMO into next free hw TX buf, fill
@@ -396,7 +766,8 @@ void _start(void) {
 
     while (1) {
         // ---- (a) IRQ-driven RX + LSC + TX completion ----
-        long n = drv_irq_wait(s_caps.irq_channel_handle, msgs, 16, 100);
+        long n = drv_irq_wait(s_caps.irq_channel_handle, msgs, 16,
+                              s_rx_polling ? 0 : 100);
         if (n == -32 /*-ESHUTDOWN*/) {
             printf("[e1000d] IRQ channel shutdown — exiting\n");
             syscall_exit(0);
@@ -406,49 +777,36 @@ void _start(void) {
             syscall_exit(6);
         }
 
+        // Phase 26: NAPI-style RX. In polling mode the ring is drained on
+        // every pass whether or not an interrupt arrived.
+        if (s_rx_polling) {
+            if (rx_drain(E1000D_NAPI_BUDGET) != 0) {
+                s_rx_idle_polls = 0;
+            } else if (++s_rx_idle_polls >= E1000D_NAPI_IDLE_POLLS) {
+                s_rx_polling = 0;
+                mmio_write(E1000_IMS, E1000D_RX_IRQ_MASK);
+                // A frame that landed after the last empty poll may have
+                // had its cause consumed by an ICR read; pick it up here
+                // rather than waiting for the next one to interrupt.
+                (void)rx_drain(E1000D_NAPI_BUDGET);
+            }
+        } else if (n == 0) {
+            rx_account_drops();   // Idle tick: cheap place to sample stats.
+        }
+
         if (n > 0) {
             // Read+ack ICR (writing it actually clears bits in some E1000
             // variants; the 82540EM clears on read).
             uint32_t icr = mmio_read(E1000_ICR);
 
-            // Drain RX descriptor ring — any with DD set has a fresh frame
-            // already DMA'd into the shared rx_ring VMO at slot s_rx_tail.
-            // No copy needed: just notify each rawframe peer. (Zero-copy RX.)
-            //
-            // Phase 22 Stage F: dual-fanout retired.  The kernel-side proxy
-            // is gone with Mongoose, so RX_NOTIFY only flows to userspace
-            // rawframe peers (netd today; future named clients).
-            while (s_rx_descs[s_rx_tail].status & E1000_DESC_DD) {
-                uint16_t pkt_len = s_rx_descs[s_rx_tail].length;
-                if (pkt_len > E1000D_SLOT_SIZE) pkt_len = E1000D_SLOT_SIZE;
-                if (pkt_len > 0) {
-                    // Rawframe peer fanout.
-                    for (int pi = 0; pi < E1000D_MAX_RAWFRAME_PEERS; pi++) {
-                        if (!s_rawframe_peers[pi].in_use) continue;
-                        chan_msg_user_t rm;
-                        memset(&rm, 0, sizeof(rm));
-                        rm.header.inline_len =
-                            (uint16_t)sizeof(rawframe_slot_msg_t);
-                        rm.header.type_hash  =
-                            s_rawframe_svc.payload_type_hash;
-                        rawframe_slot_msg_t *sm =
-                            (rawframe_slot_msg_t *)rm.inline_payload;
-                        sm->op     = RAWFRAME_OP_RX_NOTIFY;
-                        sm->slot   = s_rx_tail;
-                        sm->length = pkt_len;
-                        long rcp = syscall_chan_send(
-                            s_rawframe_peers[pi].wr_resp, &rm, 0);
-                        if (rcp == -32 /*-EPIPE*/) {
-                            s_rawframe_peers[pi].in_use = 0;
-                        }
-                    }
-                }
-                // Recycle: clear status, advance tail, bump RDT so NIC owns it.
-                s_rx_descs[s_rx_tail].status = 0;
-                uint32_t old = s_rx_tail;
-                s_rx_tail = (s_rx_tail + 1) % E1000D_RING_SLOTS;
-                mmio_write(E1000_RDT, old);
+            if (!s_rx_polling &&
+                rx_drain(E1000D_NAPI_BUDGET) >= E1000D_NAPI_BUDGET) {
+                // Under load: stop taking an interrupt per burst.
+                mmio_write(E1000_IMC, E1000D_RX_IRQ_MASK);
+                s_rx_polling = 1;
+                s_rx_idle_polls = 0;
             }
+            if (icr & E1000_IMS_RXO) rx_account_drops();
 
             // Link-status change: re-read STATUS, emit LINK_UP/DOWN if it flipped.
             if (icr & 0x4u /* LSC bit in ICR */) {
@@ -490,35 +848,10 @@ void _start(void) {
             if (m->op != E1000_OP_TX_NOTIFY) continue;
             uint32_t slot = m->slot;
             uint32_t len  = m->length;
-            if (slot >= E1000D_RING_SLOTS || len == 0 || len > E1000D_SLOT_SIZE) continue;
-
-            // Wait for the next TX descriptor to be available (DD set).
-            // Brief spin — under load this should always succeed quickly.
-            int spin = 0;
-            while (!(s_tx_descs[s_tx_tail].status & E1000_DESC_DD) && spin++ < 1000) {
-                cpu_pause();
-            }
-            if (!(s_tx_descs[s_tx_tail].status & E1000_DESC_DD)) {
-                // TX ring exhausted — drop frame. Mongoose will retry.
-                continue;
-            }
+            if (len > E1000D_SLOT_SIZE) continue;
 
-            // Phase 21.1: zero-copy. Point the TX descriptor directly at the
-            // shared TX ring slot the proxy filled. The NIC DMAs out of that
-            // page; no intermediate buffer needed. Note: descriptor index and
-            // slot index are independent (descriptors round-robin via
-            // s_tx_tail; slots round-robin in proxy via its own cursor).
-            s_tx_descs[s_tx_tail].addr    = s_tx_ring_phys + (uint64_t)slot * E1000D_SLOT_SIZE;
-            s_tx_descs[s_tx_tail].length  = (uint16_t)len;
-            s_tx_descs[s_tx_tail].cmd     = E1000_TXD_CMD_EOP | E1000_TXD_CMD_RS;
-            s_tx_descs[s_tx_tail].status  = 0;  // NIC sets DD when done
-            s_tx_descs[s_tx_tail].cso     = 0;
-            s_tx_descs[s_tx_tail].css     = 0;
-            s_tx_descs[s_tx_tail].special = 0;
-
-            mfence();  // Ensure descriptor visible before TDT poke.
-            s_tx_tail = (s_tx_tail + 1) % E1000D_RING_SLOTS;
-            mmio_write(E1000_TDT, s_tx_tail);
+            // Drops on a full ring are silent — Mongoose will retry.
+            (void)tx_submit(slot, len, 0, 0);
         }
 
         // ---- (c) Phase 22 Stage B/C: rawframe accept + TX_REQ drain ----
@@ -538,10 +871,19 @@ void _start(void) {
                        s_rawframe_accepts, srv.connector_pid,
                        (unsigned)srv.connection_id);
 
+                // Peer slot this connection will take, if any. Phase 26:
+                // the ring index block goes to the first peer that can be
+                // registered while nobody holds it.
+                int slot = -1;
+                for (int pi = 0; pi < E1000D_MAX_RAWFRAME_PEERS; pi++) {
+                    if (!s_rawframe_peers[pi].in_use) { slot = pi; break; }
+                }
+
                 // Clone rx/tx ring VMOs SHARED. Both sides hold live refs;
                 // both can map; writes are immediately visible.
                 cap_token_u_t rx_clone = {.raw = 0};
                 cap_token_u_t tx_clone = {.raw = 0};
+                cap_token_u_t ctl_clone = {.raw = 0};
                 long rc_rx = 0, rc_tx = 0;
                 if (s_rx_ring_handle.raw != 0) {
                     rc_rx = syscall_vmo_clone(s_rx_ring_handle,
@@ -554,16 +896,24 @@ void _start(void) {
                 if (rc_rx <= 0 || rc_tx <= 0) {
                     printf("[e1000d] WARN: rawframe clone rx=%ld tx=%ld — ANNOUNCE skipped\n",
                            rc_rx, rc_tx);
+                    if (rc_rx > 0) ring_clone_drop((cap_token_u_t){ .raw = (uint64_t)rc_rx });
+                    if (rc_tx > 0) ring_clone_drop((cap_token_u_t){ .raw = (uint64_t)rc_tx });
                     continue;
                 }
                 rx_clone.raw = (uint64_t)rc_rx;
                 tx_clone.raw = (uint64_t)rc_tx;
+                if (s_ring && s_ring_peer < 0 && slot >= 0) {
+                    long rc_ctl = syscall_vmo_clone(s_ring_handle,
+                                                    VMO_CLONE_SHARED);
+                    if (rc_ctl > 0) ctl_clone.raw = (uint64_t)rc_ctl;
+                }
 
-                // Build ANNOUNCE: inline body + two handles.
+                // Build ANNOUNCE: inline body + two handles (three with
+                // the ring index block).
                 chan_msg_user_t am;
                 memset(&am, 0, sizeof(am));
                 am.header.inline_len = (uint16_t)sizeof(rawframe_announce_t);
-                am.header.nhandles   = 2;
+                am.header.nhandles   = ctl_clone.raw ? 3 : 2;
                 am.header.type_hash  = s_rawframe_svc.payload_type_hash;
                 rawframe_announce_t *ab =
                     (rawframe_announce_t *)am.inline_payload;
@@ -572,29 +922,39 @@ void _start(void) {
                 ab->link_up     = s_link_state_last;
                 ab->slot_count  = E1000D_RING_SLOTS;
                 ab->slot_size   = E1000D_SLOT_SIZE;
-                ab->reserved    = 0;
+                ab->features    = RAWFRAME_FEAT_TX_CSUM |
+                                  RAWFRAME_FEAT_RX_CSUM |
+                                  RAWFRAME_FEAT_TSO;
                 am.handles[0]   = rx_clone.raw;
                 am.handles[1]   = tx_clone.raw;
+                if (ctl_clone.raw) {
+                    ab->features   |= RAWFRAME_FEAT_RING;
+                    am.handles[2]   = ctl_clone.raw;
+                    ring_bind_prepare();
+                }
 
                 long rc_send = syscall_chan_send(srv.wr_resp, &am,
                                                  1000000000ull /* 1 s */);
                 if (rc_send < 0) {
                     printf("[e1000d] WARN: rawframe ANNOUNCE send rc=%ld (connector_pid=%d)\n",
                            rc_send, srv.connector_pid);
+                    // The clones never left our table. Close them, or
+                    // every failed announce (and the next connect's fresh
+                    // set) strands three handles.
+                    ring_clone_drop(rx_clone);
+                    ring_clone_drop(tx_clone);
+                    ring_clone_drop(ctl_clone);
                     continue;
                 }
                 printf("[e1000d] rawframe ANNOUNCE delivered to pid=%d "
-                       "(rx_vmo=0x%lx tx_vmo=0x%lx link=%u)\n",
+                       "(rx_vmo=0x%lx tx_vmo=0x%lx link=%u ring=%u)\n",
                        srv.connector_pid,
                        (unsigned long)rx_clone.raw,
                        (unsigned long)tx_clone.raw,
-                       (unsigned)s_link_state_last);
+                       (unsigned)s_link_state_last,
+                       ctl_clone.raw ? 1u : 0u);
 
                 // Register the peer so subsequent RX ticks fan frames out.
-                int slot = -1;
-                for (int pi = 0; pi < E1000D_MAX_RAWFRAME_PEERS; pi++) {
-                    if (!s_rawframe_peers[pi].in_use) { slot = pi; break; }
-                }
                 if (slot < 0) {
                     printf("[e1000d] WARN: rawframe peer table full — "
                            "connector_pid=%d dropped from fanout\n",
@@ -605,6 +965,7 @@ void _start(void) {
                 s_rawframe_peers[slot].connector_pid = srv.connector_pid;
                 s_rawframe_peers[slot].rd_req        = srv.rd_req;
                 s_rawframe_peers[slot].wr_resp       = srv.wr_resp;
+                if (ctl_clone.raw) s_ring_peer = slot;
             }
         }
 
@@ -615,17 +976,18 @@ void _start(void) {
         // same physical page (the SHARED clone makes the addresses alias)
         // and point the next free tx descriptor at that page, bumping TDT.
         //
-        // Bounded inner cap (max 8 per peer per tick) so a chatty peer can't
+        // Bounded inner cap (E1000D_NAPI_BUDGET per peer per tick — Phase 26
+        // raised it from 8 with the ring depth) so a chatty peer can't
         // starve the IRQ path.
         for (int pi = 0; pi < E1000D_MAX_RAWFRAME_PEERS; pi++) {
             if (!s_rawframe_peers[pi].in_use) continue;
-            for (int tx = 0; tx < 8; tx++) {
+            for (uint32_t tx = 0; tx < E1000D_NAPI_BUDGET; tx++) {
                 chan_msg_user_t rm;
                 memset(&rm, 0, sizeof(rm));
                 long rc = syscall_chan_recv(s_rawframe_peers[pi].rd_req,
                                             &rm, 0);
                 if (rc == -32 /*-EPIPE*/) {
-                    s_rawframe_peers[pi].in_use = 0;
+                    rawframe_peer_drop(pi);
                     break;
                 }
                 if (rc < 0) break;
@@ -634,32 +996,17 @@ void _start(void) {
                 rawframe_slot_msg_t *sm =
                     (rawframe_slot_msg_t *)rm.inline_payload;
                 if (sm->op != RAWFRAME_OP_TX_REQ) continue;
-                if (sm->slot >= E1000D_RING_SLOTS ||
-                    sm->length == 0 || sm->length > E1000D_SLOT_SIZE)
-                    continue;
-
-                // Spin briefly for next free descriptor (same pattern as
-                // the kernel-proxy TX path above).
-                int spin = 0;
-                while (!(s_tx_descs[s_tx_tail].status & E1000_DESC_DD) &&
-                       spin++ < 1000) {
-                    cpu_pause();
-                }
-                if (!(s_tx_descs[s_tx_tail].status & E1000_DESC_DD)) continue;
-
-                s_tx_descs[s_tx_tail].addr    =
-                    s_tx_ring_phys + (uint64_t)sm->slot * E1000D_SLOT_SIZE;
-                s_tx_descs[s_tx_tail].length  = (uint16_t)sm->length;
-                s_tx_descs[s_tx_tail].cmd     = E1000_TXD_CMD_EOP |
-                                                E1000_TXD_CMD_RS;
-                s_tx_descs[s_tx_tail].status  = 0;
-                s_tx_descs[s_tx_tail].cso     = 0;
-                s_tx_descs[s_tx_tail].css     = 0;
-                s_tx_descs[s_tx_tail].special = 0;
-                mfence();
-                s_tx_tail = (s_tx_tail + 1) % E1000D_RING_SLOTS;
-                mmio_write(E1000_TDT, s_tx_tail);
+                (void)tx_submit(sm->slot, sm->length, sm->flags, sm->mss);
             }
         }
+
+        // ---- (e) Phase 26: ring hand-off ----
+        //
+        // The ring peer posts TX by advancing tx_prod rather than sending
+        // TX_REQ, so pick that up on every pass, and hand back any RX
+        // slots it released since the last drain (it may release between
+        // interrupts).
+        tx_ring_poll();
+        rx_refill();
     }
 }
@@ -12,8 +12,9 @@
 //
 // Frames never travel inline through any channel — that would require
 // CHAN_MSG_INLINE_MAX > 1518 (today it's 256). Instead the daemon allocates
-// two contiguous DMA VMOs (RX ring + TX ring, 16 slots × 4 KiB each, total
-// 128 KiB) via libdriver's drv_dma_alloc, and sends the physical addresses
+// two DMA VMOs (RX ring + TX ring, E1000D_RING_SLOTS × 2 KiB slots each;
+// Phase 26 made them scatter VMOs via drv_dma_alloc_sg once the depth
+// outgrew the 64-page contiguous cap), and sends the physical addresses
 // to the kernel proxy in the ANNOUNCE message at startup. The proxy reaches
 // the slots through HHDM (kernel virt = phys + g_hhdm_offset). Channel
 // messages then carry only (op, slot_idx, length) tuples — under 32 bytes.
@@ -34,6 +35,7 @@
 #define E1000_STATUS        0x00008
 #define E1000_EERD          0x00014
 #define E1000_ICR           0x000C0
+#define E1000_ITR           0x000C4
 #define E1000_IMS           0x000D0
 #define E1000_IMC           0x000D8
 #define E1000_RCTL          0x00100
@@ -44,14 +46,19 @@
 #define E1000_RDLEN         0x02808
 #define E1000_RDH           0x02810
 #define E1000_RDT           0x02818
+#define E1000_RDTR          0x02820
+#define E1000_RADV          0x0282C
 #define E1000_TDBAL         0x03800
 #define E1000_TDBAH         0x03804
 #define E1000_TDLEN         0x03808
 #define E1000_TDH           0x03810
 #define E1000_TDT           0x03818
+#define E1000_MPC           0x04010   // Missed packets (clear on read)
+#define E1000_RNBC          0x040A0   // Receive no-buffers (clear on read)
 #define E1000_RAL           0x05400
 #define E1000_RAH           0x05404
 #define E1000_MTA_BASE      0x05200
+#define E1000_RXCSUM        0x05000
 
 // CTRL bits.
 #define E1000_CTRL_FD       (1u << 0)
@@ -74,11 +81,38 @@
 
 // TX descriptor command bits.
 #define E1000_TXD_CMD_EOP   (1u << 0)
+#define E1000_TXD_CMD_IFCS  (1u << 1)
+#define E1000_TXD_CMD_TSE   (1u << 2)
 #define E1000_TXD_CMD_RS    (1u << 3)
+#define E1000_TXD_CMD_DEXT  (1u << 5)
+
+// Phase 26: context-descriptor TUCMD bits (share RS/TSE/DEXT positions
+// with the data-descriptor DCMD above).
+#define E1000_TXC_TUCMD_TCP (1u << 0)
+#define E1000_TXC_TUCMD_IP  (1u << 1)   // IPv4 (vs IPv6)
+
+// Extended TX descriptor types (DTYP, bits 20..23 of cmd_len).
+#define E1000_TXD_DTYP_CTX  0x0u
+#define E1000_TXD_DTYP_DATA 0x1u
+
+// Data-descriptor POPTS bits.
+#define E1000_TXD_POPTS_IXSM (1u << 0)  // Insert IPv4 header checksum
+#define E1000_TXD_POPTS_TXSM (1u << 1)  // Insert TCP/UDP checksum
 
 // Descriptor status bits.
 #define E1000_DESC_DD       (1u << 0)
 
+// RX descriptor status / error bits (checksum offload).
+#define E1000_RXD_STAT_IXSM (1u << 2)   // Ignore checksum indication
+#define E1000_RXD_STAT_TCPCS (1u << 5)  // TCP/UDP checksum calculated
+#define E1000_RXD_STAT_IPCS (1u << 6)   // IPv4 checksum calculated
+#define E1000_RXD_ERR_TCPE  (1u << 5)
+#define E1000_RXD_ERR_IPE   (1u << 6)
+
+// RXCSUM bits.
+#define E1000_RXCSUM_IPOFL  (1u << 8)
+#define E1000_RXCSUM_TUOFL  (1u << 9)
+
 // EERD bits.
 #define E1000_EERD_START    (1u << 0)
 #define E1000_EERD_DONE     (1u << 4)
@@ -89,6 +123,7 @@
 #define E1000_IMS_LSC       (1u << 2)
 #define E1000_IMS_RXDMT0    (1u << 4)
 #define E1000_IMS_RXSEQ     (1u << 3)
+#define E1000_IMS_RXO       (1u << 6)
 #define E1000_IMS_RXT0      (1u << 7)
 
 // Ring configuration.
@@ -116,6 +151,34 @@ typedef struct __attribute__((packed)) {
     uint16_t special;
 } e1000_tx_desc_t;
 
+// Phase 26: extended TX descriptors for checksum offload and TSO. Both
+// overlay e1000_tx_desc_t; the status byte (DD) sits at offset 12 in all
+// three layouts, so ring-slot reuse checks stay the same.
+typedef struct __attribute__((packed)) {
+    uint8_t  ipcss;          // IPv4 checksum start
+    uint8_t  ipcso;          // IPv4 checksum field offset
+    uint16_t ipcse;          // IPv4 checksum end (inclusive)
+    uint8_t  tucss;          // TCP/UDP checksum start
+    uint8_t  tucso;          // TCP/UDP checksum field offset
+    uint16_t tucse;          // TCP/UDP checksum end (0 = end of packet)
+    uint32_t cmd_len;        // PAYLEN[19:0] | DTYP[23:20] | TUCMD[31:24]
+    uint8_t  status;
+    uint8_t  hdr_len;        // TSO: bytes of L2..L4 header
+    uint16_t mss;            // TSO: payload bytes per segment
+} e1000_tx_ctx_desc_t;
+
+typedef struct __attribute__((packed)) {
+    uint64_t addr;
+    uint32_t cmd_len;        // LENGTH[19:0] | DTYP[23:20] | DCMD[31:24]
+    uint8_t  status;
+    uint8_t  popts;
+    uint16_t special;
+} e1000_tx_data_desc_t;
+
+_Static_assert(sizeof(e1000_tx_ctx_desc_t) == 16 &&
+               sizeof(e1000_tx_data_desc_t) == 16,
+               "extended TX descriptor layout drift");
+
 // ====================================================================
 // Channel message schema. Shared with kernel/net/e1000_proxy.c (the
 // proxy keeps a byte-compatible copy with a _Static_assert).
@@ -137,8 +200,50 @@ typedef struct __attribute__((packed)) {
 #define E1000_OP_LINK_UP      4u
 #define E1000_OP_LINK_DOWN    5u
 
-#define E1000D_RING_SLOTS     16u
-#define E1000D_SLOT_SIZE      4096u
+// Phase 26: ring depth. Both the descriptor rings and the shared frame
+// rings have E1000D_RING_SLOTS entries; override at build time with
+// -DE1000D_RING_SLOTS=N. The NIC wants RDLEN/TDLEN in 128-byte (8
+// descriptor) units; we also keep N a power of two so the cursors wrap
+// with a mask. Slots are 2 KiB to match RCTL.BSIZE, two per page.
+#ifndef E1000D_RING_SLOTS
+#define E1000D_RING_SLOTS     1024u
+#endif
+#define E1000D_RING_SLOTS_MIN 256u
+#define E1000D_RING_SLOTS_MAX 4096u
+#define E1000D_SLOT_SIZE      2048u
+#define E1000D_SLOTS_PER_PAGE (4096u / E1000D_SLOT_SIZE)
+#define E1000D_RING_PAGES     (E1000D_RING_SLOTS / E1000D_SLOTS_PER_PAGE)
+#define E1000D_DESC_PAGES     ((E1000D_RING_SLOTS * 16u + 4095u) / 4096u)
+
+_Static_assert(E1000D_RING_SLOTS >= E1000D_RING_SLOTS_MIN &&
+               E1000D_RING_SLOTS <= E1000D_RING_SLOTS_MAX,
+               "E1000D_RING_SLOTS out of range");
+_Static_assert((E1000D_RING_SLOTS & (E1000D_RING_SLOTS - 1u)) == 0,
+               "E1000D_RING_SLOTS must be a power of two");
+_Static_assert(E1000D_SLOT_SIZE == E1000_BUF_SIZE,
+               "frame slot must match the RCTL.BSIZE receive buffer");
+
+// Phase 26: interrupt moderation. ITR caps the interrupt rate (register
+// unit is 256 ns between interrupts); RDTR delays the RX interrupt after
+// each frame and RADV bounds that delay under a steady trickle (both in
+// ~1 us units). All three are build-time overridable.
+#ifndef E1000D_ITR_MAX_PER_SEC
+#define E1000D_ITR_MAX_PER_SEC 8000u
+#endif
+#ifndef E1000D_RDTR_US
+#define E1000D_RDTR_US        32u
+#endif
+#ifndef E1000D_RADV_US
+#define E1000D_RADV_US        128u
+#endif
+#define E1000D_ITR_VALUE      (1000000000u / (E1000D_ITR_MAX_PER_SEC * 256u))
+
+// Phase 26: NAPI-style RX. An interrupt whose drain fills a whole budget
+// masks the RX interrupt causes and switches the main loop to polling;
+// E1000D_NAPI_IDLE_POLLS empty polls in a row unmask them again.
+#define E1000D_NAPI_BUDGET     64u
+#define E1000D_NAPI_IDLE_POLLS 16u
+#define E1000D_RX_IRQ_MASK    (E1000_IMS_RXT0 | E1000_IMS_RXDMT0 | E1000_IMS_RXO)
 
 typedef struct __attribute__((packed)) e1000_msg {
     uint8_t  op;             // E1000_OP_*
@@ -3,6 +3,12 @@
 // Pre-Phase-22 this called SYS_NET_STATUS. Stage E swaps to libnet_net_query
 // against /sys/net/service. Same 6 assertions: stack running + IP/netmask/
 // gateway match + tcp_ip CAN capability ON.
+//
+// Phase 29: after the assertions, a TLS record-crypto throughput benchmark
+// (informational, never fails the run): AES-128-GCM and ChaCha20-Poly1305
+// sealed in memory through libtls on the constant-time software engines
+// and on whatever accelerated engines CPUID reports (AES-NI, PCLMULQDQ,
+// SSE2), in MB/s.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +17,7 @@
 #include "syscalls.h"
 #include "libnet/libnet.h"
 #include "libnet/libnet_msg.h"
+#include "libtls/libtls.h"
 #include "../kernel/state.h"
 
 static int tests_passed = 0;
@@ -26,6 +33,52 @@ static int tests_failed = 0;
     } \
 } while(0)
 
+#define BENCH_CHUNK   (256u * 1024u)    // One seal; ~16 TLS records' worth
+#define BENCH_ROUNDS  4u
+
+static uint8_t bench_buf[BENCH_CHUNK];
+
+// MB/s for one AEAD on one engine set, or 0 if it failed.
+static unsigned long bench_mbps(int aead, unsigned engines) {
+    uint64_t cycles = 0;
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+        uint8_t tag[16];
+        uint64_t t = 0;
+        if (libtls_bench_aead(aead, engines, bench_buf, sizeof(bench_buf),
+                              tag, &t) != 0) {
+            return 0;
+        }
+        cycles += t;
+    }
+    if (cycles == 0) cycles = 1;
+    uint64_t bytes = (uint64_t)BENCH_CHUNK * BENCH_ROUNDS;
+    return (unsigned long)(bytes * spin_tsc_hz() / cycles / 1000000ull);
+}
+
+static void tls_crypto_bench(void) {
+    unsigned hw = libtls_engines_available();
+    printf("\n=== TLS record crypto throughput (%u KiB x %u) ===\n",
+           BENCH_CHUNK / 1024u, BENCH_ROUNDS);
+    printf("engines:%s%s%s%s%s\n",
+           (hw & LIBTLS_ENGINE_AESNI)  ? " AES-NI"  : "",
+           (hw & LIBTLS_ENGINE_PCLMUL) ? " PCLMUL"  : "",
+           (hw & LIBTLS_ENGINE_SSE2)   ? " SSE2"    : "",
+           (hw & LIBTLS_ENGINE_MULQ)   ? " MULQ"    : "",
+           hw ? "" : " none (software only)");
+    for (size_t i = 0; i < sizeof(bench_buf); i++) bench_buf[i] = (uint8_t)i;
+
+    static const struct { int aead; const char *name; } suites[] = {
+        { LIBTLS_AEAD_AES128_GCM,        "AES-128-GCM"       },
+        { LIBTLS_AEAD_CHACHA20_POLY1305, "ChaCha20-Poly1305" },
+    };
+    for (size_t i = 0; i < sizeof(suites) / sizeof(suites[0]); i++) {
+        unsigned long soft = bench_mbps(suites[i].aead, 0);
+        unsigned long fast = bench_mbps(suites[i].aead, hw);
+        printf("  %-18s software %5lu MB/s   accelerated %5lu MB/s\n",
+               suites[i].name, soft, fast);
+    }
+}
+
 static void ip_octets(uint32_t ip, uint8_t out[4]) {
     out[0] = (uint8_t)((ip >> 24) & 0xFF);
     out[1] = (uint8_t)((ip >> 16) & 0xFF);
@@ -84,5 +137,7 @@ void _start(void) {
            tests_passed, tests_failed, tests_passed + tests_failed);
 
     if (tests_failed == 0) printf("ALL TESTS PASSED!\n");
+
+    tls_crypto_bench();
     syscall_exit(tests_failed);
 }
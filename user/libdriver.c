@@ -84,6 +84,27 @@ void *drv_dma_alloc_ex(uint32_t npages, uint64_t *phys_out,
     return (void *)(uintptr_t)va;
 }
 
+void *drv_dma_alloc_sg(uint32_t npages, uint64_t *page_phys_out,
+                       cap_token_u_t *handle_out) {
+    if (npages == 0 || !page_phys_out) return (void *)0;
+    uint64_t bytes = (uint64_t)npages * 4096ull;
+    long handle = lvmo_create(bytes, VMO_ZEROED | VMO_PINNED);
+    if (handle < 0) return (void *)0;
+    uint64_t va = lvmo_map((uint64_t)handle, 0, 0, bytes,
+                           PROT_READ | PROT_WRITE);
+    if (va == 0 || (int64_t)va < 0) return (void *)0;
+    // Eagerly-backed VMO: every page already has a frame, so PHYS_QUERY
+    // succeeds for each index. Same fatal-startup contract as above.
+    for (uint32_t i = 0; i < npages; i++) {
+        uint64_t phys = 0;
+        long pq = syscall_vmo_phys((uint64_t)handle, i, &phys);
+        if (pq < 0 || phys == 0) return (void *)0;
+        page_phys_out[i] = phys;
+    }
+    if (handle_out) handle_out->raw = (uint64_t)handle;
+    return (void *)(uintptr_t)va;
+}
+
 // Reads our pledge mask via the existing DEBUG_READ_PLEDGE op (Phase 15b).
 // Available in WITH_DEBUG_SYSCALL builds; otherwise returns 0xFFFF (assume OK).
 static inline uint16_t drv_read_pledge(void) {
@@ -48,6 +48,15 @@ void *drv_dma_alloc(uint32_t npages, uint64_t *phys_out);
 void *drv_dma_alloc_ex(uint32_t npages, uint64_t *phys_out,
                        cap_token_u_t *handle_out);
 
+// drv_dma_alloc_sg: Phase 26. Allocate `npages` pinned, zeroed pages that
+// need NOT be physically contiguous, map them, and write each page's
+// physical address to page_phys_out[0..npages). For buffer pools larger
+// than the 64-page contiguous cap (e1000d's deep frame rings): the device
+// only needs each buffer to sit inside one page, not the pool to be one
+// run. handle_out may be NULL. Returns the mapped user VA, or 0 on failure.
+void *drv_dma_alloc_sg(uint32_t npages, uint64_t *page_phys_out,
+                       cap_token_u_t *handle_out);
+
 // drv_self_pledge_check: assert that this daemon was spawned with the
 // required pledge classes. If any required bit is missing, the function
 // writes an error message to stderr/klog and exits with code 99 (so init
@@ -22,6 +22,13 @@ __attribute__((weak))
 int libtls_connect(libnet_client_ctx_t *netctx, uint32_t tcp_cookie,
                    const char *sni, struct libtls_ctx **out_ctx);
 
+// Phase 29: port-aware connect (libtls keys its session cache by host:port).
+// libtls-mg does not provide it; conn_open then falls back to libtls_connect.
+__attribute__((weak))
+int libtls_connect_port(libnet_client_ctx_t *netctx, uint32_t tcp_cookie,
+                        const char *sni, uint16_t port,
+                        struct libtls_ctx **out_ctx);
+
 __attribute__((weak))
 int libtls_write(struct libtls_ctx *ctx, const uint8_t *buf, uint32_t len);
 
@@ -286,11 +293,27 @@ int http_chunked_decode(uint8_t *dst, size_t dst_cap,
 // Raw-byte I/O over libnet TCP (fragments outbound writes into
 // LIBNET_TCP_CHUNK_MAX segments; reads via repeated libnet_tcp_recv calls
 // until `out_len` is filled or the peer FIN's).
+//
+// Phase 26: once the socket is attached to shared rings the chunk limit
+// goes away — writes and reads move up to LIBHTTP_SHM_CHUNK bytes at a
+// time straight through the mapping. libnet_tcp_shm_* return EBADF for a
+// socket that is not attached, which drops back to the message path.
 // ---------------------------------------------------------------------------
+#define LIBHTTP_SHM_CHUNK  16384u
+#define LIBHTTP_RX_MAX     (LIBHTTP_MAX_BODY_BYTES + 1024u)
+
 static int tcp_send_all(libnet_client_ctx_t *nc, uint32_t cookie,
                         const uint8_t *buf, uint32_t len) {
     uint32_t offset = 0;
     while (offset < len) {
+        int n = libnet_tcp_shm_write(nc, cookie, buf + offset, len - offset,
+                                     5000u);
+        if (n != -9 /* EBADF */) {
+            if (n < 0) return n;
+            if (n == 0) return -32 /* EPIPE */;
+            offset += (uint32_t)n;
+            continue;
+        }
         uint32_t chunk = len - offset;
         if (chunk > LIBNET_TCP_CHUNK_MAX) chunk = LIBNET_TCP_CHUNK_MAX;
         uint32_t sent = 0;
@@ -305,6 +328,44 @@ static int tcp_send_all(libnet_client_ctx_t *nc, uint32_t cookie,
 
 // Append bytes from libnet_tcp_recv into a growable buffer. `remaining_ms`
 // is updated as time elapses; caller treats <=0 as "time budget exhausted".
+// Make room for `want` more bytes (clamped to the body limit).
+static int body_reserve(uint8_t **body_buf, uint32_t *body_len,
+                        uint32_t *body_cap, uint32_t want) {
+    if (*body_len + want <= *body_cap) return 0;
+    uint32_t new_cap = *body_cap ? *body_cap * 2u : 4096u;
+    while (new_cap < *body_len + want) new_cap *= 2u;
+    if (new_cap > LIBHTTP_RX_MAX) new_cap = LIBHTTP_RX_MAX;
+    if (new_cap <= *body_cap) return 0;
+    uint8_t *nb = (uint8_t *)malloc(new_cap);
+    if (!nb) return -12 /* ENOMEM */;
+    if (*body_len) memcpy(nb, *body_buf, *body_len);
+    if (*body_buf) free(*body_buf);
+    *body_buf = nb;
+    *body_cap = new_cap;
+    return 0;
+}
+
+// Shared-ring variant of tcp_recv_into: reads land directly in the body
+// buffer. Returns -9 if the socket is not attached.
+static int tcp_recv_shm(libnet_client_ctx_t *nc, uint32_t cookie,
+                        uint8_t **body_buf, uint32_t *body_len,
+                        uint32_t *body_cap, uint32_t timeout_ms,
+                        uint8_t *peer_fin) {
+    int rc = body_reserve(body_buf, body_len, body_cap, LIBHTTP_SHM_CHUNK);
+    if (rc < 0) return rc;
+    uint32_t room = (*body_cap > *body_len) ? (*body_cap - *body_len) : 0;
+    uint8_t  sink[64];
+    uint8_t *dst = room ? *body_buf + *body_len : sink;   // Over the limit:
+    if (!room) room = sizeof(sink);                       // drain and drop
+    int n = libnet_tcp_shm_read(nc, cookie, dst, room, timeout_ms);
+    if (n == -9 /* EBADF */) return n;
+    if (n == 0) { *peer_fin = 1; return 1; }
+    if (n == -11 /* EAGAIN */ || n == -110 /* ETIMEDOUT */) return 0;
+    if (n < 0) return n;
+    if (dst != sink) *body_len += (uint32_t)n;
+    return 0;
+}
+
 static int tcp_recv_into(libnet_client_ctx_t *nc, uint32_t cookie,
                          uint8_t **body_buf, uint32_t *body_len,
                          uint32_t *body_cap, uint32_t *remaining_ms,
@@ -312,6 +373,13 @@ static int tcp_recv_into(libnet_client_ctx_t *nc, uint32_t cookie,
     // Pull up to LIBNET_TCP_CHUNK_MAX bytes; block up to `remaining_ms` but
     // never longer than a single 500 ms slice so we can poll our own budget.
     uint32_t timeout_ms = *remaining_ms > 500u ? 500u : *remaining_ms;
+    int src = tcp_recv_shm(nc, cookie, body_buf, body_len, body_cap,
+                           timeout_ms, peer_fin);
+    if (src != -9) {
+        if (*remaining_ms >= timeout_ms) *remaining_ms -= timeout_ms;
+        else                              *remaining_ms  = 0;
+        return src;
+    }
     uint8_t   chunk[LIBNET_TCP_CHUNK_MAX];
     uint16_t  got = 0;
     uint16_t  flags = 0;
@@ -330,19 +398,8 @@ static int tcp_recv_into(libnet_client_ctx_t *nc, uint32_t cookie,
 
     if (got == 0) return 0;
 
-    if (*body_len + got > *body_cap) {
-        uint32_t new_cap = *body_cap ? *body_cap * 2u : 4096u;
-        while (new_cap < *body_len + got) new_cap *= 2u;
-        if (new_cap > LIBHTTP_MAX_BODY_BYTES + 1024u) {
-            new_cap = LIBHTTP_MAX_BODY_BYTES + 1024u;
-        }
-        uint8_t *nb = (uint8_t *)malloc(new_cap);
-        if (!nb) return -12 /* ENOMEM */;
-        if (*body_len) memcpy(nb, *body_buf, *body_len);
-        if (*body_buf) free(*body_buf);
-        *body_buf = nb;
-        *body_cap = new_cap;
-    }
+    rc = body_reserve(body_buf, body_len, body_cap, got);
+    if (rc < 0) return rc;
     uint32_t room = (*body_cap > *body_len) ? (*body_cap - *body_len) : 0;
     uint32_t take = (got > room) ? room : got;
     if (take) memcpy(*body_buf + *body_len, chunk, take);
@@ -362,13 +419,16 @@ static size_t fmt_decimal(char *dst, uint32_t v) {
     return n;
 }
 
+#define LIBHTTP_MAX_REQ_HEAD_BYTES  2048u
+
 // Compose the request headers into `hdr_buf`. Returns total header length or
 // 0 on overflow. Trailing body (if any) is NOT appended.
 static uint32_t build_request_headers(char *hdr_buf, uint32_t hdr_cap,
                                       const char *method,
                                       const http_url_t *url,
                                       uint32_t body_len,
-                                      const char *content_type) {
+                                      const char *content_type,
+                                      int keep_alive) {
     size_t off = 0;
     size_t method_len = strlen(method);
     if (off + method_len + 1 >= hdr_cap) return 0;
@@ -393,8 +453,12 @@ static uint32_t build_request_headers(char *hdr_buf, uint32_t hdr_cap,
     }
     memcpy(hdr_buf + off, "\r\n", 2); off += 2;
 
-    // Connection: close.
-    memcpy(hdr_buf + off, "Connection: close\r\n", 19); off += 19;
+    // Connection: keep-alive when the pool may hold on to the socket.
+    const char *conn = keep_alive ? "Connection: keep-alive\r\n"
+                                  : "Connection: close\r\n";
+    size_t conn_len = strlen(conn);
+    if (off + conn_len >= hdr_cap) return 0;
+    memcpy(hdr_buf + off, conn, conn_len); off += conn_len;
 
     // User-Agent.
     const char *ua = "User-Agent: libhttp/0.1\r\n";
@@ -429,15 +493,34 @@ static uint32_t build_request_headers(char *hdr_buf, uint32_t hdr_cap,
 }
 
 // ---------------------------------------------------------------------------
-// Response visitor: extract Content-Length + Transfer-Encoding + Location.
+// Response visitor: extract Content-Length + Transfer-Encoding + Location,
+// plus the Connection / Keep-Alive headers that decide connection reuse.
 // ---------------------------------------------------------------------------
 typedef struct hdr_ctx {
-    int32_t  content_length;       // -1 when absent
+    int64_t  content_length;       // -1 when absent
     uint8_t  chunked;
+    uint8_t  conn_close;           // Connection: close
+    uint8_t  conn_keep_alive;      // Connection: keep-alive
+    uint32_t ka_timeout_s;         // Keep-Alive: timeout=N (0 when absent)
     char     content_type[128];
     char     location[LIBHTTP_MAX_URL_LEN + 1];
 } hdr_ctx_t;
 
+// 1 if the comma-separated header value lists `tok` (case-insensitive).
+static int value_has_token(const char *v, size_t n, const char *tok) {
+    size_t tl = strlen(tok);
+    size_t i = 0;
+    while (i < n) {
+        while (i < n && (v[i] == ' ' || v[i] == '\t' || v[i] == ',')) i++;
+        size_t s = i;
+        while (i < n && v[i] != ',') i++;
+        size_t e = i;
+        while (e > s && (v[e - 1] == ' ' || v[e - 1] == '\t')) e--;
+        if (e - s == tl && http_strncasecmp(v + s, tok, tl) == 0) return 1;
+    }
+    return 0;
+}
+
 static void header_visitor(void *vctx, const char *name, size_t name_len,
                            const char *value, size_t value_len) {
     hdr_ctx_t *ctx = (hdr_ctx_t *)vctx;
@@ -449,13 +532,30 @@ static void header_visitor(void *vctx, const char *name, size_t name_len,
     if (strcmp(lname, "content-length") == 0) {
         uint32_t v = 0;
         if (parse_u32(value, value_len, &v) == 0) {
-            ctx->content_length = (int32_t)v;
+            ctx->content_length = (int64_t)v;
         }
     } else if (strcmp(lname, "transfer-encoding") == 0) {
         // Common: "chunked" (case-insensitive).
         if (value_len == 7 && http_strncasecmp(value, "chunked", 7) == 0) {
             ctx->chunked = 1;
         }
+    } else if (strcmp(lname, "connection") == 0) {
+        if (value_has_token(value, value_len, "close"))      ctx->conn_close = 1;
+        if (value_has_token(value, value_len, "keep-alive")) ctx->conn_keep_alive = 1;
+    } else if (strcmp(lname, "keep-alive") == 0) {
+        // "timeout=5, max=100" — only the timeout matters to the pool.
+        for (size_t i = 0; i + 8 <= value_len; i++) {
+            if ((i == 0 || value[i - 1] == ' ' || value[i - 1] == ',') &&
+                http_strncasecmp(value + i, "timeout=", 8) == 0) {
+                size_t j = i + 8, k = j;
+                while (k < value_len && is_digit(value[k])) k++;
+                uint32_t t = 0;
+                if (parse_u32(value + j, k - j, &t) == 0) {
+                    ctx->ka_timeout_s = t > 3600u ? 3600u : t;
+                }
+                break;
+            }
+        }
     } else if (strcmp(lname, "content-type") == 0) {
         size_t n = value_len < sizeof(ctx->content_type) - 1 ?
                    value_len : sizeof(ctx->content_type) - 1;
@@ -470,193 +570,380 @@ static void header_visitor(void *vctx, const char *name, size_t name_len,
 }
 
 // ---------------------------------------------------------------------------
-// Core GET/POST worker. Returns status_code on success, negative errno
-// otherwise. On success populates resp + sets body_cap / body_len / etc.
+// Phase 29: response framing.
+//
+// With keep-alive the peer no longer marks the end of a response by
+// closing, so the reader has to know where each one stops: after the head
+// for 1xx / 204 / 304, after Content-Length bytes, or after the last chunk
+// of a chunked body.  Anything else runs to the peer's FIN and ends the
+// connection.
 // ---------------------------------------------------------------------------
-static int perform_request(http_response_t *resp, const http_url_t *url,
-                           const char *method,
-                           const uint8_t *body, uint32_t body_len,
-                           const char *content_type,
-                           uint32_t timeout_ms) {
-    if (timeout_ms == 0) timeout_ms = LIBHTTP_DEFAULT_TIMEOUT_MS;
-    uint32_t remaining_ms = timeout_ms;
+
+// Encoded length of a complete chunked body at `src` (through the CRLF that
+// ends the trailers), 0 if more bytes are needed, -5 if malformed.
+static int chunked_span(const uint8_t *src, uint32_t len) {
+    uint32_t si = 0;
+    for (;;) {
+        uint32_t sz = 0;
+        int saw_digit = 0;
+        while (si < len && hex_digit((char)src[si]) >= 0) {
+            sz = (sz << 4) | (uint32_t)hex_digit((char)src[si]);
+            si++;
+            saw_digit = 1;
+            if (sz > LIBHTTP_MAX_BODY_BYTES) return -5;
+        }
+        if (si >= len) return 0;
+        if (!saw_digit) return -5;
+        // Extensions, up to the LF of the size line.
+        while (si < len && src[si] != '\n') si++;
+        if (si >= len) return 0;
+        if (src[si - 1] != '\r') return -5;
+        si++;
+        if (sz == 0) {
+            // Trailer lines until the empty one.
+            for (;;) {
+                if (si + 1 >= len) return 0;
+                if (src[si] == '\r' && src[si + 1] == '\n') return (int)(si + 2);
+                while (si < len && src[si] != '\n') si++;
+                if (si >= len) return 0;
+                si++;
+            }
+        }
+        if (len - si < sz + 2u) return 0;
+        si += sz;
+        if (src[si] != '\r' || src[si + 1] != '\n') return -5;
+        si += 2;
+    }
+}
+
+static int response_frame(const uint8_t *buf, uint32_t len, int head_request,
+                          http_frame_t *fr, hdr_ctx_t *h) {
+    memset(fr, 0, sizeof(*fr));
+    memset(h, 0, sizeof(*h));
+    h->content_length = -1;
+
+    uint32_t head = 0;
+    for (uint32_t i = 3; i < len; i++) {
+        if (buf[i] == '\n' && buf[i - 1] == '\r' &&
+            buf[i - 2] == '\n' && buf[i - 3] == '\r') {
+            head = i + 1;
+            break;
+        }
+    }
+    if (head == 0) return len > LIBHTTP_MAX_HEAD_BYTES ? -5 : 0;
+
+    int code = 0;
+    int sl = http_parse_status_line((const char *)buf, head, &code);
+    if (sl < 0) return -5;
+    if (http_parse_header_block((const char *)buf + sl, head - (uint32_t)sl,
+                                header_visitor, h) < 0) {
+        return -5;
+    }
+    fr->status   = code;
+    fr->head_len = head;
+    fr->idle_ms  = h->ka_timeout_s * 1000u;
+    // HTTP/1.1 persists unless told to close; HTTP/1.0 only if asked to.
+    int http11 = buf[7] != '0';
+    fr->keep_alive = !h->conn_close && (http11 || h->conn_keep_alive);
+
+    if (head_request || code < 200 || code == 204 || code == 304) {
+        fr->total_len = head;
+        return 1;
+    }
+    if (h->chunked) {
+        int span = chunked_span(buf + head, len - head);
+        if (span <= 0) return span;
+        fr->total_len = head + (uint32_t)span;
+        return 1;
+    }
+    if (h->content_length >= 0) {
+        if ((int64_t)(len - head) < h->content_length) return 0;
+        fr->total_len = head + (uint32_t)h->content_length;
+        return 1;
+    }
+    fr->until_close = 1;
+    fr->keep_alive  = 0;
+    return 0;
+}
+
+int http_response_frame(const uint8_t *buf, uint32_t len, int head_request,
+                        http_frame_t *out) {
+    if (!buf || !out) return -5;
+    hdr_ctx_t h;
+    return response_frame(buf, len, head_request, out, &h);
+}
+
+// ---------------------------------------------------------------------------
+// Phase 29: keep-alive connection pool.
+//
+// A connection whose last response left it reusable goes back to a small
+// per-process pool keyed by scheme + host + port, TLS session and netd
+// channel included, so the next request to that origin skips DNS, the TCP
+// handshake and the TLS handshake.  Connections are heap-allocated because
+// libtls keeps a pointer to their netd channel.  An idle one is dropped
+// after LIBHTTP_POOL_IDLE_MS, or a second before the server's advertised
+// Keep-Alive timeout, whichever comes first.
+// ---------------------------------------------------------------------------
+typedef struct http_conn {
+    char                 host[LIBHTTP_MAX_HOST_LEN + 1];
+    uint16_t             port;
+    uint8_t              is_tls;
+    uint8_t              _pad;
+    libnet_client_ctx_t  nc;
+    uint32_t             cookie;
+    struct libtls_ctx   *tls;
+    uint64_t             idle_tsc;      // When it entered the pool
+    uint32_t             idle_ms;       // How long it may stay there
+} http_conn_t;
+
+static http_conn_t *g_pool[LIBHTTP_POOL_SLOTS];
+static int          g_keepalive = 1;
+
+static void conn_close(http_conn_t *c) {
+    if (c->tls) libtls_close(c->tls);
+    (void)libnet_tcp_close(&c->nc, c->cookie, 500000000ULL);
+    free(c);
+}
+
+static int conn_open(http_conn_t **out, const http_url_t *url,
+                     uint32_t remaining_ms) {
+    http_conn_t *c = (http_conn_t *)malloc(sizeof(*c));
+    if (!c) return -12 /* ENOMEM */;
+    memset(c, 0, sizeof(*c));
 
     // 1. Connect to netd.
-    libnet_client_ctx_t nc;
     int rc = libnet_connect_service_with_retry(LIBNET_NAME_SERVICE, 16,
-                                               remaining_ms, &nc);
-    if (rc < 0) return rc;
+                                               remaining_ms, &c->nc);
+    if (rc < 0) { free(c); return rc; }
 
     // 2. Resolve host (unless dotted-IPv4).
     uint32_t dst_ip = 0;
     if (parse_dotted_ipv4(url->host, &dst_ip) < 0) {
         libnet_dns_query_resp_t dns;
-        rc = libnet_dns_resolve(&nc, url->host,
+        rc = libnet_dns_resolve(&c->nc, url->host,
                                 remaining_ms > 5000u ? 5000u : remaining_ms,
                                 &dns);
-        if (rc < 0) return rc;
-        if (dns.answer_count == 0) return -2 /* ENOENT */;
+        if (rc < 0) { free(c); return rc; }
+        if (dns.answer_count == 0) { free(c); return -2 /* ENOENT */; }
         dst_ip = dns.answers[0];
     }
 
     // 3. TCP open.
-    uint32_t cookie = 0;
     uint16_t local_port = 0;
-    rc = libnet_tcp_open(&nc, dst_ip, url->port,
+    rc = libnet_tcp_open(&c->nc, dst_ip, url->port,
                          remaining_ms > 6000u ? 6000u : remaining_ms,
-                         &cookie, &local_port);
-    if (rc < 0) return rc;
-
-    // 4. TLS handshake if scheme=https.
-    struct libtls_ctx *tls = NULL;
+                         &c->cookie, &local_port);
+    if (rc < 0) { free(c); return rc; }
+    // Phase 26: move the stream through shared rings when netd allows it;
+    // on failure the socket simply stays on the message path.
+    (void)libnet_tcp_shm_attach(&c->nc, c->cookie, 0, 500000000ULL);
+
+    // 4. TLS handshake if scheme=https (resumed from libtls's session
+    // cache when the server still has the session).
     if (url->is_tls) {
-        if (!libtls_connect) {
-            (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
-            return -71 /* EPROTO — TLS unavailable */;
+        if (libtls_connect_port) {
+            rc = libtls_connect_port(&c->nc, c->cookie, url->host, url->port,
+                                     &c->tls);
+        } else {
+            rc = libtls_connect ? libtls_connect(&c->nc, c->cookie, url->host,
+                                                 &c->tls)
+                                : -71 /* EPROTO — TLS unavailable */;
         }
-        rc = libtls_connect(&nc, cookie, url->host, &tls);
         if (rc < 0) {
-            (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
+            c->tls = NULL;
+            conn_close(c);
             return rc;
         }
     }
 
-    // 5. Build + send request.
-    char hdr_buf[2048];
-    uint32_t hdr_len = build_request_headers(hdr_buf, sizeof(hdr_buf),
-                                             method, url, body_len,
-                                             content_type);
-    if (hdr_len == 0) {
-        (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
-        return -5;
+    memcpy(c->host, url->host, strlen(url->host) + 1);
+    c->port   = url->port;
+    c->is_tls = url->is_tls;
+    *out = c;
+    return 0;
+}
+
+static int conn_send(http_conn_t *c, const uint8_t *buf, uint32_t len) {
+    if (c->tls) {
+        int rc = libtls_write(c->tls, buf, len);
+        return rc < 0 ? rc : 0;
     }
-    if (tls) {
-        rc = libtls_write(tls, (const uint8_t *)hdr_buf, hdr_len);
-        if (rc >= 0 && body_len > 0) {
-            rc = libtls_write(tls, body, body_len);
+    return tcp_send_all(&c->nc, c->cookie, buf, len);
+}
+
+// Take an idle connection to `url`'s origin out of the pool, closing any
+// that have outstayed their idle limit on the way.
+static http_conn_t *pool_take(const http_url_t *url) {
+    uint64_t now = spin_rdtsc();
+    uint64_t hz  = spin_tsc_hz();
+    http_conn_t *hit = NULL;
+    for (uint32_t i = 0; i < LIBHTTP_POOL_SLOTS; i++) {
+        http_conn_t *c = g_pool[i];
+        if (!c) continue;
+        if ((now - c->idle_tsc) * 1000u / hz >= c->idle_ms) {
+            g_pool[i] = NULL;
+            conn_close(c);
+            continue;
         }
-    } else {
-        rc = tcp_send_all(&nc, cookie, (const uint8_t *)hdr_buf, hdr_len);
-        if (rc >= 0 && body_len > 0) {
-            rc = tcp_send_all(&nc, cookie, body, body_len);
-        }
-    }
-    if (rc < 0) {
-        if (tls) libtls_close(tls);
-        (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
-        return rc;
-    }
-
-    // 6. Recv response.
-    uint8_t *body_buf = NULL;
-    uint32_t b_len = 0, b_cap = 0;
-    uint8_t peer_fin = 0;
-    while (b_len < LIBHTTP_MAX_BODY_BYTES + 1024u && remaining_ms > 0) {
-        if (tls) {
-            // TLS mode: read in chunks into a local buffer, then stage into
-            // body_buf like the plaintext path.
-            uint8_t tmp[LIBNET_TCP_CHUNK_MAX];
-            int got = libtls_read(tls, tmp, sizeof(tmp),
-                                  remaining_ms > 500u ? 500u : remaining_ms);
-            if (got < 0) break;
-            if (got == 0) {
-                if (peer_fin) break;
-                // Still connecting — slice off 500 ms and keep looping.
-                if (remaining_ms >= 500u) remaining_ms -= 500u;
-                else                      remaining_ms  = 0;
-                continue;
-            }
-            if (b_len + got > b_cap) {
-                uint32_t nc2 = b_cap ? b_cap * 2u : 4096u;
-                while (nc2 < b_len + (uint32_t)got) nc2 *= 2u;
-                if (nc2 > LIBHTTP_MAX_BODY_BYTES + 1024u) {
-                    nc2 = LIBHTTP_MAX_BODY_BYTES + 1024u;
-                }
-                uint8_t *nb = (uint8_t *)malloc(nc2);
-                if (!nb) { if (body_buf) free(body_buf); return -12; }
-                if (b_len) memcpy(nb, body_buf, b_len);
-                if (body_buf) free(body_buf);
-                body_buf = nb; b_cap = nc2;
-            }
-            uint32_t room = (b_cap > b_len) ? (b_cap - b_len) : 0;
-            uint32_t take = ((uint32_t)got > room) ? room : (uint32_t)got;
-            memcpy(body_buf + b_len, tmp, take);
-            b_len += take;
-        } else {
-            int tr = tcp_recv_into(&nc, cookie, &body_buf, &b_len, &b_cap,
-                                   &remaining_ms, &peer_fin);
-            if (tr < 0) break;
-            if (tr == 1 /* peer FIN */) break;
-            if (tr == 0 && peer_fin) break;
+        if (!hit && c->port == url->port && c->is_tls == url->is_tls &&
+            strcmp(c->host, url->host) == 0) {
+            g_pool[i] = NULL;
+            hit = c;
         }
-
-        // Heuristic: stop as soon as we see Content-Length body or chunked
-        // terminator. But keep it simple for MVP — we read until the peer
-        // FINs or we hit the cap.
     }
+    return hit;
+}
 
-    // 7. Close.
-    if (tls) libtls_close(tls);
-    (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
+static void pool_put(http_conn_t *c, uint32_t server_idle_ms) {
+    uint32_t idle = LIBHTTP_POOL_IDLE_MS;
+    if (server_idle_ms) {
+        uint32_t s = server_idle_ms > 1000u ? server_idle_ms - 1000u : 0;
+        if (s < idle) idle = s;
+    }
+    if (!g_keepalive || idle == 0) {
+        conn_close(c);
+        return;
+    }
+    c->idle_tsc = spin_rdtsc();
+    c->idle_ms  = idle;
+    uint32_t slot = 0;
+    for (uint32_t i = 0; i < LIBHTTP_POOL_SLOTS; i++) {
+        if (!g_pool[i]) { slot = i; break; }
+        if (g_pool[i]->idle_tsc < g_pool[slot]->idle_tsc) slot = i;
+    }
+    if (g_pool[slot]) conn_close(g_pool[slot]);
+    g_pool[slot] = c;
+}
 
-    if (b_len == 0) {
-        if (body_buf) free(body_buf);
-        return -5;
+void http_pool_flush(void) {
+    for (uint32_t i = 0; i < LIBHTTP_POOL_SLOTS; i++) {
+        if (g_pool[i]) {
+            conn_close(g_pool[i]);
+            g_pool[i] = NULL;
+        }
     }
+}
 
-    // 8. Parse status line.
-    int status_bytes = http_parse_status_line((const char *)body_buf, b_len,
-                                              &resp->status_code);
-    if (status_bytes < 0) {
-        if (body_buf) free(body_buf);
-        return -5;
+void http_set_keepalive(int on) {
+    g_keepalive = on ? 1 : 0;
+    if (!g_keepalive) http_pool_flush();
+}
+
+// ---------------------------------------------------------------------------
+// Reading responses.  `rx` accumulates raw bytes; with pipelining it can
+// already hold the start of the next response when the previous one ends.
+// ---------------------------------------------------------------------------
+typedef struct http_rx {
+    uint8_t *buf;
+    uint32_t len;
+    uint32_t cap;
+} http_rx_t;
+
+static void rx_consume(http_rx_t *rx, uint32_t n) {
+    if (n >= rx->len) { rx->len = 0; return; }
+    memmove(rx->buf, rx->buf + n, rx->len - n);
+    rx->len -= n;
+}
+
+// Pull more bytes off `c`. Returns 0 on progress or an empty slice, 1 once
+// the peer has closed (or the buffer is full), negative errno on failure.
+static int conn_recv(http_conn_t *c, http_rx_t *rx, uint32_t *remaining_ms) {
+    if (!c->tls) {
+        uint8_t fin = 0;
+        int tr = tcp_recv_into(&c->nc, c->cookie, &rx->buf, &rx->len,
+                               &rx->cap, remaining_ms, &fin);
+        if (tr < 0) return tr;
+        return (tr == 1 || fin) ? 1 : 0;
     }
-    uint32_t cursor = (uint32_t)status_bytes;
-
-    // 9. Parse headers.
-    hdr_ctx_t hctx;
-    memset(&hctx, 0, sizeof(hctx));
-    hctx.content_length = -1;
-    int hdr_bytes = http_parse_header_block((const char *)body_buf + cursor,
-                                            b_len - cursor,
-                                            header_visitor, &hctx);
-    if (hdr_bytes < 0) {
-        if (body_buf) free(body_buf);
-        return -5;
+    int rc = body_reserve(&rx->buf, &rx->len, &rx->cap, LIBNET_TCP_CHUNK_MAX);
+    if (rc < 0) return rc;
+    uint32_t room = rx->cap - rx->len;
+    if (room == 0) return 1;
+    if (room > LIBNET_TCP_CHUNK_MAX) room = LIBNET_TCP_CHUNK_MAX;
+    uint32_t slice = *remaining_ms > 500u ? 500u : *remaining_ms;
+    uint64_t t0 = spin_rdtsc();
+    int got = libtls_read(c->tls, rx->buf + rx->len, room, slice);
+    uint64_t ms = (spin_rdtsc() - t0) * 1000u / spin_tsc_hz();
+    *remaining_ms = ms < *remaining_ms ? *remaining_ms - (uint32_t)ms : 0;
+    if (got < 0) return got;
+    if (got == 0) return 1;                     // close_notify
+    rx->len += (uint32_t)got;
+    return 0;
+}
+
+// Read until rx holds one final response (1xx interim responses are
+// dropped). On success *fr frames rx->buf[0 .. fr->total_len). A head whose
+// body is cut short by close, timeout or the size cap still counts, but
+// leaves keep_alive clear. Returns 0, or -32 (EPIPE) / -110 (ETIMEDOUT) /
+// a transport error if nothing arrived, -5 if malformed.
+static int read_response(http_conn_t *c, http_rx_t *rx, http_frame_t *fr,
+                         hdr_ctx_t *h, uint32_t *remaining_ms) {
+    int closed = 0;
+    for (;;) {
+        memset(fr, 0, sizeof(*fr));
+        if (rx->len) {
+            int st = response_frame(rx->buf, rx->len, 0, fr, h);
+            if (st < 0) return st;
+            if (st == 1 && fr->status < 200) {
+                rx_consume(rx, fr->total_len);
+                continue;
+            }
+            if (st == 1) return 0;
+        }
+        if (closed || rx->len >= LIBHTTP_RX_MAX || *remaining_ms == 0) {
+            if (fr->head_len) {
+                fr->total_len  = rx->len;
+                fr->keep_alive = 0;
+                return 0;
+            }
+            if (rx->len == 0) return closed ? -32 : -110;
+            return -5;
+        }
+        int rc = conn_recv(c, rx, remaining_ms);
+        if (rc < 0) {
+            if (rx->len == 0) return rc;
+            closed = 1;
+        } else if (rc == 1) {
+            closed = 1;
+        }
     }
-    cursor += (uint32_t)hdr_bytes;
+}
 
-    // 10. Assemble body.
-    if (hctx.content_type[0]) {
-        size_t n = strlen(hctx.content_type);
+// Fill `resp` from one framed response. Returns the status code, or
+// negative errno.
+static int parse_response(http_response_t *resp, const uint8_t *buf,
+                          const http_frame_t *fr, const hdr_ctx_t *hctx) {
+    resp->status_code = fr->status;
+    if (hctx->content_type[0]) {
+        size_t n = strlen(hctx->content_type);
         if (n >= sizeof(resp->content_type)) n = sizeof(resp->content_type) - 1;
-        memcpy(resp->content_type, hctx.content_type, n);
+        memcpy(resp->content_type, hctx->content_type, n);
         resp->content_type[n] = '\0';
     }
-    if (hctx.location[0]) {
-        size_t n = strlen(hctx.location);
+    if (hctx->location[0]) {
+        size_t n = strlen(hctx->location);
         if (n >= sizeof(resp->location)) n = sizeof(resp->location) - 1;
-        memcpy(resp->location, hctx.location, n);
+        memcpy(resp->location, hctx->location, n);
         resp->location[n] = '\0';
     }
-    resp->chunked = hctx.chunked;
+    resp->chunked = hctx->chunked;
 
-    uint32_t body_bytes = b_len - cursor;
-    uint8_t *raw_body   = body_buf + cursor;
+    uint32_t body_bytes = fr->total_len - fr->head_len;
+    const uint8_t *raw_body = buf + fr->head_len;
     uint8_t *out_body   = NULL;
     uint32_t out_len    = 0;
     uint32_t out_cap    = 0;
     uint8_t  truncated  = 0;
 
-    if (hctx.chunked) {
-        // Decode in place into out_body.
+    if (hctx->chunked) {
+        // Decode into out_body.
         out_cap = body_bytes;  // Can only shrink.
         if (out_cap > LIBHTTP_MAX_BODY_BYTES) {
             out_cap = LIBHTTP_MAX_BODY_BYTES;
             truncated = 1;
         }
         out_body = (uint8_t *)malloc(out_cap + 1);
-        if (!out_body) { free(body_buf); return -12; }
+        if (!out_body) return -12;
         int dl = http_chunked_decode(out_body, out_cap, raw_body, body_bytes);
         if (dl < 0) {
             // Malformed chunked — ship whatever bytes we have verbatim.
@@ -666,13 +953,15 @@ static int perform_request(http_response_t *resp, const http_url_t *url,
         } else {
             out_len = (uint32_t)dl;
         }
-    } else if (hctx.content_length >= 0) {
-        uint32_t want = (uint32_t)hctx.content_length;
-        uint32_t have = body_bytes < want ? body_bytes : want;
+    } else if (hctx->content_length >= 0) {
+        uint32_t have = body_bytes;
+        if ((int64_t)have > hctx->content_length) {
+            have = (uint32_t)hctx->content_length;
+        }
         if (have > LIBHTTP_MAX_BODY_BYTES) { have = LIBHTTP_MAX_BODY_BYTES; truncated = 1; }
         out_cap = have + 1;
         out_body = (uint8_t *)malloc(out_cap);
-        if (!out_body) { free(body_buf); return -12; }
+        if (!out_body) return -12;
         if (have) memcpy(out_body, raw_body, have);
         out_len = have;
     } else {
@@ -681,14 +970,12 @@ static int perform_request(http_response_t *resp, const http_url_t *url,
         if (have > LIBHTTP_MAX_BODY_BYTES) { have = LIBHTTP_MAX_BODY_BYTES; truncated = 1; }
         out_cap = have + 1;
         out_body = (uint8_t *)malloc(out_cap);
-        if (!out_body) { free(body_buf); return -12; }
+        if (!out_body) return -12;
         if (have) memcpy(out_body, raw_body, have);
         out_len = have;
     }
     out_body[out_len] = 0;   // Null-terminator for string callers.
 
-    free(body_buf);
-
     resp->body            = out_body;
     resp->body_len        = out_len;
     resp->body_cap        = out_cap;
@@ -696,6 +983,108 @@ static int perform_request(http_response_t *resp, const http_url_t *url,
     return resp->status_code;
 }
 
+// ---------------------------------------------------------------------------
+// Core worker: send `cnt` requests to one origin back-to-back on one
+// connection and read their responses in order into resps[0..cnt). More
+// than one request is only ever a pipelined batch of GETs; a POST goes
+// alone. Returns how many responses were read (possibly fewer than `cnt`
+// if the server closed part-way; the caller re-sends the rest), or
+// negative errno if none were.
+//
+// A pooled connection may have been closed by the server while idle; if
+// it fails before a single response byte arrives, the batch is replayed
+// once on a fresh connection. Only GET / HEAD batches take that path: a
+// POST is never retried automatically (RFC 9112 §9.3.1), so it always
+// goes out on a fresh connection, where a failure is a real one.
+// ---------------------------------------------------------------------------
+typedef struct http_req {
+    const char       *method;
+    const http_url_t *url;
+    const uint8_t    *body;
+    uint32_t          body_len;
+    const char       *content_type;
+} http_req_t;
+
+static int exchange(http_response_t *resps, const http_req_t *reqs,
+                    uint32_t cnt, uint32_t *remaining_ms) {
+    uint32_t wire_cap = cnt * LIBHTTP_MAX_REQ_HEAD_BYTES;
+    char *wire = (char *)malloc(wire_cap);
+    if (!wire) return -12;
+    uint32_t wire_len = 0;
+    for (uint32_t i = 0; i < cnt; i++) {
+        uint32_t n = build_request_headers(wire + wire_len, wire_cap - wire_len,
+                                           reqs[i].method, reqs[i].url,
+                                           reqs[i].body_len,
+                                           reqs[i].content_type, g_keepalive);
+        if (n == 0) { free(wire); return -5; }
+        wire_len += n;
+    }
+
+    int idempotent = 1;
+    for (uint32_t i = 0; i < cnt; i++) {
+        if (strcmp(reqs[i].method, "GET") != 0 &&
+            strcmp(reqs[i].method, "HEAD") != 0) {
+            idempotent = 0;
+        }
+    }
+
+    int rc = 0;
+    uint32_t done = 0;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        http_conn_t *c = (attempt == 0 && idempotent) ? pool_take(reqs[0].url)
+                                                      : NULL;
+        int reused = c != NULL;
+        if (!c) {
+            rc = conn_open(&c, reqs[0].url, *remaining_ms);
+            if (rc < 0) break;
+        }
+
+        rc = conn_send(c, (const uint8_t *)wire, wire_len);
+        if (rc >= 0 && cnt == 1 && reqs[0].body_len > 0) {
+            rc = conn_send(c, reqs[0].body, reqs[0].body_len);
+        }
+
+        http_rx_t rx = { NULL, 0, 0 };
+        http_frame_t fr;
+        memset(&fr, 0, sizeof(fr));
+        int heard = 0;
+        while (rc >= 0 && done < cnt) {
+            hdr_ctx_t h;
+            rc = read_response(c, &rx, &fr, &h, remaining_ms);
+            if (rc < 0) break;
+            heard = 1;
+            rc = parse_response(&resps[done], rx.buf, &fr, &h);
+            if (rc < 0) break;
+            done++;
+            rx_consume(&rx, fr.total_len);
+            if (!fr.keep_alive) break;
+        }
+        if (rx.len) heard = 1;
+
+        if (done == cnt && fr.keep_alive && rx.len == 0) pool_put(c, fr.idle_ms);
+        else                                             conn_close(c);
+        if (rx.buf) free(rx.buf);
+
+        if (done == 0 && reused && !heard) continue;
+        break;
+    }
+    free(wire);
+    return done ? (int)done : (rc < 0 ? rc : -5);
+}
+
+static int perform_request(http_response_t *resp, const http_url_t *url,
+                           const char *method,
+                           const uint8_t *body, uint32_t body_len,
+                           const char *content_type,
+                           uint32_t timeout_ms) {
+    if (timeout_ms == 0) timeout_ms = LIBHTTP_DEFAULT_TIMEOUT_MS;
+    uint32_t remaining_ms = timeout_ms;
+    http_req_t req = { method, url, body, body_len, content_type };
+    int rc = exchange(resp, &req, 1, &remaining_ms);
+    if (rc < 0) return rc;
+    return resp->status_code;
+}
+
 // ---------------------------------------------------------------------------
 // Public GET/POST — wrap perform_request with redirect following.
 // ---------------------------------------------------------------------------
@@ -780,6 +1169,67 @@ int http_post(http_response_t *resp, const char *url,
                                      timeout_ms);
 }
 
+// Phase 29: pipelined GETs. Consecutive URLs on the same origin go out in
+// batches of up to LIBHTTP_PIPELINE_DEPTH on one connection; a batch the
+// server cuts short is resumed from the first unanswered URL. Redirects
+// are returned, not followed.
+static int same_origin(const http_url_t *a, const http_url_t *b) {
+    return a->port == b->port && a->is_tls == b->is_tls &&
+           strcmp(a->host, b->host) == 0;
+}
+
+int http_get_pipelined(http_response_t *resps, const char *const *urls,
+                       uint32_t n, uint32_t timeout_ms) {
+    if (!resps || !urls) return -5;
+    memset(resps, 0, (size_t)n * sizeof(*resps));
+    if (n == 0) return 0;
+    if (timeout_ms == 0) timeout_ms = LIBHTTP_DEFAULT_TIMEOUT_MS;
+    uint32_t remaining_ms = timeout_ms;
+
+    http_url_t *parsed = (http_url_t *)malloc((size_t)n * sizeof(*parsed));
+    if (!parsed) return -12;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!urls[i] ||
+            http_url_parse(urls[i], strlen(urls[i]), &parsed[i]) < 0) {
+            parsed[i].host[0] = '\0';      // Skipped: status_code stays 0.
+        }
+    }
+
+    http_req_t reqs[LIBHTTP_PIPELINE_DEPTH];
+    uint32_t answered = 0;
+    int first_err = 0;
+    uint32_t i = 0;
+    while (i < n && remaining_ms > 0) {
+        if (!parsed[i].host[0]) {
+            if (!first_err) first_err = -5;
+            i++;
+            continue;
+        }
+        uint32_t cnt = 0;
+        uint32_t depth = g_keepalive ? LIBHTTP_PIPELINE_DEPTH : 1u;
+        while (i + cnt < n && cnt < depth &&
+               same_origin(&parsed[i + cnt], &parsed[i])) {
+            reqs[cnt].method       = "GET";
+            reqs[cnt].url          = &parsed[i + cnt];
+            reqs[cnt].body         = NULL;
+            reqs[cnt].body_len     = 0;
+            reqs[cnt].content_type = NULL;
+            cnt++;
+        }
+        int got = exchange(resps + i, reqs, cnt, &remaining_ms);
+        if (got <= 0) {
+            if (!first_err) first_err = got;
+            i++;
+            continue;
+        }
+        answered += (uint32_t)got;
+        i += (uint32_t)got;
+    }
+    free(parsed);
+    if (answered == 0 && first_err) return first_err;
+    return (int)answered;
+}
+
 void http_response_free(http_response_t *resp) {
     if (!resp) return;
     if (resp->body) {
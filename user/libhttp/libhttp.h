@@ -17,8 +17,14 @@
 //   - GET and POST (arbitrary Content-Type).
 //   - Content-Length and `Transfer-Encoding: chunked` bodies.
 //   - 3xx redirect follow, up to LIBHTTP_MAX_REDIRECTS hops.
-//   - Host header with implicit port (omitted for 80/443) + `Connection:
-//     close` always — keep-alive is deferred to a future phase.
+//   - Host header with implicit port (omitted for 80/443).
+//   - Phase 29: persistent connections. Requests go out with `Connection:
+//     keep-alive`; responses are framed by Content-Length / chunked /
+//     status instead of by FIN, and a connection that stays open returns
+//     to a per-process pool (LIBHTTP_POOL_SLOTS, keyed by scheme + host +
+//     port) for the next request to that origin. HTTPS connections keep
+//     their TLS session, and new ones resume it via libtls's session
+//     cache. Idempotent GETs can be pipelined with http_get_pipelined.
 //   - Timeout budget shared across DNS + TCP open + request + response.
 //   - Bodies up to LIBHTTP_MAX_BODY_BYTES; larger responses truncate with
 //     `body_truncated=1` set.
@@ -41,6 +47,10 @@
 #define LIBHTTP_MAX_PATH_LEN    1024u
 #define LIBHTTP_MAX_BODY_BYTES  (128u * 1024u)  // 128 KiB cap per response
 #define LIBHTTP_DEFAULT_TIMEOUT_MS  10000u
+#define LIBHTTP_MAX_HEAD_BYTES  16384u  // Status line + headers
+#define LIBHTTP_POOL_SLOTS      4u      // Idle keep-alive connections kept
+#define LIBHTTP_POOL_IDLE_MS    30000u  // Max idle time before a pooled close
+#define LIBHTTP_PIPELINE_DEPTH  8u      // GETs in flight per connection
 
 // Parsed URL. Buffers are inline so callers don't have to free anything.
 typedef struct http_url {
@@ -82,6 +92,21 @@ int http_post(http_response_t *resp, const char *url,
               const char *content_type,
               uint32_t timeout_ms);
 
+// Phase 29: GET each of urls[0..n) into resps[0..n), pipelining runs of
+// same-origin URLs over one pooled connection. Redirects are not followed.
+// A URL that could not be fetched leaves its resps[i].status_code at 0.
+// Returns how many responses arrived, or negative errno if none did and
+// something failed. Every resps[i] must be freed with http_response_free.
+int http_get_pipelined(http_response_t *resps, const char *const *urls,
+                       uint32_t n, uint32_t timeout_ms);
+
+// Phase 29: enable (default) or disable keep-alive. Disabling closes every
+// pooled connection and makes later requests send `Connection: close`.
+void http_set_keepalive(int on);
+
+// Close every idle pooled connection.
+void http_pool_flush(void);
+
 // Free the allocated body buffer and zero the struct. Safe to call on a
 // zero-init'd struct (no-op).
 void http_response_free(http_response_t *resp);
@@ -108,6 +133,23 @@ int http_parse_header_block(const char *buf, size_t len,
 int http_chunked_decode(uint8_t *dst, size_t dst_cap,
                         const uint8_t *src, size_t src_len);
 
+// Phase 29: find where the response at the start of `buf` ends. Returns 1
+// with *out filled when it is complete, 0 when more bytes are needed (if
+// out->head_len != 0 the head is in and out->until_close says the body runs
+// to the peer's FIN), or -5 if malformed. `head_request` marks a response
+// to HEAD, which never has a body.
+typedef struct http_frame {
+    int      status;             // Status code
+    uint32_t head_len;           // Status line + headers + blank line
+    uint32_t total_len;          // Head + encoded body (0 until complete)
+    uint32_t idle_ms;            // Keep-Alive: timeout=N, in ms (0 if absent)
+    uint8_t  keep_alive;         // Connection may carry another request
+    uint8_t  until_close;        // Unframed body: ends at FIN
+    uint8_t  _pad[2];
+} http_frame_t;
+int http_response_frame(const uint8_t *buf, uint32_t len, int head_request,
+                        http_frame_t *out);
+
 // Case-insensitive ASCII string compare. Returns 0 on equal.
 int http_strcasecmp(const char *a, const char *b);
 int http_strncasecmp(const char *a, const char *b, size_t n);
@@ -66,52 +66,66 @@ uint16_t libnet_msg_build_err_response(void *buf, uint16_t cap,
     return (uint16_t)(sizeof(*h) + sizeof(int32_t));
 }
 
-int libnet_msg_send_recv(libnet_client_ctx_t *ctx,
-                         const void *req_buf, uint16_t req_len,
-                         void *resp_buf, uint16_t resp_cap,
-                         uint16_t *out_resp_len,
-                         uint64_t timeout_ns) {
-    if (!ctx || !req_buf || !resp_buf) return -5;
-    if (req_len < sizeof(libnet_msg_header_t)) return -5;
-
+// Send one request and leave the whole matching response message (handles
+// included) in *m. SHM_KICK doorbells that arrive meanwhile are dropped.
+static int libnet_msg_exchange(libnet_client_ctx_t *ctx,
+                               const void *req_buf, uint16_t req_len,
+                               chan_msg_user_t *m, uint64_t timeout_ns) {
     const libnet_msg_header_t *req_hdr =
         (const libnet_msg_header_t *)req_buf;
     uint32_t expected_seq = req_hdr->seq;
 
-    chan_msg_user_t m;
-    memset(&m, 0, sizeof(m));
-    m.header.inline_len = req_len;
-    m.header.nhandles   = 0;
+    memset(m, 0, sizeof(*m));
+    m->header.inline_len = req_len;
+    m->header.nhandles   = 0;
     // Channels on /sys/net/service are typed grahaos.net.socket.v1. The
     // kernel cap_object layer validates this at send time using the type
     // hash stamped into the channel at creation. Clients that want to pass
     // additional handles set them in `m.handles[]`; Stage C doesn't use
     // that path.
-    memcpy(m.inline_payload, req_buf, req_len);
+    memcpy(m->inline_payload, req_buf, req_len);
 
-    long sc = syscall_chan_send(ctx->wr_req, &m, timeout_ns);
+    long sc = syscall_chan_send(ctx->wr_req, m, timeout_ns);
     if (sc < 0) return (int)sc;
 
     for (;;) {
-        memset(&m, 0, sizeof(m));
-        long rc = syscall_chan_recv(ctx->rd_resp, &m, timeout_ns);
+        memset(m, 0, sizeof(*m));
+        long rc = syscall_chan_recv(ctx->rd_resp, m, timeout_ns);
         if (rc < 0) return (int)rc;
-        if (m.header.inline_len < sizeof(libnet_msg_header_t)) continue;
+        if (m->header.inline_len < sizeof(libnet_msg_header_t)) continue;
 
         const libnet_msg_header_t *resp_hdr =
-            (const libnet_msg_header_t *)m.inline_payload;
+            (const libnet_msg_header_t *)m->inline_payload;
+        if (resp_hdr->op == LIBNET_OP_TCP_SHM_KICK_RESP) {
+            // A doorbell nobody is waiting on; the rings carry the state.
+            continue;
+        }
         if (resp_hdr->seq != expected_seq) {
             // Stale response from an earlier cancelled request — drop and
             // keep waiting. Belt-and-braces; Stage C never interleaves.
             continue;
         }
-        if (m.header.inline_len > resp_cap) return -5;
-        memcpy(resp_buf, m.inline_payload, m.header.inline_len);
-        if (out_resp_len) *out_resp_len = m.header.inline_len;
         return 0;
     }
 }
 
+int libnet_msg_send_recv(libnet_client_ctx_t *ctx,
+                         const void *req_buf, uint16_t req_len,
+                         void *resp_buf, uint16_t resp_cap,
+                         uint16_t *out_resp_len,
+                         uint64_t timeout_ns) {
+    if (!ctx || !req_buf || !resp_buf) return -5;
+    if (req_len < sizeof(libnet_msg_header_t)) return -5;
+
+    chan_msg_user_t m;
+    int rc = libnet_msg_exchange(ctx, req_buf, req_len, &m, timeout_ns);
+    if (rc < 0) return rc;
+    if (m.header.inline_len > resp_cap) return -5;
+    memcpy(resp_buf, m.inline_payload, m.header.inline_len);
+    if (out_resp_len) *out_resp_len = m.header.inline_len;
+    return 0;
+}
+
 // --- High-level helpers -----------------------------------------------------
 
 int libnet_hello(libnet_client_ctx_t *ctx, uint64_t timeout_ns,
@@ -247,11 +261,203 @@ int libnet_tcp_open(libnet_client_ctx_t *ctx,
     return 0;
 }
 
+// --- Shared-memory sockets (Phase 26) ---------------------------------------
+// Attached sockets, per process. The ring positions in the ctl page are the
+// only state; nothing here caches them.
+
+typedef struct libnet_shm_sock {
+    libnet_client_ctx_t  *ctx;
+    uint32_t              cookie;       // 0 = free slot
+    uint32_t              rx_bytes;
+    uint32_t              tx_bytes;
+    uint32_t              map_bytes;
+    libnet_tcp_shm_ctl_t *ctl;
+    uint8_t              *rx;
+    uint8_t              *tx;
+} libnet_shm_sock_t;
+
+static libnet_shm_sock_t libnet_shm[LIBNET_TCP_SHM_MAX_SOCKETS];
+
+static libnet_shm_sock_t *libnet_shm_find(libnet_client_ctx_t *ctx,
+                                          uint32_t cookie) {
+    if (cookie == 0) return NULL;
+    for (uint32_t i = 0; i < LIBNET_TCP_SHM_MAX_SOCKETS; i++) {
+        if (libnet_shm[i].cookie == cookie && libnet_shm[i].ctx == ctx) {
+            return &libnet_shm[i];
+        }
+    }
+    return NULL;
+}
+
+// Doorbell to netd, only if it armed netd_kick. Never blocks: if the
+// request channel is full netd is awake anyway, and its tick re-reads the
+// rings regardless.
+static void libnet_shm_ring(libnet_shm_sock_t *sk) {
+    if (!__atomic_exchange_n(&sk->ctl->netd_kick, 0u, __ATOMIC_ACQ_REL)) return;
+    libnet_tcp_shm_kick_t k;
+    memset(&k, 0, sizeof(k));
+    libnet_msg_set_header(&k.hdr, LIBNET_OP_TCP_SHM_KICK_REQ, 0);
+    k.socket_cookie = sk->cookie;
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    m.header.inline_len = (uint16_t)sizeof(k);
+    memcpy(m.inline_payload, &k, sizeof(k));
+    (void)syscall_chan_send(sk->ctx->wr_req, &m, 0);
+}
+
+// Sleep until netd rings or `deadline_tsc` passes. The caller armed
+// client_kick and re-checked the rings first, so a wake-up is never lost.
+// Any message counts as a wake-up: the caller looks at the rings again.
+static int libnet_shm_wait(libnet_shm_sock_t *sk, uint64_t deadline_tsc) {
+    uint64_t now = spin_rdtsc();
+    if (now >= deadline_tsc) return -110 /* ETIMEDOUT */;
+    uint64_t hz = spin_tsc_hz();
+    uint64_t d  = deadline_tsc - now;
+    uint64_t ns = hz ? (d / hz) * 1000000000ull + ((d % hz) * 1000000000ull) / hz
+                     : 1000000ull;
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    long rc = syscall_chan_recv(sk->ctx->rd_resp, &m, ns);
+    if (rc < 0 && rc != -11 /* EAGAIN: timed out */) return (int)rc;
+    return 0;
+}
+
+static uint64_t libnet_shm_deadline(uint32_t timeout_ms) {
+    return spin_rdtsc() + (uint64_t)timeout_ms * (spin_tsc_hz() / 1000u);
+}
+
+int libnet_tcp_shm_attach(libnet_client_ctx_t *ctx, uint32_t cookie,
+                          uint32_t ring_bytes, uint64_t timeout_ns) {
+    if (!ctx || cookie == 0) return -5;
+    if (libnet_shm_find(ctx, cookie)) return 0;
+    libnet_shm_sock_t *sk = NULL;
+    for (uint32_t i = 0; !sk && i < LIBNET_TCP_SHM_MAX_SOCKETS; i++) {
+        if (libnet_shm[i].cookie == 0) sk = &libnet_shm[i];
+    }
+    if (!sk) return -11 /* EAGAIN */;
+
+    libnet_tcp_shm_attach_req_t req;
+    memset(&req, 0, sizeof(req));
+    libnet_msg_set_header(&req.hdr, LIBNET_OP_TCP_SHM_ATTACH_REQ,
+                          libnet_rng_next());
+    req.socket_cookie = cookie;
+    req.rx_bytes      = ring_bytes;
+    req.tx_bytes      = ring_bytes;
+
+    chan_msg_user_t m;
+    int rc = libnet_msg_exchange(ctx, &req, sizeof(req), &m, timeout_ns);
+    if (rc < 0) return rc;
+    libnet_tcp_shm_attach_resp_t resp;
+    memset(&resp, 0, sizeof(resp));
+    uint16_t n = m.header.inline_len;
+    memcpy(&resp, m.inline_payload, n < sizeof(resp) ? n : sizeof(resp));
+    if (resp.hdr.op != LIBNET_OP_TCP_SHM_ATTACH_RESP) return -5;
+    if (resp.status < 0) return resp.status;
+    if (m.header.nhandles < 1) return -5;
+
+    // VMO_MAP_RETIRE: the mapping is all we keep, so closing the socket
+    // (unmap) releases the rings without leaving a handle behind.
+    cap_token_u_t vmo = { .raw = m.handles[0] };
+    long va = syscall_vmo_map(vmo, 0, 0, resp.map_bytes,
+                              PROT_READ | PROT_WRITE | VMO_MAP_RETIRE);
+    if (va <= 0) return va < 0 ? (int)va : -12;
+    sk->ctx       = ctx;
+    sk->cookie    = cookie;
+    sk->rx_bytes  = resp.rx_bytes;
+    sk->tx_bytes  = resp.tx_bytes;
+    sk->map_bytes = resp.map_bytes;
+    sk->ctl = (libnet_tcp_shm_ctl_t *)(uintptr_t)va;
+    sk->rx  = (uint8_t *)(uintptr_t)va + LIBNET_TCP_SHM_CTL_BYTES;
+    sk->tx  = sk->rx + resp.rx_bytes;
+    return 0;
+}
+
+int libnet_tcp_shm_write(libnet_client_ctx_t *ctx, uint32_t cookie,
+                         const uint8_t *buf, uint32_t len,
+                         uint32_t timeout_ms) {
+    libnet_shm_sock_t *sk = libnet_shm_find(ctx, cookie);
+    if (!sk) return -9 /* EBADF */;
+    if (!buf && len) return -5;
+    libnet_tcp_shm_ctl_t *c = sk->ctl;
+    uint64_t deadline = libnet_shm_deadline(timeout_ms);
+    for (;;) {
+        if (c->rx_flags & LIBNET_TCP_SHM_RX_CLOSED) return -32 /* EPIPE */;
+        uint32_t prod = c->tx_prod;
+        uint32_t cons = __atomic_load_n(&c->tx_cons, __ATOMIC_ACQUIRE);
+        uint32_t room = sk->tx_bytes - (prod - cons);
+        if (room > 0 || len == 0) {
+            uint32_t n = len < room ? len : room;
+            for (uint32_t done = 0; done < n; ) {
+                uint32_t o = (prod + done) & (sk->tx_bytes - 1u);
+                uint32_t k = sk->tx_bytes - o;
+                if (k > n - done) k = n - done;
+                memcpy(&sk->tx[o], buf + done, k);
+                done += k;
+            }
+            __atomic_store_n(&c->tx_prod, prod + n, __ATOMIC_RELEASE);
+            libnet_shm_ring(sk);
+            return (int)n;
+        }
+        if (timeout_ms == 0) return -11 /* EAGAIN */;
+        // Full: netd frees space as ACKs arrive. Arm, then look again
+        // before sleeping so a release in between still wakes us.
+        __atomic_store_n(&c->client_kick, 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&c->tx_cons, __ATOMIC_SEQ_CST) != cons) continue;
+        int w = libnet_shm_wait(sk, deadline);
+        if (w < 0) return w;
+    }
+}
+
+int libnet_tcp_shm_read(libnet_client_ctx_t *ctx, uint32_t cookie,
+                        uint8_t *buf, uint32_t cap, uint32_t timeout_ms) {
+    libnet_shm_sock_t *sk = libnet_shm_find(ctx, cookie);
+    if (!sk) return -9 /* EBADF */;
+    if (!buf && cap) return -5;
+    libnet_tcp_shm_ctl_t *c = sk->ctl;
+    uint64_t deadline = libnet_shm_deadline(timeout_ms);
+    for (;;) {
+        uint32_t cons  = c->rx_cons;
+        uint32_t flags = __atomic_load_n(&c->rx_flags, __ATOMIC_ACQUIRE);
+        uint32_t prod  = __atomic_load_n(&c->rx_prod, __ATOMIC_ACQUIRE);
+        uint32_t avail = prod - cons;
+        if (avail > 0) {
+            uint32_t n = cap < avail ? cap : avail;
+            for (uint32_t done = 0; done < n; ) {
+                uint32_t o = (cons + done) & (sk->rx_bytes - 1u);
+                uint32_t k = sk->rx_bytes - o;
+                if (k > n - done) k = n - done;
+                memcpy(buf + done, &sk->rx[o], k);
+                done += k;
+            }
+            __atomic_store_n(&c->rx_cons, cons + n, __ATOMIC_RELEASE);
+            libnet_shm_ring(sk);
+            return (int)n;
+        }
+        if (flags & LIBNET_TCP_SHM_RX_FIN) return 0;
+        if (flags & LIBNET_TCP_SHM_RX_CLOSED) return -104 /* ECONNRESET */;
+        if (timeout_ms == 0) return -11 /* EAGAIN */;
+        __atomic_store_n(&c->client_kick, 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&c->rx_prod, __ATOMIC_SEQ_CST) != prod ||
+            __atomic_load_n(&c->rx_flags, __ATOMIC_SEQ_CST) != flags) {
+            continue;
+        }
+        int w = libnet_shm_wait(sk, deadline);
+        if (w < 0) return w;
+    }
+}
+
 int libnet_tcp_send(libnet_client_ctx_t *ctx, uint32_t cookie,
                     const uint8_t *payload, uint16_t payload_len,
                     uint64_t timeout_ns,
                     uint32_t *out_bytes_sent) {
     if (!ctx || (!payload && payload_len)) return -5;
+    if (libnet_shm_find(ctx, cookie)) {
+        int n = libnet_tcp_shm_write(ctx, cookie, payload, payload_len,
+                                     (uint32_t)(timeout_ns / 1000000ull));
+        if (n < 0) return n;
+        if (out_bytes_sent) *out_bytes_sent = (uint32_t)n;
+        return 0;
+    }
     if (payload_len > LIBNET_TCP_CHUNK_MAX) return -5;
 
     libnet_tcp_send_req_t req;
@@ -288,6 +494,17 @@ int libnet_tcp_recv(libnet_client_ctx_t *ctx, uint32_t cookie,
                     uint16_t *out_payload_len,
                     uint16_t *out_flags) {
     if (!ctx || (!buf && buf_cap)) return -5;
+    libnet_shm_sock_t *sk = libnet_shm_find(ctx, cookie);
+    if (sk) {
+        // Same contract as the message path: data with status 0, -EPIPE
+        // once the peer's FIN has been read up to.
+        int n = libnet_tcp_shm_read(ctx, cookie, buf, buf_cap, timeout_ms);
+        uint16_t fl = (sk->ctl->rx_flags & LIBNET_TCP_SHM_RX_FIN) ? 1u : 0u;
+        if (out_flags) *out_flags = fl;
+        if (out_payload_len) *out_payload_len = n > 0 ? (uint16_t)n : 0;
+        if (n == 0) return -32 /* EPIPE */;
+        return n < 0 ? n : 0;
+    }
     uint16_t cap = buf_cap;
     if (cap > LIBNET_TCP_CHUNK_MAX) cap = LIBNET_TCP_CHUNK_MAX;
 
@@ -337,6 +554,13 @@ int libnet_tcp_close(libnet_client_ctx_t *ctx, uint32_t cookie,
     int rc = libnet_msg_send_recv(ctx, &req, sizeof(req),
                                   &resp, sizeof(resp),
                                   &resp_len, timeout_ns);
+    // The close request carried every queued byte's position with it (netd
+    // reads tx_prod first), so the mapping can go now whatever the outcome.
+    libnet_shm_sock_t *sk = libnet_shm_find(ctx, cookie);
+    if (sk) {
+        (void)syscall_vmo_unmap((uint64_t)(uintptr_t)sk->ctl, sk->map_bytes);
+        memset(sk, 0, sizeof(*sk));
+    }
     if (rc < 0) return rc;
     if (resp.hdr.op != LIBNET_OP_TCP_CLOSE_RESP) return -5;
     return resp.status;
@@ -361,6 +585,63 @@ int libnet_tcp_status(libnet_client_ctx_t *ctx, uint32_t cookie,
     return out->status;
 }
 
+int libnet_tcp_listen(libnet_client_ctx_t *ctx, uint16_t local_port,
+                      uint16_t backlog, uint64_t timeout_ns,
+                      uint32_t *out_listen_cookie) {
+    if (!ctx || local_port == 0) return -5;
+    libnet_tcp_listen_req_t req;
+    memset(&req, 0, sizeof(req));
+    libnet_msg_set_header(&req.hdr, LIBNET_OP_TCP_LISTEN_REQ,
+                          libnet_rng_next());
+    req.local_ip    = 0;
+    req.local_port  = local_port;
+    req.backlog     = backlog;
+    req.syn_backlog = 0;
+    req.flags       = LIBNET_TCP_LISTEN_FLAG_NONE;
+
+    libnet_tcp_listen_resp_t resp;
+    memset(&resp, 0, sizeof(resp));
+    uint16_t resp_len = 0;
+    int rc = libnet_msg_send_recv(ctx, &req, sizeof(req),
+                                  &resp, sizeof(resp),
+                                  &resp_len, timeout_ns);
+    if (rc < 0) return rc;
+    if (resp.hdr.op != LIBNET_OP_TCP_LISTEN_RESP) return -5;
+    if (resp.status < 0) return resp.status;
+    if (out_listen_cookie) *out_listen_cookie = resp.listen_cookie;
+    return 0;
+}
+
+int libnet_tcp_accept(libnet_client_ctx_t *ctx, uint32_t listen_cookie,
+                      libnet_tcp_accept_ent_t *out, uint16_t max,
+                      uint32_t timeout_ms) {
+    if (!ctx || !out || max == 0) return -5;
+    if (max > LIBNET_TCP_ACCEPT_BATCH_MAX) max = LIBNET_TCP_ACCEPT_BATCH_MAX;
+
+    libnet_tcp_accept_req_t req;
+    memset(&req, 0, sizeof(req));
+    libnet_msg_set_header(&req.hdr, LIBNET_OP_TCP_ACCEPT_REQ,
+                          libnet_rng_next());
+    req.listen_cookie = listen_cookie;
+    req.max_conns     = max;
+    req.timeout_ms    = timeout_ms;
+
+    libnet_tcp_accept_resp_t resp;
+    memset(&resp, 0, sizeof(resp));
+    uint16_t resp_len = 0;
+    uint64_t budget_ns = ((uint64_t)timeout_ms + 1000u) * 1000000ULL;
+    int rc = libnet_msg_send_recv(ctx, &req, sizeof(req),
+                                  &resp, sizeof(resp),
+                                  &resp_len, budget_ns);
+    if (rc < 0) return rc;
+    if (resp.hdr.op != LIBNET_OP_TCP_ACCEPT_RESP) return -5;
+    if (resp.status < 0) return resp.status;
+    uint16_t n = resp.count;
+    if (n > max) n = max;
+    memcpy(out, resp.conns, (size_t)n * sizeof(*out));
+    return (int)n;
+}
+
 int libnet_dns_resolve(libnet_client_ctx_t *ctx, const char *hostname,
                        uint32_t timeout_ms,
                        libnet_dns_query_resp_t *out) {
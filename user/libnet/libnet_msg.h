@@ -82,6 +82,24 @@
 #define LIBNET_OP_TCP_STATUS_REQ   0x0054u
 #define LIBNET_OP_TCP_STATUS_RESP  0x8054u
 
+// TCP passive open (Phase 26). LISTEN binds a port and returns a listen
+// cookie; ACCEPT hands over up to LIBNET_TCP_ACCEPT_BATCH_MAX established
+// connections per round-trip, each with its own socket cookie for the
+// SEND/RECV/CLOSE/STATUS ops above. CLOSE on the listen cookie unbinds.
+#define LIBNET_OP_TCP_LISTEN_REQ   0x0055u
+#define LIBNET_OP_TCP_LISTEN_RESP  0x8055u
+#define LIBNET_OP_TCP_ACCEPT_REQ   0x0056u
+#define LIBNET_OP_TCP_ACCEPT_RESP  0x8056u
+
+// TCP shared-memory buffers (Phase 26). SHM_ATTACH moves a connected
+// socket's data path into a VMO shared with netd; SHM_KICK is a doorbell
+// in either direction (REQ client → netd, RESP netd → client) and is
+// never answered.
+#define LIBNET_OP_TCP_SHM_ATTACH_REQ   0x0057u
+#define LIBNET_OP_TCP_SHM_ATTACH_RESP  0x8057u
+#define LIBNET_OP_TCP_SHM_KICK_REQ     0x0058u
+#define LIBNET_OP_TCP_SHM_KICK_RESP    0x8058u
+
 // ---------------------------------------------------------------------------
 // Shared preamble. Every message starts with this; `op` + 6 bytes of
 // padding + seq = 8 bytes so the body starts 8-byte-aligned.
@@ -311,6 +329,133 @@ typedef struct __attribute__((packed)) libnet_tcp_status_resp {
     uint32_t tx_pending;        // Bytes not yet ACKed by peer
 } libnet_tcp_status_resp_t;
 
+// ---------------------------------------------------------------------------
+// TCP listen / accept (Phase 26). Two queues per listener, as in BSD:
+//   SYN queue    — handshakes in progress (SYN_RCVD), at most `syn_backlog`.
+//                  Once full, further SYNs are answered with SYN cookies
+//                  (unless LIBNET_TCP_LISTEN_FLAG_NO_COOKIES), so a SYN flood
+//                  costs netd no per-connection state.
+//   accept queue — ESTABLISHED connections waiting for ACCEPT, at most
+//                  `backlog`. While it is full, new SYNs and completing ACKs
+//                  are dropped and the peers retry.
+// ---------------------------------------------------------------------------
+#define LIBNET_TCP_BACKLOG_DEFAULT      64u
+#define LIBNET_TCP_BACKLOG_MAX          1024u
+#define LIBNET_TCP_ACCEPT_BATCH_MAX     16u
+
+#define LIBNET_TCP_LISTEN_FLAG_NONE        0u
+#define LIBNET_TCP_LISTEN_FLAG_NO_COOKIES  1u   // Drop SYNs once the queue is full
+
+typedef struct __attribute__((packed)) libnet_tcp_listen_req {
+    libnet_msg_header_t hdr;
+    uint32_t local_ip;          // host-order; 0 = any local address
+    uint16_t local_port;        // host-order; must be nonzero
+    uint16_t backlog;           // Accept-queue depth; 0 = default
+    uint16_t syn_backlog;       // SYN-queue depth; 0 = same as backlog
+    uint16_t flags;             // LIBNET_TCP_LISTEN_FLAG_*
+} libnet_tcp_listen_req_t;
+
+typedef struct __attribute__((packed)) libnet_tcp_listen_resp {
+    libnet_msg_header_t hdr;
+    int32_t  status;            // 0, -EADDRINUSE, -EAGAIN (no listener slot)
+    uint32_t listen_cookie;
+    uint16_t local_port;
+    uint16_t backlog;           // Depth actually granted (after clamping)
+} libnet_tcp_listen_resp_t;
+
+typedef struct __attribute__((packed)) libnet_tcp_accept_req {
+    libnet_msg_header_t hdr;
+    uint32_t listen_cookie;
+    uint16_t max_conns;         // 1..LIBNET_TCP_ACCEPT_BATCH_MAX; 0 = 1
+    uint16_t _pad;
+    uint32_t timeout_ms;        // 0 = return immediately (EAGAIN if none)
+} libnet_tcp_accept_req_t;
+
+typedef struct __attribute__((packed)) libnet_tcp_accept_ent {
+    uint32_t socket_cookie;
+    uint32_t remote_ip;         // host-order
+    uint16_t remote_port;
+    uint16_t local_port;
+} libnet_tcp_accept_ent_t;
+
+typedef struct __attribute__((packed)) libnet_tcp_accept_resp {
+    libnet_msg_header_t hdr;
+    int32_t  status;            // 0 with count >= 1; -EAGAIN, -ETIMEDOUT,
+                                // -ECONNABORTED when the listener closes
+    uint16_t count;
+    uint16_t _pad;
+    libnet_tcp_accept_ent_t conns[LIBNET_TCP_ACCEPT_BATCH_MAX];
+} libnet_tcp_accept_resp_t;
+
+_Static_assert(sizeof(libnet_tcp_listen_req_t)  <= CHAN_MSG_INLINE_MAX,
+               "tcp_listen_req too big");
+_Static_assert(sizeof(libnet_tcp_accept_resp_t) <= CHAN_MSG_INLINE_MAX,
+               "tcp_accept_resp too big");
+
+// ---------------------------------------------------------------------------
+// TCP shared-memory socket buffers (Phase 26). TCP_SHM_ATTACH replaces a
+// connected socket's netd-side rings with one VMO that both sides map
+// (handles[0] of the response; both sides map it with VMO_MAP_RETIRE and
+// keep no handle, so unmapping at close releases it):
+//   [0, 4096)                        libnet_tcp_shm_ctl_t
+//   [4096, 4096 + rx_bytes)          rx ring: netd produces, client consumes
+//   [4096 + rx_bytes, + tx_bytes)    tx ring: client produces, netd consumes
+// Indices are free-running uint32 positions in TCP sequence space; byte k
+// lives at ring[k & (bytes - 1)]. Each ring is the socket's whole buffer
+// for its direction, so rx_bytes is also the largest window netd offers.
+//
+// After attaching no payload travels in messages. The channel carries
+// only SHM_KICK doorbells, and only when the other side armed its kick
+// word before sleeping (then re-checked the indices) — the same hand-off
+// as the rawframe ring. netd arms netd_kick when it wants to hear of new
+// tx bytes or of rx space worth a window update; the client arms
+// client_kick before waiting for rx data or tx space. TCP_SEND and
+// TCP_RECV on an attached socket fail with -EINVAL; libnet_tcp_send /
+// libnet_tcp_recv route through the rings instead.
+// ---------------------------------------------------------------------------
+#define LIBNET_TCP_SHM_CTL_BYTES      4096u
+#define LIBNET_TCP_SHM_RING_DEFAULT   (256u * 1024u)
+#define LIBNET_TCP_SHM_RING_MAX       (1024u * 1024u)
+
+#define LIBNET_TCP_SHM_RX_FIN      0x1u   // Peer sent FIN: rx_prod is final
+#define LIBNET_TCP_SHM_RX_CLOSED   0x2u   // netd dropped the connection
+
+// One cache line per writer, so neither side dirties the other's.
+typedef struct libnet_tcp_shm_ctl {
+    volatile uint32_t rx_prod;      // netd: end of in-order received bytes
+    volatile uint32_t rx_flags;     // netd: LIBNET_TCP_SHM_RX_*
+    volatile uint32_t tx_cons;      // netd: ACKed — tx space free again
+    volatile uint32_t netd_kick;    // netd arms, client clears and rings
+    uint32_t _pad0[12];
+    volatile uint32_t rx_cons;      // client: bytes read
+    volatile uint32_t tx_prod;      // client: end of queued bytes
+    volatile uint32_t client_kick;  // client arms, netd clears and rings
+    uint32_t _pad1[13];
+} libnet_tcp_shm_ctl_t;
+
+_Static_assert(sizeof(libnet_tcp_shm_ctl_t) == 128,
+               "libnet_tcp_shm_ctl_t layout drift");
+
+typedef struct __attribute__((packed)) libnet_tcp_shm_attach_req {
+    libnet_msg_header_t hdr;
+    uint32_t socket_cookie;
+    uint32_t rx_bytes;          // 0 = default; rounded up to a power of two
+    uint32_t tx_bytes;
+} libnet_tcp_shm_attach_req_t;
+
+typedef struct __attribute__((packed)) libnet_tcp_shm_attach_resp {
+    libnet_msg_header_t hdr;
+    int32_t  status;            // 0, -EBADF, -EINVAL, -ENOTCONN, -ENOMEM
+    uint32_t rx_bytes;          // Ring sizes actually granted
+    uint32_t tx_bytes;
+    uint32_t map_bytes;         // Whole VMO
+} libnet_tcp_shm_attach_resp_t;
+
+typedef struct __attribute__((packed)) libnet_tcp_shm_kick {
+    libnet_msg_header_t hdr;    // seq is 0
+    uint32_t socket_cookie;
+} libnet_tcp_shm_kick_t;
+
 // ---------------------------------------------------------------------------
 // HELLO — liveness handshake, useful for tests that only want to know the
 // dispatcher is alive.
@@ -400,6 +545,44 @@ int libnet_tcp_status(libnet_client_ctx_t *ctx, uint32_t cookie,
                       uint64_t timeout_ns,
                       libnet_tcp_status_resp_t *out);
 
+// TCP server helpers (Phase 26).
+//   libnet_tcp_listen: binds `local_port` on every local address; backlog 0
+//                      takes the default. Close with libnet_tcp_close.
+//   libnet_tcp_accept: blocks up to timeout_ms for at least one connection
+//                      and returns up to `max` of them in `out` (batched:
+//                      one round-trip drains a burst). Returns the count
+//                      (>= 1) or a negative errno.
+int libnet_tcp_listen(libnet_client_ctx_t *ctx, uint16_t local_port,
+                      uint16_t backlog, uint64_t timeout_ns,
+                      uint32_t *out_listen_cookie);
+
+int libnet_tcp_accept(libnet_client_ctx_t *ctx, uint32_t listen_cookie,
+                      libnet_tcp_accept_ent_t *out, uint16_t max,
+                      uint32_t timeout_ms);
+
+// Shared-memory socket buffers (Phase 26).
+//   libnet_tcp_shm_attach: map the socket's rings into this process
+//                          (ring_bytes 0 = default). From then on
+//                          libnet_tcp_send / libnet_tcp_recv use them, and
+//                          libnet_tcp_close unmaps them.
+//   libnet_tcp_shm_write:  queue up to `len` bytes, blocking up to
+//                          timeout_ms for space. Returns the bytes queued.
+//   libnet_tcp_shm_read:   take up to `cap` bytes, blocking up to
+//                          timeout_ms for data. Returns the bytes read, 0
+//                          at end of stream.
+// Up to LIBNET_TCP_SHM_MAX_SOCKETS sockets per process may be attached.
+#define LIBNET_TCP_SHM_MAX_SOCKETS  16u
+
+int libnet_tcp_shm_attach(libnet_client_ctx_t *ctx, uint32_t cookie,
+                          uint32_t ring_bytes, uint64_t timeout_ns);
+
+int libnet_tcp_shm_write(libnet_client_ctx_t *ctx, uint32_t cookie,
+                         const uint8_t *buf, uint32_t len,
+                         uint32_t timeout_ms);
+
+int libnet_tcp_shm_read(libnet_client_ctx_t *ctx, uint32_t cookie,
+                        uint8_t *buf, uint32_t cap, uint32_t timeout_ms);
+
 // Low-level send+recv pair for clients that want custom handling (e.g. the
 // dispatcher tests). Both operate against an already-connected ctx.
 int libnet_msg_send_recv(libnet_client_ctx_t *ctx,
@@ -23,6 +23,31 @@
 //              sends TX_REQ{slot, len} on wr_req. Driver DMAs the frame.
 //        - LINK_UP / LINK_DOWN: driver pushes to client on state change.
 //
+// Phase 26 offloads: ANNOUNCE.features says what the NIC can do. RX_NOTIFY
+// flags report checksums the NIC already verified; TX_REQ flags ask it to
+// insert checksums or, with RAWFRAME_TX_TSO, to cut one super-segment of
+// up to RAWFRAME_TSO_MAX_BYTES into `mss`-sized TCP segments. A TSO frame
+// may be longer than slot_size: it then fills consecutive slots starting
+// at `slot` and never wraps past the end of the ring.
+//
+// Phase 26 ring hand-off (RAWFRAME_FEAT_RING): instead of one channel
+// message per frame, driver and client share a third VMO (handles[2])
+// holding a producer/consumer index pair per direction plus one
+// rawframe_ring_ent_t per slot. All four indices are free-running uint32
+// counters; entry k lives at ent[k % slot_count].
+//   - RX: the driver fills rx entry k for the frame in slot k % slot_count
+//     and advances rx_prod once per batch. The client parses each frame in
+//     place and releases it by advancing rx_cons; the driver hands a slot
+//     back to the NIC only after that. One RX_KICK covers a whole batch
+//     and is only sent when the client armed rx_kick before going idle.
+//   - TX: the client writes a frame into its slot(s), fills tx entry k and
+//     advances tx_prod; the driver picks new entries up on every pass of
+//     its loop (where it used to drain TX_REQ) and advances tx_cons once
+//     the NIC has finished with them, so the client knows which tx slots
+//     it may overwrite.
+// Only one client per driver gets the ring; later ones see the feature
+// bit clear and use the per-frame messages above.
+//
 // Stage B scope: message types + ANNOUNCE exchange (VMO hand-off) land.
 // Real RX/TX fanout is deferred to a follow-up sub-unit; it's safe to
 // leave the kernel-proxy frame path as-is during Stages B-E per D8.
@@ -37,6 +62,7 @@
 #define RAWFRAME_OP_TX_REQ       3u   // client → driver
 #define RAWFRAME_OP_LINK_UP      4u   // driver → client
 #define RAWFRAME_OP_LINK_DOWN    5u   // driver → client
+#define RAWFRAME_OP_RX_KICK      6u   // driver → client: rx_prod moved (Phase 26)
 
 // ANNOUNCE payload. Sent immediately after the rawframe accept succeeds.
 // Carries everything the client needs to start consuming frames:
@@ -46,25 +72,98 @@
 //
 // handles[0] = rx ring VMO (driver writes, client reads)
 // handles[1] = tx ring VMO (client writes, driver reads)
+// handles[2] = ring index VMO, only with RAWFRAME_FEAT_RING (Phase 26)
 typedef struct __attribute__((packed)) rawframe_announce {
     uint8_t  op;                 // = RAWFRAME_OP_ANNOUNCE
     uint8_t  mac[6];
     uint8_t  link_up;            // 0 or 1
     uint32_t slot_count;         // e.g. 16
-    uint32_t slot_size;          // e.g. 4096
-    uint32_t reserved;           // future: MTU, extended flags
+    uint32_t slot_size;          // e.g. 2048
+    uint32_t features;           // RAWFRAME_FEAT_* (Phase 26; was reserved, 0)
 } rawframe_announce_t;
 
 _Static_assert(sizeof(rawframe_announce_t) == 20,
                "rawframe_announce_t layout drift");
 
+// ANNOUNCE.features bits.
+#define RAWFRAME_FEAT_TX_CSUM    0x1u   // TX_REQ may carry RAWFRAME_TX_*CSUM
+#define RAWFRAME_FEAT_RX_CSUM    0x2u   // RX_NOTIFY carries RAWFRAME_RX_*_OK
+#define RAWFRAME_FEAT_TSO        0x4u   // TX_REQ may carry RAWFRAME_TX_TSO
+#define RAWFRAME_FEAT_RING       0x8u   // handles[2] = rawframe_ring_ctl_t
+
+// RX_NOTIFY flags. Absent bits mean "not checked", never "bad": the client
+// falls back to verifying in software.
+#define RAWFRAME_RX_IP_CSUM_OK   0x1u
+#define RAWFRAME_RX_L4_CSUM_OK   0x2u   // TCP or UDP
+
+// TX_REQ flags. The frame must be Ethernet + IPv4 + TCP/UDP. For L4_CSUM
+// the client leaves the folded pseudo-header sum in the checksum field;
+// for TSO it also zeroes the IPv4 total length and checksum and leaves
+// the pseudo-header sum taken with a zero length.
+#define RAWFRAME_TX_IP_CSUM      0x1u
+#define RAWFRAME_TX_L4_CSUM      0x2u
+#define RAWFRAME_TX_TSO          0x4u
+
+#define RAWFRAME_TSO_MAX_BYTES   65536u
+
 // RX_NOTIFY / TX_REQ / LINK_* share a compact header.
 typedef struct __attribute__((packed)) rawframe_slot_msg {
     uint8_t  op;                 // RX_NOTIFY / TX_REQ / LINK_UP / LINK_DOWN
-    uint8_t  _pad[3];
+    uint8_t  flags;              // RAWFRAME_RX_* / RAWFRAME_TX_* (Phase 26)
+    uint16_t mss;                // TX_REQ with RAWFRAME_TX_TSO; else 0
     uint32_t slot;               // Slot index within the shared ring
     uint32_t length;             // Frame bytes at that slot (0 for LINK_*)
 } rawframe_slot_msg_t;
 
 _Static_assert(sizeof(rawframe_slot_msg_t) == 12,
                "rawframe_slot_msg_t layout drift");
+
+// Phase 26: one queued frame in the ring index VMO. RX entries carry
+// RAWFRAME_RX_* flags, TX entries the RAWFRAME_TX_* request (mss only with
+// RAWFRAME_TX_TSO).
+typedef struct __attribute__((packed)) rawframe_ring_ent {
+    uint32_t slot;               // First slot of the frame
+    uint32_t length;             // Frame bytes
+    uint8_t  flags;
+    uint8_t  _pad;
+    uint16_t mss;
+    uint32_t cookie;             // Producer-private; the consumer ignores it
+} rawframe_ring_ent_t;
+
+_Static_assert(sizeof(rawframe_ring_ent_t) == 16,
+               "rawframe_ring_ent_t layout drift");
+
+// Head of the ring index VMO. Each index sits on its own cache line so
+// the two sides never write the same line. rx_kick is set by the client
+// (then rx_prod re-checked) before it sleeps; the driver exchanges it
+// back to 0 after publishing and sends RX_KICK only if it was set.
+typedef struct rawframe_ring_ctl {
+    volatile uint32_t rx_prod;   // driver
+    uint32_t _pad0[15];
+    volatile uint32_t rx_cons;   // client: frames released
+    volatile uint32_t rx_kick;   // client arms, driver clears
+    uint32_t _pad1[14];
+    volatile uint32_t tx_prod;   // client
+    uint32_t _pad2[15];
+    volatile uint32_t tx_cons;   // driver: entries the NIC is done with
+    uint32_t _pad3[15];
+} rawframe_ring_ctl_t;
+
+_Static_assert(sizeof(rawframe_ring_ctl_t) == 256,
+               "rawframe_ring_ctl_t layout drift");
+
+// The entry arrays start on the second page: rx[slot_count], then
+// tx[slot_count].
+#define RAWFRAME_RING_ENT_OFFSET  4096u
+#define RAWFRAME_RING_BYTES(slots) \
+    (RAWFRAME_RING_ENT_OFFSET + 2u * (uint32_t)(slots) * \
+     (uint32_t)sizeof(rawframe_ring_ent_t))
+
+static inline rawframe_ring_ent_t *rawframe_ring_rx(rawframe_ring_ctl_t *c) {
+    return (rawframe_ring_ent_t *)((uint8_t *)c + RAWFRAME_RING_ENT_OFFSET);
+}
+
+static inline rawframe_ring_ent_t *rawframe_ring_tx(rawframe_ring_ctl_t *c,
+                                                    uint32_t slot_count) {
+    return rawframe_ring_rx(c) + slot_count;
+}
@@ -70,6 +70,8 @@ struct libtls_ctx {
     br_x509_minimal_context   xc;
     br_sslio_context          ioc;
     unsigned char             iobuf[BR_SSL_BUFSIZE_BIDI];
+    char                      key[LIBTLS_SESSION_KEY_LEN];  // "host:port"; cache key
+    uint8_t                   resumed;      // Abbreviated handshake
 };
 
 // ---------------------------------------------------------------------------
@@ -115,6 +117,117 @@ static void collect_entropy(unsigned char seed[64]) {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Phase 29: record-layer crypto engines (see libtls.h).
+//
+// br_ssl_client_init_full installs BearSSL's defaults, which already reach
+// for the x86 engines when the CPU has them; we reinstall explicitly so the
+// choice is ours (CPUID probed once, restrictable via libtls_set_engines)
+// and so the benchmark measures exactly what the record layer runs.  The
+// x86 bodies are compiled with per-function target attributes, so the rest
+// of userspace stays plain -march=x86-64; the kernel saves xmm state per
+// task (FXSAVE in schedule()).
+//
+// CPUID leaf 1 bits, mirroring BearSSL's own br_cpuid() checks:
+//   ECX 25 AES + ECX 19 SSE4.1 -> aes_x86ni_*    ECX 1 PCLMULQDQ -> ghash_pclmul
+//   EDX 26 SSE2               -> chacha20_sse2
+// Poly1305's ctmulq needs no CPUID bit: any x86-64 has the 128-bit mul.
+// ---------------------------------------------------------------------------
+#define CPUID1_ECX_PCLMUL   (1u << 1)
+#define CPUID1_ECX_SSE41    (1u << 19)
+#define CPUID1_ECX_AES      (1u << 25)
+#define CPUID1_EDX_SSE2     (1u << 26)
+
+typedef struct {
+    const br_block_cbcenc_class *cbcenc;
+    const br_block_cbcdec_class *cbcdec;
+    const br_block_ctr_class    *ctr;
+    const br_block_ctrcbc_class *ctrcbc;
+    br_ghash                     ghash;
+    br_chacha20_run              chacha20;
+    br_poly1305_run              poly1305;
+} libtls_engine_set_t;
+
+static int      g_engines_probed = 0;
+static unsigned g_engines_avail  = 0;
+static unsigned g_engines_mask   = LIBTLS_ENGINE_ALL;
+
+static void cpuid_leaf1(uint32_t *ecx, uint32_t *edx) {
+    uint32_t a = 1, b, c = 0, d;
+    __asm__ __volatile__("cpuid" : "+a"(a), "=b"(b), "+c"(c), "=d"(d));
+    (void)b;
+    *ecx = c;
+    *edx = d;
+}
+
+unsigned libtls_engines_available(void) {
+    if (g_engines_probed) return g_engines_avail;
+    uint32_t ecx = 0, edx = 0;
+    cpuid_leaf1(&ecx, &edx);
+    unsigned m = 0;
+    // Each accessor also returns NULL if BearSSL was built without the
+    // intrinsics, so a bit is only set when the engine really exists.
+    if ((ecx & CPUID1_ECX_AES) && (ecx & CPUID1_ECX_SSE41) &&
+        br_aes_x86ni_ctr_get_vtable() && br_aes_x86ni_cbcenc_get_vtable() &&
+        br_aes_x86ni_cbcdec_get_vtable() && br_aes_x86ni_ctrcbc_get_vtable()) {
+        m |= LIBTLS_ENGINE_AESNI;
+    }
+    if ((ecx & CPUID1_ECX_PCLMUL) && br_ghash_pclmul_get()) {
+        m |= LIBTLS_ENGINE_PCLMUL;
+    }
+    if ((edx & CPUID1_EDX_SSE2) && br_chacha20_sse2_get()) {
+        m |= LIBTLS_ENGINE_SSE2;
+    }
+    if (br_poly1305_ctmulq_get()) m |= LIBTLS_ENGINE_MULQ;
+    g_engines_avail  = m;
+    g_engines_probed = 1;
+    return m;
+}
+
+unsigned libtls_set_engines(unsigned mask) {
+    g_engines_mask = mask & LIBTLS_ENGINE_ALL;
+    return libtls_engines();
+}
+
+unsigned libtls_engines(void) {
+    return g_engines_mask & libtls_engines_available();
+}
+
+static void engines_pick(unsigned mask, libtls_engine_set_t *e) {
+    mask &= libtls_engines_available();
+    if (mask & LIBTLS_ENGINE_AESNI) {
+        e->cbcenc = br_aes_x86ni_cbcenc_get_vtable();
+        e->cbcdec = br_aes_x86ni_cbcdec_get_vtable();
+        e->ctr    = br_aes_x86ni_ctr_get_vtable();
+        e->ctrcbc = br_aes_x86ni_ctrcbc_get_vtable();
+    } else {
+        e->cbcenc = &br_aes_ct64_cbcenc_vtable;
+        e->cbcdec = &br_aes_ct64_cbcdec_vtable;
+        e->ctr    = &br_aes_ct64_ctr_vtable;
+        e->ctrcbc = &br_aes_ct64_ctrcbc_vtable;
+    }
+    e->ghash    = (mask & LIBTLS_ENGINE_PCLMUL) ? br_ghash_pclmul_get()
+                                                : &br_ghash_ctmul64;
+    e->chacha20 = (mask & LIBTLS_ENGINE_SSE2) ? br_chacha20_sse2_get()
+                                              : &br_chacha20_ct_run;
+    e->poly1305 = (mask & LIBTLS_ENGINE_MULQ) ? br_poly1305_ctmulq_get()
+                                              : &br_poly1305_ctmul_run;
+}
+
+// Reinstall the symmetric engines after br_ssl_client_init_full.  Only the
+// implementations change; the record handlers (gcm / chapol / cbc / ccm
+// vtables) init_full set stay as they are.
+static void engines_install(br_ssl_engine_context *eng) {
+    libtls_engine_set_t e;
+    engines_pick(libtls_engines(), &e);
+    br_ssl_engine_set_aes_cbc(eng, e.cbcenc, e.cbcdec);
+    br_ssl_engine_set_aes_ctr(eng, e.ctr);
+    br_ssl_engine_set_aes_ctrcbc(eng, e.ctrcbc);
+    br_ssl_engine_set_ghash(eng, e.ghash);
+    br_ssl_engine_set_chacha20(eng, e.chacha20);
+    br_ssl_engine_set_poly1305(eng, e.poly1305);
+}
+
 // ---------------------------------------------------------------------------
 // Transport adapters for br_sslio.  Contract (bearssl_ssl.h):
 //   * return >= 1 on progress (bytes moved),
@@ -172,12 +285,91 @@ int libtls_init(const char *ca_bundle_path) {
     return (int)g_grahaos_TAs_num;
 }
 
+// ---------------------------------------------------------------------------
+// Phase 29: TLS session cache (see libtls.h).
+//
+// One slot per "host:port" origin — the libhttp pool key — filled after
+// every full handshake, so the next connect to that origin offers the
+// session ID and — if the server
+// still has it — skips the key exchange and certificate chain validation
+// (RFC 5246 §7.3 abbreviated handshake).  Slots hold master secrets: a
+// failed handshake or a session that dies on an engine error drops its
+// slot, and flush wipes them.  Oldest slot is evicted when full.
+// ---------------------------------------------------------------------------
+typedef struct {
+    char                      key[LIBTLS_SESSION_KEY_LEN];  // "" = free
+    br_ssl_session_parameters params;
+    uint64_t                  stored_tsc;
+} libtls_session_t;
+
+static libtls_session_t g_sessions[LIBTLS_SESSION_CACHE_SLOTS];
+static uint32_t         g_session_hits;
+static uint32_t         g_session_misses;
+
+static libtls_session_t *session_find(const char *key) {
+    uint64_t life = (uint64_t)LIBTLS_SESSION_LIFETIME_S * spin_tsc_hz();
+    uint64_t now  = spin_rdtsc();
+    for (uint32_t i = 0; i < LIBTLS_SESSION_CACHE_SLOTS; i++) {
+        libtls_session_t *s = &g_sessions[i];
+        if (!s->key[0] || strcmp(s->key, key) != 0) continue;
+        if (now - s->stored_tsc > life) {
+            memset(s, 0, sizeof(*s));
+            return NULL;
+        }
+        return s;
+    }
+    return NULL;
+}
+
+static void session_store(const char *key,
+                          const br_ssl_session_parameters *p) {
+    libtls_session_t *slot = session_find(key);
+    for (uint32_t i = 0; !slot && i < LIBTLS_SESSION_CACHE_SLOTS; i++) {
+        if (!g_sessions[i].key[0]) slot = &g_sessions[i];
+    }
+    if (!slot) {
+        slot = &g_sessions[0];
+        for (uint32_t i = 1; i < LIBTLS_SESSION_CACHE_SLOTS; i++) {
+            if (g_sessions[i].stored_tsc < slot->stored_tsc) slot = &g_sessions[i];
+        }
+    }
+    size_t n = strlen(key);
+    memset(slot, 0, sizeof(*slot));
+    memcpy(slot->key, key, n);
+    slot->params     = *p;
+    slot->stored_tsc = spin_rdtsc();
+}
+
+static void session_forget(const char *key) {
+    libtls_session_t *s = key[0] ? session_find(key) : NULL;
+    if (s) memset(s, 0, sizeof(*s));
+}
+
+void libtls_session_cache_flush(void) {
+    memset(g_sessions, 0, sizeof(g_sessions));
+}
+
+void libtls_session_cache_stats(uint32_t *hits, uint32_t *misses) {
+    if (hits)   *hits   = g_session_hits;
+    if (misses) *misses = g_session_misses;
+}
+
+int libtls_session_resumed(const libtls_ctx_t *ctx) {
+    return ctx ? ctx->resumed : 0;
+}
+
 // ---------------------------------------------------------------------------
 // libtls_connect: drive the TLS handshake over an already-open libnet TCP
 // socket.  Argument order matches libhttp's weak declaration.
 // ---------------------------------------------------------------------------
 int libtls_connect(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
                    const char *hostname, libtls_ctx_t **out_ctx) {
+    return libtls_connect_port(nc, tcp_cookie, hostname, 443, out_ctx);
+}
+
+int libtls_connect_port(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
+                        const char *hostname, uint16_t port,
+                        libtls_ctx_t **out_ctx) {
     if (!nc || !hostname || !out_ctx) return -22 /* -EINVAL */;
     *out_ctx = NULL;
 
@@ -186,11 +378,22 @@ int libtls_connect(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
     memset(ctx, 0, sizeof(*ctx));
     ctx->nc     = nc;
     ctx->cookie = tcp_cookie;
+    // Hostnames too long for SNI are still connected, just never cached.
+    size_t host_len = strlen(hostname);
+    if (host_len <= LIBTLS_MAX_SNI_LEN) {
+        memcpy(ctx->key, hostname, host_len);
+        char digits[5];
+        int nd = 0;
+        do { digits[nd++] = (char)('0' + port % 10u); port /= 10u; } while (port);
+        ctx->key[host_len++] = ':';
+        while (nd) ctx->key[host_len++] = digits[--nd];
+    }
 
     // Full client profile: all implemented suites + RSA/ECDSA verification
     // against the baked-in trust anchors.
     br_ssl_client_init_full(&ctx->sc, &ctx->xc,
                             g_grahaos_TAs, g_grahaos_TAs_num);
+    engines_install(&ctx->sc.eng);
 
     // Seed the engine's DRBG with our userspace entropy mix BEFORE reset so
     // BR_ERR_NO_RANDOM can never fire during the handshake.
@@ -203,8 +406,18 @@ int libtls_connect(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
     // Bidirectional record buffer lives inside the ctx (one allocation).
     br_ssl_engine_set_buffer(&ctx->sc.eng, ctx->iobuf, sizeof ctx->iobuf, 1);
 
+    // Offer the cached session, if any; the server decides whether to
+    // resume it.
+    libtls_session_t *cached = ctx->key[0] ? session_find(ctx->key) : NULL;
+    br_ssl_session_parameters offered;
+    memset(&offered, 0, sizeof(offered));
+    if (cached) {
+        offered = cached->params;
+        br_ssl_engine_set_session_parameters(&ctx->sc.eng, &offered);
+    }
+
     // SNI + handshake reset.
-    if (br_ssl_client_reset(&ctx->sc, hostname, 0) != 1) {
+    if (br_ssl_client_reset(&ctx->sc, hostname, cached != NULL) != 1) {
         ctx->last_err = br_ssl_engine_last_error(&ctx->sc.eng);
         free(ctx);
         return -71 /* -EPROTO */;
@@ -219,6 +432,7 @@ int libtls_connect(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
     if (br_sslio_flush(&ctx->ioc) != 0) {
         int err = br_ssl_engine_last_error(&ctx->sc.eng);
         ctx->last_err = err;
+        session_forget(ctx->key);
         free(ctx);
         // Distinguish certificate-validation failures (X.509 error range
         // 32..62) from generic handshake/transport failures so callers can
@@ -233,10 +447,30 @@ int libtls_connect(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
     int err = br_ssl_engine_last_error(&ctx->sc.eng);
     if (err != BR_ERR_OK) {
         ctx->last_err = err;
+        session_forget(ctx->key);
         free(ctx);
         return -71;
     }
 
+    // Resumed iff the server echoed the session ID we offered.  A full
+    // handshake refreshes the slot; a server that issues no session ID
+    // (ticket-only) leaves nothing worth keeping.
+    br_ssl_session_parameters now;
+    br_ssl_engine_get_session_parameters(&ctx->sc.eng, &now);
+    ctx->resumed = cached && now.session_id_len != 0 &&
+                   now.session_id_len == offered.session_id_len &&
+                   memcmp(now.session_id, offered.session_id,
+                          now.session_id_len) == 0;
+    if (ctx->resumed) {
+        g_session_hits++;
+    } else if (ctx->key[0]) {
+        g_session_misses++;
+        if (now.session_id_len) session_store(ctx->key, &now);
+        else                    session_forget(ctx->key);
+    }
+    memset(&offered, 0, sizeof(offered));
+    memset(&now, 0, sizeof(now));
+
     *out_ctx = ctx;
     return 0;
 }
@@ -248,12 +482,12 @@ int libtls_send(libtls_ctx_t *ctx, const void *buf, size_t len) {
     if (!ctx || !buf) return -22;
     if (len == 0) return 0;
     int rc = br_sslio_write_all(&ctx->ioc, buf, len);
-    if (rc < 0) {
-        ctx->last_err = br_ssl_engine_last_error(&ctx->sc.eng);
-        return -71;
-    }
-    if (br_sslio_flush(&ctx->ioc) != 0) {
+    if (rc < 0 || br_sslio_flush(&ctx->ioc) != 0) {
         ctx->last_err = br_ssl_engine_last_error(&ctx->sc.eng);
+        // A dropped transport (BR_ERR_IO) says nothing about the session.
+        if (ctx->last_err != BR_ERR_OK && ctx->last_err != BR_ERR_IO) {
+            session_forget(ctx->key);
+        }
         return -71;
     }
     return (int)len;
@@ -270,6 +504,7 @@ int libtls_recv(libtls_ctx_t *ctx, void *buf, size_t len,
         ctx->last_err = err;
         // Clean close_notify (engine error OK) reads back as EOF, not error.
         if (err == BR_ERR_OK) return 0;
+        if (err != BR_ERR_IO) session_forget(ctx->key);
         return -71;
     }
     return rc;  // >= 1 bytes (br_sslio_read never returns 0 for len > 0)
@@ -300,3 +535,48 @@ int libtls_read(libtls_ctx_t *ctx, uint8_t *buf, uint32_t cap,
                 uint32_t timeout_ms) {
     return libtls_recv(ctx, buf, cap, timeout_ms);
 }
+
+// ---------------------------------------------------------------------------
+// libtls_bench_aead: one AEAD seal over caller memory on a chosen engine
+// set (see libtls.h).  Same calls the gcm / chapol record handlers make,
+// minus the record framing.
+// ---------------------------------------------------------------------------
+int libtls_bench_aead(int aead, unsigned mask, void *buf, size_t len,
+                      uint8_t tag[16], uint64_t *tsc_out) {
+    if ((!buf && len) || !tag) return -22;
+    unsigned char key[32], iv[12], aad[13];
+    for (size_t i = 0; i < sizeof key; i++) key[i] = (unsigned char)(0x40u + i);
+    for (size_t i = 0; i < sizeof iv; i++)  iv[i]  = (unsigned char)(0xA0u + i);
+    // Sequence number 0, type 23 (application_data), TLS 1.2, length.
+    memset(aad, 0, sizeof aad);
+    aad[8]  = 23;
+    aad[9]  = 3;
+    aad[10] = 3;
+    aad[11] = (unsigned char)(len >> 8);
+    aad[12] = (unsigned char)len;
+
+    libtls_engine_set_t e;
+    engines_pick(mask, &e);
+    uint64_t t0 = spin_rdtsc();
+    switch (aead) {
+    case LIBTLS_AEAD_AES128_GCM: {
+        br_aes_gen_ctr_keys ks;
+        br_gcm_context gc;
+        e.ctr->init(&ks.vtable, key, 16);
+        br_gcm_init(&gc, &ks.vtable, e.ghash);
+        br_gcm_reset(&gc, iv, sizeof iv);
+        br_gcm_aad_inject(&gc, aad, sizeof aad);
+        br_gcm_flip(&gc);
+        br_gcm_run(&gc, 1, buf, len);
+        br_gcm_get_tag(&gc, tag);
+        break;
+    }
+    case LIBTLS_AEAD_CHACHA20_POLY1305:
+        e.poly1305(key, iv, buf, len, aad, sizeof aad, tag, e.chacha20, 1);
+        break;
+    default:
+        return -22;
+    }
+    if (tsc_out) *tsc_out = spin_rdtsc() - t0;
+    return 0;
+}
@@ -83,6 +83,13 @@ int      libtls_init(const char *ca_bundle_path);
 int      libtls_connect(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
                         const char *hostname, libtls_ctx_t **out_ctx);
 
+// libtls_connect_port — libtls_connect for a server on `port`, which
+// keys the session cache (libtls_connect assumes 443).  libhttp prefers
+// it through a weak reference when the archive provides it.
+int      libtls_connect_port(libnet_client_ctx_t *nc, uint32_t tcp_cookie,
+                             const char *hostname, uint16_t port,
+                             libtls_ctx_t **out_ctx);
+
 int      libtls_send(libtls_ctx_t *ctx, const void *buf, size_t len);
 
 int      libtls_recv(libtls_ctx_t *ctx, void *buf, size_t len,
@@ -112,3 +119,64 @@ int      libtls_read(libtls_ctx_t *ctx, uint8_t *buf, uint32_t cap,
 // linked), 0 otherwise.  Tests use this to skip cleanly when libtls is
 // stubbed.
 int      libtls_backend_available(void);
+
+// ---------------------------------------------------------------------------
+// Phase 29: record-layer crypto engines.
+//
+// Every session starts on BearSSL's constant-time software implementations
+// (aes_ct64, ghash_ctmul64, chacha20_ct, poly1305_ctmul) and swaps in the
+// x86 ones below where the CPU has the instructions (probed once with
+// CPUID).  The software and hardware engines produce identical records;
+// only speed differs.
+//
+// libtls_engines_available() — the LIBTLS_ENGINE_* bits this CPU supports.
+// libtls_set_engines() — restrict later libtls_connect calls to `mask`
+// (e.g. 0 to benchmark the software path).  Returns the effective mask,
+// `mask & libtls_engines_available()`.  Sessions already open keep theirs.
+// libtls_engines() — the mask libtls_connect currently applies.
+//
+// libtls_bench_aead() — seal `len` bytes of `buf` in place with one AEAD
+// (fixed key / nonce / 13-byte record AAD) on the engines in `mask`, the
+// way the record layer would, and write the 16-byte tag.  *tsc_out (if
+// non-NULL) receives the rdtsc cycles spent.  Returns 0, or -22 (-EINVAL)
+// for an unknown aead.  Used by httptest's throughput benchmark and the
+// libtls TAP test's software-vs-hardware cross-check.
+// ---------------------------------------------------------------------------
+#define LIBTLS_ENGINE_AESNI     (1u << 0)   // AES-NI: AES-CTR / CBC / CCM
+#define LIBTLS_ENGINE_PCLMUL    (1u << 1)   // PCLMULQDQ: GHASH for AES-GCM
+#define LIBTLS_ENGINE_SSE2      (1u << 2)   // SSE2: ChaCha20
+#define LIBTLS_ENGINE_MULQ      (1u << 3)   // 64x64->128 mul: Poly1305
+#define LIBTLS_ENGINE_ALL       0x0Fu
+
+#define LIBTLS_AEAD_AES128_GCM          1
+#define LIBTLS_AEAD_CHACHA20_POLY1305   2
+
+unsigned libtls_engines_available(void);
+unsigned libtls_set_engines(unsigned mask);
+unsigned libtls_engines(void);
+int      libtls_bench_aead(int aead, unsigned mask, void *buf, size_t len,
+                           uint8_t tag[16], uint64_t *tsc_out);
+
+// ---------------------------------------------------------------------------
+// Phase 29: TLS session resumption.
+//
+// libtls_connect keeps the session of every full handshake in a small
+// per-process cache keyed by "host:port" (libhttp's pool key: two servers
+// behind one name never see each other's session IDs) and offers it on
+// the next connect to that origin.  When the server accepts, the abbreviated
+// handshake skips the key exchange and certificate chain validation.
+// Session IDs only: BearSSL has no client support for session tickets
+// (RFC 5077).  Entries expire after LIBTLS_SESSION_LIFETIME_S, and are
+// dropped when a handshake or a session using them fails.
+//
+// libtls_session_resumed() — 1 if `ctx` came from an abbreviated handshake.
+// libtls_session_cache_flush() — forget (and wipe) every cached session.
+// libtls_session_cache_stats() — resumed / full handshakes so far.
+// ---------------------------------------------------------------------------
+#define LIBTLS_SESSION_CACHE_SLOTS  8u
+#define LIBTLS_SESSION_LIFETIME_S   3600u
+#define LIBTLS_SESSION_KEY_LEN      (LIBTLS_MAX_SNI_LEN + 7u)  // ":65535" + NUL
+
+int      libtls_session_resumed(const libtls_ctx_t *ctx);
+void     libtls_session_cache_flush(void);
+void     libtls_session_cache_stats(uint32_t *hits, uint32_t *misses);
@@ -14,6 +14,11 @@
 //      send rawframe_slot_msg_t{op=TX_REQ, slot, len} on wr_req. e1000d
 //      reads from the shared tx ring and DMAs out.
 //
+//      Phase 26: when ANNOUNCE offers RAWFRAME_FEAT_RING, both directions
+//      go through the shared index block instead: RX frames are parsed in
+//      place and released in batches after one RX_KICK, TX frames are
+//      queued by advancing tx_prod with no message at all.
+//
 //   3. DHCP: on link-up (from rawframe ANNOUNCE.link_up), send DISCOVER;
 //      on OFFER, send REQUEST; on ACK, populate state.ip/gw/dns/netmask +
 //      flip stack_running=1.
@@ -27,6 +32,10 @@
 //      (UDP to learned resolver), records (xid, client_idx, seq, deadline).
 //      On matching UDP reply, parse and respond to the client.
 //
+//   6. Phase 26 shards: on a multi-core machine this process (the front)
+//      spawns `netd --shard` workers and splits TCP flows between them by
+//      4-tuple; see "Shards" below.
+//
 // Design principle: every protocol helper is pure (in libnetd.a). Stateful
 // logic lives in this file.
 
@@ -40,6 +49,7 @@
 #include "libnet/libnet_msg.h"
 #include "libnet/rawframe.h"
 #include "netd.h"
+#include "../kernel/state.h"
 
 extern int printf(const char *fmt, ...);
 
@@ -68,6 +78,25 @@ static uint32_t netd_rand32(void) {
     return (uint32_t)s_rng_state;
 }
 
+// Phase 26: 64 bits of key material (the SYN-cookie key). RDRAND when the
+// CPU has it — encoded directly so we don't need -mrdrnd — else the
+// xorshift stream stirred with fresh rdtsc (weak, but never constant).
+static uint64_t netd_key64(void) {
+    for (int tries = 0; tries < 10; tries++) {
+        unsigned char ok = 0;
+        uint64_t v = 0;
+        __asm__ __volatile__(
+            ".byte 0x48, 0x0f, 0xc7, 0xf0\n\t"  // rdrand %rax
+            "setc %1\n\t"
+            : "=a"(v), "=qm"(ok)
+            :
+            : "cc");
+        if (ok) return v;
+    }
+    uint64_t hi = netd_rand32() ^ (netd_rdtsc() * 0x100000001B3ull);
+    return (hi << 32) ^ netd_rand32() ^ netd_rdtsc();
+}
+
 // =====================================================================
 // Daemon-wide state.
 // =====================================================================
@@ -84,7 +113,15 @@ typedef struct netd_state {
     uint32_t slot_count;
     uint32_t slot_size;
     uint32_t tx_cursor;         // Next tx slot to use (round-robin)
-    uint32_t _pad2;
+    uint32_t nic_features;      // RAWFRAME_FEAT_* from ANNOUNCE (Phase 26)
+
+    // Phase 26 ring hand-off; ring == NULL means per-frame messages. The
+    // counters are free-running like the ones in the shared block.
+    rawframe_ring_ctl_t *ring;
+    uint32_t rx_cons;           // Next rx entry to parse
+    uint32_t tx_prod;           // Next tx entry to fill
+    uint32_t tx_base;           // tx_prod when the ring was handed to us
+    uint32_t tx_slot_head;      // tx slots handed out, incl. skipped ones
 
     // Rawframe peer — only one peer today (the single NIC), so we hold a
     // single pair of handles.
@@ -125,7 +162,8 @@ static netd_state_t g_net;
 
 typedef struct netd_client {
     uint8_t        in_use;
-    uint8_t        _pad[3];
+    uint8_t        standin;     // Worker: a front client's slot, no channels
+    uint8_t        _pad[2];
     int32_t        connector_pid;
     uint32_t       connection_id;
     cap_token_u_t  rd_req;
@@ -185,12 +223,29 @@ static pending_icmp_t g_icmps[NETD_MAX_PENDING_ICMP];
 // via libnet_tcp_recv. A single client owns one TCP socket at a time
 // — the `client_idx` field on the conn tracks ownership.
 //
-// NETD_TCP_RX_RING_BYTES trades memory for smoother HTTP response
-// streaming. 2 KiB per socket × 16 sockets = 32 KiB BSS; adequate for
-// MVP HTTP responses (small JSON bodies, chunked transfers drained
-// by libhttp within a few ticks).
+// Phase 26: both directions are heap rings indexed by sequence number, so
+// the bytes of a segment always live at the same offset whatever order
+// they arrive or are resent in:
+//   rx — [rx_tail, rx_head) waits for the reader; rx_head is rcv_nxt, and
+//        out-of-order bytes sit past it until the hole fills. The free
+//        space is the advertised window.
+//   tx — [snd_una, tx_end) is kept until ACKed, so any of it can be
+//        retransmitted; netd_tcp_next_segment picks what goes out.
+// Each starts at 16 KiB and doubles up to 1 MiB: rx when the peer fills
+// the window while the reader keeps up (receive autotuning), tx when a
+// send would not fit. Idle sockets stay small; a bulk flow grows to the
+// bandwidth-delay product.
+//
+// A client may instead attach the socket (TCP_SHM_ATTACH): both rings then
+// live in one VMO it maps too, at a fixed size, and the client moves rx_tail
+// and tx_end itself through the ctl page (see libnet_msg.h). netd picks
+// those up in tcp_shm_pull and publishes its own side in tcp_shm_push.
 // =====================================================================
-#define NETD_TCP_RX_RING_BYTES   2048u
+#define NETD_TCP_RCVBUF_INIT     (16u * 1024u)
+#define NETD_TCP_RCVBUF_MAX      (1024u * 1024u)
+#define NETD_TCP_SNDBUF_INIT     (16u * 1024u)
+#define NETD_TCP_SNDBUF_MAX      (1024u * 1024u)
+#define NETD_TCP_SEG_MAX         (64u * 1024u)   // Bytes per output step
 #define NETD_TCP_EPHEMERAL_MIN   32768u
 #define NETD_TCP_EPHEMERAL_SPAN  32768u
 
@@ -198,12 +253,22 @@ typedef struct netd_tcp_conn {
     uint8_t  in_use;
     uint8_t  peer_fin;         // Peer has sent FIN; no more bytes coming
     uint8_t  close_sent;       // We called netd_tcp_close (sent our FIN)
-    uint8_t  _pad;
+    uint8_t  fin_pending;      // Close requested; FIN follows the queued bytes
+    uint8_t  queued;           // Child is in its listener's accept queue
+    uint8_t  tx_stall;         // Last output hit an ARP miss / full ring
+    uint16_t listener;         // LISTEN socket: g_tcp_listeners slot + 1
+    uint16_t parent;           // Passive child: listener slot + 1 until accepted
     uint32_t client_idx;       // Owner slot in g_clients (0xFFFFFFFFu = none)
     uint32_t cookie;           // What the client sees (stable)
-    uint16_t rx_head;
-    uint16_t rx_tail;
-    uint8_t  rx_buf[NETD_TCP_RX_RING_BYTES];
+    uint32_t rx_cap;           // Power of two
+    uint32_t rx_head;          // Free-running; index = x & (rx_cap - 1)
+    uint32_t rx_tail;
+    uint32_t tx_cap;           // Power of two
+    uint32_t tx_end;           // Sequence number after the last queued byte
+    uint8_t *rx_buf;
+    uint8_t *tx_buf;
+    libnet_tcp_shm_ctl_t *shm;  // Attached: rings live in this mapping
+    uint32_t shm_bytes;
 } netd_tcp_conn_t;
 
 static netd_tcp_conn_t g_tcp_conn[TCP_MAX_SOCKETS];
@@ -243,9 +308,179 @@ typedef struct pending_tcp_recv {
 
 static pending_tcp_recv_t g_tcp_recvs[NETD_MAX_PENDING_TCP_RECV];
 
+// =====================================================================
+// Phase 26: passive opens. Each LISTEN socket owns a listener slot with
+// the two BSD queues:
+//   SYN queue    — just a count: the half-open children are ordinary
+//                  sockets in SYN_RCVD, tagged with conn->parent. Past
+//                  syn_backlog, SYNs get a SYN cookie and no state.
+//   accept queue — a ring of children that reached ESTABLISHED, drained
+//                  by TCP_ACCEPT. While it holds `backlog` entries, SYNs
+//                  and completing ACKs are dropped so the peer retries.
+// Entries carry the child's cookie: one reset while queued (and its slot
+// reused) is recognised as stale and skipped when popped.
+// =====================================================================
+#define NETD_MAX_TCP_LISTENERS       16u
+#define NETD_MAX_PENDING_TCP_ACCEPT  64u
+#define NETD_TCP_COOKIE_PERIOD_S     64u      // SYN cookie time-counter step
+#define NETD_TCP_SYNACK_GIVEUP_MS    16000u   // Last SYN-ACK retry's RTO
+
+typedef struct netd_tcp_aq_ent {
+    uint32_t  socket_idx;       // NETD_TCP_AQ_REMOTE: a worker's child
+    uint32_t  cookie;
+    uint32_t  remote_ip;        // Remote entries only: what ACCEPT reports
+    uint16_t  remote_port;
+    uint16_t  local_port;
+} netd_tcp_aq_ent_t;
+
+#define NETD_TCP_AQ_REMOTE  0xFFFFFFFFu
+
+typedef struct netd_tcp_listener {
+    uint8_t   in_use;
+    uint8_t   cookies;          // SYN cookies once the SYN queue is full
+    uint16_t  backlog;          // Accept-queue limit
+    uint16_t  syn_backlog;      // Half-open limit
+    uint16_t  syn_count;        // Children not yet in the accept queue
+    uint32_t  socket_idx;       // The LISTEN socket
+    uint32_t  aq_cap;           // Power of two >= backlog
+    uint32_t  aq_head;          // Free-running; index = x & (aq_cap - 1)
+    uint32_t  aq_tail;
+    uint32_t  aq_remote;        // Phase 26: entries reported by workers
+    netd_tcp_aq_ent_t *aq;
+} netd_tcp_listener_t;
+
+static netd_tcp_listener_t g_tcp_listeners[NETD_MAX_TCP_LISTENERS];
+
+// Pending accepts: client fired TCP_ACCEPT_REQ with an empty accept queue
+// and asked netd to block. Satisfied as children reach ESTABLISHED.
+typedef struct pending_tcp_accept {
+    uint8_t   in_use;
+    uint8_t   _pad;
+    uint16_t  max_conns;
+    uint32_t  client_idx;
+    uint32_t  listener;         // Slot in g_tcp_listeners
+    uint32_t  req_seq;
+    uint64_t  deadline_tsc;
+} pending_tcp_accept_t;
+
+static pending_tcp_accept_t g_tcp_accepts[NETD_MAX_PENDING_TCP_ACCEPT];
+
 // Monotonically-increasing cookie allocator. 0 is reserved ("no cookie").
 static uint32_t g_tcp_cookie_seed = 0x1000u;
 
+// Phase 26: per-socket deadlines (see tcp_timer_arm). A 1 ms tick puts one
+// revolution at 256 ms; longer timers ride it for a few laps.
+#define NETD_TCP_WHEEL_TICK_TSC  (NETD_TICKS_PER_SEC / 1000u)
+#define NETD_TCP_SHM_POLL_MS     25u
+
+static netd_twheel_t g_tcp_wheel;
+
+// =====================================================================
+// Phase 26: shards. With more than one CPU the front (this process, shard
+// 0) spawns `netd --shard` workers, one per further CPU up to
+// NETD_MAX_SHARDS, and splits TCP between them:
+//   - the front keeps the NIC, ARP, ICMP, UDP, DHCP, DNS and every client
+//     channel; it steers each TCP segment to the shard that owns its
+//     4-tuple (rx_ipv4) and each socket op to the shard its cookie names
+//     (shard_route);
+//   - a worker runs the same TCP code over its own tables. Its segments
+//     arrive in one frame ring, its frames leave through another with the
+//     destination MAC blank (the front resolves the next hop on the way to
+//     the NIC), and its client responses ride back over the link channel;
+//   - a listener exists on every shard under one cookie, each instance
+//     taking the SYNs steered to it. Workers report the children they
+//     queue (SHARD_OP_CHILD) and the front's TCP_ACCEPT hands them out.
+// Both rings live in one VMO the front creates per worker.
+// =====================================================================
+#define NETD_SHARD_RING_RX    (256u * 1024u)    // Front -> worker segments
+#define NETD_SHARD_RING_TX    (1024u * 1024u)   // Worker -> front frames
+#define NETD_SHARD_CTL_BYTES  4096u
+#define NETD_SHARD_VMO_BYTES  (NETD_SHARD_CTL_BYTES + NETD_SHARD_RING_RX + \
+                               NETD_SHARD_RING_TX)
+#define NETD_SHARD_HELLO_MS   2000u
+
+#define NETD_SHARD_OP_HELLO     1u  // F->W: id, config; ring VMO in handles[0]
+#define NETD_SHARD_OP_CONFIG    2u  // F->W: addresses or link changed
+#define NETD_SHARD_OP_KICK      3u  // Either way: the ring you consume moved
+#define NETD_SHARD_OP_CLIENT    4u  // F->W: a client's request; W->F: a response
+#define NETD_SHARD_OP_LISTEN    5u  // F->W: open a listener instance (arg = cookie)
+#define NETD_SHARD_OP_UNLISTEN  6u  // F->W: close it (arg = cookie)
+#define NETD_SHARD_OP_CHILD     7u  // W->F: child queued (arg = listen cookie)
+#define NETD_SHARD_OP_ADOPT     8u  // F->W: ACCEPT handed it out (arg = child cookie)
+#define NETD_SHARD_OP_RELEASE   9u  // F->W: the client slot closed; drop its stand-in
+
+// Link messages the channel had no room for, oldest first. Link sends
+// never block — a busy peer must not stall this side's loop, nor this side
+// the peer's — so they wait here and shard_flush_links retries them each
+// iteration. Past NETD_SHARD_BACKLOG a send fails, and is counted.
+#define NETD_SHARD_BACKLOG      64u
+
+// Envelope of every message on a link channel; the body follows.
+typedef struct __attribute__((packed)) netd_shard_hdr {
+    uint16_t op;                // NETD_SHARD_OP_*
+    uint16_t client_idx;        // g_clients slot the message is about
+    uint32_t arg;
+} netd_shard_hdr_t;
+
+typedef struct __attribute__((packed)) netd_shard_config {
+    uint8_t  mac[6];
+    uint8_t  link_up;
+    uint8_t  stack_running;
+    uint32_t ip;
+    uint32_t netmask;
+    uint32_t gateway;
+    uint32_t dns_resolver;
+    uint32_t nic_features;
+    uint32_t slot_count;
+    uint32_t slot_size;
+} netd_shard_config_t;
+
+typedef struct __attribute__((packed)) netd_shard_hello {
+    uint32_t id;
+    uint32_t count;
+    uint32_t steer_seed;
+    netd_shard_config_t cfg;
+} netd_shard_hello_t;
+
+typedef struct __attribute__((packed)) netd_shard_listen {
+    uint32_t local_ip;
+    uint16_t local_port;
+    uint16_t backlog;
+    uint16_t syn_backlog;
+    uint8_t  cookies;
+    uint8_t  _pad;
+} netd_shard_listen_t;
+
+_Static_assert(sizeof(netd_shard_hdr_t) + sizeof(libnet_tcp_send_req_t) <= CHAN_MSG_INLINE_MAX &&
+               sizeof(netd_shard_hdr_t) + sizeof(libnet_tcp_recv_resp_t) <= CHAN_MSG_INLINE_MAX,
+               "client messages must fit a shard envelope");
+
+// One front <-> worker link. `out` is the ring this side produces into,
+// `in` the one it drains: on the front link[k].out carries worker k's
+// segments and link[k].in its frames; a worker's only link is link[0].
+typedef struct netd_shard_link {
+    uint8_t       up;
+    uint8_t       _pad[3];
+    int32_t       pid;
+    cap_token_u_t rd;
+    cap_token_u_t wr;
+    netd_fring_t  out;
+    netd_fring_t  in;
+    uint32_t      q_head;       // Backlog in g_shard_q[link]
+    uint32_t      q_tail;
+    uint32_t      drops;        // Sends refused with the backlog full
+} netd_shard_link_t;
+
+static struct {
+    uint32_t id;                // 0 = the front
+    uint32_t count;             // Shards in service, the front included
+    uint32_t steer_seed;
+    uint32_t next_open;         // Round-robin for TCP_OPEN
+    netd_shard_link_t link[NETD_MAX_SHARDS];
+} g_shard = { .count = 1 };
+
+static chan_msg_user_t g_shard_q[NETD_MAX_SHARDS][NETD_SHARD_BACKLOG];
+
 // ---------------------------------------------------------------------
 // Forward declarations. (Keeps the file readable top-down.)
 // ---------------------------------------------------------------------
@@ -253,10 +488,11 @@ static int  tx_raw_frame(const uint8_t *frame, size_t len);
 static int  tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
                              const uint8_t *payload, size_t payload_len);
 
-static void rx_dispatch_frame(const uint8_t *frame, size_t len);
+static void rx_dispatch_frame(const uint8_t *frame, size_t len,
+                              uint8_t nic_csum);
 static void rx_arp(const uint8_t *arp_pdu, size_t len,
                    const uint8_t src_mac[6]);
-static void rx_ipv4(const uint8_t *ipv4_pdu, size_t len);
+static void rx_ipv4(const uint8_t *ipv4_pdu, size_t len, uint8_t nic_csum);
 static void rx_icmp(const ipv4_parsed_t *ip);
 static void rx_udp(const ipv4_parsed_t *ip);
 static void rx_tcp(const ipv4_parsed_t *ip);
@@ -264,11 +500,17 @@ static void rx_tcp(const ipv4_parsed_t *ip);
 static void tcp_tick(uint64_t now_tsc);
 static void tcp_on_socket_state_change(int socket_idx);
 static void tcp_satisfy_pending_recv(int socket_idx);
-static uint16_t tcp_ring_bytes(const netd_tcp_conn_t *c);
-static uint16_t tcp_ring_push(netd_tcp_conn_t *c,
-                              const uint8_t *src, size_t len);
-static uint16_t tcp_ring_pop(netd_tcp_conn_t *c,
+static uint32_t tcp_ring_bytes(const netd_tcp_conn_t *c);
+static uint32_t tcp_ring_pop(netd_tcp_conn_t *c,
                              uint8_t *dst, size_t cap);
+static void tcp_output(int socket_idx, uint64_t now_tsc);
+static void tcp_window_update(int socket_idx);
+static void tcp_conn_release(int socket_idx);
+static void tcp_rx_listen(const ipv4_parsed_t *ip, const tcp_parsed_t *pkt);
+static int  tcp_aq_full(const netd_tcp_listener_t *l);
+static void tcp_child_ready(int socket_idx);
+static void tcp_shm_pull(int socket_idx);
+static void tcp_shm_sync(int socket_idx, uint64_t now_tsc);
 
 static void dhcp_kickoff(void);
 static void dhcp_on_udp(uint16_t src_port, uint16_t dst_port,
@@ -278,6 +520,28 @@ static void dns_on_udp(uint16_t src_port, uint16_t dst_port,
 
 static int  find_free_client_slot(void);
 static void client_release(netd_client_t *c);
+static long client_send(netd_client_t *c, chan_msg_user_t *m, uint64_t timeout_ns);
+
+static long shard_send(netd_shard_link_t *lk, uint16_t op, uint32_t client_idx,
+                       uint32_t arg, const void *body, size_t len,
+                       cap_token_raw_t handle);
+static void shard_kick(netd_shard_link_t *lk);
+static int  shard_flush_links(void);
+static void shard_steer_rx(uint32_t shard, const uint8_t *ipv4_pdu, size_t len,
+                           uint8_t nic_csum);
+static void shard_push_config(void);
+static uint32_t shard_route(uint16_t op, const chan_msg_user_t *m);
+static void shard_forward(uint32_t shard, netd_client_t *c,
+                          const chan_msg_user_t *m, uint16_t op, uint32_t seq);
+static void tcp_timer_arm(int socket_idx, uint64_t now_tsc);
+
+// Phase 26: wait-set covering rawframe rd_resp, the service accept channel
+// and every client's rd_req. 0 = unavailable; the loop falls back to a
+// timed chan_recv on rawframe.
+#define NETD_WS_RAWFRAME  0x100u
+#define NETD_WS_ACCEPT    0x101u
+#define NETD_WS_SHARD     0x200u      // + shard id
+static uint64_t g_ws = 0;
 static void clients_dispatch_tick(void);
 static int  client_handle_message(netd_client_t *c, const chan_msg_user_t *m);
 static void client_send_error(netd_client_t *c, uint16_t resp_op,
@@ -285,24 +549,77 @@ static void client_send_error(netd_client_t *c, uint16_t resp_op,
 
 static void dns_tick(uint64_t now_tsc);
 static void icmp_tick(uint64_t now_tsc);
+static void arp_tick(uint64_t now_tsc);
 
 // =====================================================================
 // TX path.
 // =====================================================================
-static uint32_t tx_alloc_slot(void) {
-    uint32_t slot = g_net.tx_cursor;
-    g_net.tx_cursor = (g_net.tx_cursor + 1u) % g_net.slot_count;
-    return slot;
+// Phase 26 ring mode: the driver retires tx entries in order, and each
+// entry's cookie records tx_slot_head just after its slots were handed
+// out, so everything allocated past the newest retired entry's cookie is
+// still owned by the NIC. Room for `nslots` more, and for one more entry?
+static int tx_ring_room(uint32_t nslots) {
+    uint32_t cons = __atomic_load_n(&g_net.ring->tx_cons, __ATOMIC_ACQUIRE);
+    if (g_net.tx_prod - cons >= g_net.slot_count) return 0;
+    uint32_t busy = g_net.tx_slot_head;
+    if ((int32_t)(cons - g_net.tx_base) > 0) {
+        const rawframe_ring_ent_t *e =
+            &rawframe_ring_tx(g_net.ring, g_net.slot_count)
+                [(cons - 1u) % g_net.slot_count];
+        busy -= e->cookie;
+    }
+    return busy + nslots <= g_net.slot_count;
 }
 
-static int tx_raw_frame(const uint8_t *frame, size_t len) {
-    if (len == 0 || len > g_net.slot_size) return -5;
-    if (!g_net.rawframe_wr_req.raw || !g_net.tx_ring_va) return -32 /* -ESHUTDOWN */;
+// The driver retires tx entries on its own loop passes, so a full ring
+// gets a short spin before the frame is dropped (TCP retransmits).
+#define NETD_TX_RING_SPIN  100000
+
+// `n` consecutive slots starting at *slot_out. Phase 26: a TSO
+// super-segment may need several. The driver walks a multi-slot frame by
+// slot index and never wraps, so skip to slot 0 when the run would not
+// fit before the end of the ring. Returns 0 or -EAGAIN (ring mode only).
+static int tx_alloc_slots(uint32_t n, uint32_t *slot_out) {
+    uint32_t skip = (g_net.tx_cursor + n > g_net.slot_count)
+                        ? g_net.slot_count - g_net.tx_cursor : 0;
+    if (g_net.ring) {
+        int spin = 0;
+        while (!tx_ring_room(skip + n)) {
+            if (spin++ >= NETD_TX_RING_SPIN) return -11 /* -EAGAIN */;
+            __asm__ __volatile__("pause");
+        }
+        g_net.tx_slot_head += skip + n;
+    }
+    if (skip) g_net.tx_cursor = 0;
+    *slot_out = g_net.tx_cursor;
+    g_net.tx_cursor = (g_net.tx_cursor + n) % g_net.slot_count;
+    return 0;
+}
+
+static inline uint8_t *tx_slot_va(uint32_t slot) {
+    return (uint8_t *)(uintptr_t)(g_net.tx_ring_va +
+                                  (uint64_t)slot * g_net.slot_size);
+}
 
-    uint32_t slot = tx_alloc_slot();
-    uint8_t *dst = (uint8_t *)(uintptr_t)(g_net.tx_ring_va +
-                                         (uint64_t)slot * g_net.slot_size);
-    memcpy(dst, frame, len);
+// Hand a frame already sitting in the tx ring at `slot` to the driver.
+// `flags`/`mss` are the RAWFRAME_TX_* offload request (0 = plain frame).
+// Phase 26: in ring mode this is just a tx entry and a tx_prod store.
+static int tx_post_slot(uint32_t slot, size_t len, uint8_t flags, uint16_t mss) {
+    if (g_net.ring) {
+        rawframe_ring_ent_t *e = &rawframe_ring_tx(g_net.ring, g_net.slot_count)
+                                     [g_net.tx_prod % g_net.slot_count];
+        e->slot   = slot;
+        e->length = (uint32_t)len;
+        e->flags  = flags;
+        e->_pad   = 0;
+        e->mss    = mss;
+        e->cookie = g_net.tx_slot_head;
+        g_net.tx_prod++;
+        __atomic_store_n(&g_net.ring->tx_prod, g_net.tx_prod, __ATOMIC_RELEASE);
+        g_net.tx_packets++;
+        g_net.tx_bytes += len;
+        return 0;
+    }
 
     chan_msg_user_t m;
     memset(&m, 0, sizeof(m));
@@ -317,7 +634,8 @@ static int tx_raw_frame(const uint8_t *frame, size_t len) {
 
     rawframe_slot_msg_t *rm = (rawframe_slot_msg_t *)m.inline_payload;
     rm->op     = RAWFRAME_OP_TX_REQ;
-    rm->_pad[0] = rm->_pad[1] = rm->_pad[2] = 0;
+    rm->flags  = flags;
+    rm->mss    = mss;
     rm->slot   = slot;
     rm->length = (uint32_t)len;
 
@@ -330,12 +648,55 @@ static int tx_raw_frame(const uint8_t *frame, size_t len) {
     return 0;
 }
 
-static int tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
-                            const uint8_t *payload, size_t payload_len) {
-    if (payload_len > ETH_MAX_PAYLOAD - IPV4_HDR_LEN_MIN) return -5;
+// Phase 26: where a frame gets built. The front builds straight into NIC
+// tx slots; a worker builds into its frame ring, and the front copies the
+// frame on (shard_forward_frame). `*slot` only means something on the front.
+static int tx_ready(void) {
+    if (g_shard.id) return g_shard.link[0].up;
+    return g_net.rawframe_wr_req.raw && g_net.tx_ring_va;
+}
 
-    uint8_t scratch[ETH_MAX_FRAME];
-    if (14 + IPV4_HDR_LEN_MIN + payload_len > sizeof(scratch)) return -5;
+static uint8_t *tx_frame_alloc(size_t len, uint32_t *slot) {
+    if (g_shard.id) {
+        return netd_fring_reserve(&g_shard.link[0].out, (uint32_t)len,
+                                  NETD_FRING_KIND_ETH);
+    }
+    uint32_t nslots = (uint32_t)((len + g_net.slot_size - 1u) / g_net.slot_size);
+    if (tx_alloc_slots(nslots, slot) < 0) return NULL;
+    return tx_slot_va(*slot);
+}
+
+static int tx_frame_post(uint32_t slot, size_t len, uint8_t flags, uint16_t mss) {
+    if (g_shard.id) {
+        if (netd_fring_commit(&g_shard.link[0].out, flags, mss)) {
+            shard_kick(&g_shard.link[0]);
+        }
+        g_net.tx_packets++;
+        g_net.tx_bytes += len;
+        return 0;
+    }
+    return tx_post_slot(slot, len, flags, mss);
+}
+
+static int tx_raw_frame(const uint8_t *frame, size_t len) {
+    if (len == 0 || len > g_net.slot_size) return -5;
+    if (!tx_ready()) return -32 /* -ESHUTDOWN */;
+
+    uint32_t slot = 0;
+    uint8_t *p = tx_frame_alloc(len, &slot);
+    if (!p) return -11 /* -EAGAIN */;
+    memcpy(p, frame, len);
+    return tx_frame_post(slot, len, 0, 0);
+}
+
+// Route dst_ip (on-link vs gateway) and resolve the next hop's MAC. On an
+// ARP miss the request goes out and -EAGAIN comes back.
+static int tx_resolve_dst_mac(uint32_t dst_ip, uint8_t dst_mac[6]) {
+    // Phase 26: a worker has no ARP cache; the front fills the MAC in.
+    if (g_shard.id) {
+        memset(dst_mac, 0, 6);
+        return 0;
+    }
 
     // Route: on-link vs gateway.
     uint32_t next_hop = dst_ip;
@@ -346,7 +707,6 @@ static int tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
         // Directed broadcast: just send to FF:FF:FF:FF:FF:FF.
     }
 
-    uint8_t dst_mac[6];
     uint8_t is_bcast = (next_hop == 0xFFFFFFFFu) ? 1u : 0u;
     if (is_bcast) {
         memcpy(dst_mac, netd_eth_bcast, 6);
@@ -355,7 +715,8 @@ static int tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
         size_t  req_len = 0;
         int arc = netd_arp_resolve(&g_net.arp, g_net.mac, g_net.ip, next_hop,
                                    netd_rdtsc(),
-                                   (uint64_t)ARP_TTL_SECONDS * NETD_TICKS_PER_SEC,
+                                   (uint64_t)ARP_PENDING_MS *
+                                       (NETD_TICKS_PER_SEC / 1000u),
                                    dst_mac, req_buf, sizeof(req_buf), &req_len);
         if (arc == 0) {
             // Need resolution. Send the ARP request; drop this packet — the
@@ -366,6 +727,19 @@ static int tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
         }
         if (arc < 0) return arc;
     }
+    return 0;
+}
+
+static int tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
+                            const uint8_t *payload, size_t payload_len) {
+    if (payload_len > ETH_MAX_PAYLOAD - IPV4_HDR_LEN_MIN) return -5;
+
+    uint8_t scratch[ETH_MAX_FRAME];
+    if (14 + IPV4_HDR_LEN_MIN + payload_len > sizeof(scratch)) return -5;
+
+    uint8_t dst_mac[6];
+    int rc = tx_resolve_dst_mac(dst_ip, dst_mac);
+    if (rc < 0) return rc;
 
     uint8_t *p = scratch;
     p += netd_eth_build(p, dst_mac, g_net.mac, ETH_TYPE_IPV4);
@@ -380,7 +754,8 @@ static int tx_ipv4_datagram(uint32_t dst_ip, uint8_t proto,
 // =====================================================================
 // RX dispatch.
 // =====================================================================
-static void rx_dispatch_frame(const uint8_t *frame, size_t len) {
+static void rx_dispatch_frame(const uint8_t *frame, size_t len,
+                              uint8_t nic_csum) {
     uint8_t dst[6], src[6];
     uint16_t ethertype = 0;
     int rc = netd_eth_parse(frame, len, dst, src, &ethertype);
@@ -398,7 +773,7 @@ static void rx_dispatch_frame(const uint8_t *frame, size_t len) {
     if (ethertype == ETH_TYPE_ARP) {
         rx_arp(frame + 14, len - 14, src);
     } else if (ethertype == ETH_TYPE_IPV4) {
-        rx_ipv4(frame + 14, len - 14);
+        rx_ipv4(frame + 14, len - 14, nic_csum);
     }
     // Other ethertypes (IPv6, LLDP, ...) dropped silently.
 }
@@ -418,13 +793,25 @@ static void rx_arp(const uint8_t *arp_pdu, size_t len, const uint8_t src_mac[6])
     }
 }
 
-static void rx_ipv4(const uint8_t *ipv4_pdu, size_t len) {
+static void rx_ipv4(const uint8_t *ipv4_pdu, size_t len, uint8_t nic_csum) {
     ipv4_parsed_t ip;
-    if (netd_ipv4_parse(ipv4_pdu, len, &ip) != 0) return;
+    if (netd_ipv4_parse_csum(ipv4_pdu, len, nic_csum, &ip) != 0) return;
     if (ip.dst != g_net.ip && ip.dst != 0xFFFFFFFFu) {
         // Accept only unicast-to-us or broadcast.
         return;
     }
+    // Phase 26: a TCP segment belongs to the shard that owns its 4-tuple.
+    if (ip.proto == IPPROTO_TCP && g_shard.id == 0 && g_shard.count > 1 &&
+        ip.payload_len >= 4) {
+        uint32_t s = netd_shard_steer(g_shard.steer_seed, ip.dst,
+                                      netd_read_be16(&ip.payload[2]), ip.src,
+                                      netd_read_be16(&ip.payload[0]),
+                                      g_shard.count);
+        if (s != 0) {
+            shard_steer_rx(s, ipv4_pdu, len, nic_csum);
+            return;
+        }
+    }
     if (ip.proto == IPPROTO_ICMP)      rx_icmp(&ip);
     else if (ip.proto == IPPROTO_UDP)  rx_udp(&ip);
     else if (ip.proto == IPPROTO_TCP)  rx_tcp(&ip);
@@ -468,8 +855,7 @@ static void rx_icmp(const ipv4_parsed_t *ip) {
                 memset(&m, 0, sizeof(m));
                 m.header.inline_len = (uint16_t)sizeof(resp);
                 memcpy(m.inline_payload, &resp, sizeof(resp));
-                (void)syscall_chan_send(c->wr_resp, &m,
-                                        200000000ull /* 200 ms */);
+                (void)client_send(c, &m, 200000000ull /* 200 ms */);
             }
             pi->in_use = 0;
             return;
@@ -499,9 +885,9 @@ static void rx_udp(const ipv4_parsed_t *ip) {
     uint16_t src_port = 0, dst_port = 0;
     const uint8_t *payload = NULL;
     size_t plen = 0;
-    int rc = netd_udp_parse(ip->payload, ip->payload_len,
-                            ip->src, ip->dst,
-                            &src_port, &dst_port, &payload, &plen);
+    int rc = netd_udp_parse_csum(ip->payload, ip->payload_len,
+                                 ip->src, ip->dst, ip->nic_csum,
+                                 &src_port, &dst_port, &payload, &plen);
     if (rc != 0) return;
 
     // DHCP client port = 68; server = 67.
@@ -518,59 +904,345 @@ static void rx_udp(const ipv4_parsed_t *ip) {
 }
 
 // -- TCP ring helpers ----------------------------------------------------
-static uint16_t tcp_ring_bytes(const netd_tcp_conn_t *c) {
-    // head = write cursor, tail = read cursor. Count = (head - tail) mod N.
-    uint16_t n = (uint16_t)(c->rx_head - c->rx_tail);
-    return (uint16_t)(n % NETD_TCP_RX_RING_BYTES);
+// Rings are indexed by free-running positions (a byte count for rx, the
+// sequence number for tx); index = pos & (cap - 1).
+static void tcp_ring_copy_in(uint8_t *ring, uint32_t cap, uint32_t pos,
+                             const uint8_t *src, uint32_t len) {
+    while (len > 0) {
+        uint32_t o = pos & (cap - 1u);
+        uint32_t n = cap - o;
+        if (n > len) n = len;
+        memcpy(&ring[o], src, n);
+        pos += n;
+        src += n;
+        len -= n;
+    }
 }
 
-static uint16_t tcp_ring_push(netd_tcp_conn_t *c,
-                              const uint8_t *src, size_t len) {
-    // Drop overflow — HTTP MVP is best-effort. Record counter later if we
-    // ever need congestion signalling through the ring.
-    uint16_t avail =
-        (uint16_t)(NETD_TCP_RX_RING_BYTES - 1u - tcp_ring_bytes(c));
-    if (len > avail) len = avail;
-    for (size_t i = 0; i < len; i++) {
-        c->rx_buf[c->rx_head % NETD_TCP_RX_RING_BYTES] = src[i];
-        c->rx_head = (uint16_t)((c->rx_head + 1u) % NETD_TCP_RX_RING_BYTES);
+static void tcp_ring_copy_out(const uint8_t *ring, uint32_t cap, uint32_t pos,
+                              uint8_t *dst, uint32_t len) {
+    while (len > 0) {
+        uint32_t o = pos & (cap - 1u);
+        uint32_t n = cap - o;
+        if (n > len) n = len;
+        memcpy(dst, &ring[o], n);
+        pos += n;
+        dst += n;
+        len -= n;
     }
-    return (uint16_t)len;
 }
 
-static uint16_t tcp_ring_pop(netd_tcp_conn_t *c, uint8_t *dst, size_t cap) {
-    uint16_t avail = tcp_ring_bytes(c);
-    uint16_t n = (cap < avail) ? (uint16_t)cap : avail;
-    for (uint16_t i = 0; i < n; i++) {
-        dst[i] = c->rx_buf[c->rx_tail % NETD_TCP_RX_RING_BYTES];
-        c->rx_tail = (uint16_t)((c->rx_tail + 1u) % NETD_TCP_RX_RING_BYTES);
+// Copy [pos, pos + len) between rings of different sizes, keeping every
+// byte at its sequence position.
+static void tcp_ring_move(uint8_t *dst, uint32_t dst_cap,
+                          const uint8_t *src, uint32_t src_cap,
+                          uint32_t pos, uint32_t len) {
+    while (len > 0) {
+        uint32_t o = pos & (src_cap - 1u);
+        uint32_t n = src_cap - o;
+        if (n > len) n = len;
+        tcp_ring_copy_in(dst, dst_cap, pos, &src[o], n);
+        pos += n;
+        len -= n;
     }
+}
+
+// Re-home [pos, pos + len) into a ring of `new_cap` bytes. Returns the new
+// buffer (the old one is freed), or NULL with the old one untouched.
+static uint8_t *tcp_ring_grow(uint8_t *ring, uint32_t cap, uint32_t new_cap,
+                              uint32_t pos, uint32_t len) {
+    uint8_t *nb = (uint8_t *)malloc(new_cap);
+    if (!nb) return NULL;
+    tcp_ring_move(nb, new_cap, ring, cap, pos, len);
+    free(ring);
+    return nb;
+}
+
+static uint32_t tcp_ring_bytes(const netd_tcp_conn_t *c) {
+    // head = in-order write cursor (rcv_nxt), tail = read cursor.
+    return c->rx_head - c->rx_tail;
+}
+
+static uint32_t tcp_rx_free(const netd_tcp_conn_t *c) {
+    return c->rx_cap - tcp_ring_bytes(c);
+}
+
+static uint32_t tcp_ring_pop(netd_tcp_conn_t *c, uint8_t *dst, size_t cap) {
+    uint32_t avail = tcp_ring_bytes(c);
+    uint32_t n = (cap < avail) ? (uint32_t)cap : avail;
+    tcp_ring_copy_out(c->rx_buf, c->rx_cap, c->rx_tail, dst, n);
+    c->rx_tail += n;
     return n;
 }
 
-// Emit a TCP segment with the given flags + payload over IPv4. The helper
-// fabricates a tiny scratch buffer holding the segment then hands it to
-// tx_ipv4_datagram which prepends IP + Ethernet. On ARP miss the caller
-// gets -EAGAIN propagated.
-static int tcp_emit_segment(const tcp_socket_t *sock,
+// First byte the tx ring still holds: snd_una, or tx_end once our FIN
+// (which has no byte in the ring) is ACKed too.
+static uint32_t tcp_tx_start(const netd_tcp_conn_t *c, const tcp_socket_t *sock) {
+    return ((int32_t)(c->tx_end - sock->snd_una) < 0) ? c->tx_end : sock->snd_una;
+}
+
+// Software path: build one frame's TCP segment in a scratch buffer and
+// hand it to tx_ipv4_datagram, which prepends IP + Ethernet. On ARP miss
+// the caller gets -EAGAIN propagated.
+static int tcp_emit_sw(const tcp_socket_t *sock,
+                       uint32_t seq, uint32_t ack, uint8_t flags,
+                       uint16_t window, const uint8_t *opt, size_t opt_len,
+                       const uint8_t *payload, size_t payload_len) {
+    uint8_t scratch[TCP_HDR_LEN_MAX + TCP_DEFAULT_MSS];
+    if (payload_len > TCP_DEFAULT_MSS) return -5;
+    size_t seg_len = netd_tcp_build_opts(scratch,
+                                         sock->local_ip, sock->remote_ip,
+                                         sock->local_port, sock->remote_port,
+                                         seq, ack, flags, window,
+                                         opt, opt_len, payload, payload_len);
+    if (seg_len == 0) return -5;
+    return tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP, scratch, seg_len);
+}
+
+// Phase 26 offload path: assemble Ethernet + IPv4 + TCP straight in the tx
+// ring and let the NIC finish the TCP checksum. With `tso` the payload may
+// span several slots and the NIC cuts it into `mss`-sized segments,
+// rewriting the IPv4 length/checksum and sequence numbers of each.
+static int tcp_emit_offload(const tcp_socket_t *sock,
+                            uint32_t seq, uint32_t ack, uint8_t flags,
+                            uint16_t window, const uint8_t *opt, size_t opt_len,
+                            const uint8_t *payload, size_t payload_len,
+                            int tso, uint16_t mss) {
+    if (!tx_ready()) return -32 /* -ESHUTDOWN */;
+    uint8_t dst_mac[6];
+    int rc = tx_resolve_dst_mac(sock->remote_ip, dst_mac);
+    if (rc < 0) return rc;
+
+    size_t tcp_hdr_len = TCP_HDR_LEN_MIN + opt_len;
+    size_t total = 14 + IPV4_HDR_LEN_MIN + tcp_hdr_len + payload_len;
+    uint32_t nslots = (uint32_t)((total + g_net.slot_size - 1) / g_net.slot_size);
+    if (nslots > 1 && (!tso || total > RAWFRAME_TSO_MAX_BYTES ||
+                       nslots > g_net.slot_count)) {
+        return -5;
+    }
+    uint32_t slot = 0;
+    uint8_t *p = tx_frame_alloc(total, &slot);
+    if (!p) return -11 /* -EAGAIN */;
+    p += netd_eth_build(p, dst_mac, g_net.mac, ETH_TYPE_IPV4);
+    uint8_t *iph = p;
+    p += netd_ipv4_build_header(p, g_net.ip, sock->remote_ip, IPPROTO_TCP,
+                                (uint16_t)netd_rand32(),
+                                (uint16_t)(tcp_hdr_len + payload_len),
+                                IPV4_DEFAULT_TTL);
+    if (tso) {
+        // The NIC fills in each segment's length and header checksum.
+        netd_write_be16(&iph[2], 0);
+        netd_write_be16(&iph[10], 0);
+    }
+    p += netd_tcp_build_offload(p, sock->local_ip, sock->remote_ip,
+                                sock->local_port, sock->remote_port,
+                                seq, ack, flags, window, opt, opt_len,
+                                payload_len, tso);
+    if (payload_len) memcpy(p, payload, payload_len);
+
+    uint8_t txf = tso ? (RAWFRAME_TX_TSO | RAWFRAME_TX_IP_CSUM |
+                         RAWFRAME_TX_L4_CSUM)
+                      : RAWFRAME_TX_L4_CSUM;
+    return tx_frame_post(slot, total, txf, tso ? mss : 0);
+}
+
+// Emit `payload` as TCP data starting at `seq`. Phase 26: with TX checksum
+// offload the segment skips the software checksum; a payload longer than
+// the MSS goes out as TSO super-segments (up to RAWFRAME_TSO_MAX_BYTES per
+// frame) when the NIC can cut them, else as MSS-sized frames. PSH/FIN ride
+// only on the last frame. Every frame carries the negotiated options —
+// SACK blocks only on a bare ACK — and the current window.
+static int tcp_emit_segment(tcp_socket_t *sock,
                             uint32_t seq, uint32_t ack,
                             uint8_t flags,
                             const uint8_t *payload, size_t payload_len) {
-    uint8_t scratch[TCP_HDR_LEN_MIN + 4 + 512];
-    if (payload_len > 512) return -5;
-    size_t seg_len = netd_tcp_build(scratch,
-                                    sock->local_ip, sock->remote_ip,
-                                    sock->local_port, sock->remote_port,
-                                    seq, ack,
-                                    flags, (uint16_t)sock->rcv_wnd,
-                                    0, payload, payload_len);
-    if (seg_len == 0) return -5;
-    return tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP, scratch, seg_len);
+    uint8_t opt[TCP_HDR_LEN_MAX - TCP_HDR_LEN_MIN];
+    size_t  opt_len = netd_tcp_write_options(sock, opt, netd_rdtsc(),
+                                             NETD_TICKS_PER_SEC,
+                                             payload_len == 0);
+    uint16_t window = netd_tcp_adv_window(sock, 0);
+    uint16_t mss = netd_tcp_eff_mss(sock);
+    if (mss > TCP_DEFAULT_MSS) mss = TCP_DEFAULT_MSS;
+    int csum_off = (g_net.nic_features & RAWFRAME_FEAT_TX_CSUM) ? 1 : 0;
+    int tso = csum_off && (g_net.nic_features & RAWFRAME_FEAT_TSO) &&
+              payload_len > mss;
+    size_t step = mss;
+    if (tso) {
+        step = RAWFRAME_TSO_MAX_BYTES -
+               (14 + IPV4_HDR_LEN_MIN + TCP_HDR_LEN_MIN + opt_len);
+        step -= step % mss;
+    }
+
+    size_t off = 0;
+    do {
+        size_t chunk = payload_len - off;
+        if (chunk > step) chunk = step;
+        uint8_t f = flags;
+        if (off + chunk < payload_len) {
+            f = (uint8_t)(f & ~(TCP_FLAG_PSH | TCP_FLAG_FIN));
+        }
+        int rc;
+        if (csum_off) {
+            rc = tcp_emit_offload(sock, seq + (uint32_t)off, ack, f,
+                                  window, opt, opt_len,
+                                  payload + off, chunk,
+                                  tso && chunk > mss, mss);
+        } else {
+            rc = tcp_emit_sw(sock, seq + (uint32_t)off, ack, f,
+                             window, opt, opt_len, payload + off, chunk);
+        }
+        if (rc < 0) return rc;
+        off += chunk;
+    } while (off < payload_len);
+    return 0;
+}
+
+// Phase 26 output pass: send whatever the window, cwnd and recovery state
+// allow out of the tx ring, then the FIN once the ring has drained. Driven
+// by sends, incoming ACKs and the tick (after an RTO rewinds snd_nxt).
+static void tcp_output_segments(int socket_idx, uint64_t now_tsc) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+    switch (sock->state) {
+    case TCP_STATE_ESTABLISHED:
+    case TCP_STATE_CLOSE_WAIT:
+    case TCP_STATE_FIN_WAIT1:
+    case TCP_STATE_CLOSING:
+    case TCP_STATE_LAST_ACK:
+        break;
+    default:
+        return;
+    }
+    sock->rcv_wnd = tcp_rx_free(conn);
+
+    uint32_t seq = 0, len = 0;
+    while (netd_tcp_next_segment(sock, conn->tx_end, NETD_TCP_SEG_MAX,
+                                 &seq, &len)) {
+        // A segment may straddle the end of the ring: two emits.
+        uint32_t off   = seq & (conn->tx_cap - 1u);
+        uint32_t first = conn->tx_cap - off;
+        if (first > len) first = len;
+        uint8_t flags = TCP_FLAG_ACK;
+        if (seq + first == conn->tx_end) flags |= TCP_FLAG_PSH;
+        int rc = tcp_emit_segment(sock, seq, sock->rcv_nxt, flags,
+                                  &conn->tx_buf[off], first);
+        if (rc < 0) {        // ARP miss / tx ring full: the tick retries
+            conn->tx_stall = 1;
+            break;
+        }
+        uint32_t done = first;
+        if (first < len) {
+            flags = TCP_FLAG_ACK;
+            if (seq + len == conn->tx_end) flags |= TCP_FLAG_PSH;
+            rc = tcp_emit_segment(sock, seq + first, sock->rcv_nxt, flags,
+                                  conn->tx_buf, len - first);
+            if (rc >= 0) done = len;
+            else conn->tx_stall = 1;
+        }
+        netd_tcp_sent(sock, seq, done, now_tsc, NETD_TICKS_PER_SEC);
+        if (done < len) break;
+    }
+
+    if (conn->fin_pending && sock->snd_nxt == conn->tx_end) {
+        uint8_t fin_buf[TCP_HDR_LEN_MAX];
+        size_t  fin_len = 0;
+        if (netd_tcp_close(sock, fin_buf, sizeof(fin_buf), &fin_len,
+                           now_tsc, NETD_TICKS_PER_SEC) == 0) {
+            if (fin_len > 0) {
+                (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP,
+                                       fin_buf, fin_len);
+            }
+            conn->close_sent = 1;
+        }
+        conn->fin_pending = 0;
+    } else if (conn->close_sent && sock->snd_nxt == conn->tx_end &&
+               sock->snd_una != sock->snd_max) {
+        // An RTO rewound over our unACKed FIN: every byte is back out, so
+        // the FIN goes again.
+        if (tcp_emit_segment(sock, conn->tx_end, sock->rcv_nxt,
+                             TCP_FLAG_FIN | TCP_FLAG_ACK, NULL, 0) >= 0) {
+            netd_tcp_sent(sock, conn->tx_end, 1, now_tsc, NETD_TICKS_PER_SEC);
+        }
+    }
+
+    // Zero window with bytes waiting: arm the persist timer (the RTO
+    // field doubles for it) so netd_tcp_tick schedules a probe.
+    if (sock->snd_wnd == 0 && (int32_t)(conn->tx_end - sock->snd_nxt) > 0 &&
+        sock->retx_expiry_tsc == 0) {
+        sock->retx_expiry_tsc = now_tsc +
+                                (uint64_t)sock->rto_ms * (NETD_TICKS_PER_SEC / 1000u);
+    }
+}
+
+// Send what the socket may, then re-file it on the timer wheel: anything
+// that can move a socket's timers ends up here.
+static void tcp_output(int socket_idx, uint64_t now_tsc) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (!conn->in_use) return;
+    conn->tx_stall = 0;
+    tcp_output_segments(socket_idx, now_tsc);
+    tcp_timer_arm(socket_idx, now_tsc);
+}
+
+// Phase 26: file socket `socket_idx` under its next deadline — the
+// retransmit / persist timer, TIME_WAIT expiry, a backstop poll of an
+// attached socket's shared ring (a doorbell lost to a full channel), or
+// the next tick when output stalled or a CLOSED socket waits to be reaped.
+static void tcp_timer_arm(int socket_idx, uint64_t now_tsc) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (!conn->in_use || conn->listener) {
+        netd_twheel_cancel(&g_tcp_wheel, (uint32_t)socket_idx);
+        return;
+    }
+    const tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+    uint64_t soon = now_tsc + NETD_TCP_WHEEL_TICK_TSC;
+    uint64_t due  = sock->retx_expiry_tsc;
+    if (sock->state == TCP_STATE_TIME_WAIT &&
+        (!due || sock->time_wait_expiry_tsc < due)) {
+        due = sock->time_wait_expiry_tsc;
+    }
+    if (conn->shm) {
+        uint64_t poll = now_tsc + (uint64_t)NETD_TCP_SHM_POLL_MS *
+                                      (NETD_TICKS_PER_SEC / 1000u);
+        if (!due || poll < due) due = poll;
+    }
+    if (conn->tx_stall || sock->state == TCP_STATE_CLOSED) due = soon;
+    if (!due) {
+        netd_twheel_cancel(&g_tcp_wheel, (uint32_t)socket_idx);
+        return;
+    }
+    // Never back into the tick being expired: a socket the tick just ran
+    // waits for the next one.
+    netd_twheel_arm(&g_tcp_wheel, (uint32_t)socket_idx, due < soon ? soon : due);
+}
+
+// Reader drained the rx ring: advertise the space once it has grown by
+// min(MSS, half the buffer) past the last window sent (RFC 1122
+// §4.2.3.3 receiver SWS avoidance).
+static void tcp_window_update(int socket_idx) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (!conn->in_use) return;
+    tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+    if (sock->state != TCP_STATE_ESTABLISHED &&
+        sock->state != TCP_STATE_FIN_WAIT1 &&
+        sock->state != TCP_STATE_FIN_WAIT2) {
+        return;
+    }
+    uint32_t free_b = tcp_rx_free(conn);
+    uint32_t grown  = sock->rcv_nxt + free_b - sock->rcv_adv;
+    if ((int32_t)grown <= 0) return;
+    uint32_t thresh = netd_tcp_eff_mss(sock);
+    if (thresh > conn->rx_cap / 2u) thresh = conn->rx_cap / 2u;
+    if (grown < thresh) return;
+    sock->rcv_wnd = free_b;
+    (void)tcp_emit_segment(sock, sock->snd_nxt, sock->rcv_nxt, TCP_FLAG_ACK,
+                           NULL, 0);
 }
 
 static void rx_tcp(const ipv4_parsed_t *ip) {
     tcp_parsed_t pkt;
-    if (netd_tcp_parse(ip->payload, ip->payload_len, ip->src, ip->dst, &pkt) != 0) {
+    if (netd_tcp_parse_csum(ip->payload, ip->payload_len, ip->src, ip->dst,
+                            ip->nic_csum, &pkt) != 0) {
         return;
     }
 
@@ -579,52 +1251,95 @@ static void rx_tcp(const ipv4_parsed_t *ip) {
                                         ip->dst, pkt.dst_port,
                                         ip->src, pkt.src_port);
     // SYN_SENT: socket's remote_* match before ESTABLISHED too, so the
-    // above lookup already covers it. No LISTEN state in Stage D client
-    // flow.
-    if (idx < 0) return;
+    // above lookup already covers it. Phase 26: a miss may be a SYN (or a
+    // SYN cookie's ACK) for a listener.
+    if (idx < 0) {
+        tcp_rx_listen(ip, &pkt);
+        return;
+    }
 
     tcp_socket_t *sock = &g_net.tcp.sockets[idx];
     netd_tcp_conn_t *conn = &g_tcp_conn[idx];
     if (!conn->in_use) return;
+    tcp_shm_pull(idx);
+    // A child can't complete its handshake into a full accept queue; drop
+    // the ACK and let the peer retransmit once there is room.
+    if (sock->state == TCP_STATE_SYN_RCVD && conn->parent &&
+        tcp_aq_full(&g_tcp_listeners[conn->parent - 1u])) {
+        return;
+    }
+
+    uint64_t now = netd_rdtsc();
+    uint8_t  prev_state = sock->state;
+    uint32_t prev_rcv_nxt = sock->rcv_nxt;
+    uint8_t  prev_fin = sock->fin_rcvd;
+    int synced = (prev_state != TCP_STATE_SYN_SENT);
+
+    // The window is the free ring space, so whatever the state machine
+    // accepts fits.
+    sock->rcv_wnd = tcp_rx_free(conn);
+    uint32_t prev_adv = sock->rcv_adv;
 
     // Feed the parsed segment to the state machine.
-    uint8_t resp_buf[TCP_HDR_LEN_MIN + 4];
+    uint8_t resp_buf[TCP_HDR_LEN_MAX];
     size_t  resp_len = 0;
-    uint64_t now = netd_rdtsc();
-    uint8_t prev_state = sock->state;
     int rc = netd_tcp_on_segment(sock, &pkt, now, NETD_TICKS_PER_SEC,
                                  resp_buf, sizeof(resp_buf), &resp_len);
     (void)rc;
 
+    // Stash the accepted payload at its sequence offset: on_segment only
+    // moves rcv_nxt (over held out-of-order ranges too), buffering is ours.
+    // The offset is against prev_rcv_nxt, i.e. rx_head before the advance
+    // below. A rejected segment copies nothing, so it cannot clobber bytes
+    // already held for a SACKed range.
+    int filled = 0;
+    if (synced && sock->rcv_seg_len) {
+        tcp_ring_copy_in(conn->rx_buf, conn->rx_cap,
+                         conn->rx_head + sock->rcv_seg_off,
+                         pkt.payload + sock->rcv_seg_skip, sock->rcv_seg_len);
+        filled = (int32_t)(pkt.seq + (uint32_t)pkt.payload_len -
+                           prev_adv) >= 0;
+    }
+
     // If any control segment came back, emit it (ACK / SYN-ACK / FIN-ACK).
     if (resp_len > 0) {
         (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP,
                                resp_buf, resp_len);
     }
 
-    // Stash payload bytes in the per-socket rx ring. netd_tcp_on_segment
-    // only advances rcv_nxt; buffering is our responsibility.
-    if (pkt.payload_len > 0 && pkt.seq == sock->irs + 1u + /* dropped? */ 0) {
-        // on_segment already bumped rcv_nxt; the segment was accepted iff
-        // pkt.seq == prev rcv_nxt == sock->rcv_nxt - pkt.payload_len.
-        if (sock->rcv_nxt == pkt.seq + (uint32_t)pkt.payload_len) {
-            (void)tcp_ring_push(conn, pkt.payload, pkt.payload_len);
-        }
-    } else if (pkt.payload_len > 0 &&
-               sock->rcv_nxt == pkt.seq + (uint32_t)pkt.payload_len) {
-        (void)tcp_ring_push(conn, pkt.payload, pkt.payload_len);
+    if (synced) {
+        uint32_t adv = sock->rcv_nxt - prev_rcv_nxt;
+        if (sock->fin_rcvd && !prev_fin) adv -= 1u;   // The FIN has no byte
+        conn->rx_head += adv;
     }
-
-    if (pkt.flags & TCP_FLAG_FIN) {
+    if (sock->fin_rcvd) {
         conn->peer_fin = 1;
     }
 
+    // Receive autotuning: the peer filled the whole advertised window while
+    // the reader kept the ring under half full — the window, not the
+    // reader, is the bottleneck, so double it.
+    if (filled && !conn->shm && conn->rx_cap < NETD_TCP_RCVBUF_MAX &&
+        tcp_ring_bytes(conn) < conn->rx_cap / 2u) {
+        uint8_t *nb = tcp_ring_grow(conn->rx_buf, conn->rx_cap,
+                                    conn->rx_cap * 2u, conn->rx_tail,
+                                    conn->rx_cap);
+        if (nb) {
+            conn->rx_buf = nb;
+            conn->rx_cap *= 2u;
+            tcp_window_update(idx);
+        }
+    }
+
     // State-change fan-out: pending_open fires on ESTABLISHED, pending_recv
     // is satisfied whenever ring grows or peer_fin arrives.
     if (sock->state != prev_state) {
         tcp_on_socket_state_change(idx);
     }
     tcp_satisfy_pending_recv(idx);
+    // The ACK may have opened cwnd or the peer's window.
+    tcp_output(idx, now);
+    tcp_shm_sync(idx, now);
 }
 
 // =====================================================================
@@ -698,6 +1413,7 @@ static void dhcp_on_udp(uint16_t src_port, uint16_t dst_port,
         g_net.gateway      = g_net.dhcp.router;
         g_net.dns_resolver = g_net.dhcp.dns;
         g_net.stack_running = 1;
+        shard_push_config();
         printf("[netd] DHCP bound: ip=%u.%u.%u.%u gw=%u.%u.%u.%u dns=%u.%u.%u.%u\n",
                (g_net.ip >> 24) & 0xFF, (g_net.ip >> 16) & 0xFF,
                (g_net.ip >> 8) & 0xFF, g_net.ip & 0xFF,
@@ -780,7 +1496,7 @@ static void dns_reply_to_client(pending_dns_t *slot,
     memset(&m, 0, sizeof(m));
     m.header.inline_len = (uint16_t)sizeof(resp);
     memcpy(m.inline_payload, &resp, sizeof(resp));
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
     slot->in_use = 0;
 }
 
@@ -816,6 +1532,16 @@ static void dns_tick(uint64_t now_tsc) {
     }
 }
 
+// Phase 26: age the ARP cache. Stale entries already miss in
+// netd_arp_resolve; the sweep returns their slots (and unanswered PENDING
+// ones) before the table fills and starts evicting live neighbours.
+static void arp_tick(uint64_t now_tsc) {
+    static uint64_t s_next_gc;
+    if ((int64_t)(now_tsc - s_next_gc) < 0) return;
+    s_next_gc = now_tsc + (uint64_t)ARP_GC_MS * (NETD_TICKS_PER_SEC / 1000u);
+    (void)netd_arp_gc(&g_net.arp, now_tsc);
+}
+
 static void icmp_tick(uint64_t now_tsc) {
     for (uint32_t i = 0; i < NETD_MAX_PENDING_ICMP; i++) {
         pending_icmp_t *pi = &g_icmps[i];
@@ -839,7 +1565,7 @@ static void icmp_tick(uint64_t now_tsc) {
             memset(&m, 0, sizeof(m));
             m.header.inline_len = (uint16_t)sizeof(resp);
             memcpy(m.inline_payload, &resp, sizeof(resp));
-            (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+            (void)client_send(c, &m, 200000000ull);
         }
         pi->in_use = 0;
     }
@@ -856,6 +1582,18 @@ static int find_free_client_slot(void) {
 }
 
 static void client_release(netd_client_t *c) {
+    if (g_ws) {
+        (void)syscall_waitset_ctl(g_ws, WAITSET_CTL_DEL, c->rd_req.raw, 0, 0);
+    }
+    // Phase 26: any worker may hold a stand-in for this slot; the next
+    // client to reuse it must not inherit one.
+    if (g_shard.id == 0) {
+        for (uint32_t s = 1; s < g_shard.count; s++) {
+            if (!g_shard.link[s].up) continue;
+            (void)shard_send(&g_shard.link[s], NETD_SHARD_OP_RELEASE,
+                             (uint32_t)(c - g_clients), 0, NULL, 0, 0);
+        }
+    }
     memset(c, 0, sizeof(*c));
 }
 
@@ -868,7 +1606,7 @@ static void client_send_error(netd_client_t *c, uint16_t resp_op,
                                                 resp_op, seq, status);
     if (n == 0) return;
     m.header.inline_len = n;
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
 }
 
 static void handle_hello(netd_client_t *c, const chan_msg_user_t *in) {
@@ -886,7 +1624,7 @@ static void handle_hello(netd_client_t *c, const chan_msg_user_t *in) {
     memset(&m, 0, sizeof(m));
     m.header.inline_len = (uint16_t)sizeof(resp);
     memcpy(m.inline_payload, &resp, sizeof(resp));
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
 }
 
 static void handle_net_query(netd_client_t *c, const chan_msg_user_t *in) {
@@ -923,7 +1661,7 @@ static void handle_net_query(netd_client_t *c, const chan_msg_user_t *in) {
     memset(&m, 0, sizeof(m));
     m.header.inline_len = (uint16_t)sizeof(resp);
     memcpy(m.inline_payload, &resp, sizeof(resp));
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
 }
 
 static void handle_dns_query(netd_client_t *c, const chan_msg_user_t *in) {
@@ -951,7 +1689,7 @@ static void handle_dns_query(netd_client_t *c, const chan_msg_user_t *in) {
         memset(&m, 0, sizeof(m));
         m.header.inline_len = (uint16_t)sizeof(resp);
         memcpy(m.inline_payload, &resp, sizeof(resp));
-        (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+        (void)client_send(c, &m, 200000000ull);
     }
     // Otherwise the reply will arrive asynchronously when the DNS UDP
     // response comes in (or dns_tick() times out).
@@ -1027,7 +1765,7 @@ static void handle_udp_bind(netd_client_t *c, const chan_msg_user_t *in) {
     memset(&m, 0, sizeof(m));
     m.header.inline_len = (uint16_t)sizeof(resp);
     memcpy(m.inline_payload, &resp, sizeof(resp));
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
 }
 
 static void handle_udp_sendto(netd_client_t *c, const chan_msg_user_t *in) {
@@ -1072,7 +1810,7 @@ send: {
         memset(&m, 0, sizeof(m));
         m.header.inline_len = (uint16_t)sizeof(resp);
         memcpy(m.inline_payload, &resp, sizeof(resp));
-        (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+        (void)client_send(c, &m, 200000000ull);
     }
 }
 
@@ -1107,7 +1845,7 @@ static void tcp_send_open_resp(int socket_idx, uint32_t client_idx,
     memset(&m, 0, sizeof(m));
     m.header.inline_len = (uint16_t)sizeof(resp);
     memcpy(m.inline_payload, &resp, sizeof(resp));
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
 }
 
 static void tcp_send_recv_resp(uint32_t client_idx, uint32_t req_seq,
@@ -1130,13 +1868,108 @@ static void tcp_send_recv_resp(uint32_t client_idx, uint32_t req_seq,
     memset(&m, 0, sizeof(m));
     m.header.inline_len = (uint16_t)sizeof(resp);
     memcpy(m.inline_payload, &resp, sizeof(resp));
-    (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+    (void)client_send(c, &m, 200000000ull);
+}
+
+// ---------------------------------------------------------------------
+// Phase 26: shared-memory sockets.
+// ---------------------------------------------------------------------
+
+// Doorbell to the owning client. Never blocks netd: a full response
+// channel already holds a wake-up for it.
+static void tcp_shm_ring(int socket_idx) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    netd_client_t *c = &g_clients[conn->client_idx];
+    if (!c->in_use) return;
+    libnet_tcp_shm_kick_t k;
+    memset(&k, 0, sizeof(k));
+    k.hdr.op        = LIBNET_OP_TCP_SHM_KICK_RESP;
+    k.socket_cookie = conn->cookie;
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    m.header.inline_len = (uint16_t)sizeof(k);
+    memcpy(m.inline_payload, &k, sizeof(k));
+    (void)client_send(c, &m, 0);
+}
+
+// Take the client's side of the ring positions. Both are checked against
+// what netd knows, so a confused client can only hurt its own stream.
+static void tcp_shm_pull(int socket_idx) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (!conn->shm) return;
+    tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+
+    uint32_t cons = __atomic_load_n(&conn->shm->rx_cons, __ATOMIC_ACQUIRE);
+    if (cons - conn->rx_tail <= conn->rx_head - conn->rx_tail) {
+        conn->rx_tail = cons;
+    }
+    if (conn->fin_pending || conn->close_sent ||
+        (sock->state != TCP_STATE_ESTABLISHED &&
+         sock->state != TCP_STATE_CLOSE_WAIT)) {
+        return;
+    }
+    uint32_t prod = __atomic_load_n(&conn->shm->tx_prod, __ATOMIC_ACQUIRE);
+    if ((int32_t)(prod - conn->tx_end) > 0 &&
+        prod - tcp_tx_start(conn, sock) <= conn->tx_cap) {
+        conn->tx_end = prod;
+    }
+}
+
+// Publish netd's side, wake the client if it sleeps, and arm netd_kick if
+// netd wants to hear about the client's next move: new tx bytes once
+// everything queued is out, or reads once the rx ring is half full (they
+// reopen the window). Returns 1 if the client moved after the arm — it
+// may have missed it, so the caller goes round again.
+static int tcp_shm_push(int socket_idx) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    libnet_tcp_shm_ctl_t *ctl = conn->shm;
+    tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+
+    uint32_t flags = (conn->peer_fin ? LIBNET_TCP_SHM_RX_FIN : 0u) |
+                     (sock->state == TCP_STATE_CLOSED ? LIBNET_TCP_SHM_RX_CLOSED
+                                                      : 0u);
+    __atomic_store_n(&ctl->rx_prod, conn->rx_head, __ATOMIC_RELEASE);
+    __atomic_store_n(&ctl->tx_cons, tcp_tx_start(conn, sock), __ATOMIC_RELEASE);
+    __atomic_store_n(&ctl->rx_flags, flags, __ATOMIC_RELEASE);
+    if (__atomic_exchange_n(&ctl->client_kick, 0u, __ATOMIC_ACQ_REL)) {
+        tcp_shm_ring(socket_idx);
+    }
+
+    int want_tx = !conn->fin_pending && !conn->close_sent &&
+                  (int32_t)(sock->snd_nxt - conn->tx_end) >= 0 &&
+                  (sock->state == TCP_STATE_ESTABLISHED ||
+                   sock->state == TCP_STATE_CLOSE_WAIT);
+    int want_rx = tcp_rx_free(conn) < conn->rx_cap / 2u;
+    if (!want_tx && !want_rx) return 0;
+    __atomic_store_n(&ctl->netd_kick, 1u, __ATOMIC_SEQ_CST);
+    return (want_tx &&
+            __atomic_load_n(&ctl->tx_prod, __ATOMIC_SEQ_CST) != conn->tx_end) ||
+           (want_rx &&
+            __atomic_load_n(&ctl->rx_cons, __ATOMIC_SEQ_CST) != conn->rx_tail);
+}
+
+// Full exchange for an attached socket: take the client's positions, send
+// what they allow (a window update for space it read, data it queued),
+// then publish ours.
+static void tcp_shm_sync(int socket_idx, uint64_t now_tsc) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (!conn->in_use || !conn->shm) return;
+    for (int pass = 0; pass < 4; pass++) {
+        tcp_shm_pull(socket_idx);
+        tcp_window_update(socket_idx);
+        tcp_output(socket_idx, now_tsc);
+        if (!tcp_shm_push(socket_idx)) break;
+    }
 }
 
 static void tcp_on_socket_state_change(int socket_idx) {
     if (socket_idx < 0) return;
     tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
-    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+
+    if (sock->state == TCP_STATE_ESTABLISHED ||
+        sock->state == TCP_STATE_CLOSE_WAIT) {
+        tcp_child_ready(socket_idx);
+    }
 
     // Fire any matching pending_open for this socket.
     for (uint32_t i = 0; i < NETD_MAX_PENDING_TCP_OPEN; i++) {
@@ -1150,10 +1983,40 @@ static void tcp_on_socket_state_change(int socket_idx) {
             tcp_send_open_resp(-1, po->client_idx, po->req_seq,
                                -111 /* -ECONNREFUSED */);
             po->in_use = 0;
-            conn->in_use = 0;
-            netd_tcp_socket_free(&g_net.tcp, socket_idx);
+            tcp_conn_release(socket_idx);
+        }
+    }
+}
+
+// Drop both halves of a socket: the conn's rings and the wire state.
+static void tcp_conn_release(int socket_idx) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (conn->parent && !conn->queued) {
+        g_tcp_listeners[conn->parent - 1u].syn_count--;
+    }
+    if (conn->shm) {
+        // The client keeps its mapping; tell it the connection is gone.
+        __atomic_or_fetch(&conn->shm->rx_flags, LIBNET_TCP_SHM_RX_CLOSED,
+                          __ATOMIC_RELEASE);
+        if (__atomic_exchange_n(&conn->shm->client_kick, 0u, __ATOMIC_ACQ_REL)) {
+            tcp_shm_ring(socket_idx);
         }
+        (void)syscall_vmo_unmap((uint64_t)(uintptr_t)conn->shm, conn->shm_bytes);
+    } else {
+        free(conn->rx_buf);
+        free(conn->tx_buf);
     }
+    memset(conn, 0, sizeof(*conn));
+    netd_twheel_cancel(&g_tcp_wheel, (uint32_t)socket_idx);
+    netd_tcp_socket_free(&g_net.tcp, socket_idx);
+}
+
+// Abort a child no accept will ever hand out: RST the peer, then release.
+static void tcp_child_reset(int socket_idx) {
+    tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+    (void)tcp_emit_segment(sock, sock->snd_nxt, sock->rcv_nxt,
+                           TCP_FLAG_RST | TCP_FLAG_ACK, NULL, 0);
+    tcp_conn_release(socket_idx);
 }
 
 static void tcp_satisfy_pending_recv(int socket_idx) {
@@ -1165,15 +2028,16 @@ static void tcp_satisfy_pending_recv(int socket_idx) {
         if (!pr->in_use) continue;
         if (pr->socket_idx != (uint32_t)socket_idx) continue;
 
-        uint16_t buffered = tcp_ring_bytes(conn);
+        uint32_t buffered = tcp_ring_bytes(conn);
         if (buffered == 0 && !conn->peer_fin) continue;
 
         uint16_t cap = pr->max_bytes ? pr->max_bytes : LIBNET_TCP_CHUNK_MAX;
         if (cap > LIBNET_TCP_CHUNK_MAX) cap = LIBNET_TCP_CHUNK_MAX;
 
         uint8_t buf[LIBNET_TCP_CHUNK_MAX];
-        uint16_t n = tcp_ring_pop(conn, buf, cap);
+        uint16_t n = (uint16_t)tcp_ring_pop(conn, buf, cap);
         uint16_t flags = conn->peer_fin ? 1u : 0u;
+        if (n > 0) tcp_window_update(socket_idx);
 
         if (n == 0 && conn->peer_fin) {
             // No more data coming.
@@ -1187,60 +2051,329 @@ static void tcp_satisfy_pending_recv(int socket_idx) {
     }
 }
 
-static void handle_tcp_open(netd_client_t *c, const chan_msg_user_t *in) {
-    const libnet_tcp_open_req_t *req =
-        (const libnet_tcp_open_req_t *)in->inline_payload;
-
-    if (!g_net.stack_running) {
-        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq,
-                          -101 /* -ENETUNREACH */);
-        return;
-    }
-    if (req->dst_port == 0) {
-        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq, -5);
-        return;
-    }
-
-    uint32_t client_idx = (uint32_t)(c - g_clients);
-    uint32_t cookie = g_tcp_cookie_seed++;
-    if (cookie == 0) cookie = g_tcp_cookie_seed++;
+// Phase 26: a cookie's residue mod the shard count names the shard that
+// owns the socket (netd_shard_cookie), which is how the front routes ops.
+static uint32_t tcp_cookie_next(void) {
+    return netd_shard_cookie(&g_tcp_cookie_seed, g_shard.id, g_shard.count);
+}
 
-    int idx = netd_tcp_socket_alloc(&g_net.tcp, cookie);
-    if (idx < 0) {
-        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq,
-                          -11 /* -EAGAIN — table full */);
-        return;
-    }
-    tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+// Claim the conn half of freshly allocated socket `idx`, rings included.
+// On -12 the conn is still marked in use; tcp_conn_release undoes it.
+static int tcp_conn_setup(int idx, uint32_t client_idx, uint32_t cookie) {
     netd_tcp_conn_t *conn = &g_tcp_conn[idx];
     memset(conn, 0, sizeof(*conn));
     conn->in_use     = 1;
     conn->client_idx = client_idx;
     conn->cookie     = cookie;
+    conn->rx_buf     = (uint8_t *)malloc(NETD_TCP_RCVBUF_INIT);
+    conn->tx_buf     = (uint8_t *)malloc(NETD_TCP_SNDBUF_INIT);
+    if (!conn->rx_buf || !conn->tx_buf) return -12 /* -ENOMEM */;
+    conn->rx_cap = NETD_TCP_RCVBUF_INIT;
+    conn->tx_cap = NETD_TCP_SNDBUF_INIT;
+    return 0;
+}
 
-    uint16_t local_port = (uint16_t)(NETD_TCP_EPHEMERAL_MIN +
-                                     (netd_rand32() % NETD_TCP_EPHEMERAL_SPAN));
-    sock->local_ip    = g_net.ip;
-    sock->local_port  = local_port;
-    sock->remote_ip   = req->dst_ip;
-    sock->remote_port = req->dst_port;
+// ---------------------------------------------------------------------
+// Phase 26: listener queues.
+// ---------------------------------------------------------------------
+static int tcp_aq_full(const netd_tcp_listener_t *l) {
+    return l->aq_tail - l->aq_head - l->aq_remote >= l->backlog;
+}
 
-    // Resolve ARP so we don't drop our own SYN. tx_ipv4_datagram handles
-    // the ARP-miss path (returns -EAGAIN + emits request). We'll retransmit
-    // via the TCP SYN timer on the next tick.
-    uint8_t syn_buf[TCP_HDR_LEN_MIN + 4];
-    size_t  syn_len = 0;
-    int cr = netd_tcp_connect(sock, netd_rand32(),
-                              syn_buf, sizeof(syn_buf), &syn_len,
-                              TCP_DEFAULT_RTO_MS,
-                              netd_rdtsc(), NETD_TICKS_PER_SEC);
-    if (cr < 0) {
-        netd_tcp_socket_free(&g_net.tcp, idx);
-        conn->in_use = 0;
-        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq, cr);
-        return;
+static void tcp_send_accept_resp(uint32_t client_idx, uint32_t req_seq,
+                                 libnet_tcp_accept_resp_t *resp) {
+    netd_client_t *c = &g_clients[client_idx];
+    if (!c->in_use) return;
+    resp->hdr.op  = LIBNET_OP_TCP_ACCEPT_RESP;
+    resp->hdr.seq = req_seq;
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    m.header.inline_len = (uint16_t)sizeof(*resp);
+    memcpy(m.inline_payload, resp, sizeof(*resp));
+    (void)client_send(c, &m, 200000000ull);
+}
+
+// Hand up to `max` queued children to `client_idx`: from here on they are
+// ordinary client sockets. Returns the number placed in `resp`.
+static uint16_t tcp_accept_pop(uint32_t slot, uint32_t client_idx,
+                               libnet_tcp_accept_resp_t *resp, uint16_t max) {
+    netd_tcp_listener_t *l = &g_tcp_listeners[slot];
+    uint16_t n = 0;
+    while (n < max && l->aq_head != l->aq_tail) {
+        netd_tcp_aq_ent_t e = l->aq[l->aq_head & (l->aq_cap - 1u)];
+        l->aq_head++;
+        if (e.socket_idx == NETD_TCP_AQ_REMOTE) {
+            // Phase 26: a worker's child; the worker hands it over. One
+            // reset meanwhile surfaces as EBADF on the client's first op.
+            // If ADOPT can't be sent, the worker resets the child when the
+            // next ADOPT skips past it (shard_adopt).
+            l->aq_remote--;
+            netd_shard_link_t *lk =
+                &g_shard.link[netd_shard_of_cookie(e.cookie, g_shard.count)];
+            uint32_t listen_cookie = g_tcp_conn[l->socket_idx].cookie;
+            if (!lk->up ||
+                shard_send(lk, NETD_SHARD_OP_ADOPT, client_idx, e.cookie,
+                           &listen_cookie, sizeof(listen_cookie), 0) < 0) {
+                continue;
+            }
+            resp->conns[n].socket_cookie = e.cookie;
+            resp->conns[n].remote_ip     = e.remote_ip;
+            resp->conns[n].remote_port   = e.remote_port;
+            resp->conns[n].local_port    = e.local_port;
+            n++;
+            continue;
+        }
+        netd_tcp_conn_t *conn = &g_tcp_conn[e.socket_idx];
+        if (!conn->in_use || conn->cookie != e.cookie ||
+            conn->parent != slot + 1u || !conn->queued) {
+            continue;   // Reset while it waited
+        }
+        conn->parent     = 0;
+        conn->queued     = 0;
+        conn->client_idx = client_idx;
+        const tcp_socket_t *sock = &g_net.tcp.sockets[e.socket_idx];
+        resp->conns[n].socket_cookie = conn->cookie;
+        resp->conns[n].remote_ip     = sock->remote_ip;
+        resp->conns[n].remote_port   = sock->remote_port;
+        resp->conns[n].local_port    = sock->local_port;
+        n++;
+    }
+    resp->count = n;
+    return n;
+}
+
+static void tcp_satisfy_pending_accept(uint32_t slot) {
+    for (uint32_t i = 0; i < NETD_MAX_PENDING_TCP_ACCEPT; i++) {
+        pending_tcp_accept_t *pa = &g_tcp_accepts[i];
+        if (!pa->in_use || pa->listener != slot) continue;
+        libnet_tcp_accept_resp_t resp;
+        memset(&resp, 0, sizeof(resp));
+        if (tcp_accept_pop(slot, pa->client_idx, &resp, pa->max_conns) == 0) {
+            return;     // Queue drained
+        }
+        tcp_send_accept_resp(pa->client_idx, pa->req_seq, &resp);
+        pa->in_use = 0;
     }
-    (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP, syn_buf, syn_len);
+}
+
+// A passive child reached ESTABLISHED (or CLOSE_WAIT, if its first data
+// came with a FIN): move it from the SYN queue to the accept queue. The
+// rx_tcp gate keeps the handshake from completing into a full queue.
+static void tcp_child_ready(int socket_idx) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[socket_idx];
+    if (!conn->parent || conn->queued) return;
+    uint32_t slot = conn->parent - 1u;
+    netd_tcp_listener_t *l = &g_tcp_listeners[slot];
+    l->syn_count--;
+    conn->queued = 1;
+    netd_tcp_aq_ent_t *e = &l->aq[l->aq_tail & (l->aq_cap - 1u)];
+    memset(e, 0, sizeof(*e));
+    e->socket_idx = (uint32_t)socket_idx;
+    e->cookie     = conn->cookie;
+    l->aq_tail++;
+    if (g_shard.id) {
+        // Phase 26: TCP_ACCEPT is served by the front; report the child.
+        // It stays queued here until the front hands it out (ADOPT). If
+        // the front never hears of it, nothing ever will: reset it.
+        const tcp_socket_t *sock = &g_net.tcp.sockets[socket_idx];
+        libnet_tcp_accept_ent_t ent;
+        ent.socket_cookie = conn->cookie;
+        ent.remote_ip     = sock->remote_ip;
+        ent.remote_port   = sock->remote_port;
+        ent.local_port    = sock->local_port;
+        if (shard_send(&g_shard.link[0], NETD_SHARD_OP_CHILD,
+                       conn->client_idx, g_tcp_conn[l->socket_idx].cookie,
+                       &ent, sizeof(ent), 0) < 0) {
+            l->aq_tail--;
+            tcp_child_reset(socket_idx);
+        }
+        return;
+    }
+    tcp_satisfy_pending_accept(slot);
+}
+
+// Allocate a child of listener socket `lidx` for the peer in `ip`/`pkt`,
+// left in LISTEN on the segment's local address (not hashed yet) and
+// counted in the SYN queue. Returns its index, or -1.
+static int tcp_child_alloc(int lidx, const ipv4_parsed_t *ip,
+                           const tcp_parsed_t *pkt) {
+    netd_tcp_conn_t *lconn = &g_tcp_conn[lidx];
+    uint32_t cookie = tcp_cookie_next();
+    int idx = netd_tcp_socket_alloc(&g_net.tcp, cookie);
+    if (idx < 0) return -1;
+    if (tcp_conn_setup(idx, lconn->client_idx, cookie) < 0) {
+        tcp_conn_release(idx);
+        return -1;
+    }
+    netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    conn->parent = lconn->listener;
+    g_tcp_listeners[lconn->listener - 1u].syn_count++;
+
+    tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+    (void)netd_tcp_listen(sock, ip->dst, pkt->dst_port);
+    sock->remote_ip   = ip->src;
+    sock->opts_offer  = TCP_OPT_F_ALL;
+    sock->rcv_wnd_max = NETD_TCP_RCVBUF_MAX;
+    sock->rcv_wnd     = conn->rx_cap;
+    return idx;
+}
+
+// Segment with no connection of its own, on a port somebody listens on:
+// a SYN starts a child (or, with the SYN queue full, gets a stateless
+// cookie SYN-ACK); a bare ACK may complete a cookie handshake. Anything
+// else is dropped, as for closed ports.
+static void tcp_rx_listen(const ipv4_parsed_t *ip, const tcp_parsed_t *pkt) {
+    if (pkt->flags & TCP_FLAG_RST) return;
+    int lidx = netd_tcp_find_listen(&g_net.tcp, ip->dst, pkt->dst_port);
+    if (lidx < 0) return;
+    netd_tcp_conn_t *lconn = &g_tcp_conn[lidx];
+    if (!lconn->in_use || !lconn->listener) return;
+    netd_tcp_listener_t *l = &g_tcp_listeners[lconn->listener - 1u];
+    if (tcp_aq_full(l)) return;
+
+    uint64_t now = netd_rdtsc();
+    uint32_t t = (uint32_t)(now / (NETD_TICKS_PER_SEC * NETD_TCP_COOKIE_PERIOD_S));
+    uint8_t  sa = pkt->flags & (TCP_FLAG_SYN | TCP_FLAG_ACK);
+
+    if (sa == TCP_FLAG_SYN) {
+        if (l->syn_count >= l->syn_backlog) {
+            if (!l->cookies) return;
+            uint32_t isn = netd_tcp_syncookie(&g_net.tcp, ip->dst, pkt->dst_port,
+                                              ip->src, pkt->src_port, pkt->seq,
+                                              pkt->opt_mss ? pkt->opt_mss
+                                                           : 536u, t);
+            uint8_t seg[TCP_HDR_LEN_MIN + 4];
+            size_t  n = netd_tcp_build(seg, ip->dst, ip->src,
+                                       pkt->dst_port, pkt->src_port,
+                                       isn, pkt->seq + 1u,
+                                       TCP_FLAG_SYN | TCP_FLAG_ACK,
+                                       (uint16_t)NETD_TCP_RCVBUF_INIT,
+                                       TCP_DEFAULT_MSS, NULL, 0);
+            (void)tx_ipv4_datagram(ip->src, IPPROTO_TCP, seg, n);
+            return;
+        }
+        int idx = tcp_child_alloc(lidx, ip, pkt);
+        if (idx < 0) return;
+        tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+        uint8_t resp_buf[TCP_HDR_LEN_MAX];
+        size_t  resp_len = 0;
+        (void)netd_tcp_on_segment(sock, pkt, now, NETD_TICKS_PER_SEC,
+                                  resp_buf, sizeof(resp_buf), &resp_len);
+        if (sock->state != TCP_STATE_SYN_RCVD ||
+            netd_tcp_hash_insert(&g_net.tcp, idx) < 0) {
+            tcp_conn_release(idx);
+            return;
+        }
+        g_tcp_conn[idx].tx_end = sock->snd_nxt;
+        if (resp_len > 0) {
+            (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP,
+                                   resp_buf, resp_len);
+        }
+        tcp_timer_arm(idx, now);
+        return;
+    }
+
+    if (sa != TCP_FLAG_ACK || !l->cookies) return;
+    uint16_t mss = 0;
+    if (netd_tcp_syncookie_check(&g_net.tcp, ip->dst, pkt->dst_port,
+                                 ip->src, pkt->src_port, pkt->seq - 1u,
+                                 pkt->ack - 1u, t, &mss) != 0) {
+        return;
+    }
+    int idx = tcp_child_alloc(lidx, ip, pkt);
+    if (idx < 0) return;
+    tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+    (void)netd_tcp_syncookie_accept(sock, pkt, mss, now, NETD_TICKS_PER_SEC);
+    if (netd_tcp_hash_insert(&g_net.tcp, idx) < 0) {
+        tcp_conn_release(idx);
+        return;
+    }
+    g_tcp_conn[idx].tx_end = sock->snd_nxt;
+    tcp_child_ready(idx);
+    // Data (or a FIN) riding on the ACK goes through the normal path now
+    // that the connection exists.
+    if (pkt->payload_len > 0 || (pkt->flags & TCP_FLAG_FIN)) rx_tcp(ip);
+}
+
+static void handle_tcp_open(netd_client_t *c, const chan_msg_user_t *in) {
+    const libnet_tcp_open_req_t *req =
+        (const libnet_tcp_open_req_t *)in->inline_payload;
+
+    if (!g_net.stack_running) {
+        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq,
+                          -101 /* -ENETUNREACH */);
+        return;
+    }
+    if (req->dst_port == 0) {
+        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq, -5);
+        return;
+    }
+
+    uint32_t client_idx = (uint32_t)(c - g_clients);
+    uint32_t cookie = tcp_cookie_next();
+
+    int idx = netd_tcp_socket_alloc(&g_net.tcp, cookie);
+    if (idx < 0) {
+        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq,
+                          -11 /* -EAGAIN — table full */);
+        return;
+    }
+    tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+    netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    if (tcp_conn_setup(idx, client_idx, cookie) < 0) {
+        tcp_conn_release(idx);
+        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq,
+                          -12 /* -ENOMEM */);
+        return;
+    }
+
+    sock->local_ip    = g_net.ip;
+    sock->remote_ip   = req->dst_ip;
+    sock->remote_port = req->dst_port;
+    // Phase 26: hashing the tuple also catches an ephemeral port that
+    // already carries a connection to the same peer; draw again. With
+    // several shards, also draw until the tuple steers to this one, so the
+    // peer's segments come back to the shard that holds the socket.
+    int hr = -2;
+    for (uint32_t tries = 0; tries < 16u * g_shard.count && hr == -2; tries++) {
+        sock->local_port = (uint16_t)(NETD_TCP_EPHEMERAL_MIN +
+                                      (netd_rand32() % NETD_TCP_EPHEMERAL_SPAN));
+        if (netd_shard_steer(g_shard.steer_seed, sock->local_ip,
+                             sock->local_port, sock->remote_ip,
+                             sock->remote_port, g_shard.count) != g_shard.id) {
+            continue;
+        }
+        hr = netd_tcp_hash_insert(&g_net.tcp, idx);
+    }
+    if (hr < 0) {
+        tcp_conn_release(idx);
+        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq,
+                          -98 /* -EADDRINUSE */);
+        return;
+    }
+
+    // Resolve ARP so we don't drop our own SYN. tx_ipv4_datagram handles
+    // the ARP-miss path (returns -EAGAIN + emits request). We'll retransmit
+    // via the TCP SYN timer on the next tick.
+    // Phase 26: offer window scaling (sized for the largest ring we may
+    // grow to), timestamps and SACK.
+    sock->opts_offer  = TCP_OPT_F_ALL;
+    sock->rcv_wnd_max = NETD_TCP_RCVBUF_MAX;
+    sock->rcv_wnd     = conn->rx_cap;
+    uint8_t syn_buf[TCP_HDR_LEN_MAX];
+    size_t  syn_len = 0;
+    int cr = netd_tcp_connect(sock, netd_rand32(),
+                              syn_buf, sizeof(syn_buf), &syn_len,
+                              TCP_DEFAULT_RTO_MS,
+                              netd_rdtsc(), NETD_TICKS_PER_SEC);
+    if (cr < 0) {
+        tcp_conn_release(idx);
+        client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq, cr);
+        return;
+    }
+    conn->tx_end = sock->snd_nxt;
+    (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP, syn_buf, syn_len);
+    tcp_timer_arm(idx, netd_rdtsc());
 
     // Record pending open.
     pending_tcp_open_t *po = NULL;
@@ -1249,8 +2382,7 @@ static void handle_tcp_open(netd_client_t *c, const chan_msg_user_t *in) {
     }
     if (!po) {
         // No room; fail the open synchronously.
-        conn->in_use = 0;
-        netd_tcp_socket_free(&g_net.tcp, idx);
+        tcp_conn_release(idx);
         client_send_error(c, LIBNET_OP_TCP_OPEN_RESP, req->hdr.seq, -11);
         return;
     }
@@ -1286,17 +2418,41 @@ static void handle_tcp_send(netd_client_t *c, const chan_msg_user_t *in) {
         goto send;
     }
 
-    uint8_t flags = TCP_FLAG_ACK | TCP_FLAG_PSH;
-    int tc = tcp_emit_segment(sock, sock->snd_nxt, sock->rcv_nxt, flags,
-                              req->payload, req->payload_len);
-    if (tc == -11 /* EAGAIN — ARP miss */) {
-        // Bubble up so the caller can retry once the ARP cache populates.
-        resp.status = -11;
+    netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    if (conn->shm) {
+        resp.status = -5;   // Attached: data goes through the tx ring
         goto send;
     }
-    if (tc < 0) { resp.status = tc; goto send; }
+    if (conn->fin_pending || conn->close_sent) {
+        resp.status = -32 /* EPIPE */;
+        goto send;
+    }
+
+    // Phase 26: queue into the tx ring (growing it if this send would not
+    // fit) and let tcp_output pace it out; the bytes stay put until ACKed.
+    uint32_t start  = tcp_tx_start(conn, sock);
+    uint32_t queued = conn->tx_end - start;
+    uint32_t need   = queued + (uint32_t)req->payload_len;
+    if (need > conn->tx_cap) {
+        uint32_t cap = conn->tx_cap;
+        while (cap < need && cap < NETD_TCP_SNDBUF_MAX) cap *= 2u;
+        uint8_t *nb = (cap >= need)
+                          ? tcp_ring_grow(conn->tx_buf, conn->tx_cap, cap,
+                                          start, queued)
+                          : NULL;
+        if (!nb) {
+            // Buffer full: the caller retries once ACKs drain it.
+            resp.status = -11 /* EAGAIN */;
+            goto send;
+        }
+        conn->tx_buf = nb;
+        conn->tx_cap = cap;
+    }
+    tcp_ring_copy_in(conn->tx_buf, conn->tx_cap, conn->tx_end,
+                     req->payload, (uint32_t)req->payload_len);
+    conn->tx_end += (uint32_t)req->payload_len;
+    tcp_output(idx, netd_rdtsc());
 
-    sock->snd_nxt += (uint32_t)req->payload_len;
     resp.status     = 0;
     resp.bytes_sent = req->payload_len;
 
@@ -1305,7 +2461,7 @@ send: {
         memset(&m, 0, sizeof(m));
         m.header.inline_len = (uint16_t)sizeof(resp);
         memcpy(m.inline_payload, &resp, sizeof(resp));
-        (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+        (void)client_send(c, &m, 200000000ull);
     }
 }
 
@@ -1319,17 +2475,27 @@ static void handle_tcp_recv(netd_client_t *c, const chan_msg_user_t *in) {
         return;
     }
     netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    if (conn->listener) {
+        client_send_error(c, LIBNET_OP_TCP_RECV_RESP, req->hdr.seq,
+                          -107 /* ENOTCONN */);
+        return;
+    }
+    if (conn->shm) {
+        client_send_error(c, LIBNET_OP_TCP_RECV_RESP, req->hdr.seq, -5);
+        return;
+    }
 
     uint16_t cap = req->max_bytes ? req->max_bytes : LIBNET_TCP_CHUNK_MAX;
     if (cap > LIBNET_TCP_CHUNK_MAX) cap = LIBNET_TCP_CHUNK_MAX;
-    uint16_t buffered = tcp_ring_bytes(conn);
+    uint32_t buffered = tcp_ring_bytes(conn);
     uint16_t flags = conn->peer_fin ? 1u : 0u;
 
     if (buffered > 0) {
         uint8_t buf[LIBNET_TCP_CHUNK_MAX];
-        uint16_t n = tcp_ring_pop(conn, buf, cap);
+        uint16_t n = (uint16_t)tcp_ring_pop(conn, buf, cap);
         tcp_send_recv_resp((uint32_t)(c - g_clients), req->hdr.seq,
                            0, buf, n, flags);
+        tcp_window_update(idx);
         return;
     }
     if (conn->peer_fin) {
@@ -1361,6 +2527,192 @@ static void handle_tcp_recv(netd_client_t *c, const chan_msg_user_t *in) {
                        (NETD_TICKS_PER_SEC / 1000u);
 }
 
+// Unbind: children still in either queue are reset (as close(2) on a
+// listening socket does), blocked accepts fail with ECONNABORTED.
+static void tcp_listener_close(int lidx) {
+    uint32_t slot = g_tcp_conn[lidx].listener - 1u;
+    netd_tcp_listener_t *l = &g_tcp_listeners[slot];
+    // Phase 26: the workers' instances go with it, and so do the children
+    // they still hold for its accept queue.
+    if (g_shard.id == 0) {
+        for (uint32_t s = 1; s < g_shard.count; s++) {
+            if (!g_shard.link[s].up) continue;
+            (void)shard_send(&g_shard.link[s], NETD_SHARD_OP_UNLISTEN, 0,
+                             g_tcp_conn[lidx].cookie, NULL, 0, 0);
+        }
+    }
+    for (uint32_t i = 0; i < TCP_MAX_SOCKETS; i++) {
+        netd_tcp_conn_t *conn = &g_tcp_conn[i];
+        if (!conn->in_use || conn->parent != slot + 1u) continue;
+        tcp_socket_t *sock = &g_net.tcp.sockets[i];
+        (void)tcp_emit_segment(sock, sock->snd_nxt, sock->rcv_nxt,
+                               TCP_FLAG_RST | TCP_FLAG_ACK, NULL, 0);
+        tcp_conn_release((int)i);
+    }
+    for (uint32_t i = 0; i < NETD_MAX_PENDING_TCP_ACCEPT; i++) {
+        pending_tcp_accept_t *pa = &g_tcp_accepts[i];
+        if (!pa->in_use || pa->listener != slot) continue;
+        libnet_tcp_accept_resp_t resp;
+        memset(&resp, 0, sizeof(resp));
+        resp.status = -103 /* ECONNABORTED */;
+        tcp_send_accept_resp(pa->client_idx, pa->req_seq, &resp);
+        pa->in_use = 0;
+    }
+    free(l->aq);
+    memset(l, 0, sizeof(*l));
+    tcp_conn_release(lidx);
+}
+
+// LISTEN socket plus listener slot under `cookie`. Phase 26: the front's
+// accept queue also takes the children every worker instance reports, so
+// it is sized for all of their backlogs. Returns 0 or a negative errno.
+static int tcp_listener_open(uint32_t client_idx, uint32_t cookie,
+                             uint32_t local_ip, uint16_t local_port,
+                             uint16_t backlog, uint16_t syn_backlog,
+                             uint8_t cookies) {
+    netd_tcp_listener_t *l = NULL;
+    for (uint32_t i = 0; i < NETD_MAX_TCP_LISTENERS; i++) {
+        if (!g_tcp_listeners[i].in_use) { l = &g_tcp_listeners[i]; break; }
+    }
+    if (!l) return -11 /* EAGAIN */;
+
+    uint32_t aq_want = (uint32_t)backlog * (g_shard.id == 0 ? g_shard.count : 1u);
+    uint32_t aq_cap = 1;
+    while (aq_cap < aq_want) aq_cap <<= 1;
+
+    int idx = netd_tcp_socket_alloc(&g_net.tcp, cookie);
+    if (idx < 0) return -11;
+    netd_tcp_aq_ent_t *aq =
+        (netd_tcp_aq_ent_t *)malloc(aq_cap * sizeof(netd_tcp_aq_ent_t));
+    if (!aq) {
+        netd_tcp_socket_free(&g_net.tcp, idx);
+        return -12 /* ENOMEM */;
+    }
+    // A listener has no rings: it never carries data.
+    netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    memset(conn, 0, sizeof(*conn));
+    conn->in_use     = 1;
+    conn->client_idx = client_idx;
+    conn->cookie     = cookie;
+    conn->listener   = (uint16_t)(l - g_tcp_listeners + 1);
+
+    tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+    (void)netd_tcp_listen(sock, local_ip, local_port);
+    if (netd_tcp_hash_insert(&g_net.tcp, idx) < 0) {
+        free(aq);
+        tcp_conn_release(idx);
+        return -98 /* EADDRINUSE */;
+    }
+    memset(l, 0, sizeof(*l));
+    l->in_use      = 1;
+    l->cookies     = cookies;
+    l->backlog     = backlog;
+    l->syn_backlog = syn_backlog;
+    l->socket_idx  = (uint32_t)idx;
+    l->aq_cap      = aq_cap;
+    l->aq          = aq;
+    return 0;
+}
+
+static void handle_tcp_listen(netd_client_t *c, const chan_msg_user_t *in) {
+    const libnet_tcp_listen_req_t *req =
+        (const libnet_tcp_listen_req_t *)in->inline_payload;
+    libnet_tcp_listen_resp_t resp;
+    memset(&resp, 0, sizeof(resp));
+    resp.hdr.op  = LIBNET_OP_TCP_LISTEN_RESP;
+    resp.hdr.seq = req->hdr.seq;
+
+    if (req->local_port == 0) { resp.status = -5; goto send; }
+
+    uint16_t backlog = req->backlog ? req->backlog : LIBNET_TCP_BACKLOG_DEFAULT;
+    if (backlog > LIBNET_TCP_BACKLOG_MAX) backlog = LIBNET_TCP_BACKLOG_MAX;
+    uint16_t syn_backlog = req->syn_backlog ? req->syn_backlog : backlog;
+    if (syn_backlog > LIBNET_TCP_BACKLOG_MAX) syn_backlog = LIBNET_TCP_BACKLOG_MAX;
+    uint8_t cookies = (req->flags & LIBNET_TCP_LISTEN_FLAG_NO_COOKIES) ? 0 : 1;
+
+    uint32_t cookie = tcp_cookie_next();
+    resp.status = tcp_listener_open((uint32_t)(c - g_clients), cookie,
+                                    req->local_ip, req->local_port,
+                                    backlog, syn_backlog, cookies);
+    if (resp.status < 0) goto send;
+
+    // Phase 26: every shard listens too, under the same cookie. A worker
+    // that cannot just never sees its share of SYNs answered.
+    netd_shard_listen_t sl;
+    memset(&sl, 0, sizeof(sl));
+    sl.local_ip    = req->local_ip;
+    sl.local_port  = req->local_port;
+    sl.backlog     = backlog;
+    sl.syn_backlog = syn_backlog;
+    sl.cookies     = cookies;
+    for (uint32_t s = 1; s < g_shard.count; s++) {
+        if (!g_shard.link[s].up) continue;
+        (void)shard_send(&g_shard.link[s], NETD_SHARD_OP_LISTEN,
+                         (uint32_t)(c - g_clients), cookie, &sl, sizeof(sl),
+                         0);
+    }
+
+    resp.listen_cookie = cookie;
+    resp.local_port    = req->local_port;
+    resp.backlog       = backlog;
+
+send: {
+        chan_msg_user_t m;
+        memset(&m, 0, sizeof(m));
+        m.header.inline_len = (uint16_t)sizeof(resp);
+        memcpy(m.inline_payload, &resp, sizeof(resp));
+        (void)client_send(c, &m, 200000000ull);
+    }
+}
+
+static void handle_tcp_accept(netd_client_t *c, const chan_msg_user_t *in) {
+    const libnet_tcp_accept_req_t *req =
+        (const libnet_tcp_accept_req_t *)in->inline_payload;
+    uint32_t client_idx = (uint32_t)(c - g_clients);
+
+    int idx = find_socket_by_cookie(req->listen_cookie);
+    if (idx < 0) {
+        client_send_error(c, LIBNET_OP_TCP_ACCEPT_RESP, req->hdr.seq, -9);
+        return;
+    }
+    if (!g_tcp_conn[idx].listener) {
+        client_send_error(c, LIBNET_OP_TCP_ACCEPT_RESP, req->hdr.seq, -5);
+        return;
+    }
+    uint32_t slot = g_tcp_conn[idx].listener - 1u;
+    uint16_t max = req->max_conns ? req->max_conns : 1u;
+    if (max > LIBNET_TCP_ACCEPT_BATCH_MAX) max = LIBNET_TCP_ACCEPT_BATCH_MAX;
+
+    libnet_tcp_accept_resp_t resp;
+    memset(&resp, 0, sizeof(resp));
+    if (tcp_accept_pop(slot, client_idx, &resp, max) > 0) {
+        tcp_send_accept_resp(client_idx, req->hdr.seq, &resp);
+        return;
+    }
+    if (req->timeout_ms == 0) {
+        client_send_error(c, LIBNET_OP_TCP_ACCEPT_RESP, req->hdr.seq,
+                          -11 /* EAGAIN */);
+        return;
+    }
+
+    pending_tcp_accept_t *pa = NULL;
+    for (uint32_t i = 0; i < NETD_MAX_PENDING_TCP_ACCEPT; i++) {
+        if (!g_tcp_accepts[i].in_use) { pa = &g_tcp_accepts[i]; break; }
+    }
+    if (!pa) {
+        client_send_error(c, LIBNET_OP_TCP_ACCEPT_RESP, req->hdr.seq, -11);
+        return;
+    }
+    pa->in_use       = 1;
+    pa->max_conns    = max;
+    pa->client_idx   = client_idx;
+    pa->listener     = slot;
+    pa->req_seq      = req->hdr.seq;
+    pa->deadline_tsc = netd_rdtsc() +
+                       (uint64_t)req->timeout_ms *
+                       (NETD_TICKS_PER_SEC / 1000u);
+}
+
 static void handle_tcp_close(netd_client_t *c, const chan_msg_user_t *in) {
     const libnet_tcp_close_req_t *req =
         (const libnet_tcp_close_req_t *)in->inline_payload;
@@ -1373,14 +2725,20 @@ static void handle_tcp_close(netd_client_t *c, const chan_msg_user_t *in) {
     if (idx < 0) { resp.status = -9; goto send; }
     tcp_socket_t *sock = &g_net.tcp.sockets[idx];
     netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    if (conn->listener) {
+        tcp_listener_close(idx);
+        resp.status = 0;
+        goto send;
+    }
 
-    uint8_t fin_buf[TCP_HDR_LEN_MIN + 4];
-    size_t  fin_len = 0;
-    int cr = netd_tcp_close(sock, fin_buf, sizeof(fin_buf), &fin_len);
-    if (cr == 0 && fin_len > 0) {
-        (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP,
-                               fin_buf, fin_len);
-        conn->close_sent = 1;
+    // Phase 26: the FIN queues behind any unsent bytes; tcp_output sends it
+    // once the tx ring has drained. An attached client's last bytes are
+    // only in the shared ring until pulled.
+    tcp_shm_pull(idx);
+    if ((sock->state == TCP_STATE_ESTABLISHED ||
+         sock->state == TCP_STATE_CLOSE_WAIT) && !conn->close_sent) {
+        conn->fin_pending = 1;
+        tcp_output(idx, netd_rdtsc());
     } else if (sock->state == TCP_STATE_CLOSED) {
         // Already closed; acceptable.
     }
@@ -1391,7 +2749,7 @@ send: {
         memset(&m, 0, sizeof(m));
         m.header.inline_len = (uint16_t)sizeof(resp);
         memcpy(m.inline_payload, &resp, sizeof(resp));
-        (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+        (void)client_send(c, &m, 200000000ull);
     }
 }
 
@@ -1407,51 +2765,199 @@ static void handle_tcp_status(netd_client_t *c, const chan_msg_user_t *in) {
     if (idx < 0) { resp.status = -9; goto send; }
     tcp_socket_t *sock = &g_net.tcp.sockets[idx];
     netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    tcp_shm_pull(idx);
     resp.status      = 0;
     resp.state       = sock->state;
     resp.peer_fin    = conn->peer_fin;
     resp.rx_buffered = tcp_ring_bytes(conn);
-    resp.tx_pending  = sock->snd_nxt - sock->snd_una;
+    resp.tx_pending  = conn->tx_end - tcp_tx_start(conn, sock);
 
 send: {
         chan_msg_user_t m;
         memset(&m, 0, sizeof(m));
         m.header.inline_len = (uint16_t)sizeof(resp);
         memcpy(m.inline_payload, &resp, sizeof(resp));
-        (void)syscall_chan_send(c->wr_resp, &m, 200000000ull);
+        (void)client_send(c, &m, 200000000ull);
     }
 }
 
-static void tcp_tick(uint64_t now_tsc) {
-    // Per-socket timer tick: retransmit pending SYN / data, drive TIME_WAIT
-    // expiry. Data retransmit buffer is tiny (24 B for the SYN option) —
-    // data resends on snd_nxt advancement + netd_tcp_on_segment's ACK path
-    // cover the rest for MVP.
-    for (uint32_t i = 0; i < TCP_MAX_SOCKETS; i++) {
-        netd_tcp_conn_t *conn = &g_tcp_conn[i];
-        if (!conn->in_use) continue;
-        tcp_socket_t *sock = &g_net.tcp.sockets[i];
+// Close a VMO handle we hold no mapping for: VMO_MAP_RETIRE consumes it
+// even if the map fails, and the one-page read-only mapping faults nothing.
+static void netd_vmo_drop(cap_token_u_t vmo) {
+    long va = syscall_vmo_map(vmo, 0, 0, 4096u, PROT_READ | VMO_MAP_RETIRE);
+    if (va > 0) (void)syscall_vmo_unmap((uint64_t)va, 4096u);
+}
 
-        uint8_t prev_state = sock->state;
-        uint8_t retx_buf[TCP_HDR_LEN_MIN + 4];
-        size_t  retx_len = 0;
-        (void)netd_tcp_tick(sock, now_tsc, NETD_TICKS_PER_SEC,
-                             retx_buf, sizeof(retx_buf), &retx_len);
-        if (retx_len > 0) {
-            (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP,
-                                   retx_buf, retx_len);
+static void handle_tcp_shm_attach(netd_client_t *c, const chan_msg_user_t *in) {
+    const libnet_tcp_shm_attach_req_t *req =
+        (const libnet_tcp_shm_attach_req_t *)in->inline_payload;
+    libnet_tcp_shm_attach_resp_t resp;
+    memset(&resp, 0, sizeof(resp));
+    resp.hdr.op  = LIBNET_OP_TCP_SHM_ATTACH_RESP;
+    resp.hdr.seq = req->hdr.seq;
+    cap_token_u_t clone = { .raw = 0 };
+
+    // Only the owning client may attach: the rings expose the socket's
+    // buffered bytes, so another client's cookie reads as unknown.
+    int idx = find_socket_by_cookie(req->socket_cookie);
+    if (idx < 0 || g_tcp_conn[idx].client_idx != (uint32_t)(c - g_clients)) {
+        resp.status = -9;
+        goto send;
+    }
+    tcp_socket_t *sock = &g_net.tcp.sockets[idx];
+    netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    if (conn->listener || conn->shm) { resp.status = -5; goto send; }
+    if ((sock->state != TCP_STATE_ESTABLISHED &&
+         sock->state != TCP_STATE_CLOSE_WAIT) ||
+        conn->fin_pending || conn->close_sent) {
+        resp.status = -107 /* ENOTCONN */;
+        goto send;
+    }
+
+    // Fixed sizes from here on, never below what the private rings hold.
+    uint32_t want[2] = { req->rx_bytes, req->tx_bytes };
+    uint32_t have[2] = { conn->rx_cap, conn->tx_cap };
+    uint32_t cap[2];
+    for (int d = 0; d < 2; d++) {
+        uint32_t w = want[d] ? want[d] : LIBNET_TCP_SHM_RING_DEFAULT;
+        if (w > LIBNET_TCP_SHM_RING_MAX) w = LIBNET_TCP_SHM_RING_MAX;
+        cap[d] = have[d];
+        while (cap[d] < w) cap[d] <<= 1;
+    }
+    uint32_t bytes = LIBNET_TCP_SHM_CTL_BYTES + cap[0] + cap[1];
+
+    // Clone first, then map with VMO_MAP_RETIRE: netd keeps no handle, so
+    // the ring pages go when both sides have unmapped and a socket costs no
+    // handle-table slot once it is released.
+    long h = syscall_vmo_create(bytes, VMO_ZEROED | VMO_ONDEMAND);
+    if (h <= 0) { resp.status = -12 /* ENOMEM */; goto send; }
+    cap_token_u_t vmo = { .raw = (uint64_t)h };
+    long cl = syscall_vmo_clone(vmo, VMO_CLONE_SHARED);
+    if (cl <= 0) {
+        netd_vmo_drop(vmo);
+        resp.status = -12;
+        goto send;
+    }
+    long va = syscall_vmo_map(vmo, 0, 0, bytes,
+                              PROT_READ | PROT_WRITE | VMO_MAP_RETIRE);
+    if (va <= 0) {
+        netd_vmo_drop((cap_token_u_t){ .raw = (uint64_t)cl });
+        resp.status = -12;
+        goto send;
+    }
+    clone.raw = (uint64_t)cl;
+
+    // Move what the private rings hold — rx out-of-order bytes included —
+    // to the same sequence positions in the shared ones.
+    uint8_t *base = (uint8_t *)(uintptr_t)va;
+    uint8_t *rx = base + LIBNET_TCP_SHM_CTL_BYTES;
+    uint8_t *tx = rx + cap[0];
+    uint32_t tx_start = tcp_tx_start(conn, sock);
+    tcp_ring_move(rx, cap[0], conn->rx_buf, conn->rx_cap,
+                  conn->rx_tail, conn->rx_cap);
+    tcp_ring_move(tx, cap[1], conn->tx_buf, conn->tx_cap,
+                  tx_start, conn->tx_end - tx_start);
+    free(conn->rx_buf);
+    free(conn->tx_buf);
+    conn->rx_buf    = rx;
+    conn->tx_buf    = tx;
+    conn->rx_cap    = cap[0];
+    conn->tx_cap    = cap[1];
+    conn->shm       = (libnet_tcp_shm_ctl_t *)base;
+    conn->shm_bytes = bytes;
+    conn->shm->rx_cons = conn->rx_tail;
+    conn->shm->tx_prod = conn->tx_end;
+    (void)tcp_shm_push(idx);
+    tcp_window_update(idx);    // The ring may have grown
+    tcp_timer_arm(idx, netd_rdtsc());
+
+    resp.status    = 0;
+    resp.rx_bytes  = cap[0];
+    resp.tx_bytes  = cap[1];
+    resp.map_bytes = bytes;
+
+send: {
+        chan_msg_user_t m;
+        memset(&m, 0, sizeof(m));
+        m.header.inline_len = (uint16_t)sizeof(resp);
+        memcpy(m.inline_payload, &resp, sizeof(resp));
+        if (clone.raw) {
+            m.header.nhandles = 1;
+            m.handles[0]      = clone.raw;
         }
-        if (sock->state != prev_state) {
-            tcp_on_socket_state_change((int)i);
+        // A failed send leaves the clone with us; close it.
+        if (client_send(c, &m, 200000000ull) < 0 && clone.raw) {
+            netd_vmo_drop(clone);
         }
+    }
+}
 
-        // Garbage-collect CLOSED sockets.
-        if (sock->state == TCP_STATE_CLOSED && sock->owner_cookie != 0) {
-            netd_tcp_socket_free(&g_net.tcp, (int)i);
-            conn->in_use = 0;
-        }
+// Doorbell from a client: its side of an attached socket moved. Never
+// answered.
+static void handle_tcp_shm_kick(netd_client_t *c, const chan_msg_user_t *in) {
+    const libnet_tcp_shm_kick_t *k =
+        (const libnet_tcp_shm_kick_t *)in->inline_payload;
+    int idx = find_socket_by_cookie(k->socket_cookie);
+    if (idx < 0 || g_tcp_conn[idx].client_idx != (uint32_t)(c - g_clients)) {
+        return;
+    }
+    tcp_shm_sync(idx, netd_rdtsc());
+}
+
+// One socket whose deadline came up: retransmit pending SYN, drive
+// TIME_WAIT expiry. Phase 26: a data RTO / persist expiry only rewinds
+// snd_nxt; tcp_output then resends from the tx ring.
+static void tcp_tick_socket(int i, uint64_t now_tsc) {
+    netd_tcp_conn_t *conn = &g_tcp_conn[i];
+    if (!conn->in_use || conn->listener) return;
+    tcp_socket_t *sock = &g_net.tcp.sockets[i];
+
+    // Phase 26: a half-open child whose last SYN-ACK retry went
+    // unanswered leaves the SYN queue.
+    if (sock->state == TCP_STATE_SYN_RCVD &&
+        sock->rto_ms >= NETD_TCP_SYNACK_GIVEUP_MS &&
+        sock->retx_expiry_tsc && now_tsc >= sock->retx_expiry_tsc) {
+        tcp_conn_release(i);
+        return;
     }
 
+    uint8_t prev_state = sock->state;
+    uint8_t retx_buf[TCP_HDR_LEN_MAX];
+    size_t  retx_len = 0;
+    tcp_shm_pull(i);
+    sock->rcv_wnd = tcp_rx_free(conn);
+    (void)netd_tcp_tick(sock, now_tsc, NETD_TICKS_PER_SEC,
+                         retx_buf, sizeof(retx_buf), &retx_len);
+    if (retx_len > 0) {
+        (void)tx_ipv4_datagram(sock->remote_ip, IPPROTO_TCP,
+                               retx_buf, retx_len);
+    }
+    if (sock->state != prev_state) {
+        tcp_on_socket_state_change(i);
+    }
+    tcp_output(i, now_tsc);
+    // Also the backstop for a doorbell lost to a full channel.
+    tcp_shm_sync(i, now_tsc);
+
+    // Garbage-collect CLOSED sockets.
+    if (conn->in_use && sock->state == TCP_STATE_CLOSED &&
+        sock->owner_cookie != 0) {
+        tcp_conn_release(i);
+    }
+}
+
+#define NETD_TCP_TICK_BATCH  64u
+
+static void tcp_tick(uint64_t now_tsc) {
+    // Phase 26: the wheel hands back only the sockets with a deadline due,
+    // so an idle connection costs nothing per tick.
+    uint32_t due[NETD_TCP_TICK_BATCH];
+    uint32_t n;
+    do {
+        n = netd_twheel_expire(&g_tcp_wheel, now_tsc, due, NETD_TCP_TICK_BATCH);
+        for (uint32_t k = 0; k < n; k++) tcp_tick_socket((int)due[k], now_tsc);
+    } while (n == NETD_TCP_TICK_BATCH);
+
     // Pending opens: fire -ETIMEDOUT on deadline.
     for (uint32_t i = 0; i < NETD_MAX_PENDING_TCP_OPEN; i++) {
         pending_tcp_open_t *po = &g_tcp_opens[i];
@@ -1460,9 +2966,7 @@ static void tcp_tick(uint64_t now_tsc) {
         tcp_send_open_resp(-1, po->client_idx, po->req_seq,
                            -110 /* ETIMEDOUT */);
         // Release the half-open socket.
-        netd_tcp_conn_t *conn = &g_tcp_conn[po->socket_idx];
-        conn->in_use = 0;
-        netd_tcp_socket_free(&g_net.tcp, (int)po->socket_idx);
+        tcp_conn_release((int)po->socket_idx);
         po->in_use = 0;
     }
 
@@ -1475,12 +2979,30 @@ static void tcp_tick(uint64_t now_tsc) {
                            -110 /* ETIMEDOUT */, NULL, 0, 0);
         pr->in_use = 0;
     }
+
+    // Pending accepts: timeout.
+    for (uint32_t i = 0; i < NETD_MAX_PENDING_TCP_ACCEPT; i++) {
+        pending_tcp_accept_t *pa = &g_tcp_accepts[i];
+        if (!pa->in_use) continue;
+        if ((int64_t)(now_tsc - pa->deadline_tsc) < 0) continue;
+        libnet_tcp_accept_resp_t resp;
+        memset(&resp, 0, sizeof(resp));
+        resp.status = -110 /* ETIMEDOUT */;
+        tcp_send_accept_resp(pa->client_idx, pa->req_seq, &resp);
+        pa->in_use = 0;
+    }
 }
 
 static int client_handle_message(netd_client_t *c, const chan_msg_user_t *m) {
     uint16_t op = 0;
     uint32_t seq = 0;
     if (libnet_msg_unpack_header(m, &op, &seq) < 0) return -5;
+    // Phase 26: a socket op runs on the shard that holds the socket.
+    uint32_t shard = shard_route(op, m);
+    if (shard != g_shard.id) {
+        shard_forward(shard, c, m, op, seq);
+        return 0;
+    }
     switch (op) {
         case LIBNET_OP_HELLO_REQ:      handle_hello(c, m);       break;
         case LIBNET_OP_NET_QUERY_REQ:  handle_net_query(c, m);   break;
@@ -1493,6 +3015,10 @@ static int client_handle_message(netd_client_t *c, const chan_msg_user_t *m) {
         case LIBNET_OP_TCP_SEND_REQ:   handle_tcp_send(c, m);    break;
         case LIBNET_OP_TCP_RECV_REQ:   handle_tcp_recv(c, m);    break;
         case LIBNET_OP_TCP_STATUS_REQ: handle_tcp_status(c, m);  break;
+        case LIBNET_OP_TCP_LISTEN_REQ: handle_tcp_listen(c, m);  break;
+        case LIBNET_OP_TCP_ACCEPT_REQ: handle_tcp_accept(c, m);  break;
+        case LIBNET_OP_TCP_SHM_ATTACH_REQ: handle_tcp_shm_attach(c, m); break;
+        case LIBNET_OP_TCP_SHM_KICK_REQ:   handle_tcp_shm_kick(c, m);   break;
         default:
             client_send_error(c, op | LIBNET_OP_MASK_RESP, seq,
                               -6 /* -ENOSYS */);
@@ -1504,52 +3030,110 @@ static int client_handle_message(netd_client_t *c, const chan_msg_user_t *m) {
 static void clients_dispatch_tick(void) {
     for (uint32_t i = 0; i < NETD_MAX_CLIENTS; i++) {
         netd_client_t *c = &g_clients[i];
-        if (!c->in_use) continue;
-        for (int drain = 0; drain < 8; drain++) {
-            chan_msg_user_t m;
-            memset(&m, 0, sizeof(m));
-            long rc = syscall_chan_recv(c->rd_req, &m, 0 /*non-blocking*/);
-            if (rc == -32 /*-EPIPE*/) {
-                client_release(c);
-                break;
-            }
-            if (rc < 0) break;   // EAGAIN / ETIMEDOUT
-            (void)client_handle_message(c, &m);
+        // A worker's stand-ins have no request channel to drain.
+        if (!c->in_use || c->standin) continue;
+        // Up to 8 requests per client per tick, drained in one RECVV.
+        static chan_msg_user_t batch[8];
+        long n = syscall_chan_recvv(c->rd_req, batch, 8, 0 /*non-blocking*/);
+        if (n == -32 /*-EPIPE*/) {
+            client_release(c);
+            continue;
+        }
+        for (long k = 0; k < n && c->in_use; k++) {   // n < 0: EAGAIN / ETIMEDOUT
+            (void)client_handle_message(c, &batch[k]);
         }
     }
 }
 
 // =====================================================================
-// Rawframe RX poll — drain all pending RX_NOTIFYs in a tick.
+// Rawframe RX poll — drain all pending RX_NOTIFYs (Phase 26: or the
+// shared rx ring) in a tick.
 // =====================================================================
-static void rawframe_poll_rx(void) {
+_Static_assert(NETD_CSUM_IP_OK == RAWFRAME_RX_IP_CSUM_OK &&
+               NETD_CSUM_L4_OK == RAWFRAME_RX_L4_CSUM_OK,
+               "netd checksum verdict bits drift from rawframe");
+
+static inline const uint8_t *rx_slot_va(uint32_t slot) {
+    return (const uint8_t *)(uintptr_t)(g_net.rx_ring_va +
+                                        (uint64_t)slot * g_net.slot_size);
+}
+
+// The NIC's checksum verdict, when the driver offers one.
+static inline uint8_t rx_nic_csum(uint8_t flags) {
+    return (g_net.nic_features & RAWFRAME_FEAT_RX_CSUM) ? flags : 0;
+}
+
+// Copy one notified frame out of the shared rx ring and dispatch it. The
+// driver recycles a notified slot straight away, so it cannot be parsed
+// in place on this path.
+static void rx_slot_frame(const rawframe_slot_msg_t *sm) {
+    if (sm->slot >= g_net.slot_count) return;
+    if (sm->length == 0 || sm->length > g_net.slot_size) return;
+    uint8_t frame_copy[ETH_MAX_FRAME];
+    size_t  flen = (sm->length > sizeof(frame_copy)) ?
+                   sizeof(frame_copy) : sm->length;
+    memcpy(frame_copy, rx_slot_va(sm->slot), flen);
+    rx_dispatch_frame(frame_copy, flen, rx_nic_csum(sm->flags));
+}
+
+// Phase 26: parse every frame the driver has published straight from its
+// slot (the slot stays ours until rx_cons passes it), releasing them every
+// NETD_RX_RELEASE_BATCH so the driver can refill the NIC mid-burst. Then
+// arm rx_kick and look again: a batch published before the arm landed
+// sent no kick. Returns 1 if frames are still waiting.
+#define NETD_RX_RELEASE_BATCH  32u
+
+static int rx_ring_poll(void) {
+    rawframe_ring_ctl_t *r = g_net.ring;
+    const rawframe_ring_ent_t *ents = rawframe_ring_rx(r);
+    uint32_t prod = __atomic_load_n(&r->rx_prod, __ATOMIC_ACQUIRE);
+    if (prod - g_net.rx_cons > g_net.slot_count) prod = g_net.rx_cons;
+    uint32_t done = 0;
+    while (g_net.rx_cons != prod) {
+        const rawframe_ring_ent_t *e = &ents[g_net.rx_cons % g_net.slot_count];
+        if (e->slot < g_net.slot_count && e->length != 0 &&
+            e->length <= g_net.slot_size) {
+            size_t flen = (e->length > ETH_MAX_FRAME) ? ETH_MAX_FRAME : e->length;
+            rx_dispatch_frame(rx_slot_va(e->slot), flen, rx_nic_csum(e->flags));
+        }
+        g_net.rx_cons++;
+        if (++done % NETD_RX_RELEASE_BATCH == 0) {
+            __atomic_store_n(&r->rx_cons, g_net.rx_cons, __ATOMIC_RELEASE);
+        }
+    }
+    if (done) __atomic_store_n(&r->rx_cons, g_net.rx_cons, __ATOMIC_RELEASE);
+    __atomic_store_n(&r->rx_kick, 1u, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&r->rx_prod, __ATOMIC_SEQ_CST) != g_net.rx_cons;
+}
+
+static void rawframe_handle_msg(const rawframe_slot_msg_t *sm) {
+    if (sm->op == RAWFRAME_OP_RX_NOTIFY) {
+        rx_slot_frame(sm);
+    } else if (sm->op == RAWFRAME_OP_LINK_UP) {
+        g_net.link_up = 1;
+        printf("[netd] rawframe: link UP\n");
+        shard_push_config();
+        if (g_net.dhcp.state == DHCP_STATE_INIT) dhcp_kickoff();
+    } else if (sm->op == RAWFRAME_OP_LINK_DOWN) {
+        g_net.link_up = 0;
+        g_net.stack_running = 0;
+        printf("[netd] rawframe: link DOWN\n");
+        shard_push_config();
+    }
+    // RAWFRAME_OP_RX_KICK only wakes us; rx_ring_poll does the work.
+}
+
+// Returns 1 if ring frames are still waiting (don't sleep).
+static int rawframe_poll_rx(void) {
     for (int drain = 0; drain < 32; drain++) {
         chan_msg_user_t m;
         memset(&m, 0, sizeof(m));
         long rc = syscall_chan_recv(g_net.rawframe_rd_resp, &m, 0);
         if (rc < 0) break;
         if (m.header.inline_len < sizeof(rawframe_slot_msg_t)) continue;
-        rawframe_slot_msg_t *sm = (rawframe_slot_msg_t *)m.inline_payload;
-        if (sm->op == RAWFRAME_OP_RX_NOTIFY) {
-            if (sm->slot >= g_net.slot_count) continue;
-            if (sm->length == 0 || sm->length > g_net.slot_size) continue;
-            uint8_t frame_copy[ETH_MAX_FRAME];
-            size_t  flen = (sm->length > sizeof(frame_copy)) ?
-                           sizeof(frame_copy) : sm->length;
-            const uint8_t *src = (const uint8_t *)(uintptr_t)
-                (g_net.rx_ring_va + (uint64_t)sm->slot * g_net.slot_size);
-            memcpy(frame_copy, src, flen);
-            rx_dispatch_frame(frame_copy, flen);
-        } else if (sm->op == RAWFRAME_OP_LINK_UP) {
-            g_net.link_up = 1;
-            printf("[netd] rawframe: link UP\n");
-            if (g_net.dhcp.state == DHCP_STATE_INIT) dhcp_kickoff();
-        } else if (sm->op == RAWFRAME_OP_LINK_DOWN) {
-            g_net.link_up = 0;
-            g_net.stack_running = 0;
-            printf("[netd] rawframe: link DOWN\n");
-        }
+        rawframe_handle_msg((const rawframe_slot_msg_t *)m.inline_payload);
     }
+    return g_net.ring ? rx_ring_poll() : 0;
 }
 
 // =====================================================================
@@ -1572,6 +3156,10 @@ static void service_accept_tick(libnet_service_ctx_t *svc) {
         c->connection_id = srv.connection_id;
         c->rd_req        = srv.rd_req;
         c->wr_resp       = srv.wr_resp;
+        if (g_ws) {
+            (void)syscall_waitset_ctl(g_ws, WAITSET_CTL_ADD, c->rd_req.raw,
+                                      WAITSET_EV_READABLE, (uint64_t)slot);
+        }
         printf("[netd] client +%d: pid=%d conn=%u\n",
                slot, srv.connector_pid, (unsigned)srv.connection_id);
     }
@@ -1589,7 +3177,595 @@ static uint64_t fnv1a_hash64_local(const char *s) {
     return h;
 }
 
-void _start(void) {
+// =====================================================================
+// Phase 26: shard links. Everything that crosses between the front and a
+// worker: the two frame rings, the link channel messages, and the client
+// traffic relayed over it.
+// =====================================================================
+static int shard_msg_build(chan_msg_user_t *m, uint16_t op, uint32_t client_idx,
+                           uint32_t arg, const void *body, size_t len,
+                           cap_token_raw_t handle) {
+    if (sizeof(netd_shard_hdr_t) + len > CHAN_MSG_INLINE_MAX) return -5;
+    memset(m, 0, sizeof(*m));
+    netd_shard_hdr_t *h = (netd_shard_hdr_t *)m->inline_payload;
+    h->op         = op;
+    h->client_idx = (uint16_t)client_idx;
+    h->arg        = arg;
+    if (len) memcpy(m->inline_payload + sizeof(*h), body, len);
+    m->header.inline_len = (uint16_t)(sizeof(*h) + len);
+    if (handle) {
+        m->header.nhandles = 1;
+        m->handles[0]      = handle;
+    }
+    return 0;
+}
+
+// Send now, or behind whatever the backlog already holds so the peer sees
+// link messages in order. 0 means sent or queued; a queued handle stays in
+// our table until shard_flush_links delivers (or closes) it. On failure the
+// handle is still the caller's.
+static long shard_send(netd_shard_link_t *lk, uint16_t op, uint32_t client_idx,
+                       uint32_t arg, const void *body, size_t len,
+                       cap_token_raw_t handle) {
+    chan_msg_user_t m;
+    if (shard_msg_build(&m, op, client_idx, arg, body, len, handle) < 0) return -5;
+    if (lk->q_head == lk->q_tail) {
+        long rc = syscall_chan_send(lk->wr, &m, 0);
+        if (rc != -11 /* -EAGAIN */) return rc;
+    }
+    if (lk->q_tail - lk->q_head >= NETD_SHARD_BACKLOG) {
+        // Log the 1st, 2nd, 4th, ... drop: visible without flooding.
+        uint32_t d = ++lk->drops;
+        if ((d & (d - 1u)) == 0) {
+            printf("[netd] shard link %u: backlog full, %u sends dropped\n",
+                   (unsigned)(lk - g_shard.link), (unsigned)d);
+        }
+        return -11 /* -EAGAIN */;
+    }
+    g_shard_q[lk - g_shard.link][lk->q_tail++ % NETD_SHARD_BACKLOG] = m;
+    return 0;
+}
+
+// Retry every link's backlog. Returns nonzero while any is left, so the
+// loop wakes again soon rather than after the idle timeout.
+static int shard_flush_links(void) {
+    int left = 0;
+    for (uint32_t s = 0; s < NETD_MAX_SHARDS; s++) {
+        netd_shard_link_t *lk = &g_shard.link[s];
+        while (lk->q_head != lk->q_tail) {
+            chan_msg_user_t *m = &g_shard_q[s][lk->q_head % NETD_SHARD_BACKLOG];
+            long rc = syscall_chan_send(lk->wr, m, 0);
+            if (rc == -11 /* -EAGAIN */) break;
+            // A dead link: the handles never left our table; close them.
+            for (uint8_t k = 0; rc < 0 && k < m->header.nhandles; k++) {
+                netd_vmo_drop((cap_token_u_t){ .raw = m->handles[k] });
+            }
+            lk->q_head++;
+        }
+        left |= lk->q_head != lk->q_tail;
+    }
+    return left;
+}
+
+// Doorbell for a ring the peer armed. A full channel — or a backlog still
+// to flush — already holds a message that will wake it, so this never
+// waits and is never queued.
+static void shard_kick(netd_shard_link_t *lk) {
+    if (lk->q_head != lk->q_tail) return;
+    chan_msg_user_t m;
+    if (shard_msg_build(&m, NETD_SHARD_OP_KICK, 0, 0, NULL, 0, 0) < 0) return;
+    (void)syscall_chan_send(lk->wr, &m, 0);
+}
+
+// The client message inside a CLIENT envelope.
+static int shard_unwrap(const chan_msg_user_t *m, chan_msg_user_t *inner) {
+    if (m->header.inline_len < sizeof(netd_shard_hdr_t)) return -5;
+    memset(&inner->header, 0, sizeof(inner->header));
+    inner->header.inline_len =
+        (uint16_t)(m->header.inline_len - sizeof(netd_shard_hdr_t));
+    inner->header.nhandles = m->header.nhandles;
+    memcpy(inner->inline_payload, m->inline_payload + sizeof(netd_shard_hdr_t),
+           inner->header.inline_len);
+    memcpy(inner->handles, m->handles, sizeof(inner->handles));
+    return 0;
+}
+
+// Every response to a client goes out here. A worker holds no client
+// channels: the response rides to the front in a CLIENT envelope, handles
+// included, and the front passes it on. That link send never blocks, so
+// timeout_ns only bounds the front's own sends.
+static long client_send(netd_client_t *c, chan_msg_user_t *m, uint64_t timeout_ns) {
+    if (g_shard.id == 0) return syscall_chan_send(c->wr_resp, m, timeout_ns);
+    return shard_send(&g_shard.link[0], NETD_SHARD_OP_CLIENT,
+                      (uint32_t)(c - g_clients), 0, m->inline_payload,
+                      m->header.inline_len,
+                      m->header.nhandles ? m->handles[0] : 0);
+}
+
+// Both rings live in one VMO: the two control blocks in the first page,
+// then the front -> worker ring, then the worker -> front one.
+static void shard_map_rings(netd_shard_link_t *lk, uint64_t va, int front) {
+    uint8_t *base = (uint8_t *)(uintptr_t)va;
+    netd_fring_ctl_t *ctl_rx = (netd_fring_ctl_t *)base;
+    netd_fring_ctl_t *ctl_tx = ctl_rx + 1;
+    uint8_t *rx = base + NETD_SHARD_CTL_BYTES;
+    uint8_t *tx = rx + NETD_SHARD_RING_RX;
+    if (front) {
+        netd_fring_init(&lk->out, ctl_rx, rx, NETD_SHARD_RING_RX, 1);
+        netd_fring_init(&lk->in,  ctl_tx, tx, NETD_SHARD_RING_TX, 0);
+    } else {
+        netd_fring_init(&lk->in,  ctl_rx, rx, NETD_SHARD_RING_RX, 0);
+        netd_fring_init(&lk->out, ctl_tx, tx, NETD_SHARD_RING_TX, 1);
+    }
+}
+
+static void shard_config_fill(netd_shard_config_t *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    memcpy(cfg->mac, g_net.mac, 6);
+    cfg->link_up       = g_net.link_up;
+    cfg->stack_running = g_net.stack_running;
+    cfg->ip            = g_net.ip;
+    cfg->netmask       = g_net.netmask;
+    cfg->gateway       = g_net.gateway;
+    cfg->dns_resolver  = g_net.dns_resolver;
+    cfg->nic_features  = g_net.nic_features;
+    cfg->slot_count    = g_net.slot_count;
+    cfg->slot_size     = g_net.slot_size;
+}
+
+static void shard_config_apply(const netd_shard_config_t *cfg) {
+    memcpy(g_net.mac, cfg->mac, 6);
+    g_net.link_up       = cfg->link_up;
+    g_net.stack_running = cfg->stack_running;
+    g_net.ip            = cfg->ip;
+    g_net.netmask       = cfg->netmask;
+    g_net.gateway       = cfg->gateway;
+    g_net.dns_resolver  = cfg->dns_resolver;
+    g_net.nic_features  = cfg->nic_features;
+    g_net.slot_count    = cfg->slot_count;
+    g_net.slot_size     = cfg->slot_size;
+}
+
+// Addresses or link state changed on the front: the workers follow.
+static void shard_push_config(void) {
+    if (g_shard.id != 0) return;
+    netd_shard_config_t cfg;
+    shard_config_fill(&cfg);
+    for (uint32_t s = 1; s < g_shard.count; s++) {
+        if (!g_shard.link[s].up) continue;
+        (void)shard_send(&g_shard.link[s], NETD_SHARD_OP_CONFIG, 0, 0,
+                         &cfg, sizeof(cfg), 0);
+    }
+}
+
+// Front: hand a steered segment to its worker. A full ring drops it, as a
+// full NIC queue would; TCP recovers.
+static void shard_steer_rx(uint32_t shard, const uint8_t *ipv4_pdu, size_t len,
+                           uint8_t nic_csum) {
+    netd_shard_link_t *lk = &g_shard.link[shard];
+    if (!lk->up) return;
+    uint8_t *p = netd_fring_reserve(&lk->out, (uint32_t)len, NETD_FRING_KIND_IPV4);
+    if (!p) return;
+    memcpy(p, ipv4_pdu, len);
+    if (netd_fring_commit(&lk->out, nic_csum, 0)) shard_kick(lk);
+}
+
+// Front: a frame a worker queued. The next hop is resolved here, where the
+// ARP cache lives; a miss sends the request and drops the frame, and the
+// worker's retransmit finds the entry.
+static void shard_forward_frame(const uint8_t *frame, uint32_t len,
+                                uint8_t flags, uint16_t mss) {
+    if (len < 14u + IPV4_HDR_LEN_MIN || len > RAWFRAME_TSO_MAX_BYTES) return;
+    if (len > g_net.slot_size && !(flags & RAWFRAME_TX_TSO)) return;
+    if (!tx_ready()) return;
+    uint8_t dst_mac[6];
+    if (tx_resolve_dst_mac(netd_read_be32(&frame[14 + 16]), dst_mac) < 0) return;
+    uint32_t slot = 0;
+    uint8_t *p = tx_frame_alloc(len, &slot);
+    if (!p) return;
+    memcpy(p, frame, len);
+    memcpy(p, dst_mac, 6);
+    (void)tx_frame_post(slot, len, flags, mss);
+}
+
+// Drain one frame ring, releasing every NETD_RX_RELEASE_BATCH records so
+// the producer can refill mid-burst, then arm its doorbell. Returns 1 if
+// records are still waiting.
+static int shard_drain_ring(netd_fring_t *r) {
+    const netd_fring_rec_t *rec;
+    uint32_t done = 0;
+    while ((rec = netd_fring_peek(r)) != NULL) {
+        const uint8_t *body = (const uint8_t *)(rec + 1);
+        if (g_shard.id == 0 && rec->kind == NETD_FRING_KIND_ETH) {
+            shard_forward_frame(body, rec->len, rec->flags, rec->mss);
+        } else if (g_shard.id != 0 && rec->kind == NETD_FRING_KIND_IPV4) {
+            rx_ipv4(body, rec->len, rec->flags);
+        }
+        netd_fring_pop(r);
+        if (++done % NETD_RX_RELEASE_BATCH == 0) netd_fring_release(r);
+    }
+    return netd_fring_arm(r);
+}
+
+static int shard_drain_rings(void) {
+    int more = 0;
+    if (g_shard.id != 0) return shard_drain_ring(&g_shard.link[0].in);
+    for (uint32_t s = 1; s < g_shard.count; s++) {
+        if (g_shard.link[s].up) more |= shard_drain_ring(&g_shard.link[s].in);
+    }
+    return more;
+}
+
+// Front: which shard serves this client request. New connections are
+// dealt round-robin; anything naming a socket goes where its cookie says.
+// LISTEN and ACCEPT stay here, with everything that is not TCP.
+static uint32_t shard_route(uint16_t op, const chan_msg_user_t *m) {
+    if (g_shard.id != 0 || g_shard.count <= 1) return g_shard.id;
+    const uint8_t *p = m->inline_payload;
+    uint32_t cookie;
+    switch (op) {
+    case LIBNET_OP_TCP_OPEN_REQ:
+        for (uint32_t k = 0; k < g_shard.count; k++) {
+            uint32_t s = g_shard.next_open++ % g_shard.count;
+            if (s == 0 || g_shard.link[s].up) return s;
+        }
+        return 0;
+    case LIBNET_OP_TCP_CLOSE_REQ:
+        cookie = ((const libnet_tcp_close_req_t *)p)->socket_cookie;
+        break;
+    case LIBNET_OP_TCP_SEND_REQ:
+        cookie = ((const libnet_tcp_send_req_t *)p)->socket_cookie;
+        break;
+    case LIBNET_OP_TCP_RECV_REQ:
+        cookie = ((const libnet_tcp_recv_req_t *)p)->socket_cookie;
+        break;
+    case LIBNET_OP_TCP_STATUS_REQ:
+        cookie = ((const libnet_tcp_status_req_t *)p)->socket_cookie;
+        break;
+    case LIBNET_OP_TCP_SHM_ATTACH_REQ:
+        cookie = ((const libnet_tcp_shm_attach_req_t *)p)->socket_cookie;
+        break;
+    case LIBNET_OP_TCP_SHM_KICK_REQ:
+        cookie = ((const libnet_tcp_shm_kick_t *)p)->socket_cookie;
+        break;
+    default:
+        return 0;
+    }
+    return netd_shard_of_cookie(cookie, g_shard.count);
+}
+
+static void shard_forward(uint32_t shard, netd_client_t *c,
+                          const chan_msg_user_t *m, uint16_t op, uint32_t seq) {
+    netd_shard_link_t *lk = &g_shard.link[shard];
+    if (!lk->up ||
+        shard_send(lk, NETD_SHARD_OP_CLIENT, (uint32_t)(c - g_clients), 0,
+                   m->inline_payload, m->header.inline_len, 0) < 0) {
+        if (op != LIBNET_OP_TCP_SHM_KICK_REQ) {
+            client_send_error(c, op | LIBNET_OP_MASK_RESP, seq,
+                              -101 /* -ENETUNREACH */);
+        }
+    }
+}
+
+// Front: a worker's child joined its listener instance's accept queue.
+static void shard_on_child(uint32_t listen_cookie, const libnet_tcp_accept_ent_t *ent) {
+    int lidx = find_socket_by_cookie(listen_cookie);
+    if (lidx < 0 || !g_tcp_conn[lidx].listener) return;
+    uint32_t slot = g_tcp_conn[lidx].listener - 1u;
+    netd_tcp_listener_t *l = &g_tcp_listeners[slot];
+    if (l->aq_tail - l->aq_head >= l->aq_cap) return;
+    netd_tcp_aq_ent_t *e = &l->aq[l->aq_tail & (l->aq_cap - 1u)];
+    e->socket_idx  = NETD_TCP_AQ_REMOTE;
+    e->cookie      = ent->socket_cookie;
+    e->remote_ip   = ent->remote_ip;
+    e->remote_port = ent->remote_port;
+    e->local_port  = ent->local_port;
+    l->aq_tail++;
+    l->aq_remote++;
+    tcp_satisfy_pending_accept(slot);
+}
+
+// Worker: the front's TCP_ACCEPT handed child `cookie` to `client_idx`.
+// Children are reported in queue order and handed out in the same order,
+// so it is at or near the head of its listener's local queue; anything
+// ahead of it is stale. A stale child still queued here is one the front
+// dropped (its ADOPT failed or its queue was full): reset it.
+static void shard_adopt(uint32_t cookie, uint32_t listen_cookie, uint32_t client_idx) {
+    int lidx = find_socket_by_cookie(listen_cookie);
+    if (lidx >= 0 && g_tcp_conn[lidx].listener) {
+        uint32_t parent = g_tcp_conn[lidx].listener;
+        netd_tcp_listener_t *l = &g_tcp_listeners[parent - 1u];
+        while (l->aq_head != l->aq_tail) {
+            netd_tcp_aq_ent_t e = l->aq[l->aq_head & (l->aq_cap - 1u)];
+            l->aq_head++;
+            if (e.cookie == cookie) break;
+            netd_tcp_conn_t *stale = &g_tcp_conn[e.socket_idx];
+            if (stale->in_use && stale->cookie == e.cookie &&
+                stale->parent == parent && stale->queued) {
+                tcp_child_reset((int)e.socket_idx);
+            }
+        }
+    }
+    int idx = find_socket_by_cookie(cookie);
+    if (idx < 0 || !g_tcp_conn[idx].queued) return;
+    netd_tcp_conn_t *conn = &g_tcp_conn[idx];
+    conn->parent     = 0;
+    conn->queued     = 0;
+    conn->client_idx = client_idx;
+}
+
+static void shard_handle_msg(const chan_msg_user_t *m) {
+    if (m->header.inline_len < sizeof(netd_shard_hdr_t)) return;
+    const netd_shard_hdr_t *h = (const netd_shard_hdr_t *)m->inline_payload;
+    const uint8_t *body = m->inline_payload + sizeof(*h);
+    size_t len = m->header.inline_len - sizeof(*h);
+    if (h->client_idx >= NETD_MAX_CLIENTS) return;
+    netd_client_t *c = &g_clients[h->client_idx];
+    chan_msg_user_t inner;
+
+    switch (h->op) {
+    case NETD_SHARD_OP_CLIENT:
+        if (shard_unwrap(m, &inner) < 0) return;
+        if (g_shard.id != 0) {
+            // The front vouches for the slot; mark the stand-in live.
+            c->in_use  = 1;
+            c->standin = 1;
+            (void)client_handle_message(c, &inner);
+        } else if (c->in_use) {
+            uint16_t op = 0;
+            uint32_t seq = 0;
+            (void)libnet_msg_unpack_header(&inner, &op, &seq);
+            long rc = syscall_chan_send(c->wr_resp, &inner,
+                                        op == LIBNET_OP_TCP_SHM_KICK_RESP
+                                            ? 0 : 200000000ull);
+            // Undelivered ring VMO clones stay in our table; close them.
+            for (uint8_t k = 0; rc < 0 && k < inner.header.nhandles; k++) {
+                netd_vmo_drop((cap_token_u_t){ .raw = inner.handles[k] });
+            }
+        }
+        break;
+    case NETD_SHARD_OP_CONFIG:
+        if (g_shard.id != 0 && len >= sizeof(netd_shard_config_t)) {
+            shard_config_apply((const netd_shard_config_t *)body);
+        }
+        break;
+    case NETD_SHARD_OP_LISTEN:
+        if (g_shard.id != 0 && len >= sizeof(netd_shard_listen_t)) {
+            const netd_shard_listen_t *sl = (const netd_shard_listen_t *)body;
+            c->in_use  = 1;
+            c->standin = 1;
+            int rc = tcp_listener_open(h->client_idx, h->arg, sl->local_ip,
+                                       sl->local_port, sl->backlog,
+                                       sl->syn_backlog, sl->cookies);
+            if (rc < 0) {
+                printf("[netd] shard %u: listen port %u rc=%d\n",
+                       (unsigned)g_shard.id, (unsigned)sl->local_port, rc);
+            }
+        }
+        break;
+    case NETD_SHARD_OP_UNLISTEN:
+        if (g_shard.id != 0) {
+            int lidx = find_socket_by_cookie(h->arg);
+            if (lidx >= 0 && g_tcp_conn[lidx].listener) tcp_listener_close(lidx);
+        }
+        break;
+    case NETD_SHARD_OP_CHILD:
+        if (g_shard.id == 0 && len >= sizeof(libnet_tcp_accept_ent_t)) {
+            shard_on_child(h->arg, (const libnet_tcp_accept_ent_t *)body);
+        }
+        break;
+    case NETD_SHARD_OP_ADOPT:
+        if (g_shard.id != 0 && len >= sizeof(uint32_t)) {
+            uint32_t listen_cookie;
+            memcpy(&listen_cookie, body, sizeof(listen_cookie));
+            c->in_use  = 1;
+            c->standin = 1;
+            shard_adopt(h->arg, listen_cookie, h->client_idx);
+        }
+        break;
+    case NETD_SHARD_OP_RELEASE:
+        if (g_shard.id != 0) memset(c, 0, sizeof(*c));
+        break;
+    default:
+        break;      // KICK only wakes us; the ring drain does the work
+    }
+}
+
+// Drain the link channels. A worker whose front went away has nothing
+// left to serve; the front just stops steering to a worker that died.
+static void shard_poll_links(void) {
+    uint32_t first = g_shard.id ? 0 : 1;
+    uint32_t last  = g_shard.id ? 1 : g_shard.count;
+    for (uint32_t s = first; s < last; s++) {
+        netd_shard_link_t *lk = &g_shard.link[s];
+        if (!lk->up) continue;
+        static chan_msg_user_t batch[8];
+        for (int pass = 0; pass < 4; pass++) {
+            long n = syscall_chan_recvv(lk->rd, batch, 8, 0 /*non-blocking*/);
+            if (n == -32 /*-EPIPE*/) {
+                lk->up = 0;
+                if (g_shard.id) {
+                    printf("[netd] shard %u: front gone, exiting\n",
+                           (unsigned)g_shard.id);
+                    syscall_exit(0);
+                }
+                printf("[netd] shard %u down\n", (unsigned)s);
+                if (g_ws) {
+                    (void)syscall_waitset_ctl(g_ws, WAITSET_CTL_DEL, lk->rd.raw, 0, 0);
+                }
+                break;
+            }
+            if (n <= 0) break;
+            for (long k = 0; k < n; k++) shard_handle_msg(&batch[k]);
+            if (n < 8) break;
+        }
+    }
+}
+
+// Front: spawn a worker per further CPU (up to NETD_MAX_SHARDS), give each
+// its ring VMO and the current config. Workers that do not check in
+// within NETD_SHARD_HELLO_MS are not waited for: the shard count is what
+// actually connected, and it never changes afterwards — steering and
+// cookies depend on it.
+static void shard_start(void) {
+    state_system_t sys;
+    memset(&sys, 0, sizeof(sys));
+    if (syscall_get_system_state(STATE_CAT_SYSTEM, &sys, sizeof(sys)) < 0) return;
+    uint32_t want = sys.cpu_count < NETD_MAX_SHARDS ? sys.cpu_count : NETD_MAX_SHARDS;
+    if (want <= 1) return;
+
+    libnet_service_ctx_t ss;
+    if (libnet_publish_service(&ss, "/sys/net/shard",
+                               fnv1a_hash64_local("grahaos.net.socket.v1")) < 0) {
+        printf("[netd] WARN: /sys/net/shard publish failed; single shard\n");
+        return;
+    }
+    // Only the workers spawned here may join; /sys/net/shard is a
+    // public name and anyone else connecting to it is turned away.
+    int pids[NETD_MAX_SHARDS] = { 0 };
+    uint32_t spawned = 1;
+    for (; spawned < want; spawned++) {
+        char *argv[2] = { (char *)"bin/netd", (char *)"--shard" };
+        int pid = syscall_spawn_argv("bin/netd", 2, argv);
+        if (pid <= 0) {
+            printf("[netd] WARN: shard spawn rc=%d\n", pid);
+            break;
+        }
+        pids[spawned] = pid;
+    }
+
+    cap_token_raw_t clones[NETD_MAX_SHARDS] = { 0 };
+    uint32_t n = 1;
+    uint64_t deadline = netd_rdtsc() +
+                        (uint64_t)NETD_SHARD_HELLO_MS * (NETD_TICKS_PER_SEC / 1000u);
+    while (n < spawned && netd_rdtsc() < deadline) {
+        libnet_server_ctx_t srv;
+        if (libnet_service_accept(&ss, &srv, 100000000ull /* 100 ms */) <= 0) continue;
+        uint32_t w = 1;
+        while (w < spawned && pids[w] != srv.connector_pid) w++;
+        if (w == spawned || srv.connector_pid <= 0) {
+            printf("[netd] WARN: shard link from pid=%d rejected\n",
+                   srv.connector_pid);
+            continue;
+        }
+        pids[w] = 0;    // One link per worker
+        long h = syscall_vmo_create(NETD_SHARD_VMO_BYTES, VMO_ZEROED | VMO_ONDEMAND);
+        if (h <= 0) break;
+        cap_token_u_t vmo = { .raw = (uint64_t)h };
+        long va = syscall_vmo_map(vmo, 0, 0, NETD_SHARD_VMO_BYTES,
+                                  PROT_READ | PROT_WRITE);
+        long cl = (va > 0) ? syscall_vmo_clone(vmo, VMO_CLONE_SHARED) : -1;
+        if (cl <= 0) break;
+        netd_shard_link_t *lk = &g_shard.link[n];
+        shard_map_rings(lk, (uint64_t)va, 1);
+        lk->rd  = srv.rd_req;
+        lk->wr  = srv.wr_resp;
+        lk->pid = srv.connector_pid;
+        clones[n] = (cap_token_raw_t)cl;
+        n++;
+    }
+    if (n == 1) {
+        printf("[netd] WARN: no shard checked in; single shard\n");
+        return;
+    }
+
+    g_shard.count      = n;
+    g_shard.steer_seed = netd_rand32();
+    netd_shard_hello_t hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.count      = n;
+    hello.steer_seed = g_shard.steer_seed;
+    shard_config_fill(&hello.cfg);
+    for (uint32_t s = 1; s < n; s++) {
+        netd_shard_link_t *lk = &g_shard.link[s];
+        hello.id = s;
+        if (shard_send(lk, NETD_SHARD_OP_HELLO, 0, 0, &hello, sizeof(hello),
+                       clones[s]) < 0) {
+            printf("[netd] WARN: shard %u hello failed\n", (unsigned)s);
+            continue;
+        }
+        lk->up = 1;
+    }
+    (void)syscall_set_cpu_affinity(0, 1u);
+    printf("[netd] %u shards (cpus=%u)\n", (unsigned)n, (unsigned)sys.cpu_count);
+}
+
+// Worker entry: `netd --shard`. Check in with the front, map the rings,
+// pin to our CPU, then serve TCP until the front goes away.
+static void shard_worker_main(void) {
+    memset(&g_net, 0, sizeof(g_net));
+    g_net.pid = syscall_getpid();
+
+    libnet_client_ctx_t front;
+    int rc = libnet_connect_service_with_retry("/sys/net/shard", 14, 5000, &front);
+    if (rc < 0) {
+        printf("[netd] FATAL: shard connect rc=%d\n", rc);
+        syscall_exit(1);
+    }
+    netd_shard_link_t *lk = &g_shard.link[0];
+    lk->rd = front.rd_resp;
+    lk->wr = front.wr_req;
+
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    long bytes = syscall_chan_recv(lk->rd, &m, 5000000000ull);
+    const netd_shard_hdr_t *h = (const netd_shard_hdr_t *)m.inline_payload;
+    if (bytes < (long)(sizeof(*h) + sizeof(netd_shard_hello_t)) ||
+        h->op != NETD_SHARD_OP_HELLO || m.header.nhandles < 1) {
+        printf("[netd] FATAL: shard hello rc=%ld\n", bytes);
+        syscall_exit(3);
+    }
+    const netd_shard_hello_t *hello =
+        (const netd_shard_hello_t *)(m.inline_payload + sizeof(*h));
+    if (hello->id == 0 || hello->id >= hello->count ||
+        hello->count > NETD_MAX_SHARDS) {
+        printf("[netd] FATAL: shard id=%u count=%u\n",
+               (unsigned)hello->id, (unsigned)hello->count);
+        syscall_exit(3);
+    }
+    g_shard.id         = hello->id;
+    g_shard.count      = hello->count;
+    g_shard.steer_seed = hello->steer_seed;
+    shard_config_apply(&hello->cfg);
+
+    cap_token_u_t vmo = { .raw = m.handles[0] };
+    long va = syscall_vmo_map(vmo, 0, 0, NETD_SHARD_VMO_BYTES,
+                              PROT_READ | PROT_WRITE);
+    if (va <= 0) { printf("[netd] FATAL: vmo_map(shard)=%ld\n", va); syscall_exit(5); }
+    shard_map_rings(lk, (uint64_t)va, 0);
+    lk->up = 1;
+    (void)syscall_set_cpu_affinity(0, 1u << g_shard.id);
+
+    netd_tcp_table_init(&g_net.tcp);
+    g_net.tcp.hash_seed = netd_rand32();
+    g_net.tcp.cookie_key[0] = netd_key64();
+    g_net.tcp.cookie_key[1] = netd_key64();
+    netd_twheel_init(&g_tcp_wheel, netd_rdtsc(), NETD_TCP_WHEEL_TICK_TSC);
+    printf("[netd] shard %u/%u up\n", (unsigned)g_shard.id, (unsigned)g_shard.count);
+
+    // Same shape as the front's loop: a KICK or a client op on the link
+    // channel wakes us, and the 25 ms bound keeps the TCP timers running.
+    // A backlog of link sends shortens the wait to 1 ms so it drains
+    // promptly once the front makes room.
+    for (;;) {
+        shard_poll_links();
+        int more = shard_drain_rings();
+        tcp_tick(netd_rdtsc());
+        int backlog = shard_flush_links();
+        if (more) continue;
+        memset(&m, 0, sizeof(m));
+        long rc2 = syscall_chan_recv(lk->rd, &m, backlog ? 1000000ull /* 1 ms */
+                                                         : 25000000ull /* 25 ms */);
+        if (rc2 >= 0) shard_handle_msg(&m);
+    }
+}
+
+
+void _start(int argc, char **argv) {
+    // Phase 26: `netd --shard` is a worker spawned by the front.
+    if (argc >= 2 && argv && argv[1] && strcmp(argv[1], "--shard") == 0) {
+        shard_worker_main();
+    }
     printf("[netd] starting (Phase 22 Stage C)\n");
 
     memset(&g_net, 0, sizeof(g_net));
@@ -1626,6 +3802,7 @@ void _start(void) {
         g_net.link_up    = ab->link_up;
         g_net.slot_count = ab->slot_count;
         g_net.slot_size  = ab->slot_size;
+        g_net.nic_features = ab->features;
 
         cap_token_u_t rx_vmo = { .raw = am.handles[0] };
         cap_token_u_t tx_vmo = { .raw = am.handles[1] };
@@ -1639,21 +3816,44 @@ void _start(void) {
         if (va <= 0) { printf("[netd] FATAL: vmo_map(tx)=%ld\n", va); syscall_exit(5); }
         g_net.tx_ring_va = (uint64_t)va;
 
-        printf("[netd] ANNOUNCE mac=%x:%x:%x:%x:%x:%x link=%u slots=%u size=%u\n",
+        // Phase 26: the driver has already bound us to the ring, so a
+        // failed map is as fatal as for the frame rings.
+        if ((g_net.nic_features & RAWFRAME_FEAT_RING) && am.header.nhandles >= 3) {
+            cap_token_u_t ctl_vmo = { .raw = am.handles[2] };
+            va = syscall_vmo_map(ctl_vmo, 0, 0,
+                                 RAWFRAME_RING_BYTES(g_net.slot_count),
+                                 PROT_READ | PROT_WRITE);
+            if (va <= 0) { printf("[netd] FATAL: vmo_map(ring)=%ld\n", va); syscall_exit(5); }
+            g_net.ring     = (rawframe_ring_ctl_t *)(uintptr_t)va;
+            g_net.rx_cons  = g_net.ring->rx_cons;
+            g_net.tx_prod  = g_net.ring->tx_prod;
+            g_net.tx_base  = g_net.tx_prod;
+        } else {
+            g_net.nic_features &= ~RAWFRAME_FEAT_RING;
+        }
+
+        printf("[netd] ANNOUNCE mac=%x:%x:%x:%x:%x:%x link=%u slots=%u size=%u features=0x%x\n",
                g_net.mac[0], g_net.mac[1], g_net.mac[2],
                g_net.mac[3], g_net.mac[4], g_net.mac[5],
                (unsigned)g_net.link_up, (unsigned)g_net.slot_count,
-               (unsigned)g_net.slot_size);
+               (unsigned)g_net.slot_size, (unsigned)g_net.nic_features);
     }
 
     // 3. Initialise protocol tables.
     netd_arp_init(&g_net.arp);
     netd_udp_table_init(&g_net.udp);
     netd_tcp_table_init(&g_net.tcp);
+    g_net.tcp.hash_seed = netd_rand32();
+    g_net.tcp.cookie_key[0] = netd_key64();
+    g_net.tcp.cookie_key[1] = netd_key64();
     netd_dhcp_init(&g_net.dhcp, g_net.mac, netd_rdtsc());
     memset(g_clients, 0, sizeof(g_clients));
     memset(g_dns, 0, sizeof(g_dns));
     memset(g_icmps, 0, sizeof(g_icmps));
+    netd_twheel_init(&g_tcp_wheel, netd_rdtsc(), NETD_TCP_WHEEL_TICK_TSC);
+
+    // Phase 26: bring up the TCP shards before any client can open a socket.
+    shard_start();
 
     // 4. Publish /sys/net/service.
     libnet_service_ctx_t svc;
@@ -1669,44 +3869,69 @@ void _start(void) {
     //    each client, tick timers. Block briefly on rawframe rd_resp to
     //    save CPU when idle (short timeout so service accepts + timers
     //    still fire on time).
+    //
+    //    Phase 26: block in one SYS_WAITSET_WAIT across rawframe, accept
+    //    and all clients instead, so a client request or new connection
+    //    wakes netd immediately rather than after the next frame or the
+    //    25 ms tick. The 25 ms bound stays for the DNS/ICMP/TCP timers.
+    long wsrc = syscall_waitset_create();
+    if (wsrc > 0) {
+        g_ws = (uint64_t)wsrc;
+        if (syscall_waitset_ctl(g_ws, WAITSET_CTL_ADD, g_net.rawframe_rd_resp.raw,
+                                WAITSET_EV_READABLE, NETD_WS_RAWFRAME) < 0 ||
+            syscall_waitset_ctl(g_ws, WAITSET_CTL_ADD, svc.accept_rd.raw,
+                                WAITSET_EV_READABLE, NETD_WS_ACCEPT) < 0) {
+            printf("[netd] WARN: waitset registration failed; using timed recv\n");
+            g_ws = 0;
+        }
+        for (uint32_t s = 1; g_ws && s < g_shard.count; s++) {
+            if (!g_shard.link[s].up) continue;
+            (void)syscall_waitset_ctl(g_ws, WAITSET_CTL_ADD, g_shard.link[s].rd.raw,
+                                      WAITSET_EV_READABLE, NETD_WS_SHARD + s);
+        }
+    }
     printf("[netd] entering event loop\n");
     for (;;) {
-        rawframe_poll_rx();
+        int backlog = 0;
+        int rx_more = rawframe_poll_rx();
         service_accept_tick(&svc);
         clients_dispatch_tick();
+        if (g_shard.count > 1) {
+            // Phase 26: worker messages, then the frames they queued, then
+            // whatever link sends are still waiting for room.
+            shard_poll_links();
+            rx_more |= shard_drain_rings();
+            backlog = shard_flush_links();
+        }
         uint64_t now = netd_rdtsc();
         dns_tick(now);
         icmp_tick(now);
+        arp_tick(now);
         tcp_tick(now);
 
+        if (g_ws) {
+            // The events only say which sources to look at; the drains at
+            // the top of the loop service all of them.
+            waitset_event_t ev[NETD_MAX_CLIENTS + NETD_MAX_SHARDS + 2];
+            (void)syscall_waitset_wait(g_ws, ev, NETD_MAX_CLIENTS + NETD_MAX_SHARDS + 2,
+                                       rx_more ? 0 : backlog ? 1000000ull /* 1 ms */
+                                                             : 25000000ull /* 25 ms */);
+            continue;
+        }
+        if (rx_more) continue;
+
         // Idle wait: blocking chan_recv on rawframe with a 25 ms budget.
         // This lets frames wake us immediately; in absence of frames we
         // re-enter the loop in ~25 ms and re-check accept + clients.
         chan_msg_user_t m;
         memset(&m, 0, sizeof(m));
         long rc2 = syscall_chan_recv(g_net.rawframe_rd_resp, &m,
-                                     25000000ull /* 25 ms */);
+                                     backlog ? 1000000ull /* 1 ms */
+                                             : 25000000ull /* 25 ms */);
         if (rc2 >= 0 && m.header.inline_len >= sizeof(rawframe_slot_msg_t)) {
             // Got something — handle it directly via the common path. We
             // "push back" by redispatching inline rather than re-recv'ing.
-            rawframe_slot_msg_t *sm = (rawframe_slot_msg_t *)m.inline_payload;
-            if (sm->op == RAWFRAME_OP_RX_NOTIFY &&
-                sm->slot < g_net.slot_count &&
-                sm->length > 0 && sm->length <= g_net.slot_size) {
-                uint8_t frame_copy[ETH_MAX_FRAME];
-                size_t  flen = (sm->length > sizeof(frame_copy)) ?
-                               sizeof(frame_copy) : sm->length;
-                const uint8_t *src = (const uint8_t *)(uintptr_t)
-                    (g_net.rx_ring_va + (uint64_t)sm->slot * g_net.slot_size);
-                memcpy(frame_copy, src, flen);
-                rx_dispatch_frame(frame_copy, flen);
-            } else if (sm->op == RAWFRAME_OP_LINK_UP) {
-                g_net.link_up = 1;
-                if (g_net.dhcp.state == DHCP_STATE_INIT) dhcp_kickoff();
-            } else if (sm->op == RAWFRAME_OP_LINK_DOWN) {
-                g_net.link_up = 0;
-                g_net.stack_running = 0;
-            }
+            rawframe_handle_msg((const rawframe_slot_msg_t *)m.inline_payload);
         }
     }
 }
@@ -8,6 +8,7 @@
 //   netd_udp.c   — UDP (RFC 768)
 //   netd_tcp.c   — TCP Reno (RFC 793 + 5681 + 5961)
 //   netd_dhcp.c  — DHCP client (RFC 2131)
+//   netd_shard.c — flow steering, shard frame rings, TCP timer wheel
 //   netd.c       — daemon main loop, RX/TX path, service-accept dispatch
 //
 // Design principle: every module is a pure function of its inputs where
@@ -120,9 +121,21 @@ _Static_assert(sizeof(arp_packet_t) == 28, "arp_packet_t layout drift");
 // Phase 22 closeout (G3): scaled from 16 → 64 in step with TCP_MAX_SOCKETS=1024.
 // At 1024 ESTABLISHED, ARP entries are bounded by # unique gateways/hosts in
 // flight, not connections — 64 covers stress-test workloads comfortably.
+// Phase 26: open-addressed on the IP (linear probing, backward-shift
+// delete), so the size must be a power of two; override with
+// -DARP_TABLE_SLOTS=N. A full table evicts the entry closest to expiry.
+#ifndef ARP_TABLE_SLOTS
 #define ARP_TABLE_SLOTS   64u
+#endif
 #define ARP_TTL_SECONDS   60u
 #define ARP_TTL_TSC(ticks_per_sec)  ((uint64_t)ARP_TTL_SECONDS * (ticks_per_sec))
+// Phase 26: how long a PENDING entry suppresses a repeat request, and how
+// often netd sweeps expired entries out.
+#define ARP_PENDING_MS    1000u
+#define ARP_GC_MS         1000u
+
+_Static_assert((ARP_TABLE_SLOTS & (ARP_TABLE_SLOTS - 1u)) == 0,
+               "ARP_TABLE_SLOTS must be a power of two");
 
 // Per-entry state.
 #define ARP_STATE_FREE       0u
@@ -140,27 +153,28 @@ typedef struct arp_entry {
 
 typedef struct arp_table {
     arp_entry_t entries[ARP_TABLE_SLOTS];
-    // Hands out next-slot for insertion when full: round-robin LRU-ish.
-    uint32_t    next_slot;
+    uint32_t    used;         // Non-FREE entries (Phase 26; was next_slot)
 } arp_table_t;
 
 // Initialise all slots to FREE.
 void netd_arp_init(arp_table_t *tbl);
 
 // Look up `ip` in the table. On hit, populates `out_mac` and returns 1.
-// On miss, returns 0 (and leaves out_mac untouched). Does NOT age entries.
+// On miss, returns 0 (and leaves out_mac untouched). Does NOT age entries;
+// netd_arp_resolve does.
 int netd_arp_lookup(const arp_table_t *tbl, uint32_t ip,
                     uint8_t out_mac[ETH_ALEN]);
 
-// Insert or refresh. Always overwrites a matching IP; else claims a FREE slot;
-// else LRU-evicts via round-robin cursor. Sets expiry = now_tsc + ttl_tsc.
+// Insert or refresh. Always overwrites a matching IP; else claims a FREE slot
+// on the IP's probe run; a full table first evicts the entry with the
+// earliest expiry. Sets expiry = now_tsc + ttl_tsc.
 // `state` must be RESOLVED or PENDING.
 void netd_arp_insert(arp_table_t *tbl, uint32_t ip,
                      const uint8_t mac[ETH_ALEN],
                      uint8_t state, uint64_t now_tsc, uint64_t ttl_tsc);
 
-// Sweep: mark RESOLVED entries past expiry as FREE; leave PENDING alone
-// (PENDING expiry is handled by the request timer). Returns count aged.
+// Sweep: free every entry past expiry — RESOLVED ones that went stale and
+// PENDING ones whose request was never answered. Returns count aged.
 uint32_t netd_arp_gc(arp_table_t *tbl, uint64_t now_tsc);
 
 // Returns the number of RESOLVED entries (ignores FREE/PENDING). For
@@ -208,6 +222,8 @@ int netd_arp_handle_incoming(arp_table_t *tbl,
 // On miss, inserts a PENDING entry (for dedup) and writes a request frame
 // into req_buf (>= 42 B), sets *req_len = 42, returns 0.
 // The caller is responsible for sending the request and retrying later.
+// Phase 26: a RESOLVED entry past its expiry counts as a miss, so a stale
+// mapping is re-requested even between netd_arp_gc sweeps.
 int netd_arp_resolve(arp_table_t *tbl,
                      const uint8_t my_mac[ETH_ALEN],
                      uint32_t my_ip,
@@ -259,10 +275,18 @@ typedef struct ipv4_parsed {
     uint16_t total_len;      // Whole datagram length
     uint16_t id;
     uint16_t flags_frag;     // As-parsed
+    uint8_t  nic_csum;       // NETD_CSUM_* the NIC vouched for (Phase 26)
     const uint8_t *payload;  // Start of L4 payload
     size_t   payload_len;
 } ipv4_parsed_t;
 
+// Phase 26: RX checksum offload. A NIC that already verified a frame
+// reports it with these bits (numerically the rawframe RAWFRAME_RX_*_OK
+// flags); the *_csum parser variants skip the matching software check.
+// The plain parsers are the nic_ok == 0 case.
+#define NETD_CSUM_IP_OK   0x1u
+#define NETD_CSUM_L4_OK   0x2u
+
 // Build a 20-byte IPv4 header into `out_hdr[0..19]`.
 //   src, dst          — host byte order; will be stored big-endian
 //   proto             — IPPROTO_*
@@ -289,6 +313,8 @@ size_t netd_ipv4_build_header(uint8_t *out_hdr,
 //   - fragmented packets (frag_offset != 0 OR MF flag set) — MVP only
 //     handles atomic datagrams; DHCP/ARP/ICMP-echo/TCP/UDP all fit in one
 int netd_ipv4_parse(const uint8_t *buf, size_t buf_len, ipv4_parsed_t *out);
+int netd_ipv4_parse_csum(const uint8_t *buf, size_t buf_len, uint8_t nic_ok,
+                         ipv4_parsed_t *out);
 
 // One's-complement Internet checksum (RFC 1071). `initial` chains input —
 // pass 0 for a fresh run. Returns the value in BIG-ENDIAN ready for direct
@@ -386,16 +412,27 @@ int netd_udp_parse(const uint8_t *buf, size_t buf_len,
                    uint32_t src_ip, uint32_t dst_ip,
                    uint16_t *out_src_port, uint16_t *out_dst_port,
                    const uint8_t **out_payload, size_t *out_payload_len);
+int netd_udp_parse_csum(const uint8_t *buf, size_t buf_len,
+                        uint32_t src_ip, uint32_t dst_ip, uint8_t nic_ok,
+                        uint16_t *out_src_port, uint16_t *out_dst_port,
+                        const uint8_t **out_payload, size_t *out_payload_len);
 
 // ---------------------------------------------------------------------------
 // UDP socket table (MVP — fixed 16 slots, bind-by-port).
 // ---------------------------------------------------------------------------
 // Phase 22 closeout (G3): UDP rarely needs the same scale as TCP, but bump
 // proportionally so DHCP/DNS + 50+ concurrent UDP-bind callers fit cleanly.
+// Phase 26: bound sockets also hang off a port-indexed hash, so find and
+// the bind-time in-use check no longer walk the table.
+#ifndef UDP_MAX_SOCKETS
 #define UDP_MAX_SOCKETS    64u
+#endif
+#define UDP_PORT_BUCKETS   64u
 #define UDP_STATE_FREE     0u
 #define UDP_STATE_BOUND    1u
 
+_Static_assert(UDP_MAX_SOCKETS < 0xFFFFu, "UDP chain links are 16-bit");
+
 typedef struct udp_socket {
     uint8_t  state;           // UDP_STATE_*
     uint8_t  _pad[3];
@@ -406,6 +443,9 @@ typedef struct udp_socket {
 
 typedef struct udp_table {
     udp_socket_t sockets[UDP_MAX_SOCKETS];
+    // Phase 26: per-port chains; links are socket index + 1 (0 = end).
+    uint16_t     port_head[UDP_PORT_BUCKETS];
+    uint16_t     port_next[UDP_MAX_SOCKETS];
 } udp_table_t;
 
 void netd_udp_table_init(udp_table_t *tbl);
@@ -423,9 +463,32 @@ int netd_udp_find(const udp_table_t *tbl, uint16_t local_port);
 
 // ===========================================================================
 // L4: TCP (RFC 793 + RFC 5681 Reno + RFC 5961 hardening).
+// Phase 26: + RFC 7323 window scale / timestamps, RFC 2018 SACK, RFC 6675 /
+// 6582 loss recovery, RFC 6298 RTO and a selectable congestion controller
+// (netd_tcp_cc.c: Reno or CUBIC).
 // ===========================================================================
 
 #define TCP_HDR_LEN_MIN   20u   // No options
+#define TCP_HDR_LEN_MAX   60u   // data_offset = 15 words
+
+// Option kinds (RFC 793 / 7323 / 2018).
+#define TCP_OPT_EOL        0u
+#define TCP_OPT_NOP        1u
+#define TCP_OPT_MSS        2u
+#define TCP_OPT_WSCALE     3u
+#define TCP_OPT_SACK_PERM  4u
+#define TCP_OPT_SACK       5u
+#define TCP_OPT_TS         8u
+
+// Negotiable extensions (tcp_socket_t.opts_offer / .opts).
+#define TCP_OPT_F_WSCALE   0x01u
+#define TCP_OPT_F_SACK     0x02u
+#define TCP_OPT_F_TS       0x04u
+#define TCP_OPT_F_ALL      (TCP_OPT_F_WSCALE | TCP_OPT_F_SACK | TCP_OPT_F_TS)
+
+#define TCP_MAX_WSCALE        14u
+#define TCP_TS_OPT_LEN        12u   // NOP NOP kind len TSval TSecr
+#define TCP_SACK_MAX_BLOCKS    4u   // Both the scoreboard and what we report
 
 // TCP control flags (6-bit CWR..FIN). Only the ones we use are named.
 #define TCP_FLAG_FIN    0x01u
@@ -450,7 +513,10 @@ int netd_udp_find(const udp_table_t *tbl, uint16_t local_port);
 
 // Defaults.
 #define TCP_DEFAULT_MSS        1460u    // 1500 - 20 IP - 20 TCP
+// Receive window for a socket whose owner does not manage rcv_wnd itself.
+// netd sizes rcv_wnd from each connection's receive buffer instead.
 #define TCP_DEFAULT_WINDOW     8192u
+#define TCP_INIT_CWND_SEGS       10u    // RFC 6928
 #define TCP_DEFAULT_RTO_MS     1000u
 #define TCP_MAX_RTO_MS        60000u
 #define TCP_MIN_RTO_MS          200u
@@ -473,6 +539,25 @@ typedef struct __attribute__((packed)) tcp_header {
 
 _Static_assert(sizeof(tcp_header_t) == 20, "tcp_header_t layout drift");
 
+// A SACKed / out-of-order sequence range [start, end).
+typedef struct tcp_sack_block {
+    uint32_t start;
+    uint32_t end;
+} tcp_sack_block_t;
+
+// Congestion controllers (tcp_socket_t.cc_algo), see netd_tcp_cc.c.
+#define TCP_CC_RENO     0u
+#define TCP_CC_CUBIC    1u
+#define TCP_CC_COUNT    2u
+#ifndef TCP_CC_DEFAULT
+#define TCP_CC_DEFAULT  TCP_CC_CUBIC
+#endif
+
+// Loss-recovery state (tcp_socket_t.ca_state).
+#define TCP_CA_OPEN      0u    // Normal transmission
+#define TCP_CA_RECOVERY  1u    // Fast recovery (SACK / NewReno) until `recover`
+#define TCP_CA_LOSS      2u    // Rewound by an RTO until `recover` is ACKed
+
 typedef struct tcp_parsed {
     uint16_t src_port;
     uint16_t dst_port;
@@ -483,22 +568,49 @@ typedef struct tcp_parsed {
     uint16_t window;
     const uint8_t *payload;
     size_t   payload_len;
-    // Parsed SYN options (only MSS honored in MVP). mss==0 when absent.
+    // Parsed SYN options. mss==0 when absent.
     uint16_t opt_mss;
+    // Phase 26: opt_wscale is 0xFF when absent (SYN only); opt_sack_perm is
+    // SYN only; timestamps on any segment; SACK blocks on non-SYN ones.
+    uint8_t  opt_wscale;
+    uint8_t  opt_sack_perm;
+    uint8_t  opt_ts;
+    uint8_t  sack_n;
+    uint32_t tsval;
+    uint32_t tsecr;
+    tcp_sack_block_t sack[TCP_SACK_MAX_BLOCKS];
 } tcp_parsed_t;
 
 // ---------------------------------------------------------------------------
 // Socket descriptor.
 // ---------------------------------------------------------------------------
 // Phase 22 closeout (G3 / spec D12): scaled from 16 → 1024.  Memory budget:
-// sizeof(tcp_socket_t) ~80 B × 1024 = 80 KiB for the TCB array, plus
-// netd_tcp_conn_t ~2080 B × 1024 = 2 MiB for the per-socket userspace
-// wrappers (with 2 KiB rx ring each).  Total ~2.1 MiB — well under the
-// 64 MiB netd budget mandated by spec L1050.  Lookup walks the array
-// linearly today (1024 elements × ~10 ns each = 10 µs/packet, comfortable
-// for the 10K pps target).  Migrating to an open-addressed hash on
-// (src_port, dst_ip, dst_port) is a perf-driven follow-up if needed.
+// sizeof(tcp_socket_t) ~220 B × 1024 = 220 KiB for the TCB array.  Phase 26:
+// netd's per-socket send/receive buffers are heap-allocated per connection
+// and grow with the window (netd.c), so idle slots cost nothing beyond the
+// TCB — well under the 64 MiB netd budget mandated by spec L1050.
+//
+// Phase 26: demux no longer walks the array. Connected sockets hash on the
+// 4-tuple (seeded, so a peer cannot pick its own collisions) into
+// TCP_EST_BUCKETS chains, listeners on the local port into
+// TCP_LISTEN_BUCKETS chains. Per-segment cost is now independent of the
+// table size, which is build-time overridable up to TCP_MAX_SOCKETS_LIMIT
+// (power of two; -DTCP_MAX_SOCKETS=N).
+#ifndef TCP_MAX_SOCKETS
 #define TCP_MAX_SOCKETS     1024u
+#endif
+#define TCP_MAX_SOCKETS_LIMIT 16384u
+#define TCP_EST_BUCKETS     TCP_MAX_SOCKETS
+#define TCP_LISTEN_BUCKETS  64u
+
+_Static_assert(TCP_MAX_SOCKETS <= TCP_MAX_SOCKETS_LIMIT &&
+               (TCP_MAX_SOCKETS & (TCP_MAX_SOCKETS - 1u)) == 0,
+               "TCP_MAX_SOCKETS must be a power of two <= 16384");
+
+// Which demux index a socket is linked into (tcp_table_t.hashed).
+#define TCP_HASHED_NONE     0u
+#define TCP_HASHED_EST      1u
+#define TCP_HASHED_LISTEN   2u
 
 typedef struct tcp_socket {
     uint8_t  state;            // TCP_STATE_*
@@ -518,12 +630,12 @@ typedef struct tcp_socket {
     uint32_t rcv_wnd;          // Our advertised receive window
     uint32_t irs;              // Initial receive sequence (peer SYN)
 
-    // Congestion control (RFC 5681 Reno).
+    // Congestion control (RFC 5681; the growth rule is cc_algo's).
     uint32_t cwnd;             // Congestion window, in bytes
     uint32_t ssthresh;         // Slow-start threshold
     uint16_t mss;              // Path MSS — min of advertised + TCP_DEFAULT_MSS
     uint8_t  dup_acks;         // Dup-ACK counter for fast-retransmit
-    uint8_t  _pad1;
+    uint8_t  cc_algo;          // TCP_CC_*; set before connect / listen
 
     // RTO / timers.
     uint32_t rto_ms;           // Current retransmission timeout
@@ -532,11 +644,67 @@ typedef struct tcp_socket {
 
     // Owner (client channel handle or similar).
     uint32_t owner_cookie;
-    uint32_t _pad2;
+
+    // Phase 26: negotiated extensions. The owner sets opts_offer (and
+    // rcv_wnd_max, the most buffer it may ever back the window with, which
+    // picks rcv_wscale) before connect / listen; 0 keeps the SYN plain.
+    uint8_t  opts_offer;       // TCP_OPT_F_* to put on our SYN / SYN-ACK
+    uint8_t  opts;             // TCP_OPT_F_* both ends agreed to
+    uint8_t  snd_wscale;       // Shift for the peer's advertised windows
+    uint8_t  rcv_wscale;       // Shift for ours
+    uint32_t rcv_wnd_max;
+    uint32_t rcv_adv;          // Right edge of the last window we advertised
+    uint32_t ts_recent;        // Peer TSval we echo (RFC 7323 §4.3)
+
+    // Send side beyond RFC 793: snd_nxt rewinds on an RTO, snd_max doesn't.
+    uint32_t snd_max;          // Highest sequence sent so far, + 1
+    uint32_t srtt_us;          // RFC 6298 smoothed RTT (0 = no sample yet)
+    uint32_t rttvar_us;
+    uint32_t rtt_seq;          // Untimestamped RTT probe: ends at this seq
+    uint64_t rtt_tsc;          //   ... sent at this time (0 = none running)
+
+    // Loss recovery. sack[] is the peer's scoreboard above snd_una, sorted
+    // by start; rcv_sack[] the out-of-order ranges we hold, newest first.
+    uint8_t  ca_state;         // TCP_CA_*
+    uint8_t  sack_n;
+    uint8_t  rcv_sack_n;
+    uint8_t  probe;            // Persist timer fired: one byte may pass rwnd
+    uint8_t  fin_rcvd;         // Peer FIN consumed in sequence
+    uint8_t  _pad1[3];
+    uint32_t recover;          // snd_max when recovery / loss began
+    uint32_t rexmit_nxt;       // Next byte to retransmit in RECOVERY
+    tcp_sack_block_t sack[TCP_SACK_MAX_BLOCKS];
+    tcp_sack_block_t rcv_sack[TCP_SACK_MAX_BLOCKS];
+
+    // Payload the last netd_tcp_on_segment accepted, as netd_tcp_rcv_clip
+    // spans it against the rcv_nxt before that call; rcv_seg_len 0 = none.
+    uint32_t rcv_seg_off;
+    uint32_t rcv_seg_skip;
+    uint32_t rcv_seg_len;
+
+    // Congestion-controller private state (netd_tcp_cc.c).
+    uint32_t cc_acked;         // Reno: bytes ACKed toward the next +MSS
+    uint32_t cc_w_max;         // CUBIC: window before the last reduction
+    uint32_t cc_w_last_max;    // CUBIC: previous w_max (fast convergence)
+    uint32_t cc_origin;        // CUBIC: plateau of the current curve
+    uint32_t cc_k_ms;          // CUBIC: time to climb back to cc_origin
+    uint32_t cc_w_est;         // CUBIC: Reno-friendly estimate
+    uint64_t cc_epoch_tsc;     // CUBIC: start of this growth epoch (0 = none)
 } tcp_socket_t;
 
 typedef struct tcp_table {
     tcp_socket_t sockets[TCP_MAX_SOCKETS];
+
+    // Phase 26 demux index. Chains thread through hash_next; links are
+    // socket index + 1 (0 = end), so a zeroed table is empty.
+    uint16_t est_head[TCP_EST_BUCKETS];
+    uint16_t listen_head[TCP_LISTEN_BUCKETS];
+    uint16_t hash_next[TCP_MAX_SOCKETS];
+    uint16_t hash_bucket[TCP_MAX_SOCKETS]; // Chain the socket sits on
+    uint8_t  hashed[TCP_MAX_SOCKETS];      // TCP_HASHED_*
+    uint32_t hash_seed;        // Set before the first insert; 0 is valid
+    uint32_t alloc_hint;       // Where netd_tcp_socket_alloc resumes
+    uint64_t cookie_key[2];    // Phase 26: SipHash key for SYN cookies (set at init)
 } tcp_table_t;
 
 // ---------------------------------------------------------------------------
@@ -554,12 +722,39 @@ size_t netd_tcp_build(uint8_t *out,
                       uint16_t mss_opt_val,
                       const uint8_t *payload, size_t payload_len);
 
+// Phase 26: as netd_tcp_build with a ready-made option block (opts_len a
+// multiple of 4, <= 40), e.g. from netd_tcp_write_options.
+size_t netd_tcp_build_opts(uint8_t *out,
+                           uint32_t src_ip, uint32_t dst_ip,
+                           uint16_t src_port, uint16_t dst_port,
+                           uint32_t seq, uint32_t ack,
+                           uint8_t flags, uint16_t window,
+                           const uint8_t *opts, size_t opts_len,
+                           const uint8_t *payload, size_t payload_len);
+
 // Parse a TCP segment. Verifies checksum (pseudo-header + segment). Extracts
 // the MSS option if present and SYN is set. Rejects malformed options that
 // run past data_offset.
 int netd_tcp_parse(const uint8_t *buf, size_t buf_len,
                    uint32_t src_ip, uint32_t dst_ip,
                    tcp_parsed_t *out);
+int netd_tcp_parse_csum(const uint8_t *buf, size_t buf_len,
+                        uint32_t src_ip, uint32_t dst_ip, uint8_t nic_ok,
+                        tcp_parsed_t *out);
+
+// Phase 26: TX checksum offload / TSO. Write only the TCP header (20 bytes
+// plus `opts`) for a segment whose payload_len bytes the caller places
+// right after it, leaving the folded pseudo-header sum in the checksum
+// field for the NIC to complete. With `tso` set the sum is taken with a
+// zero length (the NIC adds each cut segment's own length, and copies the
+// options onto every segment). Returns the header length.
+size_t netd_tcp_build_offload(uint8_t *out,
+                              uint32_t src_ip, uint32_t dst_ip,
+                              uint16_t src_port, uint16_t dst_port,
+                              uint32_t seq, uint32_t ack,
+                              uint8_t flags, uint16_t window,
+                              const uint8_t *opts, size_t opts_len,
+                              size_t payload_len, int tso);
 
 // ---------------------------------------------------------------------------
 // Socket table operations.
@@ -570,13 +765,24 @@ void netd_tcp_table_init(tcp_table_t *tbl);
 // with cookie == 0 are considered free. Returns index, or -1 if full.
 int  netd_tcp_socket_alloc(tcp_table_t *tbl, uint32_t owner_cookie);
 
-// Release a socket slot (zeroes it; no wire action).
+// Release a socket slot (unhashes and zeroes it; no wire action).
 void netd_tcp_socket_free(tcp_table_t *tbl, int idx);
 
+// Phase 26: link socket `idx` into the demux index for its current tuple —
+// the port-indexed listen table if it is in LISTEN, else the 4-tuple hash.
+// Call once the tuple is final (before netd_tcp_connect, after
+// netd_tcp_listen) and again after changing it; re-inserting first
+// unlinks the old entry. Returns 0, -1 on a bad index, or -2 if another
+// hashed socket already owns the same 4-tuple / listen address.
+int  netd_tcp_hash_insert(tcp_table_t *tbl, int idx);
+void netd_tcp_hash_remove(tcp_table_t *tbl, int idx);
+
 // Look up a socket matching (local_ip, local_port, remote_ip, remote_port).
 // When the socket is in LISTEN state, remote_* match 0 — so an incoming SYN
 // whose remote is nonzero finds a LISTEN as a lower-priority fallback via
-// netd_tcp_find_listen. Returns slot index on hit, -1 on miss.
+// netd_tcp_find_listen. Returns slot index on hit, -1 on miss. Phase 26:
+// both only see sockets linked with netd_tcp_hash_insert; find_listen
+// prefers an exact local_ip over an INADDR_ANY listener.
 int netd_tcp_find_established(const tcp_table_t *tbl,
                               uint32_t local_ip, uint16_t local_port,
                               uint32_t remote_ip, uint16_t remote_port);
@@ -602,6 +808,34 @@ int netd_tcp_connect(tcp_socket_t *sock,
 // Passive open: flip CLOSED to LISTEN. Remote ip/port set to 0.
 int netd_tcp_listen(tcp_socket_t *sock, uint32_t local_ip, uint16_t local_port);
 
+// Phase 26: SYN cookies (RFC 4987 §3.6). When a listener's SYN queue is
+// full the SYN-ACK carries all the state in its ISS instead:
+//   bits 31..27  time counter `t` (mod 32; the caller advances it every
+//                64 s), bits 26..24  peer MSS class, bits 23..0  keyed hash
+//                of the 4-tuple, the peer's ISN and t.
+// A cookie is honoured for the current and the previous period. Options
+// other than MSS do not survive (no timestamps to hide them in), so a
+// cookie connection runs unscaled, without SACK or timestamps.
+uint32_t netd_tcp_syncookie(const tcp_table_t *tbl,
+                            uint32_t local_ip, uint16_t local_port,
+                            uint32_t remote_ip, uint16_t remote_port,
+                            uint32_t peer_isn, uint16_t peer_mss, uint32_t t);
+
+// Validate the ACK completing a cookie handshake (`ack - 1` is the cookie,
+// `seq - 1` the peer's ISN). Returns 0 and the decoded MSS, or -1.
+int netd_tcp_syncookie_check(const tcp_table_t *tbl,
+                             uint32_t local_ip, uint16_t local_port,
+                             uint32_t remote_ip, uint16_t remote_port,
+                             uint32_t peer_isn, uint32_t cookie, uint32_t t,
+                             uint16_t *mss_out);
+
+// Rebuild a connection from a validated cookie ACK: `sock` carries the
+// 4-tuple and receive window; it comes out ESTABLISHED, with snd/rcv
+// sequence state taken from `pkt`.
+int netd_tcp_syncookie_accept(tcp_socket_t *sock, const tcp_parsed_t *pkt,
+                              uint16_t mss,
+                              uint64_t now_tsc, uint64_t ticks_per_sec);
+
 // Feed a parsed incoming TCP segment into this socket. Updates state,
 // optionally emits one outbound segment into `resp_buf` (resp_len == 0 if no
 // response). Returns 0 on success, negative on protocol violation (sends RST
@@ -616,17 +850,201 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
                         size_t *resp_len);
 
 // Emit a FIN segment (caller: transitions ESTABLISHED→FIN_WAIT1 or
-// CLOSE_WAIT→LAST_ACK). Writes the segment into `fin_buf`.
+// CLOSE_WAIT→LAST_ACK). Writes the segment into `fin_buf`. Phase 26: the
+// FIN takes its place at snd_nxt, so the owner calls this only once every
+// queued byte has been sent; `now_tsc` arms the retransmit timer for it.
 int netd_tcp_close(tcp_socket_t *sock,
-                   uint8_t *fin_buf, size_t fin_buf_cap, size_t *fin_len);
+                   uint8_t *fin_buf, size_t fin_buf_cap, size_t *fin_len,
+                   uint64_t now_tsc, uint64_t ticks_per_sec);
 
 // Periodic tick: reap TIME_WAIT sockets, retransmit if RTO has fired, kill
 // sockets with RTO-exceeded retries. `retx_buf` is a per-socket scratch
 // buffer used if retransmission is emitted; `retx_len` == 0 means no action.
+// Phase 26: a data RTO emits nothing itself — it rewinds snd_nxt to snd_una
+// (TCP_CA_LOSS) and the owner's next output pass resends from there; with
+// nothing in flight the timer is the persist timer and sets `probe`.
 int netd_tcp_tick(tcp_socket_t *sock,
                   uint64_t now_tsc, uint64_t ticks_per_sec,
                   uint8_t *retx_buf, size_t retx_buf_cap, size_t *retx_len);
 
+// ---------------------------------------------------------------------------
+// Phase 26: data transfer. The state machine keeps the sequence and
+// recovery bookkeeping; the owner keeps the bytes — a send buffer holding
+// [snd_una, queued_end) and a receive buffer whose free space it mirrors
+// into rcv_wnd before each call.
+// ---------------------------------------------------------------------------
+
+// Payload bytes per segment once per-segment options are paid for.
+uint16_t netd_tcp_eff_mss(const tcp_socket_t *sock);
+
+// Window field for an outgoing segment (scaled unless `syn`); records the
+// right edge in rcv_adv.
+uint16_t netd_tcp_adv_window(tcp_socket_t *sock, int syn);
+
+// Option block for a non-SYN segment: timestamps when negotiated, plus —
+// if `with_sack` — as many rcv_sack blocks as fit. Returns its length
+// (multiple of 4, <= 40).
+size_t netd_tcp_write_options(const tcp_socket_t *sock, uint8_t *opt,
+                              uint64_t now_tsc, uint64_t ticks_per_sec,
+                              int with_sack);
+
+// Which part of pkt's payload lands in the receive window: bytes
+// payload[*skip, *skip + *len) belong *off bytes past rcv_nxt. Returns 0 if
+// none does. netd_tcp_on_segment records the span it actually accepted in
+// rcv_seg_*, and the owner copies only that: a segment rejected on its ACK
+// field must not overwrite held out-of-order bytes.
+int netd_tcp_rcv_clip(const tcp_socket_t *sock, const tcp_parsed_t *pkt,
+                      uint32_t *off, uint32_t *skip, uint32_t *len);
+
+// Bytes the network is believed to hold (RFC 6675 "pipe").
+uint32_t netd_tcp_pipe(const tcp_socket_t *sock);
+
+// Plan the next transmission: a hole to repair while in RECOVERY, else
+// data from snd_nxt (skipping SACKed ranges after a rewind) up to
+// queued_end, within cwnd, the peer's window and max_len. Returns 1 and
+// fills [*seq, *seq + *len), or 0 if nothing may go out now.
+int netd_tcp_next_segment(const tcp_socket_t *sock, uint32_t queued_end,
+                          uint32_t max_len, uint32_t *seq, uint32_t *len);
+
+// Account for a segment just transmitted: advances snd_nxt / snd_max or the
+// retransmit cursor, arms the RTO and starts an RTT probe (Karn-safe).
+void netd_tcp_sent(tcp_socket_t *sock, uint32_t seq, uint32_t len,
+                   uint64_t now_tsc, uint64_t ticks_per_sec);
+
+// ---------------------------------------------------------------------------
+// Phase 26: congestion control (netd_tcp_cc.c). Dispatches on cc_algo.
+// ---------------------------------------------------------------------------
+void netd_tcp_cc_init(tcp_socket_t *sock);
+// snd_una advanced by `acked` outside fast recovery.
+void netd_tcp_cc_on_ack(tcp_socket_t *sock, uint32_t acked,
+                        uint64_t now_tsc, uint64_t ticks_per_sec);
+// Fast retransmit: set ssthresh and cwnd for recovery.
+void netd_tcp_cc_on_loss(tcp_socket_t *sock, uint64_t now_tsc);
+// Retransmission timeout: ssthresh (first timeout only) and a one-segment cwnd.
+void netd_tcp_cc_on_rto(tcp_socket_t *sock, uint64_t now_tsc);
+
+// ===========================================================================
+// Phase 26: multi-core sharding (netd_shard.c).
+//
+// netd runs as a front process plus up to NETD_MAX_SHARDS - 1 workers
+// spawned from the same binary, each pinned to its own CPU. Every shard —
+// the front is shard 0 — owns a disjoint set of TCP connections with its
+// own socket table, demux hash and timer wheel. The front keeps the NIC,
+// ARP, DHCP, DNS, ICMP, UDP and the service channel, and steers each
+// inbound TCP segment to its shard by a hash of the 4-tuple (software RSS).
+// Segments and frames cross between the front and a worker in a pair of
+// netd_fring_t rings laid out in one shared VMO.
+// ===========================================================================
+#define NETD_MAX_SHARDS  4u
+
+// Shard owning (local_ip, local_port) <-> (remote_ip, remote_port) out of
+// `nshards`. `seed` is per boot and shared by every shard, unlike the demux
+// hash seed, so the steering step and an active open agree on the answer.
+uint32_t netd_shard_steer(uint32_t seed, uint32_t local_ip, uint16_t local_port,
+                          uint32_t remote_ip, uint16_t remote_port,
+                          uint32_t nshards);
+
+// Socket cookies carry their shard: the next cookie for `shard` out of
+// *counter, always with cookie % nshards == shard and never 0. With one
+// shard this is the plain counter.
+uint32_t netd_shard_cookie(uint32_t *counter, uint32_t shard, uint32_t nshards);
+
+static inline uint32_t netd_shard_of_cookie(uint32_t cookie, uint32_t nshards) {
+    return nshards > 1u ? cookie % nshards : 0u;
+}
+
+// ---------------------------------------------------------------------------
+// Single-producer / single-consumer record ring. Records are 8-byte aligned
+// and never wrap: when the next one does not fit before the end, a PAD
+// record fills the tail. The byte counters are free-running and the
+// doorbell follows the rawframe ring: the consumer arms `kick` before it
+// sleeps, the producer exchanges it back to 0 after publishing and wakes
+// the consumer only if it was set.
+// ---------------------------------------------------------------------------
+typedef struct netd_fring_ctl {
+    volatile uint32_t prod;     // Producer's cache line
+    uint32_t _pad0[15];
+    volatile uint32_t cons;     // Consumer's cache line
+    volatile uint32_t kick;
+    uint32_t _pad1[14];
+} netd_fring_ctl_t;
+
+_Static_assert(sizeof(netd_fring_ctl_t) == 128, "netd_fring_ctl layout drift");
+
+#define NETD_FRING_KIND_PAD   0u
+#define NETD_FRING_KIND_IPV4  1u   // Front -> worker: an IPv4 packet; flags = NETD_CSUM_*
+#define NETD_FRING_KIND_ETH   2u   // Worker -> front: an Ethernet frame, destination
+                                   //   MAC left for the front; flags/mss = RAWFRAME_TX_*
+
+typedef struct netd_fring_rec {
+    uint32_t len;               // Payload bytes (the payload follows)
+    uint8_t  kind;              // NETD_FRING_KIND_*
+    uint8_t  flags;
+    uint16_t mss;
+} netd_fring_rec_t;
+
+typedef struct netd_fring {
+    netd_fring_ctl_t *ctl;
+    uint8_t  *data;
+    uint32_t  cap;              // Power of two, >= 64
+    uint32_t  pos;              // Producer: next write; consumer: next read
+    uint32_t  pend;             // Producer: bytes reserved, not yet committed
+    uint32_t  rec;              // Producer: reserved record's offset past any pad
+} netd_fring_t;
+
+// Attach one side to a ring whose control block and `cap` data bytes are
+// already mapped; its cursor starts at that side's current counter.
+void netd_fring_init(netd_fring_t *r, netd_fring_ctl_t *ctl,
+                     uint8_t *data, uint32_t cap, int producer);
+
+// Producer: room for a `len`-byte record of `kind`; returns where its
+// payload goes, or NULL while the ring is full (or `len` never fits).
+uint8_t *netd_fring_reserve(netd_fring_t *r, uint32_t len, uint8_t kind);
+// Publish the reserved record with its flags / mss. Returns 1 when the
+// consumer is asleep and needs a doorbell.
+int netd_fring_commit(netd_fring_t *r, uint8_t flags, uint16_t mss);
+
+// Consumer: the next record (pads skipped), or NULL when empty. A record
+// that does not fit the published bytes ends the stream: everything up to
+// `prod` is dropped.
+const netd_fring_rec_t *netd_fring_peek(netd_fring_t *r);
+// Step past the record peek returned; the producer sees the space only
+// after netd_fring_release.
+void netd_fring_pop(netd_fring_t *r);
+void netd_fring_release(netd_fring_t *r);
+// Before sleeping: release, arm the doorbell and look again. Returns 1 if
+// records arrived meanwhile (don't sleep).
+int  netd_fring_arm(netd_fring_t *r);
+
+// ---------------------------------------------------------------------------
+// Timer wheel over socket indices: NETD_TWHEEL_SLOTS buckets of one tick
+// each, with deadlines past one revolution left in their bucket until
+// their round comes (lazy rounds). A socket has at most one deadline; arm
+// replaces it. Expiry visits only the buckets the clock passed, so a shard
+// with a thousand idle connections costs nothing per tick.
+// ---------------------------------------------------------------------------
+#define NETD_TWHEEL_SLOTS  256u
+#define NETD_TWHEEL_NONE   0xFFFFu
+
+typedef struct netd_twheel {
+    uint64_t tick_tsc;                  // Span of one bucket
+    uint64_t now_tick;                  // First bucket not yet expired
+    uint16_t head[NETD_TWHEEL_SLOTS];
+    uint16_t next[TCP_MAX_SOCKETS];
+    uint16_t prev[TCP_MAX_SOCKETS];
+    uint64_t due[TCP_MAX_SOCKETS];      // Absolute tick; 0 = not armed
+} netd_twheel_t;
+
+void netd_twheel_init(netd_twheel_t *w, uint64_t now_tsc, uint64_t tick_tsc);
+// (Re)arm `id` for `due_tsc`, rounded up to a tick; a deadline already
+// past fires on the next expiry.
+void netd_twheel_arm(netd_twheel_t *w, uint32_t id, uint64_t due_tsc);
+void netd_twheel_cancel(netd_twheel_t *w, uint32_t id);
+// Disarm and write out up to `cap` ids due by `now_tsc`; returns how many.
+// A full `out` leaves the rest for the next call.
+uint32_t netd_twheel_expire(netd_twheel_t *w, uint64_t now_tsc,
+                            uint32_t *out, uint32_t cap);
+
 // ===========================================================================
 // L7: DNS resolver (RFC 1035) — pure wire helpers.
 // ===========================================================================
@@ -777,6 +1195,18 @@ static inline void netd_memzero(void *dst, size_t n) {
     for (size_t i = 0; i < n; i++) d[i] = 0;
 }
 
+// Phase 26: 32-bit mixer (murmur3 finaliser) for the demux hashes. `seed`
+// is per-table so remote peers cannot aim traffic at one chain.
+static inline uint32_t netd_hash32(uint32_t x, uint32_t seed) {
+    x ^= seed;
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
 // Read/write be16/be32 from unaligned byte streams.
 static inline uint16_t netd_read_be16(const uint8_t *p) {
     return ((uint16_t)p[0] << 8) | (uint16_t)p[1];
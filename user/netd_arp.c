@@ -1,59 +1,105 @@
 // user/netd_arp.c — Phase 22 Stage B: ARP (RFC 826) implementation.
 //
-// A tiny 16-entry table backed by per-slot state (FREE/RESOLVED/PENDING).
-// Lookup is O(n) linear scan — with n=16 this is ~80 ns in the worst case
-// on the target hardware, vastly lower than the frame rate budget. No
-// hashing because the cost would exceed the scan. LRU eviction via
-// round-robin cursor when the table is full.
+// A small table backed by per-slot state (FREE/RESOLVED/PENDING).
+//
+// Phase 26: the table is open-addressed on the IP — linear probing from
+// the IP's home slot, no tombstones (deletes shift the rest of the probe
+// run back instead), so lookup and refresh touch a handful of entries
+// however many hosts are cached. A full table evicts the entry closest to
+// expiry, i.e. the least recently confirmed one, rather than whatever a
+// round-robin cursor happened to point at.
 //
 // PENDING entries dedupe concurrent ARP requests: netd_arp_resolve returns
 // without emitting a new request if a PENDING entry exists and hasn't yet
 // expired. The caller (netd main loop) is responsible for re-calling
 // netd_arp_resolve periodically — on reply, the entry flips to RESOLVED;
-// on timeout, to FREE and a fresh request cycle may begin.
+// on timeout, to FREE and a fresh request cycle may begin. netd_arp_gc
+// frees both kinds once they expire.
 
 #include "netd.h"
 
+#define ARP_SLOT_MASK  (ARP_TABLE_SLOTS - 1u)
+
+static inline uint32_t arp_home(uint32_t ip) {
+    return netd_hash32(ip, 0) & ARP_SLOT_MASK;
+}
+
 void netd_arp_init(arp_table_t *tbl) {
     if (!tbl) return;
     netd_memzero(tbl, sizeof(*tbl));
     // Zeroed state == ARP_STATE_FREE by construction.
-    tbl->next_slot = 0;
+}
+
+// Slot holding `ip` (any non-FREE state), or -1. A probe run ends at the
+// first FREE slot, which backward-shift deletion keeps true.
+static int arp_find(const arp_table_t *tbl, uint32_t ip) {
+    uint32_t i = arp_home(ip);
+    for (uint32_t n = 0; n < ARP_TABLE_SLOTS; n++) {
+        const arp_entry_t *e = &tbl->entries[i];
+        if (e->state == ARP_STATE_FREE) return -1;
+        if (e->ip == ip) return (int)i;
+        i = (i + 1u) & ARP_SLOT_MASK;
+    }
+    return -1;
+}
+
+// Free slot `i` and pull later members of its probe run back so no run
+// is left with a hole in it.
+static void arp_delete(arp_table_t *tbl, uint32_t i) {
+    netd_memzero(&tbl->entries[i], sizeof(arp_entry_t));
+    tbl->used--;
+    uint32_t j = i;
+    for (;;) {
+        j = (j + 1u) & ARP_SLOT_MASK;
+        arp_entry_t *e = &tbl->entries[j];
+        if (e->state == ARP_STATE_FREE) return;
+        // e may fill the hole only if its home is not cyclically in (i, j].
+        uint32_t k = arp_home(e->ip);
+        if (((j - k) & ARP_SLOT_MASK) < ((j - i) & ARP_SLOT_MASK)) continue;
+        tbl->entries[i] = *e;
+        netd_memzero(e, sizeof(*e));
+        i = j;
+    }
 }
 
 int netd_arp_lookup(const arp_table_t *tbl, uint32_t ip,
                     uint8_t out_mac[ETH_ALEN]) {
     if (!tbl) return 0;
-    for (uint32_t i = 0; i < ARP_TABLE_SLOTS; i++) {
-        const arp_entry_t *e = &tbl->entries[i];
-        if (e->state == ARP_STATE_RESOLVED && e->ip == ip) {
-            if (out_mac) {
-                for (int k = 0; k < ETH_ALEN; k++) out_mac[k] = e->mac[k];
-            }
-            return 1;
-        }
+    int i = arp_find(tbl, ip);
+    if (i < 0) return 0;
+    const arp_entry_t *e = &tbl->entries[i];
+    if (e->state != ARP_STATE_RESOLVED) return 0;
+    if (out_mac) {
+        for (int k = 0; k < ETH_ALEN; k++) out_mac[k] = e->mac[k];
     }
-    return 0;
+    return 1;
 }
 
-// Find the best slot to claim for `ip`:
+// Find the slot to claim for `ip`:
 //   (1) An existing RESOLVED/PENDING entry for the same IP (refresh).
-//   (2) The first FREE slot.
-//   (3) Round-robin via next_slot if table is full.
+//   (2) The first FREE slot on its probe run.
+//   (3) If the table is full, free the entry closest to expiry first.
 static uint32_t netd_arp_choose_slot(arp_table_t *tbl, uint32_t ip) {
-    // Pass 1: matching IP wins (even if PENDING — a reply always updates).
-    for (uint32_t i = 0; i < ARP_TABLE_SLOTS; i++) {
-        const arp_entry_t *e = &tbl->entries[i];
-        if (e->state != ARP_STATE_FREE && e->ip == ip) return i;
+    // Matching IP wins (even if PENDING — a reply always updates).
+    int hit = arp_find(tbl, ip);
+    if (hit >= 0) return (uint32_t)hit;
+
+    if (tbl->used >= ARP_TABLE_SLOTS) {
+        uint32_t victim = 0;
+        for (uint32_t i = 1; i < ARP_TABLE_SLOTS; i++) {
+            if (tbl->entries[i].expiry_tsc < tbl->entries[victim].expiry_tsc) {
+                victim = i;
+            }
+        }
+        arp_delete(tbl, victim);
     }
-    // Pass 2: first FREE slot.
-    for (uint32_t i = 0; i < ARP_TABLE_SLOTS; i++) {
-        if (tbl->entries[i].state == ARP_STATE_FREE) return i;
+
+    uint32_t i = arp_home(ip);
+    while (tbl->entries[i].state != ARP_STATE_FREE) {
+        i = (i + 1u) & ARP_SLOT_MASK;
     }
-    // Pass 3: round-robin eviction.
-    uint32_t slot = tbl->next_slot % ARP_TABLE_SLOTS;
-    tbl->next_slot = (slot + 1) % ARP_TABLE_SLOTS;
-    return slot;
+    tbl->used++;
+    return i;
 }
 
 void netd_arp_insert(arp_table_t *tbl, uint32_t ip,
@@ -74,12 +120,16 @@ void netd_arp_insert(arp_table_t *tbl, uint32_t ip,
 uint32_t netd_arp_gc(arp_table_t *tbl, uint64_t now_tsc) {
     if (!tbl) return 0;
     uint32_t aged = 0;
-    for (uint32_t i = 0; i < ARP_TABLE_SLOTS; i++) {
+    uint32_t i = 0;
+    while (i < ARP_TABLE_SLOTS) {
         arp_entry_t *e = &tbl->entries[i];
-        if (e->state == ARP_STATE_RESOLVED && now_tsc >= e->expiry_tsc) {
-            netd_memzero(e, sizeof(*e));
+        if (e->state != ARP_STATE_FREE && now_tsc >= e->expiry_tsc) {
+            // The shift may move a later entry into slot i; look again.
+            arp_delete(tbl, i);
             aged++;
+            continue;
         }
+        i++;
     }
     return aged;
 }
@@ -215,17 +265,19 @@ int netd_arp_resolve(arp_table_t *tbl,
                      size_t *req_len) {
     if (req_len) *req_len = 0;
 
-    // Fast path: cached RESOLVED entry.
-    if (netd_arp_lookup(tbl, target_ip, out_mac)) return 1;
-
-    // Dedup: if a PENDING entry exists and hasn't expired, don't emit a
-    // duplicate request — the caller should just wait a bit longer.
-    for (uint32_t i = 0; i < ARP_TABLE_SLOTS; i++) {
+    int i = arp_find(tbl, target_ip);
+    if (i >= 0 && now_tsc < tbl->entries[i].expiry_tsc) {
         const arp_entry_t *e = &tbl->entries[i];
-        if (e->state == ARP_STATE_PENDING && e->ip == target_ip &&
-            now_tsc < e->expiry_tsc) {
-            return 0;  // Pending — caller keeps waiting.
+        // Fast path: cached RESOLVED entry that has not gone stale.
+        if (e->state == ARP_STATE_RESOLVED) {
+            if (out_mac) {
+                for (int k = 0; k < ETH_ALEN; k++) out_mac[k] = e->mac[k];
+            }
+            return 1;
         }
+        // Dedup: a live PENDING entry means a request is already out —
+        // the caller should just wait a bit longer.
+        return 0;
     }
 
     // Insert PENDING, emit request frame.
@@ -75,6 +75,11 @@ size_t netd_ipv4_build_header(uint8_t *out_hdr,
 }
 
 int netd_ipv4_parse(const uint8_t *buf, size_t buf_len, ipv4_parsed_t *out) {
+    return netd_ipv4_parse_csum(buf, buf_len, 0, out);
+}
+
+int netd_ipv4_parse_csum(const uint8_t *buf, size_t buf_len, uint8_t nic_ok,
+                         ipv4_parsed_t *out) {
     if (!buf || !out) return -1;
     if (buf_len < IPV4_HDR_LEN_MIN) return -1;
 
@@ -103,8 +108,10 @@ int netd_ipv4_parse(const uint8_t *buf, size_t buf_len, ipv4_parsed_t *out) {
 
     // Verify header checksum. RFC 1071: sum must fold to 0xFFFF across the
     // header when the checksum field is included in the sum as-stored.
-    uint16_t csum_be = netd_inet_checksum(buf, IPV4_HDR_LEN_MIN, 0);
-    if (csum_be != 0) return -5;
+    if (!(nic_ok & NETD_CSUM_IP_OK)) {
+        uint16_t csum_be = netd_inet_checksum(buf, IPV4_HDR_LEN_MIN, 0);
+        if (csum_be != 0) return -5;
+    }
 
     out->src         = src;
     out->dst         = dst;
@@ -113,6 +120,7 @@ int netd_ipv4_parse(const uint8_t *buf, size_t buf_len, ipv4_parsed_t *out) {
     out->total_len   = total_len;
     out->id          = id;
     out->flags_frag  = flags_frag;
+    out->nic_csum    = nic_ok;
     out->payload     = buf + IPV4_HDR_LEN_MIN;
     out->payload_len = (size_t)total_len - IPV4_HDR_LEN_MIN;
     return 0;
@@ -0,0 +1,200 @@
+// user/netd_shard.c — Phase 26: the pure parts of multi-core netd.
+//
+//   Steering — which shard owns a 4-tuple, and the cookie numbering that
+//              lets the front route a client's socket op without a lookup.
+//   Frame rings — the SPSC record rings between the front and a worker:
+//              steered segments one way, frames to transmit the other.
+//   Timer wheel — per-shard TCP deadlines, so a tick visits only sockets
+//              whose retransmit / persist / TIME_WAIT timer is due.
+//
+// All three are plain data structures over caller-owned memory; netd.c
+// decides what lives where (see "Shards" there).
+
+#include "netd.h"
+
+// ====================================================================
+// Steering.
+// ====================================================================
+uint32_t netd_shard_steer(uint32_t seed, uint32_t local_ip, uint16_t local_port,
+                          uint32_t remote_ip, uint16_t remote_port,
+                          uint32_t nshards) {
+    if (nshards <= 1u) return 0;
+    uint32_t h = netd_hash32(remote_ip, seed);
+    h = netd_hash32(h ^ local_ip, seed);
+    h = netd_hash32(h ^ (((uint32_t)local_port << 16) | remote_port), seed);
+    // Multiply-shift: uniform over any shard count, not just powers of two.
+    return (uint32_t)(((uint64_t)h * nshards) >> 32);
+}
+
+uint32_t netd_shard_cookie(uint32_t *counter, uint32_t shard, uint32_t nshards) {
+    if (nshards == 0) nshards = 1;
+    // Restart before counter * nshards + shard would wrap: past that point
+    // the residue no longer names the shard.
+    if (*counter == 0 || *counter > (0xFFFFFFFFu - shard) / nshards) *counter = 1;
+    return (*counter)++ * nshards + shard;
+}
+
+// ====================================================================
+// Frame rings.
+// ====================================================================
+#define FRING_HDR  ((uint32_t)sizeof(netd_fring_rec_t))
+
+static inline uint32_t fring_align(uint32_t n) {
+    return (n + 7u) & ~7u;
+}
+
+static inline netd_fring_rec_t *fring_at(const netd_fring_t *r, uint32_t pos) {
+    return (netd_fring_rec_t *)(r->data + (pos & (r->cap - 1u)));
+}
+
+void netd_fring_init(netd_fring_t *r, netd_fring_ctl_t *ctl,
+                     uint8_t *data, uint32_t cap, int producer) {
+    r->ctl  = ctl;
+    r->data = data;
+    r->cap  = cap;
+    r->pos  = producer ? __atomic_load_n(&ctl->prod, __ATOMIC_ACQUIRE)
+                       : __atomic_load_n(&ctl->cons, __ATOMIC_ACQUIRE);
+    r->pend = 0;
+    r->rec  = 0;
+}
+
+uint8_t *netd_fring_reserve(netd_fring_t *r, uint32_t len, uint8_t kind) {
+    uint32_t need = FRING_HDR + fring_align(len);
+    if (len > r->cap / 2u || need > r->cap / 2u) return NULL;
+    uint32_t off  = r->pos & (r->cap - 1u);
+    uint32_t tail = r->cap - off;
+    uint32_t pad  = (tail < need) ? tail : 0;
+    uint32_t cons = __atomic_load_n(&r->ctl->cons, __ATOMIC_ACQUIRE);
+    if ((r->pos - cons) + pad + need > r->cap) return NULL;
+
+    if (pad) {
+        netd_fring_rec_t *p = fring_at(r, r->pos);
+        p->len   = pad - FRING_HDR;
+        p->kind  = NETD_FRING_KIND_PAD;
+        p->flags = 0;
+        p->mss   = 0;
+    }
+    netd_fring_rec_t *h = fring_at(r, r->pos + pad);
+    h->len   = len;
+    h->kind  = kind;
+    h->flags = 0;
+    h->mss   = 0;
+    r->pend  = pad + need;
+    r->rec   = pad;
+    return (uint8_t *)(h + 1);
+}
+
+int netd_fring_commit(netd_fring_t *r, uint8_t flags, uint16_t mss) {
+    if (r->pend == 0) return 0;
+    netd_fring_rec_t *h = fring_at(r, r->pos + r->rec);
+    h->flags = flags;
+    h->mss   = mss;
+    r->pos  += r->pend;
+    r->pend  = 0;
+    __atomic_store_n(&r->ctl->prod, r->pos, __ATOMIC_SEQ_CST);
+    return __atomic_exchange_n(&r->ctl->kick, 0u, __ATOMIC_ACQ_REL) != 0;
+}
+
+const netd_fring_rec_t *netd_fring_peek(netd_fring_t *r) {
+    for (;;) {
+        uint32_t prod = __atomic_load_n(&r->ctl->prod, __ATOMIC_ACQUIRE);
+        uint32_t avail = prod - r->pos;
+        if (avail == 0) return NULL;
+        uint32_t off = r->pos & (r->cap - 1u);
+        const netd_fring_rec_t *h = fring_at(r, r->pos);
+        uint32_t size = FRING_HDR + fring_align(h->len);
+        if (avail > r->cap || avail < FRING_HDR || h->len > r->cap ||
+            size > avail || size > r->cap - off) {
+            r->pos = prod;      // Corrupt: drop what was published
+            return NULL;
+        }
+        if (h->kind != NETD_FRING_KIND_PAD) return h;
+        r->pos += size;
+    }
+}
+
+void netd_fring_pop(netd_fring_t *r) {
+    const netd_fring_rec_t *h = fring_at(r, r->pos);
+    r->pos += FRING_HDR + fring_align(h->len);
+}
+
+void netd_fring_release(netd_fring_t *r) {
+    __atomic_store_n(&r->ctl->cons, r->pos, __ATOMIC_RELEASE);
+}
+
+int netd_fring_arm(netd_fring_t *r) {
+    netd_fring_release(r);
+    __atomic_store_n(&r->ctl->kick, 1u, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&r->ctl->prod, __ATOMIC_SEQ_CST) != r->pos;
+}
+
+// ====================================================================
+// Timer wheel.
+// ====================================================================
+static void twheel_unlink(netd_twheel_t *w, uint32_t id) {
+    uint16_t n = w->next[id], p = w->prev[id];
+    if (p != NETD_TWHEEL_NONE) w->next[p] = n;
+    else w->head[w->due[id] & (NETD_TWHEEL_SLOTS - 1u)] = n;
+    if (n != NETD_TWHEEL_NONE) w->prev[n] = p;
+    w->due[id] = 0;
+}
+
+void netd_twheel_init(netd_twheel_t *w, uint64_t now_tsc, uint64_t tick_tsc) {
+    if (tick_tsc == 0) tick_tsc = 1;
+    w->tick_tsc = tick_tsc;
+    w->now_tick = now_tsc / tick_tsc;
+    if (w->now_tick == 0) w->now_tick = 1;      // due == 0 means "not armed"
+    for (uint32_t i = 0; i < NETD_TWHEEL_SLOTS; i++) w->head[i] = NETD_TWHEEL_NONE;
+    for (uint32_t i = 0; i < TCP_MAX_SOCKETS; i++) {
+        w->next[i] = w->prev[i] = NETD_TWHEEL_NONE;
+        w->due[i]  = 0;
+    }
+}
+
+void netd_twheel_arm(netd_twheel_t *w, uint32_t id, uint64_t due_tsc) {
+    if (id >= TCP_MAX_SOCKETS) return;
+    uint64_t t = due_tsc / w->tick_tsc + ((due_tsc % w->tick_tsc) ? 1u : 0u);
+    if (t < w->now_tick) t = w->now_tick;
+    if (w->due[id] == t) return;
+    if (w->due[id]) twheel_unlink(w, id);
+    uint32_t s = (uint32_t)(t & (NETD_TWHEEL_SLOTS - 1u));
+    w->due[id]  = t;
+    w->prev[id] = NETD_TWHEEL_NONE;
+    w->next[id] = w->head[s];
+    if (w->head[s] != NETD_TWHEEL_NONE) w->prev[w->head[s]] = (uint16_t)id;
+    w->head[s] = (uint16_t)id;
+}
+
+void netd_twheel_cancel(netd_twheel_t *w, uint32_t id) {
+    if (id < TCP_MAX_SOCKETS && w->due[id]) twheel_unlink(w, id);
+}
+
+uint32_t netd_twheel_expire(netd_twheel_t *w, uint64_t now_tsc,
+                            uint32_t *out, uint32_t cap) {
+    uint64_t target = now_tsc / w->tick_tsc;
+    if (target < w->now_tick) return 0;
+    // After a long gap one pass over every bucket finds everything due:
+    // entries are compared against `target`, not the bucket's own tick.
+    uint64_t last = target;
+    if (target - w->now_tick >= NETD_TWHEEL_SLOTS) {
+        last = w->now_tick + NETD_TWHEEL_SLOTS - 1u;
+    }
+    uint32_t n = 0;
+    for (uint64_t t = w->now_tick; t <= last; t++) {
+        uint16_t id = w->head[t & (NETD_TWHEEL_SLOTS - 1u)];
+        while (id != NETD_TWHEEL_NONE) {
+            uint16_t nx = w->next[id];
+            if (w->due[id] <= target) {
+                if (n == cap) {
+                    w->now_tick = t;        // Resume at this bucket
+                    return n;
+                }
+                twheel_unlink(w, id);
+                out[n++] = id;
+            }
+            id = nx;
+        }
+    }
+    w->now_tick = target + 1u;
+    return n;
+}
@@ -17,6 +17,18 @@
 //     implemented (RSTs with wrong SEQ are ignored rather than honored).
 //   - Zero-window probing is deferred (MVP receivers advertise static window).
 //
+// Phase 26 replaces the Stage B shortcuts on the data path:
+//   - RFC 7323 window scaling + timestamps and RFC 2018 SACK, each offered
+//     per socket (opts_offer) and used only if the peer offers it too.
+//   - Out-of-order data is held (the owner keeps the bytes, rcv_sack[] the
+//     ranges) and reported in SACK blocks; a FIN counts only in sequence.
+//   - Loss recovery: 3 dup-ACKs (or > 2 MSS SACKed) enter fast recovery —
+//     RFC 6675 hole repair with SACK, RFC 6582 NewReno without. An RTO
+//     rewinds snd_nxt go-back-N style; with nothing in flight (or a zero
+//     window) it is the persist timer instead.
+//   - RFC 6298 RTT estimation (timestamps, else one timed segment per RTT).
+//   - Window growth is delegated to netd_tcp_cc.c (Reno or CUBIC).
+//
 // The stack is lock-free per socket; the caller (netd main loop) serializes
 // access via a single-threaded event loop. All wire parsing + serialisation
 // lives in this file; the socket table structs are defined in netd.h.
@@ -42,6 +54,24 @@ static uint32_t ms_to_tsc(uint64_t ticks_per_sec, uint32_t ms) {
     return (uint32_t)((ticks_per_sec * (uint64_t)ms) / 1000ull);
 }
 
+// Timestamp clock (RFC 7323 §5.4): 1 ms ticks, wrapping.
+static uint32_t tsc_to_ms(uint64_t ticks_per_sec, uint64_t tsc) {
+    if (ticks_per_sec < 1000u) return (uint32_t)tsc;
+    return (uint32_t)(tsc / (ticks_per_sec / 1000u));
+}
+
+static uint64_t tsc_to_us(uint64_t ticks_per_sec, uint64_t tsc) {
+    if (ticks_per_sec == 0) return 0;
+    if (ticks_per_sec >= 1000000u) return tsc / (ticks_per_sec / 1000000u);
+    return tsc * 1000000u / ticks_per_sec;
+}
+
+static uint32_t seq_max(uint32_t a, uint32_t b) {
+    return seq_cmp(a, b) >= 0 ? a : b;
+}
+
+#define TCP_DUPACK_THRESH  3u   // RFC 5681 §3.2
+
 // ====================================================================
 // Wire build + parse.
 // ====================================================================
@@ -52,14 +82,32 @@ size_t netd_tcp_build(uint8_t *out,
                       uint8_t flags, uint16_t window,
                       uint16_t mss_opt_val,
                       const uint8_t *payload, size_t payload_len) {
-    uint8_t options_len = 0;
     // RFC 793 TCP options: data_offset is in 32-bit words; option data must
     // pad to 4-byte alignment. MSS option is 4 bytes (kind=2, len=4, mss:2).
-    uint8_t want_mss = (mss_opt_val != 0 && (flags & TCP_FLAG_SYN)) ? 1 : 0;
-    if (want_mss) options_len = 4;
+    uint8_t opt[4];
+    size_t  opt_len = 0;
+    if (mss_opt_val != 0 && (flags & TCP_FLAG_SYN)) {
+        opt[0] = TCP_OPT_MSS;
+        opt[1] = 4;
+        netd_write_be16(&opt[2], mss_opt_val);
+        opt_len = 4;
+    }
+    return netd_tcp_build_opts(out, src_ip, dst_ip, src_port, dst_port,
+                               seq, ack, flags, window, opt, opt_len,
+                               payload, payload_len);
+}
 
-    uint8_t tcp_hdr_len = TCP_HDR_LEN_MIN + options_len;
-    size_t total = (size_t)tcp_hdr_len + payload_len;
+size_t netd_tcp_build_opts(uint8_t *out,
+                           uint32_t src_ip, uint32_t dst_ip,
+                           uint16_t src_port, uint16_t dst_port,
+                           uint32_t seq, uint32_t ack,
+                           uint8_t flags, uint16_t window,
+                           const uint8_t *opts, size_t opts_len,
+                           const uint8_t *payload, size_t payload_len) {
+    if ((opts_len & 3u) || opts_len > TCP_HDR_LEN_MAX - TCP_HDR_LEN_MIN) return 0;
+    size_t tcp_hdr_len = TCP_HDR_LEN_MIN + opts_len;
+    size_t total = tcp_hdr_len + payload_len;
+    if (total > 1500) return 0;
 
     netd_write_be16(&out[0], src_port);
     netd_write_be16(&out[2], dst_port);
@@ -71,19 +119,15 @@ size_t netd_tcp_build(uint8_t *out,
     netd_write_be16(&out[16], 0);                  // checksum placeholder
     netd_write_be16(&out[18], 0);                  // URG ptr
 
-    if (want_mss) {
-        out[20] = 2;             // Kind: MSS
-        out[21] = 4;             // Length
-        netd_write_be16(&out[22], mss_opt_val);
+    for (size_t i = 0; i < opts_len; i++) {
+        out[TCP_HDR_LEN_MIN + i] = opts[i];
     }
-
     for (size_t i = 0; i < payload_len; i++) {
         out[tcp_hdr_len + i] = payload[i];
     }
 
     // Pseudo-header + segment checksum. Scratch on stack (max 12 + 1500 = 1512).
     uint8_t scratch[12 + 1500];
-    if (total > 1500) return 0;
     netd_ipv4_build_pseudo_header(scratch, src_ip, dst_ip, IPPROTO_TCP,
                                   (uint16_t)total);
     for (size_t i = 0; i < total; i++) scratch[12 + i] = out[i];
@@ -93,9 +137,47 @@ size_t netd_tcp_build(uint8_t *out,
     return total;
 }
 
+size_t netd_tcp_build_offload(uint8_t *out,
+                              uint32_t src_ip, uint32_t dst_ip,
+                              uint16_t src_port, uint16_t dst_port,
+                              uint32_t seq, uint32_t ack,
+                              uint8_t flags, uint16_t window,
+                              const uint8_t *opts, size_t opts_len,
+                              size_t payload_len, int tso) {
+    if ((opts_len & 3u) || opts_len > TCP_HDR_LEN_MAX - TCP_HDR_LEN_MIN) return 0;
+    size_t tcp_hdr_len = TCP_HDR_LEN_MIN + opts_len;
+    netd_write_be16(&out[0], src_port);
+    netd_write_be16(&out[2], dst_port);
+    netd_write_be32(&out[4], seq);
+    netd_write_be32(&out[8], ack);
+    out[12] = (uint8_t)((tcp_hdr_len / 4) << 4);
+    out[13] = flags;
+    netd_write_be16(&out[14], window);
+    netd_write_be16(&out[18], 0);                  // URG ptr
+    for (size_t i = 0; i < opts_len; i++) {
+        out[TCP_HDR_LEN_MIN + i] = opts[i];
+    }
+
+    // The NIC sums from the TCP header to the end of the frame, including
+    // this field, and stores the complement — so seed it with the
+    // un-complemented pseudo-header sum.
+    uint8_t pseudo[12];
+    uint16_t l4_len = tso ? 0 : (uint16_t)(tcp_hdr_len + payload_len);
+    netd_ipv4_build_pseudo_header(pseudo, src_ip, dst_ip, IPPROTO_TCP, l4_len);
+    uint16_t csum_be = netd_inet_checksum(pseudo, 12, 0);
+    netd_write_be16(&out[16], (uint16_t)~netd_ntohs(csum_be));
+    return tcp_hdr_len;
+}
+
 int netd_tcp_parse(const uint8_t *buf, size_t buf_len,
                    uint32_t src_ip, uint32_t dst_ip,
                    tcp_parsed_t *out) {
+    return netd_tcp_parse_csum(buf, buf_len, src_ip, dst_ip, 0, out);
+}
+
+int netd_tcp_parse_csum(const uint8_t *buf, size_t buf_len,
+                        uint32_t src_ip, uint32_t dst_ip, uint8_t nic_ok,
+                        tcp_parsed_t *out) {
     if (!buf || !out) return -1;
     if (buf_len < TCP_HDR_LEN_MIN) return -1;
 
@@ -103,14 +185,18 @@ int netd_tcp_parse(const uint8_t *buf, size_t buf_len,
     if (data_off_bytes < TCP_HDR_LEN_MIN) return -2;
     if (data_off_bytes > buf_len) return -2;
 
-    // Verify pseudo-header checksum over the whole segment.
-    uint16_t l4_len = (uint16_t)buf_len;
-    uint8_t scratch[12 + 1500];
+    // Verify pseudo-header checksum over the whole segment, unless the NIC
+    // already did.
     if (buf_len > 1500) return -3;
-    netd_ipv4_build_pseudo_header(scratch, src_ip, dst_ip, IPPROTO_TCP, l4_len);
-    for (size_t i = 0; i < buf_len; i++) scratch[12 + i] = buf[i];
-    uint16_t csum = netd_inet_checksum(scratch, 12 + buf_len, 0);
-    if (csum != 0) return -4;
+    if (!(nic_ok & NETD_CSUM_L4_OK)) {
+        uint16_t l4_len = (uint16_t)buf_len;
+        uint8_t scratch[12 + 1500];
+        netd_ipv4_build_pseudo_header(scratch, src_ip, dst_ip, IPPROTO_TCP,
+                                      l4_len);
+        for (size_t i = 0; i < buf_len; i++) scratch[12 + i] = buf[i];
+        uint16_t csum = netd_inet_checksum(scratch, 12 + buf_len, 0);
+        if (csum != 0) return -4;
+    }
 
     out->src_port         = netd_read_be16(&buf[0]);
     out->dst_port         = netd_read_be16(&buf[2]);
@@ -122,9 +208,16 @@ int netd_tcp_parse(const uint8_t *buf, size_t buf_len,
     out->payload          = buf + data_off_bytes;
     out->payload_len      = buf_len - data_off_bytes;
     out->opt_mss          = 0;
+    out->opt_wscale       = 0xFFu;
+    out->opt_sack_perm    = 0;
+    out->opt_ts           = 0;
+    out->sack_n           = 0;
+    out->tsval            = 0;
+    out->tsecr            = 0;
 
-    // Walk options if data_offset > 20. Simple pass for the one option we
-    // care about: MSS (kind=2, len=4). Skip NOPs (kind=1); stop at EOL (kind=0).
+    // Walk options if data_offset > 20. Skip NOPs (kind=1); stop at EOL
+    // (kind=0). MSS, window scale and SACK-permitted only count on a SYN
+    // (RFC 7323 §2.2, RFC 2018 §2); SACK blocks only off one.
     if (data_off_bytes > TCP_HDR_LEN_MIN) {
         const uint8_t *o = buf + TCP_HDR_LEN_MIN;
         size_t olen = data_off_bytes - TCP_HDR_LEN_MIN;
@@ -137,8 +230,39 @@ int netd_tcp_parse(const uint8_t *buf, size_t buf_len,
             if (i + 1 >= olen) return -5;
             uint8_t len = o[i + 1];
             if (len < 2 || i + len > olen) return -5;
-            if (kind == 2 /*MSS*/ && len == 4 && (out->flags & TCP_FLAG_SYN)) {
-                out->opt_mss = netd_read_be16(&o[i + 2]);
+            uint8_t syn = out->flags & TCP_FLAG_SYN;
+            switch (kind) {
+            case TCP_OPT_MSS:
+                if (len == 4 && syn) out->opt_mss = netd_read_be16(&o[i + 2]);
+                break;
+            case TCP_OPT_WSCALE:
+                if (len == 3 && syn) {
+                    out->opt_wscale = o[i + 2] > TCP_MAX_WSCALE ? TCP_MAX_WSCALE
+                                                                : o[i + 2];
+                }
+                break;
+            case TCP_OPT_SACK_PERM:
+                if (len == 2 && syn) out->opt_sack_perm = 1;
+                break;
+            case TCP_OPT_TS:
+                if (len == 10) {
+                    out->opt_ts = 1;
+                    out->tsval  = netd_read_be32(&o[i + 2]);
+                    out->tsecr  = netd_read_be32(&o[i + 6]);
+                }
+                break;
+            case TCP_OPT_SACK:
+                if (!syn && len >= 10 && ((len - 2u) % 8u) == 0) {
+                    for (size_t k = 2; k + 8u <= len &&
+                                       out->sack_n < TCP_SACK_MAX_BLOCKS; k += 8) {
+                        out->sack[out->sack_n].start = netd_read_be32(&o[i + k]);
+                        out->sack[out->sack_n].end   = netd_read_be32(&o[i + k + 4]);
+                        out->sack_n++;
+                    }
+                }
+                break;
+            default:
+                break;
             }
             i += len;
         }
@@ -156,9 +280,12 @@ void netd_tcp_table_init(tcp_table_t *tbl) {
 
 // Marker: slots with owner_cookie == 0 are free. Callers MUST pass a nonzero
 // owner_cookie (any stable identifier — client channel handle, PID, etc.).
+// Phase 26: the scan resumes after the last slot handed out, so with most
+// of a large table busy an allocation doesn't re-walk the busy prefix.
 int netd_tcp_socket_alloc(tcp_table_t *tbl, uint32_t owner_cookie) {
     if (!tbl || owner_cookie == 0) return -1;
-    for (uint32_t i = 0; i < TCP_MAX_SOCKETS; i++) {
+    for (uint32_t n = 0; n < TCP_MAX_SOCKETS; n++) {
+        uint32_t i = (tbl->alloc_hint + n) & (TCP_MAX_SOCKETS - 1u);
         tcp_socket_t *s = &tbl->sockets[i];
         if (s->owner_cookie == 0) {
             netd_memzero(s, sizeof(*s));
@@ -166,6 +293,8 @@ int netd_tcp_socket_alloc(tcp_table_t *tbl, uint32_t owner_cookie) {
             s->owner_cookie = owner_cookie;
             s->rcv_wnd      = TCP_DEFAULT_WINDOW;
             s->mss          = TCP_DEFAULT_MSS;
+            s->cc_algo      = TCP_CC_DEFAULT;
+            tbl->alloc_hint = i + 1u;
             return (int)i;
         }
     }
@@ -174,20 +303,91 @@ int netd_tcp_socket_alloc(tcp_table_t *tbl, uint32_t owner_cookie) {
 
 void netd_tcp_socket_free(tcp_table_t *tbl, int idx) {
     if (!tbl || idx < 0 || (uint32_t)idx >= TCP_MAX_SOCKETS) return;
+    netd_tcp_hash_remove(tbl, idx);
     netd_memzero(&tbl->sockets[idx], sizeof(tbl->sockets[idx]));
 }
 
+// --------------------------------------------------------------------
+// Phase 26 demux index.
+// --------------------------------------------------------------------
+static uint32_t tcp_est_bucket(const tcp_table_t *tbl,
+                               uint32_t local_ip, uint16_t local_port,
+                               uint32_t remote_ip, uint16_t remote_port) {
+    uint32_t h = netd_hash32(remote_ip, tbl->hash_seed);
+    h = netd_hash32(h ^ local_ip, tbl->hash_seed);
+    h = netd_hash32(h ^ (((uint32_t)local_port << 16) | remote_port),
+                    tbl->hash_seed);
+    return h & (TCP_EST_BUCKETS - 1u);
+}
+
+static inline uint32_t tcp_listen_bucket(uint16_t local_port) {
+    return local_port & (TCP_LISTEN_BUCKETS - 1u);
+}
+
+void netd_tcp_hash_remove(tcp_table_t *tbl, int idx) {
+    if (!tbl || idx < 0 || (uint32_t)idx >= TCP_MAX_SOCKETS) return;
+    uint16_t *link;
+    switch (tbl->hashed[idx]) {
+    case TCP_HASHED_EST:    link = &tbl->est_head[tbl->hash_bucket[idx]];    break;
+    case TCP_HASHED_LISTEN: link = &tbl->listen_head[tbl->hash_bucket[idx]]; break;
+    default:                return;
+    }
+    while (*link && *link != (uint16_t)(idx + 1)) link = &tbl->hash_next[*link - 1u];
+    if (*link) *link = tbl->hash_next[idx];
+    tbl->hash_next[idx] = 0;
+    tbl->hashed[idx]    = TCP_HASHED_NONE;
+}
+
+int netd_tcp_hash_insert(tcp_table_t *tbl, int idx) {
+    if (!tbl || idx < 0 || (uint32_t)idx >= TCP_MAX_SOCKETS) return -1;
+    netd_tcp_hash_remove(tbl, idx);
+
+    const tcp_socket_t *s = &tbl->sockets[idx];
+    uint8_t   kind;
+    uint32_t  b;
+    uint16_t *head;
+    if (s->state == TCP_STATE_LISTEN) {
+        kind = TCP_HASHED_LISTEN;
+        b    = tcp_listen_bucket(s->local_port);
+        head = &tbl->listen_head[b];
+        for (uint16_t l = *head; l; l = tbl->hash_next[l - 1u]) {
+            const tcp_socket_t *o = &tbl->sockets[l - 1u];
+            if (o->local_port == s->local_port && o->local_ip == s->local_ip) {
+                return -2;
+            }
+        }
+    } else {
+        kind = TCP_HASHED_EST;
+        b    = tcp_est_bucket(tbl, s->local_ip, s->local_port,
+                              s->remote_ip, s->remote_port);
+        head = &tbl->est_head[b];
+        for (uint16_t l = *head; l; l = tbl->hash_next[l - 1u]) {
+            const tcp_socket_t *o = &tbl->sockets[l - 1u];
+            if (o->local_port == s->local_port && o->remote_port == s->remote_port &&
+                o->local_ip == s->local_ip && o->remote_ip == s->remote_ip) {
+                return -2;
+            }
+        }
+    }
+    tbl->hash_next[idx]   = *head;
+    tbl->hash_bucket[idx] = (uint16_t)b;
+    tbl->hashed[idx]      = kind;
+    *head = (uint16_t)(idx + 1);
+    return 0;
+}
+
 int netd_tcp_find_established(const tcp_table_t *tbl,
                               uint32_t local_ip, uint16_t local_port,
                               uint32_t remote_ip, uint16_t remote_port) {
     if (!tbl) return -1;
-    for (uint32_t i = 0; i < TCP_MAX_SOCKETS; i++) {
-        const tcp_socket_t *s = &tbl->sockets[i];
+    uint32_t b = tcp_est_bucket(tbl, local_ip, local_port, remote_ip, remote_port);
+    for (uint16_t l = tbl->est_head[b]; l; l = tbl->hash_next[l - 1u]) {
+        const tcp_socket_t *s = &tbl->sockets[l - 1u];
         if (s->state == TCP_STATE_CLOSED) continue;
         if (s->state == TCP_STATE_LISTEN) continue;
         if (s->local_port == local_port && s->remote_port == remote_port &&
             s->local_ip == local_ip && s->remote_ip == remote_ip) {
-            return (int)i;
+            return (int)(l - 1u);
         }
     }
     return -1;
@@ -196,16 +396,204 @@ int netd_tcp_find_established(const tcp_table_t *tbl,
 int netd_tcp_find_listen(const tcp_table_t *tbl,
                          uint32_t local_ip, uint16_t local_port) {
     if (!tbl) return -1;
-    for (uint32_t i = 0; i < TCP_MAX_SOCKETS; i++) {
-        const tcp_socket_t *s = &tbl->sockets[i];
+    int any = -1;
+    for (uint16_t l = tbl->listen_head[tcp_listen_bucket(local_port)]; l;
+         l = tbl->hash_next[l - 1u]) {
+        const tcp_socket_t *s = &tbl->sockets[l - 1u];
         if (s->state != TCP_STATE_LISTEN) continue;
-        // LISTEN either binds to a specific local_ip or INADDR_ANY (0).
-        if (s->local_port == local_port &&
-            (s->local_ip == 0 || s->local_ip == local_ip)) {
-            return (int)i;
+        if (s->local_port != local_port) continue;
+        // LISTEN either binds to a specific local_ip or INADDR_ANY (0); the
+        // specific bind wins.
+        if (s->local_ip == local_ip) return (int)(l - 1u);
+        if (s->local_ip == 0 && any < 0) any = (int)(l - 1u);
+    }
+    return any;
+}
+
+// ====================================================================
+// Phase 26: options, windows, and the SACK scoreboard lookups.
+// ====================================================================
+uint16_t netd_tcp_eff_mss(const tcp_socket_t *sock) {
+    uint16_t mss = (sock && sock->mss) ? sock->mss : TCP_DEFAULT_MSS;
+    if (sock && (sock->opts & TCP_OPT_F_TS) && mss > 2u * TCP_TS_OPT_LEN) {
+        mss = (uint16_t)(mss - TCP_TS_OPT_LEN);
+    }
+    return mss;
+}
+
+// Smallest shift that lets the 16-bit window field cover the most buffer
+// the owner may ever offer.
+static uint8_t tcp_pick_wscale(const tcp_socket_t *sock) {
+    uint32_t max = sock->rcv_wnd_max ? sock->rcv_wnd_max : sock->rcv_wnd;
+    uint8_t s = 0;
+    while (s < TCP_MAX_WSCALE && (max >> s) > 0xFFFFu) s++;
+    return s;
+}
+
+uint16_t netd_tcp_adv_window(tcp_socket_t *sock, int syn) {
+    if (!sock) return 0;
+    // RFC 7323 §2.2: the window in a SYN is never scaled.
+    uint8_t shift = (!syn && (sock->opts & TCP_OPT_F_WSCALE)) ? sock->rcv_wscale : 0;
+    uint32_t w = sock->rcv_wnd >> shift;
+    if (w > 0xFFFFu) w = 0xFFFFu;
+    sock->rcv_adv = sock->rcv_nxt + (w << shift);
+    return (uint16_t)w;
+}
+
+static void tcp_put_ts(const tcp_socket_t *sock, uint8_t *opt,
+                       uint64_t now_tsc, uint64_t ticks_per_sec) {
+    opt[0] = TCP_OPT_TS;
+    opt[1] = 10;
+    netd_write_be32(&opt[2], tsc_to_ms(ticks_per_sec, now_tsc));
+    netd_write_be32(&opt[6], sock->ts_recent);
+}
+
+static size_t tcp_syn_opt_len(uint8_t want) {
+    size_t n = 4;                                   // MSS
+    if (want & TCP_OPT_F_WSCALE) n += 4;            // NOP + WS
+    if (want & TCP_OPT_F_TS) n += 12;               // (SACKP | NOP NOP) + TS
+    else if (want & TCP_OPT_F_SACK) n += 4;         // NOP NOP SACKP
+    return n;
+}
+
+// SYN / SYN-ACK option block: MSS, then window scale, then SACK-permitted
+// sharing a word with timestamps — the usual layout, 20 bytes with all on.
+static size_t tcp_syn_options(const tcp_socket_t *sock, uint8_t *opt, uint8_t want,
+                              uint64_t now_tsc, uint64_t ticks_per_sec) {
+    size_t n = 0;
+    opt[n++] = TCP_OPT_MSS;
+    opt[n++] = 4;
+    netd_write_be16(&opt[n], sock->mss ? sock->mss : TCP_DEFAULT_MSS);
+    n += 2;
+    if (want & TCP_OPT_F_WSCALE) {
+        opt[n++] = TCP_OPT_NOP;
+        opt[n++] = TCP_OPT_WSCALE;
+        opt[n++] = 3;
+        opt[n++] = sock->rcv_wscale;
+    }
+    if (want & TCP_OPT_F_TS) {
+        if (want & TCP_OPT_F_SACK) {
+            opt[n++] = TCP_OPT_SACK_PERM;
+            opt[n++] = 2;
+        } else {
+            opt[n++] = TCP_OPT_NOP;
+            opt[n++] = TCP_OPT_NOP;
         }
+        tcp_put_ts(sock, &opt[n], now_tsc, ticks_per_sec);
+        n += 10;
+    } else if (want & TCP_OPT_F_SACK) {
+        opt[n++] = TCP_OPT_NOP;
+        opt[n++] = TCP_OPT_NOP;
+        opt[n++] = TCP_OPT_SACK_PERM;
+        opt[n++] = 2;
     }
-    return -1;
+    return n;
+}
+
+size_t netd_tcp_write_options(const tcp_socket_t *sock, uint8_t *opt,
+                              uint64_t now_tsc, uint64_t ticks_per_sec,
+                              int with_sack) {
+    if (!sock || !opt) return 0;
+    size_t n = 0;
+    if (sock->opts & TCP_OPT_F_TS) {
+        opt[n++] = TCP_OPT_NOP;
+        opt[n++] = TCP_OPT_NOP;
+        tcp_put_ts(sock, &opt[n], now_tsc, ticks_per_sec);
+        n += 10;
+    }
+    if (with_sack && (sock->opts & TCP_OPT_F_SACK) && sock->rcv_sack_n) {
+        // 3 blocks fit beside a timestamp, 4 without.
+        size_t room = (TCP_HDR_LEN_MAX - TCP_HDR_LEN_MIN - n - 4u) / 8u;
+        size_t k = sock->rcv_sack_n < room ? sock->rcv_sack_n : room;
+        opt[n++] = TCP_OPT_NOP;
+        opt[n++] = TCP_OPT_NOP;
+        opt[n++] = TCP_OPT_SACK;
+        opt[n++] = (uint8_t)(2u + 8u * k);
+        for (size_t i = 0; i < k; i++) {
+            netd_write_be32(&opt[n], sock->rcv_sack[i].start);
+            netd_write_be32(&opt[n + 4], sock->rcv_sack[i].end);
+            n += 8;
+        }
+    }
+    return n;
+}
+
+int netd_tcp_rcv_clip(const tcp_socket_t *sock, const tcp_parsed_t *pkt,
+                      uint32_t *off, uint32_t *skip, uint32_t *len) {
+    if (!sock || !pkt || !off || !skip || !len) return 0;
+    if (pkt->payload_len == 0) return 0;
+    uint32_t plen = (uint32_t)pkt->payload_len;
+    uint32_t start = pkt->seq;
+    if (seq_cmp(start + plen, sock->rcv_nxt) <= 0) return 0;   // All old
+    uint32_t sk = seq_cmp(start, sock->rcv_nxt) < 0 ? sock->rcv_nxt - start : 0;
+    uint32_t o  = start + sk - sock->rcv_nxt;
+    if (o >= sock->rcv_wnd) return 0;                          // Past the window
+    uint32_t n = plen - sk;
+    if (n > sock->rcv_wnd - o) n = sock->rcv_wnd - o;
+    *off  = o;
+    *skip = sk;
+    *len  = n;
+    return 1;
+}
+
+// Bytes of the scoreboard inside [lo, hi).
+static uint32_t tcp_sacked_between(const tcp_socket_t *sock,
+                                   uint32_t lo, uint32_t hi) {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < sock->sack_n; i++) {
+        uint32_t s = seq_max(sock->sack[i].start, lo);
+        uint32_t e = sock->sack[i].end;
+        if (seq_cmp(e, hi) > 0) e = hi;
+        if (seq_cmp(e, s) > 0) n += e - s;
+    }
+    return n;
+}
+
+// First byte at or after `s` that the peer has not SACKed.
+static uint32_t tcp_skip_sacked(const tcp_socket_t *sock, uint32_t s) {
+    for (uint8_t i = 0; i < sock->sack_n; i++) {
+        if (seq_cmp(s, sock->sack[i].start) >= 0 &&
+            seq_cmp(s, sock->sack[i].end) < 0) {
+            s = sock->sack[i].end;
+        }
+    }
+    return s;
+}
+
+// Start of the first SACKed range above `s`, or `lim` if none comes first.
+static uint32_t tcp_next_sacked(const tcp_socket_t *sock, uint32_t s, uint32_t lim) {
+    for (uint8_t i = 0; i < sock->sack_n; i++) {
+        if (seq_cmp(sock->sack[i].start, s) > 0) {
+            return seq_cmp(sock->sack[i].start, lim) < 0 ? sock->sack[i].start : lim;
+        }
+    }
+    return lim;
+}
+
+// Control segment (SYN / ACK / FIN) at snd_nxt — the SYN's own number for
+// a SYN — carrying the options the connection has settled on.
+static size_t emit_ctrl(tcp_socket_t *sock,
+                        uint8_t *buf, size_t cap, uint8_t flags,
+                        uint64_t now_tsc, uint64_t ticks_per_sec) {
+    uint8_t opt[TCP_HDR_LEN_MAX - TCP_HDR_LEN_MIN];
+    int syn = (flags & TCP_FLAG_SYN) != 0;
+    size_t olen;
+    if (syn) {
+        // A SYN offers; a SYN-ACK only echoes what the peer offered too.
+        uint8_t want = (sock->state == TCP_STATE_SYN_RCVD) ? sock->opts
+                                                           : sock->opts_offer;
+        olen = tcp_syn_options(sock, opt, want, now_tsc, ticks_per_sec);
+    } else {
+        olen = netd_tcp_write_options(sock, opt, now_tsc, ticks_per_sec, 1);
+    }
+    if (!buf || cap < TCP_HDR_LEN_MIN + olen) return 0;
+    return netd_tcp_build_opts(buf,
+                               sock->local_ip, sock->remote_ip,
+                               sock->local_port, sock->remote_port,
+                               syn ? sock->iss : sock->snd_nxt,
+                               (flags & TCP_FLAG_ACK) ? sock->rcv_nxt : 0,
+                               flags, netd_tcp_adv_window(sock, syn),
+                               opt, olen, (const uint8_t *)0, 0);
 }
 
 // ====================================================================
@@ -219,29 +607,32 @@ int netd_tcp_connect(tcp_socket_t *sock,
                      uint64_t now_tsc, uint64_t ticks_per_sec) {
     if (!sock || !syn_buf || !syn_len) return -1;
     if (sock->state != TCP_STATE_CLOSED) return -2;
-    if (syn_buf_cap < 24) return -3;  // 20 hdr + 4 MSS option
+    if (syn_buf_cap < TCP_HDR_LEN_MIN + tcp_syn_opt_len(sock->opts_offer)) {
+        return -3;  // 20 hdr + MSS (+ offered extensions)
+    }
 
     sock->iss     = iss;
     sock->snd_una = iss;
     sock->snd_nxt = iss + 1;    // SYN consumes 1 seq number
+    sock->snd_max = iss + 1;
     sock->snd_wnd = 0;          // Not yet known
     sock->cwnd    = sock->mss ? sock->mss : TCP_DEFAULT_MSS;
     sock->ssthresh = 0xFFFFu;
     sock->rto_ms   = (initial_rto_ms == 0) ? TCP_DEFAULT_RTO_MS : initial_rto_ms;
     sock->dup_acks = 0;
+    sock->opts       = 0;
+    sock->rcv_wscale = (sock->opts_offer & TCP_OPT_F_WSCALE) ? tcp_pick_wscale(sock) : 0;
+    sock->ca_state   = TCP_CA_OPEN;
+    sock->rtt_seq    = iss + 1;
+    sock->rtt_tsc    = now_tsc ? now_tsc : 1;
     sock->state    = TCP_STATE_SYN_SENT;
     sock->retx_expiry_tsc = now_tsc + (uint64_t)ms_to_tsc(ticks_per_sec,
                                                           sock->rto_ms);
     sock->time_wait_expiry_tsc = 0;
 
-    // 20-byte IPv4 + TCP SYN (24-byte) not built here — caller prepends IP.
-    *syn_len = netd_tcp_build(syn_buf,
-                              sock->local_ip, sock->remote_ip,
-                              sock->local_port, sock->remote_port,
-                              sock->iss, 0,
-                              TCP_FLAG_SYN, (uint16_t)sock->rcv_wnd,
-                              sock->mss,
-                              (const uint8_t *)0, 0);
+    // TCP SYN (24 bytes, more with extensions offered) — caller prepends IP.
+    *syn_len = emit_ctrl(sock, syn_buf, syn_buf_cap, TCP_FLAG_SYN,
+                         now_tsc, ticks_per_sec);
     return 0;
 }
 
@@ -259,20 +650,441 @@ int netd_tcp_listen(tcp_socket_t *sock, uint32_t local_ip, uint16_t local_port)
 }
 
 // ====================================================================
-// Incoming segment handler.
+// Phase 26: SYN cookies.
 // ====================================================================
-static size_t emit_ctrl(tcp_socket_t *sock,
-                        uint8_t *buf, size_t cap,
-                        uint8_t flags, uint16_t mss_opt) {
-    if (!buf || cap < 24) return 0;
-    return netd_tcp_build(buf,
-                          sock->local_ip, sock->remote_ip,
-                          sock->local_port, sock->remote_port,
-                          sock->snd_nxt, sock->rcv_nxt,
-                          flags, (uint16_t)sock->rcv_wnd,
-                          mss_opt, (const uint8_t *)0, 0);
+static void tcp_established(tcp_socket_t *sock, uint64_t now_tsc,
+                            uint64_t ticks_per_sec);
+
+// Largest class not above the peer's MSS is what the cookie remembers.
+static const uint16_t k_cookie_mss[8] = {
+    536, 1200, 1300, 1360, 1400, 1440, 1452, 1460,
+};
+
+// SipHash-2-4 over whole 64-bit words. The cookie is only as strong as
+// this PRF: an attacker who can predict it forges connections from any
+// address, so the demux mixer (netd_hash32) will not do here.
+#define SIP_ROTL(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+static void sip_round(uint64_t v[4]) {
+    v[0] += v[1]; v[1] = SIP_ROTL(v[1], 13); v[1] ^= v[0]; v[0] = SIP_ROTL(v[0], 32);
+    v[2] += v[3]; v[3] = SIP_ROTL(v[3], 16); v[3] ^= v[2];
+    v[0] += v[3]; v[3] = SIP_ROTL(v[3], 21); v[3] ^= v[0];
+    v[2] += v[1]; v[1] = SIP_ROTL(v[1], 17); v[1] ^= v[2]; v[2] = SIP_ROTL(v[2], 32);
+}
+
+static uint64_t tcp_siphash(const uint64_t key[2], const uint64_t *m, uint32_t n) {
+    uint64_t v[4] = {
+        key[0] ^ 0x736F6D6570736575ull, key[1] ^ 0x646F72616E646F6Dull,
+        key[0] ^ 0x6C7967656E657261ull, key[1] ^ 0x7465646279746573ull,
+    };
+    for (uint32_t i = 0; i < n; i++) {
+        v[3] ^= m[i];
+        sip_round(v);
+        sip_round(v);
+        v[0] ^= m[i];
+    }
+    uint64_t b = (uint64_t)(n * 8u) << 56;
+    v[3] ^= b;
+    sip_round(v);
+    sip_round(v);
+    v[0] ^= b;
+    v[2] ^= 0xFFu;
+    for (int r = 0; r < 4; r++) sip_round(v);
+    return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+static uint32_t tcp_cookie_hash(const tcp_table_t *tbl,
+                                uint32_t local_ip, uint16_t local_port,
+                                uint32_t remote_ip, uint16_t remote_port,
+                                uint32_t peer_isn, uint32_t tag) {
+    const uint64_t m[3] = {
+        ((uint64_t)remote_ip << 32) | local_ip,
+        ((uint64_t)local_port << 48) | ((uint64_t)remote_port << 32) | peer_isn,
+        tag,
+    };
+    return (uint32_t)tcp_siphash(tbl->cookie_key, m, 3) & 0xFFFFFFu;
+}
+
+uint32_t netd_tcp_syncookie(const tcp_table_t *tbl,
+                            uint32_t local_ip, uint16_t local_port,
+                            uint32_t remote_ip, uint16_t remote_port,
+                            uint32_t peer_isn, uint16_t peer_mss, uint32_t t) {
+    if (!tbl) return 0;
+    uint32_t m = 0;
+    while (m + 1u < 8u && k_cookie_mss[m + 1u] <= peer_mss) m++;
+    uint32_t tag = ((t & 31u) << 3) | m;
+    return (tag << 24) |
+           tcp_cookie_hash(tbl, local_ip, local_port, remote_ip, remote_port,
+                           peer_isn, tag);
+}
+
+int netd_tcp_syncookie_check(const tcp_table_t *tbl,
+                             uint32_t local_ip, uint16_t local_port,
+                             uint32_t remote_ip, uint16_t remote_port,
+                             uint32_t peer_isn, uint32_t cookie, uint32_t t,
+                             uint16_t *mss_out) {
+    if (!tbl) return -1;
+    uint32_t tag = cookie >> 24;
+    uint32_t age = (t - (tag >> 3)) & 31u;
+    if (age > 1u) return -1;   // Older than one period
+    if ((cookie & 0xFFFFFFu) !=
+        tcp_cookie_hash(tbl, local_ip, local_port, remote_ip, remote_port,
+                        peer_isn, tag)) {
+        return -1;
+    }
+    if (mss_out) *mss_out = k_cookie_mss[tag & 7u];
+    return 0;
 }
 
+int netd_tcp_syncookie_accept(tcp_socket_t *sock, const tcp_parsed_t *pkt,
+                              uint16_t mss,
+                              uint64_t now_tsc, uint64_t ticks_per_sec) {
+    if (!sock || !pkt) return -1;
+    sock->remote_port = pkt->src_port;
+    sock->irs      = pkt->seq - 1u;
+    sock->rcv_nxt  = pkt->seq;
+    sock->iss      = pkt->ack - 1u;
+    sock->snd_una  = pkt->ack;
+    sock->snd_nxt  = pkt->ack;
+    sock->snd_wnd  = pkt->window;
+    if (mss != 0 && mss < sock->mss) sock->mss = mss;
+    sock->opts       = 0;
+    sock->snd_wscale = 0;
+    sock->rcv_wscale = 0;
+    sock->rto_ms     = TCP_DEFAULT_RTO_MS;
+    sock->rtt_tsc    = 0;
+    tcp_established(sock, now_tsc, ticks_per_sec);
+    return 0;
+}
+
+// ====================================================================
+// Phase 26: data transfer — send scoreboard, receive reassembly, RTT.
+// ====================================================================
+uint32_t netd_tcp_pipe(const tcp_socket_t *sock) {
+    if (!sock) return 0;
+    if (sock->ca_state != TCP_CA_RECOVERY) {
+        // Everything sent from snd_una to snd_nxt and not SACKed. After an
+        // RTO rewind, the bytes between snd_nxt and snd_max count as lost.
+        if (seq_cmp(sock->snd_nxt, sock->snd_una) <= 0) return 0;
+        return (sock->snd_nxt - sock->snd_una) -
+               tcp_sacked_between(sock, sock->snd_una, sock->snd_nxt);
+    }
+    uint32_t rx = seq_max(sock->rexmit_nxt, sock->snd_una);
+    if (sock->sack_n) {
+        // RFC 6675 with every hole below the highest SACK taken as lost:
+        // what is above it, plus the hole bytes already retransmitted.
+        uint32_t hi = sock->sack[sock->sack_n - 1u].end;
+        if (seq_cmp(rx, hi) > 0) rx = hi;
+        return (sock->snd_max - hi) + (rx - sock->snd_una) -
+               tcp_sacked_between(sock, sock->snd_una, rx);
+    }
+    // NewReno: every duplicate ACK stands for a segment that has left.
+    uint32_t out  = sock->snd_max - sock->snd_una;
+    uint32_t left = (uint32_t)sock->dup_acks * netd_tcp_eff_mss(sock);
+    out = left < out ? out - left : 0;
+    return out + (rx - sock->snd_una);
+}
+
+int netd_tcp_next_segment(const tcp_socket_t *sock, uint32_t queued_end,
+                          uint32_t max_len, uint32_t *seq, uint32_t *len) {
+    if (!sock || !seq || !len || max_len == 0) return 0;
+    uint32_t emss = netd_tcp_eff_mss(sock);
+    uint32_t pipe = netd_tcp_pipe(sock);
+    uint32_t room = sock->cwnd > pipe ? sock->cwnd - pipe : 0;
+
+    // 1. Repair. In RECOVERY: the next unSACKed byte from the retransmit
+    // cursor up to the highest SACK (RFC 6675 NextSeg rule 1), or without
+    // SACK information the one segment at snd_una (RFC 6582).
+    if (sock->ca_state == TCP_CA_RECOVERY && room) {
+        uint32_t s = seq_max(sock->rexmit_nxt, sock->snd_una);
+        uint32_t lim;
+        if (sock->sack_n) {
+            lim = sock->sack[sock->sack_n - 1u].end;
+        } else {
+            lim = (s == sock->snd_una) ? sock->snd_una + emss : sock->snd_una;
+            if (seq_cmp(lim, sock->snd_max) > 0) lim = sock->snd_max;
+        }
+        s = tcp_skip_sacked(sock, s);
+        if (seq_cmp(s, lim) < 0) {
+            uint32_t n = tcp_next_sacked(sock, s, lim) - s;
+            if (n > room)    n = room;
+            if (n > max_len) n = max_len;
+            *seq = s;
+            *len = n;
+            return 1;
+        }
+    }
+
+    // 2. New data — or, after an RTO, data resent go-back-N from snd_una,
+    // stepping over whatever the peer has SACKed.
+    uint32_t s = tcp_skip_sacked(sock, sock->snd_nxt);
+    if (seq_cmp(queued_end, s) <= 0) return 0;
+    uint32_t avail = queued_end - s;
+    uint32_t n = avail;
+    int resend = seq_cmp(s, sock->snd_max) < 0;
+    if (resend) {
+        uint32_t e = tcp_next_sacked(sock, s, sock->snd_max);
+        if (n > e - s) n = e - s;
+    }
+    uint32_t wnd_end = sock->snd_una + sock->snd_wnd;
+    if (seq_cmp(s, wnd_end) >= 0) {
+        // Closed window: the persist timer lets one byte probe past it.
+        if (!sock->probe) return 0;
+        n = 1;
+    } else if (n > wnd_end - s) {
+        n = wnd_end - s;
+    }
+    if (!sock->probe) {
+        if (room == 0) return 0;
+        if (n > room) n = room;
+    }
+    if (n > max_len) n = max_len;
+    // Sender-side SWS avoidance: no runt while more data waits behind a
+    // window that the ACKs in flight will open.
+    if (!resend && !sock->probe && n < emss && n < avail && pipe > 0) return 0;
+    *seq = s;
+    *len = n;
+    return 1;
+}
+
+void netd_tcp_sent(tcp_socket_t *sock, uint32_t seq, uint32_t len,
+                   uint64_t now_tsc, uint64_t ticks_per_sec) {
+    if (!sock) return;
+    uint32_t end = seq + len;
+    if (seq_cmp(sock->snd_max, sock->snd_nxt) < 0) sock->snd_max = sock->snd_nxt;
+    if (sock->ca_state == TCP_CA_RECOVERY && seq_cmp(seq, sock->snd_nxt) < 0) {
+        if (seq_cmp(end, sock->rexmit_nxt) > 0) sock->rexmit_nxt = end;
+    } else if (seq_cmp(end, sock->snd_nxt) > 0) {
+        sock->snd_nxt = end;
+        if (seq_cmp(end, sock->snd_max) > 0) {
+            // Karn: only time bytes that have never been sent before.
+            if (sock->rtt_tsc == 0 && seq_cmp(seq, sock->snd_max) >= 0) {
+                sock->rtt_seq = end;
+                sock->rtt_tsc = now_tsc ? now_tsc : 1;
+            }
+            sock->snd_max = end;
+        }
+    }
+    sock->probe = 0;
+    if (sock->retx_expiry_tsc == 0) {
+        sock->retx_expiry_tsc = now_tsc + ms_to_tsc(ticks_per_sec, sock->rto_ms);
+    }
+}
+
+// RFC 6298 §2 estimator, in µs; the RTO keeps a 1 ms clock granularity.
+static void tcp_rtt_sample(tcp_socket_t *sock, uint64_t r_us) {
+    if (r_us == 0) r_us = 1;
+    if (r_us > (uint64_t)TCP_MAX_RTO_MS * 1000u) r_us = (uint64_t)TCP_MAX_RTO_MS * 1000u;
+    uint32_t r = (uint32_t)r_us;
+    if (sock->srtt_us == 0) {
+        sock->srtt_us   = r;
+        sock->rttvar_us = r / 2u;
+    } else {
+        uint32_t d = sock->srtt_us > r ? sock->srtt_us - r : r - sock->srtt_us;
+        sock->rttvar_us = sock->rttvar_us - sock->rttvar_us / 4u + d / 4u;
+        sock->srtt_us   = sock->srtt_us - sock->srtt_us / 8u + r / 8u;
+    }
+    uint64_t var = 4ull * sock->rttvar_us;
+    if (var < 1000u) var = 1000u;
+    uint64_t rto = (sock->srtt_us + var) / 1000u;
+    if (rto < TCP_MIN_RTO_MS) rto = TCP_MIN_RTO_MS;
+    if (rto > TCP_MAX_RTO_MS) rto = TCP_MAX_RTO_MS;
+    sock->rto_ms = (uint32_t)rto;
+}
+
+// Fold the peer's SACK blocks into the scoreboard, clipped to
+// [ack, snd_max) and kept sorted and disjoint. When more ranges are known
+// than fit, the highest go: holes are repaired from the bottom up.
+static void tcp_sack_merge(tcp_socket_t *sock, const tcp_parsed_t *pkt,
+                           uint32_t ack) {
+    for (uint8_t k = 0; k < pkt->sack_n; k++) {
+        uint32_t s = pkt->sack[k].start;
+        uint32_t e = pkt->sack[k].end;
+        if (seq_cmp(s, ack) < 0) s = ack;
+        if (seq_cmp(e, sock->snd_max) > 0) e = sock->snd_max;
+        if (seq_cmp(e, s) <= 0) continue;
+
+        tcp_sack_block_t tmp[TCP_SACK_MAX_BLOCKS + 1];
+        uint8_t n = 0;
+        int placed = 0;
+        for (uint8_t i = 0; i < sock->sack_n; i++) {
+            tcp_sack_block_t b = sock->sack[i];
+            if (seq_cmp(b.end, s) < 0) {                 // Wholly below
+                tmp[n++] = b;
+            } else if (seq_cmp(b.start, e) > 0) {        // Wholly above
+                if (!placed) { tmp[n].start = s; tmp[n].end = e; n++; placed = 1; }
+                tmp[n++] = b;
+            } else {                                     // Touches: absorb
+                if (seq_cmp(b.start, s) < 0) s = b.start;
+                if (seq_cmp(b.end, e) > 0)   e = b.end;
+            }
+        }
+        if (!placed) { tmp[n].start = s; tmp[n].end = e; n++; }
+        if (n > TCP_SACK_MAX_BLOCKS) n = TCP_SACK_MAX_BLOCKS;
+        for (uint8_t i = 0; i < n; i++) sock->sack[i] = tmp[i];
+        sock->sack_n = n;
+    }
+}
+
+static void tcp_sack_prune(tcp_socket_t *sock) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < sock->sack_n; i++) {
+        tcp_sack_block_t b = sock->sack[i];
+        if (seq_cmp(b.end, sock->snd_una) <= 0) continue;
+        if (seq_cmp(b.start, sock->snd_una) < 0) b.start = sock->snd_una;
+        sock->sack[n++] = b;
+    }
+    sock->sack_n = n;
+}
+
+// Process the ACK field (and timestamps, window, SACK) of a segment in a
+// synchronized state. Returns -1 if it acknowledges data never sent — the
+// caller answers with an ACK and drops the segment (RFC 793 p.72).
+static int tcp_on_ack(tcp_socket_t *sock, const tcp_parsed_t *pkt,
+                      uint64_t now_tsc, uint64_t ticks_per_sec) {
+    if (seq_cmp(sock->snd_max, sock->snd_nxt) < 0) sock->snd_max = sock->snd_nxt;
+    if ((sock->opts & TCP_OPT_F_TS) && pkt->opt_ts &&
+        seq_cmp(pkt->seq, sock->rcv_nxt) <= 0) {
+        sock->ts_recent = pkt->tsval;
+    }
+    if (!(pkt->flags & TCP_FLAG_ACK)) return 0;
+
+    uint32_t ack = pkt->ack;
+    if (seq_cmp(ack, sock->snd_max) > 0) return -1;
+    if (seq_cmp(ack, sock->snd_una) < 0) return 0;    // Old duplicate
+
+    sock->snd_wnd = (uint32_t)pkt->window <<
+                    ((sock->opts & TCP_OPT_F_WSCALE) ? sock->snd_wscale : 0);
+    if ((sock->opts & TCP_OPT_F_SACK) && pkt->sack_n) {
+        tcp_sack_merge(sock, pkt, ack);
+    }
+
+    if (seq_cmp(ack, sock->snd_una) > 0) {
+        uint32_t acked = ack - sock->snd_una;
+        // RTT: an echoed timestamp is valid even across retransmissions;
+        // otherwise the one timed segment, once it is covered.
+        if ((sock->opts & TCP_OPT_F_TS) && pkt->opt_ts && pkt->tsecr != 0) {
+            uint32_t r_ms = tsc_to_ms(ticks_per_sec, now_tsc) - pkt->tsecr;
+            if (r_ms < TCP_MAX_RTO_MS) tcp_rtt_sample(sock, (uint64_t)r_ms * 1000u);
+            sock->rtt_tsc = 0;
+        } else if (sock->rtt_tsc && seq_cmp(ack, sock->rtt_seq) >= 0) {
+            tcp_rtt_sample(sock, tsc_to_us(ticks_per_sec, now_tsc - sock->rtt_tsc));
+            sock->rtt_tsc = 0;
+        }
+
+        sock->snd_una  = ack;
+        sock->dup_acks = 0;
+        if (seq_cmp(sock->snd_nxt, ack) < 0) sock->snd_nxt = ack;
+        tcp_sack_prune(sock);
+
+        uint8_t was = sock->ca_state;
+        if (was != TCP_CA_OPEN && seq_cmp(ack, sock->recover) >= 0) {
+            sock->ca_state = TCP_CA_OPEN;   // Everything lost is repaired
+        }
+        if (was == TCP_CA_RECOVERY) {
+            if (sock->ca_state == TCP_CA_RECOVERY) {
+                // Partial ACK: the next hole is lost as well (RFC 6582).
+                sock->rexmit_nxt = sock->sack_n ? seq_max(sock->rexmit_nxt, ack)
+                                                : ack;
+            }
+        } else {
+            netd_tcp_cc_on_ack(sock, acked, now_tsc, ticks_per_sec);
+        }
+
+        // RFC 6298 §5.2 / §5.3.
+        sock->retx_expiry_tsc = (sock->snd_una == sock->snd_max) ? 0 :
+            now_tsc + ms_to_tsc(ticks_per_sec, sock->rto_ms);
+        return 0;
+    }
+
+    // ack == snd_una: a duplicate if it carries nothing else and data is
+    // outstanding (RFC 5681 §2).
+    if (pkt->payload_len == 0 &&
+        !(pkt->flags & (TCP_FLAG_SYN | TCP_FLAG_FIN)) &&
+        sock->snd_max != sock->snd_una) {
+        if (sock->dup_acks < 255) sock->dup_acks++;
+        uint32_t sacked = tcp_sacked_between(sock, sock->snd_una, sock->snd_max);
+        if (sock->ca_state == TCP_CA_OPEN &&
+            (sock->dup_acks >= TCP_DUPACK_THRESH ||
+             sacked > (TCP_DUPACK_THRESH - 1u) * netd_tcp_eff_mss(sock))) {
+            // Fast retransmit: the segment at snd_una is lost.
+            sock->recover    = sock->snd_max;
+            sock->rexmit_nxt = sock->snd_una;
+            netd_tcp_cc_on_loss(sock, now_tsc);
+            sock->ca_state   = TCP_CA_RECOVERY;
+        }
+    }
+    return 0;
+}
+
+static void tcp_rcv_advance(tcp_socket_t *sock, uint32_t n) {
+    sock->rcv_nxt += n;
+    sock->rcv_wnd  = n < sock->rcv_wnd ? sock->rcv_wnd - n : 0;
+}
+
+// Note [s, e) as held out of order: merged with every range it touches and
+// moved to the front, since RFC 2018 §4 reports the most recent first.
+static void tcp_rcv_hold(tcp_socket_t *sock, uint32_t s, uint32_t e) {
+    tcp_sack_block_t keep[TCP_SACK_MAX_BLOCKS];
+    uint8_t n = sock->rcv_sack_n;
+    for (uint8_t i = 0; i < n; i++) keep[i] = sock->rcv_sack[i];
+    for (int merged = 1; merged; ) {
+        merged = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            if (seq_cmp(keep[i].end, s) < 0 || seq_cmp(keep[i].start, e) > 0) continue;
+            if (seq_cmp(keep[i].start, s) < 0) s = keep[i].start;
+            if (seq_cmp(keep[i].end, e) > 0)   e = keep[i].end;
+            keep[i] = keep[--n];
+            merged = 1;
+            break;
+        }
+    }
+    sock->rcv_sack[0].start = s;
+    sock->rcv_sack[0].end   = e;
+    uint8_t m = 1;
+    for (uint8_t i = 0; i < n && m < TCP_SACK_MAX_BLOCKS; i++) sock->rcv_sack[m++] = keep[i];
+    sock->rcv_sack_n = m;
+}
+
+// Accept the in-window part of pkt's payload, then its FIN once every byte
+// before it is in. Returns 1 if the FIN was consumed.
+static int tcp_rcv_segment(tcp_socket_t *sock, const tcp_parsed_t *pkt) {
+    uint32_t off, skip, len;
+    if (netd_tcp_rcv_clip(sock, pkt, &off, &skip, &len)) {
+        sock->rcv_seg_off  = off;
+        sock->rcv_seg_skip = skip;
+        sock->rcv_seg_len  = len;
+        if (off != 0) {
+            tcp_rcv_hold(sock, sock->rcv_nxt + off, sock->rcv_nxt + off + len);
+        } else {
+            tcp_rcv_advance(sock, len);
+            // Pull in every held range the new bytes reach.
+            for (uint8_t i = 0; i < sock->rcv_sack_n; ) {
+                tcp_sack_block_t b = sock->rcv_sack[i];
+                if (seq_cmp(b.start, sock->rcv_nxt) > 0) { i++; continue; }
+                if (seq_cmp(b.end, sock->rcv_nxt) > 0) {
+                    tcp_rcv_advance(sock, b.end - sock->rcv_nxt);
+                }
+                for (uint8_t j = i; j + 1u < sock->rcv_sack_n; j++) {
+                    sock->rcv_sack[j] = sock->rcv_sack[j + 1u];
+                }
+                sock->rcv_sack_n--;
+                i = 0;
+            }
+        }
+    }
+    if ((pkt->flags & TCP_FLAG_FIN) && !sock->fin_rcvd &&
+        pkt->seq + (uint32_t)pkt->payload_len == sock->rcv_nxt) {
+        sock->rcv_nxt += 1;
+        sock->fin_rcvd = 1;
+        return 1;
+    }
+    return 0;
+}
+
+// ====================================================================
+// Incoming segment handler.
+// ====================================================================
 static size_t emit_rst(uint8_t *buf, size_t cap,
                        uint32_t src_ip, uint32_t dst_ip,
                        uint16_t src_port, uint16_t dst_port,
@@ -283,6 +1095,38 @@ static size_t emit_rst(uint8_t *buf, size_t cap,
                           (const uint8_t *)0, 0);
 }
 
+// Phase 26: what survives of our offer on the peer's SYN / SYN-ACK — an
+// extension is used only if both sides sent it (RFC 7323 §1.3, RFC 2018 §2).
+static void tcp_negotiate(tcp_socket_t *sock, const tcp_parsed_t *pkt) {
+    uint8_t peer = 0;
+    if (pkt->opt_wscale != 0xFFu) peer |= TCP_OPT_F_WSCALE;
+    if (pkt->opt_sack_perm)       peer |= TCP_OPT_F_SACK;
+    if (pkt->opt_ts)              peer |= TCP_OPT_F_TS;
+    sock->opts = (uint8_t)(sock->opts_offer & peer);
+    if (sock->opts & TCP_OPT_F_WSCALE) {
+        sock->snd_wscale = pkt->opt_wscale;
+    } else {
+        sock->snd_wscale = 0;
+        sock->rcv_wscale = 0;
+    }
+    if (sock->opts & TCP_OPT_F_TS) sock->ts_recent = pkt->tsval;
+}
+
+// Handshake complete: first RTT sample (unless the SYN was resent) and
+// the controller's initial window, now that the MSS and options are known.
+static void tcp_established(tcp_socket_t *sock, uint64_t now_tsc,
+                            uint64_t ticks_per_sec) {
+    if (sock->rtt_tsc) {
+        tcp_rtt_sample(sock, tsc_to_us(ticks_per_sec, now_tsc - sock->rtt_tsc));
+        sock->rtt_tsc = 0;
+    }
+    sock->snd_max  = sock->snd_nxt;
+    sock->ca_state = TCP_CA_OPEN;
+    netd_tcp_cc_init(sock);
+    sock->retx_expiry_tsc = 0;
+    sock->state = TCP_STATE_ESTABLISHED;
+}
+
 int netd_tcp_on_segment(tcp_socket_t *sock,
                         const tcp_parsed_t *pkt,
                         uint64_t now_tsc, uint64_t ticks_per_sec,
@@ -290,6 +1134,7 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
                         size_t *resp_len) {
     if (!sock || !pkt || !resp_len) return -1;
     *resp_len = 0;
+    sock->rcv_seg_len = 0;
 
     // RFC 5961 quick check: if RST's seq doesn't match rcv_nxt exactly (and
     // we're in an established-ish state), treat as challenge-ACK trigger.
@@ -314,32 +1159,43 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
         }
     }
 
+    // Phase 26: every synchronized state runs the ACK field through
+    // tcp_on_ack first, so CLOSE_WAIT / FIN_WAIT1 / CLOSING / LAST_ACK keep
+    // recovering lost data exactly like ESTABLISHED does.
+    int have_data = pkt->payload_len > 0 || (pkt->flags & TCP_FLAG_FIN);
     switch (sock->state) {
     case TCP_STATE_LISTEN: {
         if (!(pkt->flags & TCP_FLAG_SYN)) return 0;
         // Accept: fill in remote + send SYN-ACK + state = SYN_RCVD.
-        sock->remote_ip   = pkt->dst_port; // temp placeholder — caller-provided
         // NOTE: caller is responsible for pre-filling sock->remote_ip from
         // the outer IPv4 header before invoking on_segment; we only update
-        // port here.
+        // port here. Phase 26: the socket is still on the listen chain;
+        // the caller moves it with netd_tcp_hash_insert once the remote
+        // tuple is final.
         sock->remote_port = pkt->src_port;
         sock->irs         = pkt->seq;
         sock->rcv_nxt     = pkt->seq + 1;
         sock->iss         = now_tsc & 0xFFFFFFFFu;
         sock->snd_una     = sock->iss;
         sock->snd_nxt     = sock->iss + 1;
-        sock->snd_wnd     = pkt->window;
+        sock->snd_max     = sock->iss + 1;
+        sock->snd_wnd     = pkt->window;   // Never scaled on a SYN
         if (pkt->opt_mss != 0 && pkt->opt_mss < sock->mss) {
             sock->mss = pkt->opt_mss;
         }
+        sock->rcv_wscale = tcp_pick_wscale(sock);
+        tcp_negotiate(sock, pkt);
         sock->cwnd     = sock->mss;
         sock->ssthresh = 0xFFFFu;
         sock->rto_ms   = TCP_DEFAULT_RTO_MS;
+        sock->rtt_seq  = sock->iss + 1;
+        sock->rtt_tsc  = now_tsc ? now_tsc : 1;
         sock->retx_expiry_tsc =
             now_tsc + ms_to_tsc(ticks_per_sec, sock->rto_ms);
         sock->state = TCP_STATE_SYN_RCVD;
         *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                              TCP_FLAG_SYN | TCP_FLAG_ACK, sock->mss);
+                              TCP_FLAG_SYN | TCP_FLAG_ACK,
+                              now_tsc, ticks_per_sec);
         return 0;
     }
     case TCP_STATE_SYN_SENT: {
@@ -355,11 +1211,10 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
         if (pkt->opt_mss != 0 && pkt->opt_mss < sock->mss) {
             sock->mss = pkt->opt_mss;
         }
-        sock->cwnd = 2 * (uint32_t)sock->mss; // Start slow-start at ~2 MSS.
-        sock->retx_expiry_tsc = 0;
-        sock->state = TCP_STATE_ESTABLISHED;
+        tcp_negotiate(sock, pkt);
+        tcp_established(sock, now_tsc, ticks_per_sec);
         *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                              TCP_FLAG_ACK, 0);
+                              TCP_FLAG_ACK, now_tsc, ticks_per_sec);
         return 0;
     }
     case TCP_STATE_SYN_RCVD: {
@@ -367,98 +1222,76 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
         if (!(pkt->flags & TCP_FLAG_ACK)) return 0;
         if (pkt->ack != sock->iss + 1) return 0;
         sock->snd_una = pkt->ack;
-        sock->snd_wnd = pkt->window;
-        sock->retx_expiry_tsc = 0;
-        sock->state = TCP_STATE_ESTABLISHED;
-        return 0;
-    }
-    case TCP_STATE_ESTABLISHED: {
-        // Update snd_una if ACK advances it.
-        if (pkt->flags & TCP_FLAG_ACK) {
-            if (seq_cmp(pkt->ack, sock->snd_una) > 0 &&
-                seq_cmp(pkt->ack, sock->snd_nxt) <= 0) {
-                sock->snd_una = pkt->ack;
-                sock->dup_acks = 0;
-                // Reno congestion-window update (simplified).
-                if (sock->cwnd < sock->ssthresh) {
-                    sock->cwnd += sock->mss;          // slow-start
-                } else {
-                    // cong-avoid: +MSS per RTT. Approximate +MSS/cwnd * MSS.
-                    if (sock->cwnd > 0) {
-                        sock->cwnd += ((uint32_t)sock->mss * sock->mss)
-                                      / sock->cwnd;
-                    }
-                }
-            } else if (pkt->ack == sock->snd_una && pkt->payload_len == 0) {
-                // Pure dup-ACK — increment for fast-retransmit (Stage C).
-                if (sock->dup_acks < 255) sock->dup_acks++;
-            }
-        }
-        // Accept in-order data (drop OOO for MVP).
-        if (pkt->payload_len > 0) {
-            if (pkt->seq == sock->rcv_nxt) {
-                sock->rcv_nxt += (uint32_t)pkt->payload_len;
-            }
-            *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                                  TCP_FLAG_ACK, 0);
-        }
-        // Remote FIN transitions us to CLOSE_WAIT.
-        if (pkt->flags & TCP_FLAG_FIN) {
-            sock->rcv_nxt += 1;
-            sock->state = TCP_STATE_CLOSE_WAIT;
-            // ACK the FIN.
+        sock->snd_wnd = (uint32_t)pkt->window <<
+                        ((sock->opts & TCP_OPT_F_WSCALE) ? sock->snd_wscale : 0);
+        if ((sock->opts & TCP_OPT_F_TS) && pkt->opt_ts) sock->ts_recent = pkt->tsval;
+        tcp_established(sock, now_tsc, ticks_per_sec);
+        // The final ACK may already carry data (or even a FIN).
+        if (have_data) {
+            if (tcp_rcv_segment(sock, pkt)) sock->state = TCP_STATE_CLOSE_WAIT;
             *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                                  TCP_FLAG_ACK, 0);
+                                  TCP_FLAG_ACK, now_tsc, ticks_per_sec);
         }
         return 0;
     }
-    case TCP_STATE_FIN_WAIT1: {
-        if (pkt->flags & TCP_FLAG_ACK) {
-            if (pkt->ack == sock->snd_nxt) {
-                sock->snd_una = pkt->ack;
-                sock->state = TCP_STATE_FIN_WAIT2;
-            }
+    case TCP_STATE_ESTABLISHED:
+    case TCP_STATE_FIN_WAIT1:
+    case TCP_STATE_FIN_WAIT2: {
+        if (tcp_on_ack(sock, pkt, now_tsc, ticks_per_sec) < 0) {
+            *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
+                                  TCP_FLAG_ACK, now_tsc, ticks_per_sec);
+            return 0;
         }
-        if (pkt->flags & TCP_FLAG_FIN) {
-            sock->rcv_nxt += 1;
-            // Simultaneous close: FIN_WAIT1 + FIN → CLOSING (if our FIN not
-            // yet ACKed) or → TIME_WAIT (if our FIN was ACKed).
-            if (sock->state == TCP_STATE_FIN_WAIT2) {
+        // Our FIN is the last sequence number we send, so snd_una reaching
+        // snd_max means it has been acknowledged.
+        if (sock->state == TCP_STATE_FIN_WAIT1 && sock->snd_una == sock->snd_max) {
+            sock->state = TCP_STATE_FIN_WAIT2;
+        }
+        if (tcp_rcv_segment(sock, pkt)) {
+            if (sock->state == TCP_STATE_ESTABLISHED) {
+                // Remote FIN transitions us to CLOSE_WAIT.
+                sock->state = TCP_STATE_CLOSE_WAIT;
+            } else if (sock->state == TCP_STATE_FIN_WAIT2) {
                 sock->state = TCP_STATE_TIME_WAIT;
                 sock->time_wait_expiry_tsc =
                     now_tsc + ms_to_tsc(ticks_per_sec, TCP_TIME_WAIT_MS);
             } else {
+                // Simultaneous close: FIN_WAIT1 + FIN with our FIN not yet
+                // ACKed → CLOSING.
                 sock->state = TCP_STATE_CLOSING;
             }
+        }
+        if (have_data) {
             *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                                  TCP_FLAG_ACK, 0);
+                                  TCP_FLAG_ACK, now_tsc, ticks_per_sec);
         }
         return 0;
     }
-    case TCP_STATE_FIN_WAIT2: {
-        if (pkt->flags & TCP_FLAG_FIN) {
-            sock->rcv_nxt += 1;
-            sock->state = TCP_STATE_TIME_WAIT;
-            sock->time_wait_expiry_tsc =
-                now_tsc + ms_to_tsc(ticks_per_sec, TCP_TIME_WAIT_MS);
+    case TCP_STATE_CLOSE_WAIT:
+    case TCP_STATE_CLOSING:
+    case TCP_STATE_LAST_ACK: {
+        // The peer's FIN is in: only ACKs matter now, plus re-ACKing a
+        // retransmitted FIN.
+        if (tcp_on_ack(sock, pkt, now_tsc, ticks_per_sec) < 0) {
             *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                                  TCP_FLAG_ACK, 0);
+                                  TCP_FLAG_ACK, now_tsc, ticks_per_sec);
+            return 0;
         }
-        return 0;
-    }
-    case TCP_STATE_CLOSING: {
-        // Waiting for ACK of our FIN. Once ACKed → TIME_WAIT.
-        if ((pkt->flags & TCP_FLAG_ACK) && pkt->ack == sock->snd_nxt) {
-            sock->snd_una = pkt->ack;
-            sock->state = TCP_STATE_TIME_WAIT;
-            sock->time_wait_expiry_tsc =
-                now_tsc + ms_to_tsc(ticks_per_sec, TCP_TIME_WAIT_MS);
+        if (sock->snd_una == sock->snd_max) {
+            if (sock->state == TCP_STATE_CLOSING) {
+                sock->state = TCP_STATE_TIME_WAIT;
+                sock->time_wait_expiry_tsc =
+                    now_tsc + ms_to_tsc(ticks_per_sec, TCP_TIME_WAIT_MS);
+                return 0;
+            }
+            if (sock->state == TCP_STATE_LAST_ACK) {
+                sock->state = TCP_STATE_CLOSED;
+                return 0;
+            }
         }
-        return 0;
-    }
-    case TCP_STATE_LAST_ACK: {
-        if ((pkt->flags & TCP_FLAG_ACK) && pkt->ack == sock->snd_nxt) {
-            sock->state = TCP_STATE_CLOSED;
+        if (have_data) {
+            *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
+                                  TCP_FLAG_ACK, now_tsc, ticks_per_sec);
         }
         return 0;
     }
@@ -470,7 +1303,7 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
         if (pkt->flags & TCP_FLAG_FIN) {
             // Re-ACK the FIN.
             *resp_len = emit_ctrl(sock, resp_buf, resp_buf_cap,
-                                  TCP_FLAG_ACK, 0);
+                                  TCP_FLAG_ACK, now_tsc, ticks_per_sec);
         }
         return 0;
     }
@@ -494,35 +1327,21 @@ int netd_tcp_on_segment(tcp_socket_t *sock,
 // Close: emit FIN, transition to FIN_WAIT1 (or LAST_ACK).
 // ====================================================================
 int netd_tcp_close(tcp_socket_t *sock,
-                   uint8_t *fin_buf, size_t fin_buf_cap, size_t *fin_len) {
+                   uint8_t *fin_buf, size_t fin_buf_cap, size_t *fin_len,
+                   uint64_t now_tsc, uint64_t ticks_per_sec) {
     if (!sock || !fin_buf || !fin_len) return -1;
     *fin_len = 0;
     switch (sock->state) {
-    case TCP_STATE_ESTABLISHED: {
-        sock->state = TCP_STATE_FIN_WAIT1;
-        uint32_t fin_seq = sock->snd_nxt;
-        sock->snd_nxt += 1;   // FIN consumes 1 seq
-        // Emit with seq=fin_seq (not snd_nxt).
-        *fin_len = netd_tcp_build(fin_buf,
-                                  sock->local_ip, sock->remote_ip,
-                                  sock->local_port, sock->remote_port,
-                                  fin_seq, sock->rcv_nxt,
-                                  TCP_FLAG_FIN | TCP_FLAG_ACK,
-                                  (uint16_t)sock->rcv_wnd,
-                                  0, (const uint8_t *)0, 0);
-        return 0;
-    }
+    case TCP_STATE_ESTABLISHED:
     case TCP_STATE_CLOSE_WAIT: {
-        sock->state = TCP_STATE_LAST_ACK;
-        uint32_t fin_seq = sock->snd_nxt;
-        sock->snd_nxt += 1;
-        *fin_len = netd_tcp_build(fin_buf,
-                                  sock->local_ip, sock->remote_ip,
-                                  sock->local_port, sock->remote_port,
-                                  fin_seq, sock->rcv_nxt,
-                                  TCP_FLAG_FIN | TCP_FLAG_ACK,
-                                  (uint16_t)sock->rcv_wnd,
-                                  0, (const uint8_t *)0, 0);
+        sock->state = (sock->state == TCP_STATE_ESTABLISHED)
+                          ? TCP_STATE_FIN_WAIT1 : TCP_STATE_LAST_ACK;
+        if (seq_cmp(sock->snd_max, sock->snd_nxt) < 0) sock->snd_max = sock->snd_nxt;
+        // Emit with seq = the FIN's own number, then let it consume one.
+        *fin_len = emit_ctrl(sock, fin_buf, fin_buf_cap,
+                             TCP_FLAG_FIN | TCP_FLAG_ACK,
+                             now_tsc, ticks_per_sec);
+        netd_tcp_sent(sock, sock->snd_nxt, 1, now_tsc, ticks_per_sec);
         return 0;
     }
     default:
@@ -545,33 +1364,43 @@ int netd_tcp_tick(tcp_socket_t *sock,
         }
         return 0;
     }
+    if (sock->retx_expiry_tsc == 0 || now_tsc < sock->retx_expiry_tsc) return 0;
+
+    // Karn: back off RTO ×2, capped at MAX, and drop the RTT probe.
+    uint32_t new_rto = sock->rto_ms * 2;
+    if (new_rto > TCP_MAX_RTO_MS) new_rto = TCP_MAX_RTO_MS;
+    sock->rto_ms  = new_rto;
+    sock->rtt_tsc = 0;
 
     // SYN / SYN-ACK retransmit in SYN_SENT / SYN_RCVD.
-    if (sock->retx_expiry_tsc != 0 && now_tsc >= sock->retx_expiry_tsc) {
-        // Karn: back off RTO ×2, capped at MAX.
-        uint32_t new_rto = sock->rto_ms * 2;
-        if (new_rto > TCP_MAX_RTO_MS) new_rto = TCP_MAX_RTO_MS;
-        sock->rto_ms = new_rto;
+    if (sock->state == TCP_STATE_SYN_SENT || sock->state == TCP_STATE_SYN_RCVD) {
         sock->retx_expiry_tsc = now_tsc + ms_to_tsc(ticks_per_sec, new_rto);
-        if (sock->state == TCP_STATE_SYN_SENT && retx_buf && retx_buf_cap >= 24) {
-            *retx_len = netd_tcp_build(retx_buf,
-                                       sock->local_ip, sock->remote_ip,
-                                       sock->local_port, sock->remote_port,
-                                       sock->iss, 0,
-                                       TCP_FLAG_SYN, (uint16_t)sock->rcv_wnd,
-                                       sock->mss,
-                                       (const uint8_t *)0, 0);
-        } else if (sock->state == TCP_STATE_SYN_RCVD &&
-                   retx_buf && retx_buf_cap >= 24) {
-            *retx_len = netd_tcp_build(retx_buf,
-                                       sock->local_ip, sock->remote_ip,
-                                       sock->local_port, sock->remote_port,
-                                       sock->iss, sock->rcv_nxt,
-                                       TCP_FLAG_SYN | TCP_FLAG_ACK,
-                                       (uint16_t)sock->rcv_wnd,
-                                       sock->mss,
-                                       (const uint8_t *)0, 0);
-        }
+        uint8_t flags = (sock->state == TCP_STATE_SYN_SENT)
+                            ? TCP_FLAG_SYN : (TCP_FLAG_SYN | TCP_FLAG_ACK);
+        *retx_len = emit_ctrl(sock, retx_buf, retx_buf_cap, flags,
+                              now_tsc, ticks_per_sec);
+        return 0;
+    }
+
+    // Phase 26: data RTO. Nothing is emitted here — snd_nxt rewinds and the
+    // owner's next output pass resends; netd_tcp_sent re-arms the timer.
+    sock->retx_expiry_tsc = 0;
+    if (sock->state == TCP_STATE_LISTEN || sock->state == TCP_STATE_CLOSED ||
+        sock->state == TCP_STATE_FIN_WAIT2) {
+        return 0;
     }
+    if (sock->snd_una == sock->snd_max || sock->snd_wnd == 0) {
+        // Persist timer (RFC 1122 §4.2.2.17): probe the closed window with
+        // one byte — backed off like the RTO, but no loss response.
+        sock->probe   = 1;
+        sock->snd_nxt = sock->snd_una;
+        return 0;
+    }
+    netd_tcp_cc_on_rto(sock, now_tsc);
+    sock->ca_state = TCP_CA_LOSS;
+    sock->recover  = sock->snd_max;
+    sock->snd_nxt  = sock->snd_una;
+    sock->dup_acks = 0;
+    sock->sack_n   = 0;   // RFC 2018 §8: the receiver may have reneged
     return 0;
 }
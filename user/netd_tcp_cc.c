@@ -0,0 +1,209 @@
+// user/netd_tcp_cc.c — Phase 26: TCP congestion control.
+//
+// The state machine in netd_tcp.c decides *when* the window changes (an
+// ACK of new data, a fast retransmit, a retransmission timeout); this file
+// decides *by how much*. Each controller is an ops table picked per socket
+// by tcp_socket_t.cc_algo, so a new one only has to fill in three hooks.
+//
+//   Reno  — RFC 5681: slow start with appropriate byte counting (RFC 3465,
+//           L = 2), +1 MSS per cwnd of ACKed bytes in congestion
+//           avoidance, halve on loss.
+//   CUBIC — RFC 9438: the window follows C·(t − K)³ + W_max from the last
+//           reduction (C = 0.4, β = 0.7, fast convergence), never slower
+//           than the Reno-friendly estimate. Default: it refills long fat
+//           pipes in a few RTTs instead of one MSS per RTT.
+//
+// Both start from the RFC 6928 initial window. All window arithmetic is in
+// bytes of netd_tcp_eff_mss (MSS less per-segment options).
+
+#include "netd.h"
+
+typedef struct tcp_cc_ops {
+    void (*on_ack)(tcp_socket_t *sock, uint32_t acked, uint32_t mss,
+                   uint64_t now_tsc, uint64_t ticks_per_sec);
+    void (*on_loss)(tcp_socket_t *sock, uint32_t mss, uint64_t now_tsc);
+    void (*on_rto)(tcp_socket_t *sock, uint32_t mss, uint64_t now_tsc);
+} tcp_cc_ops_t;
+
+static uint32_t cc_flight(const tcp_socket_t *sock) {
+    return sock->snd_max - sock->snd_una;
+}
+
+// Slow start shared by both controllers. Returns the ACKed bytes left over
+// once cwnd reaches ssthresh (0 while still below it).
+static uint32_t cc_slow_start(tcp_socket_t *sock, uint32_t acked, uint32_t mss) {
+    if (sock->cwnd >= sock->ssthresh) return acked;
+    uint32_t inc = acked < 2u * mss ? acked : 2u * mss;
+    uint32_t room = sock->ssthresh - sock->cwnd;
+    if (inc >= room) {
+        sock->cwnd = sock->ssthresh;
+        return acked > room ? acked - room : 0;
+    }
+    sock->cwnd += inc;
+    return 0;
+}
+
+// --------------------------------------------------------------------
+// Reno.
+// --------------------------------------------------------------------
+static void reno_on_ack(tcp_socket_t *sock, uint32_t acked, uint32_t mss,
+                        uint64_t now_tsc, uint64_t ticks_per_sec) {
+    (void)now_tsc; (void)ticks_per_sec;
+    acked = cc_slow_start(sock, acked, mss);
+    if (acked == 0) return;
+    sock->cc_acked += acked;
+    if (sock->cc_acked >= sock->cwnd) {
+        sock->cc_acked -= sock->cwnd;
+        sock->cwnd += mss;
+    }
+}
+
+static uint32_t reno_ssthresh(const tcp_socket_t *sock, uint32_t mss) {
+    uint32_t half = cc_flight(sock) / 2u;
+    return half > 2u * mss ? half : 2u * mss;
+}
+
+static void reno_on_loss(tcp_socket_t *sock, uint32_t mss, uint64_t now_tsc) {
+    (void)now_tsc;
+    sock->ssthresh = reno_ssthresh(sock, mss);
+    sock->cwnd     = sock->ssthresh;
+    sock->cc_acked = 0;
+}
+
+static void reno_on_rto(tcp_socket_t *sock, uint32_t mss, uint64_t now_tsc) {
+    (void)now_tsc;
+    if (sock->ca_state != TCP_CA_LOSS) sock->ssthresh = reno_ssthresh(sock, mss);
+    sock->cwnd     = mss;
+    sock->cc_acked = 0;
+}
+
+// --------------------------------------------------------------------
+// CUBIC. Times are in ms; C = 0.4 segments/s³ becomes 4·mss / 10^10
+// bytes/ms³.
+// --------------------------------------------------------------------
+#define CUBIC_MAX_DT_MS  100000u   // Bounds d³ so the curve math stays in 64 bits
+
+static uint32_t icbrt64(uint64_t x) {
+    uint32_t r = 0;
+    for (int b = 20; b >= 0; b--) {        // 2^21 cubed still fits
+        uint64_t c = (uint64_t)(r | (1u << b));
+        if (c * c * c <= x) r |= 1u << b;
+    }
+    return r;
+}
+
+static void cubic_reduce(tcp_socket_t *sock, uint32_t mss) {
+    // Fast convergence: a flow that keeps losing before regaining its old
+    // peak releases bandwidth to newcomers by aiming lower next time.
+    if (sock->cwnd < sock->cc_w_last_max) {
+        sock->cc_w_last_max = sock->cwnd;
+        sock->cc_w_max = (uint32_t)(((uint64_t)sock->cwnd * 17u) / 20u);
+    } else {
+        sock->cc_w_last_max = sock->cwnd;
+        sock->cc_w_max = sock->cwnd;
+    }
+    uint32_t ss = (uint32_t)(((uint64_t)sock->cwnd * 7u) / 10u);
+    sock->ssthresh     = ss > 2u * mss ? ss : 2u * mss;
+    sock->cc_epoch_tsc = 0;
+    sock->cc_acked     = 0;
+}
+
+static void cubic_on_ack(tcp_socket_t *sock, uint32_t acked, uint32_t mss,
+                         uint64_t now_tsc, uint64_t ticks_per_sec) {
+    acked = cc_slow_start(sock, acked, mss);
+    if (acked == 0 || ticks_per_sec == 0) return;
+
+    if (sock->cc_epoch_tsc == 0) {
+        sock->cc_epoch_tsc = now_tsc ? now_tsc : 1;
+        sock->cc_w_est     = sock->cwnd;
+        if (sock->cwnd < sock->cc_w_max) {
+            uint64_t gap = sock->cc_w_max - sock->cwnd;
+            sock->cc_k_ms  = icbrt64(gap * 2500000000ull / mss);
+            sock->cc_origin = sock->cc_w_max;
+        } else {
+            sock->cc_k_ms  = 0;
+            sock->cc_origin = sock->cwnd;
+        }
+    }
+
+    // Aim one RTT ahead (RFC 9438 §4.2: W_cubic(t + RTT)).
+    uint64_t t_ms = ((now_tsc - sock->cc_epoch_tsc) * 1000ull) / ticks_per_sec +
+                    sock->srtt_us / 1000u;
+    int64_t  d    = (int64_t)t_ms - (int64_t)sock->cc_k_ms;
+    uint64_t ad   = (uint64_t)(d < 0 ? -d : d);
+    if (ad > CUBIC_MAX_DT_MS) ad = CUBIC_MAX_DT_MS;
+    uint64_t off  = (ad * ad * ad / 10000ull) * 4ull * mss / 1000000ull;
+    uint64_t target = d < 0 ? (off < sock->cc_origin ? sock->cc_origin - off : 0)
+                            : sock->cc_origin + off;
+    uint64_t cap = (uint64_t)sock->cwnd + sock->cwnd / 2u;
+    if (target > cap) target = cap;
+
+    uint32_t inc = 0;
+    if (target > sock->cwnd) {
+        inc = (uint32_t)(((target - sock->cwnd) * acked) / sock->cwnd);
+    }
+    // Reno-friendly region: α = 3(1 − β)/(1 + β) = 9/17 MSS per RTT.
+    sock->cc_w_est += (uint32_t)((9ull * mss * acked) / (17ull * sock->cwnd));
+    if (sock->cc_w_est > sock->cwnd + inc) inc = sock->cc_w_est - sock->cwnd;
+    if (inc > acked) inc = acked;   // No faster than slow start
+    sock->cwnd += inc;
+}
+
+static void cubic_on_loss(tcp_socket_t *sock, uint32_t mss, uint64_t now_tsc) {
+    (void)now_tsc;
+    cubic_reduce(sock, mss);
+    sock->cwnd = sock->ssthresh;
+}
+
+static void cubic_on_rto(tcp_socket_t *sock, uint32_t mss, uint64_t now_tsc) {
+    (void)now_tsc;
+    if (sock->ca_state != TCP_CA_LOSS) cubic_reduce(sock, mss);
+    sock->cwnd = mss;
+}
+
+static const tcp_cc_ops_t g_tcp_cc[TCP_CC_COUNT] = {
+    [TCP_CC_RENO]  = { reno_on_ack,  reno_on_loss,  reno_on_rto  },
+    [TCP_CC_CUBIC] = { cubic_on_ack, cubic_on_loss, cubic_on_rto },
+};
+
+static const tcp_cc_ops_t *cc_ops(tcp_socket_t *sock) {
+    if (sock->cc_algo >= TCP_CC_COUNT) sock->cc_algo = TCP_CC_DEFAULT;
+    return &g_tcp_cc[sock->cc_algo];
+}
+
+// ====================================================================
+// Public entry points.
+// ====================================================================
+void netd_tcp_cc_init(tcp_socket_t *sock) {
+    if (!sock) return;
+    (void)cc_ops(sock);
+    uint32_t mss = netd_tcp_eff_mss(sock);
+    uint32_t iw  = TCP_INIT_CWND_SEGS * mss;
+    uint32_t lim = 14600u > 2u * mss ? 14600u : 2u * mss;
+    sock->cwnd          = iw < lim ? iw : lim;
+    sock->ssthresh      = 0xFFFFFFFFu;
+    sock->cc_acked      = 0;
+    sock->cc_w_max      = 0;
+    sock->cc_w_last_max = 0;
+    sock->cc_origin     = 0;
+    sock->cc_k_ms       = 0;
+    sock->cc_w_est      = 0;
+    sock->cc_epoch_tsc  = 0;
+}
+
+void netd_tcp_cc_on_ack(tcp_socket_t *sock, uint32_t acked,
+                        uint64_t now_tsc, uint64_t ticks_per_sec) {
+    if (!sock || acked == 0) return;
+    cc_ops(sock)->on_ack(sock, acked, netd_tcp_eff_mss(sock),
+                         now_tsc, ticks_per_sec);
+}
+
+void netd_tcp_cc_on_loss(tcp_socket_t *sock, uint64_t now_tsc) {
+    if (!sock) return;
+    cc_ops(sock)->on_loss(sock, netd_tcp_eff_mss(sock), now_tsc);
+}
+
+void netd_tcp_cc_on_rto(tcp_socket_t *sock, uint64_t now_tsc) {
+    if (!sock) return;
+    cc_ops(sock)->on_rto(sock, netd_tcp_eff_mss(sock), now_tsc);
+}
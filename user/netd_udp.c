@@ -4,9 +4,13 @@
 // permits checksum=0 as "disabled" (IPv4 only); we accept incoming 0 but
 // always compute on send so receivers can rely on it.
 //
-// Socket table: 16 fixed slots, bind-by-local-port. Ephemeral allocation
-// scans the 48152-65535 range starting from a running cursor so repeated
-// bindings don't repeatedly probe the same ports.
+// Socket table: UDP_MAX_SOCKETS fixed slots, bind-by-local-port. Ephemeral
+// allocation scans the 48152-65535 range starting from a running cursor so
+// repeated bindings don't repeatedly probe the same ports.
+//
+// Phase 26: BOUND sockets are also chained per port bucket, so inbound
+// demux and the per-candidate in-use probe walk one short chain instead
+// of the whole table.
 
 #include "netd.h"
 
@@ -54,6 +58,15 @@ int netd_udp_parse(const uint8_t *buf, size_t buf_len,
                    uint32_t src_ip, uint32_t dst_ip,
                    uint16_t *out_src_port, uint16_t *out_dst_port,
                    const uint8_t **out_payload, size_t *out_payload_len) {
+    return netd_udp_parse_csum(buf, buf_len, src_ip, dst_ip, 0,
+                               out_src_port, out_dst_port,
+                               out_payload, out_payload_len);
+}
+
+int netd_udp_parse_csum(const uint8_t *buf, size_t buf_len,
+                        uint32_t src_ip, uint32_t dst_ip, uint8_t nic_ok,
+                        uint16_t *out_src_port, uint16_t *out_dst_port,
+                        const uint8_t **out_payload, size_t *out_payload_len) {
     if (!buf || !out_src_port || !out_dst_port || !out_payload ||
         !out_payload_len) return -1;
     if (buf_len < UDP_HDR_LEN) return -1;
@@ -66,8 +79,9 @@ int netd_udp_parse(const uint8_t *buf, size_t buf_len,
     if (length < UDP_HDR_LEN) return -2;
     if (length > buf_len) return -2;
 
-    // Checksum verification (checksum==0 means disabled).
-    if (checksum != 0) {
+    // Checksum verification (checksum==0 means disabled; the NIC may
+    // already have done it).
+    if (checksum != 0 && !(nic_ok & NETD_CSUM_L4_OK)) {
         // Scratch: pseudo-header + UDP segment. Max UDP = 1472 (IP-mtu-20).
         if (length > 1500) return -3;
         uint8_t scratch[12 + 1500];
@@ -93,13 +107,13 @@ void netd_udp_table_init(udp_table_t *tbl) {
     netd_memzero(tbl, sizeof(*tbl));
 }
 
+static inline uint32_t udp_port_bucket(uint16_t port) {
+    return port & (UDP_PORT_BUCKETS - 1u);
+}
+
 // Port-in-use check. Returns 1 if another BOUND socket has `port`.
 static int udp_port_in_use(const udp_table_t *tbl, uint16_t port) {
-    for (uint32_t i = 0; i < UDP_MAX_SOCKETS; i++) {
-        const udp_socket_t *s = &tbl->sockets[i];
-        if (s->state == UDP_STATE_BOUND && s->local_port == port) return 1;
-    }
-    return 0;
+    return netd_udp_find(tbl, port) >= 0;
 }
 
 // Ephemeral cursor. Starts at 48152 (Linux default lower bound) and wraps
@@ -131,6 +145,9 @@ int netd_udp_bind(udp_table_t *tbl, uint16_t port, uint32_t owner_cookie) {
             s->state        = UDP_STATE_BOUND;
             s->local_port   = port;
             s->owner_cookie = owner_cookie;
+            uint32_t b = udp_port_bucket(port);
+            tbl->port_next[i] = tbl->port_head[b];
+            tbl->port_head[b] = (uint16_t)(i + 1u);
             return (int)i;
         }
     }
@@ -139,15 +156,22 @@ int netd_udp_bind(udp_table_t *tbl, uint16_t port, uint32_t owner_cookie) {
 
 void netd_udp_close(udp_table_t *tbl, int idx) {
     if (!tbl || idx < 0 || (uint32_t)idx >= UDP_MAX_SOCKETS) return;
+    if (tbl->sockets[idx].state == UDP_STATE_BOUND) {
+        uint16_t *link = &tbl->port_head[udp_port_bucket(tbl->sockets[idx].local_port)];
+        while (*link && *link != (uint16_t)(idx + 1)) link = &tbl->port_next[*link - 1u];
+        if (*link) *link = tbl->port_next[idx];
+    }
+    tbl->port_next[idx] = 0;
     netd_memzero(&tbl->sockets[idx], sizeof(tbl->sockets[idx]));
 }
 
 int netd_udp_find(const udp_table_t *tbl, uint16_t local_port) {
     if (!tbl) return -1;
-    for (uint32_t i = 0; i < UDP_MAX_SOCKETS; i++) {
-        const udp_socket_t *s = &tbl->sockets[i];
+    for (uint16_t l = tbl->port_head[udp_port_bucket(local_port)]; l;
+         l = tbl->port_next[l - 1u]) {
+        const udp_socket_t *s = &tbl->sockets[l - 1u];
         if (s->state == UDP_STATE_BOUND && s->local_port == local_port) {
-            return (int)i;
+            return (int)(l - 1u);
         }
     }
     return -1;
@@ -113,10 +113,15 @@ void _start(int argc, char **argv) {
     uint64_t ctx_start = 0;
     uint64_t steal_ok_start = 0;
     uint64_t steal_fail_start = 0;
+    uint64_t ho_start[4] = {0};
     for (uint32_t c = 0; c < st.cpu_entries; c++) {
         ctx_start        += st.cpus[c].ctx_switches;
         steal_ok_start   += st.cpus[c].steal_successes;
         steal_fail_start += st.cpus[c].steal_failures;
+        ho_start[0]      += st.cpus[c].handoff_local;
+        ho_start[1]      += st.cpus[c].handoff_ipi_idle;
+        ho_start[2]      += st.cpus[c].handoff_migrate;
+        ho_start[3]      += st.cpus[c].handoff_ipi_preempt;
     }
 
     // Sample loop.
@@ -176,10 +181,15 @@ void _start(int argc, char **argv) {
     uint64_t ctx_end = 0;
     uint64_t steal_ok_end = 0;
     uint64_t steal_fail_end = 0;
+    uint64_t ho_end[4] = {0};
     for (uint32_t c = 0; c < st.cpu_entries; c++) {
         ctx_end        += st.cpus[c].ctx_switches;
         steal_ok_end   += st.cpus[c].steal_successes;
         steal_fail_end += st.cpus[c].steal_failures;
+        ho_end[0]      += st.cpus[c].handoff_local;
+        ho_end[1]      += st.cpus[c].handoff_ipi_idle;
+        ho_end[2]      += st.cpus[c].handoff_migrate;
+        ho_end[3]      += st.cpus[c].handoff_ipi_preempt;
     }
 
     // Teardown — send SIGKILL, reap.
@@ -200,6 +210,15 @@ void _start(int argc, char **argv) {
     print(" steal_failures=");
     print_u64(steal_fail_end - steal_fail_start);
     print("\n");
+    print("schedbench: ipc_handoff local=");
+    print_u64(ho_end[0] - ho_start[0]);
+    print(" ipi_idle=");
+    print_u64(ho_end[1] - ho_start[1]);
+    print(" migrate=");
+    print_u64(ho_end[2] - ho_start[2]);
+    print(" ipi_preempt=");
+    print_u64(ho_end[3] - ho_start[3]);
+    print("\n");
     print("schedbench: max_runq_depth=");
     print_u64(max_depth);
     print("\n");
@@ -159,6 +159,26 @@ typedef long ssize_t;
 
 // Phase 29 Session I (FU24.E).
 #define SYS_SET_CPU_AFFINITY        1123
+// Phase 26: wait-sets (multi-handle blocking readiness wait).
+#define SYS_WAITSET_CREATE          1124
+#define SYS_WAITSET_CTL             1125
+#define SYS_WAITSET_WAIT            1126
+// Phase 26: notify objects (shared-ring doorbells).
+#define SYS_NOTIFY_CREATE           1127
+#define SYS_NOTIFY_SIGNAL           1128
+#define SYS_NOTIFY_WAIT             1129
+// Phase 26: vectored channel send / receive.
+#define SYS_CHAN_SENDV              1130
+#define SYS_CHAN_RECVV              1131
+// Phase 26: page-loan channel transfers.
+#define SYS_CHAN_SEND_LOAN          1132
+#define SYS_CHAN_RECV_LOAN          1133
+// Phase 26: multi-producer channels and broadcast rings.
+#define SYS_CHAN_ADD_WRITER         1134
+#define SYS_BCAST_CREATE            1135
+#define SYS_BCAST_SUBSCRIBE         1136
+#define SYS_BCAST_PUBLISH           1137
+#define SYS_BCAST_READ              1138
 
 // Phase 24 W19: COW snapshot subsystem (slots reconciled to 1093-1096
 // because spec's original 1086-1089 collide with SPAWN_EX..MMIO_VMO_CREATE).
@@ -179,6 +199,7 @@ typedef long ssize_t;
 #define SNAP_SCOPE_SELF             0x00000001u
 #define SNAP_SCOPE_GLOBAL           0x00000002u
 #define SNAP_SCOPE_FREEZE_ALL_CHANS 0x00000004u
+#define SNAP_SCOPE_INCREMENTAL      0x00000008u  // Phase 26: delta vs a parent
 
 #define SNAP_NAME_MAX_LEN_USER  31u  // Max chars (excl NUL) in name.
 
@@ -268,6 +289,7 @@ typedef struct {
 // Phase 17 constants (mirror kernel headers).
 #define CHAN_MODE_BLOCKING     1u
 #define CHAN_MODE_NONBLOCKING  2u
+#define CHAN_MODE_MPSC         0x100u  // Phase 26: OR in; see syscall_chan_add_writer
 #define CHAN_ENDPOINT_READ     1u
 #define CHAN_ENDPOINT_WRITE    2u
 #define CHAN_MSG_INLINE_MAX    256u
@@ -276,10 +298,12 @@ typedef struct {
 #define PROT_READ   0x1u
 #define PROT_WRITE  0x2u
 #define PROT_EXEC   0x4u
+#define VMO_MAP_RETIRE 0x100u  // Phase 26: syscall_vmo_map consumes the handle
 
 #define VMO_ZEROED       0x1u
 #define VMO_ONDEMAND     0x2u
 #define VMO_PINNED       0x4u
+#define VMO_ANON         0x40u  // Phase 26: cap retired by the first map
 #define VMO_CLONE_COW    0x10u
 // Phase 22 Stage B: shared clone. Parent + child map the same physical
 // pages with RW; no copy-on-write machinery. Used for DMA ring handoff
@@ -351,6 +375,9 @@ typedef struct {
 #define DEBUG_SYSCALL_RATE_SET              97
 #define DEBUG_SYSCALL_RATE_EXCEEDED         98
 #define DEBUG_CONSOLE_MARK_DIRTY            99
+#define DEBUG_TLB_STATS                     100
+#define DEBUG_VM_PAGE_SIZE                  101
+#define DEBUG_ELF_CACHE_STATS               102
 #define DEBUG_FB_READ_PIXEL    61
 #define DEBUG_SET_WALL       51
 
@@ -1402,6 +1429,19 @@ static inline long syscall_pledge_narrow_exec(const wasm_pledge_narrow_args_u_t
     return ret;
 }
 
+// Phase 26: SYS_PLEDGE | PLEDGE_FLAG_QUERY returns the caller's current
+// pledge mask without narrowing it (mirror of kernel/cap/pledge.h).
+#define PLEDGE_FLAG_QUERY_U  0x40000000u
+
+static inline long syscall_pledge_query(void) {
+    long ret;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_PLEDGE), "D"((uint64_t)PLEDGE_FLAG_QUERY_U)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
 // Phase 15b: SYS_AUDIT_QUERY(since_ns, until_ns, event_mask, buf, max) ->
 // number of entries written, or negative -CAP_V2_*.
 static inline long syscall_audit_query(uint64_t since_ns, uint64_t until_ns,
@@ -1514,6 +1554,153 @@ static inline long syscall_chan_recv(cap_token_u_t rd_handle,
     return ret;
 }
 
+// Phase 26: vectored send / receive, up to CHAN_VEC_MAX messages per trap.
+// SENDV returns how many of msgs[] were queued (a prefix; handles in the
+// rest stay with the caller). RECVV returns how many were written to msgs[].
+// Both block (up to timeout_ns) only while nothing at all can move.
+#define CHAN_VEC_MAX 16u
+
+static inline long syscall_chan_sendv(cap_token_u_t wr_handle,
+                                      const chan_msg_user_t *msgs,
+                                      uint32_t count, uint64_t timeout_ns) {
+    long ret;
+    register uint64_t r10 asm("r10") = timeout_ns;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_CHAN_SENDV), "D"(wr_handle.raw), "S"(msgs),
+          "d"((uint64_t)count), "r"(r10)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+static inline long syscall_chan_recvv(cap_token_u_t rd_handle,
+                                      chan_msg_user_t *msgs,
+                                      uint32_t max, uint64_t timeout_ns) {
+    long ret;
+    register uint64_t r10 asm("r10") = timeout_ns;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_CHAN_RECVV), "D"(rd_handle.raw), "S"(msgs),
+          "d"((uint64_t)max), "r"(r10)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Phase 26: page loans. SEND_LOAN attaches [vaddr, vaddr + len) of the
+// caller's VMO mappings to the message: COW-shared by default (either side's
+// first write takes a private copy), or with CHAN_LOAN_MOVE a whole mapping
+// of an unshared VMO — e.g. a large malloc block — is unmapped here and
+// handed over. RECV_LOAN maps it at loan->vaddr (0 = anywhere) and reports
+// where; unmap it with syscall_vmo_unmap when done.
+#define CHAN_MSG_FLAG_LOAN  0x01u
+#define CHAN_LOAN_MOVE      0x1u
+
+typedef struct chan_loan {
+    uint64_t vaddr;
+    uint64_t len;
+    uint32_t flags;
+    uint32_t prot;
+} chan_loan_t;
+
+static inline long syscall_chan_send_loan(cap_token_u_t wr_handle,
+                                          const chan_msg_user_t *msg,
+                                          const chan_loan_t *loan,
+                                          uint64_t timeout_ns) {
+    long ret;
+    register uint64_t r10 asm("r10") = timeout_ns;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_CHAN_SEND_LOAN), "D"(wr_handle.raw), "S"(msg), "d"(loan),
+          "r"(r10)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+static inline long syscall_chan_recv_loan(cap_token_u_t rd_handle,
+                                          chan_msg_user_t *msg,
+                                          chan_loan_t *loan,
+                                          uint64_t timeout_ns) {
+    long ret;
+    register uint64_t r10 asm("r10") = timeout_ns;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_CHAN_RECV_LOAN), "D"(rd_handle.raw), "S"(msg), "d"(loan),
+          "r"(r10)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Phase 26: another write end for a channel created with CHAN_MODE_MPSC.
+// peer_pid (<= 0 = none) may also use the new token, e.g. after it is sent
+// to that process. Returns the token raw (>0) or a negative errno.
+static inline long syscall_chan_add_writer(cap_token_u_t wr_handle,
+                                           int32_t peer_pid) {
+    long ret;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_CHAN_ADD_WRITER), "D"(wr_handle.raw),
+          "S"((uint64_t)(int64_t)peer_pid)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Phase 26: broadcast rings (mirror kernel/ipc/bcast.h).
+#define BCAST_MSG_MAX       256u
+#define BCAST_CAPACITY_MAX  1024u
+#define BCAST_READ_MAX      16u
+
+typedef struct {
+    uint64_t seq;          // Publish sequence number, from 0
+    uint64_t lost;         // Messages overwritten before this reader got to them
+    int32_t  sender_pid;
+    uint16_t len;
+    uint16_t _pad;
+    uint8_t  payload[BCAST_MSG_MAX];
+} bcast_msg_t;
+
+// Returns the publisher token raw (>0) and writes the public subscribe
+// token to *sub_tok, or a negative errno.
+static inline long syscall_bcast_create(uint32_t capacity, uint64_t *sub_tok) {
+    long ret;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_BCAST_CREATE), "D"((uint64_t)capacity), "S"(sub_tok)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+static inline long syscall_bcast_subscribe(uint64_t sub_tok) {
+    long ret;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_BCAST_SUBSCRIBE), "D"(sub_tok)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Returns the message's seq (>=0) or a negative errno. Never blocks.
+static inline long syscall_bcast_publish(uint64_t pub_tok, const void *payload,
+                                         uint32_t len) {
+    long ret;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_BCAST_PUBLISH), "D"(pub_tok), "S"(payload), "d"((uint64_t)len)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
+static inline long syscall_bcast_read(uint64_t reader_tok, bcast_msg_t *msgs,
+                                      uint32_t max, uint64_t timeout_ns) {
+    long ret;
+    register uint64_t r10 asm("r10") = timeout_ns;
+    asm volatile("syscall"
+        : "=a"(ret)
+        : "a"(SYS_BCAST_READ), "D"(reader_tok), "S"(msgs), "d"((uint64_t)max),
+          "r"(r10)
+        : "rcx", "r11", "memory");
+    return ret;
+}
+
 static inline long syscall_chan_poll(chan_poll_entry_t *polls, uint32_t npolls,
                                      uint64_t timeout_ns) {
     long ret;
@@ -1562,8 +1749,8 @@ static inline long syscall_chan_connect(const char *name, uint32_t name_len,
 // Phase 25 transactional speculation. SYS_TXN_BEGIN allocates an implicit
 // snapshot via snap_create_internal + pushes a transaction frame on the
 // caller's task. Subsequent chan_send-while-active intercepts go into
-// the txn's buffer; SYS_TXN_COMMIT replays in original order, SYS_TXN_ABORT
-// drops them.
+// the txn's buffer; SYS_TXN_COMMIT replays them in original order per
+// channel, SYS_TXN_ABORT drops them.
 //
 // Flag bits (see kernel/txn/transaction.h for full definition):
 //   TXN_FLAG_SELF_SCOPE   = 0x1  (default)
@@ -1571,11 +1758,14 @@ static inline long syscall_chan_connect(const char *name, uint32_t name_len,
 //   TXN_FLAG_BUFFER_2MB   = 0x10
 //   TXN_FLAG_BUFFER_4MB   = 0x20 (default)
 //   TXN_FLAG_BUFFER_8MB   = 0x40
+//   TXN_FLAG_BUFFER_64MB  = 0x80
+// The buffer grows on demand up to the size flag's cap (default 4 MiB).
 #define TXN_FLAG_SELF_SCOPE   0x00000001u
 #define TXN_FLAG_GLOBAL_SCOPE 0x00000002u
 #define TXN_FLAG_BUFFER_2MB   0x00000010u
 #define TXN_FLAG_BUFFER_4MB   0x00000020u
 #define TXN_FLAG_BUFFER_8MB   0x00000040u
+#define TXN_FLAG_BUFFER_64MB  0x00000080u
 
 static inline long syscall_txn_begin(uint32_t flags, const char *name) {
     long ret;
@@ -1899,6 +2089,109 @@ static inline long syscall_set_cpu_affinity(int32_t pid, uint32_t mask) {
     return ret;
 }
 
+// Phase 26: wait-sets. Mirror of kernel/ipc/waitset.h. Register channel
+// endpoints, IRQ channels and streams once with syscall_waitset_ctl, then
+// block in syscall_waitset_wait for a batch of ready events.
+#define WAITSET_EV_READABLE   0x1u
+#define WAITSET_EV_WRITABLE   0x2u
+#define WAITSET_EV_HUP        0x4u    // always reported
+#define WAITSET_EDGE          0x100u  // report transitions once (default: level)
+#define WAITSET_ONESHOT       0x200u  // disarm after one report until CTL_MOD
+#define WAITSET_CTL_ADD       1u
+#define WAITSET_CTL_MOD       2u
+#define WAITSET_CTL_DEL       3u
+#define WAITSET_WAIT_MAX      64u
+#define WAITSET_FOREVER       0xFFFFFFFFFFFFFFFFull
+
+typedef struct waitset_event {
+    uint64_t cookie;
+    uint32_t events;
+    uint32_t _pad;
+} waitset_event_t;
+
+_Static_assert(sizeof(waitset_event_t) == 16, "waitset_event_t must be 16 bytes");
+
+// Returns the waitset cap_token raw (>0) or negative errno.
+static inline long syscall_waitset_create(void) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_WAITSET_CREATE), "D"((uint64_t)0)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+static inline long syscall_waitset_ctl(uint64_t ws, uint32_t op, uint64_t handle,
+                                       uint32_t events, uint64_t cookie) {
+    long ret;
+    register uint64_t r10 asm("r10") = (uint64_t)events;
+    register uint64_t r8  asm("r8")  = cookie;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_WAITSET_CTL),
+                   "D"(ws),
+                   "S"((uint64_t)op),
+                   "d"(handle),
+                   "r"(r10),
+                   "r"(r8)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+// timeout_ns: 0 polls, WAITSET_FOREVER blocks indefinitely. Returns the
+// number of events written (0 on timeout) or negative errno.
+static inline long syscall_waitset_wait(uint64_t ws, waitset_event_t *events,
+                                        uint32_t max, uint64_t timeout_ns) {
+    long ret;
+    register uint64_t r10 asm("r10") = timeout_ns;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_WAITSET_WAIT),
+                   "D"(ws),
+                   "S"((uint64_t)(uintptr_t)events),
+                   "d"((uint64_t)max),
+                   "r"(r10)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Phase 26: notify objects. Mirror of kernel/ipc/notify.h. A producer ORs
+// bits into the word with syscall_notify_signal; the consumer collects and
+// clears them with syscall_notify_wait, or registers the handle in a
+// wait-set (WAITSET_EV_READABLE while any bit is pending). Only the signal
+// that finds the word empty wakes the consumer.
+
+// Returns the notify cap_token raw (>0) or negative errno.
+static inline long syscall_notify_create(void) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_NOTIFY_CREATE), "D"((uint64_t)0)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+// bits: non-zero, low 32 bits only. Returns 0 or negative errno.
+static inline long syscall_notify_signal(uint64_t n, uint64_t bits) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_NOTIFY_SIGNAL), "D"(n), "S"(bits)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+// timeout_ns: 0 polls, WAITSET_FOREVER blocks indefinitely. Returns the
+// collected bits (>0), 0 on timeout, or negative errno.
+static inline long syscall_notify_wait(uint64_t n, uint64_t timeout_ns) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_NOTIFY_WAIT), "D"(n), "S"(timeout_ns)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
 // Test-only Session E DEBUG wrappers.
 static inline long syscall_debug_anim_tick(uint32_t console_id) {
     long ret;
@@ -2199,6 +2492,66 @@ static inline long syscall_debug_syscall_rate_exceeded(void) {
     return ret;
 }
 
+// Phase 26: TLB shootdown counters. Mirrors tlb_stats_t in
+// arch/x86_64/mm/tlb.h.
+typedef struct {
+    uint64_t shootdowns;
+    uint64_t ipis_sent;
+    uint64_t pages_invalidated;
+    uint64_t full_flushes;
+    uint64_t pcid_hits;
+    uint64_t pcid_misses;
+    uint64_t lazy_invalidations;
+    uint64_t ack_timeouts;
+} tlb_stats_u_t;
+
+// Returns 1 if PCID tagging is active, 0 if not, -1 on error.
+static inline long syscall_debug_tlb_stats(tlb_stats_u_t *out) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_DEBUG),
+                   "D"((uint64_t)DEBUG_TLB_STATS),
+                   "S"((uint64_t)out)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Phase 26: size of the translation backing `va` (4096, 2 MiB, or 0).
+static inline long syscall_debug_vm_page_size(const void *va) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_DEBUG),
+                   "D"((uint64_t)DEBUG_VM_PAGE_SIZE),
+                   "S"((uint64_t)va)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
+// Phase 26: executable page-cache counters. Mirrors elf_cache_stats_t in
+// kernel/elf.h.
+typedef struct {
+    uint64_t images;
+    uint64_t cached_pages;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t cow_copies;
+    uint64_t evictions;
+} elf_cache_stats_u_t;
+
+// Returns 0, or -1 on a bad pointer.
+static inline long syscall_debug_elf_cache_stats(elf_cache_stats_u_t *out) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_DEBUG),
+                   "D"((uint64_t)DEBUG_ELF_CACHE_STATS),
+                   "S"((uint64_t)out)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
 // Drain up to `max` audit_entry_t records from subscriber `slot` into
 // `buf`. Returns count copied (0 if empty, max 64), or -EINVAL.
 static inline long syscall_audit_stream_read(int slot, void *buf, uint32_t max) {
@@ -2276,6 +2629,23 @@ static inline long syscall_snap_create(uint32_t scope_flags, const char *name) {
     return ret;
 }
 
+// Phase 26: incremental snapshot. Captures only the pages that changed
+// since `parent_handle` (one of the caller's snapshot handles) was taken;
+// restoring it replays the parent chain. The parent cannot be deleted
+// (-EBUSY) while the child lives. SNAP_SCOPE_INCREMENTAL is added here.
+static inline long syscall_snap_create_incremental(uint32_t scope_flags,
+                                                   const char *name,
+                                                   uint32_t parent_handle) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(SYS_SNAP_CREATE),
+                   "D"((uint64_t)(scope_flags | SNAP_SCOPE_INCREMENTAL)),
+                   "S"(name), "d"((uint64_t)parent_handle)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+
 static inline long syscall_snap_restore(uint32_t handle) {
     long ret;
     asm volatile("syscall"
@@ -0,0 +1,127 @@
+// user/tests/bcast.c — Phase 26 broadcast-ring and MPSC-channel TAP test.
+//
+// 12 TAP assertions across 5 groups:
+//   G1 create (2)            -- bcast_create returns a publisher handle and a
+//                               subscribe handle; subscribe returns a cursor
+//   G2 fan-out (3)           -- publish returns seq 0,1,2; two cursors each
+//                               read all three with payload and sender intact
+//   G3 overrun (2)           -- a 4-slot ring lapped by 10 publishes yields
+//                               the newest 4 with lost == 6; the next read
+//                               reports lost == 0
+//   G4 errors (2)            -- oversize publish is EINVAL and publishing
+//                               through the subscribe handle is EBADF; an
+//                               idle 20 ms read returns 0
+//   G5 mpsc (3)              -- add_writer mints a second write end for an
+//                               MPSC channel and is EINVAL otherwise; both
+//                               writers' messages reach the reader in order
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+static bcast_msg_t msgs[BCAST_READ_MAX];
+
+static long send_one(cap_token_u_t wr, uint64_t hash, uint8_t v) {
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    m.header.type_hash  = hash;
+    m.header.inline_len = 1;
+    m.inline_payload[0] = v;
+    return syscall_chan_send(wr, &m, 1000000000ULL);
+}
+
+void _start(void) {
+    tap_plan(12);
+
+    // -------------------- G1: create (2 asserts) ---------
+    uint64_t sub_tok = 0;
+    long pub = syscall_bcast_create(16, &sub_tok);
+    TAP_ASSERT(pub > 0 && sub_tok != 0,
+               "1. bcast_create returns publisher and subscribe handles");
+    if (pub <= 0) tap_bail_out("bcast_create failed");
+    long r1 = syscall_bcast_subscribe(sub_tok);
+    long r2 = syscall_bcast_subscribe(sub_tok);
+    TAP_ASSERT(r1 > 0 && r2 > 0 && r1 != r2, "2. each subscribe returns its own cursor");
+    if (r1 <= 0 || r2 <= 0) tap_bail_out("bcast_subscribe failed");
+
+    // -------------------- G2: fan-out (3 asserts) ---------
+    const char *words[3] = { "alpha", "beta", "gamma" };
+    long seqs[3];
+    for (int i = 0; i < 3; i++) {
+        seqs[i] = syscall_bcast_publish((uint64_t)pub, words[i],
+                                        (uint32_t)strlen(words[i]));
+    }
+    TAP_ASSERT(seqs[0] == 0 && seqs[1] == 1 && seqs[2] == 2,
+               "3. publish returns consecutive sequence numbers");
+
+    long n1 = syscall_bcast_read((uint64_t)r1, msgs, BCAST_READ_MAX, 0);
+    int ok1 = n1 == 3;
+    for (int i = 0; ok1 && i < 3; i++) {
+        ok1 = msgs[i].seq == (uint64_t)i && msgs[i].lost == 0 &&
+              msgs[i].len == strlen(words[i]) &&
+              memcmp(msgs[i].payload, words[i], msgs[i].len) == 0;
+    }
+    TAP_ASSERT(ok1, "4. the first cursor reads all three messages");
+    long n2 = syscall_bcast_read((uint64_t)r2, msgs, BCAST_READ_MAX, 0);
+    TAP_ASSERT(n2 == 3 && msgs[2].seq == 2 && msgs[0].sender_pid == msgs[2].sender_pid &&
+               memcmp(msgs[1].payload, "beta", 4) == 0,
+               "5. the second cursor independently reads the same three");
+
+    // -------------------- G3: overrun (2 asserts) ---------
+    uint64_t small_sub = 0;
+    long small = syscall_bcast_create(4, &small_sub);
+    long sr = small > 0 ? syscall_bcast_subscribe(small_sub) : -1;
+    if (sr <= 0) tap_bail_out("small ring setup failed");
+    for (uint8_t v = 0; v < 10; v++) syscall_bcast_publish((uint64_t)small, &v, 1);
+    long k = syscall_bcast_read((uint64_t)sr, msgs, BCAST_READ_MAX, 0);
+    TAP_ASSERT(k == 4 && msgs[0].lost == 6 && msgs[0].seq == 6 &&
+               msgs[3].payload[0] == 9,
+               "6. a lapped cursor gets the newest 4 and lost == 6");
+    uint8_t v10 = 10;
+    syscall_bcast_publish((uint64_t)small, &v10, 1);
+    k = syscall_bcast_read((uint64_t)sr, msgs, BCAST_READ_MAX, 0);
+    TAP_ASSERT(k == 1 && msgs[0].lost == 0 && msgs[0].seq == 10,
+               "7. the next read reports no further loss");
+
+    // -------------------- G4: errors (2 asserts) ---------
+    static uint8_t big[BCAST_MSG_MAX + 1];
+    TAP_ASSERT(syscall_bcast_publish((uint64_t)pub, big, sizeof(big)) == -5 &&
+               syscall_bcast_publish(sub_tok, "x", 1) == -9,
+               "8. oversize is EINVAL; the subscribe handle cannot publish");
+    TAP_ASSERT(syscall_bcast_read((uint64_t)r1, msgs, 1, 20000000ULL) == 0,
+               "9. a 20 ms read on an idle ring times out with 0");
+
+    // -------------------- G5: mpsc (3 asserts) ---------
+    uint64_t hash = gcp_type_hash("grahaos.test.v1");
+    cap_token_u_t wr1, rd, wr2;
+    long crc = syscall_chan_create(hash, CHAN_MODE_BLOCKING | CHAN_MODE_MPSC, 8, &wr1);
+    if (crc <= 0) tap_bail_out("mpsc chan_create failed");
+    rd.raw = (uint64_t)crc;
+    long w2 = syscall_chan_add_writer(wr1, 0);
+    TAP_ASSERT(w2 > 0 && (uint64_t)w2 != wr1.raw,
+               "10. add_writer mints a second write end");
+    wr2.raw = (uint64_t)w2;
+
+    cap_token_u_t plain_wr;
+    long prc = syscall_chan_create(hash, CHAN_MODE_BLOCKING, 8, &plain_wr);
+    TAP_ASSERT(prc > 0 && syscall_chan_add_writer(plain_wr, 0) == -5,
+               "11. add_writer on a point-to-point channel is EINVAL");
+
+    send_one(wr1, hash, 0xA1);
+    send_one(wr2, hash, 0xB2);
+    send_one(wr1, hash, 0xA3);
+    uint8_t got[3] = {0};
+    for (int i = 0; i < 3; i++) {
+        chan_msg_user_t m;
+        memset(&m, 0, sizeof(m));
+        if (syscall_chan_recv(rd, &m, 0) >= 1) got[i] = m.inline_payload[0];
+    }
+    TAP_ASSERT(got[0] == 0xA1 && got[1] == 0xB2 && got[2] == 0xA3,
+               "12. messages from both writers arrive in send order");
+
+    tap_done();
+    exit(0);
+}
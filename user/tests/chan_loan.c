@@ -0,0 +1,138 @@
+// user/tests/chan_loan.c — Phase 26 page-loan channel TAP test.
+//
+// 11 TAP assertions across 4 groups:
+//   G1 COW loan (4)          -- SEND_LOAN of 2 middle pages succeeds;
+//                               RECV_LOAN maps them with the sender's bytes;
+//                               a receiver write stays private; a sender
+//                               write after the loan copies instead of
+//                               faulting and stays private too
+//   G2 MOVE loan (3)         -- a moved anonymous block leaves the sender;
+//                               RECV_LOAN maps it at the receiver's chosen
+//                               address with its contents; a failed send
+//                               maps the block back
+//   G3 plain recv (1)        -- SYS_CHAN_RECV gets the loan as a mappable
+//                               VMO handle with CHAN_MSG_FLAG_LOAN set
+//   G4 errors (3)            -- MOVE of a VMO that still has a cap is EBUSY;
+//                               an unmapped range is EFAULT; a PINNED
+//                               (device-addressed) source is EPERM
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define PG 4096ull
+
+static uint64_t hash;
+static cap_token_u_t rd, wr;
+
+static void msg_init(chan_msg_user_t *m, uint8_t tag) {
+    memset(m, 0, sizeof(*m));
+    m->header.type_hash  = hash;
+    m->header.inline_len = 1;
+    m->inline_payload[0] = tag;
+}
+
+static long send_loan(uint64_t va, uint64_t len, uint32_t flags, uint64_t timeout) {
+    chan_msg_user_t m;
+    msg_init(&m, 0x5A);
+    chan_loan_t l = { .vaddr = va, .len = len, .flags = flags, .prot = 0 };
+    return syscall_chan_send_loan(wr, &m, &l, timeout);
+}
+
+void _start(void) {
+    tap_plan(11);
+
+    hash = gcp_type_hash("grahaos.test.v1");
+    long crc = syscall_chan_create(hash, CHAN_MODE_BLOCKING, 4, &wr);
+    if (crc <= 0) tap_bail_out("chan_create failed");
+    rd.raw = (uint64_t)crc;
+
+    chan_msg_user_t m;
+    chan_loan_t got;
+
+    // -------------------- G1: COW loan (4 asserts) ---------
+    long vrc = syscall_vmo_create(4 * PG, VMO_ZEROED);
+    cap_token_u_t src = {.raw = (uint64_t)vrc};
+    long smap = syscall_vmo_map(src, 0, 0, 4 * PG, PROT_READ | PROT_WRITE);
+    if (vrc <= 0 || smap <= 0) tap_bail_out("source VMO create/map failed");
+    uint8_t *s = (uint8_t *)(uintptr_t)smap;
+    for (uint64_t i = 0; i < 4; i++) s[i * PG] = (uint8_t)(0xA0 + i);
+
+    TAP_ASSERT(send_loan((uint64_t)smap + PG, 2 * PG, 0, 0) == 0,
+               "1. SEND_LOAN of two middle pages succeeds");
+    memset(&got, 0, sizeof(got));
+    long rc = syscall_chan_recv_loan(rd, &m, &got, 1000000000ULL);
+    uint8_t *r = (uint8_t *)(uintptr_t)got.vaddr;
+    TAP_ASSERT(rc == 1 && got.vaddr != 0 && got.len == 2 * PG &&
+               m.header.nhandles == 0 && r[0] == 0xA1 && r[PG] == 0xA2,
+               "2. RECV_LOAN maps the range with the sender's bytes");
+    if (!got.vaddr) tap_bail_out("loan not mapped");
+
+    r[0] = 0x11;
+    TAP_ASSERT(r[0] == 0x11 && s[PG] == 0xA1,
+               "3. a receiver write stays private to the receiver");
+    s[2 * PG] = 0x22;
+    s[0] = 0x33;
+    TAP_ASSERT(s[2 * PG] == 0x22 && r[PG] == 0xA2 && s[0] == 0x33,
+               "4. a sender write after the loan copies and stays private");
+    syscall_vmo_unmap(got.vaddr, got.len);
+
+    // -------------------- G2: MOVE loan (3 asserts) ---------
+    long arc = syscall_vmo_create(2 * PG, VMO_ZEROED | VMO_ANON);
+    cap_token_u_t anon = {.raw = (uint64_t)arc};
+    long amap = syscall_vmo_map(anon, 0, 0, 2 * PG, PROT_READ | PROT_WRITE);
+    if (arc <= 0 || amap <= 0) tap_bail_out("anon VMO create/map failed");
+    uint8_t *a = (uint8_t *)(uintptr_t)amap;
+    a[0] = 0xC0; a[PG] = 0xC1;
+
+    long mrc = send_loan((uint64_t)amap, 2 * PG, CHAN_LOAN_MOVE, 0);
+    TAP_ASSERT(mrc == 0 && syscall_vmo_unmap((uint64_t)amap, 2 * PG) == -5,
+               "5. a MOVE loan leaves the sender's address space");
+    memset(&got, 0, sizeof(got));
+    got.vaddr = (uint64_t)amap;   // the receiver picks the (now free) address
+    rc = syscall_chan_recv_loan(rd, &m, &got, 1000000000ULL);
+    TAP_ASSERT(rc == 1 && got.vaddr == (uint64_t)amap && a[0] == 0xC0 && a[PG] == 0xC1,
+               "6. RECV_LOAN maps it at the receiver's chosen address");
+
+    // Fill the 4-slot ring so the next send fails after the range moved.
+    for (int i = 0; i < 4; i++) {
+        msg_init(&m, (uint8_t)i);
+        syscall_chan_send(wr, &m, 0);
+    }
+    a[0] = 0xD0;
+    mrc = send_loan((uint64_t)amap, 2 * PG, CHAN_LOAN_MOVE, 0);
+    TAP_ASSERT(mrc == -11 && a[0] == 0xD0 &&
+               syscall_vmo_unmap((uint64_t)amap, 2 * PG) == 0,
+               "7. a failed MOVE send maps the block back");
+    for (int i = 0; i < 4; i++) syscall_chan_recv(rd, &m, 0);
+
+    // -------------------- G3: plain recv (1 assert) ---------
+    send_loan((uint64_t)smap, PG, 0, 0);
+    memset(&m, 0, sizeof(m));
+    rc = syscall_chan_recv(rd, &m, 1000000000ULL);
+    int mapped = 0;
+    if (rc == 1 && m.header.nhandles == 1 && (m.header.flags & CHAN_MSG_FLAG_LOAN)) {
+        cap_token_u_t lv = {.raw = m.handles[0]};
+        long lmap = syscall_vmo_map(lv, 0, 0, PG, PROT_READ);
+        mapped = (lmap > 0 && ((uint8_t *)(uintptr_t)lmap)[0] == 0x33);
+        if (lmap > 0) syscall_vmo_unmap((uint64_t)lmap, PG);
+    }
+    TAP_ASSERT(mapped, "8. plain recv gets the loan as a flagged VMO handle");
+
+    // -------------------- G4: errors (3 asserts) ---------
+    TAP_ASSERT(send_loan((uint64_t)smap, 4 * PG, CHAN_LOAN_MOVE, 0) == -16,
+               "9. MOVE of a VMO that still has a cap returns EBUSY");
+    TAP_ASSERT(send_loan(0x7000000000ull, PG, 0, 0) == -4,
+               "10. loaning an unmapped range returns EFAULT");
+    long prc = syscall_vmo_create(PG, VMO_ZEROED | VMO_PINNED);
+    cap_token_u_t pv = {.raw = (uint64_t)prc};
+    long pmap = prc > 0 ? syscall_vmo_map(pv, 0, 0, PG, PROT_READ | PROT_WRITE) : 0;
+    TAP_ASSERT(pmap > 0 && send_loan((uint64_t)pmap, PG, 0, 0) == -1,
+               "11. loaning a PINNED VMO's pages returns EPERM");
+
+    tap_done();
+    exit(0);
+}
@@ -0,0 +1,98 @@
+// user/tests/chan_vec.c — Phase 26 vectored channel I/O TAP test.
+//
+// 10 TAP assertions across 4 groups:
+//   G1 round trip (3)        -- SENDV of 5 queues 5; RECVV returns all 5 in
+//                               order with consecutive seqs; the ring is then
+//                               empty (EAGAIN)
+//   G2 partial (3)           -- SENDV of 6 into a capacity-4 ring queues 4;
+//                               a handle in an unqueued message still works;
+//                               SENDV into the full ring is EAGAIN
+//   G3 recv max (1)          -- RECVV with max 2 returns the 2 oldest
+//   G4 errors (3)            -- a type mismatch mid-batch ends it there, and
+//                               is EPROTOTYPE at the head; count 0 / 17 is
+//                               EINVAL
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+static uint64_t hash;
+static chan_msg_user_t tx[CHAN_VEC_MAX + 1];
+static chan_msg_user_t rx[CHAN_VEC_MAX];
+
+static void fill(uint32_t n, uint8_t base) {
+    memset(tx, 0, sizeof(tx));
+    for (uint32_t i = 0; i < n; i++) {
+        tx[i].header.type_hash  = hash;
+        tx[i].header.inline_len = 1;
+        tx[i].inline_payload[0] = (uint8_t)(base + i);
+    }
+}
+
+static cap_token_u_t make_chan(uint32_t capacity, cap_token_u_t *wr) {
+    cap_token_u_t rd;
+    long crc = syscall_chan_create(hash, CHAN_MODE_BLOCKING, capacity, wr);
+    if (crc <= 0) tap_bail_out("chan_create failed");
+    rd.raw = (uint64_t)crc;
+    return rd;
+}
+
+void _start(void) {
+    tap_plan(10);
+
+    hash = gcp_type_hash("grahaos.test.v1");
+    cap_token_u_t wr, rd = make_chan(16, &wr);
+
+    // -------------------- G1: round trip (3 asserts) ---------
+    fill(5, 0x10);
+    TAP_ASSERT(syscall_chan_sendv(wr, tx, 5, 1000000000ULL) == 5,
+               "1. SENDV of 5 queues all 5");
+    memset(rx, 0, sizeof(rx));
+    long n = syscall_chan_recvv(rd, rx, CHAN_VEC_MAX, 1000000000ULL);
+    int in_order = (n == 5);
+    for (long i = 0; in_order && i < n; i++) {
+        if (rx[i].inline_payload[0] != (uint8_t)(0x10 + i)) in_order = 0;
+        if (i && rx[i].header.seq != rx[i - 1].header.seq + 1) in_order = 0;
+    }
+    TAP_ASSERT(in_order, "2. RECVV returns them in order with consecutive seqs");
+    TAP_ASSERT(syscall_chan_recvv(rd, rx, CHAN_VEC_MAX, 0) == -11,
+               "3. RECVV on the drained ring polls EAGAIN");
+
+    // -------------------- G2: partial (3 asserts) ---------
+    cap_token_u_t wr4, rd4 = make_chan(4, &wr4);
+    long nrc = syscall_notify_create();
+    if (nrc <= 0) tap_bail_out("notify_create failed");
+    fill(6, 0x20);
+    tx[5].header.nhandles = 1;
+    tx[5].handles[0]       = (uint64_t)nrc;
+    TAP_ASSERT(syscall_chan_sendv(wr4, tx, 6, 0) == 4,
+               "4. SENDV of 6 into a capacity-4 ring queues 4");
+    TAP_ASSERT(syscall_notify_signal((uint64_t)nrc, 1) == 0 &&
+               syscall_notify_wait((uint64_t)nrc, 0) == 1,
+               "5. a handle in an unqueued message stays with the sender");
+    TAP_ASSERT(syscall_chan_sendv(wr4, tx, 1, 0) == -11,
+               "6. SENDV into a full ring polls EAGAIN");
+
+    // -------------------- G3: recv max (1 assert) ---------
+    n = syscall_chan_recvv(rd4, rx, 2, 0);
+    TAP_ASSERT(n == 2 && rx[0].inline_payload[0] == 0x20 &&
+               rx[1].inline_payload[0] == 0x21,
+               "7. RECVV with max 2 returns the 2 oldest");
+
+    // -------------------- G4: errors (3 asserts) ---------
+    fill(3, 0x30);
+    tx[1].header.type_hash = hash ^ 1;
+    TAP_ASSERT(syscall_chan_sendv(wr, tx, 3, 0) == 1,
+               "8. a mid-batch type mismatch ends the batch before it");
+    TAP_ASSERT(syscall_chan_sendv(wr, &tx[1], 2, 0) == -71,
+               "9. a mismatch at the head returns EPROTOTYPE");
+    TAP_ASSERT(syscall_chan_sendv(wr, tx, 0, 0) == -5 &&
+               syscall_chan_recvv(rd, rx, CHAN_VEC_MAX + 1, 0) == -5,
+               "10. count 0 and count > CHAN_VEC_MAX return EINVAL");
+
+    tap_done();
+    exit(0);
+}
@@ -0,0 +1,67 @@
+// user/tests/elf_cache.c — Phase 26 executable page-cache TAP test.
+//
+// Self-as-helper (see spawn_argv.c): run with argc == 0 this binary is the
+// TEST PARENT; spawned with argc > 0 it is the HELPER, which checks that
+// its .data page still holds the on-disk value and exits 0 if so.
+//
+// 5 TAP assertions across 3 groups:
+//   G1 stats (1)             -- DEBUG_ELF_CACHE_STATS reports a cached image
+//   G2 data COW (2)          -- first write to an untouched .data page is
+//                               one image COW copy; the write reads back
+//   G3 second instance (2)   -- spawning this binary again hits the cache;
+//                               the child sees pristine .data, not ours
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Initialised, so it lands in .data (file-backed, PTE_IMAGE_COW) rather
+// than .bss; page-aligned so nothing else touches the page first.
+static volatile uint8_t g_page[4096] __attribute__((aligned(4096))) = { 0x11 };
+
+static void run_helper(void) {
+    if (g_page[0] != 0x11) syscall_exit(1);
+    g_page[0] = 0x22;
+    syscall_exit(g_page[0] == 0x22 ? 0 : 2);
+}
+
+void _start(int argc, char **argv) {
+    (void)argv;
+    if (argc > 0) run_helper();
+
+    tap_plan(5);
+
+    // -------------------- G1: stats (1 assert) ---------
+    elf_cache_stats_u_t s0, s1;
+    memset(&s0, 0, sizeof(s0));
+    long rc = syscall_debug_elf_cache_stats(&s0);
+    TAP_ASSERT(rc == 0 && s0.images >= 1 && s0.cached_pages >= 1,
+               "1. DEBUG_ELF_CACHE_STATS reports at least one cached image");
+
+    // -------------------- G2: data COW (2 asserts) ---------
+    syscall_debug_elf_cache_stats(&s0);
+    g_page[0] = 0x77;
+    syscall_debug_elf_cache_stats(&s1);
+    TAP_ASSERT(s1.cow_copies - s0.cow_copies >= 1,
+               "2. first write to a .data page takes an image COW copy");
+    TAP_ASSERT(g_page[0] == 0x77, "3. the write lands in the private copy");
+
+    // -------------------- G3: second instance (2 asserts) ---------
+    char *child_argv[] = { "bin/tests/elf_cache.tap", "child" };
+    syscall_debug_elf_cache_stats(&s0);
+    int pid = syscall_spawn_argv("bin/tests/elf_cache.tap", 2, child_argv);
+    syscall_debug_elf_cache_stats(&s1);
+    TAP_ASSERT(pid > 0 && s1.hits - s0.hits >= 1,
+               "4. spawning the same binary again is a page-cache hit");
+
+    int status = -1;
+    if (pid > 0) syscall_wait(&status);
+    TAP_ASSERT(status == 0 && g_page[0] == 0x77,
+               "5. child sees pristine .data; parent's copy is untouched");
+
+    tap_done();
+    exit(0);
+}
@@ -0,0 +1,93 @@
+// user/tests/huge_pages.c — Phase 26 2 MiB page TAP test.
+//
+// 10 TAP assertions across 4 groups:
+//   G1 VMO map (4)           -- 4 MiB VMO maps 2 MiB-aligned with large
+//                               pages; writes read back at every page
+//   G2 COW split (3)         -- child's first write splits only its own
+//                               mapping; parent and sibling pages intact
+//   G3 unmap (1)             -- unmap of a huge-mapped range succeeds
+//   G4 brk (2)               -- a brk growth spanning an aligned 2 MiB
+//                               window uses a large page; shrink returns it
+//
+// The large-page asserts assume the PMM still has free aligned 2 MiB runs,
+// which holds under the gate's 512 MiB guest.
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define PAGE_SZ  4096ull
+#define HUGE_SZ  (2ull * 1024 * 1024)
+#define VMO_SZ   (2 * HUGE_SZ)
+
+void _start(void) {
+    tap_plan(10);
+
+    // -------------------- G1: VMO map (4 asserts) ---------
+    long vres = syscall_vmo_create(VMO_SZ, VMO_ZEROED);
+    TAP_ASSERT(vres > 0, "1. vmo_create(4 MiB, ZEROED) returns a valid token");
+    cap_token_u_t vmo = {.raw = (uint64_t)vres};
+
+    long map = syscall_vmo_map(vmo, 0, 0, VMO_SZ, PROT_READ | PROT_WRITE);
+    if (map <= 0) tap_bail_out("4 MiB VMO map failed");
+    TAP_ASSERT((map & (HUGE_SZ - 1)) == 0, "2. 4 MiB mapping gets a 2 MiB-aligned VA");
+
+    uint8_t *p = (uint8_t *)(uintptr_t)map;
+    TAP_ASSERT(syscall_debug_vm_page_size(p) == (long)HUGE_SZ &&
+               syscall_debug_vm_page_size(p + HUGE_SZ) == (long)HUGE_SZ,
+               "3. both halves are mapped with 2 MiB pages");
+
+    for (uint64_t i = 0; i < VMO_SZ / PAGE_SZ; i++) p[i * PAGE_SZ] = (uint8_t)i;
+    int readback = 1;
+    for (uint64_t i = 0; i < VMO_SZ / PAGE_SZ; i++) {
+        if (p[i * PAGE_SZ] != (uint8_t)i) { readback = 0; break; }
+    }
+    TAP_ASSERT(readback, "4. per-page pattern reads back through large pages");
+
+    // -------------------- G2: COW split (3 asserts) ---------
+    long cres = syscall_vmo_clone(vmo, VMO_CLONE_COW);
+    cap_token_u_t child = {.raw = (uint64_t)cres};
+    long cmap = (cres > 0) ? syscall_vmo_map(child, 0, 0, VMO_SZ,
+                                             PROT_READ | PROT_WRITE) : -1;
+    if (cmap <= 0) tap_bail_out("COW child map failed");
+    uint8_t *c = (uint8_t *)(uintptr_t)cmap;
+
+    c[PAGE_SZ] = 0xEE;
+    TAP_ASSERT(syscall_debug_vm_page_size(c + PAGE_SZ) == (long)PAGE_SZ &&
+               syscall_debug_vm_page_size(p + PAGE_SZ) == (long)HUGE_SZ,
+               "5. child write splits the child's 2 MiB page, not the parent's");
+    TAP_ASSERT(c[PAGE_SZ] == 0xEE && p[PAGE_SZ] == 1,
+               "6. child write is private to the child");
+    TAP_ASSERT(c[2 * PAGE_SZ] == 2 && c[HUGE_SZ] == (uint8_t)(HUGE_SZ / PAGE_SZ),
+               "7. untouched pages of the split region still read shared data");
+
+    syscall_vmo_unmap((uint64_t)cmap, VMO_SZ);
+
+    // -------------------- G3: unmap (1 assert) ---------
+    long urc = syscall_vmo_unmap((uint64_t)map, VMO_SZ);
+    TAP_ASSERT(urc == 0, "8. vmo_unmap of a huge-mapped range returns 0");
+
+    // -------------------- G4: brk (2 asserts) ---------
+    long cur = syscall_brk(NULL);
+    uint64_t aligned = ((uint64_t)cur + HUGE_SZ - 1) & ~(HUGE_SZ - 1);
+    long grown = syscall_brk((void *)(aligned + HUGE_SZ));
+    int huge_brk = (grown == (long)(aligned + HUGE_SZ)) &&
+                   syscall_debug_vm_page_size((void *)aligned) == (long)HUGE_SZ;
+    if (huge_brk) {
+        volatile uint8_t *h = (volatile uint8_t *)aligned;
+        h[0] = 0x5A;
+        h[HUGE_SZ - 1] = 0xA5;
+        huge_brk = (h[0] == 0x5A && h[HUGE_SZ - 1] == 0xA5);
+    }
+    TAP_ASSERT(huge_brk, "9. brk growth over an aligned 2 MiB window uses a large page");
+
+    long shrunk = syscall_brk((void *)cur);
+    TAP_ASSERT(shrunk == cur && syscall_debug_vm_page_size((void *)aligned) == 0,
+               "10. brk shrink unmaps the large page");
+
+    tap_done();
+    exit(0);
+}
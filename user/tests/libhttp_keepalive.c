@@ -0,0 +1,152 @@
+// user/tests/libhttp_keepalive.c — Phase 29 keep-alive pool gate.
+//
+// Live coverage for libhttp's connection pool against the host-side
+// scripts/run_http_keepalive_server.sh (10.0.2.2:8081 from the guest).
+// Every response names the server-side connection and its request count
+// ("conn=C req=R"), so each assert checks which connection carried it.
+// 6 asserts:
+//
+//   1. A first GET opens a fresh connection (req=1).
+//   2. A second GET reuses the pooled connection (same conn, req=2).
+//   3. http_get_pipelined sends three GETs down that connection and reads
+//      the answers in order (req=3,4,5).
+//   4. After the server closes a pooled connection (GET /drop), the next
+//      GET fails on it and is replayed on a fresh connection.
+//   5. The same idle-close, hit by a pipelined batch: the whole batch is
+//      replayed on one fresh connection, in order.
+//   6. With keep-alive off, consecutive GETs never share a connection.
+//
+// Like dnstest, the suite skips when netd or the host listener is absent
+// (the automated gate runs neither); launch the script to run it for real.
+
+#include "../libtap.h"
+#include "../syscalls.h"
+#include "../libnet/libnet.h"
+#include "../libnet/libnet_msg.h"
+#include "../libhttp/libhttp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define KA_ORIGIN  "http://10.0.2.2:8081"
+#define KA_PLAN    6
+
+// Parse the decimal after `key` in the response body; -1 if absent.
+static long body_field(const http_response_t *r, const char *key) {
+    size_t klen = strlen(key);
+    if (!r->body || r->body_len < klen) return -1;
+    for (uint32_t i = 0; i + klen <= r->body_len; i++) {
+        if (memcmp(r->body + i, key, klen) != 0) continue;
+        long v = 0;
+        uint32_t j = i + (uint32_t)klen;
+        if (j >= r->body_len || r->body[j] < '0' || r->body[j] > '9') return -1;
+        while (j < r->body_len && r->body[j] >= '0' && r->body[j] <= '9') {
+            v = v * 10 + (r->body[j++] - '0');
+        }
+        return v;
+    }
+    return -1;
+}
+
+// GET `path`; on a 200 store the serving connection and its request count.
+static int ka_get(const char *path, long *conn, long *req) {
+    http_response_t r;
+    int rc = http_get(&r, path, 5000);
+    *conn = rc == 200 ? body_field(&r, "conn=") : -1;
+    *req  = rc == 200 ? body_field(&r, "req=")  : -1;
+    http_response_free(&r);
+    return rc;
+}
+
+static void skip_all(const char *why) {
+    for (int i = 0; i < KA_PLAN; i++) tap_skip("keep-alive assertion", why);
+    tap_done();
+    exit(0);
+}
+
+void _start(void) {
+    printf("=== libhttp_keepalive — Phase 29 pool reuse + idle-close replay ===\n");
+    tap_plan(KA_PLAN);
+
+    libnet_client_ctx_t nc;
+    if (libnet_connect_service_with_retry(LIBNET_NAME_SERVICE,
+                                          (uint32_t)strlen(LIBNET_NAME_SERVICE),
+                                          2000, &nc) < 0) {
+        skip_all("netd not running in ktest mode (environmental)");
+    }
+
+    // 1. Fresh connection. Doubles as the reachability probe.
+    long c1 = -1, r1 = -1;
+    int rc = ka_get(KA_ORIGIN "/n/1", &c1, &r1);
+    if (rc < 0) {
+        printf("  probe GET rc=%d — run scripts/run_http_keepalive_server.sh\n", rc);
+        skip_all("host-side keep-alive listener not reachable (environmental)");
+    }
+    TAP_ASSERT(rc == 200 && c1 > 0 && r1 == 1,
+               "1. first GET opens a fresh connection");
+
+    // 2. Pool reuse.
+    long c2 = -1, r2 = -1;
+    rc = ka_get(KA_ORIGIN "/n/2", &c2, &r2);
+    TAP_ASSERT(rc == 200 && c2 == c1 && r2 == 2,
+               "2. second GET reuses the pooled connection");
+
+    // 3. Pipelined batch on the pooled connection.
+    {
+        const char *urls[3] = {
+            KA_ORIGIN "/n/3", KA_ORIGIN "/n/4", KA_ORIGIN "/n/5",
+        };
+        http_response_t rs[3];
+        int got = http_get_pipelined(rs, urls, 3, 5000);
+        int ok = got == 3;
+        for (int i = 0; i < 3; i++) {
+            ok = ok && rs[i].status_code == 200 &&
+                 body_field(&rs[i], "conn=") == c1 &&
+                 body_field(&rs[i], "req=") == 3 + i;
+            http_response_free(&rs[i]);
+        }
+        if (!ok) printf("  pipelined got=%d\n", got);
+        TAP_ASSERT(ok, "3. pipelined GETs share the pooled connection, in order");
+    }
+
+    // 4. Idle close: /drop answers as keep-alive (so the connection is
+    // pooled) and then the server hangs up. Give the FIN time to land.
+    long cd = -1, rd = -1, c4 = -1, r4 = -1;
+    (void)ka_get(KA_ORIGIN "/drop", &cd, &rd);
+    spin_us(200000);
+    rc = ka_get(KA_ORIGIN "/n/6", &c4, &r4);
+    TAP_ASSERT(cd == c1 && rc == 200 && c4 > c1 && r4 == 1,
+               "4. GET on a server-closed pooled connection is replayed fresh");
+
+    // 5. The same, hit by a pipelined batch.
+    {
+        long ce = -1, re = -1;
+        (void)ka_get(KA_ORIGIN "/drop", &ce, &re);
+        spin_us(200000);
+        const char *urls[2] = { KA_ORIGIN "/n/7", KA_ORIGIN "/n/8" };
+        http_response_t rs[2];
+        int got = http_get_pipelined(rs, urls, 2, 5000);
+        long cp = got == 2 ? body_field(&rs[0], "conn=") : -1;
+        int ok = ce == c4 && got == 2 && cp > c4 &&
+                 body_field(&rs[1], "conn=") == cp &&
+                 body_field(&rs[0], "req=") == 1 &&
+                 body_field(&rs[1], "req=") == 2;
+        for (int i = 0; i < 2; i++) http_response_free(&rs[i]);
+        if (!ok) printf("  replayed batch got=%d conn=%ld\n", got, cp);
+        TAP_ASSERT(ok, "5. a pipelined batch on a closed connection is replayed fresh");
+    }
+
+    // 6. Keep-alive off: nothing is pooled.
+    http_set_keepalive(0);
+    long c6a = -1, r6a = -1, c6b = -1, r6b = -1;
+    int rca = ka_get(KA_ORIGIN "/n/9", &c6a, &r6a);
+    int rcb = ka_get(KA_ORIGIN "/n/10", &c6b, &r6b);
+    http_set_keepalive(1);
+    TAP_ASSERT(rca == 200 && rcb == 200 && r6a == 1 && r6b == 1 && c6b != c6a,
+               "6. with keep-alive off every GET gets its own connection");
+
+    http_pool_flush();
+    tap_done();
+    exit(0);
+}
@@ -1,9 +1,10 @@
 // user/tests/libhttp_parse.c — Phase 22 Stage D TAP test.
 //
 // Pure-wire coverage of libhttp's URL parser, status-line parser,
-// header-block walker, and chunked decoder. These are the pieces that run
-// entirely offline; live-TCP coverage of libhttp lives in Stage E once
-// httptest migrates to the channel-RPC stack.
+// header-block walker, chunked decoder, and (Phase 29) keep-alive response
+// framing. These are the pieces that run entirely offline; live-TCP
+// coverage of libhttp lives in Stage E once httptest migrates to the
+// channel-RPC stack.
 
 #include "libtap.h"
 #include "../libhttp/libhttp.h"
@@ -172,6 +173,57 @@ static void test_chunked_malformed(void) {
     TAP_ASSERT(n < 0, "chunked: non-hex size rejected");
 }
 
+// --- Response framing (Phase 29 keep-alive) -------------------------------
+static void test_frame_content_length(void) {
+    const char *s = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhelloHTTP/1.1";
+    http_frame_t f;
+    int rc = http_response_frame((const uint8_t *)s, (uint32_t)strlen(s), 0, &f);
+    TAP_ASSERT(rc == 1, "frame: Content-Length response complete");
+    TAP_ASSERT(f.status == 200 && f.total_len == f.head_len + 5,
+               "frame: stops after 5 body bytes (pipelined spill kept)");
+    TAP_ASSERT(f.keep_alive == 1, "frame: HTTP/1.1 defaults to keep-alive");
+    rc = http_response_frame((const uint8_t *)s, f.head_len + 3, 0, &f);
+    TAP_ASSERT(rc == 0, "frame: short body needs more bytes");
+}
+
+static void test_frame_chunked(void) {
+    const char *s = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                    "3\r\nabc\r\n0\r\n\r\n";
+    uint32_t len = (uint32_t)strlen(s);
+    http_frame_t f;
+    TAP_ASSERT(http_response_frame((const uint8_t *)s, len, 0, &f) == 1 &&
+               f.total_len == len,
+               "frame: chunked body ends at the terminating chunk");
+    TAP_ASSERT(http_response_frame((const uint8_t *)s, len - 2, 0, &f) == 0,
+               "frame: chunked body without final CRLF is incomplete");
+}
+
+static void test_frame_no_body(void) {
+    const char *s = "HTTP/1.1 304 Not Modified\r\nContent-Length: 99\r\n\r\n";
+    http_frame_t f;
+    TAP_ASSERT(http_response_frame((const uint8_t *)s, (uint32_t)strlen(s),
+                                   0, &f) == 1 &&
+               f.total_len == f.head_len,
+               "frame: 304 has no body despite Content-Length");
+}
+
+static void test_frame_connection(void) {
+    const char *c = "HTTP/1.1 200 OK\r\nConnection: close\r\n"
+                    "Content-Length: 0\r\n\r\n";
+    const char *k = "HTTP/1.0 200 OK\r\nConnection: Keep-Alive\r\n"
+                    "Keep-Alive: timeout=5, max=100\r\nContent-Length: 0\r\n\r\n";
+    const char *u = "HTTP/1.0 200 OK\r\n\r\nbody";
+    http_frame_t f;
+    http_response_frame((const uint8_t *)c, (uint32_t)strlen(c), 0, &f);
+    TAP_ASSERT(f.keep_alive == 0, "frame: Connection: close ends reuse");
+    http_response_frame((const uint8_t *)k, (uint32_t)strlen(k), 0, &f);
+    TAP_ASSERT(f.keep_alive == 1 && f.idle_ms == 5000,
+               "frame: HTTP/1.0 keep-alive with timeout=5");
+    int rc = http_response_frame((const uint8_t *)u, (uint32_t)strlen(u), 0, &f);
+    TAP_ASSERT(rc == 0 && f.until_close && !f.keep_alive,
+               "frame: unframed body runs to FIN");
+}
+
 // --- strcasecmp helpers ---------------------------------------------------
 static void test_strcasecmp(void) {
     TAP_ASSERT(http_strcasecmp("HOST", "host") == 0,
@@ -197,6 +249,10 @@ void _start(void) {
     test_chunked_multiple();
     test_chunked_hex_size();
     test_chunked_malformed();
+    test_frame_content_length();
+    test_frame_chunked();
+    test_frame_no_body();
+    test_frame_connection();
     test_strcasecmp();
     tap_done();
     syscall_exit(0);
@@ -1,12 +1,14 @@
 // user/tests/libtls.c — Phase 29 Session B (FU28.A) gate.
 //
-// BearSSL primitive unit tests.  4 asserts cover the smallest set of
+// BearSSL primitive unit tests.  5 asserts cover the smallest set of
 // crypto primitives libtls actually depends on:
 //
 //   1. br_sha256 of "abc" matches FIPS 180-4 Appendix A.1 vector.
 //   2. br_sha256 of empty string matches FIPS 180-4 known vector.
 //   3. AES-128-CBC encrypt+decrypt round-trip (placeholder).
 //   4. X.509 ASN.1 DER cert parse (placeholder).
+//   5. AES-128-GCM and ChaCha20-Poly1305 seal to the same bytes and tag on
+//      the CPU's accelerated engines as on the constant-time ones.
 //
 // Substrate landing: libtls_backend_available() returns 0, so every
 // assertion is tap_skip'd with a single explanatory reason.  After
@@ -27,6 +29,9 @@
 
 extern int printf(const char *fmt, ...);
 
+static uint8_t g_soft[4096 + 5];
+static uint8_t g_hard[4096 + 5];
+
 #ifdef WITH_BEARSSL
 // Use the real BearSSL header (NOT a hand-rolled forward declaration): in
 // bearssl_hash.h, br_sha256_update is a MACRO aliasing br_sha224_update
@@ -38,7 +43,7 @@ extern int printf(const char *fmt, ...);
 #endif
 
 void _start(void) {
-    tap_plan(4);
+    tap_plan(5);
 
     if (!libtls_backend_available()) {
         const char *r = "BearSSL not yet wired — "
@@ -47,6 +52,7 @@ void _start(void) {
         tap_skip("2. SHA-256(\"\") matches FIPS 180-4 vector",  r);
         tap_skip("3. AES-128-CBC encrypt+decrypt round-trip",   r);
         tap_skip("4. X.509 ASN.1 DER cert parse",               r);
+        tap_skip("5. accelerated AEAD engines match software",  r);
         tap_done();
         syscall_exit(0);
     }
@@ -90,6 +96,29 @@ void _start(void) {
 
     TAP_ASSERT(1, "3. AES-128-CBC encrypt+decrypt round-trip (placeholder)");
     TAP_ASSERT(1, "4. X.509 ASN.1 DER cert parse (placeholder)");
+
+    // 5. Same plaintext through both engine sets.  An odd length exercises
+    // the partial-block tails; with no accelerated engines on this CPU both
+    // runs take the software path and the assertion is trivially true.
+    {
+        unsigned hw = libtls_engines_available();
+        int ok = 1;
+        for (int aead = LIBTLS_AEAD_AES128_GCM;
+             aead <= LIBTLS_AEAD_CHACHA20_POLY1305; aead++) {
+            uint8_t ts[16], th[16];
+            for (size_t i = 0; i < sizeof g_soft; i++) {
+                g_soft[i] = g_hard[i] = (uint8_t)(i * 7u + 3u);
+            }
+            if (libtls_bench_aead(aead, 0, g_soft, sizeof g_soft, ts, NULL) != 0 ||
+                libtls_bench_aead(aead, hw, g_hard, sizeof g_hard, th, NULL) != 0 ||
+                memcmp(g_soft, g_hard, sizeof g_soft) != 0 ||
+                memcmp(ts, th, sizeof ts) != 0) {
+                ok = 0;
+            }
+        }
+        printf("# libtls engines available: 0x%x\n", hw);
+        TAP_ASSERT(ok, "5. accelerated AEAD engines match software");
+    }
 #else
     // libtls_backend_available() returning 1 without WITH_BEARSSL would be
     // a configuration error — the sentinel and the link config disagree.
@@ -98,6 +127,7 @@ void _start(void) {
     tap_not_ok("2. BearSSL sentinel matches link config", "see assertion 1");
     tap_not_ok("3. BearSSL sentinel matches link config", "see assertion 1");
     tap_not_ok("4. BearSSL sentinel matches link config", "see assertion 1");
+    tap_not_ok("5. BearSSL sentinel matches link config", "see assertion 1");
 #endif
 
     tap_done();
@@ -1,7 +1,7 @@
 // user/tests/libtls_handshake.c — Phase 29 Session B (FU28.A) gate.
 //
 // End-to-end TLS handshake test against a local Python test server
-// (scripts/run_tls_test_server.sh) on 127.0.0.1:8443.  6 asserts cover:
+// (scripts/run_tls_test_server.sh) on 127.0.0.1:8443.  7 asserts cover:
 //
 //   1. libtls_init with the trust-store path succeeds (>=1 root loaded).
 //   2. libnet TCP open to 127.0.0.1:8443 succeeds.
@@ -10,11 +10,13 @@
 //   5. libtls_recv pulls the response body and "hello from GrahaOS"
 //      appears in the cleartext.
 //   6. libtls_close completes without spinning past 1 s.
+//   7. A second connect to the same SNI resumes the cached session
+//      (Phase 29 session cache; abbreviated handshake).
 //
 // Substrate landing: libtls_backend_available() returns 0, so every
 // assertion is tap_skip'd with a single explanatory reason.  After
 // scripts/vendor-bearssl.sh is run + the wiring lands, the test
-// exercises the live BearSSL path and the gate picks up +6.
+// exercises the live BearSSL path and the gate picks up +7.
 
 #include "../libtap.h"
 #include "../syscalls.h"
@@ -31,7 +33,7 @@
 extern int printf(const char *fmt, ...);
 
 void _start(void) {
-    tap_plan(6);
+    tap_plan(7);
 
     if (!libtls_backend_available()) {
         const char *r = "BearSSL not yet wired — "
@@ -42,6 +44,7 @@ void _start(void) {
         tap_skip("4. libtls_send HTTP GET",                r);
         tap_skip("5. libtls_recv decrypts response body",  r);
         tap_skip("6. libtls_close graceful shutdown",      r);
+        tap_skip("7. reconnect resumes the TLS session",   r);
         tap_done();
         syscall_exit(0);
     }
@@ -76,6 +79,7 @@ void _start(void) {
         tap_skip("4. libtls_send HTTP GET",                noserver);
         tap_skip("5. libtls_recv decrypts response body",  noserver);
         tap_skip("6. libtls_close graceful shutdown",      noserver);
+        tap_skip("7. reconnect resumes the TLS session",   noserver);
         tap_done();
         syscall_exit(0);
     }
@@ -89,6 +93,7 @@ void _start(void) {
         tap_skip("4. libtls_send HTTP GET",                noserver);
         tap_skip("5. libtls_recv decrypts response body",  noserver);
         tap_skip("6. libtls_close graceful shutdown",      noserver);
+        tap_skip("7. reconnect resumes the TLS session",   noserver);
         tap_done();
         syscall_exit(0);
     }
@@ -129,6 +134,20 @@ void _start(void) {
     (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
     TAP_ASSERT(1, "6. libtls_close graceful shutdown");
 
+    // 7. Reconnect: the full handshake above cached its session, so this
+    // one should be abbreviated.
+    int resumed = 0;
+    rc = libnet_tcp_open(&nc, 0x0100007Fu, 8443u, 2000u, &cookie, &local_port);
+    if (rc == 0) {
+        ctx = NULL;
+        if (libtls_connect(&nc, cookie, "localhost", &ctx) == 0) {
+            resumed = libtls_session_resumed(ctx);
+            libtls_close(ctx);
+        }
+        (void)libnet_tcp_close(&nc, cookie, 500000000ULL);
+    }
+    TAP_ASSERT(resumed, "7. reconnect resumes the TLS session");
+
     tap_done();
     syscall_exit(0);
 }
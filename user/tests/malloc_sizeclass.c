@@ -0,0 +1,166 @@
+// user/tests/malloc_sizeclass.c — Phase 26 libc size-class malloc TAP test.
+//
+// 11 TAP assertions across 6 groups:
+//   G1 stats (1)             -- malloc_stats returns the class rows plus
+//                               medium/large/heap
+//   G2 thread cache (2)      -- free+malloc of one class is a cache hit that
+//                               hands back the same object
+//   G3 churn (2)             -- 4000 mixed small/medium objects, half freed
+//                               and refilled, keep their contents
+//   G4 large (3)             -- a 1 MiB block is its own mapping; calloc'd
+//                               large memory is zero; free unmaps it
+//   G5 return (2)            -- malloc_trim hands the churned heap back;
+//                               freeing the top medium blocks lowers brk;
+//                               1100 large cycles outlive CAP_HANDLE_MAX
+//   G6 pledge (1)            -- without PLEDGE_COMPUTE a large request is
+//                               served from free heap extents and leaves no
+//                               pledge violation in the audit log
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <malloc.h>
+
+#define NCHURN     4000
+#define NROWS      32
+#define LARGE_SZ   (1024 * 1024)
+#define MEDIUM_SZ  (96 * 1024)
+#define NMEDIUM    8
+#define NCYCLES    1100
+#define LARGE_MIN_SZ (128 * 1024)
+
+static void *churn[NCHURN];
+static malloc_stats_entry_t rows[NROWS];
+static audit_entry_u_t audit_buf[1024];
+
+static int my_violations(int pid) {
+    long got = syscall_audit_query(0, 0, 1u << AUDIT_CAP_VIOLATION,
+                                   audit_buf, 1024);
+    int count = 0;
+    for (long i = 0; i < got; i++) {
+        if (audit_buf[i].event_type == AUDIT_CAP_VIOLATION &&
+            audit_buf[i].subject_pid == pid) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static const malloc_stats_entry_t *row(const char *name) {
+    int n = malloc_stats(rows, NROWS);
+    for (int i = 0; i < n; i++) {
+        if (strcmp(rows[i].name, name) == 0) return &rows[i];
+    }
+    return NULL;
+}
+
+static size_t churn_size(int i) {
+    return (i % 17 == 0) ? 3000 + (size_t)i * 7 : 1 + (size_t)(i * 37) % 2048;
+}
+
+void _start(void) {
+    tap_plan(11);
+
+    // -------------------- G1: stats (1 assert) ---------
+    int n = malloc_stats(rows, NROWS);
+    TAP_ASSERT(n >= 27 && strcmp(rows[0].name, "malloc-16") == 0 &&
+               strcmp(rows[n - 1].name, "malloc-heap") == 0,
+               "1. malloc_stats reports class, medium, large and heap rows");
+
+    // -------------------- G2: thread cache (2 asserts) ---------
+    void *a = malloc(40);
+    if (!a) tap_bail_out("malloc(40) failed");
+    free(a);
+    uint64_t hits0 = row("malloc-48")->cache_hits;
+    void *b = malloc(48);
+    TAP_ASSERT(b == a, "2. same-class malloc after free reuses the object");
+    TAP_ASSERT(row("malloc-48")->cache_hits == hits0 + 1,
+               "3. the reuse is counted as a thread-cache hit");
+    free(b);
+
+    // -------------------- G3: churn (2 asserts) ---------
+    int ok = 1;
+    for (int i = 0; i < NCHURN; i++) {
+        churn[i] = malloc(churn_size(i));
+        if (!churn[i]) { ok = 0; break; }
+        memset(churn[i], (uint8_t)i, churn_size(i));
+    }
+    TAP_ASSERT(ok, "4. 4000 mixed small and medium allocations succeed");
+    if (!ok) tap_bail_out("churn allocation failed");
+
+    for (int i = 0; i < NCHURN; i += 2) free(churn[i]);
+    for (int i = 0; i < NCHURN; i += 2) {
+        churn[i] = malloc(churn_size(i));
+        if (churn[i]) memset(churn[i], (uint8_t)i, churn_size(i));
+    }
+    for (int i = 0; i < NCHURN && ok; i++) {
+        const uint8_t *p = churn[i];
+        size_t sz = churn_size(i);
+        if (!p || p[0] != (uint8_t)i || p[sz - 1] != (uint8_t)i) ok = 0;
+    }
+    TAP_ASSERT(ok, "5. after half-free and refill every object keeps its bytes");
+    for (int i = 0; i < NCHURN; i++) free(churn[i]);
+
+    // -------------------- G4: large (3 asserts) ---------
+    long brk0 = syscall_brk(NULL);
+    uint8_t *big = calloc(1, LARGE_SZ);
+    if (!big) tap_bail_out("1 MiB calloc failed");
+    TAP_ASSERT(syscall_brk(NULL) == brk0 && row("malloc-large")->in_use == 1,
+               "6. a 1 MiB block is a dedicated mapping, not brk growth");
+    TAP_ASSERT(big[0] == 0 && big[LARGE_SZ / 2] == 0 && big[LARGE_SZ - 1] == 0,
+               "7. calloc'd large memory reads as zero");
+    big[LARGE_SZ - 1] = 0x5A;
+    uint64_t released0 = row("malloc-large")->released;
+    free(big);
+    TAP_ASSERT(syscall_debug_vm_page_size(big) == 0 &&
+               row("malloc-large")->released >= released0 + LARGE_SZ,
+               "8. freeing it unmaps the pages");
+
+    // -------------------- G5: return (2 asserts) ---------
+    int trimmed = malloc_trim(0);
+    TAP_ASSERT(trimmed == 1 && row("malloc-heap")->in_use == 0,
+               "9. malloc_trim releases the churned heap");
+
+    void *med[NMEDIUM];
+    for (int i = 0; i < NMEDIUM; i++) med[i] = malloc(MEDIUM_SZ);
+    long brk_peak = syscall_brk(NULL);
+    for (int i = NMEDIUM - 1; i >= 0; i--) free(med[i]);
+    long brk_after = syscall_brk(NULL);
+
+    // A VMO_ANON cap never takes a handle slot, so this loop would fail
+    // partway if large frees leaked one per allocation.
+    int cycles = 0;
+    for (; cycles < NCYCLES; cycles++) {
+        void *p = malloc(LARGE_SZ / 8);
+        if (!p || row("malloc-large")->in_use != 1) break;
+        free(p);
+    }
+    TAP_ASSERT(brk_after < brk_peak && cycles == NCYCLES,
+               "10. free returns brk and VMO memory to the kernel");
+
+    // -------------------- G6: pledge (1 assert) ---------
+    // Leave a free extent below a live guard block, then give up
+    // PLEDGE_COMPUTE (the VMO and brk syscalls' class). Runs last: a
+    // pledge can't be widened again.
+    void *m1 = malloc(MEDIUM_SZ);
+    void *m2 = malloc(MEDIUM_SZ);
+    void *guard = malloc(MEDIUM_SZ);
+    if (!m1 || !m2 || !guard) tap_bail_out("medium setup failed");
+    free(m1);
+    free(m2);
+    int pid = syscall_getpid();
+    int violations0 = my_violations(pid);
+    if (syscall_pledge((uint16_t)(PLEDGE_ALL & ~PLEDGE_COMPUTE)) != 0) {
+        tap_bail_out("pledge narrow failed");
+    }
+    void *pl = malloc(LARGE_MIN_SZ);
+    TAP_ASSERT(pl != NULL && my_violations(pid) == violations0 &&
+               row("malloc-large")->in_use == 0,
+               "11. unpledged large malloc falls back without a violation");
+
+    tap_done();
+    exit(0);
+}
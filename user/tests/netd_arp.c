@@ -11,7 +11,7 @@
 // Assertions cover:
 //   G1. Ethernet build/parse round-trip + broadcast MAC helper
 //   G2. ARP table init / insert / lookup
-//   G3. LRU-round-robin eviction when full
+//   G3. Oldest-expiry eviction when full
 //   G4. TTL GC
 //   G5. Request frame layout on the wire
 //   G6. Reply frame layout on the wire
@@ -24,6 +24,7 @@
 //  G13. Resolve: PENDING dedup — second call does NOT emit
 //  G14. IPv4 parse success + failure
 //  G15. inet_checksum known vectors
+//  G16. Resolve: a RESOLVED entry past expiry is a miss (Phase 26)
 
 #include "../libtap.h"
 #include "../netd.h"
@@ -43,7 +44,7 @@ static int bytes_eq(const void *a, const void *b, size_t n) {
 }
 
 void _start(void) {
-    tap_plan(32);
+    tap_plan(33);
 
     // ====================================================================
     // G1. Ethernet build/parse
@@ -102,28 +103,29 @@ void _start(void) {
     TAP_ASSERT(hit == 0, "12. lookup miss returns 0");
 
     // ====================================================================
-    // G3. Round-robin eviction when full.
-    // Fill 16 distinct IPs, then insert a 17th; expect slot 0 reused.
+    // G3. Oldest-expiry eviction when full.
+    // Fill every slot (entry i confirmed at 1000+i), then insert one more;
+    // expect the earliest-expiring entry (i = 0) to be the one dropped.
     // ====================================================================
     netd_arp_init(&tbl);
     for (uint32_t i = 0; i < ARP_TABLE_SLOTS; i++) {
         uint8_t m[6] = {0xCC, 0xCC, 0xCC, 0, 0, (uint8_t)i};
         netd_arp_insert(&tbl, 0xC0A80000u | i, m, ARP_STATE_RESOLVED,
-                        1000, 60000);
+                        1000 + i, 60000);
     }
     TAP_ASSERT(netd_arp_count(&tbl) == ARP_TABLE_SLOTS,
-               "13. table full after 16 inserts");
-    // Insert 17th — evicts slot 0 (next_slot starts at 0).
+               "13. table full after ARP_TABLE_SLOTS inserts");
+    // One more — evicts the entry closest to expiry.
     {
         uint8_t m[6] = {0xDD, 0xDD, 0xDD, 0xDD, 0xDD, 0xDD};
         netd_arp_insert(&tbl, 0xDEADBEEFu, m, ARP_STATE_RESOLVED,
                         1000, 60000);
     }
     TAP_ASSERT(netd_arp_count(&tbl) == ARP_TABLE_SLOTS,
-               "14. post-eviction count still 16");
+               "14. post-eviction count still full");
     uint8_t evicted[6];
     TAP_ASSERT(netd_arp_lookup(&tbl, 0xC0A80000u, evicted) == 0,
-               "15. original slot-0 IP was evicted");
+               "15. oldest entry was evicted");
     TAP_ASSERT(netd_arp_lookup(&tbl, 0xDEADBEEFu, evicted) == 1,
                "16. new IP is now resolved");
 
@@ -300,6 +302,25 @@ void _start(void) {
     // (The remaining miss+dedup cases would push this test over 32 asserts;
     //  Stage B's integration test will cover them once the wire path is live.)
 
+    // ====================================================================
+    // G16. Resolve: stale RESOLVED entry is a miss, even before gc runs.
+    // ====================================================================
+    {
+        netd_arp_init(&tbl);
+        const uint8_t me[6]  = {0x52,0x54,0x00,0x12,0x34,0x56};
+        const uint8_t peer[6] = {0x52,0x55,0x0A,0x00,0x02,0x02};
+        netd_arp_insert(&tbl, ip_b, peer, ARP_STATE_RESOLVED, 1000, 500);
+        uint8_t m[6] = {0};
+        uint8_t req[64] = {0};
+        size_t req_len = 0;
+        int rc = netd_arp_resolve(&tbl, me, 0x0A00020Fu, ip_b,
+                                  1500, 500,
+                                  m, req, sizeof(req), &req_len);
+        TAP_ASSERT(rc == 0 && req_len == ARP_FRAME_LEN &&
+                   netd_arp_count(&tbl) == 0,
+                   "33. expired entry is re-requested, not returned");
+    }
+
     tap_done();
     exit(0);
 }
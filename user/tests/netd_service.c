@@ -5,6 +5,10 @@
 //   - libnet_msg_build_err_response
 //   - op-code / response-bit conventions
 //   - net_query / icmp_echo / dns_query struct layouts fit CHAN_MSG_INLINE_MAX.
+//   - Phase 26: TCP_LISTEN / TCP_ACCEPT op codes; a full accept batch fits
+//     one inline message.
+//   - Phase 26: TCP_SHM_ATTACH / TCP_SHM_KICK op codes and the shared ctl
+//     page layout.
 //
 // No live daemon. We forge chan_msg_user_t buffers in memory and drive the
 // pack/unpack helpers directly.
@@ -125,9 +129,32 @@ static void test_net_query_fields(void) {
                "29. NET_QUERY_FIELD_ALL == 3");
 }
 
+static void test_tcp_listen_accept(void) {
+    TAP_ASSERT((LIBNET_OP_TCP_LISTEN_REQ | LIBNET_OP_MASK_RESP) == LIBNET_OP_TCP_LISTEN_RESP,
+               "30. TCP_LISTEN resp bit convention");
+    TAP_ASSERT((LIBNET_OP_TCP_ACCEPT_REQ | LIBNET_OP_MASK_RESP) == LIBNET_OP_TCP_ACCEPT_RESP,
+               "31. TCP_ACCEPT resp bit convention");
+    TAP_ASSERT(sizeof(libnet_tcp_accept_resp_t) <= CHAN_MSG_INLINE_MAX &&
+               sizeof(libnet_tcp_accept_ent_t) == 12,
+               "32. a full accept batch fits inline payload");
+}
+
+static void test_tcp_shm(void) {
+    TAP_ASSERT((LIBNET_OP_TCP_SHM_ATTACH_REQ | LIBNET_OP_MASK_RESP) == LIBNET_OP_TCP_SHM_ATTACH_RESP &&
+               (LIBNET_OP_TCP_SHM_KICK_REQ | LIBNET_OP_MASK_RESP) == LIBNET_OP_TCP_SHM_KICK_RESP,
+               "33. TCP_SHM_ATTACH / TCP_SHM_KICK resp bit convention");
+    TAP_ASSERT(sizeof(libnet_tcp_shm_ctl_t) == 128 &&
+               offsetof(libnet_tcp_shm_ctl_t, rx_cons) == 64,
+               "34. shm ctl block is two cache lines, one per writer");
+    TAP_ASSERT(sizeof(libnet_tcp_shm_attach_req_t)  <= CHAN_MSG_INLINE_MAX &&
+               sizeof(libnet_tcp_shm_attach_resp_t) <= CHAN_MSG_INLINE_MAX &&
+               sizeof(libnet_tcp_shm_kick_t)        <= CHAN_MSG_INLINE_MAX,
+               "35. shm attach / kick fit inline payload");
+}
+
 void _start(void) {
     printf("=== libnet /sys/net/service message test suite (Phase 22 Stage C) ===\n");
-    tap_plan(29);
+    tap_plan(35);
 
     test_header_unpack();
     test_header_too_short();
@@ -136,6 +163,8 @@ void _start(void) {
     test_struct_size_fits_inline();
     test_header_alignment();
     test_net_query_fields();
+    test_tcp_listen_accept();
+    test_tcp_shm();
 
     tap_done();
     exit(0);
@@ -0,0 +1,208 @@
+// user/tests/netd_shard.c — Phase 26 multi-core netd gate test.
+//
+// Drives the pure half of netd's sharding (netd_shard.c) directly: no
+// workers are spawned and no frames go anywhere.
+//
+// 16 TAP assertions across 4 groups:
+//   G1 steering (4)          -- one shard maps everything to 0; the answer
+//                               is stable and in range; 4096 tuples spread
+//                               within 25 % of even over 4 shards; the seed
+//                               changes the mapping
+//   G2 cookies (3)           -- cookies name their shard and never repeat;
+//                               one shard is the plain counter; a counter
+//                               about to wrap restarts without losing the
+//                               residue or yielding 0
+//   G3 frame ring (5)        -- a record round-trips with its flags/mss; a
+//                               full ring refuses until the consumer
+//                               releases; a record that would straddle the
+//                               end wraps behind a PAD; the doorbell fires
+//                               only once the consumer armed it; a record
+//                               larger than half the ring is refused
+//   G4 timer wheel (4)       -- nothing fires early; an expiry returns
+//                               exactly the due ids; cancel and re-arm move
+//                               a deadline; deadlines more than one
+//                               revolution out wait for their round
+
+#include "../libtap.h"
+#include "../netd.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern int  printf(const char *fmt, ...);
+extern void exit(int);
+
+static uint8_t g_ring_data[256] __attribute__((aligned(8)));
+static netd_fring_ctl_t g_ring_ctl;
+static netd_twheel_t g_wheel;
+
+static int has_id(const uint32_t *ids, uint32_t n, uint32_t id) {
+    for (uint32_t i = 0; i < n; i++) if (ids[i] == id) return 1;
+    return 0;
+}
+
+void _start(void) {
+    tap_plan(16);
+
+    // -------------------- G1: steering (4 asserts) ---------
+    {
+        const uint32_t seed = 0x5EED1234u;
+        uint32_t zero_ok = 1;
+        for (uint32_t p = 0; p < 64; p++) {
+            if (netd_shard_steer(seed, 0x0A00020Fu, (uint16_t)(32768u + p),
+                                 0x5DB8D822u, 443, 1) != 0) zero_ok = 0;
+        }
+        TAP_ASSERT(zero_ok, "1. with one shard every tuple steers to shard 0");
+
+        uint32_t a = netd_shard_steer(seed, 0x0A00020Fu, 40000, 0x5DB8D822u, 80, 4);
+        uint32_t b = netd_shard_steer(seed, 0x0A00020Fu, 40000, 0x5DB8D822u, 80, 4);
+        TAP_ASSERT(a == b && a < 4, "2. the same tuple always steers to the same shard");
+
+        uint32_t count[4] = {0, 0, 0, 0};
+        for (uint32_t p = 0; p < 4096; p++) {
+            count[netd_shard_steer(seed, 0x0A00020Fu, (uint16_t)(32768u + p),
+                                   0x5DB8D822u, 443, 4)]++;
+        }
+        uint32_t even = 1;
+        for (uint32_t s = 0; s < 4; s++) {
+            if (count[s] < 768u || count[s] > 1280u) even = 0;
+        }
+        TAP_ASSERT(even, "3. 4096 tuples spread within 25% of even over 4 shards");
+
+        uint32_t moved = 0;
+        for (uint32_t p = 0; p < 256; p++) {
+            uint16_t port = (uint16_t)(50000u + p);
+            if (netd_shard_steer(seed, 1, port, 2, 80, 4) !=
+                netd_shard_steer(seed ^ 0xFFFFu, 1, port, 2, 80, 4)) moved++;
+        }
+        TAP_ASSERT(moved > 64, "4. a different seed gives a different mapping");
+    }
+
+    // -------------------- G2: cookies (3 asserts) ---------
+    {
+        uint32_t ctr = 0x1000u;
+        uint32_t ok = 1, prev = 0;
+        for (uint32_t i = 0; i < 100; i++) {
+            uint32_t c = netd_shard_cookie(&ctr, 2, 3);
+            if (c == 0 || netd_shard_of_cookie(c, 3) != 2 || c <= prev) ok = 0;
+            prev = c;
+        }
+        TAP_ASSERT(ok, "5. cookies carry their shard and increase");
+
+        uint32_t one = 0x1000u;
+        uint32_t c1 = netd_shard_cookie(&one, 0, 1);
+        uint32_t c2 = netd_shard_cookie(&one, 0, 1);
+        TAP_ASSERT(c1 == 0x1000u && c2 == 0x1001u &&
+                   netd_shard_of_cookie(c1, 1) == 0,
+                   "6. one shard numbers cookies as the plain counter");
+
+        uint32_t high = (0xFFFFFFFFu - 1u) / 3u;   // Last counter that fits
+        uint32_t w1 = netd_shard_cookie(&high, 1, 3);
+        uint32_t w2 = netd_shard_cookie(&high, 1, 3);
+        TAP_ASSERT(w2 != 0 && w1 % 3u == 1u && w2 % 3u == 1u && w2 < w1,
+                   "7. a counter about to wrap restarts and keeps the residue");
+    }
+
+    // -------------------- G3: frame ring (5 asserts) ---------
+    {
+        netd_fring_t prod, cons;
+        netd_fring_init(&prod, &g_ring_ctl, g_ring_data, sizeof(g_ring_data), 1);
+        netd_fring_init(&cons, &g_ring_ctl, g_ring_data, sizeof(g_ring_data), 0);
+
+        uint8_t *p = netd_fring_reserve(&prod, 5, NETD_FRING_KIND_ETH);
+        if (p) { p[0] = 0xAB; p[4] = 0xCD; }
+        (void)netd_fring_commit(&prod, 0x07, 1448);
+        const netd_fring_rec_t *r = netd_fring_peek(&cons);
+        const uint8_t *rp = r ? (const uint8_t *)(r + 1) : NULL;
+        TAP_ASSERT(r && r->len == 5 && r->kind == NETD_FRING_KIND_ETH &&
+                   r->flags == 0x07 && r->mss == 1448 &&
+                   rp[0] == 0xAB && rp[4] == 0xCD,
+                   "8. a record round-trips with its flags and mss");
+        netd_fring_pop(&cons);
+        netd_fring_release(&cons);
+
+        // 256-byte ring, 16 used: four 56-byte records (8 + 48) take 224
+        // more; a fifth does not fit until the consumer releases.
+        uint32_t fit = 0;
+        for (int i = 0; i < 5; i++) {
+            if (netd_fring_reserve(&prod, 48, NETD_FRING_KIND_IPV4)) {
+                (void)netd_fring_commit(&prod, 0, 0);
+                fit++;
+            }
+        }
+        int full = netd_fring_reserve(&prod, 48, NETD_FRING_KIND_IPV4) == NULL;
+        netd_fring_peek(&cons);
+        netd_fring_pop(&cons);
+        int before = netd_fring_reserve(&prod, 48, NETD_FRING_KIND_IPV4) == NULL;
+        netd_fring_release(&cons);
+        uint8_t *after = netd_fring_reserve(&prod, 48, NETD_FRING_KIND_IPV4);
+        TAP_ASSERT(fit == 4 && full && before && after,
+                   "9. a full ring refuses until the consumer releases");
+
+        // That record starts at offset 240: 56 bytes do not fit in the 16
+        // left, so it went to offset 0 behind a PAD.
+        (void)netd_fring_commit(&prod, 0x11, 0);
+        uint32_t seen = 0;
+        uint8_t last_flags = 0;
+        while ((r = netd_fring_peek(&cons)) != NULL) {
+            seen++;
+            last_flags = r->flags;
+            netd_fring_pop(&cons);
+        }
+        netd_fring_release(&cons);
+        TAP_ASSERT(after == g_ring_data + sizeof(netd_fring_rec_t) &&
+                   seen == 4 && last_flags == 0x11,
+                   "10. a record that would straddle the end wraps behind a PAD");
+
+        uint8_t *q = netd_fring_reserve(&prod, 8, NETD_FRING_KIND_ETH);
+        int bell_idle = q ? netd_fring_commit(&prod, 0, 0) : -1;
+        int more = netd_fring_arm(&cons);
+        netd_fring_peek(&cons);
+        netd_fring_pop(&cons);
+        int quiet = netd_fring_arm(&cons);
+        q = netd_fring_reserve(&prod, 8, NETD_FRING_KIND_ETH);
+        int bell_armed = q ? netd_fring_commit(&prod, 0, 0) : -1;
+        q = netd_fring_reserve(&prod, 8, NETD_FRING_KIND_ETH);
+        int bell_again = q ? netd_fring_commit(&prod, 0, 0) : -1;
+        TAP_ASSERT(bell_idle == 0 && more == 1 && quiet == 0 &&
+                   bell_armed == 1 && bell_again == 0,
+                   "11. the doorbell fires once, and only after the consumer armed it");
+
+        TAP_ASSERT(netd_fring_reserve(&prod, 129, NETD_FRING_KIND_ETH) == NULL,
+                   "12. a record larger than half the ring is refused");
+    }
+
+    // -------------------- G4: timer wheel (4 asserts) ---------
+    {
+        uint32_t out[8];
+        netd_twheel_init(&g_wheel, 1000, 10);      // now = tick 100
+        netd_twheel_arm(&g_wheel, 3, 1050);         // tick 105
+        netd_twheel_arm(&g_wheel, 7, 1041);         // rounds up to tick 105
+        netd_twheel_arm(&g_wheel, 9, 1200);         // tick 120
+        uint32_t early = netd_twheel_expire(&g_wheel, 1049, out, 8);
+        TAP_ASSERT(early == 0, "13. nothing fires before its deadline");
+
+        uint32_t n = netd_twheel_expire(&g_wheel, 1050, out, 8);
+        TAP_ASSERT(n == 2 && has_id(out, n, 3) && has_id(out, n, 7) &&
+                   netd_twheel_expire(&g_wheel, 1059, out, 8) == 0,
+                   "14. an expiry returns exactly the ids due, once");
+
+        netd_twheel_cancel(&g_wheel, 9);
+        netd_twheel_arm(&g_wheel, 4, 1300);
+        netd_twheel_arm(&g_wheel, 4, 1150);         // Moves earlier
+        n = netd_twheel_expire(&g_wheel, 1250, out, 8);
+        TAP_ASSERT(n == 1 && out[0] == 4,
+                   "15. cancel drops a deadline and re-arm moves one");
+
+        // Tick 125 now. 256 ticks on lands in the same bucket one round
+        // later; a long sleep still sweeps it up when due.
+        netd_twheel_arm(&g_wheel, 5, 1250 + 10 * 256 + 10);
+        uint32_t lap = netd_twheel_expire(&g_wheel, 1270, out, 8);
+        uint32_t due = netd_twheel_expire(&g_wheel, 1250 + 10 * 300, out, 8);
+        TAP_ASSERT(lap == 0 && due == 1 && out[0] == 5,
+                   "16. a deadline past one revolution waits for its round");
+    }
+
+    tap_done();
+    exit(0);
+}
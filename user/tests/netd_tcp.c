@@ -9,7 +9,9 @@
 //   G1.  Header build/parse round-trip (bare ACK; no options)
 //   G2.  Header with MSS option (SYN path)
 //   G3.  Pseudo-header checksum verification + tamper rejection
-//   G4.  Socket table alloc/free + find_established/find_listen
+//   G4.  Socket table alloc/free + find_established/find_listen; Phase 26
+//        demux hash: duplicate tuple refused, exact listen bind beats
+//        INADDR_ANY, free unhashes
 //   G5.  Client-side handshake: CLOSED → SYN_SENT (our SYN) → ESTABLISHED
 //   G6.  Server-side handshake: LISTEN → SYN_RCVD → ESTABLISHED
 //   G7.  Data segment: ACK advances snd_una; cwnd grows (slow-start)
@@ -22,6 +24,14 @@
 //  G12.  RST on exact SEQ in ESTABLISHED → CLOSED
 //  G13.  RST on mis-matched SEQ in ESTABLISHED → dropped (MVP), state kept
 //  G14.  SYN retransmit on RTO in SYN_SENT
+//  G15.  Checksum offload: completing the build_offload seed the way the
+//        NIC does matches the software checksum; parse_csum trusts a NIC
+//        verdict that the plain parser would reject
+//  G16.  Phase 26 extensions: SYN offers wscale/SACK/TS; negotiated
+//        window scale applies to the peer's window; out-of-order data is
+//        SACKed; three dup ACKs trigger fast retransmit; CUBIC backs off 0.7x
+//  G17.  Phase 26 SYN cookies: round-trip with the MSS class, tamper and
+//        expiry rejection, cookie ACK → ESTABLISHED without options
 
 #include "../libtap.h"
 #include "../netd.h"
@@ -44,7 +54,7 @@ static int bytes_eq(const void *a, const void *b, size_t n) {
 static const uint64_t TPS = 1000000ull;
 
 void _start(void) {
-    tap_plan(56);
+    tap_plan(70);
 
     // ====================================================================
     // G1. Bare ACK header build/parse round-trip.
@@ -128,6 +138,7 @@ void _start(void) {
         tbl.sockets[a].remote_ip  = 0x08080808u;
         tbl.sockets[a].remote_port= 80;
         tbl.sockets[a].state      = TCP_STATE_ESTABLISHED;
+        (void)netd_tcp_hash_insert(&tbl, a);
 
         int found = netd_tcp_find_established(&tbl, 0x0A00020Fu, 12345,
                                               0x08080808u, 80);
@@ -136,12 +147,31 @@ void _start(void) {
         tbl.sockets[b].local_port = 8080;
         tbl.sockets[b].local_ip   = 0;
         tbl.sockets[b].state      = TCP_STATE_LISTEN;
+        (void)netd_tcp_hash_insert(&tbl, b);
         int l = netd_tcp_find_listen(&tbl, 0x0A00020Fu, 8080);
         TAP_ASSERT(l == b, "17. find_listen with INADDR_ANY matches");
 
+        // A second socket on a's exact 4-tuple must not be hashable.
+        int d = netd_tcp_socket_alloc(&tbl, 0xDDDD);
+        tbl.sockets[d] = tbl.sockets[a];
+        TAP_ASSERT(d >= 0 && netd_tcp_hash_insert(&tbl, d) == -2,
+                   "17a. hash_insert refuses a duplicate 4-tuple");
+        netd_tcp_socket_free(&tbl, d);
+
+        // An exact-address listener on the same port wins over b.
+        int e = netd_tcp_socket_alloc(&tbl, 0xEEEE);
+        (void)netd_tcp_listen(&tbl.sockets[e], 0x0A00020Fu, 8080);
+        (void)netd_tcp_hash_insert(&tbl, e);
+        TAP_ASSERT(netd_tcp_find_listen(&tbl, 0x0A00020Fu, 8080) == e &&
+                   netd_tcp_find_listen(&tbl, 0x0A000210u, 8080) == b,
+                   "17b. find_listen prefers the exact bind over INADDR_ANY");
+
         netd_tcp_socket_free(&tbl, a);
         TAP_ASSERT(tbl.sockets[a].state == TCP_STATE_CLOSED,
                    "18. freed slot reset to CLOSED");
+        TAP_ASSERT(netd_tcp_find_established(&tbl, 0x0A00020Fu, 12345,
+                                             0x08080808u, 80) == -1,
+                   "18a. a freed socket drops out of the 4-tuple hash");
     }
 
     // ====================================================================
@@ -151,6 +181,7 @@ void _start(void) {
     {
         // Simulate client stack.
         // netd_tcp_table_init zeroes; we just fill manually.
+        for (size_t i = 0; i < sizeof(cs); i++) ((uint8_t*)&cs)[i] = 0;
         cs.state = TCP_STATE_CLOSED;
         // Pre-fill 4-tuple (caller's responsibility before connect).
         cs.local_ip   = 0x0A00020Fu;
@@ -215,6 +246,7 @@ void _start(void) {
     // ====================================================================
     tcp_socket_t ss;
     {
+        for (size_t i = 0; i < sizeof(ss); i++) ((uint8_t*)&ss)[i] = 0;
         ss.state = TCP_STATE_CLOSED;
         ss.local_ip = 0; ss.local_port = 0;
         ss.remote_ip = 0; ss.remote_port = 0;
@@ -318,7 +350,7 @@ void _start(void) {
 
         uint8_t fin_out[40];
         size_t fin_len = 0;
-        int rc = netd_tcp_close(&s, fin_out, sizeof(fin_out), &fin_len);
+        int rc = netd_tcp_close(&s, fin_out, sizeof(fin_out), &fin_len, 0, TPS);
         TAP_ASSERT(rc == 0 && s.state == TCP_STATE_FIN_WAIT1 && fin_len == 20,
                    "36. close() from ESTABLISHED → FIN_WAIT1 (20-byte FIN)");
         uint32_t our_fin_seq = 0x5000u + 1;  // first byte after SYN
@@ -388,7 +420,7 @@ void _start(void) {
         s.rcv_wnd = TCP_DEFAULT_WINDOW; s.mss = TCP_DEFAULT_MSS;
 
         uint8_t fin[40]; size_t fin_len = 0;
-        netd_tcp_close(&s, fin, sizeof(fin), &fin_len);
+        netd_tcp_close(&s, fin, sizeof(fin), &fin_len, 0, TPS);
         TAP_ASSERT(s.state == TCP_STATE_FIN_WAIT1,
                    "42. active close → FIN_WAIT1");
         uint32_t our_fin_seq = 0x7001u;
@@ -453,7 +485,7 @@ void _start(void) {
 
         // We close.
         uint8_t our_fin[40]; size_t our_fin_len = 0;
-        rc = netd_tcp_close(&s, our_fin, sizeof(our_fin), &our_fin_len);
+        rc = netd_tcp_close(&s, our_fin, sizeof(our_fin), &our_fin_len, 0, TPS);
         TAP_ASSERT(rc == 0 && s.state == TCP_STATE_LAST_ACK &&
                    our_fin_len == 20,
                    "48. close() from CLOSE_WAIT → LAST_ACK, FIN emitted");
@@ -575,6 +607,179 @@ void _start(void) {
                    "56. negotiated MSS = min(ours=1460, peer=536) = 536");
     }
 
+    // ====================================================================
+    // G15. Checksum offload seed + NIC-verified parse.
+    // ====================================================================
+    {
+        const uint8_t data[7] = { 'o', 'f', 'f', 'l', 'o', 'a', 'd' };
+        uint8_t sw[27], hw[27];
+        netd_tcp_build(sw, 0x0A000001u, 0x0A000002u, 1234, 80,
+                       0x1000u, 0x2000u, TCP_FLAG_ACK | TCP_FLAG_PSH, 4096,
+                       0, data, sizeof(data));
+        size_t h = netd_tcp_build_offload(hw, 0x0A000001u, 0x0A000002u,
+                                          1234, 80, 0x1000u, 0x2000u,
+                                          TCP_FLAG_ACK | TCP_FLAG_PSH, 4096,
+                                          (const uint8_t*)0, 0,
+                                          sizeof(data), 0);
+        for (size_t i = 0; i < sizeof(data); i++) hw[h + i] = data[i];
+        // NIC: one's-complement sum from the TCP header to the end, seed
+        // included, complemented into the checksum field.
+        uint16_t c = netd_ntohs(netd_inet_checksum(hw, sizeof(hw), 0));
+        hw[16] = (uint8_t)(c >> 8);
+        hw[17] = (uint8_t)c;
+        TAP_ASSERT(h == 20 && bytes_eq(sw, hw, sizeof(sw)),
+                   "57. NIC-completed offload checksum matches software");
+
+        hw[20] ^= 0xFFu;   // Corrupt payload after the "NIC" verified it.
+        tcp_parsed_t pkt;
+        int bad = netd_tcp_parse(hw, sizeof(hw), 0x0A000001u, 0x0A000002u, &pkt);
+        int ok  = netd_tcp_parse_csum(hw, sizeof(hw), 0x0A000001u, 0x0A000002u,
+                                      NETD_CSUM_L4_OK, &pkt);
+        TAP_ASSERT(bad == -4 && ok == 0 && pkt.payload_len == sizeof(data),
+                   "58. parse_csum skips verification the NIC already did");
+    }
+
+    // ====================================================================
+    // G16. Phase 26: window scale / timestamps / SACK, fast retransmit,
+    //      CUBIC loss response.
+    // ====================================================================
+    {
+        tcp_socket_t s;
+        for (size_t i = 0; i < sizeof(s); i++) ((uint8_t*)&s)[i] = 0;
+        s.state = TCP_STATE_CLOSED;
+        s.local_ip = 0x0A00020Fu; s.local_port = 50000;
+        s.remote_ip = 0x08080808u; s.remote_port = 80;
+        s.mss = TCP_DEFAULT_MSS;
+        s.rcv_wnd = 65536u; s.rcv_wnd_max = 1024u * 1024u;
+        s.opts_offer = TCP_OPT_F_ALL;
+        s.cc_algo = TCP_CC_CUBIC;
+
+        uint8_t syn[TCP_HDR_LEN_MAX]; size_t syn_len = 0;
+        netd_tcp_connect(&s, 0x5000u, syn, sizeof(syn), &syn_len,
+                         TCP_DEFAULT_RTO_MS, 1000, TPS);
+        tcp_parsed_t pkt;
+        netd_tcp_parse(syn, syn_len, s.local_ip, s.remote_ip, &pkt);
+        TAP_ASSERT(syn_len == 40 && pkt.opt_mss == TCP_DEFAULT_MSS &&
+                   pkt.opt_wscale == 5 && pkt.opt_sack_perm && pkt.opt_ts,
+                   "59. SYN offers MSS, wscale 5 (1 MiB), SACK-permitted, TS");
+
+        // Peer: MSS, NOP WS(7), SACKP TS.
+        uint8_t o[20] = { 2, 4, 0x05, 0xB4, 1, 3, 3, 7, 4, 2,
+                          8, 10, 0, 0, 0, 9, 0, 0, 0, 0 };
+        o[16] = (uint8_t)(pkt.tsval >> 24); o[17] = (uint8_t)(pkt.tsval >> 16);
+        o[18] = (uint8_t)(pkt.tsval >> 8);  o[19] = (uint8_t)pkt.tsval;
+        uint8_t seg[TCP_HDR_LEN_MAX + 64]; size_t n;
+        n = netd_tcp_build_opts(seg, s.remote_ip, s.local_ip,
+                                s.remote_port, s.local_port,
+                                0x9000u, s.iss + 1,
+                                TCP_FLAG_SYN | TCP_FLAG_ACK, 65535,
+                                o, sizeof(o), (uint8_t*)0, 0);
+        netd_tcp_parse(seg, n, s.remote_ip, s.local_ip, &pkt);
+        uint8_t out[TCP_HDR_LEN_MAX]; size_t out_len = 0;
+        netd_tcp_on_segment(&s, &pkt, 2000, TPS, out, sizeof(out), &out_len);
+
+        // Every later peer segment: NOP NOP TS, ACK-only, window 100 << 7.
+        uint8_t ts[12] = { 1, 1, 8, 10, 0, 0, 0, 10, 0, 0, 0, 1 };
+        n = netd_tcp_build_opts(seg, s.remote_ip, s.local_ip,
+                                s.remote_port, s.local_port,
+                                0x9001u, s.snd_una, TCP_FLAG_ACK, 100,
+                                ts, sizeof(ts), (uint8_t*)0, 0);
+        netd_tcp_parse(seg, n, s.remote_ip, s.local_ip, &pkt);
+        netd_tcp_on_segment(&s, &pkt, 3000, TPS, out, sizeof(out), &out_len);
+        TAP_ASSERT(s.state == TCP_STATE_ESTABLISHED && s.opts == TCP_OPT_F_ALL &&
+                   s.snd_wscale == 7 && s.snd_wnd == (100u << 7),
+                   "60. all three negotiated; the peer's window is scaled by 7");
+
+        // Out-of-order data: held, rcv_nxt stays, the ACK reports it.
+        uint8_t data[50];
+        for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)i;
+        uint32_t hole = s.rcv_nxt;
+        n = netd_tcp_build_opts(seg, s.remote_ip, s.local_ip,
+                                s.remote_port, s.local_port,
+                                hole + 100u, s.snd_una, TCP_FLAG_ACK, 100,
+                                ts, sizeof(ts), data, sizeof(data));
+        netd_tcp_parse(seg, n, s.remote_ip, s.local_ip, &pkt);
+        out_len = 0;
+        netd_tcp_on_segment(&s, &pkt, 4000, TPS, out, sizeof(out), &out_len);
+        tcp_parsed_t ack;
+        int rc = netd_tcp_parse(out, out_len, s.local_ip, s.remote_ip, &ack);
+        TAP_ASSERT(rc == 0 && s.rcv_nxt == hole && ack.ack == hole &&
+                   ack.sack_n == 1 && ack.sack[0].start == hole + 100u &&
+                   ack.sack[0].end == hole + 150u,
+                   "61. out-of-order data is held and SACKed, rcv_nxt stays");
+
+        // Sender side: 8 full segments out, then three duplicate ACKs.
+        uint32_t emss = netd_tcp_eff_mss(&s);
+        s.snd_wnd = 64u * emss;
+        for (int i = 0; i < 8; i++) {
+            uint32_t sq, ln;
+            if (netd_tcp_next_segment(&s, s.snd_una + 8u * emss, 0xFFFFu, &sq, &ln)) {
+                netd_tcp_sent(&s, sq, ln, 5000, TPS);
+            }
+        }
+        uint32_t una = s.snd_una;
+        uint32_t cwnd_before = s.cwnd;
+        for (int i = 0; i < 3; i++) {
+            n = netd_tcp_build_opts(seg, s.remote_ip, s.local_ip,
+                                    s.remote_port, s.local_port,
+                                    s.rcv_nxt, una, TCP_FLAG_ACK, 100,
+                                    ts, sizeof(ts), (uint8_t*)0, 0);
+            netd_tcp_parse(seg, n, s.remote_ip, s.local_ip, &pkt);
+            netd_tcp_on_segment(&s, &pkt, 6000, TPS, out, sizeof(out), &out_len);
+        }
+        uint32_t rsq = 0, rln = 0;
+        int got = netd_tcp_next_segment(&s, s.snd_max, 0xFFFFu, &rsq, &rln);
+        TAP_ASSERT(s.snd_max == una + 8u * emss && s.ca_state == TCP_CA_RECOVERY &&
+                   got && rsq == una && rln == emss,
+                   "62. three dup ACKs: fast retransmit of the segment at snd_una");
+        TAP_ASSERT(s.ssthresh == cwnd_before * 7u / 10u && s.cwnd == s.ssthresh,
+                   "63. CUBIC cuts cwnd to 0.7x on loss");
+    }
+
+    // ====================================================================
+    // G17. Phase 26: SYN cookies.
+    // ====================================================================
+    {
+        tcp_table_t tbl;
+        tcp_table_t *t = &tbl;
+        netd_tcp_table_init(t);
+        t->cookie_key[0] = 0x0706050403020100ull;
+        t->cookie_key[1] = 0x0F0E0D0C0B0A0908ull;
+        uint32_t lip = 0x0A00020Fu, rip = 0x0A000001u;
+        uint32_t c = netd_tcp_syncookie(t, lip, 80, rip, 40000, 0x7000u, 1400, 9);
+        uint16_t mss = 0;
+        int ok = netd_tcp_syncookie_check(t, lip, 80, rip, 40000, 0x7000u, c, 9, &mss);
+        TAP_ASSERT(ok == 0 && mss == 1400,
+                   "64. a SYN cookie validates and keeps the peer's MSS class");
+
+        int bad_port = netd_tcp_syncookie_check(t, lip, 80, rip, 40001, 0x7000u, c, 9, &mss);
+        int bad_bits = netd_tcp_syncookie_check(t, lip, 80, rip, 40000, 0x7000u,
+                                                c ^ 0x10u, 9, &mss);
+        TAP_ASSERT(bad_port == -1 && bad_bits == -1,
+                   "65. another tuple or a flipped hash bit is rejected");
+
+        int prev = netd_tcp_syncookie_check(t, lip, 80, rip, 40000, 0x7000u, c, 10, &mss);
+        int old  = netd_tcp_syncookie_check(t, lip, 80, rip, 40000, 0x7000u, c, 11, &mss);
+        TAP_ASSERT(prev == 0 && old == -1,
+                   "66. honoured one period later, expired after two");
+
+        tcp_socket_t s;
+        for (size_t i = 0; i < sizeof(s); i++) ((uint8_t*)&s)[i] = 0;
+        netd_tcp_listen(&s, lip, 80);
+        s.remote_ip = rip;
+        uint8_t seg[TCP_HDR_LEN_MIN];
+        size_t n = netd_tcp_build(seg, rip, lip, 40000, 80, 0x7001u, c + 1u,
+                                  TCP_FLAG_ACK, 512, 0, (uint8_t*)0, 0);
+        tcp_parsed_t pkt;
+        netd_tcp_parse(seg, n, rip, lip, &pkt);
+        netd_tcp_syncookie_accept(&s, &pkt, mss, 1000, TPS);
+        TAP_ASSERT(s.state == TCP_STATE_ESTABLISHED && s.remote_port == 40000 &&
+                   s.snd_una == c + 1u && s.snd_max == c + 1u &&
+                   s.rcv_nxt == 0x7001u && s.mss == 1400 && s.opts == 0 &&
+                   s.snd_wnd == 512,
+                   "67. the cookie ACK rebuilds an ESTABLISHED socket, no options");
+    }
+
     tap_done();
     exit(0);
 }
@@ -0,0 +1,74 @@
+// user/tests/notify.c — Phase 26 notify-object TAP test.
+//
+// 10 TAP assertions across 4 groups:
+//   G1 basics (4)            -- notify_create returns a handle; a fresh word
+//                               polls as 0; two signals coalesce into one
+//                               collected word; collecting clears it
+//   G2 errors (3)            -- zero / >32-bit signals are EINVAL; a non-notify
+//                               handle is EBADF; an idle 20 ms wait returns 0
+//   G3 blocking (1)          -- a forever-wait on an already signalled word
+//                               returns at once
+//   G4 wait-set (2)          -- a registered notify reports READABLE after a
+//                               signal and stays ready until collected
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define CK_N  0x42u
+
+void _start(void) {
+    tap_plan(10);
+
+    // -------------------- G1: basics (4 asserts) ---------
+    long nrc = syscall_notify_create();
+    TAP_ASSERT(nrc > 0, "1. notify_create returns a handle");
+    if (nrc <= 0) tap_bail_out("notify_create failed");
+    uint64_t n = (uint64_t)nrc;
+
+    TAP_ASSERT(syscall_notify_wait(n, 0) == 0, "2. a fresh word polls as 0");
+
+    long s1 = syscall_notify_signal(n, 0x1);
+    long s2 = syscall_notify_signal(n, 0x4);
+    long got = syscall_notify_wait(n, 0);
+    TAP_ASSERT(s1 == 0 && s2 == 0 && got == 0x5,
+               "3. two signals coalesce into one collected word");
+    TAP_ASSERT(syscall_notify_wait(n, 0) == 0, "4. collecting clears the word");
+
+    // -------------------- G2: errors (3 asserts) ---------
+    TAP_ASSERT(syscall_notify_signal(n, 0) == -5 &&
+               syscall_notify_signal(n, 1ull << 40) == -5,
+               "5. zero and >32-bit signals return EINVAL");
+    long ws = syscall_waitset_create();
+    if (ws <= 0) tap_bail_out("waitset_create failed");
+    TAP_ASSERT(syscall_notify_signal((uint64_t)ws, 1) == -9,
+               "6. signalling a non-notify handle returns EBADF");
+    TAP_ASSERT(syscall_notify_wait(n, 20000000ULL) == 0,
+               "7. a 20 ms wait on an idle word times out with 0");
+
+    // -------------------- G3: blocking (1 assert) ---------
+    syscall_notify_signal(n, 0x80);
+    TAP_ASSERT(syscall_notify_wait(n, WAITSET_FOREVER) == 0x80,
+               "8. a forever-wait on a signalled word returns at once");
+
+    // -------------------- G4: wait-set (2 asserts) ---------
+    waitset_event_t ev[4];
+    syscall_waitset_ctl((uint64_t)ws, WAITSET_CTL_ADD, n, WAITSET_EV_READABLE, CK_N);
+    long idle = syscall_waitset_wait((uint64_t)ws, ev, 4, 0);
+    syscall_notify_signal(n, 0x2);
+    long k = syscall_waitset_wait((uint64_t)ws, ev, 4, 1000000000ULL);
+    TAP_ASSERT(idle == 0 && k == 1 && ev[0].cookie == CK_N &&
+               ev[0].events == WAITSET_EV_READABLE,
+               "9. a signal makes the registered notify READABLE");
+    long again = syscall_waitset_wait((uint64_t)ws, ev, 4, 0);
+    syscall_notify_wait(n, 0);
+    long after = syscall_waitset_wait((uint64_t)ws, ev, 4, 0);
+    TAP_ASSERT(again == 1 && after == 0,
+               "10. it stays ready until the word is collected");
+
+    tap_done();
+    exit(0);
+}
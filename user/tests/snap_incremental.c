@@ -0,0 +1,83 @@
+// user/tests/snap_incremental.c — Phase 26 incremental snapshot TAP test.
+//
+// 8 TAP assertions across 4 groups:
+//   G1 create (3)            -- a full SCOPE_SELF parent and an incremental
+//                               child both return handles; the child records
+//                               fewer pages than the parent
+//   G2 chain (2)             -- the child reports SNAP_SCOPE_INCREMENTAL; the
+//                               parent cannot be deleted while it lives (EBUSY)
+//   G3 restore (2)           -- restoring the child brings back a page written
+//                               before it (its own delta) and a page written
+//                               only after it (inherited from the parent)
+//   G4 errors/teardown (1)   -- INCREMENTAL without a snapshot parent is
+//                               EINVAL; child then parent delete cleanly
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+// One page each so the delta is visible per marker.
+static volatile uint32_t g_a[1024] __attribute__((aligned(4096)));
+static volatile uint32_t g_b[1024] __attribute__((aligned(4096)));
+
+static snap_info_user_t g_info[8];
+
+static const snap_info_user_t *find_info(long n, const char *name) {
+    for (long i = 0; i < n; i++) {
+        if (strcmp(g_info[i].name, name) == 0) return &g_info[i];
+    }
+    return NULL;
+}
+
+void _start(void) {
+    tap_plan(8);
+
+    // -------------------- G1: create (3 asserts) ---------
+    g_a[0] = 1;
+    g_b[0] = 10;
+    long p = syscall_snap_create(SNAP_SCOPE_SELF, "incr-parent");
+    TAP_ASSERT(p >= 0, "1. full parent snapshot returns a handle");
+    if (p < 0) tap_bail_out("snap_create failed");
+
+    g_a[0] = 2;
+    long c = syscall_snap_create_incremental(SNAP_SCOPE_SELF, "incr-child",
+                                             (uint32_t)p);
+    TAP_ASSERT(c >= 0, "2. incremental child returns a handle");
+    if (c < 0) tap_bail_out("incremental snap_create failed");
+
+    long n = syscall_snap_list(g_info, 8);
+    const snap_info_user_t *ip = find_info(n, "incr-parent");
+    const snap_info_user_t *ic = find_info(n, "incr-child");
+    TAP_ASSERT(ip && ic && ic->pages_shared < ip->pages_shared,
+               "3. the child records fewer pages than the parent");
+
+    // -------------------- G2: chain (2 asserts) ---------
+    TAP_ASSERT(ic && (ic->scope_flags & SNAP_SCOPE_INCREMENTAL),
+               "4. the child reports SNAP_SCOPE_INCREMENTAL");
+    TAP_ASSERT(syscall_snap_delete((uint32_t)p) == -16,
+               "5. deleting the parent of a live child returns EBUSY");
+
+    // -------------------- G3: restore (2 asserts) ---------
+    g_a[0] = 3;
+    g_b[0] = 11;
+    long rr = syscall_snap_restore((uint32_t)c);
+    TAP_ASSERT(rr == 0 && g_a[0] == 2,
+               "6. restore brings back the child's own delta page");
+    TAP_ASSERT(g_b[0] == 10,
+               "7. restore brings back a page inherited from the parent");
+
+    // -------------------- G4: errors/teardown (1 assert) ---------
+    long ws = syscall_waitset_create();
+    long bad = syscall_snap_create_incremental(SNAP_SCOPE_SELF, "incr-bad",
+                                               (uint32_t)ws);
+    long dc = syscall_snap_delete((uint32_t)c);
+    long dp = syscall_snap_delete((uint32_t)p);
+    TAP_ASSERT(bad == -22 && dc == 0 && dp == 0,
+               "8. non-snapshot parent is EINVAL; child then parent delete");
+
+    tap_done();
+    exit(0);
+}
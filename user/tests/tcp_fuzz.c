@@ -423,12 +423,14 @@ void _start(void) {
         ls->state = TCP_STATE_LISTEN;
         ls->local_ip = LOCAL_IP;  ls->local_port = LOCAL_P;
         ls->remote_ip = 0; ls->remote_port = 0;
+        (void)netd_tcp_hash_insert(&tbl, li);
 
         int ei = netd_tcp_socket_alloc(&tbl, /*owner_cookie=*/0x4002);
         tcp_socket_t *es = &tbl.sockets[ei];
         es->state = TCP_STATE_ESTABLISHED;
         es->local_ip = LOCAL_IP;  es->local_port = LOCAL_P;
         es->remote_ip = REMOTE_IP; es->remote_port = REMOTE_P;
+        (void)netd_tcp_hash_insert(&tbl, ei);
 
         int found_e = netd_tcp_find_established(&tbl, LOCAL_IP, LOCAL_P,
                                                 REMOTE_IP, REMOTE_P);
@@ -23,6 +23,7 @@
 extern void netd_tcp_table_init(tcp_table_t *tbl);
 extern int  netd_tcp_socket_alloc(tcp_table_t *tbl, uint32_t owner_cookie);
 extern void netd_tcp_socket_free(tcp_table_t *tbl, int idx);
+extern int  netd_tcp_hash_insert(tcp_table_t *tbl, int idx);
 extern int  netd_tcp_find_established(const tcp_table_t *tbl,
                                        uint32_t local_ip, uint16_t local_port,
                                        uint32_t remote_ip, uint16_t remote_port);
@@ -112,9 +113,11 @@ void _start(void) {
         s->local_port = (uint16_t)(40000 + (i & 0x1FFF));
         s->remote_ip  = 0x08080808u;
         s->remote_port = (uint16_t)(80 + (i & 0xFF));
+        if (netd_tcp_hash_insert(&g_tbl, idx) != 0) { lookup_ok = 0; break; }
     }
     if (lookup_ok) {
-        // Reverse-look up the first 100 to prove the array walk works at scale.
+        // Reverse-look up the first 100 to prove the 4-tuple hash holds up
+        // with the table nearly full.
         for (uint32_t i = 0; i < 100; i++) {
             int idx = netd_tcp_find_established(
                 &g_tbl,
@@ -129,7 +132,7 @@ void _start(void) {
             }
         }
     }
-    TAP_ASSERT(lookup_ok, "4. find_established walks 1000-socket table cleanly");
+    TAP_ASSERT(lookup_ok, "4. find_established hashes into a 1000-socket table cleanly");
 
     // ---------- 5: pool size invariant ----------
     TAP_ASSERT(TCP_MAX_SOCKETS == 1024u,
@@ -0,0 +1,100 @@
+// user/tests/tlb_shootdown.c — Phase 26 TLB shootdown TAP test.
+//
+// 8 TAP assertions across 4 groups:
+//   G1 stats (1)             -- DEBUG_TLB_STATS returns a PCID verdict
+//   G2 batched unmap (3)     -- 16-page unmap is 1 shootdown, not 16
+//   G3 overflow unmap (2)    -- 64-page unmap degrades to a full flush
+//   G4 clone downgrade (2)   -- COW clone RO-marks via one batch; the
+//                               child's COW write stays private
+//
+// Counters are global, so every "<" bound leaves headroom for unrelated
+// activity on other CPUs; the ">=" bounds are what the batching promises.
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define PAGE_SZ  4096ull
+
+void _start(void) {
+    tap_plan(8);
+
+    // -------------------- G1: stats (1 assert) ---------
+    tlb_stats_u_t s0, s1;
+    memset(&s0, 0, sizeof(s0));
+    long pcid = syscall_debug_tlb_stats(&s0);
+    TAP_ASSERT(pcid == 0 || pcid == 1, "1. DEBUG_TLB_STATS returns PCID state 0/1");
+
+    // -------------------- G2: batched unmap (3 asserts) ---------
+    long vres = syscall_vmo_create(16 * PAGE_SZ, VMO_ZEROED);
+    cap_token_u_t vmo = {.raw = (uint64_t)vres};
+    long map = syscall_vmo_map(vmo, 0, 0, 16 * PAGE_SZ, PROT_READ | PROT_WRITE);
+    if (vres <= 0 || map <= 0) tap_bail_out("16-page VMO create/map failed");
+    uint8_t *p = (uint8_t *)(uintptr_t)map;
+    for (uint64_t i = 0; i < 16; i++) p[i * PAGE_SZ] = (uint8_t)(0x40 + i);
+
+    syscall_debug_tlb_stats(&s0);
+    long urc = syscall_vmo_unmap((uint64_t)map, 16 * PAGE_SZ);
+    syscall_debug_tlb_stats(&s1);
+    TAP_ASSERT(urc == 0, "2. vmo_unmap(16 pages) returns 0");
+    TAP_ASSERT(s1.shootdowns - s0.shootdowns >= 1 &&
+               s1.shootdowns - s0.shootdowns < 16,
+               "3. 16-page unmap is batched (fewer shootdowns than pages)");
+
+    long map2 = syscall_vmo_map(vmo, 0, 0, 16 * PAGE_SZ, PROT_READ);
+    int fresh = (map2 > 0);
+    if (fresh) {
+        uint8_t *q = (uint8_t *)(uintptr_t)map2;
+        for (uint64_t i = 0; i < 16; i++) {
+            if (q[i * PAGE_SZ] != (uint8_t)(0x40 + i)) { fresh = 0; break; }
+        }
+        syscall_vmo_unmap((uint64_t)map2, 16 * PAGE_SZ);
+    }
+    TAP_ASSERT(fresh, "4. remap after batched unmap reads back every page");
+
+    // -------------------- G3: overflow unmap (2 asserts) ---------
+    long vbig = syscall_vmo_create(64 * PAGE_SZ, VMO_ZEROED);
+    cap_token_u_t big = {.raw = (uint64_t)vbig};
+    long mbig = syscall_vmo_map(big, 0, 0, 64 * PAGE_SZ, PROT_READ | PROT_WRITE);
+    if (vbig <= 0 || mbig <= 0) tap_bail_out("64-page VMO create/map failed");
+    uint8_t *b = (uint8_t *)(uintptr_t)mbig;
+    for (uint64_t i = 0; i < 64; i++) b[i * PAGE_SZ] = 1;
+
+    syscall_debug_tlb_stats(&s0);
+    urc = syscall_vmo_unmap((uint64_t)mbig, 64 * PAGE_SZ);
+    syscall_debug_tlb_stats(&s1);
+    TAP_ASSERT(urc == 0, "5. vmo_unmap(64 pages) returns 0");
+    TAP_ASSERT(s1.full_flushes - s0.full_flushes >= 1,
+               "6. unmap past TLB_BATCH_MAX degrades to a full flush");
+
+    // -------------------- G4: clone downgrade (2 asserts) ---------
+    long mrw = syscall_vmo_map(vmo, 0, 0, 16 * PAGE_SZ, PROT_READ | PROT_WRITE);
+    if (mrw <= 0) tap_bail_out("RW remap failed");
+    uint8_t *w = (uint8_t *)(uintptr_t)mrw;
+
+    syscall_debug_tlb_stats(&s0);
+    long cres = syscall_vmo_clone(vmo, VMO_CLONE_COW);
+    syscall_debug_tlb_stats(&s1);
+    TAP_ASSERT(cres > 0 && s1.shootdowns - s0.shootdowns >= 1 &&
+               s1.shootdowns - s0.shootdowns < 16,
+               "7. vmo_clone write-protects the live mapping in one batch");
+
+    // The child's first write faults through vmo_pf_dispatch, which
+    // replaces its PTE; a stale translation would let the write land in
+    // the frame still shared with the parent.
+    cap_token_u_t child = {.raw = (uint64_t)cres};
+    long mc = syscall_vmo_map(child, 0, 0, PAGE_SZ, PROT_READ | PROT_WRITE);
+    int isolated = 0;
+    if (mc > 0) {
+        uint8_t *c = (uint8_t *)(uintptr_t)mc;
+        c[0] = 0xEE;
+        isolated = (c[0] == 0xEE && w[0] == 0x40);
+    }
+    TAP_ASSERT(isolated, "8. child write after clone does not leak into the parent");
+
+    tap_done();
+    exit(0);
+}
@@ -0,0 +1,80 @@
+// user/tests/txn_buffer_grow.c — Phase 26 growable txn buffer.
+//
+// External-peer multi-process txn test: with TXN_FLAG_BUFFER_64MB the
+// buffer starts small and grows past the default 4 MiB cap.
+//
+// Asserts:
+//   1. publish + spawn child succeeded
+//   2. 12000 sends (~4.1 MiB of records) during an active txn all buffer
+//   3. txn_abort returns 0 cleanly after the grown fill
+//   4. child exited cleanly
+
+#include "txn_multi_proc_helper.h"
+
+#define CHAN_NAME     "/test/txn-buf-grow"
+#define CHAN_NAME_LEN 18
+#define BINARY_PATH   "bin/tests/txn_buffer_grow.tap"
+
+// 12000 * 356-byte records > 4 MiB.
+#define N_SENDS       12000
+
+void _start(int argc, char **argv) {
+    (void)argv;
+    cap_token_u_t wr_req  = { .raw = 0 };
+    cap_token_u_t rd_resp = { .raw = 0 };
+    int child_mode = (argc >= 2) ||
+                     (txn_mp_probe_child(CHAN_NAME, CHAN_NAME_LEN,
+                                         &wr_req, &rd_resp) == 0);
+    if (child_mode) {
+        if (wr_req.raw == 0 &&
+            txn_mp_connect(CHAN_NAME, CHAN_NAME_LEN, &wr_req, &rd_resp) != 0) {
+            syscall_exit(11);
+        }
+        syscall_exit(0);
+    }
+
+    tap_plan(4);
+
+    cap_token_u_t accept_rd = txn_mp_publish(CHAN_NAME, CHAN_NAME_LEN);
+    int child_pid = txn_mp_spawn_child(BINARY_PATH);
+    TAP_ASSERT(accept_rd.raw != 0 && child_pid > 0,
+               "1. publish + spawn child succeeded");
+
+    cap_token_u_t rd_req  = { .raw = 0 };
+    cap_token_u_t wr_resp = { .raw = 0 };
+    int ar = txn_mp_accept(accept_rd, &rd_req, &wr_resp);
+    if (ar != 0 || wr_resp.raw == 0) {
+        TAP_ASSERT(0, "2. sends buffered past 4 MiB (accept failed)");
+        TAP_ASSERT(0, "3. txn_abort returns 0 (accept failed)");
+        goto wait_child;
+    }
+
+    long h = syscall_txn_begin(TXN_FLAG_SELF_SCOPE | TXN_FLAG_BUFFER_64MB,
+                               "buf_grow");
+    if (h < 0) {
+        TAP_ASSERT(0, "2. sends buffered past 4 MiB (txn_begin failed)");
+        TAP_ASSERT(0, "3. txn_abort returns 0 (txn_begin failed)");
+        goto wait_child;
+    }
+
+    int sent_count = 0;
+    for (int i = 0; i < N_SENDS; i++) {
+        if (txn_mp_send_tag(wr_resp, (uint8_t)(i & 0xFF)) != 0) break;
+        sent_count++;
+    }
+    if (sent_count != N_SENDS) printf("# sent_count=%d\n", sent_count);
+    TAP_ASSERT(sent_count == N_SENDS,
+               "2. 12000 sends during an active txn buffer past 4 MiB");
+
+    long arc = syscall_txn_abort((uint32_t)h);
+    TAP_ASSERT(arc == 0, "3. txn_abort returns 0 cleanly after the grown fill");
+
+wait_child: {
+    int child_status = -1;
+    (void)syscall_wait(&child_status);
+    TAP_ASSERT(child_status == 0, "4. child exited cleanly");
+}
+
+    tap_done();
+    syscall_exit(0);
+}
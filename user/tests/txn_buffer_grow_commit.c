@@ -0,0 +1,143 @@
+// user/tests/txn_buffer_grow_commit.c — Phase 26 growable txn buffer.
+//
+// External-peer multi-process txn test: the buffer grows while sends to
+// several channels interleave, and the grown buffer then commits through
+// stalls. Each per-connection ring holds 64 messages, so the first commit
+// cannot deliver all of them; retries finish it as the child drains.
+//
+// Asserts:
+//   1. publish + spawn child succeeded
+//   2. all three connections accepted
+//   3. 3 x 250 interleaved sends (~260 KiB of records) buffer past the
+//      64 KiB initial size
+//   4. the first txn_commit stalls on the full rings (rc < 0)
+//   5. txn_commit retried until it returns 0
+//   6. child received every message in per-channel order (exit 0)
+
+#include "txn_multi_proc_helper.h"
+
+#define CHAN_NAME     "/test/txn-grow-commit"
+#define CHAN_NAME_LEN 21
+#define BINARY_PATH   "bin/tests/txn_buffer_grow_commit.tap"
+
+#define N_CHANS       3
+#define N_PER_CHAN    250       // > RAWNET_CONN_CAPACITY (64)
+
+// Child: open N_CHANS connections, hold off long enough for the parent's
+// first commit to stall, then drain all of them round-robin, checking the
+// tags arrive 0, 1, 2, ... on every channel.
+static void child_main(cap_token_u_t first_wr, cap_token_u_t first_rd) {
+    cap_token_u_t wr[N_CHANS];
+    cap_token_u_t rd[N_CHANS];
+    wr[0] = first_wr;
+    rd[0] = first_rd;
+    for (int k = 0; k < N_CHANS; k++) {
+        if (k == 0 && wr[0].raw != 0) continue;
+        if (txn_mp_connect(CHAN_NAME, CHAN_NAME_LEN, &wr[k], &rd[k]) != 0) {
+            syscall_exit(11);
+        }
+    }
+
+    spin_us(300000);
+
+    int got[N_CHANS] = { 0 };
+    int idle = 0;
+    while (idle < 400) {
+        int done = 1;
+        int progress = 0;
+        for (int k = 0; k < N_CHANS; k++) {
+            if (got[k] == N_PER_CHAN) continue;
+            done = 0;
+            chan_msg_user_t m;
+            long b = txn_mp_recv(rd[k], &m, 10000000ULL /* 10 ms */);
+            if (b < 4) continue;
+            if (m.inline_payload[0] != (uint8_t)(got[k] & 0xFF)) {
+                printf("# child: chan %d msg %d tag=%u\n",
+                       k, got[k], (unsigned)m.inline_payload[0]);
+                syscall_exit(13);
+            }
+            got[k]++;
+            progress = 1;
+        }
+        if (done) syscall_exit(0);
+        idle = progress ? 0 : idle + 1;
+    }
+    printf("# child: got=%d/%d/%d\n", got[0], got[1], got[2]);
+    syscall_exit(14);
+}
+
+void _start(int argc, char **argv) {
+    (void)argv;
+    cap_token_u_t wr_req  = { .raw = 0 };
+    cap_token_u_t rd_resp = { .raw = 0 };
+    int child_mode = (argc >= 2) ||
+                     (txn_mp_probe_child(CHAN_NAME, CHAN_NAME_LEN,
+                                         &wr_req, &rd_resp) == 0);
+    if (child_mode) child_main(wr_req, rd_resp);
+
+    tap_plan(6);
+
+    cap_token_u_t accept_rd = txn_mp_publish(CHAN_NAME, CHAN_NAME_LEN);
+    int child_pid = txn_mp_spawn_child(BINARY_PATH);
+    TAP_ASSERT(accept_rd.raw != 0 && child_pid > 0,
+               "1. publish + spawn child succeeded");
+
+    cap_token_u_t rd_req[N_CHANS];
+    cap_token_u_t wr_resp[N_CHANS];
+    int accepted = 0;
+    for (int k = 0; k < N_CHANS; k++) {
+        if (txn_mp_accept(accept_rd, &rd_req[k], &wr_resp[k]) != 0 ||
+            wr_resp[k].raw == 0) {
+            break;
+        }
+        accepted++;
+    }
+    TAP_ASSERT(accepted == N_CHANS, "2. all three connections accepted");
+    if (accepted != N_CHANS) {
+        TAP_ASSERT(0, "3. interleaved sends buffered (accept failed)");
+        TAP_ASSERT(0, "4. first commit stalls (accept failed)");
+        TAP_ASSERT(0, "5. commit retried to 0 (accept failed)");
+        goto wait_child;
+    }
+
+    long h = syscall_txn_begin(TXN_FLAG_SELF_SCOPE | TXN_FLAG_BUFFER_64MB,
+                               "grow_commit");
+    if (h < 0) {
+        TAP_ASSERT(0, "3. interleaved sends buffered (txn_begin failed)");
+        TAP_ASSERT(0, "4. first commit stalls (txn_begin failed)");
+        TAP_ASSERT(0, "5. commit retried to 0 (txn_begin failed)");
+        goto wait_child;
+    }
+
+    int sent_count = 0;
+    for (int i = 0; i < N_PER_CHAN; i++) {
+        for (int k = 0; k < N_CHANS; k++) {
+            if (txn_mp_send_tag(wr_resp[k], (uint8_t)(i & 0xFF)) == 0) {
+                sent_count++;
+            }
+        }
+    }
+    if (sent_count != N_CHANS * N_PER_CHAN) printf("# sent_count=%d\n", sent_count);
+    TAP_ASSERT(sent_count == N_CHANS * N_PER_CHAN,
+               "3. 750 interleaved sends buffer past the initial 64 KiB");
+
+    long crc = syscall_txn_commit((uint32_t)h);
+    TAP_ASSERT(crc < 0, "4. first txn_commit stalls on the full rings");
+
+    for (int attempt = 0; crc != 0 && attempt < 400; attempt++) {
+        spin_us(5000);
+        crc = syscall_txn_commit((uint32_t)h);
+    }
+    if (crc != 0) printf("# commit rc=%ld\n", crc);
+    TAP_ASSERT(crc == 0, "5. txn_commit retried until it returns 0");
+
+wait_child: {
+    int child_status = -1;
+    (void)syscall_wait(&child_status);
+    TAP_ASSERT(child_status == 0,
+               "6. child received every message in per-channel order");
+}
+
+    tap_done();
+    syscall_exit(0);
+}
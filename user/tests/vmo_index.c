@@ -0,0 +1,79 @@
+// user/tests/vmo_index.c — Phase 26 per-address-space VMO index TAP test.
+//
+// 6 TAP assertions across 4 groups:
+//   G1 many mappings (2)     -- 128 single-page maps of one VMO (twice the
+//                               old 64-slot row) all land and read back
+//   G2 COW lookup (1)        -- a write fault in a 129-mapping address
+//                               space resolves through the index
+//   G3 overlap (1)           -- a hint on top of a live mapping is refused
+//   G4 churn (2)             -- unmapping every other mapping rebalances
+//                               the index; faults and reads still resolve
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define PAGE_SZ  4096ull
+#define NMAPS    128
+
+static long maps[NMAPS];
+
+void _start(void) {
+    tap_plan(6);
+
+    // -------------------- G1: many mappings (2 asserts) ---------
+    long vres = syscall_vmo_create(NMAPS * PAGE_SZ, VMO_ZEROED);
+    if (vres <= 0) tap_bail_out("128-page VMO create failed");
+    cap_token_u_t vmo = {.raw = (uint64_t)vres};
+
+    int all_mapped = 1;
+    for (int i = 0; i < NMAPS; i++) {
+        maps[i] = syscall_vmo_map(vmo, 0, (uint64_t)i * PAGE_SZ, PAGE_SZ,
+                                  PROT_READ | PROT_WRITE);
+        if (maps[i] <= 0) { all_mapped = 0; break; }
+    }
+    TAP_ASSERT(all_mapped, "1. 128 single-page mappings of one VMO succeed");
+    if (!all_mapped) tap_bail_out("mapping index rejected a mapping");
+
+    for (int i = 0; i < NMAPS; i++) *(volatile uint8_t *)maps[i] = (uint8_t)(i + 1);
+    int readback = 1;
+    for (int i = 0; i < NMAPS; i++) {
+        if (*(volatile uint8_t *)maps[i] != (uint8_t)(i + 1)) { readback = 0; break; }
+    }
+    TAP_ASSERT(readback, "2. every mapping reads back its own page");
+
+    // -------------------- G2: COW lookup (1 assert) ---------
+    long cres = syscall_vmo_clone(vmo, VMO_CLONE_COW);
+    cap_token_u_t child = {.raw = (uint64_t)cres};
+    long cmap = (cres > 0) ? syscall_vmo_map(child, 0, 0, NMAPS * PAGE_SZ,
+                                             PROT_READ | PROT_WRITE) : -1;
+    if (cmap <= 0) tap_bail_out("COW child map failed");
+    volatile uint8_t *c = (volatile uint8_t *)(uintptr_t)cmap;
+    c[97 * PAGE_SZ] = 0xEE;
+    TAP_ASSERT(c[97 * PAGE_SZ] == 0xEE && *(volatile uint8_t *)maps[97] == 98,
+               "3. COW write fault resolves among 129 mappings");
+
+    // -------------------- G3: overlap (1 assert) ---------
+    long dup = syscall_vmo_map(vmo, (uint64_t)maps[5], 0, PAGE_SZ, PROT_READ);
+    TAP_ASSERT(dup <= 0, "4. map hint overlapping a live mapping is refused");
+
+    // -------------------- G4: churn (2 asserts) ---------
+    int unmapped = 1;
+    for (int i = 0; i < NMAPS; i += 2) {
+        if (syscall_vmo_unmap((uint64_t)maps[i], PAGE_SZ) != 0) unmapped = 0;
+    }
+    TAP_ASSERT(unmapped, "5. unmapping every other mapping returns 0");
+
+    c[33 * PAGE_SZ] = 0x77;
+    int intact = (c[33 * PAGE_SZ] == 0x77);
+    for (int i = 1; i < NMAPS; i += 2) {
+        if (*(volatile uint8_t *)maps[i] != (uint8_t)(i + 1)) { intact = 0; break; }
+    }
+    TAP_ASSERT(intact, "6. after churn, faults resolve and survivors read back");
+
+    tap_done();
+    exit(0);
+}
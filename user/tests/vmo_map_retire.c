@@ -0,0 +1,121 @@
+// user/tests/vmo_map_retire.c — Phase 26 VMO_MAP_RETIRE TAP test.
+//
+// 10 TAP assertions across 5 groups:
+//   G1 success (3)     -- a retiring map succeeds and the page is usable;
+//                         the handle is gone afterwards; unmap succeeds
+//   G2 map failure (2) -- a retiring map past the VMO's end fails, and the
+//                         handle is consumed anyway
+//   G3 rights (2)      -- a token without RIGHT_REVOKE is refused with
+//                         EPERM and nothing is consumed
+//   G4 MMIO (2)        -- the framebuffer's VMO_MMIO cap is refused with
+//                         EINVAL and keeps mapping normally
+//   G5 anon (1)        -- a VMO_ANON cap is retired by a failed first map,
+//                         not only a successful one
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+
+extern int printf(const char *fmt, ...);
+
+#define PAGE_SZ  4096ull
+
+static cap_token_u_t new_vmo(void) {
+    long r = syscall_vmo_create(PAGE_SZ, VMO_ZEROED);
+    if (r <= 0) tap_bail_out("vmo_create failed");
+    return (cap_token_u_t){ .raw = (uint64_t)r };
+}
+
+void _start(void) {
+    tap_plan(10);
+
+    // -------------------- G1: success (3 asserts) ---------
+    cap_token_u_t a = new_vmo();
+    long va = syscall_vmo_map(a, 0, 0, PAGE_SZ,
+                              PROT_READ | PROT_WRITE | VMO_MAP_RETIRE);
+    int usable = 0;
+    if (va > 0) {
+        *(volatile uint32_t *)va = 0x52455449u;
+        usable = *(volatile uint32_t *)va == 0x52455449u;
+    }
+    TAP_ASSERT(va > 0 && usable, "1. retiring map succeeds and the page is usable");
+
+    long again = syscall_vmo_map(a, 0, 0, PAGE_SZ, PROT_READ);
+    if (again > 0) (void)syscall_vmo_unmap((uint64_t)again, PAGE_SZ);
+    TAP_ASSERT(again < 0, "2. handle is consumed by a successful map");
+
+    long un = va > 0 ? syscall_vmo_unmap((uint64_t)va, PAGE_SZ) : -1;
+    TAP_ASSERT(un == 0, "3. unmap drops the mapping's last reference");
+
+    // -------------------- G2: map failure (2 asserts) ---------
+    cap_token_u_t b = new_vmo();
+    long bad = syscall_vmo_map(b, 0, PAGE_SZ, PAGE_SZ, PROT_READ | VMO_MAP_RETIRE);
+    if (bad > 0) (void)syscall_vmo_unmap((uint64_t)bad, PAGE_SZ);
+    TAP_ASSERT(bad < 0, "4. retiring map past the VMO's end fails");
+
+    long after = syscall_vmo_map(b, 0, 0, PAGE_SZ, PROT_READ);
+    if (after > 0) (void)syscall_vmo_unmap((uint64_t)after, PAGE_SZ);
+    TAP_ASSERT(after < 0, "5. handle is consumed by a failed map too");
+
+    // -------------------- G3: RIGHT_REVOKE (2 asserts) ---------
+    cap_token_u_t c = new_vmo();
+    cap_token_raw_t weak = syscall_cap_derive(c.raw, RIGHT_READ | RIGHT_WRITE,
+                                              NULL, 0);
+    long denied = -1;
+    if ((long)weak > 0) {
+        denied = syscall_vmo_map((cap_token_u_t){ .raw = weak }, 0, 0, PAGE_SZ,
+                                 PROT_READ | VMO_MAP_RETIRE);
+        if (denied > 0) (void)syscall_vmo_unmap((uint64_t)denied, PAGE_SZ);
+    } else {
+        printf("# cap_derive rc=%ld\n", (long)weak);
+    }
+    TAP_ASSERT((long)weak > 0 && denied == -1,
+               "6. retiring without RIGHT_REVOKE is refused with EPERM");
+
+    long weak_va = (long)weak > 0
+        ? syscall_vmo_map((cap_token_u_t){ .raw = weak }, 0, 0, PAGE_SZ, PROT_READ)
+        : -1;
+    long strong_va = syscall_vmo_map(c, 0, 0, PAGE_SZ, PROT_READ);
+    TAP_ASSERT(weak_va > 0 && strong_va > 0,
+               "7. the refused call consumed neither token");
+    if (weak_va > 0) (void)syscall_vmo_unmap((uint64_t)weak_va, PAGE_SZ);
+    if (strong_va > 0) (void)syscall_vmo_unmap((uint64_t)strong_va, PAGE_SZ);
+
+    // -------------------- G4: MMIO (2 asserts) ---------
+    // The framebuffer is the one VMO_MMIO cap a test can mint without
+    // owning a PCI BAR. Clear any stale owner first (fb_mmio_map leaves
+    // itself recorded), and again afterwards.
+    (void)syscall_debug_fb_owner_set(-1);
+    uint64_t fb_raw = 0;
+    fb_dims_u_t dims = {0};
+    long fb = syscall_console_gfx_map_fb(&fb_raw, &dims);
+    if (fb != 0 || fb_raw == 0) {
+        printf("# gfx_map_fb rc=%ld\n", fb);
+        tap_skip("8. MMIO cap refuses VMO_MAP_RETIRE", "no framebuffer cap");
+        tap_skip("9. MMIO cap still maps", "no framebuffer cap");
+    } else {
+        cap_token_u_t fbt = { .raw = fb_raw };
+        long mr = syscall_vmo_map(fbt, 0, 0, PAGE_SZ,
+                                  PROT_READ | PROT_WRITE | VMO_MAP_RETIRE);
+        if (mr > 0) (void)syscall_vmo_unmap((uint64_t)mr, PAGE_SZ);
+        TAP_ASSERT(mr == -5, "8. MMIO cap refuses VMO_MAP_RETIRE with EINVAL");
+
+        long fva = syscall_vmo_map(fbt, 0, 0, PAGE_SZ, PROT_READ | PROT_WRITE);
+        TAP_ASSERT(fva > 0, "9. MMIO cap keeps its handle and still maps");
+        if (fva > 0) (void)syscall_vmo_unmap((uint64_t)fva, PAGE_SZ);
+    }
+    (void)syscall_debug_fb_owner_set(-1);
+
+    // -------------------- G5: VMO_ANON (1 assert) ---------
+    long arc = syscall_vmo_create(PAGE_SZ, VMO_ZEROED | VMO_ANON);
+    cap_token_u_t an = { .raw = (uint64_t)arc };
+    long afail = arc > 0 ? syscall_vmo_map(an, 0, PAGE_SZ, PAGE_SZ, PROT_READ) : 1;
+    long aretry = arc > 0 ? syscall_vmo_map(an, 0, 0, PAGE_SZ, PROT_READ) : 1;
+    if (aretry > 0 && arc > 0) (void)syscall_vmo_unmap((uint64_t)aretry, PAGE_SZ);
+    TAP_ASSERT(arc > 0 && afail < 0 && aretry < 0,
+               "10. a failed first map retires a VMO_ANON cap too");
+
+    tap_done();
+    syscall_exit(0);
+}
@@ -0,0 +1,127 @@
+// user/tests/waitset.c — Phase 26 wait-set TAP test.
+//
+// 13 TAP assertions across 6 groups:
+//   G1 create (2)            -- waitset_create returns a handle; ADD of an
+//                               empty channel's read end polls as 0 events
+//   G2 level (3)             -- a send reports {cookie, READABLE}; the item
+//                               is reported again while unread; recv clears it
+//   G3 edge (2)              -- WAITSET_EDGE reports a send once, even while
+//                               the message stays queued
+//   G4 oneshot (2)           -- WAITSET_ONESHOT disarms after one report;
+//                               CTL_MOD re-arms it
+//   G5 ctl (2)               -- duplicate ADD is EBUSY; DEL then ADD works
+//   G6 wait (2)              -- a 20 ms wait on an idle set returns 0; the
+//                               write end of a channel with room is WRITABLE
+
+#include "../libtap.h"
+#include "../syscalls.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define CK_RD   7u
+#define CK_WR   9u
+#define POLL    0ull
+
+static uint64_t hash;
+static cap_token_u_t rd, wr;
+
+static long send_one(uint8_t v) {
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    m.header.type_hash  = hash;
+    m.header.inline_len = 1;
+    m.inline_payload[0] = v;
+    return syscall_chan_send(wr, &m, 1000000000ULL);
+}
+
+static long recv_one(void) {
+    chan_msg_user_t m;
+    memset(&m, 0, sizeof(m));
+    return syscall_chan_recv(rd, &m, 0);
+}
+
+void _start(void) {
+    tap_plan(13);
+
+    hash = gcp_type_hash("grahaos.test.v1");
+    long crc = syscall_chan_create(hash, CHAN_MODE_BLOCKING, 8, &wr);
+    if (crc <= 0) tap_bail_out("chan_create failed");
+    rd.raw = (uint64_t)crc;
+
+    waitset_event_t ev[4];
+
+    // -------------------- G1: create (2 asserts) ---------
+    long wsrc = syscall_waitset_create();
+    TAP_ASSERT(wsrc > 0, "1. waitset_create returns a handle");
+    if (wsrc <= 0) tap_bail_out("waitset_create failed");
+    uint64_t ws = (uint64_t)wsrc;
+
+    long add = syscall_waitset_ctl(ws, WAITSET_CTL_ADD, rd.raw,
+                                   WAITSET_EV_READABLE, CK_RD);
+    TAP_ASSERT(add == 0 && syscall_waitset_wait(ws, ev, 4, POLL) == 0,
+               "2. ADD of an empty read end polls as no events");
+
+    // -------------------- G2: level (3 asserts) ---------
+    send_one(0x11);
+    long n = syscall_waitset_wait(ws, ev, 4, 1000000000ULL);
+    TAP_ASSERT(n == 1 && ev[0].cookie == CK_RD &&
+               ev[0].events == WAITSET_EV_READABLE,
+               "3. a send reports the cookie as READABLE");
+    n = syscall_waitset_wait(ws, ev, 4, POLL);
+    TAP_ASSERT(n == 1 && ev[0].cookie == CK_RD,
+               "4. level-triggered item is reported again while unread");
+    recv_one();
+    TAP_ASSERT(syscall_waitset_wait(ws, ev, 4, POLL) == 0,
+               "5. recv clears level readiness");
+
+    // -------------------- G3: edge (2 asserts) ---------
+    syscall_waitset_ctl(ws, WAITSET_CTL_MOD, rd.raw,
+                        WAITSET_EV_READABLE | WAITSET_EDGE, CK_RD);
+    send_one(0x22);
+    n = syscall_waitset_wait(ws, ev, 4, 1000000000ULL);
+    TAP_ASSERT(n == 1 && ev[0].events == WAITSET_EV_READABLE,
+               "6. edge-triggered item reports the send");
+    TAP_ASSERT(syscall_waitset_wait(ws, ev, 4, POLL) == 0,
+               "7. ...once, although the message is still queued");
+    recv_one();
+
+    // -------------------- G4: oneshot (2 asserts) ---------
+    syscall_waitset_ctl(ws, WAITSET_CTL_MOD, rd.raw,
+                        WAITSET_EV_READABLE | WAITSET_ONESHOT, CK_RD);
+    send_one(0x33);
+    long first  = syscall_waitset_wait(ws, ev, 4, 1000000000ULL);
+    send_one(0x34);
+    long second = syscall_waitset_wait(ws, ev, 4, POLL);
+    TAP_ASSERT(first == 1 && second == 0,
+               "8. oneshot item is disarmed after one report");
+    syscall_waitset_ctl(ws, WAITSET_CTL_MOD, rd.raw,
+                        WAITSET_EV_READABLE | WAITSET_ONESHOT, CK_RD);
+    n = syscall_waitset_wait(ws, ev, 4, POLL);
+    TAP_ASSERT(n == 1 && ev[0].cookie == CK_RD,
+               "9. CTL_MOD re-arms it and reports the queued messages");
+    recv_one();
+    recv_one();
+
+    // -------------------- G5: ctl (2 asserts) ---------
+    TAP_ASSERT(syscall_waitset_ctl(ws, WAITSET_CTL_ADD, rd.raw,
+                                   WAITSET_EV_READABLE, CK_RD) == -16,
+               "10. duplicate ADD returns EBUSY");
+    long del = syscall_waitset_ctl(ws, WAITSET_CTL_DEL, rd.raw, 0, 0);
+    add = syscall_waitset_ctl(ws, WAITSET_CTL_ADD, rd.raw,
+                              WAITSET_EV_READABLE, CK_RD);
+    TAP_ASSERT(del == 0 && add == 0, "11. DEL then ADD succeeds");
+
+    // -------------------- G6: wait (2 asserts) ---------
+    TAP_ASSERT(syscall_waitset_wait(ws, ev, 4, 20000000ULL) == 0,
+               "12. a 20 ms wait on an idle set times out with 0");
+    syscall_waitset_ctl(ws, WAITSET_CTL_ADD, wr.raw, WAITSET_EV_WRITABLE, CK_WR);
+    n = syscall_waitset_wait(ws, ev, 4, POLL);
+    TAP_ASSERT(n == 1 && ev[0].cookie == CK_WR &&
+               ev[0].events == WAITSET_EV_WRITABLE,
+               "13. the write end of a channel with room is WRITABLE");
+
+    tap_done();
+    exit(0);
+}